@@ -39,6 +39,7 @@ set (SLIB_CORE_FILES
  "${SLIB_PATH}/src/slib/core/async.cpp"
  "${SLIB_PATH}/src/slib/core/async_epoll.cpp"
  "${SLIB_PATH}/src/slib/core/async_unix.cpp"
+ "${SLIB_PATH}/src/slib/core/async_uring.cpp"
  "${SLIB_PATH}/src/slib/core/atomic.cpp"
  "${SLIB_PATH}/src/slib/core/base.cpp"
  "${SLIB_PATH}/src/slib/core/charset.cpp"
@@ -60,6 +61,7 @@ set (SLIB_CORE_FILES
  "${SLIB_PATH}/src/slib/core/log.cpp"
  "${SLIB_PATH}/src/slib/core/math.cpp"
  "${SLIB_PATH}/src/slib/core/memory.cpp"
+ "${SLIB_PATH}/src/slib/core/memory_pool.cpp"
  "${SLIB_PATH}/src/slib/core/mutex.cpp"
  "${SLIB_PATH}/src/slib/core/named_instance.cpp"
  "${SLIB_PATH}/src/slib/core/object.cpp"
@@ -80,6 +82,7 @@ set (SLIB_CORE_FILES
  "${SLIB_PATH}/src/slib/core/setting.cpp"
  "${SLIB_PATH}/src/slib/core/spin_lock.cpp"
  "${SLIB_PATH}/src/slib/core/string.cpp"
+ "${SLIB_PATH}/src/slib/core/hex_simd.cpp"
  "${SLIB_PATH}/src/slib/core/string_buffer.cpp"
  "${SLIB_PATH}/src/slib/core/string_param.cpp"
  "${SLIB_PATH}/src/slib/core/system.cpp"
@@ -93,19 +96,23 @@ set (SLIB_CORE_FILES
  "${SLIB_PATH}/src/slib/core/xml.cpp"
 
  "${SLIB_PATH}/src/slib/crypto/aes.cpp"
+ "${SLIB_PATH}/src/slib/crypto/aes_hw.cpp"
  "${SLIB_PATH}/src/slib/crypto/asn1.cpp"
  "${SLIB_PATH}/src/slib/crypto/base64.cpp"
  "${SLIB_PATH}/src/slib/crypto/block_cipher.cpp"
  "${SLIB_PATH}/src/slib/crypto/blowfish.cpp"
  "${SLIB_PATH}/src/slib/crypto/certificate.cpp"
  "${SLIB_PATH}/src/slib/crypto/chacha.cpp"
+ "${SLIB_PATH}/src/slib/crypto/chacha_simd.cpp"
  "${SLIB_PATH}/src/slib/crypto/compress.cpp"
+ "${SLIB_PATH}/src/slib/crypto/compress_parallel.cpp"
  "${SLIB_PATH}/src/slib/crypto/crc32c.cpp"
  "${SLIB_PATH}/src/slib/crypto/des.cpp"
  "${SLIB_PATH}/src/slib/crypto/ecc.cpp"
  "${SLIB_PATH}/src/slib/crypto/gcm.cpp"
  "${SLIB_PATH}/src/slib/crypto/jwt.cpp"
  "${SLIB_PATH}/src/slib/crypto/jwt_openssl.cpp"
+ "${SLIB_PATH}/src/slib/crypto/jwt_verifier.cpp"
  "${SLIB_PATH}/src/slib/crypto/lzw.cpp"
  "${SLIB_PATH}/src/slib/crypto/md5.cpp"
  "${SLIB_PATH}/src/slib/crypto/openssl.cpp"
@@ -117,6 +124,10 @@ set (SLIB_CORE_FILES
  "${SLIB_PATH}/src/slib/crypto/rsa.cpp"
  "${SLIB_PATH}/src/slib/crypto/sha1.cpp"
  "${SLIB_PATH}/src/slib/crypto/sha2.cpp"
+ "${SLIB_PATH}/src/slib/crypto/sha_simd.cpp"
+ "${SLIB_PATH}/src/slib/crypto/sha3_simd.cpp"
+ "${SLIB_PATH}/src/slib/crypto/crc32_simd.cpp"
+ "${SLIB_PATH}/src/slib/crypto/base64_simd.cpp"
  "${SLIB_PATH}/src/slib/crypto/sha3.cpp"
  "${SLIB_PATH}/src/slib/crypto/tls.cpp"
  "${SLIB_PATH}/src/slib/crypto/zlib.cpp"
@@ -138,6 +149,8 @@ set (SLIB_CORE_FILES
  "${SLIB_PATH}/src/slib/network/http_common.cpp"
  "${SLIB_PATH}/src/slib/network/http_io.cpp"
  "${SLIB_PATH}/src/slib/network/http_server.cpp"
+ "${SLIB_PATH}/src/slib/network/http_server_http2.cpp"
+ "${SLIB_PATH}/src/slib/network/http2.cpp"
  "${SLIB_PATH}/src/slib/network/http_openssl.cpp"
  "${SLIB_PATH}/src/slib/network/icmp.cpp"
  "${SLIB_PATH}/src/slib/network/ipc.cpp"
@@ -147,6 +160,7 @@ set (SLIB_CORE_FILES
  "${SLIB_PATH}/src/slib/network/net_capture.cpp"
  "${SLIB_PATH}/src/slib/network/network_async.cpp"
  "${SLIB_PATH}/src/slib/network/network_async_unix.cpp"
+ "${SLIB_PATH}/src/slib/network/network_async_uring.cpp"
  "${SLIB_PATH}/src/slib/network/network_os.cpp"
  "${SLIB_PATH}/src/slib/network/p2p.cpp"
  "${SLIB_PATH}/src/slib/network/packet_analyzer.cpp"
@@ -163,6 +177,7 @@ set (SLIB_CORE_FILES
  "${SLIB_PATH}/src/slib/network/url_request.cpp"
  "${SLIB_PATH}/src/slib/network/url_request_param.cpp"
  "${SLIB_PATH}/src/slib/network/url_request_curl.cpp"
+ "${SLIB_PATH}/src/slib/network/websocket.cpp"
 )
 if (ANDROID)
  set (SLIB_CORE_PLATFORM_FILES
@@ -530,6 +545,7 @@ endif()
 
 if (SLIB_X86_64)
  SET_PROPERTY( SOURCE ${SLIB_PATH}/src/slib/crypto/crc32c.cpp PROPERTY COMPILE_FLAGS -msse4.2 )
+ SET_PROPERTY( SOURCE ${SLIB_PATH}/src/slib/crypto/aes_hw.cpp PROPERTY COMPILE_FLAGS "-msse4.2 -maes -mpclmul" )
 endif()
 
 set (EXTERNAL_SRC_DIR "${SLIB_PATH}/external/src")
@@ -2,32 +2,83 @@
 
 using namespace slib;
 
-String Encrypt(const String& plain, const String& key, const String& iv)
+#define DATA_SIZE 0x4000000
+#define REPEAT_COUNT 4
+
+static void PrintSpeed(const char* name, sl_uint64 elapsed)
 {
-	AES aes;
-	aes.setKey_SHA256(key);
-	char hashIV[16];
-	MD5::hash(iv, hashIV);
-	return String::makeHexString(aes.encrypt_CBC_PKCS7Padding(hashIV, plain.getData(), plain.getLength()));
+	if (!elapsed) {
+		elapsed = 1;
+	}
+	double speed = (double)DATA_SIZE * REPEAT_COUNT / (double)elapsed / 1000000.0;
+	Println("%s: %s GB/s", name, String::fromDouble(speed, 2));
 }
 
-String Decrypt(const String& strCipher, const String& key, const String& iv)
+static void RunBenchmark(sl_uint32 lenKey, sl_uint8* data, sl_uint8* output)
 {
-	Memory cipher = strCipher.parseHexString();
+	Println("AES-%d", lenKey * 8);
+
+	sl_uint8 key[32];
+	Math::randomMemory(key, sizeof(key));
 	AES aes;
-	aes.setKey_SHA256(key);
-	char hashIV[16];
-	MD5::hash(iv, hashIV);
-	return String::fromUtf8(aes.decrypt_CBC_PKCS7Padding(hashIV, cipher.getData(), cipher.getSize()));
+	aes.setKey(key, lenKey);
+
+	sl_uint8 iv[16];
+	Math::randomMemory(iv, sizeof(iv));
+
+	TimeCounter tc;
+	for (sl_uint32 i = 0; i < REPEAT_COUNT; i++) {
+		aes.encryptBlocks(data, output, DATA_SIZE);
+	}
+	PrintSpeed("ECB Encrypt", tc.getElapsedMilliseconds());
+
+	tc.reset();
+	for (sl_uint32 i = 0; i < REPEAT_COUNT; i++) {
+		aes.encrypt_CBC_PKCS7Padding(iv, data, DATA_SIZE - 1, output);
+	}
+	PrintSpeed("CBC Encrypt", tc.getElapsedMilliseconds());
+
+	tc.reset();
+	for (sl_uint32 i = 0; i < REPEAT_COUNT; i++) {
+		aes.decrypt_CBC_PKCS7Padding(iv, output, DATA_SIZE, data);
+	}
+	PrintSpeed("CBC Decrypt", tc.getElapsedMilliseconds());
+
+	tc.reset();
+	for (sl_uint32 i = 0; i < REPEAT_COUNT; i++) {
+		aes.encrypt_CTR(iv, 0, data, DATA_SIZE, output);
+	}
+	PrintSpeed("CTR", tc.getElapsedMilliseconds());
+
+	GCM<AES> gcm(&aes);
+	sl_uint8 tag[16];
+	tc.reset();
+	for (sl_uint32 i = 0; i < REPEAT_COUNT; i++) {
+		gcm.encrypt(iv, 12, sl_null, 0, data, output, DATA_SIZE, tag);
+	}
+	PrintSpeed("GCM Encrypt", tc.getElapsedMilliseconds());
+
+	tc.reset();
+	for (sl_uint32 i = 0; i < REPEAT_COUNT; i++) {
+		if (!(gcm.decrypt(iv, 12, sl_null, 0, output, data, DATA_SIZE, tag))) {
+			Println("GCM Decrypt: tag mismatch");
+		}
+	}
+	PrintSpeed("GCM Decrypt", tc.getElapsedMilliseconds());
 }
 
 int main(int argc, const char * argv[])
 {
-	String iv = "abc";
-	String key = "aaaa";
-	String encrypt = Encrypt("This string is used to check AES.", key, iv);
-	String decrypt = Decrypt(encrypt, key, iv);
-	Println("Encrypt=%s", encrypt);
-	Println("Decrypt=%s", decrypt);
+	Println("AES-NI: %s, PCLMULQDQ: %s, VAES: %s", Cpu::isSupportedAES(), Cpu::isSupportedPCLMUL(), Cpu::isSupportedVAES());
+
+	Memory data = Memory::create(DATA_SIZE);
+	Memory output = Memory::create(DATA_SIZE + 16);
+	if (data.isNull() || output.isNull()) {
+		return -1;
+	}
+	Math::randomMemory(data.getData(), DATA_SIZE);
+
+	RunBenchmark(16, (sl_uint8*)(data.getData()), (sl_uint8*)(output.getData()));
+	RunBenchmark(32, (sl_uint8*)(data.getData()), (sl_uint8*)(output.getData()));
 	return 0;
 }
@@ -0,0 +1,121 @@
+#include <slib.h>
+
+#if defined(SLIB_ARCH_IS_X64) || defined(SLIB_ARCH_IS_X86)
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#	else
+#		include <x86intrin.h>
+#	endif
+#	define SUPPORT_RDTSC
+#endif
+
+using namespace slib;
+
+#define TOTAL_SIZE 0x4000000
+
+static volatile sl_size g_result;
+
+static sl_uint64 GetCycles()
+{
+#if defined(SUPPORT_RDTSC)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static void PrintSpeed(const char* name, sl_size size, sl_uint64 elapsed, sl_uint64 cycles)
+{
+	if (!elapsed) {
+		elapsed = 1;
+	}
+	double speed = (double)TOTAL_SIZE / (double)elapsed / 1000.0;
+	if (cycles) {
+		Println("%s (%d Bytes): %s MB/s, %s bytes/cycle", name, size, String::fromDouble(speed, 1), String::fromDouble((double)TOTAL_SIZE / (double)cycles, 2));
+	} else {
+		Println("%s (%d Bytes): %s MB/s", name, size, String::fromDouble(speed, 1));
+	}
+}
+
+// Speeds are measured in bytes of binary data
+static void RunBenchmark(sl_size size, sl_uint8* data)
+{
+	sl_size nRepeat = TOTAL_SIZE / size;
+	sl_size result = 0;
+
+	String base64 = Base64::encode(data, size);
+	Memory bufBase64 = Memory::create(base64.getLength());
+	Memory bufDecode = Memory::create(size);
+	if (bufBase64.isNull() || bufDecode.isNull()) {
+		return;
+	}
+
+	TimeCounter tc;
+	sl_uint64 cycles = GetCycles();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		result += Base64::encode(data, size).getLength();
+	}
+	cycles = GetCycles() - cycles;
+	PrintSpeed("Base64::encode", size, tc.getElapsedMilliseconds(), cycles);
+
+	tc.reset();
+	cycles = GetCycles();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		result += Base64::encode((sl_char8*)(bufBase64.getData()), data, size);
+	}
+	cycles = GetCycles() - cycles;
+	PrintSpeed("Base64::encode (buffer)", size, tc.getElapsedMilliseconds(), cycles);
+
+	tc.reset();
+	cycles = GetCycles();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		result += Base64::decode(base64).getSize();
+	}
+	cycles = GetCycles() - cycles;
+	PrintSpeed("Base64::decode", size, tc.getElapsedMilliseconds(), cycles);
+
+	tc.reset();
+	cycles = GetCycles();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		result += Base64::decode(base64.getData(), base64.getLength(), bufDecode.getData());
+	}
+	cycles = GetCycles() - cycles;
+	PrintSpeed("Base64::decode (buffer)", size, tc.getElapsedMilliseconds(), cycles);
+
+	String hex = String::makeHexString(data, size);
+
+	tc.reset();
+	cycles = GetCycles();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		result += String::makeHexString(data, size).getLength();
+	}
+	cycles = GetCycles() - cycles;
+	PrintSpeed("String::makeHexString", size, tc.getElapsedMilliseconds(), cycles);
+
+	tc.reset();
+	cycles = GetCycles();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		result += hex.parseHexString(bufDecode.getData());
+	}
+	cycles = GetCycles() - cycles;
+	PrintSpeed("String::parseHexString", size, tc.getElapsedMilliseconds(), cycles);
+
+	g_result = result;
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("AVX2: %s, AVX-512 VBMI: %s", Cpu::isSupportedAVX2(), Cpu::isSupportedAVX512VBMI());
+
+	sl_size maxSize = 0x100000;
+	Memory data = Memory::create(maxSize);
+	if (data.isNull()) {
+		return -1;
+	}
+	Math::randomMemory(data.getData(), maxSize);
+
+	for (sl_size size = 64; size <= maxSize; size <<= 4) {
+		RunBenchmark(size, (sl_uint8*)(data.getData()));
+	}
+	return 0;
+}
@@ -0,0 +1 @@
+$SLIB_PATH/tool/build-app-cmake-debug.sh $(dirname $0)
\ No newline at end of file
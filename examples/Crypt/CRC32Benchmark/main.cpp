@@ -0,0 +1,97 @@
+#include <slib.h>
+
+#if defined(SLIB_ARCH_IS_X64) || defined(SLIB_ARCH_IS_X86)
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#	else
+#		include <x86intrin.h>
+#	endif
+#	define SUPPORT_RDTSC
+#endif
+
+using namespace slib;
+
+#define TOTAL_SIZE 0x10000000
+#define CHUNK_COUNT 16
+
+static volatile sl_uint32 g_result;
+
+static sl_uint64 GetCycles()
+{
+#if defined(SUPPORT_RDTSC)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static void PrintSpeed(const char* name, sl_size size, sl_uint64 elapsed, sl_uint64 cycles)
+{
+	if (!elapsed) {
+		elapsed = 1;
+	}
+	double speed = (double)TOTAL_SIZE / (double)elapsed / 1000.0;
+	if (cycles) {
+		Println("%s (%d Bytes): %s MB/s, %s bytes/cycle", name, size, String::fromDouble(speed, 1), String::fromDouble((double)TOTAL_SIZE / (double)cycles, 2));
+	} else {
+		Println("%s (%d Bytes): %s MB/s", name, size, String::fromDouble(speed, 1));
+	}
+}
+
+static void RunBenchmark(sl_size size, sl_uint8* data)
+{
+	sl_size nRepeat = TOTAL_SIZE / size;
+	sl_uint32 crc = 0;
+
+	TimeCounter tc;
+	sl_uint64 cycles = GetCycles();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		crc ^= Crc32::get(data, size);
+	}
+	cycles = GetCycles() - cycles;
+	PrintSpeed("CRC32", size, tc.getElapsedMilliseconds(), cycles);
+
+	tc.reset();
+	cycles = GetCycles();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		crc ^= Crc32c::get(data, size);
+	}
+	cycles = GetCycles() - cycles;
+	PrintSpeed("CRC32C", size, tc.getElapsedMilliseconds(), cycles);
+	g_result = crc;
+}
+
+// Checksums the chunks independently (as the threads would do), and merges the results
+static void RunCombine(sl_uint8* data, sl_size size)
+{
+	sl_size sizeChunk = size / CHUNK_COUNT;
+	sl_uint32 crcs[CHUNK_COUNT];
+	for (sl_size i = 0; i < CHUNK_COUNT; i++) {
+		crcs[i] = Crc32::get(data + i * sizeChunk, sizeChunk);
+	}
+	sl_uint64 cycles = GetCycles();
+	sl_uint32 crc = crcs[0];
+	for (sl_size i = 1; i < CHUNK_COUNT; i++) {
+		crc = Crc32::combine(crc, crcs[i], sizeChunk);
+	}
+	cycles = GetCycles() - cycles;
+	Println("CRC32 combine (%d chunks): %d cycles per combine, %s", CHUNK_COUNT, cycles / (CHUNK_COUNT - 1), crc == Crc32::get(data, sizeChunk * CHUNK_COUNT) ? "OK" : "Mismatch");
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("PCLMUL: %s, VPCLMUL: %s, SSE4.2: %s", Cpu::isSupportedPCLMUL(), Cpu::isSupportedVPCLMUL(), Cpu::isSupportedSSE42());
+
+	sl_size maxSize = 0x1000000;
+	Memory data = Memory::create(maxSize);
+	if (data.isNull()) {
+		return -1;
+	}
+	Math::randomMemory(data.getData(), maxSize);
+
+	for (sl_size size = 64; size <= maxSize; size <<= 2) {
+		RunBenchmark(size, (sl_uint8*)(data.getData()));
+	}
+	RunCombine((sl_uint8*)(data.getData()), maxSize);
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include <slib.h>
+
+using namespace slib;
+
+#define TOTAL_SIZE 0x4000000
+
+static void PrintSpeed(const char* name, sl_size size, sl_uint64 elapsed)
+{
+	if (!elapsed) {
+		elapsed = 1;
+	}
+	double speed = (double)TOTAL_SIZE / (double)elapsed / 1000.0;
+	Println("%s (%d Bytes): %s MB/s", name, size, String::fromDouble(speed, 1));
+}
+
+static void RunBenchmark(sl_size size, sl_uint8* data, sl_uint8* output)
+{
+	sl_size nRepeat = TOTAL_SIZE / size;
+
+	sl_uint8 key[32];
+	Math::randomMemory(key, sizeof(key));
+	sl_uint8 iv[12];
+	Math::randomMemory(iv, sizeof(iv));
+
+	ChaCha20 cipher;
+	cipher.setKey(key);
+	TimeCounter tc;
+	for (sl_size i = 0; i < nRepeat; i++) {
+		cipher.start(iv);
+		cipher.encrypt(data, output, size);
+	}
+	PrintSpeed("ChaCha20", size, tc.getElapsedMilliseconds());
+
+	sl_uint8 tag[16];
+	tc.reset();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		Poly1305::execute(key, data, size, tag);
+	}
+	PrintSpeed("Poly1305", size, tc.getElapsedMilliseconds());
+
+	ChaCha20_Poly1305 aead;
+	aead.setKey(key);
+	tc.reset();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		aead.encrypt(0, iv, sl_null, 0, data, output, size, tag);
+	}
+	PrintSpeed("ChaCha20-Poly1305 Encrypt", size, tc.getElapsedMilliseconds());
+
+	tc.reset();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		if (!(aead.decrypt(0, iv, sl_null, 0, output, data, size, tag))) {
+			Println("ChaCha20-Poly1305 Decrypt: tag mismatch");
+			return;
+		}
+	}
+	PrintSpeed("ChaCha20-Poly1305 Decrypt", size, tc.getElapsedMilliseconds());
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("AVX2: %s, AVX-512: %s", Cpu::isSupportedAVX2(), Cpu::isSupportedAVX512F());
+
+	sl_size maxSize = 0x1000000;
+	Memory data = Memory::create(maxSize);
+	Memory output = Memory::create(maxSize);
+	if (data.isNull() || output.isNull()) {
+		return -1;
+	}
+	Math::randomMemory(data.getData(), maxSize);
+
+	for (sl_size size = 64; size <= maxSize; size <<= 2) {
+		RunBenchmark(size, (sl_uint8*)(data.getData()), (sl_uint8*)(output.getData()));
+	}
+	return 0;
+}
@@ -0,0 +1,92 @@
+#include <slib.h>
+
+using namespace slib;
+
+static void PrintOps(const char* name, const char* engine, sl_uint32 n, sl_uint64 elapsed)
+{
+	if (!elapsed) {
+		elapsed = 1;
+	}
+	Println("%s [%s]: %d ops/s", name, engine, (sl_uint64)n * 1000 / elapsed);
+}
+
+static void RunBenchmark(const char* name, const EllipticCurve& curve, sl_uint32 n)
+{
+	ECPrivateKey key;
+	if (!(key.generate(curve))) {
+		Println("Failed to generate key: %s", name);
+		return;
+	}
+	ECPrivateKey keyRemote;
+	keyRemote.generate(curve);
+	sl_uint8 hash[32];
+	SHA256::hash("SLib ECC Benchmark", 18, hash);
+
+	ECDSA_Signature signature;
+	TimeCounter tc;
+	for (sl_uint32 i = 0; i < n; i++) {
+		signature = ECDSA::sign(curve, key, hash, sizeof(hash));
+	}
+	PrintOps(name, "SLib sign", n, tc.getElapsedMilliseconds());
+
+	tc.reset();
+	sl_uint32 nVerified = 0;
+	for (sl_uint32 i = 0; i < n; i++) {
+		if (ECDSA::verify(curve, key, hash, sizeof(hash), signature)) {
+			nVerified++;
+		}
+	}
+	PrintOps(name, "SLib verify", n, tc.getElapsedMilliseconds());
+	if (nVerified != n) {
+		Println("Verification failed!");
+	}
+
+	{
+		List<ECPublicKey> keys;
+		List<BigInt> z;
+		List<ECDSA_Signature> signatures;
+		BigInt e = BigInt::fromBytesBE(hash, sizeof(hash));
+		for (sl_uint32 i = 0; i < n; i++) {
+			keys.add_NoLock(key);
+			z.add_NoLock(e);
+			signatures.add_NoLock(signature);
+		}
+		tc.reset();
+		if (!(ECDSA::verifyBatch(curve, keys.getData(), z.getData(), signatures.getData(), n))) {
+			Println("Batch verification failed!");
+		}
+		PrintOps(name, "SLib batch verify", n, tc.getElapsedMilliseconds());
+	}
+
+	tc.reset();
+	for (sl_uint32 i = 0; i < n; i++) {
+		ECDH::getSharedKey(curve, key, keyRemote);
+	}
+	PrintOps(name, "SLib ECDH", n, tc.getElapsedMilliseconds());
+
+	tc.reset();
+	for (sl_uint32 i = 0; i < n; i++) {
+		signature = OpenSSL::sign_ECDSA(curve, key, hash, sizeof(hash));
+	}
+	PrintOps(name, "OpenSSL sign", n, tc.getElapsedMilliseconds());
+
+	tc.reset();
+	nVerified = 0;
+	for (sl_uint32 i = 0; i < n; i++) {
+		if (OpenSSL::verify_ECDSA(curve, key, hash, sizeof(hash), signature)) {
+			nVerified++;
+		}
+	}
+	PrintOps(name, "OpenSSL verify", n, tc.getElapsedMilliseconds());
+	if (nVerified != n) {
+		Println("Verification failed!");
+	}
+}
+
+int main(int argc, const char * argv[])
+{
+	RunBenchmark("secp256k1", EllipticCurve::secp256k1(), 1000);
+	RunBenchmark("secp384r1", EllipticCurve::secp384r1(), 300);
+	RunBenchmark("secp521r1", EllipticCurve::secp521r1(), 100);
+	return 0;
+}
@@ -0,0 +1,76 @@
+#include <slib.h>
+
+using namespace slib;
+
+static void PrintOps(const char* name, const char* engine, sl_uint32 n, sl_uint64 elapsed)
+{
+	if (!elapsed) {
+		elapsed = 1;
+	}
+	Println("%s [%s]: %d ops/s", name, engine, (sl_uint64)n * 1000 / elapsed);
+}
+
+static void RunBenchmark(const char* name, sl_uint32 nBits, sl_uint32 nSign, sl_uint32 nVerify)
+{
+	PrivateKey key;
+	OpenSSL::generateRSA(key.rsa, nBits);
+	sl_uint32 sizeRSA = key.rsa.getLength();
+
+	sl_uint8 hash[32];
+	SHA256::hash("SLib RSA Benchmark", 18, hash);
+	Memory signature = Memory::create(sizeRSA);
+	Memory output = Memory::create(sizeRSA);
+	if (signature.isNull() || output.isNull()) {
+		return;
+	}
+
+	TimeCounter tc;
+	for (sl_uint32 i = 0; i < nSign; i++) {
+		RSA::encryptPrivate_pkcs1_v15(key.rsa, hash, sizeof(hash), signature.getData());
+	}
+	PrintOps(name, "SLib sign", nSign, tc.getElapsedMilliseconds());
+
+	tc.reset();
+	sl_uint32 nVerified = 0;
+	for (sl_uint32 i = 0; i < nVerify; i++) {
+		if (RSA::decryptPublic_pkcs1_v15(key.rsa, signature.getData(), sizeRSA, output.getData()) == sizeof(hash)) {
+			nVerified++;
+		}
+	}
+	PrintOps(name, "SLib verify", nVerify, tc.getElapsedMilliseconds());
+	if (nVerified != nVerify || !(Base::equalsMemory(output.getData(), hash, sizeof(hash)))) {
+		Println("Verification failed!");
+	}
+
+	PEM pem;
+	pem.addPrivateKey(key);
+	Ref<OpenSSL_Key> keyOpenSSL = OpenSSL_Key::createPrivateKey(String::fromMemory(pem.save()));
+	if (keyOpenSSL.isNull()) {
+		Println("Failed to load key into OpenSSL: %s", name);
+		return;
+	}
+	tc.reset();
+	for (sl_uint32 i = 0; i < nSign; i++) {
+		signature = keyOpenSSL->sign_RSA_SHA256(hash, sizeof(hash));
+	}
+	PrintOps(name, "OpenSSL sign", nSign, tc.getElapsedMilliseconds());
+
+	tc.reset();
+	nVerified = 0;
+	for (sl_uint32 i = 0; i < nVerify; i++) {
+		if (keyOpenSSL->verify_RSA_SHA256(hash, sizeof(hash), signature.getData(), signature.getSize())) {
+			nVerified++;
+		}
+	}
+	PrintOps(name, "OpenSSL verify", nVerify, tc.getElapsedMilliseconds());
+	if (nVerified != nVerify) {
+		Println("Verification failed!");
+	}
+}
+
+int main(int argc, const char * argv[])
+{
+	RunBenchmark("RSA-2048", 2048, 500, 10000);
+	RunBenchmark("RSA-4096", 4096, 100, 3000);
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include <slib.h>
+
+#if defined(SLIB_ARCH_IS_X64) || defined(SLIB_ARCH_IS_X86)
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#	else
+#		include <x86intrin.h>
+#	endif
+#	define SUPPORT_RDTSC
+#endif
+
+using namespace slib;
+
+#define TOTAL_SIZE 0x4000000
+#define MESSAGE_COUNT 64
+
+static sl_uint64 GetCycles()
+{
+#if defined(SUPPORT_RDTSC)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static void PrintSpeed(const char* name, sl_size size, sl_uint64 elapsed, sl_uint64 cycles)
+{
+	if (!elapsed) {
+		elapsed = 1;
+	}
+	double speed = (double)TOTAL_SIZE / (double)elapsed / 1000.0;
+	if (cycles) {
+		Println("%s (%d Bytes): %s MB/s, %s cycles/byte", name, size, String::fromDouble(speed, 1), String::fromDouble((double)cycles / (double)TOTAL_SIZE, 2));
+	} else {
+		Println("%s (%d Bytes): %s MB/s", name, size, String::fromDouble(speed, 1));
+	}
+}
+
+static void RunBenchmark(sl_size size, sl_uint8* data, sl_size sizeData)
+{
+	sl_size nRepeat = TOTAL_SIZE / size;
+	sl_uint8 hash[32];
+
+	TimeCounter tc;
+	sl_uint64 cycles = GetCycles();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		SHA1::hash(data, size, hash);
+	}
+	cycles = GetCycles() - cycles;
+	PrintSpeed("SHA-1", size, tc.getElapsedMilliseconds(), cycles);
+
+	tc.reset();
+	cycles = GetCycles();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		SHA256::hash(data, size, hash);
+	}
+	cycles = GetCycles() - cycles;
+	PrintSpeed("SHA-256", size, tc.getElapsedMilliseconds(), cycles);
+
+	if (size * MESSAGE_COUNT > sizeData) {
+		return;
+	}
+	const void* inputs[MESSAGE_COUNT];
+	sl_size sizes[MESSAGE_COUNT];
+	for (sl_size k = 0; k < MESSAGE_COUNT; k++) {
+		inputs[k] = data + k * size;
+		sizes[k] = size;
+	}
+	sl_uint8 hashes[32 * MESSAGE_COUNT];
+	nRepeat /= MESSAGE_COUNT;
+	tc.reset();
+	cycles = GetCycles();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		SHA256::hashMany(inputs, sizes, MESSAGE_COUNT, hashes);
+	}
+	cycles = GetCycles() - cycles;
+	PrintSpeed("SHA-256 hashMany", size, tc.getElapsedMilliseconds(), cycles);
+}
+
+static void RunPBKDF2(sl_uint32 lenDK, sl_uint32 nIteration)
+{
+	sl_uint8 password[16];
+	Math::randomMemory(password, sizeof(password));
+	sl_uint8 salt[16];
+	Math::randomMemory(salt, sizeof(salt));
+	sl_uint8 key[512];
+	TimeCounter tc;
+	PBKDF2_HMAC_SHA256::generateKey(password, sizeof(password), salt, sizeof(salt), nIteration, key, lenDK);
+	Println("PBKDF2-HMAC-SHA256 (%d Bytes, %d iterations): %d ms", lenDK, nIteration, tc.getElapsedMilliseconds());
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("SHA: %s, AVX2: %s, AVX-512: %s", Cpu::isSupportedSHA(), Cpu::isSupportedAVX2(), Cpu::isSupportedAVX512F());
+
+	sl_size maxSize = 0x1000000;
+	Memory data = Memory::create(maxSize);
+	if (data.isNull()) {
+		return -1;
+	}
+	Math::randomMemory(data.getData(), maxSize);
+
+	for (sl_size size = 64; size <= maxSize; size <<= 2) {
+		RunBenchmark(size, (sl_uint8*)(data.getData()), maxSize);
+	}
+
+	RunPBKDF2(32, 100000);
+	RunPBKDF2(256, 100000);
+	return 0;
+}
@@ -0,0 +1,87 @@
+#include <slib.h>
+
+#if defined(SLIB_ARCH_IS_X64) || defined(SLIB_ARCH_IS_X86)
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#	else
+#		include <x86intrin.h>
+#	endif
+#	define SUPPORT_RDTSC
+#endif
+
+using namespace slib;
+
+#define TOTAL_SIZE 0x4000000
+
+static sl_uint64 GetCycles()
+{
+#if defined(SUPPORT_RDTSC)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static void PrintSpeed(const char* name, sl_size size, sl_uint64 elapsed, sl_uint64 cycles)
+{
+	if (!elapsed) {
+		elapsed = 1;
+	}
+	double speed = (double)TOTAL_SIZE / (double)elapsed / 1000.0;
+	if (cycles) {
+		Println("%s (%d Bytes): %s MB/s, %s cycles/byte", name, size, String::fromDouble(speed, 1), String::fromDouble((double)cycles / (double)TOTAL_SIZE, 2));
+	} else {
+		Println("%s (%d Bytes): %s MB/s", name, size, String::fromDouble(speed, 1));
+	}
+}
+
+static void RunBenchmark(sl_size size, sl_uint8* data)
+{
+	sl_size nRepeat = TOTAL_SIZE / size;
+	sl_uint8 hash[32];
+
+	TimeCounter tc;
+	sl_uint64 cycles = GetCycles();
+	for (sl_size i = 0; i < nRepeat; i++) {
+		SHA3_256::hash(data, size, hash);
+	}
+	cycles = GetCycles() - cycles;
+	PrintSpeed("SHA3-256", size, tc.getElapsedMilliseconds(), cycles);
+
+	if (size < ParallelHash256::DefaultBlockSize) {
+		return;
+	}
+	for (sl_uint32 nThreads = 1; ; nThreads = 0) {
+		tc.reset();
+		cycles = GetCycles();
+		for (sl_size i = 0; i < nRepeat; i++) {
+			ParallelHash256 hasher;
+			hasher.setThreadCount(nThreads);
+			hasher.start();
+			hasher.update(data, size);
+			hasher.finish(hash);
+		}
+		cycles = GetCycles() - cycles;
+		PrintSpeed(nThreads ? "ParallelHash256 (1 thread)" : "ParallelHash256 (all cores)", size, tc.getElapsedMilliseconds(), cycles);
+		if (!nThreads) {
+			break;
+		}
+	}
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("AVX2: %s, AVX-512: %s, Cores: %d", Cpu::isSupportedAVX2(), Cpu::isSupportedAVX512F(), Cpu::getCoreCount());
+
+	sl_size maxSize = 0x1000000;
+	Memory data = Memory::create(maxSize);
+	if (data.isNull()) {
+		return -1;
+	}
+	Math::randomMemory(data.getData(), maxSize);
+
+	for (sl_size size = 64; size <= maxSize; size <<= 2) {
+		RunBenchmark(size, (sl_uint8*)(data.getData()));
+	}
+	return 0;
+}
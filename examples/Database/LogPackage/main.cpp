@@ -0,0 +1,83 @@
+#include <slib.h>
+
+using namespace slib;
+
+static void RunBenchmark(const String& title, const LogPackageAppenderParam& param, sl_uint32 nThreads, sl_uint32 nRecordsPerThread, sl_uint32 sizeRecord)
+{
+	File::deleteFile(param.pathContent.toString());
+	File::deleteFile(String::concat(param.pathContent, ".idx"));
+
+	LogPackageAppender appender;
+	if (!(appender.open(param))) {
+		Println("Failed to open: %s", param.pathContent);
+		return;
+	}
+
+	Memory content = Memory::create(sizeRecord);
+	sl_uint8* data = (sl_uint8*)(content.getData());
+	for (sl_uint32 i = 0; i < sizeRecord; i++) {
+		data[i] = (sl_uint8)("0123456789abcdef"[Math::randomInt() & 7]);
+	}
+
+	TimeCounter tc;
+	List< Ref<Thread> > threads;
+	for (sl_uint32 k = 0; k < nThreads; k++) {
+		threads.add_NoLock(Thread::start([&appender, &content, k, nRecordsPerThread]() {
+			for (sl_uint32 i = 0; i < nRecordsPerThread; i++) {
+				appender.appendRecord((sl_uint64)k * nRecordsPerThread + i, content);
+			}
+		}));
+	}
+	for (auto& thread : threads) {
+		thread->join();
+	}
+	appender.sync();
+	sl_uint64 elapsed = tc.getElapsedMilliseconds();
+	if (!elapsed) {
+		elapsed = 1;
+	}
+	appender.close();
+
+	sl_uint64 nRecords = (sl_uint64)nThreads * nRecordsPerThread;
+	sl_uint64 sizeTotal = nRecords * sizeRecord;
+	Println("%s: %d records/s, %d MB/s, file size: %d bytes", title, nRecords * 1000 / elapsed, sizeTotal * 1000 / elapsed / 1048576, File::getSize(param.pathContent));
+
+	LogPackageReader reader;
+	if (reader.open(param.pathContent)) {
+		sl_size n = reader.getRecordCount();
+		sl_uint64 sizeRead = 0;
+		for (sl_size i = 0; i < n; i++) {
+			sizeRead += reader.readRecordAt(i).second.getSize();
+		}
+		if (n != nRecords || sizeRead != sizeTotal) {
+			Println("Verification failed: %d records, %d bytes", n, sizeRead);
+		}
+	}
+}
+
+int main(int argc, const char * argv[])
+{
+	String path = System::getTempDirectory() + "/log_package_benchmark";
+	sl_uint32 nThreads = 4;
+	sl_uint32 nRecords = 50000;
+	sl_uint32 sizeRecord = 256;
+
+	LogPackageAppenderParam param;
+	param.pathContent = path;
+	RunBenchmark("Unbuffered", param, nThreads, nRecords, sizeRecord);
+
+	param.blockSize = 0x10000;
+	RunBenchmark("Buffered", param, nThreads, nRecords, sizeRecord);
+
+	param.flagCompress = sl_true;
+	RunBenchmark("Compressed", param, nThreads, nRecords, sizeRecord);
+
+	param.syncSize = 0x400000;
+	RunBenchmark("Compressed, sync per 4MB", param, nThreads, nRecords, sizeRecord);
+
+	param.syncSize = 0;
+	param.syncInterval = 100;
+	RunBenchmark("Compressed, sync per 100ms", param, nThreads, nRecords, sizeRecord);
+
+	return 0;
+}
@@ -0,0 +1,188 @@
+#include <slib.h>
+
+using namespace slib;
+
+#define PORT 39201
+#define CONNECTION_COUNT 8
+#define MESSAGE_SIZE 64
+#define FILE_SIZE (64 << 20)
+#define BLOCK_SIZE 4096
+#define QUEUE_DEPTH 16
+#define DURATION 2000
+
+static volatile sl_reg g_nCompleted = 0;
+static volatile sl_bool g_flagStop = sl_false;
+
+static const char* GetBackendName(AsyncIoBackend backend)
+{
+	return backend == AsyncIoBackend::Uring ? "io_uring" : "epoll";
+}
+
+static void Echo(AsyncTcpSocket* socket, const Memory& buf)
+{
+	socket->receive(buf, [buf](AsyncStreamResult& result) {
+		AsyncTcpSocket* socket = (AsyncTcpSocket*)(result.stream);
+		if (result.isSuccess() && result.size) {
+			Memory data = buf.sub(0, result.size);
+			socket->send(data, [buf](AsyncStreamResult& result) {
+				if (result.isSuccess()) {
+					Echo((AsyncTcpSocket*)(result.stream), buf);
+				}
+			});
+		}
+	});
+}
+
+static void RunEchoBenchmark(AsyncIoBackend backend)
+{
+	Ref<AsyncIoLoop> loop = AsyncIoLoop::create(backend);
+	if (loop.isNull()) {
+		Println("Failed to create the loop");
+		return;
+	}
+	if (loop->getBackend() != backend) {
+		Println("echo (%s): not supported by the kernel", GetBackendName(backend));
+		return;
+	}
+
+	CList< Ref<AsyncTcpSocket> > clients;
+	AsyncTcpServerParam param;
+	param.bindAddress = SocketAddress(IPv4Address(127, 0, 0, 1), PORT);
+	param.ioLoop = loop;
+	param.onAccept = [&clients, loop](AsyncTcpServer*, Socket& socket, SocketAddress&) {
+		socket.setOption_TcpNoDelay();
+		AsyncTcpSocketParam param;
+		param.socket = Move(socket);
+		param.ioLoop = loop;
+		Ref<AsyncTcpSocket> client = AsyncTcpSocket::create(param);
+		if (client.isNotNull()) {
+			clients.add(client);
+			Echo(client.get(), Memory::create(MESSAGE_SIZE));
+		}
+	};
+	Ref<AsyncTcpServer> server = AsyncTcpServer::create(param);
+	if (server.isNull()) {
+		Println("Failed to bind the server");
+		return;
+	}
+
+	g_nCompleted = 0;
+	g_flagStop = sl_false;
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < CONNECTION_COUNT; i++) {
+		threads.add(Thread::start([]() {
+			Socket socket = Socket::openTcp_Connect(SocketAddress(IPv4Address(127, 0, 0, 1), PORT));
+			if (socket.isNone()) {
+				return;
+			}
+			socket.setOption_TcpNoDelay();
+			sl_uint8 data[MESSAGE_SIZE] = {0};
+			while (!g_flagStop) {
+				if (socket.send(data, MESSAGE_SIZE) != MESSAGE_SIZE) {
+					return;
+				}
+				sl_uint32 nReceived = 0;
+				while (nReceived < MESSAGE_SIZE) {
+					sl_int32 n = socket.receive(data + nReceived, MESSAGE_SIZE - nReceived);
+					if (n <= 0) {
+						return;
+					}
+					nReceived += n;
+				}
+				Base::interlockedIncrement(&g_nCompleted);
+			}
+		}));
+	}
+	Thread::sleep(DURATION);
+	g_flagStop = sl_true;
+	sl_reg nCompleted = g_nCompleted;
+	for (auto& thread : threads) {
+		thread->finishAndWait(1000);
+	}
+	server->close();
+	clients.removeAll();
+	loop->release();
+
+	Println("echo (%s): %s round trips/s", GetBackendName(backend), String::fromUint64((sl_uint64)nCompleted * 1000 / DURATION));
+}
+
+static void ReadRandom(AsyncStream* file, const Memory& buf)
+{
+	if (g_flagStop) {
+		return;
+	}
+	sl_uint64 pos = (sl_uint64)(Math::randomInt() % (FILE_SIZE / BLOCK_SIZE)) * BLOCK_SIZE;
+	if (!(file->seek(pos))) {
+		return;
+	}
+	file->read(buf, [buf](AsyncStreamResult& result) {
+		if (result.isSuccess()) {
+			Base::interlockedIncrement(&g_nCompleted);
+			ReadRandom(result.stream, buf);
+		}
+	});
+}
+
+static void RunFileBenchmark(AsyncIoBackend backend, const String& path)
+{
+	Ref<AsyncIoLoop> loop = AsyncIoLoop::create(backend);
+	if (loop.isNull()) {
+		Println("Failed to create the loop");
+		return;
+	}
+	if (loop->getBackend() != backend) {
+		Println("random read (%s): not supported by the kernel", GetBackendName(backend));
+		return;
+	}
+
+	g_nCompleted = 0;
+	g_flagStop = sl_false;
+	// epoll loops read the files on the thread pool of the dispatcher
+	Ref<Dispatcher> dispatcher = ThreadPool::create();
+	List< Ref<AsyncStream> > files;
+	for (sl_uint32 i = 0; i < QUEUE_DEPTH; i++) {
+		Ref<AsyncStream> file = AsyncFile::openStream(path, FileMode::Read, loop, dispatcher);
+		if (file.isNull()) {
+			Println("Failed to open the file");
+			return;
+		}
+		files.add(file);
+	}
+	for (auto& file : files) {
+		ReadRandom(file.get(), Memory::create(BLOCK_SIZE));
+	}
+	Thread::sleep(DURATION);
+	g_flagStop = sl_true;
+	sl_reg nCompleted = g_nCompleted;
+	Thread::sleep(100);
+	for (auto& file : files) {
+		file->close();
+	}
+	loop->release();
+
+	Println("random read (%s): %s reads/s, %d-byte blocks, queue depth %d", GetBackendName(backend), String::fromUint64((sl_uint64)nCompleted * 1000 / DURATION), BLOCK_SIZE, QUEUE_DEPTH);
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("TCP echo, %d connections, %d-byte messages", CONNECTION_COUNT, MESSAGE_SIZE);
+	RunEchoBenchmark(AsyncIoBackend::Default);
+	RunEchoBenchmark(AsyncIoBackend::Uring);
+
+	String path = System::getTempDirectory() + "/slib_async_io_benchmark";
+	Memory content = Memory::create(FILE_SIZE);
+	if (content.isNull()) {
+		return -1;
+	}
+	Math::randomMemory(content.getData(), FILE_SIZE);
+	if (File::writeAllBytes(path, content) != FILE_SIZE) {
+		Println("Failed to write %s", path);
+		return -1;
+	}
+	content.setNull();
+	Println("Random reads on a cached %d MB file", FILE_SIZE >> 20);
+	RunFileBenchmark(AsyncIoBackend::Default, path);
+	RunFileBenchmark(AsyncIoBackend::Uring, path);
+	File::deleteFile(path);
+	return 0;
+}
@@ -0,0 +1,130 @@
+#include <slib.h>
+
+using namespace slib;
+
+#define SERVER_PORT 39311
+#define UPSTREAM_PORT 39312
+#define UPSTREAM_LATENCY 5
+#define CLIENT_COUNT 4
+#define WINDOW_SIZE 32
+#define NAME_COUNT 1000
+#define DURATION 2000
+
+static volatile sl_reg g_nAnswers = 0;
+static volatile sl_reg g_nUpstreamQueries = 0;
+static volatile sl_bool g_flagStop = sl_false;
+
+// Stand-in for a recursive resolver: answers every A question after UPSTREAM_LATENCY milliseconds, with TTL of 300 seconds
+static void RunUpstream()
+{
+	Socket socket = Socket::openUdp(SocketAddress(IPv4Address(127, 0, 0, 1), UPSTREAM_PORT));
+	struct Answer
+	{
+		SocketAddress address;
+		Memory packet;
+		sl_uint64 time;
+	};
+	CLinkedList<Answer> answers;
+	Ref<Thread> thread = Thread::getCurrent();
+	while (thread.isNotNull() && !(thread->isStopping())) {
+		sl_uint8 buf[1024];
+		SocketAddress address;
+		sl_int32 n = 0;
+		if (socket.waitRead(1)) {
+			n = socket.receiveFrom(address, buf, sizeof(buf) - 16);
+		}
+		if (n > (sl_int32)sizeof(DnsHeader)) {
+			Base::interlockedIncrement(&g_nUpstreamQueries);
+			DnsHeader* header = (DnsHeader*)buf;
+			header->setQuestion(sl_false);
+			header->setRA(sl_true);
+			header->setAnswerCount(1);
+			sl_uint8 record[] = { 0xC0, 0x0C, 0, 1, 0, 1, 0, 0, 0x01, 0x2C, 0, 4, 10, 0, 0, 1 };
+			Base::copyMemory(buf + n, record, sizeof(record));
+			answers.pushBack_NoLock(Answer{address, Memory::create(buf, n + sizeof(record)), System::getTickCount64() + UPSTREAM_LATENCY});
+		}
+		sl_uint64 now = System::getTickCount64();
+		Answer answer;
+		while (answers.getFrontValue_NoLock(&answer) && answer.time <= now) {
+			socket.sendTo(answer.address, answer.packet.getData(), answer.packet.getSize());
+			answers.popFront_NoLock();
+		}
+	}
+}
+
+static void RunClient(sl_uint32 index)
+{
+	Socket socket = Socket::openUdp();
+	SocketAddress addressServer(IPv4Address(127, 0, 0, 1), SERVER_PORT);
+	sl_uint16 id = (sl_uint16)(index << 12);
+	auto sendQuestion = [&]() {
+		Memory packet = DnsPacket::buildQuestionPacket(id++, String::format("host%d.example.com", Math::randomInt() % NAME_COUNT));
+		socket.sendTo(addressServer, packet.getData(), packet.getSize());
+	};
+	for (sl_uint32 i = 0; i < WINDOW_SIZE; i++) {
+		sendQuestion();
+	}
+	while (!g_flagStop) {
+		sl_uint8 buf[1024];
+		SocketAddress address;
+		sl_int32 n = 0;
+		if (socket.waitRead(100)) {
+			n = socket.receiveFrom(address, buf, sizeof(buf));
+		}
+		if (n > (sl_int32)sizeof(DnsHeader)) {
+			Base::interlockedIncrement(&g_nAnswers);
+		}
+		// replaces the lost answer when timed out
+		sendQuestion();
+	}
+}
+
+static void RunBenchmark(const char* title, sl_bool flagCache, sl_uint32 coalesceTimeout)
+{
+	DnsServerParam param;
+	param.portDns = SERVER_PORT;
+	param.flagProxy = sl_true;
+	param.defaultForwardAddress = SocketAddress(IPv4Address(127, 0, 0, 1), UPSTREAM_PORT);
+	param.flagCache = flagCache;
+	param.coalesceTimeout = coalesceTimeout;
+	Ref<DnsServer> server = DnsServer::create(param);
+	if (server.isNull()) {
+		Println("Failed to start the server");
+		return;
+	}
+	g_nAnswers = 0;
+	g_nUpstreamQueries = 0;
+	g_flagStop = sl_false;
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < CLIENT_COUNT; i++) {
+		threads.add(Thread::start([i]() {
+			RunClient(i);
+		}));
+	}
+	Thread::sleep(DURATION);
+	g_flagStop = sl_true;
+	sl_reg nAnswers = g_nAnswers;
+	sl_reg nUpstreamQueries = g_nUpstreamQueries;
+	for (auto& thread : threads) {
+		thread->finishAndWait(1000);
+	}
+	server->release();
+	Println("%s: %s answers/s, %s upstream queries/s", title, String::fromUint64((sl_uint64)nAnswers * 1000 / DURATION), String::fromUint64((sl_uint64)nUpstreamQueries * 1000 / DURATION));
+	Ref<DnsCache> cache = server->getCache();
+	if (cache.isNotNull()) {
+		DnsCacheStatistics statistics;
+		cache->getStatistics(statistics);
+		Println("  cache: %s hits, %s misses, %s entries, %s coalesced questions", statistics.countHits, statistics.countMisses, statistics.countEntries, server->getCoalescedQuestionCount());
+	}
+}
+
+int main(int argc, const char * argv[])
+{
+	Ref<Thread> upstream = Thread::start(&RunUpstream);
+	Println("Proxy DnsServer on loopback, %d clients x %d questions in flight over %d names, upstream latency %d ms", CLIENT_COUNT, WINDOW_SIZE, NAME_COUNT, UPSTREAM_LATENCY);
+	RunBenchmark("No cache", sl_false, 0);
+	RunBenchmark("Coalescing only", sl_false, 3000);
+	RunBenchmark("Cache + coalescing", sl_true, 3000);
+	upstream->finishAndWait();
+	return 0;
+}
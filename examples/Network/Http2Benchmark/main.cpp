@@ -0,0 +1,242 @@
+#include <slib.h>
+
+using namespace slib;
+
+#define PORT 39211
+#define CONNECTION_COUNT 8
+#define STREAM_COUNT 64
+#define DURATION 2000
+
+static volatile sl_reg g_nCompleted = 0;
+static volatile sl_reg g_sizeReceived = 0;
+static volatile sl_bool g_flagStop = sl_false;
+
+static const char* g_requestHeaders[][2] = {
+	{"user-agent", "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36"},
+	{"accept", "text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8"},
+	{"accept-language", "en-US,en;q=0.9"},
+	{"cookie", "session=4f0c6e1b8a2d4c7e9b3a5d1f2e6c8a0b; theme=dark"}
+};
+
+static sl_bool ReceiveHttp1Response(Socket& socket, sl_uint8* buf, sl_uint32 size)
+{
+	sl_uint32 nReceived = 0;
+	for (;;) {
+		sl_int32 n = socket.receive(buf + nReceived, size - nReceived);
+		if (n <= 0) {
+			return sl_false;
+		}
+		nReceived += n;
+		StringView response((sl_char8*)buf, nReceived);
+		sl_reg indexBody = response.indexOf(StringView::literal("\r\n\r\n"));
+		if (indexBody >= 0) {
+			sl_reg index = response.indexOf(StringView::literal("Content-Length: "));
+			if (index < 0 || index > indexBody) {
+				return sl_false;
+			}
+			sl_uint32 lengthBody = response.substring(index + 16, response.indexOf('\r', index)).parseUint32();
+			if (nReceived >= (sl_uint32)indexBody + 4 + lengthBody) {
+				Base::interlockedAdd(&g_sizeReceived, (sl_reg)nReceived);
+				return sl_true;
+			}
+		}
+		if (nReceived >= size) {
+			return sl_false;
+		}
+	}
+}
+
+static void RunHttp1Client()
+{
+	Socket socket = Socket::openTcp_Connect(SocketAddress(IPv4Address(127, 0, 0, 1), PORT));
+	if (socket.isNone()) {
+		return;
+	}
+	socket.setOption_TcpNoDelay();
+	StringBuffer sb;
+	sb.addStatic("GET /hello HTTP/1.1\r\nHost: 127.0.0.1\r\n");
+	for (auto& header : g_requestHeaders) {
+		sb.add(header[0]);
+		sb.addStatic(": ");
+		sb.add(header[1]);
+		sb.addStatic("\r\n");
+	}
+	sb.addStatic("\r\n");
+	String request = sb.merge();
+	sl_uint8 buf[4096];
+	while (!g_flagStop) {
+		if (socket.send(request.getData(), request.getLength()) != (sl_int32)(request.getLength())) {
+			return;
+		}
+		if (!(ReceiveHttp1Response(socket, buf, sizeof(buf)))) {
+			return;
+		}
+		Base::interlockedIncrement(&g_nCompleted);
+	}
+}
+
+static void WriteFrame(MemoryOutput& output, Http2FrameType type, sl_uint8 flags, sl_uint32 streamId, const void* payload, sl_uint32 size)
+{
+	Http2FrameHeader header;
+	header.setLength(size);
+	header.setType(type);
+	header.setFlags(flags);
+	header.setStreamId(streamId);
+	output.write(&header, sizeof(header));
+	output.write(payload, size);
+}
+
+static void WriteRequest(MemoryOutput& output, HpackEncoder& encoder, sl_uint32 streamId)
+{
+	MemoryOutput block;
+	encoder.encode(block, StringView::literal(":method"), StringView::literal("GET"));
+	encoder.encode(block, StringView::literal(":scheme"), StringView::literal("http"));
+	encoder.encode(block, StringView::literal(":authority"), StringView::literal("127.0.0.1"));
+	encoder.encode(block, StringView::literal(":path"), StringView::literal("/hello"));
+	for (auto& header : g_requestHeaders) {
+		encoder.encode(block, StringView(header[0]), StringView(header[1]));
+	}
+	Memory data = block.getData();
+	WriteFrame(output, Http2FrameType::Headers, Http2FrameHeader::FlagEndHeaders | Http2FrameHeader::FlagEndStream, streamId, data.getData(), (sl_uint32)(data.getSize()));
+}
+
+// Keeps `nStreams` requests in flight on one connection
+static void RunHttp2Client(sl_uint32 nStreams)
+{
+	Socket socket = Socket::openTcp_Connect(SocketAddress(IPv4Address(127, 0, 0, 1), PORT));
+	if (socket.isNone()) {
+		return;
+	}
+	socket.setOption_TcpNoDelay();
+	HpackEncoder encoder;
+	HpackDecoder decoder;
+	MemoryOutput output;
+	output.write(SLIB_HTTP2_CONNECTION_PREFACE, SLIB_HTTP2_CONNECTION_PREFACE_SIZE);
+	WriteFrame(output, Http2FrameType::Settings, 0, 0, sl_null, 0);
+	sl_uint32 streamId = 1;
+	for (sl_uint32 i = 0; i < nStreams; i++) {
+		WriteRequest(output, encoder, streamId);
+		streamId += 2;
+	}
+	sl_uint32 sizeUnacked = 0;
+	Memory bufReceive = Memory::create(0x10000);
+	sl_uint8* buf = (sl_uint8*)(bufReceive.getData());
+	sl_uint32 sizeBuf = 0;
+	while (!g_flagStop) {
+		Memory data = output.getData();
+		output.clear();
+		if (data.isNotNull()) {
+			if (socket.send(data.getData(), data.getSize()) != (sl_int32)(data.getSize())) {
+				return;
+			}
+		}
+		sl_int32 n = socket.receive(buf + sizeBuf, (sl_uint32)(bufReceive.getSize()) - sizeBuf);
+		if (n <= 0) {
+			return;
+		}
+		Base::interlockedAdd(&g_sizeReceived, (sl_reg)n);
+		sizeBuf += n;
+		sl_uint32 pos = 0;
+		while (sizeBuf - pos >= Http2FrameHeader::HeaderSize) {
+			Http2FrameHeader& header = *((Http2FrameHeader*)(buf + pos));
+			sl_uint32 size = header.getLength();
+			if (sizeBuf - pos - Http2FrameHeader::HeaderSize < size) {
+				break;
+			}
+			sl_uint8* payload = buf + pos + Http2FrameHeader::HeaderSize;
+			switch (header.getType()) {
+				case Http2FrameType::Settings:
+					if (!(header.isAck())) {
+						WriteFrame(output, Http2FrameType::Settings, Http2FrameHeader::FlagAck, 0, sl_null, 0);
+					}
+					break;
+				case Http2FrameType::Headers:
+					{
+						List<HpackHeaderField> fields;
+						if (!(decoder.decode(payload, size, fields))) {
+							return;
+						}
+					}
+					break;
+				case Http2FrameType::Data:
+					sizeUnacked += size;
+					break;
+				case Http2FrameType::GoAway:
+				case Http2FrameType::RstStream:
+					return;
+				default:
+					break;
+			}
+			if (header.isEndStream()) {
+				Base::interlockedIncrement(&g_nCompleted);
+				WriteRequest(output, encoder, streamId);
+				streamId += 2;
+			}
+			pos += Http2FrameHeader::HeaderSize + size;
+		}
+		if (pos) {
+			Base::moveMemory(buf, buf + pos, sizeBuf - pos);
+			sizeBuf -= pos;
+		}
+		if (sizeUnacked >= 0x4000) {
+			sl_uint8 increment[4];
+			MIO::writeUint32BE(increment, sizeUnacked);
+			WriteFrame(output, Http2FrameType::WindowUpdate, 0, 0, increment, 4);
+			sizeUnacked = 0;
+		}
+	}
+}
+
+static void RunBenchmark(const char* title, sl_uint32 nConnections, sl_uint32 nStreams)
+{
+	g_nCompleted = 0;
+	g_sizeReceived = 0;
+	g_flagStop = sl_false;
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < nConnections; i++) {
+		threads.add(Thread::start([nStreams]() {
+			if (nStreams) {
+				RunHttp2Client(nStreams);
+			} else {
+				RunHttp1Client();
+			}
+		}));
+	}
+	Thread::sleep(DURATION);
+	g_flagStop = sl_true;
+	sl_reg nCompleted = g_nCompleted;
+	sl_reg sizeReceived = g_sizeReceived;
+	for (auto& thread : threads) {
+		thread->finishAndWait(1000);
+	}
+	if (!nCompleted) {
+		Println("%s: failed", title);
+		return;
+	}
+	sl_uint32 nConcurrent = nConnections * (nStreams ? nStreams : 1);
+	Println("%s: %s requests/s, mean latency %s us, %d bytes received per response", title, String::fromUint64((sl_uint64)nCompleted * 1000 / DURATION), String::fromUint64((sl_uint64)nConcurrent * DURATION * 1000 / nCompleted), (sl_uint32)(sizeReceived / nCompleted));
+}
+
+int main(int argc, const char * argv[])
+{
+	HttpServerParam param;
+	param.bindAddress = IPv4Address(127, 0, 0, 1);
+	param.port = PORT;
+	param.flagProcessByThreads = sl_false;
+	param.onRequest = [](HttpServerContext* context) -> Variant {
+		context->setResponseContentType(ContentType::TextPlain);
+		return "Hello World!";
+	};
+	Ref<HttpServer> server = HttpServer::create(param);
+	if (server.isNull()) {
+		Println("Failed to start the server");
+		return -1;
+	}
+	Println("GET /hello on loopback with browser-like request headers");
+	RunBenchmark("HTTP/1.1, 8 connections", CONNECTION_COUNT, 0);
+	RunBenchmark("HTTP/2, 1 connection x 8 streams", 1, CONNECTION_COUNT);
+	RunBenchmark("HTTP/2, 1 connection x 64 streams", 1, STREAM_COUNT);
+	RunBenchmark("HTTP/2, 8 connections x 8 streams", CONNECTION_COUNT, CONNECTION_COUNT);
+	server->release();
+	return 0;
+}
@@ -14,15 +14,11 @@ int main(int argc, const char * argv[])
 	analyzer.setAnalyzingHttp();
 	analyzer.setAnalyzingHttps();
 	analyzer.setIgnoringLocalPackets();
+	analyzer.startWorkers();
 
 	PcapParam param;
-	param.onCapturePacket = [](NetCapture* capture, NetCapturePacket& input) {
-		auto link = capture->getLinkType();
-		if (capture->getLinkType() == NetworkLinkDeviceType::Ethernet) {
-			analyzer.putEthernet(input.data, input.length, sl_null);
-		} else if (link == NetworkLinkDeviceType::Raw) {
-			analyzer.putIP(input.data, input.length, sl_null);
-		}
+	param.onCapturePackets = [](NetCapture* capture, NetCapturePacket* packets, sl_uint32 nPackets) {
+		analyzer.putCapturedPackets(capture, packets, nPackets, sl_null);
 	};
 	auto pcap = Pcap::createAny(param);
 	for (;;) {
@@ -31,5 +27,7 @@ int main(int argc, const char * argv[])
 		}
 		System::sleep(10);
 	}
+	pcap->release();
+	analyzer.stopWorkers();
 	return 0;
 }
@@ -0,0 +1,253 @@
+#include <slib.h>
+
+using namespace slib;
+
+#define FLOW_COUNT 8192
+#define BATCH_SIZE 64
+#define DURATION 3000
+
+static Memory g_bufFrames;
+static List<NetCapturePacket> g_packets;
+static NetworkLinkDeviceType g_linkType = NetworkLinkDeviceType::Ethernet;
+
+static List<Memory> g_frames;
+
+static void AddFrame(sl_uint32 ipSource, sl_uint32 ipTarget, NetworkInternetProtocol protocol, sl_uint16 portSource, sl_uint16 portTarget, sl_uint8 tcpFlags, sl_uint32 seq, const void* content, sl_uint32 sizeContent)
+{
+	sl_uint8 buf[2048];
+	Base::zeroMemory(buf, EthernetFrame::HeaderSize + 60);
+	EthernetFrame* eth = (EthernetFrame*)buf;
+	eth->setSourceAddress(MacAddress(2, 0, 0, 0, 0, 1));
+	eth->setDestinationAddress(MacAddress(2, 0, 0, 0, 0, 2));
+	eth->setProtocol(NetworkLinkProtocol::IPv4);
+	IPv4Packet* ip = (IPv4Packet*)(buf + EthernetFrame::HeaderSize);
+	ip->setVersion();
+	ip->setHeaderLength();
+	ip->setTTL(64);
+	ip->setProtocol(protocol);
+	ip->setSourceAddress(IPv4Address(ipSource));
+	ip->setDestinationAddress(IPv4Address(ipTarget));
+	sl_uint8* transport = ip->getContent();
+	sl_uint32 sizeHeader;
+	if (protocol == NetworkInternetProtocol::TCP) {
+		TcpSegment* tcp = (TcpSegment*)transport;
+		tcp->setSourcePort(portSource);
+		tcp->setDestinationPort(portTarget);
+		tcp->setSequenceNumber(seq);
+		tcp->setHeaderLength();
+		tcp->setSYN((tcpFlags & 1) != 0);
+		tcp->setACK((tcpFlags & 2) != 0);
+		tcp->setFIN((tcpFlags & 4) != 0);
+		tcp->setPSH(sizeContent != 0);
+		sizeHeader = TcpSegment::HeaderSizeBeforeOptions;
+	} else {
+		UdpDatagram* udp = (UdpDatagram*)transport;
+		udp->setSourcePort(portSource);
+		udp->setDestinationPort(portTarget);
+		udp->setTotalSize((sl_uint16)(UdpDatagram::HeaderSize + sizeContent));
+		sizeHeader = UdpDatagram::HeaderSize;
+	}
+	Base::copyMemory(transport + sizeHeader, content, sizeContent);
+	sl_uint32 sizeIP = IPv4Packet::HeaderSizeBeforeOptions + sizeHeader + sizeContent;
+	ip->setTotalSize((sl_uint16)sizeIP);
+	ip->updateChecksum();
+	g_frames.add_NoLock(Memory::create(buf, EthernetFrame::HeaderSize + sizeIP));
+}
+
+static Memory BuildClientHello(const StringView& host)
+{
+	sl_uint8 sni[9];
+	MIO::writeUint16BE(sni, 0); // server_name
+	MIO::writeUint16BE(sni + 2, (sl_uint16)(host.getLength() + 5));
+	MIO::writeUint16BE(sni + 4, (sl_uint16)(host.getLength() + 3));
+	sni[6] = 0; // host_name
+	MIO::writeUint16BE(sni + 7, (sl_uint16)(host.getLength()));
+	sl_uint8 body[128];
+	Base::zeroMemory(body, sizeof(body));
+	sl_uint32 n = 0;
+	MIO::writeUint16BE(body, 0x0303);
+	n = 2 + 32;
+	body[n++] = 0; // session id
+	MIO::writeUint16BE(body + n, 2);
+	MIO::writeUint16BE(body + n + 2, 0x1301);
+	n += 4;
+	body[n++] = 1; // compression methods
+	body[n++] = 0;
+	sl_uint32 sizeExtensions = sizeof(sni) + (sl_uint32)(host.getLength());
+	MIO::writeUint16BE(body + n, (sl_uint16)sizeExtensions);
+	n += 2;
+	sl_uint32 sizeMessage = n + sizeExtensions;
+	sl_uint8 header[9];
+	header[0] = 22; // handshake
+	MIO::writeUint16BE(header + 1, 0x0301);
+	MIO::writeUint16BE(header + 3, (sl_uint16)(sizeMessage + 4));
+	header[5] = 1; // client_hello
+	header[6] = 0;
+	MIO::writeUint16BE(header + 7, (sl_uint16)sizeMessage);
+	MemoryBuffer ret;
+	ret.addNew(header, sizeof(header));
+	ret.addNew(body, n);
+	ret.addNew(sni, sizeof(sni));
+	ret.addNew(host.getData(), host.getLength());
+	return ret.merge();
+}
+
+// HTTP, HTTPS, bulk TCP and DNS flows, interleaved by the stage of each flow
+static void GenerateTraffic()
+{
+	sl_uint8 data[1448];
+	for (sl_uint32 i = 0; i < sizeof(data); i++) {
+		data[i] = (sl_uint8)(i * 7 + 1);
+	}
+	for (sl_uint32 stage = 0; stage < 12; stage++) {
+		for (sl_uint32 i = 0; i < FLOW_COUNT; i++) {
+			sl_uint32 client = 0x0A000000 | (i + 1);
+			sl_uint32 server = 0x5DB80000 | ((i * 37) & 0xFFFF);
+			sl_uint16 port = (sl_uint16)(10000 + (i % 50000));
+			sl_uint32 kind = i & 3;
+			String host = String::format("host%d.example.com", i);
+			if (kind == 3) {
+				if (stage == 0) {
+					Memory q = DnsPacket::buildQuestionPacket((sl_uint16)i, host);
+					AddFrame(client, 0x08080808, NetworkInternetProtocol::UDP, port, 53, 0, 0, q.getData(), (sl_uint32)(q.getSize()));
+				} else if (stage == 1) {
+					Memory a = DnsPacket::buildHostAddressAnswerPacket((sl_uint16)i, host, IPv4Address(server));
+					AddFrame(0x08080808, client, NetworkInternetProtocol::UDP, 53, port, 0, 0, a.getData(), (sl_uint32)(a.getSize()));
+				}
+				continue;
+			}
+			sl_uint16 portServer = kind == 0 ? 80 : (kind == 1 ? 443 : 8080);
+			sl_uint32 seq = i * 100000;
+			if (stage == 0) {
+				AddFrame(client, server, NetworkInternetProtocol::TCP, port, portServer, 1, seq, sl_null, 0);
+			} else if (stage == 1) {
+				AddFrame(server, client, NetworkInternetProtocol::TCP, portServer, port, 3, 0, sl_null, 0);
+			} else if (stage == 2) {
+				if (kind == 0) {
+					String request = String::format("GET /index%d.html HTTP/1.1\r\nUser-Agent: Benchmark\r\nHost: %s\r\nAccept: */*\r\n\r\n", i, host);
+					AddFrame(client, server, NetworkInternetProtocol::TCP, port, portServer, 2, seq + 1, request.getData(), (sl_uint32)(request.getLength()));
+				} else if (kind == 1) {
+					Memory hello = BuildClientHello(host);
+					AddFrame(client, server, NetworkInternetProtocol::TCP, port, portServer, 2, seq + 1, hello.getData(), (sl_uint32)(hello.getSize()));
+				} else {
+					AddFrame(client, server, NetworkInternetProtocol::TCP, port, portServer, 2, seq + 1, data, sizeof(data));
+				}
+			} else if (stage < 11) {
+				AddFrame(server, client, NetworkInternetProtocol::TCP, portServer, port, 2, stage * sizeof(data), data, sizeof(data));
+				if (stage & 1) {
+					AddFrame(client, server, NetworkInternetProtocol::TCP, port, portServer, 2, seq + 1, sl_null, 0);
+				}
+			} else {
+				AddFrame(client, server, NetworkInternetProtocol::TCP, port, portServer, 6, seq + 1, sl_null, 0);
+			}
+		}
+	}
+}
+
+// Classic libpcap file format
+static sl_bool LoadPcapFile(const String& path)
+{
+	Memory file = File::readAllBytes(path);
+	sl_uint8* p = (sl_uint8*)(file.getData());
+	sl_size size = file.getSize();
+	if (size < 24) {
+		return sl_false;
+	}
+	sl_uint32 magic = MIO::readUint32LE(p);
+	sl_bool flagBE;
+	if (magic == 0xa1b2c3d4 || magic == 0xa1b23c4d) {
+		flagBE = sl_false;
+	} else if (magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1) {
+		flagBE = sl_true;
+	} else {
+		return sl_false;
+	}
+	sl_uint32 linkType = flagBE ? MIO::readUint32BE(p + 20) : MIO::readUint32LE(p + 20);
+	if (linkType == 1) {
+		g_linkType = NetworkLinkDeviceType::Ethernet;
+	} else if (linkType == 101 || linkType == 228) {
+		g_linkType = NetworkLinkDeviceType::Raw;
+	} else if (linkType == 0) {
+		g_linkType = NetworkLinkDeviceType::Null;
+	} else {
+		Println("Not supported link type: %d", linkType);
+		return sl_false;
+	}
+	sl_size offset = 24;
+	while (offset + 16 <= size) {
+		sl_uint32 n = flagBE ? MIO::readUint32BE(p + offset + 8) : MIO::readUint32LE(p + offset + 8);
+		offset += 16;
+		if (offset + n > size) {
+			break;
+		}
+		g_frames.add_NoLock(Memory::create(p + offset, n));
+		offset += n;
+	}
+	return sl_true;
+}
+
+static void BuildPackets()
+{
+	MemoryBuffer all;
+	for (auto& frame : g_frames) {
+		all.add(frame);
+	}
+	g_bufFrames = all.merge();
+	sl_uint8* p = (sl_uint8*)(g_bufFrames.getData());
+	for (auto& frame : g_frames) {
+		NetCapturePacket packet;
+		packet.data = p;
+		packet.length = (sl_uint32)(frame.getSize());
+		g_packets.add_NoLock(packet);
+		p += packet.length;
+	}
+}
+
+static void Run(sl_uint32 nWorkers)
+{
+	PacketAnalyzer analyzer;
+	analyzer.setAnalyzingHttp();
+	analyzer.setAnalyzingHttps();
+	analyzer.setAnalyzingDns();
+	analyzer.setGatheringHostInfo();
+	analyzer.setIcmpEnabled();
+	if (nWorkers) {
+		analyzer.startWorkers(nWorkers);
+	}
+	NetCapturePacket* packets = g_packets.getData();
+	sl_uint32 nPackets = (sl_uint32)(g_packets.getCount());
+	TimeCounter tc;
+	sl_uint64 nInput = 0;
+	while (tc.getElapsedMilliseconds() < DURATION) {
+		for (sl_uint32 i = 0; i < nPackets; i += BATCH_SIZE) {
+			sl_uint32 n = Math::min(nPackets - i, (sl_uint32)BATCH_SIZE);
+			analyzer.putCapturedPackets(sl_null, g_linkType, packets + i, n, sl_null);
+			nInput += n;
+		}
+	}
+	analyzer.stopWorkers();
+	double elapsed = (double)(tc.getElapsedMilliseconds()) / 1000;
+	PacketAnalyzerStatistics s;
+	analyzer.getStatistics(s);
+	Println("%s: %d Kpps, %s Gbit/s analyzed (input %d Kpps, drops %d)", nWorkers ? String::format("%d workers", nWorkers) : String("synchronous"), (sl_int64)((double)(s.countPackets) / elapsed / 1000), String::fromDouble((double)(s.countBytes) * 8 / elapsed / 1e9, 2), (sl_int64)((double)nInput / elapsed / 1000), s.countDrops);
+	Println("    IPv4 %d, TCP %d, UDP %d, DNS %d, HTTP %d, HTTPS %d, flows created %d, expired %d, evicted %d, active %d", s.countIPv4, s.countTcp, s.countUdp, s.countDns, s.countHttp, s.countHttps, s.countFlowsCreated, s.countFlowsExpired, s.countFlowsEvicted, s.countFlows);
+}
+
+int main(int argc, const char * argv[])
+{
+	if (argc > 1) {
+		if (!(LoadPcapFile(argv[1]))) {
+			Println("Failed to load the pcap file: %s", argv[1]);
+			return -1;
+		}
+	} else {
+		GenerateTraffic();
+	}
+	BuildPackets();
+	Println("Packets: %d, Bytes: %d, Cores: %d", g_packets.getCount(), g_bufFrames.getSize(), Cpu::getCoreCount());
+	Run(0);
+	for (sl_uint32 n = 1; n <= 8; n <<= 1) {
+		Run(n);
+	}
+	return 0;
+}
@@ -0,0 +1,137 @@
+#include <slib.h>
+
+using namespace slib;
+
+#define PORT 39101
+#define DATAGRAM_SIZE 64
+#define BATCH_COUNT 32
+#define DURATION 2000
+
+static volatile sl_reg g_nReceived = 0;
+
+static void RunBenchmark(const char* name, sl_uint32 sendMode, sl_uint32 receiveBatchCount, sl_bool flagOffload)
+{
+	g_nReceived = 0;
+
+	AsyncUdpSocketParam param;
+	param.bindAddress = SocketAddress(IPv4Address(127, 0, 0, 1), PORT);
+	param.receiveBatchCount = receiveBatchCount;
+	param.flagReceiveOffload = flagOffload;
+	param.onReceiveBatch = [](AsyncUdpSocket*, SocketMessage*, sl_uint32 n) {
+		Base::interlockedAdd(&g_nReceived, n);
+	};
+	Ref<AsyncUdpSocket> receiver = AsyncUdpSocket::create(param);
+	if (receiver.isNull()) {
+		Println("Failed to bind the receiver");
+		return;
+	}
+	receiver->setReceiveBufferSize(8 << 20);
+
+	Socket sender = Socket::openUdp();
+	sender.setOption_SendBufferSize(8 << 20);
+	SocketAddress target(IPv4Address(127, 0, 0, 1), PORT);
+	sl_uint8 data[DATAGRAM_SIZE * BATCH_COUNT];
+	Base::resetMemory(data, sizeof(data), 0x55);
+	SocketMessage messages[BATCH_COUNT];
+	for (sl_uint32 i = 0; i < BATCH_COUNT; i++) {
+		messages[i].address = target;
+		messages[i].data = data + i * DATAGRAM_SIZE;
+		messages[i].size = DATAGRAM_SIZE;
+	}
+
+	sl_uint64 nSent = 0;
+	TimeCounter tc;
+	while (tc.getElapsedMilliseconds() < DURATION) {
+		for (sl_uint32 k = 0; k < 16; k++) {
+			if (sendMode == 0) {
+				for (sl_uint32 i = 0; i < BATCH_COUNT; i++) {
+					if (sender.sendTo(target, data, DATAGRAM_SIZE) == DATAGRAM_SIZE) {
+						nSent++;
+					}
+				}
+			} else if (sendMode == 1) {
+				sl_int32 n = sender.sendToBatch(messages, BATCH_COUNT);
+				if (n > 0) {
+					nSent += n;
+				}
+			} else {
+				sl_int32 n = sender.sendToSegmented(target, data, sizeof(data), DATAGRAM_SIZE);
+				if (n > 0) {
+					nSent += n / DATAGRAM_SIZE;
+				}
+			}
+		}
+		Thread::sleep(0);
+	}
+	double elapsed = (double)(tc.getElapsedMilliseconds()) / 1000.0;
+	Thread::sleep(200);
+	sl_reg nReceived = g_nReceived;
+	receiver->close();
+
+	Println("%s: sent %s pps, received %s pps (%s%%)", name, String::fromUint64((sl_uint64)(nSent / elapsed)), String::fromUint64((sl_uint64)(nReceived / elapsed)), String::fromDouble(nSent ? (double)nReceived * 100.0 / (double)nSent : 0.0, 1));
+}
+
+// Fills the receive buffer, and measures the time to drain it
+static void RunReceiveBenchmark(const char* name, sl_bool flagBatch)
+{
+	Socket receiver = Socket::openUdp(SocketAddress(IPv4Address(127, 0, 0, 1), PORT));
+	receiver.setOption_ReceiveBufferSize(32 << 20);
+	receiver.setNonBlockingMode();
+	Socket sender = Socket::openUdp();
+	SocketAddress target(IPv4Address(127, 0, 0, 1), PORT);
+	sl_uint8 data[DATAGRAM_SIZE * BATCH_COUNT];
+	Base::zeroMemory(data, sizeof(data));
+	SocketMessage messages[BATCH_COUNT];
+	for (sl_uint32 i = 0; i < BATCH_COUNT; i++) {
+		messages[i].address = target;
+		messages[i].data = data + i * DATAGRAM_SIZE;
+		messages[i].size = DATAGRAM_SIZE;
+	}
+	sl_uint64 nTotal = 0;
+	sl_uint64 elapsed = 0;
+	for (sl_uint32 iRound = 0; iRound < 20; iRound++) {
+		for (sl_uint32 i = 0; i < 1000; i++) {
+			sender.sendToBatch(messages, BATCH_COUNT);
+		}
+		TimeCounter tc;
+		for (;;) {
+			sl_int32 n;
+			if (flagBatch) {
+				for (sl_uint32 i = 0; i < BATCH_COUNT; i++) {
+					messages[i].data = data + i * DATAGRAM_SIZE;
+					messages[i].size = DATAGRAM_SIZE;
+				}
+				n = receiver.receiveFromBatch(messages, BATCH_COUNT);
+			} else {
+				SocketAddress address;
+				n = receiver.receiveFrom(address, data, DATAGRAM_SIZE);
+				if (n > 0) {
+					n = 1;
+				}
+			}
+			if (n <= 0) {
+				break;
+			}
+			nTotal += n;
+		}
+		elapsed += tc.getElapsedMilliseconds();
+		for (sl_uint32 i = 0; i < BATCH_COUNT; i++) {
+			messages[i].address = target;
+		}
+	}
+	if (!elapsed) {
+		elapsed = 1;
+	}
+	Println("%s: received %s pps", name, String::fromUint64(nTotal * 1000 / elapsed));
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("UDP loopback, %d-byte datagrams", DATAGRAM_SIZE);
+	RunReceiveBenchmark("drain: recvfrom", sl_false);
+	RunReceiveBenchmark("drain: recvmmsg", sl_true);
+	RunBenchmark("sendto / recvfrom", 0, 1, sl_false);
+	RunBenchmark("sendmmsg / recvmmsg", 1, BATCH_COUNT, sl_false);
+	RunBenchmark("GSO / recvmmsg + GRO", 2, BATCH_COUNT, sl_true);
+	return 0;
+}
@@ -62,6 +62,7 @@
 #include "core/string_traits.h"
 #include "core/memory.h"
 #include "core/memory_buffer.h"
+#include "core/memory_pool.h"
 #include "core/memory_queue.h"
 #include "core/memory_traits.h"
 #include "core/bytes.h"
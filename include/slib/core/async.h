@@ -40,6 +40,13 @@ namespace slib
 		InOut = 3
 	};
 
+	// [Linux] `Uring`: io_uring. The loop falls back to epoll when the kernel does not support it
+	enum class AsyncIoBackend
+	{
+		Default = 0,
+		Uring = 1
+	};
+
 	class AsyncIoInstance;
 	class AsyncIoObject;
 
@@ -66,9 +73,13 @@ namespace slib
 		static void releaseDefault();
 
 		static Ref<AsyncIoLoop> create(sl_bool flagAutoStart = sl_true);
+
+		static Ref<AsyncIoLoop> create(AsyncIoBackend backend, sl_bool flagAutoStart = sl_true);
 	
 	public:
 		void release();
+
+		AsyncIoBackend getBackend();
 	
 		void start();
 
@@ -92,6 +103,7 @@ namespace slib
 		sl_bool m_flagInit;
 		sl_bool m_flagRunning;
 		void* m_handle;
+		AsyncIoBackend m_backend;
 
 		Ref<Thread> m_thread;
 
@@ -109,9 +121,21 @@ namespace slib
 		void _native_detachInstance(AsyncIoInstance* instance);
 		void _native_wake();
 
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		static void* _uring_createHandle();
+		static void _uring_closeHandle(void* handle);
+		void _uring_runLoop();
+		void _uring_processCompletions();
+		sl_bool _uring_attachInstance(AsyncIoInstance* instance, AsyncIoMode mode);
+		void _uring_detachInstance(AsyncIoInstance* instance);
+		void _uring_wake();
+#endif
+
 	protected:
 		void _stepBegin();
 		void _stepEnd();
+
+		friend class AsyncUring;
 	
 	};
 
@@ -166,9 +190,23 @@ namespace slib
 			sl_bool flagIn;
 			sl_bool flagOut;
 			sl_bool flagError;
+#endif
+#if defined(SLIB_PLATFORM_IS_LINUX)
+			// io_uring: completion of the operation submitted by `AsyncUring`
+			sl_bool flagCompletion;
+			sl_uint32 operation;
+			sl_int32 result; // negative: -errno
+			sl_bool flagMore; // multishot operation continues
+			sl_int32 bufferIndex; // provided buffer, -1: none
 #endif
 		};
 		virtual void onEvent(EventDesc* pev) = 0;
+
+#if defined(SLIB_PLATFORM_IS_LINUX)
+	public:
+		// io_uring: returns true when the instance submits its own operations by `AsyncUring`. Otherwise the loop polls the handle
+		virtual sl_bool isUringInstance();
+#endif
 	
 	private:
 		AtomicWeakRef<AsyncIoObject> m_object;
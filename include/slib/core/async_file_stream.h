@@ -46,7 +46,7 @@ namespace slib
 		AsyncFileStreamParam();
 
 	public:
-#ifdef SLIB_PLATFORM_IS_WIN32
+#if defined(SLIB_PLATFORM_IS_WIN32) || defined(SLIB_PLATFORM_IS_LINUX)
 		sl_bool openFile(const StringParam& filePath, FileMode mode);
 #endif
 
@@ -74,7 +74,7 @@ namespace slib
 
 	};
 
-	// [Linux] `AsyncFileStream` does not work on regular files
+	// [Linux] `AsyncFileStream` works on regular files only on the loop of `AsyncIoBackend::Uring`
 	class SLIB_EXPORT AsyncFileStream : public AsyncStreamBase
 	{
 		SLIB_DECLARE_OBJECT
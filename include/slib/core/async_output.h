@@ -91,6 +91,9 @@ namespace slib
 
 		sl_uint64 getOutputLength() const;
 
+		// Takes the first element out of the queue, for the writers which frame the output by themselves
+		sl_bool popOutput(Ref<AsyncOutputBufferElement>& element);
+
 	protected:
 		sl_uint64 m_lengthOutput;
 		LinkedQueue< Ref<AsyncOutputBufferElement> > m_queueOutput;
@@ -160,7 +163,6 @@ namespace slib
 
 		Ref<AsyncOutputBufferElement> m_elementWriting;
 		Ref<AsyncCopy> m_copy;
-		Memory m_bufWrite;
 		sl_bool m_flagWriting;
 		sl_bool m_flagClosed;
 
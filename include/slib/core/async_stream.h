@@ -31,6 +31,8 @@ namespace slib
 	class AsyncStream;
 	class AsyncStreamRequest;
 	class Memory;
+	class MemoryView;
+	class MemoryPoolStatus;
 
 	enum class AsyncStreamResultCode
 	{
@@ -96,6 +98,15 @@ namespace slib
 	public:
 		void runCallback(AsyncStream* stream, sl_size resultSize, AsyncStreamResultCode resultCode);
 
+	public:
+		// The released requests are kept in a free list of the releasing thread, and reused by the next requests created on the thread
+		static void* operator new(sl_size_t size) noexcept;
+
+		static void operator delete(void* ptr, sl_size_t size) noexcept;
+
+		// Counters of the free list of the calling thread. `inUseCount` is not tracked
+		static void getPoolStatus(MemoryPoolStatus& status) noexcept;
+
 	};
 	
 	class SLIB_EXPORT AsyncStreamInstance : public AsyncIoInstance
@@ -170,6 +181,12 @@ namespace slib
 
 		sl_bool write(const Memory& mem, const Function<void(AsyncStreamResult&)>& callback);
 
+		// Calls back with zero size when the data can be read, without consuming it. Lets the idle connections hold no read buffer
+		virtual sl_bool waitRead(const Function<void(AsyncStreamResult&)>& callback, Referable* userObject = sl_null);
+
+		// Queues the buffers as consecutive writes without concatenating them. `callback` is called once, with the result of the last buffer
+		virtual sl_bool writeVector(const MemoryView* buffers, sl_size count, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject = sl_null);
+
 		virtual sl_bool addTask(const Function<void()>& callback) = 0;
 
 		virtual sl_bool isSeekable();
@@ -198,6 +215,10 @@ namespace slib
 	
 		sl_bool requestIo(const Ref<AsyncStreamRequest>& req) override;
 
+		sl_bool waitRead(const Function<void(AsyncStreamResult&)>& callback, Referable* userObject = sl_null) override;
+
+		sl_bool writeVector(const MemoryView* buffers, sl_size count, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject = sl_null) override;
+
 		sl_bool addTask(const Function<void()>& callback) override;
 
 	protected:
@@ -0,0 +1,97 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_ASYNC_URING
+#define CHECKHEADER_SLIB_CORE_ASYNC_URING
+
+#include "async.h"
+
+/*
+	Completion-based operations on the `AsyncIoLoop` created with `AsyncIoBackend::Uring` (Linux io_uring).
+
+	The instances overriding `isUringInstance()` submit their own operations, and receive the completions by `onEvent()` with `flagCompletion`.
+	`operation` is the tag passed at the submission, `result` is the result of the system call (negative: -errno).
+	The submissions are batched and entered into the kernel once per loop iteration.
+	All functions except `isEnabled()` must be called on the loop thread.
+	An operation keeps its instance alive until the final completion, and the operations of the closing instance are canceled.
+*/
+
+namespace slib
+{
+
+	class MemoryView;
+	class AsyncFileStreamParam;
+	class AsyncFileStreamInstance;
+
+	class SLIB_EXPORT AsyncUring
+	{
+	public:
+		static sl_bool isEnabled(AsyncIoLoop* loop);
+
+	public:
+		// `offset`: -1 for the current file position
+		static sl_bool read(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, void* buf, sl_uint32 size, sl_uint64 offset = (sl_uint64)-1);
+
+		static sl_bool write(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, const void* buf, sl_uint32 size, sl_uint64 offset = (sl_uint64)-1);
+
+		// `flags`: `MSG_*` flags of recv()
+		static sl_bool receive(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, void* buf, sl_uint32 size, sl_uint32 flags = 0);
+
+		static sl_bool sendVector(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, const MemoryView* buffers, sl_uint32 count);
+
+		// Multishot accept. `result` is the accepted socket
+		static sl_bool accept(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation);
+
+		// `timeout`: milliseconds, 0 for no timeout. The timed out connection completes with -ECANCELED
+		static sl_bool connect(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, const void* address, sl_uint32 sizeAddress, sl_uint32 timeout = 0);
+
+		// Multishot `recvmsg` into the buffers of `bufferGroup`. Each completion holds `bufferIndex`, which should be parsed by `parseMessage()` and recycled
+		static sl_bool receiveMessages(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, sl_uint32 bufferGroup, sl_uint32 sizeName, sl_uint32 sizeControl);
+
+	public:
+		// Provided buffer ring. Returns the group id, or -1 on failure
+		static sl_int32 createBufferGroup(AsyncIoLoop* loop, sl_uint32 count, sl_uint32 size);
+
+		static void freeBufferGroup(AsyncIoLoop* loop, sl_uint32 bufferGroup);
+
+		static void* getBuffer(AsyncIoLoop* loop, sl_uint32 bufferGroup, sl_uint32 bufferIndex);
+
+		static void recycleBuffer(AsyncIoLoop* loop, sl_uint32 bufferGroup, sl_uint32 bufferIndex);
+
+		// Size of the buffer for `receiveMessages()`, holding the message header, the address, the control messages and the payload
+		static sl_uint32 getMessageBufferSize(sl_uint32 sizeName, sl_uint32 sizeControl, sl_uint32 sizePayload);
+
+		// Parses the buffer filled by `receiveMessages()`. `outControl` and `outSizeControl` can be passed to `CMSG_*` by a `msghdr`. Returns `sl_false` for the datagram truncated to the buffer
+		static sl_bool parseMessage(const void* buf, sl_uint32 sizeReceived, sl_uint32 sizeName, sl_uint32 sizeControl, void*& outName, sl_uint32& outSizeName, void*& outControl, sl_uint32& outSizeControl, void*& outPayload, sl_uint32& outSizePayload);
+
+	public:
+		// Reads and writes regular files at the tracked position (`AsyncFileStream::create()` uses this on the uring loop)
+		static Ref<AsyncFileStreamInstance> createFileInstance(const AsyncFileStreamParam& param);
+
+	private:
+		static void* _getRing(AsyncIoLoop* loop);
+
+	};
+
+}
+
+#endif
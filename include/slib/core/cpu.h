@@ -35,11 +35,75 @@ namespace slib
 
 #ifdef SLIB_ARCH_IS_X64
 		static sl_bool isSupportedSSE42() noexcept;
+
+		// AES-NI
+		static sl_bool isSupportedAES() noexcept;
+
+		// PCLMULQDQ
+		static sl_bool isSupportedPCLMUL() noexcept;
+
+		// AVX2, including the OS support of YMM registers
+		static sl_bool isSupportedAVX2() noexcept;
+
+		// VAES with 256-bit registers (AVX2 required)
+		static sl_bool isSupportedVAES() noexcept;
+
+		// AVX-512 Foundation, including the OS support of ZMM registers
+		static sl_bool isSupportedAVX512F() noexcept;
+
+		// VPCLMULQDQ with 512-bit registers (AVX-512F required)
+		static sl_bool isSupportedVPCLMUL() noexcept;
+
+		// SHA extensions (SHA-1, SHA-256)
+		static sl_bool isSupportedSHA() noexcept;
+
+		// AVX-512 VBMI with AVX-512BW (AVX-512F required)
+		static sl_bool isSupportedAVX512VBMI() noexcept;
 #else
 		static constexpr sl_bool isSupportedSSE42()
 		{
 			return sl_false;
 		}
+
+		static constexpr sl_bool isSupportedAES()
+		{
+			return sl_false;
+		}
+
+		static constexpr sl_bool isSupportedPCLMUL()
+		{
+			return sl_false;
+		}
+
+		static constexpr sl_bool isSupportedAVX2()
+		{
+			return sl_false;
+		}
+
+		static constexpr sl_bool isSupportedVAES()
+		{
+			return sl_false;
+		}
+
+		static constexpr sl_bool isSupportedAVX512F()
+		{
+			return sl_false;
+		}
+
+		static constexpr sl_bool isSupportedVPCLMUL()
+		{
+			return sl_false;
+		}
+
+		static constexpr sl_bool isSupportedSHA()
+		{
+			return sl_false;
+		}
+
+		static constexpr sl_bool isSupportedAVX512VBMI()
+		{
+			return sl_false;
+		}
 #endif
 
 	};
@@ -0,0 +1,96 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_MEMORY_POOL
+#define CHECKHEADER_SLIB_CORE_MEMORY_POOL
+
+#include "memory.h"
+#include "spin_lock.h"
+
+namespace slib
+{
+
+	class SLIB_EXPORT MemoryPoolStatus
+	{
+	public:
+		sl_size blockSize;
+		sl_size inUseCount; // Blocks handed out and not yet returned
+		sl_size stockCount; // Free blocks kept for reuse
+		sl_uint64 allocationCount; // Blocks taken from the heap
+		sl_uint64 reuseCount; // Blocks taken from the stock
+
+	public:
+		MemoryPoolStatus() noexcept;
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(MemoryPoolStatus)
+
+	};
+
+	/*
+		Fixed-size blocks recycled through a free list.
+		Returned blocks are kept up to `maxStockCount` and freed beyond it. Safe to use from any thread.
+	*/
+	class SLIB_EXPORT MemoryPool : public Referable
+	{
+	public:
+		MemoryPool(sl_size blockSize, sl_size maxStockCount = 64) noexcept;
+
+		~MemoryPool() noexcept;
+
+	public:
+		static Ref<MemoryPool> create(sl_size blockSize, sl_size maxStockCount = 64) noexcept;
+
+	public:
+		void* allocateBlock() noexcept;
+
+		void freeBlock(void* block) noexcept;
+
+		// The block goes back to the pool when the last reference to the returned memory is released
+		Memory allocate() noexcept;
+
+		sl_size getBlockSize() noexcept;
+
+		sl_size getMaxStockCount() noexcept;
+
+		void setMaxStockCount(sl_size count) noexcept;
+
+		void getStatus(MemoryPoolStatus& status) noexcept;
+
+		// Frees the blocks in the stock
+		void trim() noexcept;
+
+	protected:
+		sl_size m_blockSize;
+		sl_size m_maxStockCount;
+
+		void* m_stock;
+		sl_size m_stockCount;
+		sl_size m_inUseCount;
+		sl_uint64 m_allocationCount;
+		sl_uint64 m_reuseCount;
+		SpinLock m_lock;
+
+	};
+
+}
+
+#endif
@@ -64,11 +64,26 @@ namespace slib
 		// 128 bits (16 bytes) block
 		void decryptBlock(const void* src, void* dst) const;
 
+		// Following functions use AES-NI (VAES) or ARMv8 Crypto Extension when available
+		void encryptBlocks(const void* src, void* dst, sl_size size) const;
+
+		void decryptBlocks(const void* src, void* dst, sl_size size) const;
+
+		void encryptBlocks_CBC(const void* src, void* dst, sl_size size, void* iv /* inout */) const;
+
+		void decryptBlocks_CBC(const void* src, void* dst, sl_size size, void* iv /* inout */) const;
+
+		void encryptBlocks_CTR(const void* src, void* dst, sl_size size, void* counter /* inout */, sl_uint32 counterSize = 16) const;
+
 	private:
 		sl_uint32 m_roundKeyEnc[64];
 		sl_uint32 m_roundKeyDec[64];
 		sl_uint32 m_nCountRounds;
 
+		sl_bool m_flagHardware;
+		sl_uint8 m_roundKeyEncHardware[240];
+		sl_uint8 m_roundKeyDecHardware[240];
+
 	};
 	
 	class SLIB_EXPORT AES_GCM : public GCM<AES>
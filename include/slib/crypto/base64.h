@@ -58,11 +58,21 @@ namespace slib
 		static String encode(const StringView& str, sl_char8 padding = '=');
 
 		static String encodeUrl(const StringView& str, sl_char8 padding = 0);
+
+		// Writes `getEncodeOutputSize(size, padding != 0)` characters (without null terminator) to `output`, and returns the length
+		static sl_size encode(sl_char8* output, const void* data, sl_size size, sl_char8 padding = '=');
+
+		static sl_size encodeUrl(sl_char8* output, const void* data, sl_size size, sl_char8 padding = 0);
+
+		static sl_size getEncodeOutputSize(sl_size size, sl_bool flagPadding = sl_true);
 		
 		static sl_size getDecodeOutputSize(sl_size lenBase64);
 		
+		// `output` should have `getDecodeOutputSize(len)` bytes. Returns the size of the decoded data, 0 on error
 		static sl_size decode(const StringParam& base64, void* output, sl_char32 padding = '=');
 
+		static sl_size decode(const sl_char8* base64, sl_size len, void* output, sl_char8 padding = '=');
+
 		static Memory decode(const StringParam& base64, sl_char32 padding = '=');
 		
 	};
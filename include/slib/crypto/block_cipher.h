@@ -144,29 +144,18 @@ namespace slib
 		{
 			const char* src = (const char*)(_src);
 			char* dst = (char*)(_dst);
-			const char* iv = (const char*)_iv;
-			sl_size n = size / CLASS::BlockSize;
-			char msg[256];
-			for (sl_size i = 0; i < n; i++) {
-				for (sl_uint32 k = 0; k < CLASS::BlockSize; k++) {
-					msg[k] = src[k] ^ iv[k];
-				}
-				crypto->encryptBlock(msg, dst);
-				iv = dst;
-				src += CLASS::BlockSize;
-				dst += CLASS::BlockSize;
-			}
-			sl_size p = n * CLASS::BlockSize;
+			char iv[CLASS::BlockSize];
+			Base::copyMemory(iv, _iv, CLASS::BlockSize);
+			sl_size p = size / CLASS::BlockSize * CLASS::BlockSize;
+			crypto->encryptBlocks_CBC(src, dst, p, iv);
+			src += p;
+			dst += p;
 			{
+				char msg[CLASS::BlockSize];
 				sl_uint32 m = (sl_uint32)(size - p);
-				for (sl_uint32 k = 0; k < m; k++) {
-					msg[k] = src[k] ^ iv[k];
-				}
+				Base::copyMemory(msg, src, m);
 				PADDING::addPadding(msg + m, CLASS::BlockSize - m);
-				for (sl_uint32 k = m; k < CLASS::BlockSize; k++) {
-					msg[k] = msg[k] ^ iv[k];
-				}
-				crypto->encryptBlock(msg, dst);
+				crypto->encryptBlocks_CBC(msg, dst, CLASS::BlockSize, iv);
 			}
 			return p + CLASS::BlockSize;
 		}
@@ -203,24 +192,16 @@ namespace slib
 		}
 
 		// destination buffer size must equals to or greater than size
-		static sl_size decrypt(const CLASS* crypto, const void* _iv, const void* _src, sl_size size, void* _dst)
+		static sl_size decrypt(const CLASS* crypto, const void* _iv, const void* src, sl_size size, void* _dst)
 		{
-			const char* src = (const char*)(_src);
 			char* dst = (char*)(_dst);
-			const char* iv = (const char*)_iv;
 			if (size % CLASS::BlockSize != 0) {
 				return 0;
 			}
-			sl_size n = size / CLASS::BlockSize;
-			for (sl_size i = 0; i < n; i++) {
-				crypto->decryptBlock(src, dst);
-				for (sl_uint32 k = 0; k < CLASS::BlockSize; k++) {
-					dst[k] ^= iv[k];
-				}
-				iv = src;
-				src += CLASS::BlockSize;
-				dst += CLASS::BlockSize;
-			}
+			char iv[CLASS::BlockSize];
+			Base::copyMemory(iv, _iv, CLASS::BlockSize);
+			crypto->decryptBlocks_CBC(src, dst, size, iv);
+			dst += size;
 			sl_uint32 padding = PADDING::removePadding(dst - CLASS::BlockSize, CLASS::BlockSize);
 			if (padding > 0) {
 				return size - padding;
@@ -305,15 +286,18 @@ namespace slib
 					return size;
 				}
 			}
-			while (size > 0) {
-				crypto->encryptBlock(counter, mask);
-				n = SLIB_MIN(CLASS::BlockSize, size);
-				for (i = 0; i < n; i++) {
-					output[i] = input[i] ^ mask[i];
-				}
+			n = size / CLASS::BlockSize * CLASS::BlockSize;
+			if (n) {
+				crypto->encryptBlocks_CTR(input, output, n, counter);
 				size -= n;
 				input += n;
 				output += n;
+			}
+			if (size) {
+				crypto->encryptBlock(counter, mask);
+				for (i = 0; i < size; i++) {
+					output[i] = input[i] ^ mask[i];
+				}
 				MIO::increaseBE(counter, CLASS::BlockSize);
 			}
 			return _size;
@@ -370,6 +354,62 @@ namespace slib
 				dst += CLASS::BlockSize;
 			}
 		}
+
+		void encryptBlocks_CBC(const void* _src, void* _dst, sl_size size, void* _iv /* inout */) const
+		{
+			const sl_uint8* src = (const sl_uint8*)_src;
+			sl_uint8* dst = (sl_uint8*)_dst;
+			sl_uint8* iv = (sl_uint8*)_iv;
+			sl_uint8 msg[CLASS::BlockSize];
+			sl_size nBlocks = size / CLASS::BlockSize;
+			for (sl_size i = 0; i < nBlocks; i++) {
+				for (sl_uint32 k = 0; k < CLASS::BlockSize; k++) {
+					msg[k] = src[k] ^ iv[k];
+				}
+				((CLASS*)this)->encryptBlock(msg, iv);
+				Base::copyMemory(dst, iv, CLASS::BlockSize);
+				src += CLASS::BlockSize;
+				dst += CLASS::BlockSize;
+			}
+		}
+
+		void decryptBlocks_CBC(const void* _src, void* _dst, sl_size size, void* _iv /* inout */) const
+		{
+			const sl_uint8* src = (const sl_uint8*)_src;
+			sl_uint8* dst = (sl_uint8*)_dst;
+			sl_uint8* iv = (sl_uint8*)_iv;
+			sl_uint8 msg[CLASS::BlockSize];
+			sl_size nBlocks = size / CLASS::BlockSize;
+			for (sl_size i = 0; i < nBlocks; i++) {
+				Base::copyMemory(msg, src, CLASS::BlockSize);
+				((CLASS*)this)->decryptBlock(msg, dst);
+				for (sl_uint32 k = 0; k < CLASS::BlockSize; k++) {
+					dst[k] ^= iv[k];
+				}
+				Base::copyMemory(iv, msg, CLASS::BlockSize);
+				src += CLASS::BlockSize;
+				dst += CLASS::BlockSize;
+			}
+		}
+
+		// increases the last `counterSize` bytes of the counter (big endian)
+		void encryptBlocks_CTR(const void* _src, void* _dst, sl_size size, void* _counter /* inout */, sl_uint32 counterSize = CLASS::BlockSize) const
+		{
+			const sl_uint8* src = (const sl_uint8*)_src;
+			sl_uint8* dst = (sl_uint8*)_dst;
+			sl_uint8* counter = (sl_uint8*)_counter;
+			sl_uint8 mask[CLASS::BlockSize];
+			sl_size nBlocks = size / CLASS::BlockSize;
+			for (sl_size i = 0; i < nBlocks; i++) {
+				((CLASS*)this)->encryptBlock(counter, mask);
+				for (sl_uint32 k = 0; k < CLASS::BlockSize; k++) {
+					dst[k] = src[k] ^ mask[k];
+				}
+				MIO::increaseBE(counter + CLASS::BlockSize - counterSize, counterSize);
+				src += CLASS::BlockSize;
+				dst += CLASS::BlockSize;
+			}
+		}
 		
 		sl_size encrypt_ECB_PKCS7Padding(const void* src, sl_size size, void* dst) const
 		{
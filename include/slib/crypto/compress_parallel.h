@@ -0,0 +1,109 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CRYPTO_COMPRESS_PARALLEL
+#define CHECKHEADER_SLIB_CRYPTO_COMPRESS_PARALLEL
+
+#include "compress.h"
+
+#include "../core/string.h"
+#include "../core/ref.h"
+
+/*
+	ParallelCompressor splits the input into blocks, compresses the blocks
+	on a thread pool and emits them in order as a single stream.
+
+	- Zlib, Gzip, Deflate: each block is primed with the last 32KB of the
+	  previous block and ends on a sync flush, so the output is one valid
+	  deflate stream (pigz-style) readable by any zlib decoder.
+	- Zstd: each block is an independent frame. Concatenated frames are a valid
+	  zstd stream, and `Zstd::decompressParallel` decodes the frames in parallel.
+
+	At most `maxPendingBlocks` blocks are in flight, so memory is bounded
+	regardless of the input size.
+*/
+
+namespace slib
+{
+
+	class ThreadPool;
+
+	enum class ParallelCompressionFormat
+	{
+		Zlib = 0,
+		Gzip = 1,
+		Deflate = 2, // Raw deflate stream
+		Zstd = 3
+	};
+
+	class SLIB_EXPORT ParallelCompressorParam
+	{
+	public:
+		ParallelCompressionFormat format;
+		sl_int32 level; // Zlib, Gzip, Deflate: 0-9, Zstd: `Zstd::getMinimumLevel()` ~ `Zstd::getMaximumLevel()`
+		sl_uint32 threadCount; // 0: number of cpu cores
+		sl_size blockSize; // 0: default (128KB for deflate formats, 1MB for Zstd)
+		sl_uint32 maxPendingBlocks; // 0: 2 * threadCount
+		Ref<ThreadPool> threadPool; // null: the compressor creates its own pool
+
+		// Gzip header
+		StringParam fileName;
+		StringParam comment;
+
+	public:
+		ParallelCompressorParam();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(ParallelCompressorParam)
+
+	};
+
+	class SLIB_EXPORT ParallelCompressor : public ICompressor
+	{
+	public:
+		ParallelCompressor();
+
+		~ParallelCompressor();
+
+	public:
+		sl_bool isStarted();
+
+		sl_bool start(const ParallelCompressorParam& param);
+
+		DataFilterResult pass(const void* input, sl_size sizeInputAvailable, sl_size& sizeInputPassed,
+			void* output, sl_size sizeOutputAvailable, sl_size& sizeOutputUsed) override;
+
+		DataFilterResult finish(void* output, sl_size sizeOutputAvailable, sl_size& sizeOutputUsed) override;
+
+		sl_size getRecommendedInputSize() override;
+
+		sl_size getRecommendedOutputSize() override;
+
+	public:
+		static Memory compress(const ParallelCompressorParam& param, const void* data, sl_size size);
+
+	protected:
+		Ref<Referable> m_context;
+	};
+
+}
+
+#endif
@@ -41,6 +41,9 @@ namespace slib
 
 		static sl_uint32 get(const MemoryView& mem);
 
+		// Returns CRC of the concatenation (A || B), where `crc1` is CRC of A, `crc2` is CRC of B and `len2` is the length of B. Used to merge the checksums of the chunks computed in parallel
+		static sl_uint32 combine(sl_uint32 crc1, sl_uint32 crc2, sl_uint64 len2);
+
 	};
 
 	class SLIB_EXPORT Crc32c
@@ -54,6 +57,9 @@ namespace slib
 
 		static sl_uint32 get(const MemoryView& mem);
 
+		// Returns CRC of the concatenation (A || B), where `crc1` is CRC of A, `crc2` is CRC of B and `len2` is the length of B. Used to merge the checksums of the chunks computed in parallel
+		static sl_uint32 combine(sl_uint32 crc1, sl_uint32 crc2, sl_uint64 len2);
+
 	};
 
 }
@@ -136,6 +136,9 @@ namespace slib
 		ECPoint multiplyPoint(const ECPoint& pt, const BigInt& k) const noexcept;
 		
 		ECPoint multiplyG(const BigInt& k) const noexcept;
+
+		// kG * G + kPt * pt
+		ECPoint multiplyGAndPoint(const BigInt& kG, const ECPoint& pt, const BigInt& kPt) const noexcept;
 		
 		BigInt getY(const BigInt& x, sl_bool yBit) const noexcept;
 
@@ -265,6 +268,9 @@ namespace slib
 
 		static sl_bool verify_SHA512(const EllipticCurve& curve, const ECPublicKey& key, const void* data, sl_size size, const ECDSA_Signature& signature) noexcept;
 
+		// Returns `sl_true` when all signatures are valid. The inverses of `s` are computed by one modular inversion
+		static sl_bool verifyBatch(const EllipticCurve& curve, const ECPublicKey* keys, const BigInt* z, const ECDSA_Signature* signatures, sl_size nSignatures, sl_bool* outResults = sl_null) noexcept;
+
 	};
 	
 	// Elliptic Curve Diffie-Hellman
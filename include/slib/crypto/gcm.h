@@ -25,6 +25,8 @@
 
 #include "definition.h"
 
+#include "../core/base.h"
+#include "../core/mio.h"
 #include "../math/int128.h"
 
 /*
@@ -46,6 +48,8 @@ namespace slib
 	{
 	public:
 		Uint128 M[16]; // Shoup's, 4-bit table
+		sl_uint8 HP[128]; // H^1 ~ H^8, for carry-less multiplication (PCLMULQDQ)
+		sl_bool flagCLMUL;
 	
 	public:
 		void generateTable(const void* H /* 16 bytes */);
@@ -148,25 +152,22 @@ namespace slib
 
 		void encrypt(const void* src, void *dst /* out */, sl_size len)
 		{
-			sl_uint8 GCTR[16];
-			sl_size i, k, n;
 			const sl_uint8* P = (const sl_uint8*)src;
 			sl_uint8* C = (sl_uint8*)dst;
-			
-			for (i = 0; i < len; i += 16) {
-				increaseCIV();
-				m_cipher->encryptBlock(CIV, GCTR);
-				n = len - i;
-				if (n > 16) {
-					n = 16;
-				}
-				for (k = 0; k < n; k++) {
-					*C = *P ^ GCTR[k];
-					GHASH_X[k] ^= *C;
-					C++;
-					P++;
-				}
-				multiplyH(GHASH_X, GHASH_X);
+			sl_size nBlocks = len >> 4;
+			while (nBlocks) {
+				// Processes by chunks, so that GHASH reads the cipher text from the cache
+				sl_size n = SLIB_MIN(nBlocks, 64);
+				sl_size size = n << 4;
+				_encryptCounter(P, C, size);
+				put(C, size);
+				P += size;
+				C += size;
+				nBlocks -= n;
+			}
+			sl_uint32 m = (sl_uint32)(len & 15);
+			if (m) {
+				encryptBlock(P, C, m);
 			}
 		}
 
@@ -189,25 +190,21 @@ namespace slib
 
 		void decrypt(const void* src, void *dst /* out */, sl_size len)
 		{
-			sl_uint8 GCTR[16];
-			sl_size i, k, n;
 			const sl_uint8* C = (const sl_uint8*)src;
 			sl_uint8* P = (sl_uint8*)dst;
-			
-			for (i = 0; i < len; i += 16) {
-				increaseCIV();
-				m_cipher->encryptBlock(CIV, GCTR);
-				n = len - i;
-				if (n > 16) {
-					n = 16;
-				}
-				for (k = 0; k < n; k++) {
-					GHASH_X[k] ^= *C;
-					*P = *C ^ GCTR[k];
-					C++;
-					P++;
-				}
-				multiplyH(GHASH_X, GHASH_X);
+			sl_size nBlocks = len >> 4;
+			while (nBlocks) {
+				sl_size n = SLIB_MIN(nBlocks, 64);
+				sl_size size = n << 4;
+				put(C, size);
+				_encryptCounter(C, P, size);
+				C += size;
+				P += size;
+				nBlocks -= n;
+			}
+			sl_uint32 m = (sl_uint32)(len & 15);
+			if (m) {
+				decryptBlock(C, P, m);
 			}
 		}
 
@@ -260,6 +257,18 @@ namespace slib
 			return finishAndCheckTag(lenA, lenC, tag, lenTag);
 		}
 
+	protected:
+		// Encrypts the full blocks by the counters following CIV (32-bit increment)
+		void _encryptCounter(const void* src, void* dst, sl_size size)
+		{
+			sl_uint8 counter[16];
+			Base::copyMemory(counter, CIV, 12);
+			sl_uint32 n = MIO::readUint32BE(CIV + 12);
+			MIO::writeUint32BE(counter + 12, n + 1);
+			m_cipher->encryptBlocks_CTR(src, dst, size, counter, 4);
+			MIO::writeUint32BE(CIV + 12, n + (sl_uint32)(size >> 4));
+		}
+
 	protected:
 		const CLASS* m_cipher;
 
@@ -63,14 +63,25 @@ namespace slib
 			}
 
 			// hash(o_key_pad | hash(i_key_pad | message)), i_key_pad = key xor [0x36 * BlockSize], o_key_pad = key xor [0x5c * BlockSize]
-			m_hash.start();
+			// The states after hashing the pads are kept, so that the messages can be authenticated repeatedly without deriving the pads again
+			sl_uint8 pad[HASH::BlockSize];
 			for (i = 0; i < HASH::BlockSize; i++) {
-				m_keyPad[i] = key[i] ^ 0x36;
+				pad[i] = key[i] ^ 0x36;
 			}
-			m_hash.update(m_keyPad, HASH::BlockSize);
+			m_hashInner.start();
+			m_hashInner.update(pad, HASH::BlockSize);
 			for (i = 0; i < HASH::BlockSize; i++) {
-				m_keyPad[i] = key[i] ^ 0x5c;
+				pad[i] = key[i] ^ 0x5c;
 			}
+			m_hashOuter.start();
+			m_hashOuter.update(pad, HASH::BlockSize);
+			m_hash = m_hashInner;
+		}
+
+		// Discards the updated message, and starts a new message with the same key
+		void restart()
+		{
+			m_hash = m_hashInner;
 		}
 
 		void update(const void* input, sl_size n)
@@ -78,14 +89,14 @@ namespace slib
 			m_hash.update(input, n);
 		}
 
-		// output: length of HASH size
+		// output: length of HASH size. After finishing, a new message with the same key can be updated
 		void finish(void* output)
 		{
 			m_hash.finish(output);
-			m_hash.start();
-			m_hash.update(m_keyPad, HASH::BlockSize);
+			m_hash = m_hashOuter;
 			m_hash.update(output, HASH::HashSize);
 			m_hash.finish(output);
+			m_hash = m_hashInner;
 		}
 
 		// output: length of HASH size
@@ -99,7 +110,8 @@ namespace slib
 
 	private:
 		HASH m_hash;
-		sl_uint8 m_keyPad[HASH::BlockSize];
+		HASH m_hashInner;
+		HASH m_hashOuter;
 
 	};
 	
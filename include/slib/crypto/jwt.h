@@ -36,6 +36,8 @@
 
 namespace slib
 {
+
+	class ThreadPool;
 	
 	enum class JwtAlgorithm
 	{
@@ -81,6 +83,8 @@ namespace slib
 		String generateSignature_OpenSSL(const Ref<OpenSSL_Key>& key, const void* data, sl_size size) const noexcept;
 		
 		sl_bool verifySignature_OpenSSL(const Ref<OpenSSL_Key>& key, const StringParam& signature, const void* data, sl_size size) const noexcept;
+
+		static sl_bool verifySignature_OpenSSL(const Ref<OpenSSL_Key>& key, JwtAlgorithm algorithm, const void* signature, sl_size sizeSignature, const void* data, sl_size size) noexcept;
 		
 		// header
 	public:
@@ -121,6 +125,58 @@ namespace slib
 		
 	};
 
+	class SLIB_EXPORT JwtVerifierParam
+	{
+	public:
+		JwtAlgorithm algorithm; // Tokens whose header declares another algorithm are rejected
+		Memory secret; // HS256, HS384, HS512
+		Ref<OpenSSL_Key> key; // Public key for RS*, ES*, PS*
+
+		sl_uint32 cacheSize; // Maximum number of the verified tokens kept in the cache. 0: no cache
+		sl_uint32 leeway; // Allowed clock skew (seconds) when checking `exp` and `nbf`
+		sl_bool flagRequireExpirationTime; // Rejects the tokens without `exp`
+
+		sl_uint32 threadCount; // Used by the batch verification. 0: number of cpu cores
+		Ref<ThreadPool> threadPool; // null: the verifier creates its own pool at the first batch
+
+	public:
+		JwtVerifierParam() noexcept;
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(JwtVerifierParam)
+
+	};
+
+	/*
+		Verifies the tokens signed by a fixed key and algorithm.
+		The HMAC pads are precomputed once, and the tokens which passed the signature check are cached by their SHA-256 digest,
+		so a repeated token costs a hash and a lookup, plus parsing its header and payload when they are requested.
+		The cache keeps only the claims, so the returned Json objects are never shared. `exp` and `nbf` are checked against the current time on every call.
+		The payload is parsed only when the signature is valid.
+	*/
+	class SLIB_EXPORT JwtVerifier : public Referable
+	{
+	protected:
+		JwtVerifier() noexcept;
+
+		~JwtVerifier() noexcept;
+
+	public:
+		static Ref<JwtVerifier> create(const JwtVerifierParam& param) noexcept;
+
+	public:
+		// `jwt`: receives the decoded header and payload when not null
+		sl_bool verify(const StringView& token, Jwt* jwt = sl_null) noexcept;
+
+		// Verifies the tokens on the worker threads. `jwts` can be null
+		void verify(const StringView* tokens, sl_size count, sl_bool* results, Jwt* jwts = sl_null) noexcept;
+
+		void clearCache() noexcept;
+
+	protected:
+		Ref<Referable> m_context;
+
+	};
+
 }
 
 #endif
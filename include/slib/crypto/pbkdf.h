@@ -145,6 +145,14 @@ namespace slib
 	template <class HASH>
 	using PBKDF2_HMAC = PBKDF2< HMAC<HASH> >;
 
+	// Specialized to iterate on the precomputed HMAC pads, computing the output blocks in the parallel lanes when supported
+	template <>
+	void PBKDF2< HMAC<SHA256> >::generateKey(
+		const void* password, sl_size lenPassword,
+		const void* salt, sl_size lenSalt,
+		sl_uint32 nIteration,
+		void* outDK, sl_size lenDK);
+
 	typedef PBKDF2_HMAC<SHA256> PBKDF2_HMAC_SHA256;
 
 }
@@ -62,7 +62,8 @@ namespace slib
 		void updateBlocks(const void* input, sl_size nBlocks);
 		
 	private:
-		sl_uint32 m_r[5];
+		sl_uint32 m_r[20]; // r^1 ~ r^4, the powers are computed for multi-block updates
+		sl_bool m_flagPowers;
 		sl_uint32 m_h[5];
 		sl_uint32 m_pad[4];
 		sl_uint32 m_leftOver;
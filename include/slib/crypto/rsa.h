@@ -48,6 +48,12 @@ namespace slib
 
 		sl_uint32 getLength() const noexcept;
 
+		// Montgomery parameters of N, computed on first use and kept while N is unchanged
+		Ref<MontgomeryContext> getMontgomeryContextN() const noexcept;
+
+	protected:
+		mutable AtomicRef<MontgomeryContext> m_montgomeryN;
+
 	};
 	
 	class SLIB_EXPORT RSAPrivateKey : public RSAPublicKey
@@ -75,6 +81,15 @@ namespace slib
 
 		sl_bool generateFromPrimes(sl_uint32 nBits) noexcept;
 
+		// Montgomery parameters of P and Q for CRT, computed on first use and kept while P and Q are unchanged
+		Ref<MontgomeryContext> getMontgomeryContextP() const noexcept;
+
+		Ref<MontgomeryContext> getMontgomeryContextQ() const noexcept;
+
+	protected:
+		mutable AtomicRef<MontgomeryContext> m_montgomeryP;
+		mutable AtomicRef<MontgomeryContext> m_montgomeryQ;
+
 	};
 
 	class SLIB_EXPORT RSA
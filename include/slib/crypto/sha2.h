@@ -136,6 +136,12 @@ namespace slib
 	public:
 		static sl_uint32 make32bitChecksum(const void* input, sl_size n) noexcept;
 
+		/*
+			Hashes `count` independent messages, interleaved in the parallel lanes of AVX2 (8 lanes) or AVX-512 (16 lanes) when supported.
+			outputs: `count` * HashSize bytes
+		*/
+		static void hashMany(const void* const* inputs, const sl_size* sizes, sl_size count, void* outputs) noexcept;
+
 	};
 	
 	class SLIB_EXPORT SHA384 : public priv::sha2::SHA512Base, public CryptoHash<SHA384>
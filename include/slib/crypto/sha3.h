@@ -67,11 +67,15 @@ namespace slib
 				
 				void _updateBlock(const sl_uint8* input) noexcept;
 
+				// Pads the last block and squeezes `size` bytes
+				void _finish(void* output, sl_size size) noexcept;
+
 			protected:
-				BitInterleaved64 A[5][5]; // State Blocks for Keccak-f[1600]
-				sl_uint8 rdata[144];
+				sl_uint64 A[25]; // State Blocks for Keccak-f[1600]. Lane (x, y) is stored at [x + 5 * y], or bit-interleaved at [5 * x + y] on 32-bit platforms
+				sl_uint8 rdata[168];
 				sl_uint32 rdata_len;
 				sl_uint32 rate, nhash; // in bytes
+				sl_uint8 suffix; // Domain separation bits followed by the first bit of padding: SHA3 (0x06), SHAKE (0x1F), cSHAKE (0x04)
 			};
 			
 		}
@@ -137,6 +141,114 @@ namespace slib
 
 	};
 
+	// SHAKE128 extendable-output function. `finish(output)` extracts 32 bytes
+	class SLIB_EXPORT SHAKE128 : public priv::sha3::SHA3Base, public CryptoHash<SHAKE128>
+	{
+	public:
+		enum {
+			HashSize = 32,
+			BlockSize = 168
+		};
+
+	public:
+		SHAKE128() noexcept;
+
+		~SHAKE128();
+
+	public:
+		using SHA3Base::finish;
+
+		void finish(void* output, sl_size size) noexcept;
+
+	};
+
+	// SHAKE256 extendable-output function. `finish(output)` extracts 64 bytes
+	class SLIB_EXPORT SHAKE256 : public priv::sha3::SHA3Base, public CryptoHash<SHAKE256>
+	{
+	public:
+		enum {
+			HashSize = 64,
+			BlockSize = 136
+		};
+
+	public:
+		SHAKE256() noexcept;
+
+		~SHAKE256();
+
+	public:
+		using SHA3Base::finish;
+
+		void finish(void* output, sl_size size) noexcept;
+
+	};
+
+	// cSHAKE256 (NIST SP 800-185): SHAKE256 customized by the function name `N` and the customization string `S`
+	class SLIB_EXPORT CSHAKE256 : public SHAKE256
+	{
+	public:
+		CSHAKE256() noexcept;
+
+		~CSHAKE256();
+
+	public:
+		using SHAKE256::start;
+
+		void start(const void* N, sl_size lenN, const void* S, sl_size lenS) noexcept;
+
+	};
+
+	/*
+		ParallelHash256 (NIST SP 800-185) with empty customization string.
+
+		The input is split into the blocks of `blockSize` bytes, which are hashed independently by SHAKE256
+		in the lanes of AVX2/AVX-512 and by multiple threads, and their hashes are absorbed by cSHAKE256.
+	*/
+	class SLIB_EXPORT ParallelHash256 : public CryptoHash<ParallelHash256>
+	{
+	public:
+		enum {
+			HashSize = 32,
+			DefaultBlockSize = 8192
+		};
+
+	public:
+		ParallelHash256() noexcept;
+
+		~ParallelHash256();
+
+	public:
+		sl_uint32 getBlockSize() const noexcept;
+
+		// Applied by next `start()`
+		void setBlockSize(sl_uint32 size) noexcept;
+
+		sl_uint32 getThreadCount() const noexcept;
+
+		// 0: number of CPU cores (default)
+		void setThreadCount(sl_uint32 n) noexcept;
+
+	public:
+		void start() noexcept;
+
+		void update(const void* input, sl_size n) noexcept;
+
+		void finish(void* output) noexcept;
+
+	private:
+		void _updateBlocks(const sl_uint8* input, sl_size nBlocks) noexcept;
+
+	private:
+		CSHAKE256 m_outer;
+		SHAKE256 m_leaf;
+		sl_uint32 m_blockSize;
+		sl_uint32 m_blockSizeCurrent;
+		sl_uint32 m_nThreads;
+		sl_uint32 m_sizeLeaf; // Bytes in the block being hashed by `m_leaf`
+		sl_uint64 m_nBlocks;
+
+	};
+
 }
 
 #endif
@@ -238,6 +238,8 @@ namespace slib
 		
 		String serverName; // At Client, sets the server name indication ClientHello extension to contain the value name
 
+		List<String> applicationProtocols; // ALPN protocol names (such as "h2", "http/1.1") in the order of preference
+
 	public:
 		TlsContextParam();
 		
@@ -336,6 +338,9 @@ namespace slib
 		
 	public:
 		virtual void handshake() = 0;
+
+		// Protocol negotiated by ALPN after the handshake. null: not negotiated
+		virtual String getApplicationProtocol();
 		
 	};
 	
@@ -48,6 +48,12 @@ namespace slib
 
 		DataFilterResult finish32(void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed) override;
 
+		// Flushes the pending output to a byte boundary without ending the stream (Z_SYNC_FLUSH). Returns `Finished` when all the output is flushed
+		DataFilterResult flush32(void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed);
+
+		// Starts a new stream with the same parameters, without reallocating the state
+		sl_bool reset();
+
 	protected:
 		sl_uint8 m_stream[128]; // bigger than sizeof(z_stream)
 		sl_bool m_flagStarted;
@@ -70,6 +76,9 @@ namespace slib
 
 		DataFilterResult finish32(void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed) override;
 
+		// Starts a new stream with the same parameters, without reallocating the state
+		sl_bool reset();
+
 	protected:
 		sl_uint8 m_stream[128]; // bigger than sizeof(z_stream)
 		sl_bool m_flagStarted;
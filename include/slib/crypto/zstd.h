@@ -98,6 +98,9 @@ namespace slib
 		static Memory compress(const void* data, sl_size size, sl_int32 level = 3);
 
 		static Memory decompress(const void* data, sl_size size);
+
+		// Decodes the frames of a multi-frame stream (such as the output of `ParallelCompressor`) in parallel. nThreads = 0: number of cpu cores
+		static Memory decompressParallel(const void* data, sl_size size, sl_uint32 nThreads = 0);
 	
 	};
 
@@ -110,6 +110,9 @@ namespace slib
 	public:
 		sl_bool flagLockFile;
 
+		// Items of `treeHashThreshold` bytes or larger are hashed by ParallelHash256 instead of SHA3-256 (0: disabled)
+		sl_uint64 treeHashThreshold;
+
 	public:
 		DataPackageWriterParam();
 
@@ -140,6 +143,16 @@ namespace slib
 		// `outHash`: 32 bytes (SHA3-256)
 		sl_bool writeItem(DataStoreItemType type, const void* data, sl_size size, void* outHash = sl_null);
 
+		// Appends the items by coalesced writes and updates the file header once. `hash` of each item should be already verified by the caller.
+		// `outPositions`: positions of the written items
+		virtual sl_bool writeItems(const DataStoreItem* items, sl_size nItems, sl_uint64* outPositions = sl_null) = 0;
+
+		// Flushes the written items to the disk
+		virtual sl_bool sync() = 0;
+
+		// Discards the items written after `position` (result of `getCurrentPosition`)
+		virtual sl_bool rollback(sl_uint64 position) = 0;
+
 	public:
 		// `outId`: 12 Bytes
 		virtual void getId(void* outId) = 0;
@@ -26,15 +26,20 @@
 #include "definition.h"
 
 #include "../core/json.h"
+#include "../core/io.h"
 
 namespace slib
 {
 
+	class ThreadPool;
+
 	enum class DataStoreItemType
 	{
 		Data = 0,
 		List = 1,
-		Document = 2
+		Document = 2,
+		// List of the chunks of an item stored in chunked mode (type: 1 byte, [Content address (32 bytes), Size (8 bytes)]...)
+		Manifest = 3
 	};
 
 	class SLIB_EXPORT DataStoreParam
@@ -45,6 +50,24 @@ namespace slib
 
 		StringParam encrytionKey;
 
+		// Synchronizes the package file to the disk once per `putItem`/`putItems` call, before the hash index is committed
+		sl_bool flagSync;
+
+		// Maximum number of threads used to verify the hashes in `putItems` (0: number of CPU cores)
+		sl_uint32 maxThreadCount;
+		// Runs the parallel hashing tasks (null: the store creates its own pool at the first parallel task)
+		Ref<ThreadPool> threadPool;
+
+		// Stores the items of `chunkingThreshold` bytes or larger as content-defined chunks (FastCDC) and a manifest, so that the chunks shared by the items are stored once
+		sl_bool flagChunking;
+		sl_uint64 chunkingThreshold;
+		// Chunk sizes are limited from `averageChunkSize / 4` to `averageChunkSize * 4`. Must be power of 2
+		sl_uint32 averageChunkSize;
+
+		// Items of `treeHashThreshold` bytes or larger are addressed by ParallelHash256 (SP 800-185, hashed by all cores) instead of SHA3-256 (0: disabled).
+		// Saved in the store when it is created. Opening the store with a different value fails, because the stored items would not be found by their hashes
+		sl_uint64 treeHashThreshold;
+
 	public:
 		DataStoreParam();
 
@@ -52,6 +75,39 @@ namespace slib
 
 	};
 
+	class SLIB_EXPORT DataStoreItem
+	{
+	public:
+		DataStoreItemType type;
+		const void* hash; // Content address (32 bytes): see `DataStore::computeHash`
+		const void* data;
+		sl_size size;
+
+	public:
+		DataStoreItem();
+
+		DataStoreItem(DataStoreItemType type, const void* hash, const void* data, sl_size size);
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(DataStoreItem)
+
+	};
+
+	class SLIB_EXPORT DataStoreItemReader : public Object, public IReader
+	{
+		SLIB_DECLARE_OBJECT
+
+	public:
+		DataStoreItemReader();
+
+		~DataStoreItemReader();
+
+	public:
+		virtual DataStoreItemType getType() = 0;
+
+		virtual sl_uint64 getSize() = 0;
+
+	};
+
 	class SLIB_EXPORT DataStore : public Object
 	{
 		SLIB_DECLARE_OBJECT
@@ -65,12 +121,27 @@ namespace slib
 		static Ref<DataStore> open(const DataStoreParam& param);
 
 	public:
-		// `hash`: SHA3-256 Hash
+		// `hash`: content address (see `computeHash`)
 		virtual Memory getItem(const void* hash, DataStoreItemType* pOutType = sl_null) = 0;
 
-		// `hash`: SHA3-256 Hash
+		// `hash`: content address (see `computeHash`). Chunked items are read lazily, chunk by chunk
+		virtual Ref<DataStoreItemReader> openItem(const void* hash);
+
+		// `hash`: content address (see `computeHash`)
 		virtual sl_bool putItem(DataStoreItemType type, const void* hash, const void* data, sl_size size) = 0;
 
+		// Computes the hash while writing the item, so that the content is hashed once. `outHash`: 32 bytes
+		virtual sl_bool putItem(DataStoreItemType type, const void* data, sl_size size, void* outHash);
+
+		// Computes the content address of the item: ParallelHash256 for the items of `treeHashThreshold` bytes or larger, otherwise SHA3-256. `outHash`: 32 bytes
+		virtual void computeHash(const void* data, sl_size size, void* outHash);
+
+		// Verifies the hashes in parallel, appends the new items to the package by one write and commits the hash index by one batch.
+		// Returns `sl_true` when all items are stored (including the items which were already stored)
+		virtual sl_bool putItems(const DataStoreItem* items, sl_size nItems);
+
+		sl_bool putItems(const List<DataStoreItem>& items);
+
 	};
 
 }
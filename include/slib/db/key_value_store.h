@@ -26,14 +26,32 @@
 #include "definition.h"
 
 #include "../core/object.h"
+#include "../core/default_members.h"
 
 namespace slib
 {
 
 	class KeyValueStore;
 	class KeyValueIterator;
+	class MemoryView;
 	class MemoryData;
 
+	class SLIB_EXPORT KeyValueIteratorParam
+	{
+	public:
+		// Should the blocks read by the iterator be cached? Set `sl_false` for bulk scans
+		sl_bool flagFillCache;
+
+		// Size of read-ahead for the sequential scans (0: backend default)
+		sl_size readaheadSize;
+
+	public:
+		KeyValueIteratorParam();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(KeyValueIteratorParam)
+
+	};
+
 	class SLIB_EXPORT KeyValueReader
 	{
 	public:
@@ -49,8 +67,18 @@ namespace slib
 
 		virtual Variant get(const StringParam& key);
 
+		// Reads the values of `nKeys` keys at once. `outValues` and `outFlagsFound` (optional) should have `nKeys` elements.
+		// Returns the number of the found keys
+		virtual sl_size multiGet(const MemoryView* keys, sl_size nKeys, MemoryData* outValues, sl_bool* outFlagsFound = sl_null);
+
+		// Reads the value without copying it when the backend supports.
+		// `pOutValue->data` stays valid while `pOutValue->ref` is alive.
+		virtual sl_bool getPinned(const void* key, sl_size sizeKey, MemoryData* pOutValue);
+
 		virtual Ref<KeyValueIterator> getIterator() = 0;
 
+		virtual Ref<KeyValueIterator> getIterator(const KeyValueIteratorParam& param);
+
 	public:
 		static Variant deserialize(const MemoryData& data);
 		static Variant deserialize(MemoryData&& data);
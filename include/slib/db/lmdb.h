@@ -37,6 +37,8 @@ namespace slib
 
 		sl_bool flagCreateIfMissing;
 		sl_uint32 mode; // The UNIX permissions to set on created files and semaphores
+		// Maximum number of the read transactions alive at once (0: LMDB default, 126). Each snapshot, iterator and `multiGet` result holds one until released, and the values pinned by `getPinned` share one per committed version
+		sl_uint32 maxReaders;
 
 	public:
 		LMDB_Param();
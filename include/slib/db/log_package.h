@@ -30,10 +30,37 @@
 #include "../core/memory.h"
 #include "../core/list.h"
 #include "../core/pair.h"
+#include "../core/mutex.h"
+#include "../core/spin_lock.h"
+#include "../core/default_members.h"
 
 namespace slib
 {
 
+	class SLIB_EXPORT LogPackageAppenderParam
+	{
+	public:
+		StringParam pathContent;
+		StringParam pathIndex; // Default: `pathContent` + ".idx"
+
+		// Records are buffered until `blockSize` bytes (or `blockSize / 16` records) are collected. (0: written immediately)
+		sl_uint32 blockSize;
+
+		// Buffered blocks are compressed by Zstd
+		sl_bool flagCompress;
+		sl_int32 compressionLevel;
+
+		// Files are synchronized when `syncInterval` milliseconds passed or `syncSize` bytes are written since last sync. (0: disabled)
+		sl_uint32 syncInterval;
+		sl_uint64 syncSize;
+
+	public:
+		LogPackageAppenderParam();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(LogPackageAppenderParam)
+
+	};
+
 	class LogPackageAppender
 	{
 	public:
@@ -46,12 +73,60 @@ namespace slib
 
 		sl_bool open(const StringParam& pathContent, const StringParam& pathIndex);
 
+		sl_bool open(const LogPackageAppenderParam& param);
+
+		void close();
+
+		// Thread-safe
 		sl_bool appendRecord(sl_uint64 id, const MemoryView& content);
 
+		// Writes buffered records
+		sl_bool flush();
+
+		// Writes buffered records and synchronizes the files
+		sl_bool sync();
+
+	protected:
+		struct PendingRecord
+		{
+			sl_uint64 id;
+			sl_size offset;
+			sl_size size;
+		};
+
+		sl_bool _flush();
+
+		sl_bool _writeBlock(const void* data, sl_size size, const PendingRecord* records, sl_size nRecords);
+
+		sl_bool _sync(sl_bool flagForce);
+
 	protected:
 		File m_fileContent;
 		File m_fileIndex;
 
+		sl_uint32 m_sizeBlock;
+		sl_bool m_flagCompress;
+		sl_int32 m_compressionLevel;
+		sl_uint32 m_syncInterval;
+		sl_uint64 m_syncSize;
+
+		SpinLock m_lockBuffer;
+		Memory m_bufContent;
+		sl_size m_sizeContent;
+		Memory m_bufPending; // PendingRecord[m_maxPending]
+		sl_size m_countPending;
+		sl_size m_maxPending;
+		// Number of the records being copied into each of the two alternating buffers
+		volatile sl_reg m_countCopying[2];
+		sl_uint32 m_indexBuffer;
+
+		Mutex m_lockWrite;
+		Memory m_bufSpare;
+		Memory m_bufPendingSpare;
+		sl_uint64 m_positionContent;
+		sl_uint64 m_sizeNotSynced;
+		sl_uint64 m_tickLastSync;
+
 	};
 
 	class LogPackageReader
@@ -75,20 +150,29 @@ namespace slib
 		List< Pair<sl_uint64, Memory> > readRecords(sl_uint64 startId, sl_uint64 endId, sl_size maxSize = SLIB_SIZE_MAX);
 
 	protected:
-		Memory _readRecord(sl_uint64 position, sl_size size);
-
-	protected:
-		File m_fileContent;
-
 		struct Index
 		{
 			sl_uint64 position;
 			sl_uint64 size;
 			sl_uint64 id;
+			sl_uint32 offsetInBlock;
+			sl_uint32 sizeBlock; // 0: Not compressed
 		};
+
+		Memory _readRecord(const Index& index);
+
+		Memory _readBlock(sl_uint64 position, sl_uint32 size);
+
+	protected:
+		File m_fileContent;
+
 		Index* m_indices;
 		sl_size m_nIndices;
 
+		SpinLock m_lockCachedBlock;
+		sl_uint64 m_positionCachedBlock;
+		Memory m_cachedBlock;
+
 	};
 
 }
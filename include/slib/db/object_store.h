@@ -32,6 +32,7 @@ namespace slib
 
 	class ObjectStoreDictionary;
 	class ObjectStoreManager;
+	class ObjectStoreWriteBatch;
 	class KeyValueStore;
 
 	class SLIB_EXPORT ObjectStoreParam
@@ -88,6 +89,8 @@ namespace slib
 
 		PropertyIterator getItemIterator() const;
 
+		Ref<ObjectStoreWriteBatch> createWriteBatch() const;
+
 	public:
 		static const ObjectStore& undefined() noexcept
 		{
@@ -276,6 +279,32 @@ namespace slib
 		
 		virtual Ref<ObjectStoreDictionary> getRootDictionary() = 0;
 
+		virtual Ref<ObjectStoreWriteBatch> createWriteBatch() = 0;
+
+		// Clears the cache of the dictionary ids
+		virtual void clearCache() = 0;
+
+	};
+
+	// Buffers the changes on the dictionaries of a store, and applies them by one write batch of the underlying `KeyValueStore`
+	class SLIB_EXPORT ObjectStoreWriteBatch : public Referable
+	{
+		SLIB_DECLARE_OBJECT
+
+	public:
+		ObjectStoreWriteBatch();
+
+		~ObjectStoreWriteBatch();
+
+	public:
+		virtual sl_bool putItem(const ObjectStore& dictionary, const StringView& key, const Variant& value) = 0;
+
+		virtual sl_bool removeItem(const ObjectStore& dictionary, const StringView& key) = 0;
+
+		virtual sl_bool commit() = 0;
+
+		virtual void discard() = 0;
+
 	};
 
 }
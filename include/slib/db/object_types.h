@@ -71,7 +71,9 @@ namespace slib
 			DataStore,
 			DataStoreItem,
 			DataPackageReader,
-			DataPackageWriter
+			DataPackageWriter,
+			ObjectStoreWriteBatch,
+			DataStoreItemReader
 		};
 
 	}
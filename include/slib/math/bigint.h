@@ -923,6 +923,34 @@ namespace slib
 		BigInt operator>>(sl_size n) const noexcept;
 
 	};
+
+	/*
+		Precomputed Montgomery parameters of an odd modulus, for repeated modular operations with the same modulus (RSA keys, DH groups)
+	*/
+	class SLIB_EXPORT MontgomeryContext : public Referable
+	{
+	protected:
+		MontgomeryContext() noexcept;
+
+		~MontgomeryContext() noexcept;
+
+	public:
+		// returns null when M is not a positive odd value
+		static Ref<MontgomeryContext> create(const BigInt& M) noexcept;
+
+	public:
+		const BigInt& getModulus() const noexcept;
+
+		// C = A^E mod M (E >= 0)
+		BigInt pow(const BigInt& A, const BigInt& E) const noexcept;
+
+		// C = A * B mod M
+		BigInt mulMod(const BigInt& A, const BigInt& B) const noexcept;
+
+	protected:
+		BigInt m_modulus;
+
+	};
 	
 }
 
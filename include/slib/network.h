@@ -49,6 +49,8 @@
 #include "network/url_request.h"
 #include "network/curl.h"
 #include "network/http.h"
+#include "network/http2.h"
+#include "network/websocket.h"
 #include "network/stun.h"
 #include "network/smb.h"
 
@@ -41,6 +41,7 @@ namespace slib
 		SocketAddress bindAddress;
 		sl_bool flagIPv6; // default: false
 		sl_bool flagLogError; // default: true
+		sl_uint32 connectTimeout; // milliseconds, default: 0 (no timeout). Not supported on Windows
 		Ref<AsyncIoLoop> ioLoop;
 		
 	public:
@@ -78,6 +79,14 @@ namespace slib
 		sl_bool send(void* data, sl_size size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject = sl_null);
 		
 		sl_bool send(const Memory& mem, const Function<void(AsyncStreamResult&)>& callback);
+
+		// `callback` is called once, with the result of the last buffer
+		sl_bool sendVector(const MemoryView* buffers, sl_size count, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject = sl_null);
+
+		// Holds the queued writes until `uncork()`, so that a response written in pieces goes out by one vectored write
+		void cork();
+
+		void uncork();
 		
 	protected:
 		Ref<AsyncTcpSocketInstance> _getIoInstance();
@@ -85,7 +94,7 @@ namespace slib
 		void _onConnect(sl_bool flagError);
 
 	private:
-		static Ref<AsyncTcpSocketInstance> _createInstance(Socket&& socket, sl_bool flagIPv6);
+		static Ref<AsyncTcpSocketInstance> _createInstance(Socket&& socket, sl_bool flagIPv6, const Ref<AsyncIoLoop>& loop);
 		
 	protected:
 		AtomicFunction<void(AsyncTcpSocket*, sl_bool flagError)> m_onConnect;
@@ -150,7 +159,7 @@ namespace slib
 		void _onError();
 		
 	protected:
-		static Ref<AsyncTcpServerInstance> _createInstance(Socket&&, sl_bool flagIPv6);
+		static Ref<AsyncTcpServerInstance> _createInstance(Socket&&, sl_bool flagIPv6, const Ref<AsyncIoLoop>& loop);
 		
 	protected:
 		Function<void(AsyncTcpServer*, Socket&, SocketAddress&)> m_onAccept;
@@ -174,9 +183,13 @@ namespace slib
 		sl_bool flagAutoStart; // default: true
 		sl_bool flagLogError; // default: true
 		sl_uint32 packetSize; // default: 65536
+		sl_uint32 receiveBatchCount; // default: 1. Maximum datagrams received by one system call (recvmmsg on Linux), each having `packetSize` bytes of buffer
+		sl_bool flagReceiveOffload; // default: false. Linux: the kernel coalesces the datagrams of a flow (UDP GRO), which are split again before the callbacks. Raises `packetSize` to 65536
 		Ref<AsyncIoLoop> ioLoop;
 		
 		Function<void(AsyncUdpSocket*, SocketAddress&, void* data, sl_uint32 sizeReceived)> onReceiveFrom;
+		// Called instead of `onReceiveFrom` when set. A message holds one datagram. Datagrams truncated by a short `packetSize` are dropped when received in batches
+		Function<void(AsyncUdpSocket*, SocketMessage* messages, sl_uint32 nMessages)> onReceiveBatch;
 		Function<void(AsyncUdpSocket*)> onError;
 		
 	public:
@@ -219,19 +232,28 @@ namespace slib
 		sl_bool sendTo(const SocketAddress& addressTo, const void* data, sl_size size);
 		
 		sl_bool sendTo(const SocketAddress& addressTo, const MemoryView& mem);
+
+		// Returns the number of the sent datagrams
+		sl_uint32 sendToBatch(const SocketMessage* messages, sl_uint32 count);
+
+		// Sends `size` bytes as the datagrams of `segmentSize` bytes (UDP GSO on Linux)
+		sl_bool sendToSegmented(const SocketAddress& addressTo, const void* data, sl_size size, sl_uint32 segmentSize);
 		
 	protected:
 		Ref<AsyncUdpSocketInstance> _getIoInstance();
 		
 		void _onReceive(SocketAddress& address, void* data, sl_uint32 sizeReceived);
+
+		void _onReceiveBatch(SocketMessage* messages, sl_uint32 count);
 		
 		void _onError();
 		
 	protected:
-		static Ref<AsyncUdpSocketInstance> _createInstance(Socket&& socket, sl_uint32 packetSize);
+		static Ref<AsyncUdpSocketInstance> _createInstance(Socket&& socket, const AsyncUdpSocketParam& param, const Ref<AsyncIoLoop>& loop);
 		
 	protected:
 		Function<void(AsyncUdpSocket*, SocketAddress&, void* data, sl_uint32 sizeReceived)> m_onReceiveFrom;
+		Function<void(AsyncUdpSocket*, SocketMessage* messages, sl_uint32 nMessages)> m_onReceiveBatch;
 		Function<void(AsyncUdpSocket*)> m_onError;
 
 		friend class AsyncUdpSocketInstance;
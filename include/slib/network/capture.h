@@ -34,6 +34,7 @@
 namespace slib
 {
 
+	// `data` is valid only in the capture callback. In the packet ring mode, it points into the ring shared with the kernel
 	class SLIB_EXPORT NetCapturePacket
 	{
 	public:
@@ -59,8 +60,16 @@ namespace slib
 		NetworkLinkDeviceType preferedLinkDeviceType; // NetworkLinkDeviceType, used in Packet Socket mode. now supported Ethernet and Raw
 		
 		sl_bool flagAutoStart; // default: true
+
+		// Packet ring mode (`createPacketRing`)
+		sl_uint32 ringBlockSize; // default: 1MB. Multiple of the page size, in power of two
+		sl_uint32 ringBlockCount; // default: 64
+		sl_uint32 ringBlockTimeout; // default: 10ms. A block is retired to the user when it is full, or this time after its first packet
+		sl_uint32 threadCount; // default: 1. Above 1, every thread has its own ring in a fanout group, where the packets of a flow go to the same thread (PACKET_FANOUT_HASH). The callbacks are called concurrently
 		
 		Function<void(NetCapture*, NetCapturePacket&)> onCapturePacket;
+		// Called instead of `onCapturePacket` when set. In the packet ring mode, `packets` are all of a retired block
+		Function<void(NetCapture*, NetCapturePacket* packets, sl_uint32 nPackets)> onCapturePackets;
 		Function<void(NetCapture*)> onError;
 
 	public:
@@ -70,6 +79,20 @@ namespace slib
 		
 	};
 	
+	class SLIB_EXPORT NetCaptureStatistics
+	{
+	public:
+		sl_uint64 countPackets; // Packets passed to the user
+		sl_uint64 countDrops; // Packets dropped by the kernel, because of the full buffer
+		sl_uint64 countFreezes; // Packet ring mode: times the ring was full
+
+	public:
+		NetCaptureStatistics();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(NetCaptureStatistics)
+
+	};
+	
 	class SLIB_EXPORT NetCapture : public Object
 	{
 		SLIB_DECLARE_OBJECT
@@ -85,6 +108,9 @@ namespace slib
 		
 		// raw socket
 		static Ref<NetCapture> createRawIPv4(const NetCaptureParam& param);
+
+		// linux packet socket receiving by TPACKET_V3 mmap ring, without copying the packets. Returns null when not supported
+		static Ref<NetCapture> createPacketRing(const NetCaptureParam& param);
 		
 	public:
 		virtual void release() = 0;
@@ -102,6 +128,9 @@ namespace slib
 		
 		virtual String getErrorMessage();
 
+		// Returns false when not supported
+		virtual sl_bool getStatistics(NetCaptureStatistics& _out);
+
 	public:
 		const String& getDeviceName();
 
@@ -112,6 +141,8 @@ namespace slib
 		
 		void _onCapturePacket(NetCapturePacket& packet);
 
+		void _onCapturePackets(NetCapturePacket* packets, sl_uint32 nPackets);
+
 		void _onError();
 
 	protected:
@@ -121,6 +152,7 @@ namespace slib
 		MacAddress m_deviceAddress;
 
 		Function<void(NetCapture*, NetCapturePacket&)> m_onCapturePacket;
+		Function<void(NetCapture*, NetCapturePacket*, sl_uint32)> m_onCapturePackets;
 		Function<void(NetCapture*)> m_onError;
 
 	};
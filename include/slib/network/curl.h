@@ -104,6 +104,80 @@ namespace slib
 		
 	};
 
+	class AsyncIoLoop;
+
+	class SLIB_EXPORT CurlEngineParam
+	{
+	public:
+		Ref<AsyncIoLoop> ioLoop; // null: default loop
+
+		sl_uint32 maxConnectionsPerHost; // Requests over the limit wait for a free connection. 0: unlimited
+		sl_uint32 maxConnections; // 0: unlimited
+		sl_uint32 maxIdleConnections; // Size of the keep-alive connection pool
+
+		sl_bool flagHttp2; // Negotiates HTTP/2 by ALPN on https, and multiplexes the requests to the same host on one connection
+		sl_bool flagHttp2PriorKnowledge; // Uses HTTP/2 without the upgrade on http
+
+	public:
+		CurlEngineParam();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(CurlEngineParam)
+
+	};
+
+	class SLIB_EXPORT CurlEngineStatistics
+	{
+	public:
+		sl_uint64 countRequests; // Finished requests
+		sl_uint64 countErrors;
+		sl_uint64 countConnections; // Opened connections
+		sl_uint64 countReusedConnections; // Requests sent on a pooled connection
+		sl_uint64 countMultiplexedRequests; // Requests sent as the HTTP/2 streams
+		sl_uint32 countActiveRequests;
+		sl_uint32 maxActiveRequests;
+		sl_uint64 totalTime; // Sum of the request durations, in microseconds
+		sl_uint64 totalWaitTime; // Sum of the durations until the first byte of the responses, in microseconds
+
+	public:
+		CurlEngineStatistics();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(CurlEngineStatistics)
+
+	};
+
+	/*
+		Runs the asynchronous requests on a curl multi handle driven by `AsyncIoLoop`, without blocking a thread per request.
+		The connections, DNS results and TLS sessions are shared by the requests of the engine.
+		The callbacks of the requests are called on `UrlRequestParam::dispatcher`, or on the loop thread when it is null.
+		The asynchronous `UrlRequest`s on Linux are sent by the default engine.
+	*/
+	class SLIB_EXPORT CurlEngine : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		CurlEngine();
+
+		~CurlEngine();
+
+	public:
+		// Returns null on the platforms where `AsyncIoLoop` does not report the readiness of the sockets
+		static Ref<CurlEngine> create(const CurlEngineParam& param);
+
+		static Ref<CurlEngine> getDefault();
+
+	public:
+		virtual Ref<UrlRequest> send(const UrlRequestParam& param) = 0;
+
+		virtual Ref<AsyncIoLoop> getIoLoop() = 0;
+
+		virtual void getStatistics(CurlEngineStatistics& statistics) = 0;
+
+		// Fails the pending requests and closes the pooled connections
+		virtual void close() = 0;
+
+	};
+
 }
 
 #endif
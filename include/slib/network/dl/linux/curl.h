@@ -97,6 +97,80 @@ namespace slib
 		)
 		#define curl_slist_free_all slib::curl::getApi_curl_slist_free_all()
 
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_init,
+			CURLM*,
+		)
+		#define curl_multi_init slib::curl::getApi_curl_multi_init()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_cleanup,
+			CURLMcode, ,
+			CURLM *multi_handle
+		)
+		#define curl_multi_cleanup slib::curl::getApi_curl_multi_cleanup()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_add_handle,
+			CURLMcode, ,
+			CURLM *multi_handle, CURL *curl_handle
+		)
+		#define curl_multi_add_handle slib::curl::getApi_curl_multi_add_handle()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_remove_handle,
+			CURLMcode, ,
+			CURLM *multi_handle, CURL *curl_handle
+		)
+		#define curl_multi_remove_handle slib::curl::getApi_curl_multi_remove_handle()
+
+		#ifdef curl_multi_setopt
+		#undef curl_multi_setopt
+		#endif
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_setopt,
+			CURLMcode, ,
+			CURLM *multi_handle, CURLMoption option, ...
+		)
+		#define curl_multi_setopt slib::curl::getApi_curl_multi_setopt()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_socket_action,
+			CURLMcode, ,
+			CURLM *multi_handle, curl_socket_t s, int ev_bitmask, int *running_handles
+		)
+		#define curl_multi_socket_action slib::curl::getApi_curl_multi_socket_action()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_multi_info_read,
+			CURLMsg*, ,
+			CURLM *multi_handle, int *msgs_in_queue
+		)
+		#define curl_multi_info_read slib::curl::getApi_curl_multi_info_read()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_share_init,
+			CURLSH*,
+		)
+		#define curl_share_init slib::curl::getApi_curl_share_init()
+
+		#ifdef curl_share_setopt
+		#undef curl_share_setopt
+		#endif
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_share_setopt,
+			CURLSHcode, ,
+			CURLSH *share, CURLSHoption option, ...
+		)
+		#define curl_share_setopt slib::curl::getApi_curl_share_setopt()
+
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			curl_share_cleanup,
+			CURLSHcode, ,
+			CURLSH *share
+		)
+		#define curl_share_cleanup slib::curl::getApi_curl_share_cleanup()
+
 	SLIB_IMPORT_LIBRARY_END
 
 }
@@ -134,6 +134,13 @@ namespace slib
 		)
 		#define pcap_dispatch slib::pcap::getApi_pcap_dispatch()
 
+		SLIB_IMPORT_LIBRARY_FUNCTION(
+			pcap_stats,
+			int, ,
+			pcap_t *, struct pcap_stat *
+		)
+		#define pcap_stats slib::pcap::getApi_pcap_stats()
+
 		SLIB_IMPORT_LIBRARY_FUNCTION(
 			pcap_get_selectable_fd,
 			int, ,
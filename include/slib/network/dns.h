@@ -446,6 +446,83 @@ namespace slib
 	};
 	
 	
+	class SLIB_EXPORT DnsCacheParam
+	{
+	public:
+		sl_uint32 shardCount; // Number of the independently locked partitions
+		sl_uint32 maxEntries; // 0: unlimited
+
+		sl_uint32 minTTL; // seconds. TTLs of the cached answers are raised to this value
+		sl_uint32 maxTTL; // seconds
+		sl_uint32 maxNegativeTTL; // seconds. Limit of the negative answers (NXDOMAIN, NODATA), taken from SOA record of the authority section (RFC 2308)
+
+		sl_uint32 prefetchPercent; // Hot entries having less than this percent of TTL are refreshed before expiry. 0: no prefetch
+		sl_uint32 prefetchMinHits; // Hits needed to regard an entry as hot
+
+	public:
+		DnsCacheParam();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(DnsCacheParam)
+
+	};
+
+	class SLIB_EXPORT DnsCacheStatistics
+	{
+	public:
+		sl_uint64 countHits;
+		sl_uint64 countNegativeHits; // Included in `countHits`
+		sl_uint64 countMisses;
+		sl_uint64 countInsertions;
+		sl_uint64 countEvictions; // Removed to keep `maxEntries`, not counting the expired entries
+		sl_uint64 countPrefetches;
+		sl_size countEntries;
+
+	public:
+		DnsCacheStatistics();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(DnsCacheStatistics)
+
+	};
+
+	/*
+		Caches the wire-format responses keyed by the question (name, type and class, ignoring the case of the name) and its DNSSEC flags (CD, and DO of EDNS).
+		A hit is a copy of the stored response having the transaction id, the letter case of the question name and the remaining TTLs patched.
+		A hit larger than the UDP payload size of the question (512 bytes without EDNS) is truncated to the question and the OPT record, having TC flag.
+	*/
+	class SLIB_EXPORT DnsCache : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		DnsCache();
+
+		~DnsCache();
+
+	public:
+		static Ref<DnsCache> create(const DnsCacheParam& param);
+
+		static Ref<DnsCache> create();
+
+	public:
+		// `query`: wire-format question. `pFlagPrefetch` is set when the hit is a hot entry near expiry, which the caller should refresh from upstream
+		virtual Memory getResponse(const void* query, sl_uint32 size, sl_bool* pFlagPrefetch = sl_null) = 0;
+
+		Memory getResponse(sl_uint16 id, const String& name, DnsRecordType type = DnsRecordType::A, sl_bool* pFlagPrefetch = sl_null);
+
+		// Returns false when the response is not cacheable (truncated, server failure, zero TTL, negative answer without SOA, ...)
+		virtual sl_bool putResponse(const void* response, sl_uint32 size) = 0;
+
+		virtual void removeAll() = 0;
+
+		virtual void getStatistics(DnsCacheStatistics& statistics) = 0;
+
+	public:
+		// Returns the cache key of the single question of `packet`, or null when the packet has no cacheable question
+		static String getQuestionKey(const void* packet, sl_uint32 size);
+
+	};
+	
+	
 	class DnsClient;
 	
 	class SLIB_EXPORT DnsClientParam
@@ -454,6 +531,12 @@ namespace slib
 		Function<void(DnsClient*, const SocketAddress&, const DnsPacket&)> onAnswer;
 
 		Ref<AsyncIoLoop> ioLoop;
+
+		sl_bool flagCache; // default: true. Cached answers are delivered by `onAnswer` without sending the question. Hot entries near expiry are also refreshed, and the fresh answer is delivered again
+		Ref<DnsCache> cache; // Shared cache. null: creates a private cache by `cacheParam`
+		DnsCacheParam cacheParam;
+
+		sl_uint32 coalesceTimeout; // milliseconds. An identical question to the same server is not sent again while the previous one is unanswered within this time
 		
 	public:
 		DnsClientParam();
@@ -478,15 +561,31 @@ namespace slib
 		void sendQuestion(const SocketAddress& serverAddress, const String& hostName);
 		
 		void sendQuestion(const IPv4Address& serverIp, const String& hostName);
+
+		Ref<DnsCache> getCache();
 		
 	protected:
 		void _onReceiveFrom(AsyncUdpSocket* socket, const SocketAddress& address, void* data, sl_uint32 sizeReceive);
 
 		void _onAnswer(const SocketAddress& serverAddress, const DnsPacket& packet);
+
+		void _onCachedAnswer(const SocketAddress& serverAddress, const Memory& answer);
 		
 	protected:
 		Ref<AsyncUdpSocket> m_udp;
 		sl_uint16 m_idLast;
+
+		Ref<DnsCache> m_cache;
+		sl_uint32 m_coalesceTimeout;
+
+		struct PendingQuestion
+		{
+			SocketAddress serverAddress;
+			String questionKey;
+			sl_uint64 timeSent;
+		};
+		CHashMap<sl_uint16, PendingQuestion> m_mapPending;
+		CHashMap<String, sl_uint16> m_mapPendingQuestion; // server address + question key => id
 		
 		Function<void(DnsClient*, const SocketAddress&, const DnsPacket&)> m_onAnswer;
 
@@ -538,6 +637,12 @@ namespace slib
 		sl_bool flagAutoStart;
 		
 		Ref<AsyncIoLoop> ioLoop;
+
+		sl_bool flagCache; // default: true. Answers of the forwarded questions are cached and served without forwarding again
+		Ref<DnsCache> cache; // Shared cache. null: creates a private cache by `cacheParam`
+		DnsCacheParam cacheParam;
+
+		sl_uint32 coalesceTimeout; // milliseconds. Identical questions arriving while one is forwarded wait for its answer instead of being forwarded, within this time
 		
 		Function<void(DnsServer*, DnsResolveHostParam&)> onResolve;
 		Function<void(DnsServer*, const String& hostName, const IPAddress& hostAddress)> onCache;
@@ -570,17 +675,29 @@ namespace slib
 		void start();
 		
 		sl_bool isRunning();
+
+		Ref<DnsCache> getCache();
+
+		sl_uint64 getForwardedQuestionCount();
+
+		// Questions answered by the answer of an identical question in flight
+		sl_uint64 getCoalescedQuestionCount();
 		
 	protected:
 		void _processReceivedDnsQuestion(const SocketAddress& clientAddress, sl_uint16 id, const String& hostName, sl_bool flagEncryptedRequest);
 		
-		void _processReceivedDnsAnswer(const DnsPacket& packet);
+		void _processReceivedDnsAnswer(const DnsPacket& packet, const void* data, sl_uint32 size);
 		
 		void _processReceivedProxyQuestion(const SocketAddress& clientAddress, void* data, sl_uint32 size, sl_bool flagEncryptedRequest);
 		
 		void _processReceivedProxyAnswer(void* data, sl_uint32 size);
 		
 		void _sendPacket(sl_bool flagEncrypted, const SocketAddress& targetAddress, const MemoryView& packet);
+
+		sl_bool _sendCachedAnswer(const SocketAddress& clientAddress, const void* query, sl_uint32 sizeQuery, sl_bool flagEncrypted, sl_bool* pFlagPrefetch);
+
+		// Returns true when the question is coalesced into the identical one in flight
+		sl_bool _coalesceQuestion(const String& questionKey, const SocketAddress& clientAddress, sl_uint16 requestedId, const String& requestedHostName, const void* query, sl_uint32 sizeQuery, sl_bool flagEncrypted);
 		
 		Memory _buildQuestionPacket(sl_uint16 id, const String& host, sl_bool flagEncrypt);
 		
@@ -608,19 +725,38 @@ namespace slib
 		sl_bool m_flagEncryptDefaultForward;
 		
 		sl_uint16 m_lastForwardId;
+
+		Ref<DnsCache> m_cache;
+		sl_uint32 m_coalesceTimeout;
 		
-		struct ForwardElement
+		struct ForwardClient
 		{
 			SocketAddress clientAddress;
 			sl_uint16 requestedId;
 			String requestedHostName;
 			sl_bool flagEncrypted;
+			Memory query; // coalesced proxy question, of which name is echoed in the answer
+		};
+		struct ForwardElement : ForwardClient
+		{
+			String questionKey;
+			sl_uint64 timeForward;
+			List<ForwardClient> coalescedClients;
 		};
 		CHashMap<sl_uint16, ForwardElement> m_mapForward;
+		CHashMap<String, sl_uint16> m_mapForwardQuestion; // question key => forward id
+
+		sl_uint64 m_countForwarded;
+		sl_uint64 m_countCoalesced;
 		
 		Function<void(DnsServer*, DnsResolveHostParam&)> m_onResolve;
 		Function<void(DnsServer*, const String& hostName, const IPAddress& hostAddress)> m_onCache;
 
+	private:
+		void _registerForward(sl_uint16 idForward, ForwardElement& element);
+
+		sl_bool _takeForward(sl_uint16 idForward, ForwardElement& element);
+
 	};
 
 }
@@ -0,0 +1,338 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_NETWORK_HTTP2
+#define CHECKHEADER_SLIB_NETWORK_HTTP2
+
+/****************************************************************************
+
+		Hypertext Transfer Protocol Version 2 -- HTTP/2
+
+	https://tools.ietf.org/html/rfc9113
+
+		HPACK: Header Compression for HTTP/2
+
+	https://tools.ietf.org/html/rfc7541
+
+		Extensible Prioritization Scheme for HTTP
+
+	https://tools.ietf.org/html/rfc9218
+
+****************************************************************************/
+
+#include "definition.h"
+
+#include "../core/string.h"
+#include "../core/list.h"
+#include "../core/memory_output.h"
+
+#define SLIB_HTTP2_CONNECTION_PREFACE "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"
+#define SLIB_HTTP2_CONNECTION_PREFACE_SIZE 24
+
+namespace slib
+{
+
+	enum class Http2FrameType
+	{
+		Data = 0,
+		Headers = 1,
+		Priority = 2,
+		RstStream = 3,
+		Settings = 4,
+		PushPromise = 5,
+		Ping = 6,
+		GoAway = 7,
+		WindowUpdate = 8,
+		Continuation = 9,
+		PriorityUpdate = 16 // RFC 9218
+	};
+
+	enum class Http2ErrorCode
+	{
+		NoError = 0,
+		ProtocolError = 1,
+		InternalError = 2,
+		FlowControlError = 3,
+		SettingsTimeout = 4,
+		StreamClosed = 5,
+		FrameSizeError = 6,
+		RefusedStream = 7,
+		Cancel = 8,
+		CompressionError = 9,
+		ConnectError = 10,
+		EnhanceYourCalm = 11,
+		InadequateSecurity = 12,
+		Http_1_1_Required = 13
+	};
+
+	enum class Http2SettingId
+	{
+		HeaderTableSize = 1,
+		EnablePush = 2,
+		MaxConcurrentStreams = 3,
+		InitialWindowSize = 4,
+		MaxFrameSize = 5,
+		MaxHeaderListSize = 6
+	};
+
+	/*
+		Frame Header
+
+	 +-----------------------------------------------+
+	 |                 Length (24)                   |
+	 +---------------+---------------+---------------+
+	 |   Type (8)    |   Flags (8)   |
+	 +-+-------------+---------------+-------------------------------+
+	 |R|                 Stream Identifier (31)                      |
+	 +=+=============================================================+
+	*/
+	class SLIB_EXPORT Http2FrameHeader
+	{
+	public:
+		enum
+		{
+			HeaderSize = 9,
+			DefaultMaxFrameSize = 16384,
+			DefaultWindowSize = 65535,
+			MaxWindowSize = 0x7fffffff
+		};
+
+		enum
+		{
+			FlagEndStream = 0x01,
+			FlagAck = 0x01,
+			FlagEndHeaders = 0x04,
+			FlagPadded = 0x08,
+			FlagPriority = 0x20
+		};
+
+	public:
+		sl_uint32 getLength() const
+		{
+			return ((sl_uint32)(_length[0]) << 16) | ((sl_uint32)(_length[1]) << 8) | ((sl_uint32)(_length[2]));
+		}
+
+		void setLength(sl_uint32 length)
+		{
+			_length[0] = (sl_uint8)(length >> 16);
+			_length[1] = (sl_uint8)(length >> 8);
+			_length[2] = (sl_uint8)(length);
+		}
+
+		Http2FrameType getType() const
+		{
+			return (Http2FrameType)_type;
+		}
+
+		void setType(Http2FrameType type)
+		{
+			_type = (sl_uint8)type;
+		}
+
+		sl_uint8 getFlags() const
+		{
+			return _flags;
+		}
+
+		void setFlags(sl_uint8 flags)
+		{
+			_flags = flags;
+		}
+
+		sl_bool isEndStream() const
+		{
+			return (_flags & FlagEndStream) != 0;
+		}
+
+		sl_bool isAck() const
+		{
+			return (_flags & FlagAck) != 0;
+		}
+
+		sl_bool isEndHeaders() const
+		{
+			return (_flags & FlagEndHeaders) != 0;
+		}
+
+		sl_bool isPadded() const
+		{
+			return (_flags & FlagPadded) != 0;
+		}
+
+		sl_bool isPriority() const
+		{
+			return (_flags & FlagPriority) != 0;
+		}
+
+		sl_uint32 getStreamId() const
+		{
+			return ((sl_uint32)(_streamId[0] & 0x7f) << 24) | ((sl_uint32)(_streamId[1]) << 16) | ((sl_uint32)(_streamId[2]) << 8) | ((sl_uint32)(_streamId[3]));
+		}
+
+		void setStreamId(sl_uint32 streamId)
+		{
+			_streamId[0] = (sl_uint8)((streamId >> 24) & 0x7f);
+			_streamId[1] = (sl_uint8)(streamId >> 16);
+			_streamId[2] = (sl_uint8)(streamId >> 8);
+			_streamId[3] = (sl_uint8)(streamId);
+		}
+
+	private:
+		sl_uint8 _length[3];
+		sl_uint8 _type;
+		sl_uint8 _flags;
+		sl_uint8 _streamId[4];
+
+	};
+
+	class SLIB_EXPORT HpackHeaderField
+	{
+	public:
+		String name;
+		String value;
+
+	public:
+		HpackHeaderField();
+
+		HpackHeaderField(const String& name, const String& value);
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(HpackHeaderField)
+
+	public:
+		// Size counted by the dynamic table: length of the name and the value + 32
+		sl_size getSize() const;
+
+	};
+
+	class SLIB_EXPORT HpackDynamicTable
+	{
+	public:
+		HpackDynamicTable();
+
+		~HpackDynamicTable();
+
+		SLIB_DELETE_CLASS_DEFAULT_MEMBERS(HpackDynamicTable)
+
+	public:
+		sl_uint32 getCount() const;
+
+		sl_size getSize() const;
+
+		sl_size getMaxSize() const;
+
+		// Evicts the oldest entries which exceed the new size
+		void setMaxSize(sl_size size);
+
+		// `index`: 0 is the newest entry
+		const HpackHeaderField* getAt(sl_uint32 index) const;
+
+		// Entries larger than the table empty the table and are not added
+		void add(const String& name, const String& value);
+
+		void clear();
+
+	protected:
+		void _evict(sl_size sizeRequired);
+
+	protected:
+		List<HpackHeaderField> m_entries; // ring buffer
+		sl_uint32 m_first; // position of the oldest entry
+		sl_uint32 m_count;
+		sl_size m_size;
+		sl_size m_maxSize;
+
+	};
+
+	class SLIB_EXPORT HpackEncoder
+	{
+	public:
+		HpackEncoder();
+
+		~HpackEncoder();
+
+		SLIB_DELETE_CLASS_DEFAULT_MEMBERS(HpackEncoder)
+
+	public:
+		// SETTINGS_HEADER_TABLE_SIZE of the peer. The size update is sent at the beginning of the next header block
+		void setMaxTableSize(sl_uint32 size);
+
+		// `name` must be lowercase. The values of sensitive fields (authorization, cookie, set-cookie) are never indexed
+		sl_bool encode(MemoryOutput& output, const StringView& name, const StringView& value);
+
+		sl_bool encode(MemoryOutput& output, const StringView& name, const StringView& value, sl_bool flagIndexing, sl_bool flagNeverIndexed);
+
+	public:
+		static sl_bool encodeInteger(MemoryOutput& output, sl_uint8 prefix, sl_uint32 nPrefixBits, sl_uint64 value);
+
+		// Uses the Huffman code when it is shorter
+		static sl_bool encodeString(MemoryOutput& output, const StringView& str);
+
+	protected:
+		HpackDynamicTable m_table;
+		sl_uint32 m_maxTableSizeLimit;
+		sl_uint32 m_maxTableSizeUpdate;
+		sl_bool m_flagTableSizeUpdate;
+
+	};
+
+	class SLIB_EXPORT HpackDecoder
+	{
+	public:
+		HpackDecoder();
+
+		~HpackDecoder();
+
+		SLIB_DELETE_CLASS_DEFAULT_MEMBERS(HpackDecoder)
+
+	public:
+		// SETTINGS_HEADER_TABLE_SIZE sent to the peer. default: 4096
+		void setMaxTableSizeLimit(sl_uint32 size);
+
+		// Decodes a complete header block. Returns `sl_false` on the compression errors, after which the decoder state is not usable
+		sl_bool decode(const void* data, sl_size size, List<HpackHeaderField>& fields, sl_size maxHeaderListSize = 0);
+
+	public:
+		static sl_bool decodeInteger(const sl_uint8*& data, const sl_uint8* end, sl_uint32 nPrefixBits, sl_uint32& value);
+
+		static sl_bool decodeString(const sl_uint8*& data, const sl_uint8* end, String& str);
+
+	protected:
+		HpackDynamicTable m_table;
+		sl_uint32 m_maxTableSizeLimit;
+
+	};
+
+	class SLIB_EXPORT HpackHuffman
+	{
+	public:
+		static sl_size getEncodedLength(const void* data, sl_size size);
+
+		// `output` must have `getEncodedLength()` bytes. Returns the written size
+		static sl_size encode(const void* data, sl_size size, void* output);
+
+		static sl_bool decode(const void* data, sl_size size, String& output);
+
+	};
+
+}
+
+#endif
@@ -170,6 +170,7 @@ namespace slib
 		static const String& CacheControl;
 		static const String& ContentDisposition;
 		static const String& Authorization;
+		static const String& Upgrade;
 
 		// Entity Headers
 		static const String& ContentLength;
@@ -184,6 +185,8 @@ namespace slib
 		static const String& Range;
 		static const String& IfModifiedSince;
 		static const String& Depth;
+		static const String& SecWebSocketKey;
+		static const String& SecWebSocketVersion;
 
 		// Response Headers
 		static const String& TransferEncoding;
@@ -198,8 +201,13 @@ namespace slib
 		static const String& ContentRange;
 		static const String& LastModified;
 		static const String& Location;
+		static const String& SecWebSocketAccept;
 		static const String& DAV; // WebDAV
 
+		// WebSocket Headers (Request and Response)
+		static const String& SecWebSocketProtocol;
+		static const String& SecWebSocketExtensions;
+
 	};
 
 	class SLIB_EXPORT HttpHeaderHelper
@@ -25,6 +25,7 @@
 
 #include "http_common.h"
 #include "http_io.h"
+#include "websocket.h"
 #include "socket_address.h"
 
 #include "../core/io.h"
@@ -37,8 +38,11 @@ namespace slib
 
 	class HttpServer;
 	class HttpServerConnection;
+	class Http2ServerSession;
 
 	class ThreadPool;
+	class MemoryPool;
+	class MemoryPoolStatus;
 	
 	class SLIB_EXPORT HttpServerContext : public Object, public HttpRequest, public HttpResponse, public HttpOutputBuffer
 	{
@@ -92,6 +96,16 @@ namespace slib
 		sl_bool isKeepAlive() const;
 		
 		void setKeepAlive(sl_bool flag = sl_true);
+
+		// GET request with `Upgrade: websocket` and the version 13 handshake headers
+		sl_bool isWebSocketRequest() const;
+
+		// Answers `101 Switching Protocols` and hands the connection over to the returned socket, which is kept by the server until it closes.
+		// Returns null if the request is not a WebSocket request
+		Ref<WebSocket> acceptWebSocket(const WebSocketParam& param, const String& protocol = sl_null);
+
+		// Identifier of the HTTP/2 stream carrying the request. 0: HTTP/1.x request
+		sl_uint32 getHttp2StreamId() const;
 		
 	protected:
 		HttpHeaderReader m_requestHeaderReader;
@@ -106,11 +120,14 @@ namespace slib
 		sl_bool m_flagKeepAlive;
 
 		sl_bool m_flagBeganProcessing;
+
+		sl_uint32 m_http2StreamId;
 		
 	private:
 		WeakRef<HttpServerConnection> m_connection;
 		
 		friend class HttpServerConnection;
+		friend class Http2ServerSession;
 		
 	};
 	
@@ -150,6 +167,9 @@ namespace slib
 		void sendConnectResponse_Failed();
 		
 		void sendProxyResponse_Failed();
+
+		// Stops processing HTTP and returns the stream to the caller. `dataUnprocessed` receives the bytes read after the current request
+		Ref<AsyncStream> detachIO(Memory& dataUnprocessed);
 		
 	public:
 		SLIB_PROPERTY(SocketAddress, LocalAddress)
@@ -167,19 +187,28 @@ namespace slib
 		sl_bool m_flagFreed;
 		sl_bool m_flagClosed;
 		Memory m_bufRead;
+		Ref<MemoryPool> m_poolRead;
+		Function<void(AsyncStreamResult&)> m_callbackRead;
 		sl_bool m_flagReading;
 		sl_bool m_flagKeepAlive;
 		List<char> m_bufReadUnprocessed;
 		sl_uint64 m_timeLastRead;
+
+		sl_bool m_flagFirstRequest;
+		AtomicRef<Http2ServerSession> m_http2;
 		
 	protected:
 		void _free();
 
-		void _read(AsyncStreamResult* result);
+		void _read();
 		
 		void _processInput(AsyncStreamResult* result);
+
+		sl_bool _beginProcessing(const Ref<HttpServerContext>& context);
 		
 		void _processContext(const Ref<HttpServerContext>& context);
+
+		sl_bool _upgradeHttp2(const Ref<HttpServerContext>& context);
 		
 	public:
 		void completeContext(HttpServerContext* context);
@@ -191,6 +220,7 @@ namespace slib
 		
 		friend class HttpServerContext;
 		friend class HttpServer;
+		friend class Http2ServerSession;
 		
 	};
 	
@@ -351,7 +381,16 @@ namespace slib
 
 		sl_bool flagSupportWebDAV;
 
+		// Accepts HTTP/2 by the connection preface (prior knowledge or ALPN "h2" on the HTTPS bindings) and by `Upgrade: h2c`. default: false
+		sl_bool flagSupportHttp2;
+		sl_uint32 http2MaxConcurrentStreams;
+		sl_uint32 http2MaxResetRate; // Streams canceled by the client (RST_STREAM) or refused by `http2MaxConcurrentStreams`, per second. Above this rate, the connection is closed by GOAWAY(ENHANCE_YOUR_CALM). 0: no limit
+		sl_uint32 http2InitialWindowSize; // Receiving window of the streams and the connection
+
 		sl_uint32 connectionExpiringDuration;
+
+		// Maximum number of the idle read buffers kept for reuse. The connections borrow a buffer only while the data is arriving. 0: each connection keeps its own buffer
+		sl_uint32 readBufferPoolSize;
 		
 		sl_bool flagLogDebug;
 		
@@ -405,6 +444,10 @@ namespace slib
 		Ref<ThreadPool> getThreadPool();
 		
 		const HttpServerParam& getParam();
+
+		Ref<MemoryPool> getReadBufferPool();
+
+		void getReadBufferPoolStatus(MemoryPoolStatus& status);
 		
 	public:
 		// called before processing body, returns true if the server is trying to process the connection itself.
@@ -451,6 +494,18 @@ namespace slib
 		void addConnectionProvider(const Ref<HttpServerConnectionProvider>& provider);
 		
 		void removeConnectionProvider(const Ref<HttpServerConnectionProvider>& provider);
+
+
+		List< Ref<WebSocket> > getWebSockets();
+
+		sl_size getWebSocketCount();
+
+		void addWebSocket(const Ref<WebSocket>& socket);
+
+		void removeWebSocket(WebSocket* socket);
+
+		// Sends the message to all the accepted WebSocket connections, sharing one frame among them. Returns the number of the connections which queued the message
+		sl_size broadcastWebSocket(WebSocketOpcode opcode, const void* data, sl_size size);
 		
 		
 		sl_bool addHttpBinding(const SocketAddress& addr);
@@ -486,7 +541,11 @@ namespace slib
 		Ref<Timer> m_timerExpireConnections;
 		
 		CList< Ref<HttpServerConnectionProvider> > m_connectionProviders;
+
+		CHashMap< WebSocket*, Ref<WebSocket> > m_webSockets;
 		
+		Ref<MemoryPool> m_poolReadBuffer;
+
 		HttpServerParam m_param;
 		
 	};
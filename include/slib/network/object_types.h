@@ -57,7 +57,10 @@ namespace slib
 			IPC,
 			SmbServer,
 			SmbServerShare,
-			SmbServerFileContext
+			SmbServerFileContext,
+			WebSocket,
+			CurlEngine,
+			DnsCache
 		};
 
 	}
@@ -35,6 +35,7 @@ namespace slib
 {
 	
 	class NetCapture;
+	class NetCapturePacket;
 
 	enum class TcpConnectionType
 	{
@@ -49,6 +50,45 @@ namespace slib
 		String host;
 	};
 
+	class SLIB_EXPORT PacketAnalyzerStatistics
+	{
+	public:
+		// Input
+		sl_uint64 countPackets;
+		sl_uint64 countBytes;
+		sl_uint64 countDrops; // Dropped because the queue of the worker was full
+
+		// Protocols
+		sl_uint64 countIPv4;
+		sl_uint64 countInvalidIPv4;
+		sl_uint64 countArp;
+		sl_uint64 countTcp;
+		sl_uint64 countUdp;
+		sl_uint64 countIcmp;
+
+		// Contents
+		sl_uint64 countDns;
+		sl_uint64 countHttp;
+		sl_uint64 countHttps;
+		sl_uint64 countBlocked;
+
+		// Flow table
+		sl_uint64 countFlowsCreated;
+		sl_uint64 countFlowsExpired;
+		sl_uint64 countFlowsEvicted; // Removed to keep the capacity of the flow table
+		sl_size countFlows;
+
+	public:
+		PacketAnalyzerStatistics();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(PacketAnalyzerStatistics)
+
+	};
+
+	/*
+		The packets are distributed to the lanes by the symmetric hash of the flow (addresses, ports and protocol), so both directions of a flow are always analyzed in the same lane.
+		Each lane owns a flow table. Without workers, the lanes are locked by the calling threads. After `startWorkers()`, each lane is owned by a worker thread and the callbacks are invoked on the workers.
+	*/
 	class SLIB_EXPORT PacketAnalyzer
 	{
 	public:
@@ -60,6 +100,10 @@ namespace slib
 		void putCapturedPacket(NetCapture* capture, NetworkLinkDeviceType type, const void* frame, sl_size size, void* userData);
 
 		void putCapturedPacket(NetCapture* capture, const void* frame, sl_size size, void* userData);
+
+		void putCapturedPackets(NetCapture* capture, NetworkLinkDeviceType type, NetCapturePacket* packets, sl_uint32 nPackets, void* userData);
+
+		void putCapturedPackets(NetCapture* capture, NetCapturePacket* packets, sl_uint32 nPackets, void* userData);
 		
 		void putEthernet(NetCapture* capture, const void* frame, sl_size size, void* userData);
 
@@ -75,6 +119,17 @@ namespace slib
 		String getDnsHost(const IPv4Address& ip);
 
 
+		// `nWorkers`: 0 means the count of the cpu cores. Call before putting the packets: the flows analyzed so far are dropped. `capture` and `userData` of the queued packets should be valid until `stopWorkers()`
+		sl_bool startWorkers(sl_uint32 nWorkers = 0);
+
+		// Analyzes the queued packets and stops the workers. Call before destroying the derived class
+		void stopWorkers();
+
+		sl_uint32 getWorkerCount();
+
+		void getStatistics(PacketAnalyzerStatistics& _out);
+
+
 		void setLogging(sl_bool flag = sl_true);
 
 
@@ -104,6 +159,15 @@ namespace slib
 
 		void setBlockingTcpConnections(sl_bool flag = sl_true);
 
+		// Applied to the lanes created after the call
+		void setFlowTableCapacity(sl_uint32 capacity);
+
+		// Milliseconds
+		void setFlowTimeout(sl_uint32 timeout);
+
+		// Bytes per worker
+		void setWorkerQueueSize(sl_uint32 size);
+
 	protected:
 		virtual void onIPv4(IPv4Packet* packet, void* userData);
 
@@ -135,11 +199,14 @@ namespace slib
 			sl_uint8* packet;
 			sl_uint32 sizePacket;
 			void* userData;
+			void* lane;
 		};
 
+		void analyzeFrame(const PacketParam& param);
+
 		void analyzeIP(const PacketParam& param);
 
-		void analyzeTcpContent(IPv4Packet* packet, TcpSegment* tcp, sl_uint8* data, sl_uint32 sizeData, void* userData);
+		void analyzeTcpContent(const PacketParam& param, IPv4Packet* packet, TcpSegment* tcp, sl_uint8* data, sl_uint32 sizeData);
 
 		void registerHostInfo(IPv4Packet* packet, TcpSegment* tcp, TcpConnectionType type, const String& host);
 
@@ -165,8 +232,12 @@ namespace slib
 		sl_bool m_flagCaptureUnknownFrames;
 		sl_bool m_flagBlockingTcpConnections;
 
-		Ref<Referable> m_contentAnalyzer;
-		Mutex m_lockContentAnalyzer;
+		sl_uint32 m_flowTableCapacity;
+		sl_uint32 m_flowTimeout;
+		sl_uint32 m_sizeWorkerQueue;
+
+		Ref<Referable> m_pipeline;
+		Mutex m_lockPipeline;
 
 		HashTable<sl_uint64, TcpConnectionInfo> m_tableTcpConnectionInfo;
 		ReadWriteLock m_lockTcpConnectionInfo;
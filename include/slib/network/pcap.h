@@ -95,6 +95,9 @@ namespace slib
 		
 		static Ref<Pcap> createAny(const PcapParam& param);
 
+		// Linux: captures by `NetCapture::createPacketRing`, falling back to pcap when the packet ring is not available
+		static Ref<NetCapture> createWithPacketRing(const PcapParam& param);
+
 
 		static sl_bool isAllowedNonRoot(const StringParam& executablePath);
 
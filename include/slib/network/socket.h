@@ -135,7 +135,22 @@ namespace slib
 		
 	};
 
+	class SLIB_EXPORT SocketMessage
+	{
+	public:
+		SocketAddress address;
+		void* data;
+		sl_uint32 size; // receiving: size of the buffer on input, received size on output
+		sl_uint32 segmentSize; // received by UDP GRO: size of the coalesced datagrams (the last one can be shorter), 0: not coalesced
+		sl_bool flagTruncated; // received: the datagram was larger than the buffer, and the rest was discarded (MSG_TRUNC)
+
+	public:
+		SocketMessage() noexcept: data(sl_null), size(0), segmentSize(0), flagTruncated(sl_false) {}
+
+	};
+
 	class SocketEvent;
+	class MemoryView;
 	
 	class SLIB_EXPORT Socket
 	{
@@ -251,6 +266,9 @@ namespace slib
 
 		sl_reg sendFully(const void* buf, sl_size size, SocketEvent* ev = sl_null) const noexcept;
 
+		// Sends the buffers in order by one system call (sendmsg, WSASend), without concatenating them. Returns the sent size
+		sl_int32 sendVector(const MemoryView* buffers, sl_uint32 count) const noexcept;
+
 		sl_int32 write32(const void* buf, sl_uint32 size) const noexcept;
 
 		sl_reg write(const void* buf, sl_size size) const noexcept;
@@ -259,6 +277,9 @@ namespace slib
 
 		sl_int32 receive(void* buf, sl_size size) const noexcept;
 
+		// Receives without removing the data from the queue (MSG_PEEK)
+		sl_int32 peek(void* buf, sl_size size) const noexcept;
+
 		sl_reg receiveFully(void* buf, sl_size size, SocketEvent* ev = sl_null) const noexcept;
 
 		sl_int32 read32(void* buf, sl_uint32 size) const noexcept;
@@ -279,6 +300,15 @@ namespace slib
 
 		sl_int32 receiveFromDomain(void* buf, sl_size size, String& outPath, sl_bool* pOutFlagAbstract = sl_null) const noexcept;
 
+		// Receives up to `count` datagrams by one system call on Linux (recvmmsg). Returns the number of the received datagrams
+		sl_int32 receiveFromBatch(SocketMessage* messages, sl_uint32 count) const noexcept;
+
+		// Sends the datagrams by one system call on Linux (sendmmsg). Returns the number of the sent datagrams
+		sl_int32 sendToBatch(const SocketMessage* messages, sl_uint32 count) const noexcept;
+
+		// Sends `size` bytes as the datagrams of `segmentSize` bytes, segmented by the kernel or the device on Linux (UDP GSO). Returns the sent size
+		sl_int32 sendToSegmented(const SocketAddress& address, const void* buf, sl_size size, sl_uint32 segmentSize) const noexcept;
+
 		sl_int32 sendPacket(const void* buf, sl_size size, const L2PacketInfo& info) const noexcept;
 		
 		sl_int32 receivePacket(const void* buf, sl_size size, L2PacketInfo& info) const noexcept;
@@ -336,6 +366,9 @@ namespace slib
 		sl_bool setOption_TcpNoDelay(sl_bool flagEnable = sl_true) const noexcept;
 		
 		sl_bool getOption_TcpNoDelay() const noexcept;
+
+		// Linux: TCP_CORK, macOS/iOS/BSD: TCP_NOPUSH. Holds the partial segments until uncorked
+		sl_bool setOption_TcpCork(sl_bool flagEnable = sl_true) const noexcept;
 		
 		sl_bool setOption_IpTTL(sl_uint32 ttl) const noexcept; // max - 255
 		
@@ -348,6 +381,9 @@ namespace slib
 		sl_bool getOption_IncludeIpHeader() const noexcept;
 		
 		sl_bool setOption_bindToDevice(const StringParam& ifname) const noexcept;
+
+		// Linux: lets the kernel coalesce the received datagrams of a flow (UDP GRO). See `SocketMessage::segmentSize`
+		sl_bool setOption_UdpGro(sl_bool flagEnable = sl_true) const noexcept;
 		
 		// multicast
 		// interface address may be null
@@ -0,0 +1,282 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_NETWORK_WEBSOCKET
+#define CHECKHEADER_SLIB_NETWORK_WEBSOCKET
+
+#include "http_io.h"
+#include "socket_address.h"
+
+#include "../core/property.h"
+#include "../core/memory_buffer.h"
+
+/*
+	The WebSocket Protocol (RFC 6455), with the permessage-deflate extension (RFC 7692)
+
+		https://tools.ietf.org/html/rfc6455
+		https://tools.ietf.org/html/rfc7692
+
+	Both endpoints compress each message independently (no context takeover),
+	so a frame sent by a server can be built once and shared by any number of connections.
+*/
+
+namespace slib
+{
+
+	class WebSocket;
+	class MemoryPool;
+
+	enum class WebSocketOpcode
+	{
+		Continuation = 0,
+		Text = 1,
+		Binary = 2,
+		Close = 8,
+		Ping = 9,
+		Pong = 10
+	};
+
+	// Status codes of the close frames
+	enum class WebSocketCloseCode
+	{
+		Normal = 1000,
+		GoingAway = 1001,
+		ProtocolError = 1002,
+		UnsupportedData = 1003,
+		NoStatus = 1005, // Not sent. Reported when the close frame has no status code
+		Abnormal = 1006, // Not sent. Reported when the connection is lost without a close frame
+		InvalidData = 1007,
+		PolicyViolation = 1008,
+		MessageTooBig = 1009,
+		MandatoryExtension = 1010,
+		InternalError = 1011
+	};
+
+	class SLIB_EXPORT WebSocketMessage
+	{
+	public:
+		WebSocketOpcode opcode; // Text or Binary
+		Memory data;
+
+	public:
+		WebSocketMessage();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(WebSocketMessage)
+
+	public:
+		sl_bool isText() const;
+
+		String getText() const;
+
+	};
+
+	class SLIB_EXPORT WebSocketParam
+	{
+	public:
+		sl_uint32 maxMessageSize; // default: 16MB. Larger messages close the connection with `MessageTooBig`
+		sl_uint32 maxSendQueueSize; // default: 4MB. `send` fails while the unsent bytes exceed this size. `onDrain` is called when the queue falls to the half
+
+		sl_bool flagCompress; // permessage-deflate, default: true
+		sl_uint32 compressionLevel; // 0-9, default: 6
+		sl_uint32 compressionThreshold; // Smaller messages are sent without compression. default: 128
+
+		Function<void(WebSocket*, WebSocketMessage&)> onMessage;
+		Function<void(WebSocket*)> onDrain;
+		Function<void(WebSocket*, sl_uint16 code, const String& reason)> onClose;
+
+	public:
+		WebSocketParam();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(WebSocketParam)
+
+	};
+
+	class SLIB_EXPORT WebSocketClientParam : public WebSocketParam
+	{
+	public:
+		String url; // ws://host[:port]/path[?query]
+		Ref<AsyncStream> stream; // optional. Connected stream (for example, TLS) used instead of a new TCP connection. Required by wss://
+		String protocol; // Sec-WebSocket-Protocol
+		Ref<AsyncIoLoop> ioLoop;
+		sl_uint32 connectTimeout; // milliseconds, default: 0 (no timeout)
+
+		Function<void(WebSocket*, sl_bool flagError)> onConnect;
+
+	public:
+		WebSocketClientParam();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(WebSocketClientParam)
+
+	};
+
+	class SLIB_EXPORT WebSocket : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		WebSocket();
+
+		~WebSocket();
+
+	public:
+		// Connects and sends the opening handshake. `onConnect` is called with the result
+		static Ref<WebSocket> connect(const WebSocketClientParam& param);
+
+		// Starts the protocol on a stream which completed the opening handshake. `dataReceived`: bytes received after the handshake
+		static Ref<WebSocket> create(const Ref<AsyncStream>& stream, const WebSocketParam& param, sl_bool flagClient, sl_bool flagCompress, const Memory& dataReceived = sl_null);
+
+	public:
+		// Sends the close frame and closes the stream when the peer answers. `onClose` is called once
+		void close(sl_uint16 code, const StringParam& reason = sl_null);
+
+		void close();
+
+		sl_bool isOpened();
+
+		sl_bool isClient();
+
+		sl_bool isCompressing();
+
+		Ref<AsyncStream> getIO();
+
+		sl_bool send(WebSocketOpcode opcode, const void* data, sl_size size);
+
+		sl_bool sendText(const StringParam& text);
+
+		sl_bool sendBinary(const void* data, sl_size size);
+
+		sl_bool sendBinary(const MemoryView& data);
+
+		sl_bool ping(const void* data = sl_null, sl_size size = 0);
+
+		// Bytes written to the stream and not yet completed
+		sl_size getSendQueueSize();
+
+		sl_bool isSendQueueFull();
+
+	public:
+		SLIB_PROPERTY(SocketAddress, LocalAddress)
+		SLIB_PROPERTY(SocketAddress, RemoteAddress)
+		SLIB_PROPERTY(AtomicRef<Referable>, UserObject)
+
+	public:
+		// Sends the message to the sockets. The frame is built (and compressed) once and its memory is shared by the server sockets.
+		// Returns the number of the sockets which queued the message. The sockets with a full send queue are skipped.
+		static sl_size broadcast(const Ref<WebSocket>* sockets, sl_size count, WebSocketOpcode opcode, const void* data, sl_size size);
+
+		static sl_size broadcast(const List< Ref<WebSocket> >& sockets, WebSocketOpcode opcode, const void* data, sl_size size);
+
+		// Sec-WebSocket-Accept for the Sec-WebSocket-Key
+		static String getAcceptKey(const StringParam& key);
+
+		// XORs `data` with the 4-byte `mask`, starting at `offset` of the payload
+		static void mask(void* data, sl_size size, const sl_uint8* mask, sl_uint64 offset = 0);
+
+	protected:
+		void _init(const WebSocketParam& param, sl_bool flagClient);
+
+		void _start(const Memory& dataReceived);
+
+		void _read();
+
+		sl_bool _processFrames(sl_uint8* data, sl_size size);
+
+		sl_bool _beginFrame();
+
+		sl_bool _endFrame();
+
+		sl_bool _processHandshake(sl_uint8* data, sl_size size);
+
+		Memory _buildFrame(WebSocketOpcode opcode, const void* data, sl_size size);
+
+		sl_bool _isCompressingMessage(WebSocketOpcode opcode, sl_size size);
+
+		sl_bool _sendFrame(const Memory& frame, sl_bool flagControl);
+
+		sl_bool _sendClose(sl_uint16 code, const StringView& reason, sl_bool flagCloseStream);
+
+		void _fail(WebSocketCloseCode code);
+
+		void _closeStream();
+
+		void _onConnect(AsyncTcpSocket* socket, sl_bool flagError);
+
+		void onReadStream(AsyncStreamResult& result);
+
+		void onWriteStream(AsyncStreamResult& result);
+
+		void onWriteClose(AsyncStreamResult& result);
+
+	protected:
+		Ref<AsyncStream> m_io;
+		WebSocketParam m_param;
+		sl_bool m_flagClient;
+		sl_bool m_flagCompress;
+		sl_bool m_flagPeerResetsContext;
+
+		sl_bool m_flagOpened;
+		sl_bool m_flagClosed;
+		sl_bool m_flagCloseSent;
+		sl_bool m_flagCloseReceived;
+		sl_bool m_flagCloseStreamAfterWrite;
+		sl_uint16 m_codeClose;
+		String m_reasonClose;
+
+		// Reading
+		Memory m_bufRead;
+		Ref<MemoryPool> m_poolRead;
+		Function<void(AsyncStreamResult&)> m_callbackRead;
+		sl_uint8 m_header[14];
+		sl_uint32 m_sizeHeader;
+		sl_uint32 m_sizeHeaderRequired;
+		sl_bool m_flagPayload;
+		sl_uint64 m_sizePayload;
+		sl_uint64 m_offsetPayload;
+		sl_uint8 m_maskPayload[4];
+		sl_uint8 m_bufControl[125];
+		MemoryBuffer m_bufMessage;
+		sl_bool m_flagMessage;
+		sl_bool m_flagMessageCompressed;
+		WebSocketOpcode m_opcodeMessage;
+		ZlibRawDecompressor m_decompressor;
+
+		// Writing
+		Function<void(AsyncStreamResult&)> m_callbackWrite;
+		Function<void(AsyncStreamResult&)> m_callbackWriteClose;
+		sl_size m_sizeSendQueue;
+		sl_bool m_flagSendQueueFull;
+		sl_uint64 m_seedMask;
+
+		// Opening handshake of the client
+		Function<void(WebSocket*, sl_bool flagError)> m_onConnect;
+		Memory m_requestHandshake;
+		String m_acceptHandshake;
+		sl_bool m_flagOfferCompress;
+		HttpHeaderReader m_readerHandshake;
+
+		friend class HttpServerContext;
+
+	};
+
+}
+
+#endif
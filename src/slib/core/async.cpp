@@ -28,12 +28,18 @@
 #include "slib/core/async_file_stream.h"
 #include "slib/core/async_copy.h"
 #include "slib/core/async_output.h"
+#include "slib/core/async_uring.h"
 
 #include "slib/core/thread.h"
+#include "slib/core/memory_view.h"
+#include "slib/core/memory_pool.h"
 #include "slib/core/dispatch_loop.h"
 #include "slib/core/handle_ptr.h"
 #include "slib/core/safe_static.h"
 
+#define ASYNC_OUTPUT_MAX_VECTOR 64
+#define ASYNC_STREAM_REQUEST_CACHE_SIZE 256
+
 namespace slib
 {
 
@@ -42,6 +48,34 @@ namespace slib
 		namespace async
 		{
 
+			// Free list of the requests released on the current thread. Most requests are created and released on the thread of their loop
+			class StreamRequestCache
+			{
+			public:
+				void* stock = sl_null;
+				sl_uint32 stockCount = 0;
+				sl_uint64 allocationCount = 0;
+				sl_uint64 reuseCount = 0;
+				sl_bool flagFreed = sl_false;
+
+			public:
+				~StreamRequestCache()
+				{
+					flagFreed = sl_true;
+					void* block = stock;
+					stock = sl_null;
+					stockCount = 0;
+					while (block) {
+						void* next = *((void**)block);
+						Base::freeMemory(block);
+						block = next;
+					}
+				}
+
+			};
+
+			static SLIB_THREAD StreamRequestCache g_cacheStreamRequest;
+
 			static Ref<AsyncIoLoop> CreateDefaultAsyncIoLoop(sl_bool flagRelease = sl_false)
 			{
 				if (flagRelease) {
@@ -76,6 +110,7 @@ namespace slib
 		m_flagInit = sl_false;
 		m_flagRunning = sl_false;
 		m_handle = sl_null;
+		m_backend = AsyncIoBackend::Default;
 	}
 
 	AsyncIoLoop::~AsyncIoLoop()
@@ -95,12 +130,36 @@ namespace slib
 
 	Ref<AsyncIoLoop> AsyncIoLoop::create(sl_bool flagAutoStart)
 	{
-		void* handle = _native_createHandle();
+		return create(AsyncIoBackend::Default, flagAutoStart);
+	}
+
+	Ref<AsyncIoLoop> AsyncIoLoop::create(AsyncIoBackend backend, sl_bool flagAutoStart)
+	{
+		void* handle = sl_null;
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		if (backend == AsyncIoBackend::Uring) {
+			handle = _uring_createHandle();
+		}
+#endif
+		if (handle) {
+			backend = AsyncIoBackend::Uring;
+		} else {
+			backend = AsyncIoBackend::Default;
+			handle = _native_createHandle();
+		}
 		if (handle) {
 			Ref<AsyncIoLoop> ret = new AsyncIoLoop;
 			if (ret.isNotNull()) {
 				ret->m_handle = handle;
-				ret->m_thread = Thread::create(SLIB_FUNCTION_MEMBER(ret.get(), _native_runLoop));
+				ret->m_backend = backend;
+#if defined(SLIB_PLATFORM_IS_LINUX)
+				if (backend == AsyncIoBackend::Uring) {
+					ret->m_thread = Thread::create(SLIB_FUNCTION_MEMBER(ret.get(), _uring_runLoop));
+				} else
+#endif
+				{
+					ret->m_thread = Thread::create(SLIB_FUNCTION_MEMBER(ret.get(), _native_runLoop));
+				}
 				if (ret->m_thread.isNotNull()) {
 					ret->m_flagInit = sl_true;
 					if (flagAutoStart) {
@@ -108,7 +167,14 @@ namespace slib
 					}
 					return ret;
 				}
+				ret->m_handle = sl_null;
+			}
+#if defined(SLIB_PLATFORM_IS_LINUX)
+			if (backend == AsyncIoBackend::Uring) {
+				_uring_closeHandle(handle);
+				return sl_null;
 			}
+#endif
 			_native_closeHandle(handle);
 		}
 		return sl_null;
@@ -125,12 +191,26 @@ namespace slib
 		if (m_flagRunning) {
 			m_flagRunning = sl_false;
 			m_thread->finish();
-			_native_wake();
+#if defined(SLIB_PLATFORM_IS_LINUX)
+			if (m_backend == AsyncIoBackend::Uring) {
+				_uring_wake();
+			} else
+#endif
+			{
+				_native_wake();
+			}
 			lock.unlock();
 			m_thread->finishAndWait();
 		}
 		
-		_native_closeHandle(m_handle);
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		if (m_backend == AsyncIoBackend::Uring) {
+			_uring_closeHandle(m_handle);
+		} else
+#endif
+		{
+			_native_closeHandle(m_handle);
+		}
 		
 		m_queueInstancesOrder.removeAll();
 		m_queueInstancesClosing.removeAll();
@@ -138,6 +218,11 @@ namespace slib
 		
 	}
 
+	AsyncIoBackend AsyncIoLoop::getBackend()
+	{
+		return m_backend;
+	}
+
 	void AsyncIoLoop::start()
 	{
 		ObjectLocker lock(this);
@@ -184,6 +269,12 @@ namespace slib
 		if (!m_flagRunning) {
 			return;
 		}
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		if (m_backend == AsyncIoBackend::Uring) {
+			_uring_wake();
+			return;
+		}
+#endif
 		_native_wake();
 	}
 
@@ -192,6 +283,11 @@ namespace slib
 		if (m_handle) {
 			if (instance && instance->isOpened()) {
 				ObjectLocker lock(this);
+#if defined(SLIB_PLATFORM_IS_LINUX)
+				if (m_backend == AsyncIoBackend::Uring) {
+					return _uring_attachInstance(instance, mode);
+				}
+#endif
 				return _native_attachInstance(instance, mode);
 			}
 		}
@@ -251,7 +347,14 @@ namespace slib
 		Ref<AsyncIoInstance> instance;
 		while (m_queueInstancesClosing.pop(&instance)) {
 			if (instance.isNotNull() && instance->isOpened()) {
-				_native_detachInstance(instance.get());
+#if defined(SLIB_PLATFORM_IS_LINUX)
+				if (m_backend == AsyncIoBackend::Uring) {
+					_uring_detachInstance(instance.get());
+				} else
+#endif
+				{
+					_native_detachInstance(instance.get());
+				}
 				instance->onClose();
 				m_queueInstancesClosed.push(instance);
 			}
@@ -352,6 +455,13 @@ namespace slib
 		onOrder();
 	}
 
+#if defined(SLIB_PLATFORM_IS_LINUX)
+	sl_bool AsyncIoInstance::isUringInstance()
+	{
+		return sl_false;
+	}
+#endif
+
 
 	SLIB_DEFINE_OBJECT(AsyncIoObject, Object)
 
@@ -475,6 +585,46 @@ namespace slib
 		}
 	}
 
+	void* AsyncStreamRequest::operator new(sl_size_t size) noexcept
+	{
+		if (size == sizeof(AsyncStreamRequest)) {
+			priv::async::StreamRequestCache& cache = priv::async::g_cacheStreamRequest;
+			void* block = cache.stock;
+			if (block) {
+				cache.stock = *((void**)block);
+				cache.stockCount--;
+				cache.reuseCount++;
+				return block;
+			}
+			cache.allocationCount++;
+		}
+		return Base::createMemory(size);
+	}
+
+	void AsyncStreamRequest::operator delete(void* ptr, sl_size_t size) noexcept
+	{
+		if (ptr && size == sizeof(AsyncStreamRequest)) {
+			priv::async::StreamRequestCache& cache = priv::async::g_cacheStreamRequest;
+			if (!(cache.flagFreed) && cache.stockCount < ASYNC_STREAM_REQUEST_CACHE_SIZE) {
+				*((void**)ptr) = cache.stock;
+				cache.stock = ptr;
+				cache.stockCount++;
+				return;
+			}
+		}
+		Base::freeMemory(ptr);
+	}
+
+	void AsyncStreamRequest::getPoolStatus(MemoryPoolStatus& status) noexcept
+	{
+		priv::async::StreamRequestCache& cache = priv::async::g_cacheStreamRequest;
+		status.blockSize = sizeof(AsyncStreamRequest);
+		status.inUseCount = 0;
+		status.stockCount = cache.stockCount;
+		status.allocationCount = cache.allocationCount;
+		status.reuseCount = cache.reuseCount;
+	}
+
 
 	SLIB_DEFINE_OBJECT(AsyncStreamInstance, AsyncIoInstance)
 
@@ -630,6 +780,38 @@ namespace slib
 		return write(mem.getData(), mem.getSize(), callback, mem.ref.get());
 	}
 
+	sl_bool AsyncStream::waitRead(const Function<void(AsyncStreamResult&)>& callback, Referable* userObject)
+	{
+		// Completes at once on the streams which can't wait without reading
+		Ref<AsyncStreamRequest> req = new AsyncStreamRequest(sl_true, sl_null, 0, userObject, callback);
+		if (req.isNull()) {
+			return sl_false;
+		}
+		Ref<AsyncStream> thiz = this;
+		return addTask([thiz, req]() {
+			req->runCallback(thiz.get(), 0, AsyncStreamResultCode::Success);
+		});
+	}
+
+	sl_bool AsyncStream::writeVector(const MemoryView* buffers, sl_size count, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject)
+	{
+		while (count && !(buffers[count - 1].size)) {
+			count--;
+		}
+		if (!count) {
+			return sl_false;
+		}
+		Function<void(AsyncStreamResult&)> noCallback;
+		for (sl_size i = 0; i < count; i++) {
+			if (buffers[i].size) {
+				if (!(write(buffers[i].data, buffers[i].size, i + 1 == count ? callback : noCallback, userObject))) {
+					return sl_false;
+				}
+			}
+		}
+		return sl_true;
+	}
+
 	sl_bool AsyncStream::isSeekable()
 	{
 		Ref<AsyncStreamInstance> instance = Ref<AsyncStreamInstance>::from(getIoInstance());
@@ -730,6 +912,51 @@ namespace slib
 		return sl_false;
 	}
 
+	sl_bool AsyncStreamBase::waitRead(const Function<void(AsyncStreamResult&)>& callback, Referable* userObject)
+	{
+		Ref<AsyncStreamRequest> req = new AsyncStreamRequest(sl_true, sl_null, 0, userObject, callback);
+		if (req.isNotNull()) {
+			return requestIo(req);
+		}
+		return sl_false;
+	}
+
+	sl_bool AsyncStreamBase::writeVector(const MemoryView* buffers, sl_size count, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject)
+	{
+		while (count && !(buffers[count - 1].size)) {
+			count--;
+		}
+		if (!count) {
+			return sl_false;
+		}
+		Ref<AsyncIoLoop> loop = getIoLoop();
+		if (loop.isNull()) {
+			return sl_false;
+		}
+		Ref<AsyncStreamInstance> instance = getIoInstance();
+		if (instance.isNull()) {
+			return sl_false;
+		}
+		// Queues all the buffers before ordering, so that the instance can submit them together
+		sl_bool flagAdded = sl_false;
+		sl_bool flagSuccess = sl_true;
+		Function<void(AsyncStreamResult&)> noCallback;
+		for (sl_size i = 0; i < count; i++) {
+			if (buffers[i].size) {
+				Ref<AsyncStreamRequest> req = AsyncStreamRequest::createWrite(buffers[i].data, buffers[i].size, userObject, i + 1 == count ? callback : noCallback);
+				if (req.isNull() || !(instance->addRequest(req))) {
+					flagSuccess = sl_false;
+					break;
+				}
+				flagAdded = sl_true;
+			}
+		}
+		if (flagAdded) {
+			loop->requestOrder(instance.get());
+		}
+		return flagSuccess;
+	}
+
 	sl_bool AsyncStreamBase::addTask(const Function<void()>& callback)
 	{
 		Ref<AsyncIoLoop> loop = getIoLoop();
@@ -1009,6 +1236,16 @@ namespace slib
 		}
 		return sl_null;
 #else
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		if (AsyncUring::isEnabled(ioLoop.get())) {
+			AsyncFileStreamParam param;
+			if (param.openFile(path, mode)) {
+				param.ioLoop = ioLoop;
+				return AsyncFileStream::create(param);
+			}
+			return sl_null;
+		}
+#endif
 		return open(path, mode, dispatcher);
 #endif
 	}
@@ -1568,6 +1805,21 @@ namespace slib
 		return m_lengthOutput;
 	}
 
+	sl_bool AsyncOutputBuffer::popOutput(Ref<AsyncOutputBufferElement>& element)
+	{
+		ObjectLocker lock(this);
+		if (m_queueOutput.pop_NoLock(&element)) {
+			sl_uint64 size = element->getHeader().getSize() + element->getBodySize();
+			if (size < m_lengthOutput) {
+				m_lengthOutput -= size;
+			} else {
+				m_lengthOutput = 0;
+			}
+			return sl_true;
+		}
+		return sl_false;
+	}
+
 
 	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(AsyncOutputParam)
 	
@@ -1613,17 +1865,12 @@ namespace slib
 		if (param.stream.isNull()) {
 			return sl_null;
 		}
-		Memory buffer = Memory::create(param.bufferSize);
-		if (buffer.isNull()) {
-			return sl_null;
-		}
 		Ref<AsyncOutput> ret = new AsyncOutput;
 		if (ret.isNotNull()) {
 			ret->m_streamOutput = param.stream;
 			ret->m_bufferSize = param.bufferSize;
 			ret->m_bufferCount = param.bufferCount;
 			ret->m_onEnd = param.onEnd;
-			ret->m_bufWrite = buffer;
 			return ret;
 		}
 		return sl_null;
@@ -1670,15 +1917,49 @@ namespace slib
 				return;
 			}
 		}
-		MemoryQueue& header = m_elementWriting->getHeader();
-		if (header.getSize() > 0) {
-			sl_size size = header.pop(m_bufWrite.getData(), m_bufWrite.getSize());
-			if (size > 0) {
+		if (m_elementWriting->getHeader().getSize() > 0) {
+			// Submits the queued pieces as they are, so that the stream can send them by one vectored write
+			MemoryView views[ASYNC_OUTPUT_MAX_VECTOR];
+			List<MemoryData> pieces;
+			sl_size n = 0;
+			while (n < ASYNC_OUTPUT_MAX_VECTOR) {
+				MemoryQueue& header = m_elementWriting->getHeader();
+				if (header.getSize() > 0) {
+					MemoryData data;
+					if (!(header.pop(data))) {
+						_onError();
+						return;
+					}
+					if (!(data.size)) {
+						continue;
+					}
+					views[n] = data;
+					if (!(pieces.add_NoLock(Move(data)))) {
+						_onError();
+						return;
+					}
+					n++;
+				} else {
+					// Joins the header of the next element (such as the response header and its content), which would be delayed by Nagle's algorithm when written separately
+					if (!(m_elementWriting->isEmptyBody())) {
+						break;
+					}
+					Ref<AsyncOutputBufferElement> next;
+					if (!(m_queueOutput.pop(&next))) {
+						break;
+					}
+					m_elementWriting = Move(next);
+				}
+			}
+			if (n) {
 				m_flagWriting = sl_true;
-				if (!(m_streamOutput->write(m_bufWrite.getData(), size, SLIB_FUNCTION_WEAKREF(this, onWriteStream), m_bufWrite.ref.get()))) {
+				if (!(m_streamOutput->writeVector(views, n, SLIB_FUNCTION_WEAKREF(this, onWriteStream), pieces.ref.get()))) {
 					m_flagWriting = sl_false;
 					_onError();
 				}
+			} else {
+				// Only empty pieces were queued, so continues with the body or the next element
+				_write(flagCompleted);
 			}
 		} else {
 			sl_uint64 sizeBody = m_elementWriting->getBodySize();
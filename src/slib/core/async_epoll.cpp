@@ -118,6 +118,7 @@ namespace slib
 						desc.flagIn = sl_false;
 						desc.flagOut = sl_false;
 						desc.flagError = sl_false;
+						desc.flagCompletion = sl_false;
 						int re = ev.events;
 						if (re & (EPOLLIN | EPOLLPRI)) {
 							desc.flagIn = sl_true;
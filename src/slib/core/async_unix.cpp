@@ -25,6 +25,7 @@
 #if defined(SLIB_PLATFORM_IS_UNIX)
 
 #include "slib/core/async_file_stream.h"
+#include "slib/core/async_uring.h"
 
 #include "slib/core/thread.h"
 #include "slib/core/handle_ptr.h"
@@ -196,6 +197,15 @@ namespace slib
 	
 	Ref<AsyncFileStream> AsyncFileStream::create(const AsyncFileStreamParam& param)
 	{
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		if (AsyncUring::isEnabled(param.ioLoop.get())) {
+			Ref<AsyncFileStreamInstance> instance = AsyncUring::createFileInstance(param);
+			if (instance.isNotNull()) {
+				return AsyncFileStream::create(instance.get(), param.mode, param.ioLoop);
+			}
+			return sl_null;
+		}
+#endif
 		Ref<priv::async::FileInstance> ret = priv::async::FileInstance::create(param);
 		if (ret.isNotNull()) {
 			return AsyncFileStream::create(ret.get(), param.mode, param.ioLoop);
@@ -203,6 +213,36 @@ namespace slib
 		return sl_null;
 	}
 
+#if defined(SLIB_PLATFORM_IS_LINUX)
+	sl_bool AsyncFileStreamParam::openFile(const StringParam& filePath, FileMode fileMode)
+	{
+		File file = File::open(filePath, fileMode);
+		if (file.isNone()) {
+			return sl_false;
+		}
+		if (!(file.getPosition(initialPosition))) {
+			initialPosition = 0;
+		}
+		handle = file.release();
+		flagCloseOnRelease = sl_true;
+		flagSupportSeeking = sl_true;
+		if (fileMode & FileMode::Read) {
+			if (fileMode & FileMode::Write) {
+				mode = AsyncIoMode::InOut;
+			} else {
+				mode = AsyncIoMode::In;
+			}
+		} else {
+			if (fileMode & FileMode::Write) {
+				mode = AsyncIoMode::Out;
+			} else {
+				mode = AsyncIoMode::None;
+			}
+		}
+		return sl_true;
+	}
+#endif
+
 }
 
 #endif
@@ -0,0 +1,1221 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "async_config.h"
+
+#if defined(SLIB_PLATFORM_IS_LINUX)
+
+#include "slib/core/async_uring.h"
+#include "slib/core/async_file_stream.h"
+
+#include "slib/core/memory_view.h"
+#include "slib/core/handle_ptr.h"
+#include "slib/core/thread.h"
+
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP) && defined(__has_include)
+#	if __has_include(<linux/io_uring.h>)
+#		include <linux/io_uring.h>
+#		include <sys/syscall.h>
+#		if defined(IORING_SETUP_DEFER_TASKRUN) && defined(IORING_RECV_MULTISHOT) && defined(__NR_io_uring_setup)
+#			define ASYNC_URING_SUPPORTED
+#		endif
+#	endif
+#endif
+
+#if defined(ASYNC_URING_SUPPORTED)
+
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <signal.h>
+#include <poll.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/eventfd.h>
+
+#define URING_SQ_ENTRIES 512
+#define URING_CQ_ENTRIES 4096
+#define URING_MAX_BUFFER_GROUPS 64
+#define URING_MAX_VECTOR 1024
+
+#define URING_USER_DATA_WAKE 1
+#define URING_USER_DATA_IGNORE 2
+
+#define OPERATION_FILE_READ 1
+#define OPERATION_FILE_WRITE 2
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace async_uring
+		{
+
+			enum class OperationType
+			{
+				Poll = 0,
+				Completion = 1
+			};
+
+			struct Operation
+			{
+				Operation* prev;
+				Operation* next;
+
+				Ref<AsyncIoInstance> instance;
+				OperationType type;
+				sl_uint32 tag;
+				sl_uint32 pollMask;
+
+				iovec* iov;
+				sl_uint32 nIovCapacity;
+				msghdr msg;
+				sockaddr_storage address;
+				__kernel_timespec timeout;
+			};
+
+			struct BufferGroup
+			{
+				io_uring_buf_ring* ring;
+				sl_size sizeRing;
+				sl_uint8* buffers;
+				sl_size sizeBuffers;
+				sl_uint32 count;
+				sl_uint32 size;
+
+				// `io_uring_buf_ring::bufs` is declared by an empty struct in C++, which shifts it by one byte
+				io_uring_buf* getEntry(sl_uint32 index)
+				{
+					return (io_uring_buf*)((void*)ring) + (index & (count - 1));
+				}
+			};
+
+			struct AttachRequest
+			{
+				Ref<AsyncIoInstance> instance;
+				AsyncIoMode mode;
+			};
+
+			static int Setup(unsigned entries, io_uring_params* params)
+			{
+				return (int)(syscall(__NR_io_uring_setup, entries, params));
+			}
+
+			static int Enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, const void* arg, sl_size sizeArg)
+			{
+				return (int)(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, sizeArg));
+			}
+
+			static int Register(int fd, unsigned opcode, const void* arg, unsigned nArgs)
+			{
+				return (int)(syscall(__NR_io_uring_register, fd, opcode, arg, nArgs));
+			}
+
+			class Ring
+			{
+			public:
+				int fd;
+				int fdWake;
+				sl_bool flagDisabled;
+
+				void* memSq;
+				sl_size sizeSq;
+				void* memCq;
+				sl_size sizeCq;
+				io_uring_sqe* sqes;
+				sl_size sizeSqes;
+
+				unsigned* sqHead;
+				unsigned* sqTail;
+				unsigned sqMask;
+				unsigned sqEntries;
+				unsigned sqTailLocal;
+
+				unsigned* cqHead;
+				unsigned* cqTail;
+				unsigned cqMask;
+				io_uring_cqe* cqes;
+
+				Operation listActive;
+				Operation* listFree;
+				BufferGroup* groups[URING_MAX_BUFFER_GROUPS];
+
+				LinkedQueue<AttachRequest> queueAttach;
+
+			public:
+				Ring()
+				{
+					fd = -1;
+					fdWake = -1;
+					flagDisabled = sl_false;
+					memSq = MAP_FAILED;
+					memCq = MAP_FAILED;
+					sqes = (io_uring_sqe*)MAP_FAILED;
+					listActive.prev = &listActive;
+					listActive.next = &listActive;
+					listFree = sl_null;
+					Base::zeroMemory(groups, sizeof(groups));
+				}
+
+				~Ring()
+				{
+					if (fd >= 0) {
+						::close(fd);
+					}
+					if (fdWake >= 0) {
+						::close(fdWake);
+					}
+					if (sqes != MAP_FAILED) {
+						munmap(sqes, sizeSqes);
+					}
+					if (memCq != MAP_FAILED && memCq != memSq) {
+						munmap(memCq, sizeCq);
+					}
+					if (memSq != MAP_FAILED) {
+						munmap(memSq, sizeSq);
+					}
+					for (sl_uint32 i = 0; i < URING_MAX_BUFFER_GROUPS; i++) {
+						BufferGroup* group = groups[i];
+						if (group) {
+							munmap(group->ring, group->sizeRing);
+							munmap(group->buffers, group->sizeBuffers);
+							delete group;
+						}
+					}
+					while (listActive.next != &listActive) {
+						freeOperation(listActive.next);
+					}
+					while (listFree) {
+						Operation* op = listFree;
+						listFree = op->next;
+						if (op->iov) {
+							delete[] op->iov;
+						}
+						delete op;
+					}
+				}
+
+			public:
+				sl_bool initialize()
+				{
+					io_uring_params params;
+					Base::zeroMemory(&params, sizeof(params));
+					params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_CLAMP | IORING_SETUP_SUBMIT_ALL | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_R_DISABLED;
+					params.cq_entries = URING_CQ_ENTRIES;
+					// Linux 6.1 or later: `DEFER_TASKRUN` implies the multishot receive, the provided buffer ring and the cancellation by descriptor
+					fd = Setup(URING_SQ_ENTRIES, &params);
+					if (fd < 0) {
+						return sl_false;
+					}
+					flagDisabled = sl_true;
+					unsigned featuresRequired = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_SUBMIT_STABLE | IORING_FEAT_EXT_ARG;
+					if ((params.features & featuresRequired) != featuresRequired) {
+						return sl_false;
+					}
+					sizeSq = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+					sizeCq = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+					if (sizeCq > sizeSq) {
+						sizeSq = sizeCq;
+					}
+					memSq = mmap(sl_null, sizeSq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+					if (memSq == MAP_FAILED) {
+						return sl_false;
+					}
+					memCq = memSq;
+					sizeSqes = params.sq_entries * sizeof(io_uring_sqe);
+					sqes = (io_uring_sqe*)(mmap(sl_null, sizeSqes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+					if (sqes == MAP_FAILED) {
+						return sl_false;
+					}
+					sl_uint8* sq = (sl_uint8*)memSq;
+					sqHead = (unsigned*)(sq + params.sq_off.head);
+					sqTail = (unsigned*)(sq + params.sq_off.tail);
+					sqMask = *((unsigned*)(sq + params.sq_off.ring_mask));
+					sqEntries = *((unsigned*)(sq + params.sq_off.ring_entries));
+					sqTailLocal = *sqTail;
+					unsigned* sqArray = (unsigned*)(sq + params.sq_off.array);
+					for (unsigned i = 0; i < sqEntries; i++) {
+						sqArray[i] = i;
+					}
+					sl_uint8* cq = (sl_uint8*)memCq;
+					cqHead = (unsigned*)(cq + params.cq_off.head);
+					cqTail = (unsigned*)(cq + params.cq_off.tail);
+					cqMask = *((unsigned*)(cq + params.cq_off.ring_mask));
+					cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+					fdWake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+					if (fdWake < 0) {
+						return sl_false;
+					}
+					return sl_true;
+				}
+
+				// Called on the loop thread: the submitter of the single issuer ring
+				sl_bool start()
+				{
+					if (flagDisabled) {
+						if (Register(fd, IORING_REGISTER_ENABLE_RINGS, sl_null, 0) < 0) {
+							return sl_false;
+						}
+						flagDisabled = sl_false;
+					}
+					armWake();
+					submit();
+					return sl_true;
+				}
+
+				io_uring_sqe* getSqe()
+				{
+					if (sqTailLocal - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries) {
+						submit();
+						if (sqTailLocal - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries) {
+							return sl_null;
+						}
+					}
+					io_uring_sqe* sqe = sqes + (sqTailLocal & sqMask);
+					sqTailLocal++;
+					Base::zeroMemory(sqe, sizeof(io_uring_sqe));
+					return sqe;
+				}
+
+				sl_bool reserve(unsigned n)
+				{
+					if (sqTailLocal - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) + n > sqEntries) {
+						submit();
+						if (sqTailLocal - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) + n > sqEntries) {
+							return sl_false;
+						}
+					}
+					return sl_true;
+				}
+
+				unsigned getPendingCount()
+				{
+					__atomic_store_n(sqTail, sqTailLocal, __ATOMIC_RELEASE);
+					return sqTailLocal - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+				}
+
+				void submit()
+				{
+					unsigned n = getPendingCount();
+					if (n) {
+						Enter(fd, n, 0, 0, sl_null, 0);
+					}
+				}
+
+				void wait(sl_uint32 timeout)
+				{
+					unsigned n = getPendingCount();
+					if (__atomic_load_n(cqTail, __ATOMIC_ACQUIRE) != *cqHead) {
+						if (n) {
+							Enter(fd, n, 0, 0, sl_null, 0);
+						}
+						return;
+					}
+					if (!timeout) {
+						// Runs the deferred task work without blocking
+						Enter(fd, n, 0, IORING_ENTER_GETEVENTS, sl_null, 0);
+						return;
+					}
+					__kernel_timespec ts;
+					ts.tv_sec = timeout / 1000;
+					ts.tv_nsec = (timeout % 1000) * 1000000;
+					io_uring_getevents_arg arg;
+					Base::zeroMemory(&arg, sizeof(arg));
+					arg.ts = (sl_uint64)(&ts);
+					Enter(fd, n, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+				}
+
+				void armWake()
+				{
+					io_uring_sqe* sqe = getSqe();
+					if (sqe) {
+						sqe->opcode = IORING_OP_POLL_ADD;
+						sqe->fd = fdWake;
+						sqe->len = IORING_POLL_ADD_MULTI;
+						sqe->poll32_events = POLLIN;
+						sqe->user_data = URING_USER_DATA_WAKE;
+					}
+				}
+
+				void wake()
+				{
+					sl_uint64 n = 1;
+					ssize_t ret = ::write(fdWake, &n, sizeof(n));
+					SLIB_UNUSED(ret)
+				}
+
+				Operation* createOperation(AsyncIoInstance* instance, OperationType type, sl_uint32 tag)
+				{
+					Operation* op = listFree;
+					if (op) {
+						listFree = op->next;
+					} else {
+						op = new Operation;
+						if (!op) {
+							return sl_null;
+						}
+						op->iov = sl_null;
+						op->nIovCapacity = 0;
+					}
+					op->instance = instance;
+					op->type = type;
+					op->tag = tag;
+					op->pollMask = 0;
+					op->prev = &listActive;
+					op->next = listActive.next;
+					listActive.next->prev = op;
+					listActive.next = op;
+					return op;
+				}
+
+				void freeOperation(Operation* op)
+				{
+					Ref<AsyncIoInstance> instance = Move(op->instance);
+					op->prev->next = op->next;
+					op->next->prev = op->prev;
+					op->prev = sl_null;
+					op->next = listFree;
+					listFree = op;
+				}
+
+				io_uring_sqe* prepare(AsyncIoInstance* instance, OperationType type, sl_uint32 tag, sl_uint8 opcode, Operation*& op)
+				{
+					io_uring_sqe* sqe = getSqe();
+					if (!sqe) {
+						return sl_null;
+					}
+					op = createOperation(instance, type, tag);
+					if (!op) {
+						sqe->opcode = IORING_OP_NOP;
+						sqe->user_data = URING_USER_DATA_IGNORE;
+						return sl_null;
+					}
+					sqe->opcode = opcode;
+					sqe->fd = (int)(instance->getHandle());
+					sqe->user_data = (sl_uint64)op;
+					return sqe;
+				}
+
+				void armPoll(Operation* op)
+				{
+					io_uring_sqe* sqe = getSqe();
+					if (sqe) {
+						sqe->opcode = IORING_OP_POLL_ADD;
+						sqe->fd = (int)(op->instance->getHandle());
+						sqe->len = IORING_POLL_ADD_MULTI;
+						sqe->poll32_events = op->pollMask;
+						sqe->user_data = (sl_uint64)op;
+					} else {
+						freeOperation(op);
+					}
+				}
+
+				void processAttach()
+				{
+					AttachRequest request;
+					while (queueAttach.pop(&request)) {
+						AsyncIoInstance* instance = request.instance.get();
+						if (instance->isOpened() && !(instance->isClosing())) {
+							sl_uint32 mask = POLLERR | POLLHUP;
+							if (request.mode == AsyncIoMode::In || request.mode == AsyncIoMode::InOut) {
+								mask |= POLLIN | POLLPRI | POLLRDHUP;
+							}
+							if (request.mode == AsyncIoMode::Out || request.mode == AsyncIoMode::InOut) {
+								mask |= POLLOUT;
+							}
+							Operation* op = createOperation(instance, OperationType::Poll, 0);
+							if (op) {
+								op->pollMask = mask;
+								armPoll(op);
+							}
+						}
+					}
+				}
+
+				void cancel(AsyncIoInstance* instance)
+				{
+					io_uring_sqe* sqe = getSqe();
+					if (sqe) {
+						sqe->opcode = IORING_OP_ASYNC_CANCEL;
+						sqe->fd = (int)(instance->getHandle());
+						sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+						sqe->user_data = URING_USER_DATA_IGNORE;
+					}
+					// The cancellation should be issued before the handle is closed
+					submit();
+				}
+
+			};
+
+			class FileInstance : public AsyncFileStreamInstance
+			{
+			public:
+				sl_uint64 m_offset;
+				sl_bool m_flagSupportSeeking;
+
+				Ref<AsyncStreamRequest> m_requestReadingUring;
+				Ref<AsyncStreamRequest> m_requestWritingUring;
+
+			public:
+				FileInstance()
+				{
+					m_offset = 0;
+					m_flagSupportSeeking = sl_false;
+				}
+
+				~FileInstance()
+				{
+					if (m_requestReadingUring.isNotNull()) {
+						processStreamResult(m_requestReadingUring.get(), 0, AsyncStreamResultCode::Closed);
+					}
+					if (m_requestWritingUring.isNotNull()) {
+						processStreamResult(m_requestWritingUring.get(), 0, AsyncStreamResultCode::Closed);
+					}
+				}
+
+			public:
+				static Ref<FileInstance> create(const AsyncFileStreamParam& param)
+				{
+					if (param.handle != SLIB_FILE_INVALID_HANDLE) {
+						Ref<FileInstance> ret = new FileInstance();
+						if (ret.isNotNull()) {
+							ret->setHandle(param.handle);
+							ret->m_flagCloseOnRelease = param.flagCloseOnRelease;
+							if (param.flagSupportSeeking) {
+								ret->m_flagSupportSeeking = sl_true;
+								ret->m_offset = param.initialPosition;
+							}
+							return ret;
+						} else {
+							if (param.flagCloseOnRelease) {
+								File::close(param.handle);
+							}
+						}
+					}
+					return sl_null;
+				}
+
+				sl_bool isUringInstance() override
+				{
+					return sl_true;
+				}
+
+				void onOrder() override
+				{
+					if (isClosing()) {
+						return;
+					}
+					Ref<AsyncIoLoop> loop = getLoop();
+					if (loop.isNull()) {
+						return;
+					}
+					sl_uint64 offset = m_flagSupportSeeking ? m_offset : (sl_uint64)-1;
+					if (m_requestReadingUring.isNull()) {
+						Ref<AsyncStreamRequest> req;
+						if (popReadRequest(req)) {
+							if (req.isNotNull()) {
+								if (req->data && req->size) {
+									sl_uint32 size = req->size > 0x40000000 ? 0x40000000 : (sl_uint32)(req->size);
+									if (AsyncUring::read(loop.get(), this, OPERATION_FILE_READ, req->data, size, offset)) {
+										m_requestReadingUring = Move(req);
+									} else {
+										processStreamResult(req.get(), 0, AsyncStreamResultCode::Unknown);
+									}
+								} else {
+									processStreamResult(req.get(), req->size, AsyncStreamResultCode::Success);
+								}
+							}
+						}
+					}
+					if (m_requestWritingUring.isNull()) {
+						Ref<AsyncStreamRequest> req;
+						if (popWriteRequest(req)) {
+							if (req.isNotNull()) {
+								if (req->data && req->size) {
+									sl_uint32 size = req->size > 0x40000000 ? 0x40000000 : (sl_uint32)(req->size);
+									if (AsyncUring::write(loop.get(), this, OPERATION_FILE_WRITE, req->data, size, offset)) {
+										m_requestWritingUring = Move(req);
+									} else {
+										processStreamResult(req.get(), 0, AsyncStreamResultCode::Unknown);
+									}
+								} else {
+									processStreamResult(req.get(), req->size, AsyncStreamResultCode::Success);
+								}
+							}
+						}
+					}
+				}
+
+				void onEvent(EventDesc* pev) override
+				{
+					if (!(pev->flagCompletion)) {
+						return;
+					}
+					sl_int32 result = pev->result;
+					if (result > 0 && m_flagSupportSeeking) {
+						m_offset += result;
+					}
+					AsyncStreamResultCode code;
+					if (result > 0) {
+						code = AsyncStreamResultCode::Success;
+					} else if (isClosing() || result == -ECANCELED) {
+						code = AsyncStreamResultCode::Closed;
+					} else {
+						code = AsyncStreamResultCode::Unknown;
+					}
+					if (pev->operation == OPERATION_FILE_READ) {
+						Ref<AsyncStreamRequest> req = Move(m_requestReadingUring);
+						if (req.isNotNull()) {
+							if (!result) {
+								code = AsyncStreamResultCode::Ended;
+							}
+							processStreamResult(req.get(), result > 0 ? result : 0, code);
+						}
+					} else if (pev->operation == OPERATION_FILE_WRITE) {
+						Ref<AsyncStreamRequest> req = Move(m_requestWritingUring);
+						if (req.isNotNull()) {
+							processStreamResult(req.get(), result > 0 ? result : 0, code);
+						}
+					}
+					if (!(isClosing())) {
+						onOrder();
+					}
+				}
+
+				sl_bool isSeekable() override
+				{
+					return m_flagSupportSeeking;
+				}
+
+				sl_bool seek(sl_uint64 pos) override
+				{
+					if (m_flagSupportSeeking) {
+						m_offset = pos;
+						return sl_true;
+					}
+					return sl_false;
+				}
+
+				sl_uint64 getPosition() override
+				{
+					return m_offset;
+				}
+
+				sl_uint64 getSize() override
+				{
+					sl_uint64 size;
+					if ((HandlePtr<File>(getHandle()))->getSize(size)) {
+						return size;
+					}
+					return 0;
+				}
+
+			};
+
+		}
+	}
+
+	using namespace priv::async_uring;
+
+	void* AsyncIoLoop::_uring_createHandle()
+	{
+		Ring* ring = new Ring;
+		if (ring) {
+			if (ring->initialize()) {
+				return ring;
+			}
+			delete ring;
+		}
+		return sl_null;
+	}
+
+	void AsyncIoLoop::_uring_closeHandle(void* handle)
+	{
+		delete (Ring*)handle;
+	}
+
+	void AsyncIoLoop::_uring_runLoop()
+	{
+		Ring* ring = (Ring*)m_handle;
+		if (!(ring->start())) {
+			return;
+		}
+		while (m_flagRunning) {
+			ring->processAttach();
+			_stepBegin();
+			// The orders and tasks requested on this thread don't wake the ring
+			if (m_flagRunning && m_queueInstancesOrder.isEmpty() && m_queueTasks.isEmpty()) {
+				ring->wait(5000);
+			} else {
+				ring->wait(0);
+			}
+			if (m_queueInstancesClosed.isNotEmpty()) {
+				m_queueInstancesClosed.removeAll();
+			}
+			_uring_processCompletions();
+			if (m_flagRunning) {
+				_stepEnd();
+			}
+		}
+	}
+
+	void AsyncIoLoop::_uring_processCompletions()
+	{
+		Ring* ring = (Ring*)m_handle;
+		unsigned head = *(ring->cqHead);
+		unsigned tail = __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE);
+		while (m_flagRunning && head != tail) {
+			io_uring_cqe* cqe = ring->cqes + (head & ring->cqMask);
+			sl_uint64 userData = cqe->user_data;
+			sl_int32 result = cqe->res;
+			sl_uint32 flags = cqe->flags;
+			head++;
+			__atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+			if (userData == URING_USER_DATA_WAKE) {
+				sl_uint64 n;
+				ssize_t ret = ::read(ring->fdWake, &n, sizeof(n));
+				SLIB_UNUSED(ret)
+				if (!(flags & IORING_CQE_F_MORE)) {
+					ring->armWake();
+				}
+				continue;
+			}
+			if (userData == URING_USER_DATA_IGNORE || !userData) {
+				continue;
+			}
+			Operation* op = (Operation*)userData;
+			Ref<AsyncIoInstance> instance = op->instance;
+			AsyncIoInstance::EventDesc desc;
+			if (op->type == OperationType::Poll) {
+				if (result < 0 || instance->isClosing()) {
+					if (!(flags & IORING_CQE_F_MORE)) {
+						ring->freeOperation(op);
+					}
+					continue;
+				}
+				desc.flagIn = (result & (POLLIN | POLLPRI)) != 0;
+				desc.flagOut = (result & POLLOUT) != 0;
+				desc.flagError = (result & (POLLERR | POLLHUP | POLLRDHUP)) != 0;
+				desc.flagCompletion = sl_false;
+				if (!(flags & IORING_CQE_F_MORE)) {
+					ring->armPoll(op);
+				}
+			} else {
+				desc.flagIn = sl_false;
+				desc.flagOut = sl_false;
+				desc.flagError = sl_false;
+				desc.flagCompletion = sl_true;
+				desc.operation = op->tag;
+				desc.result = result;
+				desc.flagMore = (flags & IORING_CQE_F_MORE) != 0;
+				if (flags & IORING_CQE_F_BUFFER) {
+					desc.bufferIndex = (sl_int32)(flags >> IORING_CQE_BUFFER_SHIFT);
+				} else {
+					desc.bufferIndex = -1;
+				}
+				if (!(desc.flagMore)) {
+					ring->freeOperation(op);
+				}
+				// Delivered also to the closing instance, which completes the requests of the operation
+			}
+			instance->onEvent(&desc);
+		}
+	}
+
+	sl_bool AsyncIoLoop::_uring_attachInstance(AsyncIoInstance* instance, AsyncIoMode mode)
+	{
+		if (instance->isUringInstance() || mode == AsyncIoMode::None) {
+			return sl_true;
+		}
+		Ring* ring = (Ring*)m_handle;
+		AttachRequest request;
+		request.instance = instance;
+		request.mode = mode;
+		if (ring->queueAttach.push(Move(request))) {
+			ring->wake();
+			return sl_true;
+		}
+		return sl_false;
+	}
+
+	void AsyncIoLoop::_uring_detachInstance(AsyncIoInstance* instance)
+	{
+		Ring* ring = (Ring*)m_handle;
+		ring->cancel(instance);
+	}
+
+	void AsyncIoLoop::_uring_wake()
+	{
+		if (Thread::getCurrent() == m_thread.get()) {
+			// Checked by the loop before waiting
+			return;
+		}
+		Ring* ring = (Ring*)m_handle;
+		ring->wake();
+	}
+
+
+	void* AsyncUring::_getRing(AsyncIoLoop* loop)
+	{
+		if (loop && loop->m_backend == AsyncIoBackend::Uring) {
+			return loop->m_handle;
+		}
+		return sl_null;
+	}
+
+	sl_bool AsyncUring::isEnabled(AsyncIoLoop* loop)
+	{
+		return _getRing(loop) != sl_null;
+	}
+
+	sl_bool AsyncUring::read(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, void* buf, sl_uint32 size, sl_uint64 offset)
+	{
+		Ring* ring = (Ring*)(_getRing(loop));
+		if (!ring) {
+			return sl_false;
+		}
+		Operation* op;
+		io_uring_sqe* sqe = ring->prepare(instance, OperationType::Completion, operation, IORING_OP_READ, op);
+		if (!sqe) {
+			return sl_false;
+		}
+		sqe->addr = (sl_uint64)buf;
+		sqe->len = size;
+		sqe->off = offset;
+		return sl_true;
+	}
+
+	sl_bool AsyncUring::write(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, const void* buf, sl_uint32 size, sl_uint64 offset)
+	{
+		Ring* ring = (Ring*)(_getRing(loop));
+		if (!ring) {
+			return sl_false;
+		}
+		Operation* op;
+		io_uring_sqe* sqe = ring->prepare(instance, OperationType::Completion, operation, IORING_OP_WRITE, op);
+		if (!sqe) {
+			return sl_false;
+		}
+		sqe->addr = (sl_uint64)buf;
+		sqe->len = size;
+		sqe->off = offset;
+		return sl_true;
+	}
+
+	sl_bool AsyncUring::receive(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, void* buf, sl_uint32 size, sl_uint32 flags)
+	{
+		Ring* ring = (Ring*)(_getRing(loop));
+		if (!ring) {
+			return sl_false;
+		}
+		Operation* op;
+		io_uring_sqe* sqe = ring->prepare(instance, OperationType::Completion, operation, IORING_OP_RECV, op);
+		if (!sqe) {
+			return sl_false;
+		}
+		sqe->addr = (sl_uint64)buf;
+		sqe->len = size;
+		sqe->msg_flags = flags;
+		return sl_true;
+	}
+
+	sl_bool AsyncUring::sendVector(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, const MemoryView* buffers, sl_uint32 count)
+	{
+		Ring* ring = (Ring*)(_getRing(loop));
+		if (!ring) {
+			return sl_false;
+		}
+		if (!count) {
+			return sl_false;
+		}
+		if (count > URING_MAX_VECTOR) {
+			count = URING_MAX_VECTOR;
+		}
+		Operation* op;
+		io_uring_sqe* sqe = ring->prepare(instance, OperationType::Completion, operation, IORING_OP_SENDMSG, op);
+		if (!sqe) {
+			return sl_false;
+		}
+		if (op->nIovCapacity < count) {
+			iovec* iov = new iovec[count];
+			if (!iov) {
+				sqe->opcode = IORING_OP_NOP;
+				sqe->user_data = URING_USER_DATA_IGNORE;
+				ring->freeOperation(op);
+				return sl_false;
+			}
+			if (op->iov) {
+				delete[] op->iov;
+			}
+			op->iov = iov;
+			op->nIovCapacity = count;
+		}
+		for (sl_uint32 i = 0; i < count; i++) {
+			op->iov[i].iov_base = buffers[i].data;
+			op->iov[i].iov_len = buffers[i].size;
+		}
+		Base::zeroMemory(&(op->msg), sizeof(msghdr));
+		op->msg.msg_iov = op->iov;
+		op->msg.msg_iovlen = count;
+		sqe->addr = (sl_uint64)(&(op->msg));
+		sqe->len = 1;
+		sqe->msg_flags = MSG_NOSIGNAL;
+		return sl_true;
+	}
+
+	sl_bool AsyncUring::accept(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation)
+	{
+		Ring* ring = (Ring*)(_getRing(loop));
+		if (!ring) {
+			return sl_false;
+		}
+		Operation* op;
+		io_uring_sqe* sqe = ring->prepare(instance, OperationType::Completion, operation, IORING_OP_ACCEPT, op);
+		if (!sqe) {
+			return sl_false;
+		}
+		sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+		sqe->accept_flags = SOCK_CLOEXEC;
+		return sl_true;
+	}
+
+	sl_bool AsyncUring::connect(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, const void* address, sl_uint32 sizeAddress, sl_uint32 timeout)
+	{
+		Ring* ring = (Ring*)(_getRing(loop));
+		if (!ring) {
+			return sl_false;
+		}
+		if (sizeAddress > sizeof(sockaddr_storage)) {
+			return sl_false;
+		}
+		if (!(ring->reserve(timeout ? 2 : 1))) {
+			return sl_false;
+		}
+		Operation* op;
+		io_uring_sqe* sqe = ring->prepare(instance, OperationType::Completion, operation, IORING_OP_CONNECT, op);
+		if (!sqe) {
+			return sl_false;
+		}
+		Base::copyMemory(&(op->address), address, sizeAddress);
+		sqe->addr = (sl_uint64)(&(op->address));
+		sqe->off = sizeAddress;
+		if (timeout) {
+			sqe->flags |= IOSQE_IO_LINK;
+			op->timeout.tv_sec = timeout / 1000;
+			op->timeout.tv_nsec = (timeout % 1000) * 1000000;
+			io_uring_sqe* sqeTimeout = ring->getSqe();
+			sqeTimeout->opcode = IORING_OP_LINK_TIMEOUT;
+			sqeTimeout->fd = -1;
+			sqeTimeout->addr = (sl_uint64)(&(op->timeout));
+			sqeTimeout->len = 1;
+			sqeTimeout->user_data = URING_USER_DATA_IGNORE;
+		}
+		return sl_true;
+	}
+
+	sl_bool AsyncUring::receiveMessages(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, sl_uint32 bufferGroup, sl_uint32 sizeName, sl_uint32 sizeControl)
+	{
+		Ring* ring = (Ring*)(_getRing(loop));
+		if (!ring) {
+			return sl_false;
+		}
+		Operation* op;
+		io_uring_sqe* sqe = ring->prepare(instance, OperationType::Completion, operation, IORING_OP_RECVMSG, op);
+		if (!sqe) {
+			return sl_false;
+		}
+		Base::zeroMemory(&(op->msg), sizeof(msghdr));
+		op->msg.msg_namelen = sizeName;
+		op->msg.msg_controllen = sizeControl;
+		sqe->addr = (sl_uint64)(&(op->msg));
+		sqe->len = 1;
+		sqe->ioprio = IORING_RECV_MULTISHOT;
+		sqe->flags |= IOSQE_BUFFER_SELECT;
+		sqe->buf_group = (sl_uint16)bufferGroup;
+		return sl_true;
+	}
+
+	sl_int32 AsyncUring::createBufferGroup(AsyncIoLoop* loop, sl_uint32 count, sl_uint32 size)
+	{
+		Ring* ring = (Ring*)(_getRing(loop));
+		if (!ring) {
+			return -1;
+		}
+		if (!count || count > 32768 || !size) {
+			return -1;
+		}
+		sl_uint32 n = 1;
+		while (n < count) {
+			n <<= 1;
+		}
+		count = n;
+		sl_uint32 id = 0;
+		for (; id < URING_MAX_BUFFER_GROUPS; id++) {
+			if (!(ring->groups[id])) {
+				break;
+			}
+		}
+		if (id >= URING_MAX_BUFFER_GROUPS) {
+			return -1;
+		}
+		BufferGroup* group = new BufferGroup;
+		if (!group) {
+			return -1;
+		}
+		group->count = count;
+		group->size = size;
+		group->sizeRing = count * sizeof(io_uring_buf);
+		group->ring = (io_uring_buf_ring*)(mmap(sl_null, group->sizeRing, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+		if (group->ring != MAP_FAILED) {
+			group->sizeBuffers = (sl_size)count * size;
+			group->buffers = (sl_uint8*)(mmap(sl_null, group->sizeBuffers, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+			if (group->buffers != MAP_FAILED) {
+				io_uring_buf_reg reg;
+				Base::zeroMemory(&reg, sizeof(reg));
+				reg.ring_addr = (sl_uint64)(group->ring);
+				reg.ring_entries = count;
+				reg.bgid = (sl_uint16)id;
+				if (Register(ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) >= 0) {
+					for (sl_uint32 i = 0; i < count; i++) {
+						io_uring_buf* buf = group->getEntry(i);
+						buf->addr = (sl_uint64)(group->buffers + (sl_size)i * size);
+						buf->len = size;
+						buf->bid = (sl_uint16)i;
+					}
+					__atomic_store_n(&(group->ring->tail), (sl_uint16)count, __ATOMIC_RELEASE);
+					ring->groups[id] = group;
+					return (sl_int32)id;
+				}
+				munmap(group->buffers, group->sizeBuffers);
+			}
+			munmap(group->ring, group->sizeRing);
+		}
+		delete group;
+		return -1;
+	}
+
+	void AsyncUring::freeBufferGroup(AsyncIoLoop* loop, sl_uint32 bufferGroup)
+	{
+		Ring* ring = (Ring*)(_getRing(loop));
+		if (!ring || bufferGroup >= URING_MAX_BUFFER_GROUPS) {
+			return;
+		}
+		BufferGroup* group = ring->groups[bufferGroup];
+		if (!group) {
+			return;
+		}
+		io_uring_buf_reg reg;
+		Base::zeroMemory(&reg, sizeof(reg));
+		reg.bgid = (sl_uint16)bufferGroup;
+		Register(ring->fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+		munmap(group->ring, group->sizeRing);
+		munmap(group->buffers, group->sizeBuffers);
+		delete group;
+		ring->groups[bufferGroup] = sl_null;
+	}
+
+	void* AsyncUring::getBuffer(AsyncIoLoop* loop, sl_uint32 bufferGroup, sl_uint32 bufferIndex)
+	{
+		Ring* ring = (Ring*)(_getRing(loop));
+		if (!ring || bufferGroup >= URING_MAX_BUFFER_GROUPS) {
+			return sl_null;
+		}
+		BufferGroup* group = ring->groups[bufferGroup];
+		if (!group || bufferIndex >= group->count) {
+			return sl_null;
+		}
+		return group->buffers + (sl_size)bufferIndex * group->size;
+	}
+
+	void AsyncUring::recycleBuffer(AsyncIoLoop* loop, sl_uint32 bufferGroup, sl_uint32 bufferIndex)
+	{
+		Ring* ring = (Ring*)(_getRing(loop));
+		if (!ring || bufferGroup >= URING_MAX_BUFFER_GROUPS) {
+			return;
+		}
+		BufferGroup* group = ring->groups[bufferGroup];
+		if (!group || bufferIndex >= group->count) {
+			return;
+		}
+		sl_uint16 tail = group->ring->tail;
+		io_uring_buf* buf = group->getEntry(tail);
+		buf->addr = (sl_uint64)(group->buffers + (sl_size)bufferIndex * group->size);
+		buf->len = group->size;
+		buf->bid = (sl_uint16)bufferIndex;
+		__atomic_store_n(&(group->ring->tail), (sl_uint16)(tail + 1), __ATOMIC_RELEASE);
+	}
+
+	sl_uint32 AsyncUring::getMessageBufferSize(sl_uint32 sizeName, sl_uint32 sizeControl, sl_uint32 sizePayload)
+	{
+		return (sl_uint32)sizeof(io_uring_recvmsg_out) + sizeName + sizeControl + sizePayload;
+	}
+
+	sl_bool AsyncUring::parseMessage(const void* buf, sl_uint32 sizeReceived, sl_uint32 sizeName, sl_uint32 sizeControl, void*& outName, sl_uint32& outSizeName, void*& outControl, sl_uint32& outSizeControl, void*& outPayload, sl_uint32& outSizePayload)
+	{
+		sl_uint32 offsetPayload = (sl_uint32)sizeof(io_uring_recvmsg_out) + sizeName + sizeControl;
+		if (sizeReceived < offsetPayload) {
+			return sl_false;
+		}
+		io_uring_recvmsg_out* out = (io_uring_recvmsg_out*)buf;
+		if (out->flags & MSG_TRUNC) {
+			return sl_false;
+		}
+		sl_uint8* p = (sl_uint8*)buf + sizeof(io_uring_recvmsg_out);
+		outName = p;
+		outSizeName = out->namelen > sizeName ? sizeName : out->namelen;
+		outControl = p + sizeName;
+		outSizeControl = out->controllen > sizeControl ? sizeControl : out->controllen;
+		outPayload = p + sizeName + sizeControl;
+		sl_uint32 sizePayload = sizeReceived - offsetPayload;
+		outSizePayload = out->payloadlen > sizePayload ? sizePayload : out->payloadlen;
+		return sl_true;
+	}
+
+	Ref<AsyncFileStreamInstance> AsyncUring::createFileInstance(const AsyncFileStreamParam& param)
+	{
+		return Ref<AsyncFileStreamInstance>::from(FileInstance::create(param));
+	}
+
+}
+
+#else
+
+namespace slib
+{
+
+	void* AsyncIoLoop::_uring_createHandle()
+	{
+		return sl_null;
+	}
+
+	void AsyncIoLoop::_uring_closeHandle(void* handle)
+	{
+	}
+
+	void AsyncIoLoop::_uring_runLoop()
+	{
+	}
+
+	void AsyncIoLoop::_uring_processCompletions()
+	{
+	}
+
+	sl_bool AsyncIoLoop::_uring_attachInstance(AsyncIoInstance* instance, AsyncIoMode mode)
+	{
+		return sl_false;
+	}
+
+	void AsyncIoLoop::_uring_detachInstance(AsyncIoInstance* instance)
+	{
+	}
+
+	void AsyncIoLoop::_uring_wake()
+	{
+	}
+
+
+	void* AsyncUring::_getRing(AsyncIoLoop* loop)
+	{
+		return sl_null;
+	}
+
+	sl_bool AsyncUring::isEnabled(AsyncIoLoop* loop)
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncUring::read(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, void* buf, sl_uint32 size, sl_uint64 offset)
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncUring::write(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, const void* buf, sl_uint32 size, sl_uint64 offset)
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncUring::receive(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, void* buf, sl_uint32 size, sl_uint32 flags)
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncUring::sendVector(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, const MemoryView* buffers, sl_uint32 count)
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncUring::accept(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation)
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncUring::connect(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, const void* address, sl_uint32 sizeAddress, sl_uint32 timeout)
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncUring::receiveMessages(AsyncIoLoop* loop, AsyncIoInstance* instance, sl_uint32 operation, sl_uint32 bufferGroup, sl_uint32 sizeName, sl_uint32 sizeControl)
+	{
+		return sl_false;
+	}
+
+	sl_int32 AsyncUring::createBufferGroup(AsyncIoLoop* loop, sl_uint32 count, sl_uint32 size)
+	{
+		return -1;
+	}
+
+	void AsyncUring::freeBufferGroup(AsyncIoLoop* loop, sl_uint32 bufferGroup)
+	{
+	}
+
+	void* AsyncUring::getBuffer(AsyncIoLoop* loop, sl_uint32 bufferGroup, sl_uint32 bufferIndex)
+	{
+		return sl_null;
+	}
+
+	void AsyncUring::recycleBuffer(AsyncIoLoop* loop, sl_uint32 bufferGroup, sl_uint32 bufferIndex)
+	{
+	}
+
+	sl_uint32 AsyncUring::getMessageBufferSize(sl_uint32 sizeName, sl_uint32 sizeControl, sl_uint32 sizePayload)
+	{
+		return 0;
+	}
+
+	sl_bool AsyncUring::parseMessage(const void* buf, sl_uint32 sizeReceived, sl_uint32 sizeName, sl_uint32 sizeControl, void*& outName, sl_uint32& outSizeName, void*& outControl, sl_uint32& outSizeControl, void*& outPayload, sl_uint32& outSizePayload)
+	{
+		return sl_false;
+	}
+
+	Ref<AsyncFileStreamInstance> AsyncUring::createFileInstance(const AsyncFileStreamParam& param)
+	{
+		return sl_null;
+	}
+
+}
+
+#endif
+
+#endif
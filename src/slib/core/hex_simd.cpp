@@ -0,0 +1,175 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "hex_simd.h"
+
+#include "slib/core/cpu.h"
+
+#if !defined(SLIB_PLATFORM_IS_MOBILE) && defined(SLIB_ARCH_IS_X64)
+#	define SUPPORT_AVX2
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#		define TARGET_AVX2
+#	else
+#		include <immintrin.h>
+#		define TARGET_AVX2 __attribute__((target("avx2")))
+#	endif
+#elif defined(SLIB_ARCH_IS_ARM64)
+#	define SUPPORT_NEON
+#	include <arm_neon.h>
+#endif
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace hex_simd
+		{
+
+			SLIB_ALIGN(16) static const char g_patternLower[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+			SLIB_ALIGN(16) static const char g_patternUpper[16] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+
+#if defined(SUPPORT_AVX2)
+			TARGET_AVX2 static sl_size Encode_AVX2(sl_char8* output, const sl_uint8* input, sl_size size, const char* pattern) noexcept
+			{
+				const __m256i lookup = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)pattern));
+				const __m256i mask = _mm256_set1_epi8(0x0f);
+				sl_size n = 0;
+				while (size - n >= 32) {
+					__m256i v = _mm256_loadu_si256((const __m256i*)(input + n));
+					__m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+					__m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, mask));
+					// Unpacking works within 128-bit lanes: (0-7, 16-23) and (8-15, 24-31)
+					__m256i a = _mm256_unpacklo_epi8(hi, lo);
+					__m256i b = _mm256_unpackhi_epi8(hi, lo);
+					_mm256_storeu_si256((__m256i*)output, _mm256_permute2x128_si256(a, b, 0x20));
+					_mm256_storeu_si256((__m256i*)(output + 32), _mm256_permute2x128_si256(a, b, 0x31));
+					output += 64;
+					n += 32;
+				}
+				return n;
+			}
+
+			TARGET_AVX2 static sl_size Decode_AVX2(sl_uint8* output, const sl_char8* input, sl_size len) noexcept
+			{
+				const __m256i merge = _mm256_set1_epi16(0x0110);
+				sl_size n = 0;
+				while (len - n >= 32) {
+					__m256i c = _mm256_loadu_si256((const __m256i*)(input + n));
+					// Signed comparisons also reject non-ASCII characters
+					__m256i mDigit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+					__m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+					__m256i mAlpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+					if (_mm256_movemask_epi8(_mm256_or_si256(mDigit, mAlpha)) != -1) {
+						break;
+					}
+					__m256i v = _mm256_or_si256(
+						_mm256_and_si256(mDigit, _mm256_sub_epi8(c, _mm256_set1_epi8('0'))),
+						_mm256_and_si256(mAlpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+					// (high << 4) | low in each 16-bit lane
+					v = _mm256_maddubs_epi16(v, merge);
+					v = _mm256_packus_epi16(v, v);
+					v = _mm256_permute4x64_epi64(v, 0x08);
+					_mm_storeu_si128((__m128i*)output, _mm256_castsi256_si128(v));
+					output += 16;
+					n += 32;
+				}
+				return n;
+			}
+#endif
+
+#if defined(SUPPORT_NEON)
+			static sl_size Encode_NEON(sl_char8* output, const sl_uint8* input, sl_size size, const char* pattern) noexcept
+			{
+				const uint8x16_t lookup = vld1q_u8((const sl_uint8*)pattern);
+				const uint8x16_t mask = vdupq_n_u8(0x0f);
+				sl_size n = 0;
+				while (size - n >= 16) {
+					uint8x16_t v = vld1q_u8(input + n);
+					uint8x16x2_t r;
+					r.val[0] = vqtbl1q_u8(lookup, vshrq_n_u8(v, 4));
+					r.val[1] = vqtbl1q_u8(lookup, vandq_u8(v, mask));
+					vst2q_u8((sl_uint8*)output, r);
+					output += 32;
+					n += 16;
+				}
+				return n;
+			}
+
+			static uint8x16_t DecodeNibble(uint8x16_t c, uint8x16_t& valid) noexcept
+			{
+				uint8x16_t digit = vsubq_u8(c, vdupq_n_u8('0'));
+				uint8x16_t alpha = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+				uint8x16_t mDigit = vcltq_u8(digit, vdupq_n_u8(10));
+				uint8x16_t mAlpha = vcltq_u8(alpha, vdupq_n_u8(6));
+				valid = vandq_u8(valid, vorrq_u8(mDigit, mAlpha));
+				return vorrq_u8(vandq_u8(mDigit, digit), vandq_u8(mAlpha, vaddq_u8(alpha, vdupq_n_u8(10))));
+			}
+
+			static sl_size Decode_NEON(sl_uint8* output, const sl_char8* input, sl_size len) noexcept
+			{
+				sl_size n = 0;
+				while (len - n >= 32) {
+					uint8x16x2_t c = vld2q_u8((const sl_uint8*)(input + n));
+					uint8x16_t valid = vdupq_n_u8(0xff);
+					uint8x16_t hi = DecodeNibble(c.val[0], valid);
+					uint8x16_t lo = DecodeNibble(c.val[1], valid);
+					if (vminvq_u8(valid) != 0xff) {
+						break;
+					}
+					vst1q_u8(output, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+					output += 16;
+					n += 32;
+				}
+				return n;
+			}
+#endif
+
+			sl_size Encode(sl_char8* output, const sl_uint8* input, sl_size size, sl_bool flagUseLowerChar) noexcept
+			{
+#if defined(SUPPORT_AVX2)
+				if (size >= 32 && Cpu::isSupportedAVX2()) {
+					return Encode_AVX2(output, input, size, flagUseLowerChar ? g_patternLower : g_patternUpper);
+				}
+#elif defined(SUPPORT_NEON)
+				return Encode_NEON(output, input, size, flagUseLowerChar ? g_patternLower : g_patternUpper);
+#endif
+				return 0;
+			}
+
+			sl_size Decode(sl_uint8* output, const sl_char8* input, sl_size len) noexcept
+			{
+#if defined(SUPPORT_AVX2)
+				if (len >= 32 && Cpu::isSupportedAVX2()) {
+					return Decode_AVX2(output, input, len);
+				}
+#elif defined(SUPPORT_NEON)
+				return Decode_NEON(output, input, len);
+#endif
+				return 0;
+			}
+
+		}
+	}
+
+}
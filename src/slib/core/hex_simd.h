@@ -0,0 +1,54 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_HEX_SIMD
+#define CHECKHEADER_SLIB_CORE_HEX_SIMD
+
+#include "slib/core/definition.h"
+
+/*
+	Vectorized hexadecimal codecs (AVX2, NEON) used by `String::makeHexString()` and `String::parseHexString()`
+
+	The kernels process whole blocks only and leave the tail to the scalar codec.
+*/
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace hex_simd
+		{
+
+			// Returns the number of encoded input bytes. `output` receives (return * 2) characters.
+			sl_size Encode(sl_char8* output, const sl_uint8* input, sl_size size, sl_bool flagUseLowerChar) noexcept;
+
+			// Stops at the first block containing a non-hexadecimal character.
+			// Returns the number of decoded characters (even). `output` receives (return / 2) bytes.
+			sl_size Decode(sl_uint8* output, const sl_char8* input, sl_size len) noexcept;
+
+		}
+	}
+
+}
+
+#endif
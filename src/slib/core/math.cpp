@@ -887,7 +887,7 @@ namespace slib
 		sl_uint64 bh = b >> 32;
 		sl_uint64 m0 = al * bl;
 		sl_uint64 m1 = al * bh + (m0 >> 32);
-		sl_uint64 m2 = bh * al + (sl_uint32)(m1);
+		sl_uint64 m2 = ah * bl + (sl_uint32)(m1);
 		o_low = (((sl_uint64)((sl_uint32)m2)) << 32) + ((sl_uint32)m0);
 		o_high = ah * bh + (m1 >> 32) + (m2 >> 32);
 #endif
@@ -0,0 +1,188 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/core/memory_pool.h"
+
+#include "slib/core/base.h"
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace memory_pool
+		{
+
+			class PooledMemory : public CMemory
+			{
+			public:
+				Ref<MemoryPool> pool;
+
+			public:
+				PooledMemory(MemoryPool* _pool, void* _data, sl_size _size) noexcept: CMemory(_data, _size), pool(_pool) {}
+
+				~PooledMemory() noexcept
+				{
+					pool->freeBlock(data);
+				}
+
+			};
+
+		}
+	}
+
+	using namespace priv::memory_pool;
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(MemoryPoolStatus)
+
+	MemoryPoolStatus::MemoryPoolStatus() noexcept
+	{
+		blockSize = 0;
+		inUseCount = 0;
+		stockCount = 0;
+		allocationCount = 0;
+		reuseCount = 0;
+	}
+
+
+	MemoryPool::MemoryPool(sl_size blockSize, sl_size maxStockCount) noexcept
+	{
+		if (blockSize < sizeof(void*)) {
+			blockSize = sizeof(void*);
+		}
+		m_blockSize = blockSize;
+		m_maxStockCount = maxStockCount;
+		m_stock = sl_null;
+		m_stockCount = 0;
+		m_inUseCount = 0;
+		m_allocationCount = 0;
+		m_reuseCount = 0;
+	}
+
+	MemoryPool::~MemoryPool() noexcept
+	{
+		trim();
+	}
+
+	Ref<MemoryPool> MemoryPool::create(sl_size blockSize, sl_size maxStockCount) noexcept
+	{
+		if (!blockSize) {
+			return sl_null;
+		}
+		return new MemoryPool(blockSize, maxStockCount);
+	}
+
+	void* MemoryPool::allocateBlock() noexcept
+	{
+		{
+			SpinLocker lock(&m_lock);
+			void* block = m_stock;
+			if (block) {
+				m_stock = *((void**)block);
+				m_stockCount--;
+				m_inUseCount++;
+				m_reuseCount++;
+				return block;
+			}
+		}
+		void* block = Base::createMemory(m_blockSize);
+		if (block) {
+			SpinLocker lock(&m_lock);
+			m_inUseCount++;
+			m_allocationCount++;
+		}
+		return block;
+	}
+
+	void MemoryPool::freeBlock(void* block) noexcept
+	{
+		if (!block) {
+			return;
+		}
+		{
+			SpinLocker lock(&m_lock);
+			m_inUseCount--;
+			if (m_stockCount < m_maxStockCount) {
+				*((void**)block) = m_stock;
+				m_stock = block;
+				m_stockCount++;
+				return;
+			}
+		}
+		Base::freeMemory(block);
+	}
+
+	Memory MemoryPool::allocate() noexcept
+	{
+		void* block = allocateBlock();
+		if (block) {
+			CMemory* mem = new PooledMemory(this, block, m_blockSize);
+			if (mem) {
+				return mem;
+			}
+			freeBlock(block);
+		}
+		return sl_null;
+	}
+
+	sl_size MemoryPool::getBlockSize() noexcept
+	{
+		return m_blockSize;
+	}
+
+	sl_size MemoryPool::getMaxStockCount() noexcept
+	{
+		return m_maxStockCount;
+	}
+
+	void MemoryPool::setMaxStockCount(sl_size count) noexcept
+	{
+		m_maxStockCount = count;
+	}
+
+	void MemoryPool::getStatus(MemoryPoolStatus& status) noexcept
+	{
+		SpinLocker lock(&m_lock);
+		status.blockSize = m_blockSize;
+		status.inUseCount = m_inUseCount;
+		status.stockCount = m_stockCount;
+		status.allocationCount = m_allocationCount;
+		status.reuseCount = m_reuseCount;
+	}
+
+	void MemoryPool::trim() noexcept
+	{
+		void* block;
+		{
+			SpinLocker lock(&m_lock);
+			block = m_stock;
+			m_stock = sl_null;
+			m_stockCount = 0;
+		}
+		while (block) {
+			void* next = *((void**)block);
+			Base::freeMemory(block);
+			block = next;
+		}
+	}
+
+}
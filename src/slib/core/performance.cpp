@@ -77,17 +77,134 @@ namespace slib
 
 
 #ifdef SLIB_ARCH_IS_X64
-			static sl_bool IsSupportedSSE42() noexcept
+			static void GetCpuId(sl_uint32 leaf, sl_uint32 subleaf, sl_uint32* regs) noexcept
 			{
 #if defined(SLIB_COMPILER_IS_VC)
 				int cpu_info[4];
-				__cpuid(cpu_info, 1);
-				return (cpu_info[2] & (1 << 20)) != 0;
+				__cpuid(cpu_info, 0);
+				if ((sl_uint32)(cpu_info[0]) >= leaf) {
+					__cpuidex(cpu_info, (int)leaf, (int)subleaf);
+					for (int i = 0; i < 4; i++) {
+						regs[i] = (sl_uint32)(cpu_info[i]);
+					}
+					return;
+				}
 #else
 				unsigned int eax, ebx, ecx, edx;
-				return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && ((ecx & (1 << 20)) != 0);
+				if (__get_cpuid_max(0, sl_null) >= leaf) {
+					__cpuid_count(leaf, subleaf, eax, ebx, ecx, edx);
+					regs[0] = eax;
+					regs[1] = ebx;
+					regs[2] = ecx;
+					regs[3] = edx;
+					return;
+				}
+#endif
+				regs[0] = regs[1] = regs[2] = regs[3] = 0;
+			}
+
+			static sl_bool IsSupportedSSE42() noexcept
+			{
+				sl_uint32 regs[4];
+				GetCpuId(1, 0, regs);
+				return (regs[2] & (1 << 20)) != 0;
+			}
+
+			static sl_bool IsSupportedAES() noexcept
+			{
+				sl_uint32 regs[4];
+				GetCpuId(1, 0, regs);
+				return (regs[2] & (1 << 25)) != 0;
+			}
+
+			static sl_bool IsSupportedPCLMUL() noexcept
+			{
+				sl_uint32 regs[4];
+				GetCpuId(1, 0, regs);
+				return (regs[2] & (1 << 1)) != 0;
+			}
+
+			static sl_uint64 GetEnabledXStates() noexcept
+			{
+				sl_uint32 regs[4];
+				GetCpuId(1, 0, regs);
+				// OSXSAVE, AVX
+				if ((regs[2] & 0x18000000) != 0x18000000) {
+					return 0;
+				}
+#if defined(SLIB_COMPILER_IS_VC)
+				return (sl_uint64)(_xgetbv(0));
+#else
+				sl_uint32 xcr0Low, xcr0High;
+				__asm__ __volatile__ ("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+				return xcr0Low;
 #endif
 			}
+
+			static sl_bool IsSupportedAVX2() noexcept
+			{
+				// XMM and YMM states are enabled by OS
+				if ((GetEnabledXStates() & 6) != 6) {
+					return sl_false;
+				}
+				sl_uint32 regs[4];
+				GetCpuId(7, 0, regs);
+				return (regs[1] & (1 << 5)) != 0;
+			}
+
+			static sl_bool IsSupportedVAES() noexcept
+			{
+				if (!(Cpu::isSupportedAVX2())) {
+					return sl_false;
+				}
+				sl_uint32 regs[4];
+				GetCpuId(7, 0, regs);
+				return (regs[2] & (1 << 9)) != 0;
+			}
+
+			static sl_bool IsSupportedAVX512F() noexcept
+			{
+				// XMM, YMM, opmask and ZMM states are enabled by OS
+				if ((GetEnabledXStates() & 0xE6) != 0xE6) {
+					return sl_false;
+				}
+				sl_uint32 regs[4];
+				GetCpuId(7, 0, regs);
+				return (regs[1] & (1 << 16)) != 0;
+			}
+
+			static sl_bool IsSupportedVPCLMUL() noexcept
+			{
+				if (!(Cpu::isSupportedAVX512F())) {
+					return sl_false;
+				}
+				sl_uint32 regs[4];
+				GetCpuId(7, 0, regs);
+				return (regs[2] & (1 << 10)) != 0;
+			}
+
+			static sl_bool IsSupportedAVX512VBMI() noexcept
+			{
+				if (!(Cpu::isSupportedAVX512F())) {
+					return sl_false;
+				}
+				sl_uint32 regs[4];
+				GetCpuId(7, 0, regs);
+				// AVX512BW, AVX512_VBMI
+				return (regs[1] & (1 << 30)) && (regs[2] & (1 << 1));
+			}
+
+			static sl_bool IsSupportedSHA() noexcept
+			{
+				sl_uint32 regs[4];
+				GetCpuId(1, 0, regs);
+				// SSE4.1
+				if (!(regs[2] & (1 << 19))) {
+					return sl_false;
+				}
+				GetCpuId(7, 0, regs);
+				return (regs[1] & (1 << 29)) != 0;
+			}
 #endif
 
 		}
@@ -107,6 +224,54 @@ namespace slib
 		static sl_bool f = IsSupportedSSE42();
 		return f;
 	}
+
+	sl_bool Cpu::isSupportedAES() noexcept
+	{
+		static sl_bool f = IsSupportedAES();
+		return f;
+	}
+
+	sl_bool Cpu::isSupportedPCLMUL() noexcept
+	{
+		static sl_bool f = IsSupportedPCLMUL();
+		return f;
+	}
+
+	sl_bool Cpu::isSupportedAVX2() noexcept
+	{
+		static sl_bool f = IsSupportedAVX2();
+		return f;
+	}
+
+	sl_bool Cpu::isSupportedVAES() noexcept
+	{
+		static sl_bool f = IsSupportedVAES();
+		return f;
+	}
+
+	sl_bool Cpu::isSupportedAVX512F() noexcept
+	{
+		static sl_bool f = IsSupportedAVX512F();
+		return f;
+	}
+
+	sl_bool Cpu::isSupportedVPCLMUL() noexcept
+	{
+		static sl_bool f = IsSupportedVPCLMUL();
+		return f;
+	}
+
+	sl_bool Cpu::isSupportedSHA() noexcept
+	{
+		static sl_bool f = IsSupportedSHA();
+		return f;
+	}
+
+	sl_bool Cpu::isSupportedAVX512VBMI() noexcept
+	{
+		static sl_bool f = IsSupportedAVX512VBMI();
+		return f;
+	}
 #endif
 
 
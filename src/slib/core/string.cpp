@@ -33,6 +33,8 @@
 #include "slib/core/time_zone.h"
 #include "slib/math/bigint.h"
 
+#include "hex_simd.h"
+
 #define EMPTY_SZ(CHAR_TYPE) ((CHAR_TYPE*)"\0\0\0\0")
 
 namespace slib
@@ -2874,6 +2876,17 @@ namespace slib
 				return sl_false;
 			}
 
+			static sl_size ParseHexStringSIMD(sl_uint8* output, const sl_char8* str, sl_size len) noexcept
+			{
+				return hex_simd::Decode(output, str, len);
+			}
+
+			template <class CHAR>
+			static sl_size ParseHexStringSIMD(sl_uint8* output, const CHAR* str, sl_size len) noexcept
+			{
+				return 0;
+			}
+
 			template <class CHAR>
 			static sl_reg ParseHexString(const CHAR* str, sl_size i, sl_size n, void* _out) noexcept
 			{
@@ -2881,7 +2894,9 @@ namespace slib
 					return SLIB_PARSE_ERROR;
 				}
 				sl_uint8* buf = (sl_uint8*)(_out);
-				sl_size k = 0;
+				sl_size k = ParseHexStringSIMD(buf, str + i, n - i);
+				i += k;
+				k >>= 1;
 				for (; i < n; i += 2) {
 					sl_uint32 v1, v2;
 					{
@@ -3292,6 +3307,17 @@ namespace slib
 				return typename StringTypeFromCharType<CHAR>::Type(buf, str - buf);
 			}
 
+			static sl_size MakeHexStringSIMD(sl_char8* output, const sl_uint8* input, sl_size size, sl_bool flagUseLowerChar) noexcept
+			{
+				return hex_simd::Encode(output, input, size, flagUseLowerChar);
+			}
+
+			template <class CHAR>
+			static sl_size MakeHexStringSIMD(CHAR* output, const sl_uint8* input, sl_size size, sl_bool flagUseLowerChar) noexcept
+			{
+				return 0;
+			}
+
 			template <class CHAR>
 			static typename StringTypeFromCharType<CHAR>::Type MakeHexString(const void* buf, sl_size size, sl_bool flagUseLowerChar) noexcept
 			{
@@ -3303,6 +3329,10 @@ namespace slib
 					return str;
 				}
 				CHAR* data = (CHAR*)(str.getData());
+				sl_size n = MakeHexStringSIMD(data, (const sl_uint8*)buf, size, flagUseLowerChar);
+				buf = (const sl_uint8*)buf + n;
+				data += n << 1;
+				size -= n;
 				if (flagUseLowerChar) {
 					for (sl_size i = 0; i < size; i++) {
 						sl_uint8 v = ((sl_uint8*)(buf))[i];
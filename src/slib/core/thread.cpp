@@ -506,7 +506,10 @@ namespace slib
 		}
 		m_flagRunning = sl_false;
 
-		ListElements< Ref<Thread> > threads(m_threadWorkers);
+		List< Ref<Thread> > workers(m_threadWorkers.duplicate_NoLock());
+		// Workers take this lock before sleeping, so it must not be held while joining them
+		lock.unlock();
+		ListElements< Ref<Thread> > threads(workers);
 		sl_size i;
 		for (i = 0; i < threads.count; i++) {
 			threads[i]->finish();
@@ -582,6 +585,10 @@ namespace slib
 				task();
 			} else {
 				ObjectLocker lock(this);
+				// `addTask()` pushes under this lock, so a task added after the failed `pop()` is visible here
+				if (m_tasks.getCount()) {
+					continue;
+				}
 				sl_size nThreads = m_threadWorkers.getCount();
 				if (nThreads > getMinimumThreadCount()) {
 					m_threadWorkers.remove_NoLock(thread);
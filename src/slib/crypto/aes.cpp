@@ -24,6 +24,8 @@
 
 #include "slib/crypto/sha2.h"
 
+#include "aes_hw.h"
+
 /*
 	AES - Advanced Encryption Standard
 
@@ -409,6 +411,7 @@ namespace slib
 
 	AES::AES()
 	{
+		m_flagHardware = sl_false;
 	}
 
 	AES::~AES()
@@ -514,6 +517,15 @@ namespace slib
 			W += 4;
 		}
 		Base::copyMemory(W, WE, 32);
+
+		m_flagHardware = priv::aes_hw::IsSupported();
+		if (m_flagHardware) {
+			j = (nRounds + 1) << 2;
+			for (i = 0; i < j; i++) {
+				MIO::writeUint32BE(m_roundKeyEncHardware + (i << 2), m_roundKeyEnc[i]);
+				MIO::writeUint32BE(m_roundKeyDecHardware + (i << 2), m_roundKeyDec[i]);
+			}
+		}
 		return sl_true;
 	}
 
@@ -524,6 +536,10 @@ namespace slib
 	
 	void AES::encryptBlock(const void* _src, void *_dst) const
 	{
+		if (m_flagHardware) {
+			priv::aes_hw::EncryptBlocks(m_roundKeyEncHardware, m_nCountRounds, (const sl_uint8*)_src, (sl_uint8*)_dst, 1);
+			return;
+		}
 		const sl_uint8* IN = (const sl_uint8*)_src;
 		sl_uint8* OUT = (sl_uint8*)_dst;
 
@@ -547,6 +563,10 @@ namespace slib
 	
 	void AES::decryptBlock(const void* _src, void *_dst) const
 	{
+		if (m_flagHardware) {
+			priv::aes_hw::DecryptBlocks(m_roundKeyDecHardware, m_nCountRounds, (const sl_uint8*)_src, (sl_uint8*)_dst, 1);
+			return;
+		}
 		const sl_uint8* IN = (const sl_uint8*)_src;
 		sl_uint8* OUT = (sl_uint8*)_dst;
 		
@@ -563,6 +583,51 @@ namespace slib
 		MIO::writeUint32BE(OUT + 12, d3);
 	}
 
+	void AES::encryptBlocks(const void* src, void* dst, sl_size size) const
+	{
+		if (m_flagHardware) {
+			priv::aes_hw::EncryptBlocks(m_roundKeyEncHardware, m_nCountRounds, (const sl_uint8*)src, (sl_uint8*)dst, size >> 4);
+		} else {
+			BlockCipher<AES>::encryptBlocks(src, dst, size);
+		}
+	}
+
+	void AES::decryptBlocks(const void* src, void* dst, sl_size size) const
+	{
+		if (m_flagHardware) {
+			priv::aes_hw::DecryptBlocks(m_roundKeyDecHardware, m_nCountRounds, (const sl_uint8*)src, (sl_uint8*)dst, size >> 4);
+		} else {
+			BlockCipher<AES>::decryptBlocks(src, dst, size);
+		}
+	}
+
+	void AES::encryptBlocks_CBC(const void* src, void* dst, sl_size size, void* iv) const
+	{
+		if (m_flagHardware) {
+			priv::aes_hw::EncryptBlocks_CBC(m_roundKeyEncHardware, m_nCountRounds, (const sl_uint8*)src, (sl_uint8*)dst, size >> 4, (sl_uint8*)iv);
+		} else {
+			BlockCipher<AES>::encryptBlocks_CBC(src, dst, size, iv);
+		}
+	}
+
+	void AES::decryptBlocks_CBC(const void* src, void* dst, sl_size size, void* iv) const
+	{
+		if (m_flagHardware) {
+			priv::aes_hw::DecryptBlocks_CBC(m_roundKeyDecHardware, m_nCountRounds, (const sl_uint8*)src, (sl_uint8*)dst, size >> 4, (sl_uint8*)iv);
+		} else {
+			BlockCipher<AES>::decryptBlocks_CBC(src, dst, size, iv);
+		}
+	}
+
+	void AES::encryptBlocks_CTR(const void* src, void* dst, sl_size size, void* counter, sl_uint32 counterSize) const
+	{
+		if (m_flagHardware && (counterSize == 4 || counterSize == 8 || counterSize == 16)) {
+			priv::aes_hw::EncryptBlocks_CTR(m_roundKeyEncHardware, m_nCountRounds, (const sl_uint8*)src, (sl_uint8*)dst, size >> 4, (sl_uint8*)counter, counterSize);
+		} else {
+			BlockCipher<AES>::encryptBlocks_CTR(src, dst, size, counter, counterSize);
+		}
+	}
+
 	void AES::setKey_SHA256(const StringView& key)
 	{
 		char sig[32];
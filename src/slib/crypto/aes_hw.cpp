@@ -0,0 +1,664 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "aes_hw.h"
+
+#include "slib/core/cpu.h"
+#include "slib/core/mio.h"
+
+#if !defined(SLIB_PLATFORM_IS_MOBILE) && defined(SLIB_ARCH_IS_X64)
+#	define SUPPORT_AES_NI
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#		define TARGET_VAES
+#	else
+#		include <immintrin.h>
+#		define TARGET_VAES __attribute__((target("avx2,vaes")))
+#	endif
+#elif defined(SLIB_ARCH_IS_ARM64) && defined(__ARM_FEATURE_CRYPTO)
+#	define SUPPORT_ARM_CRYPTO
+#	include <arm_neon.h>
+#endif
+
+#define PRIV_AES_HW_4(STEP) STEP(0) STEP(1) STEP(2) STEP(3)
+#define PRIV_AES_HW_8(STEP) STEP(0) STEP(1) STEP(2) STEP(3) STEP(4) STEP(5) STEP(6) STEP(7)
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace aes_hw
+		{
+
+#if defined(SUPPORT_AES_NI) || defined(SUPPORT_ARM_CRYPTO)
+
+			class Counter
+			{
+			public:
+				sl_uint64 high;
+				sl_uint64 low;
+				sl_uint32 size;
+
+			public:
+				Counter(const sl_uint8* counter, sl_uint32 _size)
+				{
+					high = MIO::readUint64BE(counter);
+					low = MIO::readUint64BE(counter + 8);
+					size = _size;
+				}
+
+			public:
+				SLIB_INLINE void increase()
+				{
+					if (size == 4) {
+						low = (low & SLIB_UINT64(0xFFFFFFFF00000000)) | (sl_uint32)(low + 1);
+					} else {
+						low++;
+						if (!low && size == 16) {
+							high++;
+						}
+					}
+				}
+
+				void save(sl_uint8* counter)
+				{
+					MIO::writeUint64BE(counter, high);
+					MIO::writeUint64BE(counter + 8, low);
+				}
+
+			};
+
+#if defined(SUPPORT_AES_NI)
+			typedef __m128i Block;
+
+#	define LOAD_BLOCK(p) _mm_loadu_si128((const __m128i*)(p))
+#	define STORE_BLOCK(p, v) _mm_storeu_si128((__m128i*)(p), (v))
+#	define XOR_BLOCK(a, b) _mm_xor_si128((a), (b))
+
+			static SLIB_INLINE Block GetCounterBlock(Counter& counter)
+			{
+				Block ret = _mm_shuffle_epi8(_mm_set_epi64x((sl_int64)(counter.low), (sl_int64)(counter.high)), _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7));
+				counter.increase();
+				return ret;
+			}
+
+			static SLIB_INLINE Block EncryptBlock(const Block* K, sl_uint32 nRounds, Block x)
+			{
+				x = _mm_xor_si128(x, K[0]);
+				for (sl_uint32 i = 1; i < nRounds; i++) {
+					x = _mm_aesenc_si128(x, K[i]);
+				}
+				return _mm_aesenclast_si128(x, K[nRounds]);
+			}
+
+			static SLIB_INLINE Block DecryptBlock(const Block* K, sl_uint32 nRounds, Block x)
+			{
+				x = _mm_xor_si128(x, K[0]);
+				for (sl_uint32 i = 1; i < nRounds; i++) {
+					x = _mm_aesdec_si128(x, K[i]);
+				}
+				return _mm_aesdeclast_si128(x, K[nRounds]);
+			}
+
+			static SLIB_INLINE void EncryptBlocks8(const Block* K, sl_uint32 nRounds, Block* x)
+			{
+				Block k = K[0];
+#define PRIV_AES_HW_STEP(N) x[N] = _mm_xor_si128(x[N], k);
+				PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+				for (sl_uint32 i = 1; i < nRounds; i++) {
+					k = K[i];
+#define PRIV_AES_HW_STEP(N) x[N] = _mm_aesenc_si128(x[N], k);
+					PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+				}
+				k = K[nRounds];
+#define PRIV_AES_HW_STEP(N) x[N] = _mm_aesenclast_si128(x[N], k);
+				PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+			}
+
+			static SLIB_INLINE void DecryptBlocks8(const Block* K, sl_uint32 nRounds, Block* x)
+			{
+				Block k = K[0];
+#define PRIV_AES_HW_STEP(N) x[N] = _mm_xor_si128(x[N], k);
+				PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+				for (sl_uint32 i = 1; i < nRounds; i++) {
+					k = K[i];
+#define PRIV_AES_HW_STEP(N) x[N] = _mm_aesdec_si128(x[N], k);
+					PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+				}
+				k = K[nRounds];
+#define PRIV_AES_HW_STEP(N) x[N] = _mm_aesdeclast_si128(x[N], k);
+				PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+			}
+
+			static SLIB_INLINE void DecryptBlocks4(const Block* K, sl_uint32 nRounds, Block* x)
+			{
+				Block k = K[0];
+#define PRIV_AES_HW_STEP(N) x[N] = _mm_xor_si128(x[N], k);
+				PRIV_AES_HW_4(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+				for (sl_uint32 i = 1; i < nRounds; i++) {
+					k = K[i];
+#define PRIV_AES_HW_STEP(N) x[N] = _mm_aesdec_si128(x[N], k);
+					PRIV_AES_HW_4(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+				}
+				k = K[nRounds];
+#define PRIV_AES_HW_STEP(N) x[N] = _mm_aesdeclast_si128(x[N], k);
+				PRIV_AES_HW_4(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+			}
+
+			// 16 blocks in 8 registers of 256 bits
+			TARGET_VAES static sl_size EncryptBlocks_VAES(const sl_uint8* keys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks, Counter* counter)
+			{
+				__m256i K[15];
+				sl_uint32 i;
+				for (i = 0; i <= nRounds; i++) {
+					K[i] = _mm256_broadcastsi128_si256(LOAD_BLOCK(keys + (i << 4)));
+				}
+				sl_size n = nBlocks >> 4;
+				for (sl_size iter = 0; iter < n; iter++) {
+					__m256i x[8];
+					if (counter) {
+#define PRIV_AES_HW_STEP(N) x[N] = _mm256_castsi128_si256(GetCounterBlock(*counter)); x[N] = _mm256_xor_si256(_mm256_inserti128_si256(x[N], GetCounterBlock(*counter), 1), K[0]);
+						PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					} else {
+#define PRIV_AES_HW_STEP(N) x[N] = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(src + (N << 5))), K[0]);
+						PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					}
+					for (i = 1; i < nRounds; i++) {
+						__m256i k = K[i];
+#define PRIV_AES_HW_STEP(N) x[N] = _mm256_aesenc_epi128(x[N], k);
+						PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					}
+					{
+						__m256i k = K[nRounds];
+#define PRIV_AES_HW_STEP(N) x[N] = _mm256_aesenclast_epi128(x[N], k);
+						PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					}
+					if (counter) {
+#define PRIV_AES_HW_STEP(N) x[N] = _mm256_xor_si256(x[N], _mm256_loadu_si256((const __m256i*)(src + (N << 5))));
+						PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					}
+#define PRIV_AES_HW_STEP(N) _mm256_storeu_si256((__m256i*)(dst + (N << 5)), x[N]);
+					PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					src += 256;
+					dst += 256;
+				}
+				return n << 4;
+			}
+
+			// 16 blocks in 8 registers of 256 bits
+			TARGET_VAES static sl_size DecryptBlocks_VAES(const sl_uint8* keys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks)
+			{
+				__m256i K[15];
+				sl_uint32 i;
+				for (i = 0; i <= nRounds; i++) {
+					K[i] = _mm256_broadcastsi128_si256(LOAD_BLOCK(keys + (i << 4)));
+				}
+				sl_size n = nBlocks >> 4;
+				for (sl_size iter = 0; iter < n; iter++) {
+					__m256i x[8];
+#define PRIV_AES_HW_STEP(N) x[N] = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(src + (N << 5))), K[0]);
+					PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					for (i = 1; i < nRounds; i++) {
+						__m256i k = K[i];
+#define PRIV_AES_HW_STEP(N) x[N] = _mm256_aesdec_epi128(x[N], k);
+						PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					}
+					{
+						__m256i k = K[nRounds];
+#define PRIV_AES_HW_STEP(N) x[N] = _mm256_aesdeclast_epi128(x[N], k);
+						PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					}
+#define PRIV_AES_HW_STEP(N) _mm256_storeu_si256((__m256i*)(dst + (N << 5)), x[N]);
+					PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					src += 256;
+					dst += 256;
+				}
+				return n << 4;
+			}
+
+			sl_bool IsSupported() noexcept
+			{
+				return Cpu::isSupportedAES() && Cpu::isSupportedSSE42();
+			}
+#else
+			typedef uint8x16_t Block;
+
+#	define LOAD_BLOCK(p) vld1q_u8((const uint8_t*)(p))
+#	define STORE_BLOCK(p, v) vst1q_u8((uint8_t*)(p), (v))
+#	define XOR_BLOCK(a, b) veorq_u8((a), (b))
+
+			static SLIB_INLINE Block GetCounterBlock(Counter& counter)
+			{
+				Block ret = vrev64q_u8(vreinterpretq_u8_u64(vcombine_u64(vcreate_u64(counter.high), vcreate_u64(counter.low))));
+				counter.increase();
+				return ret;
+			}
+
+			// AESE: AddRoundKey, SubBytes, ShiftRows / AESMC: MixColumns
+			static SLIB_INLINE Block EncryptBlock(const Block* K, sl_uint32 nRounds, Block x)
+			{
+				for (sl_uint32 i = 0; i + 1 < nRounds; i++) {
+					x = vaesmcq_u8(vaeseq_u8(x, K[i]));
+				}
+				x = vaeseq_u8(x, K[nRounds - 1]);
+				return veorq_u8(x, K[nRounds]);
+			}
+
+			// AESD: AddRoundKey, InvShiftRows, InvSubBytes / AESIMC: InvMixColumns
+			static SLIB_INLINE Block DecryptBlock(const Block* K, sl_uint32 nRounds, Block x)
+			{
+				for (sl_uint32 i = 0; i + 1 < nRounds; i++) {
+					x = vaesimcq_u8(vaesdq_u8(x, K[i]));
+				}
+				x = vaesdq_u8(x, K[nRounds - 1]);
+				return veorq_u8(x, K[nRounds]);
+			}
+
+			static SLIB_INLINE void EncryptBlocks8(const Block* K, sl_uint32 nRounds, Block* x)
+			{
+				Block k;
+				for (sl_uint32 i = 0; i + 1 < nRounds; i++) {
+					k = K[i];
+#define PRIV_AES_HW_STEP(N) x[N] = vaesmcq_u8(vaeseq_u8(x[N], k));
+					PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+				}
+				k = K[nRounds - 1];
+				Block l = K[nRounds];
+#define PRIV_AES_HW_STEP(N) x[N] = veorq_u8(vaeseq_u8(x[N], k), l);
+				PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+			}
+
+			static SLIB_INLINE void DecryptBlocks8(const Block* K, sl_uint32 nRounds, Block* x)
+			{
+				Block k;
+				for (sl_uint32 i = 0; i + 1 < nRounds; i++) {
+					k = K[i];
+#define PRIV_AES_HW_STEP(N) x[N] = vaesimcq_u8(vaesdq_u8(x[N], k));
+					PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+				}
+				k = K[nRounds - 1];
+				Block l = K[nRounds];
+#define PRIV_AES_HW_STEP(N) x[N] = veorq_u8(vaesdq_u8(x[N], k), l);
+				PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+			}
+
+			static SLIB_INLINE void DecryptBlocks4(const Block* K, sl_uint32 nRounds, Block* x)
+			{
+				Block k;
+				for (sl_uint32 i = 0; i + 1 < nRounds; i++) {
+					k = K[i];
+#define PRIV_AES_HW_STEP(N) x[N] = vaesimcq_u8(vaesdq_u8(x[N], k));
+					PRIV_AES_HW_4(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+				}
+				k = K[nRounds - 1];
+				Block l = K[nRounds];
+#define PRIV_AES_HW_STEP(N) x[N] = veorq_u8(vaesdq_u8(x[N], k), l);
+				PRIV_AES_HW_4(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+			}
+
+			sl_bool IsSupported() noexcept
+			{
+				return sl_true;
+			}
+#endif
+
+			static SLIB_INLINE void LoadRoundKeys(Block* K, const sl_uint8* keys, sl_uint32 nRounds)
+			{
+				for (sl_uint32 i = 0; i <= nRounds; i++) {
+					K[i] = LOAD_BLOCK(keys + (i << 4));
+				}
+			}
+
+			void EncryptBlocks(const sl_uint8* keys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks) noexcept
+			{
+#if defined(SUPPORT_AES_NI)
+				if (nBlocks >= 16 && Cpu::isSupportedVAES()) {
+					sl_size n = EncryptBlocks_VAES(keys, nRounds, src, dst, nBlocks, sl_null);
+					src += n << 4;
+					dst += n << 4;
+					nBlocks -= n;
+				}
+#endif
+				Block K[15];
+				LoadRoundKeys(K, keys, nRounds);
+				while (nBlocks >= 8) {
+					Block x[8];
+#define PRIV_AES_HW_STEP(N) x[N] = LOAD_BLOCK(src + (N << 4));
+					PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					EncryptBlocks8(K, nRounds, x);
+#define PRIV_AES_HW_STEP(N) STORE_BLOCK(dst + (N << 4), x[N]);
+					PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					src += 128;
+					dst += 128;
+					nBlocks -= 8;
+				}
+				while (nBlocks) {
+					STORE_BLOCK(dst, EncryptBlock(K, nRounds, LOAD_BLOCK(src)));
+					src += 16;
+					dst += 16;
+					nBlocks--;
+				}
+			}
+
+			void DecryptBlocks(const sl_uint8* keys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks) noexcept
+			{
+#if defined(SUPPORT_AES_NI)
+				if (nBlocks >= 16 && Cpu::isSupportedVAES()) {
+					sl_size n = DecryptBlocks_VAES(keys, nRounds, src, dst, nBlocks);
+					src += n << 4;
+					dst += n << 4;
+					nBlocks -= n;
+				}
+#endif
+				Block K[15];
+				LoadRoundKeys(K, keys, nRounds);
+				while (nBlocks >= 8) {
+					Block x[8];
+#define PRIV_AES_HW_STEP(N) x[N] = LOAD_BLOCK(src + (N << 4));
+					PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					DecryptBlocks8(K, nRounds, x);
+#define PRIV_AES_HW_STEP(N) STORE_BLOCK(dst + (N << 4), x[N]);
+					PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					src += 128;
+					dst += 128;
+					nBlocks -= 8;
+				}
+				while (nBlocks) {
+					STORE_BLOCK(dst, DecryptBlock(K, nRounds, LOAD_BLOCK(src)));
+					src += 16;
+					dst += 16;
+					nBlocks--;
+				}
+			}
+
+			void EncryptBlocks_CBC(const sl_uint8* keys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks, sl_uint8* _iv) noexcept
+			{
+				Block K[15];
+				LoadRoundKeys(K, keys, nRounds);
+				Block iv = LOAD_BLOCK(_iv);
+				for (sl_size i = 0; i < nBlocks; i++) {
+					iv = EncryptBlock(K, nRounds, XOR_BLOCK(LOAD_BLOCK(src), iv));
+					STORE_BLOCK(dst, iv);
+					src += 16;
+					dst += 16;
+				}
+				STORE_BLOCK(_iv, iv);
+			}
+
+			void DecryptBlocks_CBC(const sl_uint8* keys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks, sl_uint8* _iv) noexcept
+			{
+				Block K[15];
+				LoadRoundKeys(K, keys, nRounds);
+				Block iv = LOAD_BLOCK(_iv);
+				while (nBlocks >= 4) {
+					Block c[4], x[4];
+#define PRIV_AES_HW_STEP(N) x[N] = c[N] = LOAD_BLOCK(src + (N << 4));
+					PRIV_AES_HW_4(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					DecryptBlocks4(K, nRounds, x);
+					STORE_BLOCK(dst, XOR_BLOCK(x[0], iv));
+					STORE_BLOCK(dst + 16, XOR_BLOCK(x[1], c[0]));
+					STORE_BLOCK(dst + 32, XOR_BLOCK(x[2], c[1]));
+					STORE_BLOCK(dst + 48, XOR_BLOCK(x[3], c[2]));
+					iv = c[3];
+					src += 64;
+					dst += 64;
+					nBlocks -= 4;
+				}
+				while (nBlocks) {
+					Block c = LOAD_BLOCK(src);
+					STORE_BLOCK(dst, XOR_BLOCK(DecryptBlock(K, nRounds, c), iv));
+					iv = c;
+					src += 16;
+					dst += 16;
+					nBlocks--;
+				}
+				STORE_BLOCK(_iv, iv);
+			}
+
+			void EncryptBlocks_CTR(const sl_uint8* keys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks, sl_uint8* _counter, sl_uint32 counterSize) noexcept
+			{
+				Counter counter(_counter, counterSize);
+#if defined(SUPPORT_AES_NI)
+				if (nBlocks >= 16 && Cpu::isSupportedVAES()) {
+					sl_size n = EncryptBlocks_VAES(keys, nRounds, src, dst, nBlocks, &counter);
+					src += n << 4;
+					dst += n << 4;
+					nBlocks -= n;
+				}
+#endif
+				Block K[15];
+				LoadRoundKeys(K, keys, nRounds);
+				while (nBlocks >= 8) {
+					Block x[8];
+#define PRIV_AES_HW_STEP(N) x[N] = GetCounterBlock(counter);
+					PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					EncryptBlocks8(K, nRounds, x);
+#define PRIV_AES_HW_STEP(N) STORE_BLOCK(dst + (N << 4), XOR_BLOCK(x[N], LOAD_BLOCK(src + (N << 4))));
+					PRIV_AES_HW_8(PRIV_AES_HW_STEP)
+#undef PRIV_AES_HW_STEP
+					src += 128;
+					dst += 128;
+					nBlocks -= 8;
+				}
+				while (nBlocks) {
+					STORE_BLOCK(dst, XOR_BLOCK(EncryptBlock(K, nRounds, GetCounterBlock(counter)), LOAD_BLOCK(src)));
+					src += 16;
+					dst += 16;
+					nBlocks--;
+				}
+				counter.save(_counter);
+			}
+#else
+			sl_bool IsSupported() noexcept
+			{
+				return sl_false;
+			}
+
+			void EncryptBlocks(const sl_uint8* keys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks) noexcept
+			{
+			}
+
+			void DecryptBlocks(const sl_uint8* keys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks) noexcept
+			{
+			}
+
+			void EncryptBlocks_CBC(const sl_uint8* keys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks, sl_uint8* iv) noexcept
+			{
+			}
+
+			void DecryptBlocks_CBC(const sl_uint8* keys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks, sl_uint8* iv) noexcept
+			{
+			}
+
+			void EncryptBlocks_CTR(const sl_uint8* keys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks, sl_uint8* counter, sl_uint32 counterSize) noexcept
+			{
+			}
+#endif
+
+#if defined(SUPPORT_AES_NI)
+			/*
+				Carry-less multiplication in GF(2^128), on the byte-reflected blocks
+				Intel, "Intel Carry-Less Multiplication Instruction and its Usage for Computing the GCM Mode"
+			*/
+
+			static SLIB_INLINE __m128i ReverseBytes(__m128i x)
+			{
+				return _mm_shuffle_epi8(x, _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+			}
+
+			static SLIB_INLINE void MultiplyAccumulate(__m128i a, __m128i b, __m128i& lo, __m128i& mid, __m128i& hi)
+			{
+				lo = _mm_xor_si128(lo, _mm_clmulepi64_si128(a, b, 0x00));
+				hi = _mm_xor_si128(hi, _mm_clmulepi64_si128(a, b, 0x11));
+				mid = _mm_xor_si128(mid, _mm_clmulepi64_si128(a, b, 0x10));
+				mid = _mm_xor_si128(mid, _mm_clmulepi64_si128(a, b, 0x01));
+			}
+
+			static SLIB_INLINE __m128i Reduce(__m128i lo, __m128i mid, __m128i hi)
+			{
+				lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+				hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+				// shift left the 256-bit product by 1 bit
+				__m128i t1 = _mm_srli_epi32(lo, 31);
+				__m128i t2 = _mm_srli_epi32(hi, 31);
+				lo = _mm_slli_epi32(lo, 1);
+				hi = _mm_slli_epi32(hi, 1);
+				__m128i t3 = _mm_srli_si128(t1, 12);
+				t2 = _mm_slli_si128(t2, 4);
+				t1 = _mm_slli_si128(t1, 4);
+				lo = _mm_or_si128(lo, t1);
+				hi = _mm_or_si128(hi, t2);
+				hi = _mm_or_si128(hi, t3);
+				// reduce modulo x^128 + x^7 + x^2 + x + 1
+				t1 = _mm_slli_epi32(lo, 31);
+				t2 = _mm_slli_epi32(lo, 30);
+				t3 = _mm_slli_epi32(lo, 25);
+				t1 = _mm_xor_si128(t1, t2);
+				t1 = _mm_xor_si128(t1, t3);
+				t2 = _mm_srli_si128(t1, 4);
+				t1 = _mm_slli_si128(t1, 12);
+				lo = _mm_xor_si128(lo, t1);
+				t1 = _mm_srli_epi32(lo, 1);
+				t3 = _mm_srli_epi32(lo, 2);
+				t1 = _mm_xor_si128(t1, t3);
+				t3 = _mm_srli_epi32(lo, 7);
+				t1 = _mm_xor_si128(t1, t3);
+				t1 = _mm_xor_si128(t1, t2);
+				lo = _mm_xor_si128(lo, t1);
+				return _mm_xor_si128(hi, lo);
+			}
+
+			static SLIB_INLINE __m128i Multiply(__m128i a, __m128i b)
+			{
+				__m128i lo = _mm_setzero_si128();
+				__m128i mid = _mm_setzero_si128();
+				__m128i hi = _mm_setzero_si128();
+				MultiplyAccumulate(a, b, lo, mid, hi);
+				return Reduce(lo, mid, hi);
+			}
+
+			sl_bool IsSupportedGHash() noexcept
+			{
+				return Cpu::isSupportedPCLMUL() && Cpu::isSupportedSSE42();
+			}
+
+			void GHash_GenerateTable(const sl_uint8* _H, sl_uint8* table) noexcept
+			{
+				__m128i H = ReverseBytes(LOAD_BLOCK(_H));
+				__m128i P = H;
+				STORE_BLOCK(table, P);
+				for (sl_uint32 i = 1; i < 8; i++) {
+					P = Multiply(P, H);
+					STORE_BLOCK(table + (i << 4), P);
+				}
+			}
+
+			void GHash_MultiplyH(const sl_uint8* table, const sl_uint8* X, sl_uint8* O) noexcept
+			{
+				STORE_BLOCK(O, ReverseBytes(Multiply(ReverseBytes(LOAD_BLOCK(X)), LOAD_BLOCK(table))));
+			}
+
+			// X = (X + D1) * H^8 + D2 * H^7 + ... + D8 * H, with one reduction for 8 blocks
+			void GHash_MultiplyData(const sl_uint8* table, sl_uint8* _X, const sl_uint8* data, sl_size nBlocks) noexcept
+			{
+				__m128i H[8];
+				for (sl_uint32 i = 0; i < 8; i++) {
+					H[i] = LOAD_BLOCK(table + (i << 4));
+				}
+				__m128i X = ReverseBytes(LOAD_BLOCK(_X));
+				while (nBlocks >= 8) {
+					__m128i lo = _mm_setzero_si128();
+					__m128i mid = _mm_setzero_si128();
+					__m128i hi = _mm_setzero_si128();
+					MultiplyAccumulate(_mm_xor_si128(X, ReverseBytes(LOAD_BLOCK(data))), H[7], lo, mid, hi);
+#define PRIV_AES_HW_STEP(N) MultiplyAccumulate(ReverseBytes(LOAD_BLOCK(data + ((N + 1) << 4))), H[6 - N], lo, mid, hi);
+					PRIV_AES_HW_4(PRIV_AES_HW_STEP)
+					PRIV_AES_HW_STEP(4)
+					PRIV_AES_HW_STEP(5)
+					PRIV_AES_HW_STEP(6)
+#undef PRIV_AES_HW_STEP
+					X = Reduce(lo, mid, hi);
+					data += 128;
+					nBlocks -= 8;
+				}
+				while (nBlocks) {
+					X = Multiply(_mm_xor_si128(X, ReverseBytes(LOAD_BLOCK(data))), H[0]);
+					data += 16;
+					nBlocks--;
+				}
+				STORE_BLOCK(_X, ReverseBytes(X));
+			}
+#else
+			sl_bool IsSupportedGHash() noexcept
+			{
+				return sl_false;
+			}
+
+			void GHash_GenerateTable(const sl_uint8* H, sl_uint8* table) noexcept
+			{
+			}
+
+			void GHash_MultiplyH(const sl_uint8* table, const sl_uint8* X, sl_uint8* O) noexcept
+			{
+			}
+
+			void GHash_MultiplyData(const sl_uint8* table, sl_uint8* X, const sl_uint8* data, sl_size nBlocks) noexcept
+			{
+			}
+#endif
+
+		}
+	}
+
+}
@@ -0,0 +1,70 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CRYPTO_AES_HW
+#define CHECKHEADER_SLIB_CRYPTO_AES_HW
+
+#include "slib/crypto/definition.h"
+
+/*
+	Hardware-accelerated kernels of AES and GHASH (AES-NI, VAES, PCLMULQDQ, ARMv8 Crypto Extension)
+
+	Round keys are stored in the byte order of the state, (nRounds + 1) * 16 bytes.
+	Decryption round keys are the keys of the equivalent inverse cipher (FIPS-197 5.3.5).
+*/
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace aes_hw
+		{
+
+			sl_bool IsSupported() noexcept;
+
+			sl_bool IsSupportedGHash() noexcept;
+
+			void EncryptBlocks(const sl_uint8* roundKeys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks) noexcept;
+
+			void DecryptBlocks(const sl_uint8* roundKeys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks) noexcept;
+
+			void EncryptBlocks_CBC(const sl_uint8* roundKeys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks, sl_uint8* iv /* inout */) noexcept;
+
+			void DecryptBlocks_CBC(const sl_uint8* roundKeys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks, sl_uint8* iv /* inout */) noexcept;
+
+			// counterSize: 16 (128-bit counter), 4 (32-bit counter of GCM)
+			void EncryptBlocks_CTR(const sl_uint8* roundKeys, sl_uint32 nRounds, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks, sl_uint8* counter /* inout */, sl_uint32 counterSize) noexcept;
+
+			// table: H^1 ~ H^8, 128 bytes
+			void GHash_GenerateTable(const sl_uint8* H, sl_uint8* table) noexcept;
+
+			void GHash_MultiplyH(const sl_uint8* table, const sl_uint8* X, sl_uint8* O) noexcept;
+
+			void GHash_MultiplyData(const sl_uint8* table, sl_uint8* X /* inout */, const sl_uint8* data, sl_size nBlocks) noexcept;
+
+		}
+	}
+
+}
+
+#endif
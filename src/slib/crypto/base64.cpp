@@ -24,6 +24,8 @@
 
 #include "slib/core/memory.h"
 
+#include "base64_simd.h"
+
 #define BASE64_CHARS "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"
 #define BASE64_CHARS_URL "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
 
@@ -35,56 +37,74 @@ namespace slib
 		namespace base64
 		{
 			
+			static sl_size EncodeSIMD(sl_char8* output, const sl_uint8* input, sl_size size, const char* patterns)
+			{
+				return base64_simd::Encode(output, input, size, patterns[62] == '-');
+			}
+
 			template <class CHAR>
-			static typename StringTypeFromCharType<CHAR>::Type Encode(const char* patterns, const void* buf, sl_size size, CHAR padding)
+			static sl_size EncodeSIMD(CHAR* output, const sl_uint8* input, sl_size size, const char* patterns)
+			{
+				return 0;
+			}
+
+			template <class CHAR>
+			static sl_size Encode(CHAR* output, const char* patterns, const void* buf, sl_size size, CHAR padding)
 			{
-				typedef typename StringTypeFromCharType<CHAR>::Type STRING;
-				if (!size) {
-					return sl_null;
-				}
 				const sl_uint8* input = (const sl_uint8*)buf;
-				sl_uint32 last = (sl_uint32)(size % 3);
-				sl_size countBlock = (size / 3) + (last ? 1 : 0);
-				STRING ret = STRING::allocate(countBlock << 2);
-				if (ret.isEmpty()) {
-					return ret;
-				}
-				CHAR* _output = ret.getData();
-				CHAR* output = _output;
-				sl_uint32 n = 0;
-				for (sl_size iBlock = 0; iBlock < countBlock; iBlock++) {
+				CHAR* start = output;
+				sl_size n = EncodeSIMD(output, input, size, patterns);
+				input += n;
+				output += (n / 3) << 2;
+				size -= n;
+				while (size >= 3) {
 					sl_uint8 n0 = input[0];
-					sl_uint8 n1 = (n + 1 < size) ? input[1] : 0;
-					sl_uint8 n2 = (n + 2 < size) ? input[2] : 0;
+					sl_uint8 n1 = input[1];
+					sl_uint8 n2 = input[2];
 					output[0] = patterns[n0 >> 2];
 					output[1] = patterns[((n0 & 0x03) << 4) + ((n1 & 0xF0) >> 4)];
 					output[2] = patterns[((n1 & 0x0F) << 2) + ((n2 & 0xC0) >> 6)];
 					output[3] = patterns[n2 & 0x3F];
 					input += 3;
-					n += 3;
+					size -= 3;
 					output += 4;
 				}
-				if (padding) {
-					if (last == 1) {
-						*(output - 2) = padding;
-					}
-					if (last >= 1) {
-						*(output - 1) = padding;
+				if (size) {
+					sl_uint8 n0 = input[0];
+					sl_uint8 n1 = size > 1 ? input[1] : 0;
+					output[0] = patterns[n0 >> 2];
+					output[1] = patterns[((n0 & 0x03) << 4) + ((n1 & 0xF0) >> 4)];
+					if (size > 1) {
+						output[2] = patterns[(n1 & 0x0F) << 2];
+						output += 3;
+					} else {
+						output += 2;
 					}
-				} else {
-					if (last == 1) {
-						sl_size nLen = (countBlock << 2) - 2;
-						_output[nLen] = 0;
-						ret.setLength(nLen);
-					} else if (last > 1) {
-						sl_size nLen = (countBlock << 2) - 1;
-						_output[nLen] = 0;
-						ret.setLength(nLen);
+					if (padding) {
+						if (size == 1) {
+							*(output++) = padding;
+						}
+						*(output++) = padding;
 					}
 				}
+				return output - start;
+			}
+
+			template <class CHAR>
+			static typename StringTypeFromCharType<CHAR>::Type Encode(const char* patterns, const void* buf, sl_size size, CHAR padding)
+			{
+				typedef typename StringTypeFromCharType<CHAR>::Type STRING;
+				if (!size) {
+					return sl_null;
+				}
+				STRING ret = STRING::allocate(Base64::getEncodeOutputSize(size, padding != 0));
+				if (ret.isEmpty()) {
+					return ret;
+				}
+				Encode(ret.getData(), patterns, buf, size, padding);
 				return ret;
 			}
-			
+
 			static sl_uint32 GetIndex(sl_uint32 c)
 			{
 				if (c >= 'A' && c <= 'Z') {
@@ -111,6 +131,17 @@ namespace slib
 				return 64;
 			}
 			
+			static sl_size DecodeSIMD(sl_uint8* output, const sl_char8* input, sl_size len)
+			{
+				return base64_simd::Decode(output, input, len);
+			}
+
+			template <class CHAR>
+			static sl_size DecodeSIMD(sl_uint8* output, const CHAR* input, sl_size len)
+			{
+				return 0;
+			}
+
 			template <class CHAR>
 			static sl_size Decode(const CHAR* input, sl_size len, void* buf, CHAR padding)
 			{
@@ -129,7 +160,18 @@ namespace slib
 				sl_size indexInput = 0;
 				sl_size indexOutput = 0;
 				sl_uint32 posInBlock = 0;
+				sl_size indexResumeSIMD = 0;
 				while (indexInput < len) {
+					if (!posInBlock && indexInput >= indexResumeSIMD) {
+						sl_size n = DecodeSIMD(output + indexOutput, input + indexInput, len - indexInput);
+						indexInput += n;
+						indexOutput += (n >> 2) * 3;
+						// The vector codec stopped at a block with whitespace, padding or an invalid character
+						indexResumeSIMD = indexInput + 64;
+						if (indexInput >= len) {
+							break;
+						}
+					}
 					CHAR ch = input[indexInput];
 					if (SLIB_CHAR_IS_WHITE_SPACE(ch) || ch == padding) {
 						indexInput++;
@@ -260,6 +302,30 @@ namespace slib
 		return Encode(BASE64_CHARS_URL, str.getData(), str.getLength(), padding);
 	}
 	
+	sl_size Base64::encode(sl_char8* output, const void* buf, sl_size size, sl_char8 padding)
+	{
+		return Encode(output, BASE64_CHARS, buf, size, padding);
+	}
+
+	sl_size Base64::encodeUrl(sl_char8* output, const void* buf, sl_size size, sl_char8 padding)
+	{
+		return Encode(output, BASE64_CHARS_URL, buf, size, padding);
+	}
+
+	sl_size Base64::getEncodeOutputSize(sl_size size, sl_bool flagPadding)
+	{
+		sl_size len = (size / 3) << 2;
+		sl_uint32 last = (sl_uint32)(size % 3);
+		if (last) {
+			if (flagPadding) {
+				len += 4;
+			} else {
+				len += last + 1;
+			}
+		}
+		return len;
+	}
+
 	sl_size Base64::getDecodeOutputSize(sl_size len)
 	{
 		sl_size size = (len >> 2) * 3;
@@ -285,6 +351,11 @@ namespace slib
 		}
 	}
 
+	sl_size Base64::decode(const sl_char8* base64, sl_size len, void* output, sl_char8 padding)
+	{
+		return Decode(base64, len, output, padding);
+	}
+
 	Memory Base64::decode(const StringParam& _str, sl_char32 padding)
 	{
 		if (_str.is8BitsStringType()) {
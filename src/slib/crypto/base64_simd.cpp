@@ -0,0 +1,333 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "base64_simd.h"
+
+#include "slib/core/cpu.h"
+
+#if !defined(SLIB_PLATFORM_IS_MOBILE) && defined(SLIB_ARCH_IS_X64)
+#	define SUPPORT_AVX2
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#		define TARGET_AVX2
+#		define TARGET_VBMI
+#	else
+#		include <immintrin.h>
+#		define TARGET_AVX2 __attribute__((target("avx2")))
+#		define TARGET_VBMI __attribute__((target("avx2,avx512f,avx512bw,avx512vbmi")))
+#	endif
+#elif defined(SLIB_ARCH_IS_ARM64)
+#	define SUPPORT_NEON
+#	include <arm_neon.h>
+#endif
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace base64_simd
+		{
+
+			SLIB_ALIGN(64) static const char g_encodeTable[64] = {
+				'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+				'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+				'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+				'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
+			};
+
+			SLIB_ALIGN(64) static const char g_encodeTableUrl[64] = {
+				'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+				'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+				'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+				'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '-', '_'
+			};
+
+			// Sextet values of ASCII characters (both alphabets), 0xFF: invalid
+			SLIB_ALIGN(64) static const sl_uint8 g_decodeTable[128] = {
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0x3E, 0xFF, 0x3F,
+				0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+				0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F,
+				0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+				0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+			};
+
+#if defined(SUPPORT_AVX2)
+			// Spreads each 3 bytes (a, b, c) into a 32-bit lane as (b, a, c, b)
+			SLIB_ALIGN(64) static const sl_uint8 g_encodeShuffleVBMI[64] = {
+				1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 13, 12, 14, 13, 16, 15, 17, 16, 19, 18, 20, 19, 22, 21, 23, 22,
+				25, 24, 26, 25, 28, 27, 29, 28, 31, 30, 32, 31, 34, 33, 35, 34, 37, 36, 38, 37, 40, 39, 41, 40, 43, 42, 44, 43, 46, 45, 47, 46
+			};
+
+			// Gathers the 3 bytes of each 32-bit lane in big-endian order
+			SLIB_ALIGN(64) static const sl_uint8 g_decodePackVBMI[64] = {
+				2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, 18, 17, 16, 22, 21, 20, 26, 25, 24, 30, 29, 28, 34, 33, 32, 38, 37, 36, 42, 41,
+				40, 46, 45, 44, 50, 49, 48, 54, 53, 52, 58, 57, 56, 62, 61, 60, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+			};
+
+			TARGET_VBMI static sl_size Encode_VBMI(sl_char8*& output, const sl_uint8* input, sl_size size, const char* table) noexcept
+			{
+				const __m512i lookup = _mm512_load_si512((const __m512i*)table);
+				const __m512i shuffle = _mm512_load_si512((const __m512i*)g_encodeShuffleVBMI);
+				const __m512i shifts = _mm512_set1_epi64(0x3036242a1016040aLL);
+				sl_size n = 0;
+				while (size - n >= 48) {
+					__m512i v = _mm512_maskz_loadu_epi8((__mmask64)0xFFFFFFFFFFFFULL, input + n);
+					v = _mm512_permutexvar_epi8(shuffle, v);
+					v = _mm512_multishift_epi64_epi8(shifts, v);
+					v = _mm512_permutexvar_epi8(v, lookup);
+					_mm512_storeu_si512((__m512i*)output, v);
+					output += 64;
+					n += 48;
+				}
+				return n;
+			}
+
+			TARGET_VBMI static sl_size Decode_VBMI(sl_uint8*& output, const sl_char8* input, sl_size len) noexcept
+			{
+				const __m512i lookupLow = _mm512_load_si512((const __m512i*)g_decodeTable);
+				const __m512i lookupHigh = _mm512_load_si512((const __m512i*)(g_decodeTable + 64));
+				const __m512i pack = _mm512_load_si512((const __m512i*)g_decodePackVBMI);
+				const __m512i merge1 = _mm512_set1_epi32(0x01400140);
+				const __m512i merge2 = _mm512_set1_epi32(0x00011000);
+				sl_size n = 0;
+				while (len - n >= 64) {
+					__m512i c = _mm512_loadu_si512((const __m512i*)(input + n));
+					__m512i v = _mm512_permutex2var_epi8(lookupLow, c, lookupHigh);
+					// Non-ASCII characters and invalid entries have the sign bit
+					if (_mm512_movepi8_mask(_mm512_or_si512(v, c))) {
+						break;
+					}
+					v = _mm512_maddubs_epi16(v, merge1);
+					v = _mm512_madd_epi16(v, merge2);
+					v = _mm512_permutexvar_epi8(pack, v);
+					_mm512_mask_storeu_epi8(output, (__mmask64)0xFFFFFFFFFFFFULL, v);
+					output += 48;
+					n += 64;
+				}
+				return n;
+			}
+
+			TARGET_AVX2 static sl_size Encode_AVX2(sl_char8*& output, const sl_uint8* input, sl_size size, sl_bool flagUrl) noexcept
+			{
+				const __m256i shuffle = _mm256_setr_epi8(
+					1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+					1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+				// Offsets from the sextets to ASCII, indexed by the class computed below
+				const __m256i offsets = flagUrl ?
+					_mm256_setr_epi8(
+						'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0,
+						'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0) :
+					_mm256_setr_epi8(
+						'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+						'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+				const __m256i mask1 = _mm256_set1_epi32(0x0fc0fc00);
+				const __m256i mul1 = _mm256_set1_epi32(0x04000040);
+				const __m256i mask2 = _mm256_set1_epi32(0x003f03f0);
+				const __m256i mul2 = _mm256_set1_epi32(0x01000010);
+				sl_size n = 0;
+				// The second lane reads 16 bytes from offset 12
+				while (size - n >= 28) {
+					__m128i lo = _mm_loadu_si128((const __m128i*)(input + n));
+					__m128i hi = _mm_loadu_si128((const __m128i*)(input + n + 12));
+					__m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+					v = _mm256_shuffle_epi8(v, shuffle);
+					__m256i t1 = _mm256_mulhi_epu16(_mm256_and_si256(v, mask1), mul1);
+					__m256i t2 = _mm256_mullo_epi16(_mm256_and_si256(v, mask2), mul2);
+					__m256i indices = _mm256_or_si256(t1, t2);
+					// 0-25: 13, 26-51: 0, 52-61: 1-10, 62: 11, 63: 12
+					__m256i classes = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+					__m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+					classes = _mm256_or_si256(classes, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+					v = _mm256_add_epi8(_mm256_shuffle_epi8(offsets, classes), indices);
+					_mm256_storeu_si256((__m256i*)output, v);
+					output += 32;
+					n += 24;
+				}
+				return n;
+			}
+
+			TARGET_AVX2 static sl_size Decode_AVX2(sl_uint8*& output, const sl_char8* input, sl_size len) noexcept
+			{
+				// A character is valid when (classesInvalidByLow[low nibble] & classByHigh[high nibble]) is zero
+				const __m256i classesInvalidByLow = _mm256_setr_epi8(
+					0x25, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x23, 0x3A, 0x3B, 0x3A, 0x3B, 0x32,
+					0x25, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x23, 0x3A, 0x3B, 0x3A, 0x3B, 0x32);
+				const __m256i classByHigh = _mm256_setr_epi8(
+					0x20, 0x20, 0x01, 0x02, 0x04, 0x08, 0x04, 0x10, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+					0x20, 0x20, 0x01, 0x02, 0x04, 0x08, 0x04, 0x10, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20);
+				// Offsets from the characters to the sextets: by the high nibble, and by the low nibble for `+`, `-`, `/`
+				const __m256i shiftByHigh = _mm256_setr_epi8(
+					0, 0, 0, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+					0, 0, 0, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+				const __m256i shiftSymbols = _mm256_setr_epi8(
+					0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 19, 0, 17, 0, 16,
+					0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 19, 0, 17, 0, 16);
+				const __m256i mask = _mm256_set1_epi8(0x0f);
+				const __m256i merge1 = _mm256_set1_epi32(0x01400140);
+				const __m256i merge2 = _mm256_set1_epi32(0x00011000);
+				const __m256i pack = _mm256_setr_epi8(
+					2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+					2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+				const __m256i packLanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+				sl_size n = 0;
+				while (len - n >= 32) {
+					__m256i c = _mm256_loadu_si256((const __m256i*)(input + n));
+					__m256i hi = _mm256_and_si256(_mm256_srli_epi32(c, 4), mask);
+					__m256i lo = _mm256_and_si256(c, mask);
+					if (!(_mm256_testz_si256(_mm256_shuffle_epi8(classesInvalidByLow, lo), _mm256_shuffle_epi8(classByHigh, hi)))) {
+						break;
+					}
+					__m256i shift = _mm256_blendv_epi8(_mm256_shuffle_epi8(shiftByHigh, hi), _mm256_shuffle_epi8(shiftSymbols, lo), _mm256_cmpeq_epi8(hi, _mm256_set1_epi8(2)));
+					// `_`: -32 instead of -65
+					shift = _mm256_add_epi8(shift, _mm256_and_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('_')), _mm256_set1_epi8(33)));
+					__m256i v = _mm256_add_epi8(c, shift);
+					v = _mm256_maddubs_epi16(v, merge1);
+					v = _mm256_madd_epi16(v, merge2);
+					v = _mm256_shuffle_epi8(v, pack);
+					v = _mm256_permutevar8x32_epi32(v, packLanes);
+					_mm_storeu_si128((__m128i*)output, _mm256_castsi256_si128(v));
+					_mm_storel_epi64((__m128i*)(output + 16), _mm256_extracti128_si256(v, 1));
+					output += 24;
+					n += 32;
+				}
+				return n;
+			}
+#endif
+
+#if defined(SUPPORT_NEON)
+			static uint8x16x4_t LoadTable(const sl_uint8* table) noexcept
+			{
+				uint8x16x4_t ret;
+				ret.val[0] = vld1q_u8(table);
+				ret.val[1] = vld1q_u8(table + 16);
+				ret.val[2] = vld1q_u8(table + 32);
+				ret.val[3] = vld1q_u8(table + 48);
+				return ret;
+			}
+
+			static sl_size Encode_NEON(sl_char8*& output, const sl_uint8* input, sl_size size, const char* table) noexcept
+			{
+				const uint8x16x4_t lookup = LoadTable((const sl_uint8*)table);
+				const uint8x16_t mask = vdupq_n_u8(0x3f);
+				sl_size n = 0;
+				while (size - n >= 48) {
+					uint8x16x3_t v = vld3q_u8(input + n);
+					uint8x16x4_t r;
+					r.val[0] = vshrq_n_u8(v.val[0], 2);
+					r.val[1] = vandq_u8(vorrq_u8(vshrq_n_u8(v.val[1], 4), vshlq_n_u8(v.val[0], 4)), mask);
+					r.val[2] = vandq_u8(vorrq_u8(vshrq_n_u8(v.val[2], 6), vshlq_n_u8(v.val[1], 2)), mask);
+					r.val[3] = vandq_u8(v.val[2], mask);
+					r.val[0] = vqtbl4q_u8(lookup, r.val[0]);
+					r.val[1] = vqtbl4q_u8(lookup, r.val[1]);
+					r.val[2] = vqtbl4q_u8(lookup, r.val[2]);
+					r.val[3] = vqtbl4q_u8(lookup, r.val[3]);
+					vst4q_u8((sl_uint8*)output, r);
+					output += 64;
+					n += 48;
+				}
+				return n;
+			}
+
+			static uint8x16_t DecodeLookup(const uint8x16x4_t& low, const uint8x16x4_t& high, uint8x16_t c) noexcept
+			{
+				// Out-of-range indices give 0 in `vqtbl4q_u8` and keep the value in `vqtbx4q_u8`
+				return vqtbx4q_u8(vqtbl4q_u8(low, c), high, vsubq_u8(c, vdupq_n_u8(64)));
+			}
+
+			static sl_size Decode_NEON(sl_uint8*& output, const sl_char8* input, sl_size len) noexcept
+			{
+				const uint8x16x4_t low = LoadTable(g_decodeTable);
+				const uint8x16x4_t high = LoadTable(g_decodeTable + 64);
+				sl_size n = 0;
+				while (len - n >= 64) {
+					uint8x16x4_t c = vld4q_u8((const sl_uint8*)(input + n));
+					uint8x16_t v0 = DecodeLookup(low, high, c.val[0]);
+					uint8x16_t v1 = DecodeLookup(low, high, c.val[1]);
+					uint8x16_t v2 = DecodeLookup(low, high, c.val[2]);
+					uint8x16_t v3 = DecodeLookup(low, high, c.val[3]);
+					// Non-ASCII characters and invalid entries have the sign bit
+					uint8x16_t check = vorrq_u8(vorrq_u8(vorrq_u8(v0, v1), vorrq_u8(v2, v3)), vorrq_u8(vorrq_u8(c.val[0], c.val[1]), vorrq_u8(c.val[2], c.val[3])));
+					if (vmaxvq_u8(check) & 0x80) {
+						break;
+					}
+					uint8x16x3_t r;
+					r.val[0] = vorrq_u8(vshlq_n_u8(v0, 2), vshrq_n_u8(v1, 4));
+					r.val[1] = vorrq_u8(vshlq_n_u8(v1, 4), vshrq_n_u8(v2, 2));
+					r.val[2] = vorrq_u8(vshlq_n_u8(v2, 6), v3);
+					vst3q_u8(output, r);
+					output += 48;
+					n += 64;
+				}
+				return n;
+			}
+#endif
+
+			sl_size Encode(sl_char8* output, const sl_uint8* input, sl_size size, sl_bool flagUrl) noexcept
+			{
+				sl_size n = 0;
+#if defined(SUPPORT_AVX2)
+				if (size < 28) {
+					return 0;
+				}
+				if (size >= 48 && Cpu::isSupportedAVX512VBMI()) {
+					n = Encode_VBMI(output, input, size, flagUrl ? g_encodeTableUrl : g_encodeTable);
+				}
+				if (Cpu::isSupportedAVX2()) {
+					n += Encode_AVX2(output, input + n, size - n, flagUrl);
+				}
+#elif defined(SUPPORT_NEON)
+				n = Encode_NEON(output, input, size, flagUrl ? g_encodeTableUrl : g_encodeTable);
+#endif
+				return n;
+			}
+
+			sl_size Decode(sl_uint8* output, const sl_char8* input, sl_size len) noexcept
+			{
+				sl_size n = 0;
+#if defined(SUPPORT_AVX2)
+				if (len < 32) {
+					return 0;
+				}
+				if (len >= 64 && Cpu::isSupportedAVX512VBMI()) {
+					n = Decode_VBMI(output, input, len);
+					if (len - n >= 64) {
+						// Stopped at an invalid block
+						return n;
+					}
+				}
+				if (Cpu::isSupportedAVX2()) {
+					n += Decode_AVX2(output, input + n, len - n);
+				}
+#elif defined(SUPPORT_NEON)
+				n = Decode_NEON(output, input, len);
+#endif
+				return n;
+			}
+
+		}
+	}
+
+}
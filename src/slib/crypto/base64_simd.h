@@ -0,0 +1,55 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CRYPTO_BASE64_SIMD
+#define CHECKHEADER_SLIB_CRYPTO_BASE64_SIMD
+
+#include "slib/crypto/definition.h"
+
+/*
+	Vectorized Base64 codecs (AVX-512 VBMI, AVX2, NEON)
+
+	The kernels process whole blocks only and leave the tail, padding and whitespace to the scalar codec.
+	Decoding accepts both the standard (`+/`) and the URL-safe (`-_`) alphabets, like the scalar codec.
+*/
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace base64_simd
+		{
+
+			// Returns the number of encoded input bytes (multiple of 3). `output` receives (return / 3 * 4) characters.
+			sl_size Encode(sl_char8* output, const sl_uint8* input, sl_size size, sl_bool flagUrl) noexcept;
+
+			// Stops at the first block containing a character outside of the alphabets.
+			// Returns the number of decoded characters (multiple of 4). `output` receives (return / 4 * 3) bytes.
+			sl_size Decode(sl_uint8* output, const sl_char8* input, sl_size len) noexcept;
+
+		}
+	}
+
+}
+
+#endif
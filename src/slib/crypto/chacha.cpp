@@ -35,11 +35,19 @@
 #include "slib/core/math.h"
 #include "slib/crypto/pbkdf.h"
 
+#include "chacha_simd.h"
+
 namespace slib
 {
 
 #define ROUNDS 20
 
+// maximum number of blocks per call of the multi-block kernel
+#define PARALLEL_BLOCKS 16
+
+// ChaCha20_Poly1305 encrypts and authenticates the data in chunks of this size, while the output stays in L1 cache
+#define FUSED_CHUNK_SIZE 4096
+
 #define ROTATE(v, c) (((v) << (c)) | ((v) >> (32 - (c))))
 
 #define U8TO32_LITTLE(A, B, C, D) ((((sl_uint32)(sl_uint8)(A))) | (((sl_uint32)(sl_uint8)(B))<<8) | (((sl_uint32)(sl_uint8)(C))<<16) | (((sl_uint32)(sl_uint8)(D))<<24))
@@ -154,6 +162,25 @@ namespace slib
 				INNER_BLOCK(state)
 				SERIALIZE_OUTPUT(output, state, constants, key, nonce, ^ *(data++))
 			}
+
+			// nonces: 4 words per block
+			// src: null to output the key stream
+			static void EncryptBlocks(const sl_uint32* key, sl_uint32 indexConstants, const sl_uint32* nonces, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks) noexcept
+			{
+				const sl_uint32* constants = g_constants + (indexConstants << 2);
+				sl_uint32 input[12];
+				Base::copyMemory(input, constants, 16);
+				Base::copyMemory(input + 4, key, 32);
+				sl_size i = priv::chacha_simd::EncryptBlocks(input, nonces, src, dst, nBlocks);
+				for (; i < nBlocks; i++) {
+					const sl_uint32* nonce = nonces + (i << 2);
+					if (src) {
+						Salsa20WordToByte(src + (i << 6), dst + (i << 6), key, indexConstants, nonce[0], nonce[1], nonce[2], nonce[3]);
+					} else {
+						Salsa20WordToByte(dst + (i << 6), key, indexConstants, nonce[0], nonce[1], nonce[2], nonce[3]);
+					}
+				}
+			}
 			
 		}
 	}
@@ -210,37 +237,49 @@ namespace slib
 		if (!size) {
 			return;
 		}
-		sl_uint8* src = (sl_uint8*)_src;
+		const sl_uint8* src = (const sl_uint8*)_src;
 		sl_uint8* dst = (sl_uint8*)_dst;
 		sl_uint64 block = offset >> 6;
-		sl_uint64 offsetEnd = (sl_uint64)(offset + size);
-		sl_uint64 blockEnd = offsetEnd >> 6;
-		sl_bool flagFirstBlock = sl_true;
-		char h[64];
-		for (; block <= blockEnd; block++) {
+		sl_uint8 h[64];
+		sl_uint32 pos = (sl_uint32)(offset & 63);
+		if (pos) {
 			generateBlock(iv[0], iv[1], iv[2] ^ ((sl_uint32)(block >> 32)), iv[3] ^ ((sl_uint32)block), h);
-			sl_uint32 n;
-			if (block == blockEnd) {
-				n = (sl_uint32)(offsetEnd & 63);
+			sl_uint32 n = 64 - pos;
+			if (n > size) {
+				n = (sl_uint32)size;
 			}
-			else {
-				n = 64;
-			}
-			if (flagFirstBlock) {
-				flagFirstBlock = sl_false;
-				sl_uint32 s = offset & 63;
-				n -= s;
-				for (sl_uint32 i = 0; i < n; i++) {
-					dst[i] = src[i] ^ h[s + i];
-				}
-			}
-			else {
-				for (sl_uint32 i = 0; i < n; i++) {
-					dst[i] = src[i] ^ h[i];
-				}
+			for (sl_uint32 i = 0; i < n; i++) {
+				dst[i] = src[i] ^ h[pos + i];
 			}
 			src += n;
 			dst += n;
+			size -= n;
+			block++;
+		}
+		sl_size nBlocks = size >> 6;
+		while (nBlocks) {
+			sl_uint32 n = nBlocks > PARALLEL_BLOCKS ? PARALLEL_BLOCKS : (sl_uint32)nBlocks;
+			sl_uint32 nonces[PARALLEL_BLOCKS << 2];
+			for (sl_uint32 i = 0; i < n; i++) {
+				sl_uint64 b = block + i;
+				sl_uint32* nonce = nonces + (i << 2);
+				nonce[0] = iv[0];
+				nonce[1] = iv[1];
+				nonce[2] = iv[2] ^ ((sl_uint32)(b >> 32));
+				nonce[3] = iv[3] ^ ((sl_uint32)b);
+			}
+			EncryptBlocks(key, m_indexConstants, nonces, src, dst, n);
+			block += n;
+			src += n << 6;
+			dst += n << 6;
+			nBlocks -= n;
+		}
+		sl_uint32 n = (sl_uint32)(size & 63);
+		if (n) {
+			generateBlock(iv[0], iv[1], iv[2] ^ ((sl_uint32)(block >> 32)), iv[3] ^ ((sl_uint32)block), h);
+			for (sl_uint32 i = 0; i < n; i++) {
+				dst[i] = src[i] ^ h[i];
+			}
 		}
 	}
 
@@ -300,15 +339,45 @@ namespace slib
 		sl_uint8* dst = (sl_uint8*)_dst;
 		sl_uint8* y = m_output;
 		sl_uint32 pos = m_pos;
-		for (sl_size k = 0; k < len; k++) {
-			if (!pos) {
-				Salsa20WordToByte(y, key, m_indexConstants, m_nonce[0], m_nonce[1], m_nonce[2], m_nonce[3]);
-				m_nonce[0]++;
+		if (pos) {
+			sl_uint32 n = 64 - pos;
+			if (n > len) {
+				n = (sl_uint32)len;
+			}
+			for (sl_uint32 i = 0; i < n; i++) {
+				dst[i] = src[i] ^ y[pos + i];
+			}
+			m_pos = (pos + n) & 63;
+			src += n;
+			dst += n;
+			len -= n;
+		}
+		sl_size nBlocks = len >> 6;
+		while (nBlocks) {
+			sl_uint32 n = nBlocks > PARALLEL_BLOCKS ? PARALLEL_BLOCKS : (sl_uint32)nBlocks;
+			sl_uint32 nonces[PARALLEL_BLOCKS << 2];
+			for (sl_uint32 i = 0; i < n; i++) {
+				sl_uint32* nonce = nonces + (i << 2);
+				nonce[0] = m_nonce[0] + i;
+				nonce[1] = m_nonce[1];
+				nonce[2] = m_nonce[2];
+				nonce[3] = m_nonce[3];
 			}
-			dst[k] = src[k] ^ y[pos];
-			pos = (pos + 1) & 0x3F;
+			EncryptBlocks(key, m_indexConstants, nonces, src, dst, n);
+			m_nonce[0] += n;
+			src += n << 6;
+			dst += n << 6;
+			nBlocks -= n;
+		}
+		sl_uint32 n = (sl_uint32)(len & 63);
+		if (n) {
+			Salsa20WordToByte(y, key, m_indexConstants, m_nonce[0], m_nonce[1], m_nonce[2], m_nonce[3]);
+			m_nonce[0]++;
+			for (sl_uint32 i = 0; i < n; i++) {
+				dst[i] = src[i] ^ y[i];
+			}
+			m_pos = n;
 		}
-		m_pos = pos;
 	}
 	
 	
@@ -364,9 +433,17 @@ namespace slib
 		if (!len) {
 			return;
 		}
-		m_cipher.encrypt(src, dst, len);
-		m_auth.update(dst, len);
+		const sl_uint8* s = (const sl_uint8*)src;
+		sl_uint8* d = (sl_uint8*)dst;
 		m_lenInput += len;
+		do {
+			sl_size n = len > FUSED_CHUNK_SIZE ? FUSED_CHUNK_SIZE : len;
+			m_cipher.encrypt(s, d, n);
+			m_auth.update(d, n);
+			s += n;
+			d += n;
+			len -= n;
+		} while (len);
 	}
 	
 	void ChaCha20_Poly1305::decrypt(const void* src, void* dst, sl_size len) noexcept
@@ -374,9 +451,17 @@ namespace slib
 		if (!len) {
 			return;
 		}
-		m_auth.update(src, len);
-		m_cipher.encrypt(src, dst, len);
+		const sl_uint8* s = (const sl_uint8*)src;
+		sl_uint8* d = (sl_uint8*)dst;
 		m_lenInput += len;
+		do {
+			sl_size n = len > FUSED_CHUNK_SIZE ? FUSED_CHUNK_SIZE : len;
+			m_auth.update(s, n);
+			m_cipher.encrypt(s, d, n);
+			s += n;
+			d += n;
+			len -= n;
+		} while (len);
 	}
 	
 	void ChaCha20_Poly1305::check(const void* src, sl_size len) noexcept
@@ -0,0 +1,525 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "chacha_simd.h"
+
+#include "slib/core/cpu.h"
+
+#if !defined(SLIB_PLATFORM_IS_MOBILE) && defined(SLIB_ARCH_IS_X64)
+#	define SUPPORT_SSE2
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#		define TARGET_AVX2
+#		define TARGET_AVX512
+#	else
+#		include <immintrin.h>
+#		define TARGET_AVX2 __attribute__((target("avx2")))
+#		define TARGET_AVX512 __attribute__((target("avx2,avx512f")))
+#	endif
+#elif defined(SLIB_ARCH_IS_ARM64)
+#	define SUPPORT_NEON
+#	include <arm_neon.h>
+#endif
+
+#define PRIV_CHACHA_4(STEP) STEP(0) STEP(1) STEP(2) STEP(3)
+#define PRIV_CHACHA_16(STEP) PRIV_CHACHA_4(STEP) STEP(4) STEP(5) STEP(6) STEP(7) STEP(8) STEP(9) STEP(10) STEP(11) STEP(12) STEP(13) STEP(14) STEP(15)
+
+#define PRIV_CHACHA_QUARTERROUND(a, b, c, d) \
+	a = VEC_ADD(a, b); d = VEC_XOR(d, a); d = VEC_ROTL16(d); \
+	c = VEC_ADD(c, d); b = VEC_XOR(b, c); b = VEC_ROTL(b, 12); \
+	a = VEC_ADD(a, b); d = VEC_XOR(d, a); d = VEC_ROTL8(d); \
+	c = VEC_ADD(c, d); b = VEC_XOR(b, c); b = VEC_ROTL(b, 7);
+
+#define PRIV_CHACHA_ROUNDS(x) \
+	for (sl_uint32 iRound = 0; iRound < 10; iRound++) { \
+		PRIV_CHACHA_QUARTERROUND(x[0], x[4], x[8], x[12]) \
+		PRIV_CHACHA_QUARTERROUND(x[1], x[5], x[9], x[13]) \
+		PRIV_CHACHA_QUARTERROUND(x[2], x[6], x[10], x[14]) \
+		PRIV_CHACHA_QUARTERROUND(x[3], x[7], x[11], x[15]) \
+		PRIV_CHACHA_QUARTERROUND(x[0], x[5], x[10], x[15]) \
+		PRIV_CHACHA_QUARTERROUND(x[1], x[6], x[11], x[12]) \
+		PRIV_CHACHA_QUARTERROUND(x[2], x[7], x[8], x[13]) \
+		PRIV_CHACHA_QUARTERROUND(x[3], x[4], x[9], x[14]) \
+	}
+
+#define PRIV_CHACHA_COPY_STATE(k) x[k] = s[k];
+#define PRIV_CHACHA_ADD_STATE(k) x[k] = VEC_ADD(x[k], s[k]);
+
+// 4x4 transpose of the 32-bit words in each 128-bit lane
+#define PRIV_CHACHA_TRANSPOSE(TYPE, x0, x1, x2, x3) \
+	{ \
+		TYPE t0 = VEC_UNPACKLO32(x0, x1); \
+		TYPE t1 = VEC_UNPACKLO32(x2, x3); \
+		TYPE t2 = VEC_UNPACKHI32(x0, x1); \
+		TYPE t3 = VEC_UNPACKHI32(x2, x3); \
+		x0 = VEC_UNPACKLO64(t0, t1); \
+		x1 = VEC_UNPACKHI64(t0, t1); \
+		x2 = VEC_UNPACKLO64(t2, t3); \
+		x3 = VEC_UNPACKHI64(t2, t3); \
+	}
+
+#define PRIV_CHACHA_TRANSPOSE_GROUP(g) PRIV_CHACHA_TRANSPOSE(VEC, x[4 * g], x[4 * g + 1], x[4 * g + 2], x[4 * g + 3])
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace chacha_simd
+		{
+
+#if defined(SUPPORT_SSE2)
+
+#define VEC __m128i
+#define VEC_ADD(a, b) _mm_add_epi32(a, b)
+#define VEC_XOR(a, b) _mm_xor_si128(a, b)
+#define VEC_ROTL(a, c) _mm_or_si128(_mm_slli_epi32(a, c), _mm_srli_epi32(a, 32 - (c)))
+#define VEC_ROTL16(a) _mm_shufflehi_epi16(_mm_shufflelo_epi16(a, 0xB1), 0xB1)
+#define VEC_ROTL8(a) VEC_ROTL(a, 8)
+#define VEC_UNPACKLO32(a, b) _mm_unpacklo_epi32(a, b)
+#define VEC_UNPACKHI32(a, b) _mm_unpackhi_epi32(a, b)
+#define VEC_UNPACKLO64(a, b) _mm_unpacklo_epi64(a, b)
+#define VEC_UNPACKHI64(a, b) _mm_unpackhi_epi64(a, b)
+
+			static SLIB_INLINE void Store_SSE2(const sl_uint8* src, sl_uint8* dst, sl_size offset, __m128i v) noexcept
+			{
+				if (src) {
+					v = _mm_xor_si128(v, _mm_loadu_si128((const __m128i*)(src + offset)));
+				}
+				_mm_storeu_si128((__m128i*)(dst + offset), v);
+			}
+
+#define PRIV_CHACHA_STORE_SSE2(g) \
+	Store_SSE2(src, dst, (g << 4), x[4 * g]); \
+	Store_SSE2(src, dst, 64 + (g << 4), x[4 * g + 1]); \
+	Store_SSE2(src, dst, 128 + (g << 4), x[4 * g + 2]); \
+	Store_SSE2(src, dst, 192 + (g << 4), x[4 * g + 3]);
+
+			// 4 blocks per group
+			static void EncryptBlocks_SSE2(const sl_uint32* input, const sl_uint32* nonces, const sl_uint8* src, sl_uint8* dst, sl_size nGroups) noexcept
+			{
+				__m128i s[16];
+				sl_uint32 i;
+				for (i = 0; i < 12; i++) {
+					s[i] = _mm_set1_epi32((int)(input[i]));
+				}
+				for (; nGroups; nGroups--) {
+					for (i = 0; i < 4; i++) {
+						s[12 + i] = _mm_setr_epi32((int)(nonces[i]), (int)(nonces[4 + i]), (int)(nonces[8 + i]), (int)(nonces[12 + i]));
+					}
+					__m128i x[16];
+					PRIV_CHACHA_16(PRIV_CHACHA_COPY_STATE)
+					PRIV_CHACHA_ROUNDS(x)
+					PRIV_CHACHA_16(PRIV_CHACHA_ADD_STATE)
+					PRIV_CHACHA_4(PRIV_CHACHA_TRANSPOSE_GROUP)
+					PRIV_CHACHA_4(PRIV_CHACHA_STORE_SSE2)
+					nonces += 16;
+					if (src) {
+						src += 256;
+					}
+					dst += 256;
+				}
+			}
+
+#undef VEC
+#undef VEC_ADD
+#undef VEC_XOR
+#undef VEC_ROTL
+#undef VEC_ROTL16
+#undef VEC_ROTL8
+#undef VEC_UNPACKLO32
+#undef VEC_UNPACKHI32
+#undef VEC_UNPACKLO64
+#undef VEC_UNPACKHI64
+
+#define VEC __m256i
+#define VEC_ADD(a, b) _mm256_add_epi32(a, b)
+#define VEC_XOR(a, b) _mm256_xor_si256(a, b)
+#define VEC_ROTL(a, c) _mm256_or_si256(_mm256_slli_epi32(a, c), _mm256_srli_epi32(a, 32 - (c)))
+#define VEC_ROTL16(a) _mm256_shuffle_epi8(a, rot16)
+#define VEC_ROTL8(a) _mm256_shuffle_epi8(a, rot8)
+#define VEC_UNPACKLO32(a, b) _mm256_unpacklo_epi32(a, b)
+#define VEC_UNPACKHI32(a, b) _mm256_unpackhi_epi32(a, b)
+#define VEC_UNPACKLO64(a, b) _mm256_unpacklo_epi64(a, b)
+#define VEC_UNPACKHI64(a, b) _mm256_unpackhi_epi64(a, b)
+
+			TARGET_AVX2
+			static SLIB_INLINE void Store_AVX2(const sl_uint8* src, sl_uint8* dst, sl_size offset, __m256i v) noexcept
+			{
+				if (src) {
+					v = _mm256_xor_si256(v, _mm256_loadu_si256((const __m256i*)(src + offset)));
+				}
+				_mm256_storeu_si256((__m256i*)(dst + offset), v);
+			}
+
+			// After transposing, the 128-bit lane L of x[4 * g + k] holds the words (4 * g) ~ (4 * g + 3) of the block (4 * L + k)
+#define PRIV_CHACHA_STORE_AVX2(k) \
+	Store_AVX2(src, dst, (k << 6), _mm256_permute2x128_si256(x[k], x[4 + k], 0x20)); \
+	Store_AVX2(src, dst, (k << 6) + 32, _mm256_permute2x128_si256(x[8 + k], x[12 + k], 0x20)); \
+	Store_AVX2(src, dst, ((4 + k) << 6), _mm256_permute2x128_si256(x[k], x[4 + k], 0x31)); \
+	Store_AVX2(src, dst, ((4 + k) << 6) + 32, _mm256_permute2x128_si256(x[8 + k], x[12 + k], 0x31));
+
+			// 8 blocks per group
+			TARGET_AVX2
+			static void EncryptBlocks_AVX2(const sl_uint32* input, const sl_uint32* nonces, const sl_uint8* src, sl_uint8* dst, sl_size nGroups) noexcept
+			{
+				const __m256i rot16 = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13, 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+				const __m256i rot8 = _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14, 3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14);
+				const __m256i indexNonces = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+				__m256i s[16];
+				sl_uint32 i;
+				for (i = 0; i < 12; i++) {
+					s[i] = _mm256_set1_epi32((int)(input[i]));
+				}
+				for (; nGroups; nGroups--) {
+					for (i = 0; i < 4; i++) {
+						s[12 + i] = _mm256_i32gather_epi32((const int*)(nonces + i), indexNonces, 4);
+					}
+					__m256i x[16];
+					PRIV_CHACHA_16(PRIV_CHACHA_COPY_STATE)
+					PRIV_CHACHA_ROUNDS(x)
+					PRIV_CHACHA_16(PRIV_CHACHA_ADD_STATE)
+					PRIV_CHACHA_4(PRIV_CHACHA_TRANSPOSE_GROUP)
+					PRIV_CHACHA_4(PRIV_CHACHA_STORE_AVX2)
+					nonces += 32;
+					if (src) {
+						src += 512;
+					}
+					dst += 512;
+				}
+			}
+
+#undef VEC
+#undef VEC_ADD
+#undef VEC_XOR
+#undef VEC_ROTL
+#undef VEC_ROTL16
+#undef VEC_ROTL8
+#undef VEC_UNPACKLO32
+#undef VEC_UNPACKHI32
+#undef VEC_UNPACKLO64
+#undef VEC_UNPACKHI64
+
+#define VEC __m512i
+#define VEC_ADD(a, b) _mm512_add_epi32(a, b)
+#define VEC_XOR(a, b) _mm512_xor_si512(a, b)
+#define VEC_ROTL(a, c) _mm512_rol_epi32(a, c)
+#define VEC_ROTL16(a) _mm512_rol_epi32(a, 16)
+#define VEC_ROTL8(a) _mm512_rol_epi32(a, 8)
+#define VEC_UNPACKLO32(a, b) _mm512_unpacklo_epi32(a, b)
+#define VEC_UNPACKHI32(a, b) _mm512_unpackhi_epi32(a, b)
+#define VEC_UNPACKLO64(a, b) _mm512_unpacklo_epi64(a, b)
+#define VEC_UNPACKHI64(a, b) _mm512_unpackhi_epi64(a, b)
+
+			TARGET_AVX512
+			static SLIB_INLINE void Store_AVX512(const sl_uint8* src, sl_uint8* dst, sl_size offset, __m512i v) noexcept
+			{
+				if (src) {
+					v = _mm512_xor_si512(v, _mm512_loadu_si512((const void*)(src + offset)));
+				}
+				_mm512_storeu_si512((void*)(dst + offset), v);
+			}
+
+			// After transposing, the 128-bit lane L of x[4 * g + k] holds the words (4 * g) ~ (4 * g + 3) of the block (4 * L + k)
+#define PRIV_CHACHA_STORE_AVX512(k) \
+	{ \
+		__m512i a = _mm512_shuffle_i32x4(x[k], x[4 + k], 0x44); \
+		__m512i b = _mm512_shuffle_i32x4(x[k], x[4 + k], 0xEE); \
+		__m512i c = _mm512_shuffle_i32x4(x[8 + k], x[12 + k], 0x44); \
+		__m512i d = _mm512_shuffle_i32x4(x[8 + k], x[12 + k], 0xEE); \
+		Store_AVX512(src, dst, (k << 6), _mm512_shuffle_i32x4(a, c, 0x88)); \
+		Store_AVX512(src, dst, ((4 + k) << 6), _mm512_shuffle_i32x4(a, c, 0xDD)); \
+		Store_AVX512(src, dst, ((8 + k) << 6), _mm512_shuffle_i32x4(b, d, 0x88)); \
+		Store_AVX512(src, dst, ((12 + k) << 6), _mm512_shuffle_i32x4(b, d, 0xDD)); \
+	}
+
+			// 16 blocks per group
+			TARGET_AVX512
+			static void EncryptBlocks_AVX512(const sl_uint32* input, const sl_uint32* nonces, const sl_uint8* src, sl_uint8* dst, sl_size nGroups) noexcept
+			{
+				const __m512i indexNonces = _mm512_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28, 32, 36, 40, 44, 48, 52, 56, 60);
+				__m512i s[16];
+				sl_uint32 i;
+				for (i = 0; i < 12; i++) {
+					s[i] = _mm512_set1_epi32((int)(input[i]));
+				}
+				for (; nGroups; nGroups--) {
+					for (i = 0; i < 4; i++) {
+						s[12 + i] = _mm512_i32gather_epi32(indexNonces, (const void*)(nonces + i), 4);
+					}
+					__m512i x[16];
+					PRIV_CHACHA_16(PRIV_CHACHA_COPY_STATE)
+					PRIV_CHACHA_ROUNDS(x)
+					PRIV_CHACHA_16(PRIV_CHACHA_ADD_STATE)
+					PRIV_CHACHA_4(PRIV_CHACHA_TRANSPOSE_GROUP)
+					PRIV_CHACHA_4(PRIV_CHACHA_STORE_AVX512)
+					nonces += 64;
+					if (src) {
+						src += 1024;
+					}
+					dst += 1024;
+				}
+			}
+
+#undef VEC
+#undef VEC_ADD
+#undef VEC_XOR
+#undef VEC_ROTL
+#undef VEC_ROTL16
+#undef VEC_ROTL8
+#undef VEC_UNPACKLO32
+#undef VEC_UNPACKHI32
+#undef VEC_UNPACKLO64
+#undef VEC_UNPACKHI64
+
+			sl_size EncryptBlocks(const sl_uint32* input, const sl_uint32* nonces, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks) noexcept
+			{
+				sl_size nDone = 0;
+				if (nBlocks >= 16 && Cpu::isSupportedAVX512F()) {
+					sl_size nGroups = nBlocks >> 4;
+					EncryptBlocks_AVX512(input, nonces, src, dst, nGroups);
+					nDone = nGroups << 4;
+				}
+				if (nBlocks - nDone >= 8 && Cpu::isSupportedAVX2()) {
+					sl_size nGroups = (nBlocks - nDone) >> 3;
+					EncryptBlocks_AVX2(input, nonces + (nDone << 2), src ? src + (nDone << 6) : sl_null, dst + (nDone << 6), nGroups);
+					nDone += nGroups << 3;
+				}
+				if (nBlocks - nDone >= 4) {
+					sl_size nGroups = (nBlocks - nDone) >> 2;
+					EncryptBlocks_SSE2(input, nonces + (nDone << 2), src ? src + (nDone << 6) : sl_null, dst + (nDone << 6), nGroups);
+					nDone += nGroups << 2;
+				}
+				return nDone;
+			}
+
+			sl_bool IsSupportedPoly1305() noexcept
+			{
+				return Cpu::isSupportedAVX2();
+			}
+
+#define PRIV_POLY1305_MUL(a0, a1, a2, a3, a4, R0, R1, R2, R3, R4, S1, S2, S3, S4) \
+	d0 = _mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a0, R0), _mm256_mul_epu32(a1, S4)), _mm256_add_epi64(_mm256_mul_epu32(a2, S3), _mm256_mul_epu32(a3, S2))), _mm256_mul_epu32(a4, S1)); \
+	d1 = _mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a0, R1), _mm256_mul_epu32(a1, R0)), _mm256_add_epi64(_mm256_mul_epu32(a2, S4), _mm256_mul_epu32(a3, S3))), _mm256_mul_epu32(a4, S2)); \
+	d2 = _mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a0, R2), _mm256_mul_epu32(a1, R1)), _mm256_add_epi64(_mm256_mul_epu32(a2, R0), _mm256_mul_epu32(a3, S4))), _mm256_mul_epu32(a4, S3)); \
+	d3 = _mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a0, R3), _mm256_mul_epu32(a1, R2)), _mm256_add_epi64(_mm256_mul_epu32(a2, R1), _mm256_mul_epu32(a3, R0))), _mm256_mul_epu32(a4, S4)); \
+	d4 = _mm256_add_epi64(_mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epu32(a0, R4), _mm256_mul_epu32(a1, R3)), _mm256_add_epi64(_mm256_mul_epu32(a2, R2), _mm256_mul_epu32(a3, R1))), _mm256_mul_epu32(a4, R0));
+
+#define PRIV_POLY1305_CARRY(x, y) \
+	c = _mm256_srli_epi64(x, 26); x = _mm256_and_si256(x, mask); y = _mm256_add_epi64(y, c);
+
+			// Loads 4 blocks into the 64-bit lanes in the order of (0, 2, 1, 3)
+#define PRIV_POLY1305_LOAD_MESSAGE \
+	{ \
+		__m256i v01 = _mm256_loadu_si256((const __m256i*)m); \
+		__m256i v23 = _mm256_loadu_si256((const __m256i*)(m + 32)); \
+		__m256i lo = _mm256_unpacklo_epi64(v01, v23); \
+		__m256i hi = _mm256_unpackhi_epi64(v01, v23); \
+		m0 = _mm256_and_si256(lo, mask); \
+		m1 = _mm256_and_si256(_mm256_srli_epi64(lo, 26), mask); \
+		m2 = _mm256_and_si256(_mm256_or_si256(_mm256_srli_epi64(lo, 52), _mm256_slli_epi64(hi, 12)), mask); \
+		m3 = _mm256_and_si256(_mm256_srli_epi64(hi, 14), mask); \
+		m4 = _mm256_or_si256(_mm256_srli_epi64(hi, 40), hibit); \
+		m += 64; \
+	}
+
+			TARGET_AVX2
+			static void Poly1305_UpdateBlocks_AVX2(const sl_uint32* r, sl_uint32* h, const sl_uint8* m, sl_size nBlocks, sl_uint32 _hibit) noexcept
+			{
+				const __m256i mask = _mm256_set1_epi64x(0x3ffffff);
+				const __m256i hibit = _mm256_set1_epi64x(_hibit);
+
+				// r^4
+				const sl_uint32* p = r + 15;
+				__m256i R0 = _mm256_set1_epi64x(p[0]);
+				__m256i R1 = _mm256_set1_epi64x(p[1]);
+				__m256i R2 = _mm256_set1_epi64x(p[2]);
+				__m256i R3 = _mm256_set1_epi64x(p[3]);
+				__m256i R4 = _mm256_set1_epi64x(p[4]);
+				__m256i S1 = _mm256_set1_epi64x(p[1] * 5);
+				__m256i S2 = _mm256_set1_epi64x(p[2] * 5);
+				__m256i S3 = _mm256_set1_epi64x(p[3] * 5);
+				__m256i S4 = _mm256_set1_epi64x(p[4] * 5);
+
+				__m256i m0, m1, m2, m3, m4;
+				__m256i d0, d1, d2, d3, d4;
+				__m256i c;
+
+				PRIV_POLY1305_LOAD_MESSAGE
+				__m256i a0 = _mm256_add_epi64(m0, _mm256_set_epi64x(0, 0, 0, h[0]));
+				__m256i a1 = _mm256_add_epi64(m1, _mm256_set_epi64x(0, 0, 0, h[1]));
+				__m256i a2 = _mm256_add_epi64(m2, _mm256_set_epi64x(0, 0, 0, h[2]));
+				__m256i a3 = _mm256_add_epi64(m3, _mm256_set_epi64x(0, 0, 0, h[3]));
+				__m256i a4 = _mm256_add_epi64(m4, _mm256_set_epi64x(0, 0, 0, h[4]));
+				nBlocks -= 4;
+
+				while (nBlocks) {
+					// a = a * r^4 + m
+					PRIV_POLY1305_MUL(a0, a1, a2, a3, a4, R0, R1, R2, R3, R4, S1, S2, S3, S4)
+					PRIV_POLY1305_CARRY(d0, d1)
+					PRIV_POLY1305_CARRY(d3, d4)
+					PRIV_POLY1305_CARRY(d1, d2)
+					c = _mm256_srli_epi64(d4, 26); d4 = _mm256_and_si256(d4, mask); d0 = _mm256_add_epi64(d0, _mm256_add_epi64(c, _mm256_slli_epi64(c, 2)));
+					PRIV_POLY1305_CARRY(d2, d3)
+					PRIV_POLY1305_CARRY(d0, d1)
+					PRIV_POLY1305_CARRY(d3, d4)
+					PRIV_POLY1305_LOAD_MESSAGE
+					a0 = _mm256_add_epi64(d0, m0);
+					a1 = _mm256_add_epi64(d1, m1);
+					a2 = _mm256_add_epi64(d2, m2);
+					a3 = _mm256_add_epi64(d3, m3);
+					a4 = _mm256_add_epi64(d4, m4);
+					nBlocks -= 4;
+				}
+
+				// h = a[0] * r^4 + a[1] * r^2 + a[2] * r^3 + a[3] * r^1
+				R0 = _mm256_set_epi64x(r[0], r[10], r[5], r[15]);
+				R1 = _mm256_set_epi64x(r[1], r[11], r[6], r[16]);
+				R2 = _mm256_set_epi64x(r[2], r[12], r[7], r[17]);
+				R3 = _mm256_set_epi64x(r[3], r[13], r[8], r[18]);
+				R4 = _mm256_set_epi64x(r[4], r[14], r[9], r[19]);
+				S1 = _mm256_add_epi64(R1, _mm256_slli_epi64(R1, 2));
+				S2 = _mm256_add_epi64(R2, _mm256_slli_epi64(R2, 2));
+				S3 = _mm256_add_epi64(R3, _mm256_slli_epi64(R3, 2));
+				S4 = _mm256_add_epi64(R4, _mm256_slli_epi64(R4, 2));
+				PRIV_POLY1305_MUL(a0, a1, a2, a3, a4, R0, R1, R2, R3, R4, S1, S2, S3, S4)
+
+				sl_uint64 t[4];
+				sl_uint64 e[5];
+#define PRIV_POLY1305_SUM_LANES(k) \
+	_mm256_storeu_si256((__m256i*)t, d##k); \
+	e[k] = t[0] + t[1] + t[2] + t[3];
+				PRIV_POLY1305_SUM_LANES(0)
+				PRIV_POLY1305_SUM_LANES(1)
+				PRIV_POLY1305_SUM_LANES(2)
+				PRIV_POLY1305_SUM_LANES(3)
+				PRIV_POLY1305_SUM_LANES(4)
+#undef PRIV_POLY1305_SUM_LANES
+
+				// (partial) h %= p
+				sl_uint64 carry;
+				carry = e[0] >> 26; e[0] &= 0x3ffffff; e[1] += carry;
+				carry = e[1] >> 26; e[1] &= 0x3ffffff; e[2] += carry;
+				carry = e[2] >> 26; e[2] &= 0x3ffffff; e[3] += carry;
+				carry = e[3] >> 26; e[3] &= 0x3ffffff; e[4] += carry;
+				carry = e[4] >> 26; e[4] &= 0x3ffffff; e[0] += carry * 5;
+				carry = e[0] >> 26; e[0] &= 0x3ffffff; e[1] += carry;
+				h[0] = (sl_uint32)(e[0]);
+				h[1] = (sl_uint32)(e[1]);
+				h[2] = (sl_uint32)(e[2]);
+				h[3] = (sl_uint32)(e[3]);
+				h[4] = (sl_uint32)(e[4]);
+			}
+
+			void Poly1305_UpdateBlocks(const sl_uint32* r, sl_uint32* h, const sl_uint8* m, sl_size nBlocks, sl_uint32 hibit) noexcept
+			{
+				Poly1305_UpdateBlocks_AVX2(r, h, m, nBlocks, hibit);
+			}
+
+#elif defined(SUPPORT_NEON)
+
+#define VEC uint32x4_t
+#define VEC_ADD(a, b) vaddq_u32(a, b)
+#define VEC_XOR(a, b) veorq_u32(a, b)
+#define VEC_ROTL(a, c) vsriq_n_u32(vshlq_n_u32(a, c), a, 32 - (c))
+#define VEC_ROTL16(a) vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(a)))
+#define VEC_ROTL8(a) VEC_ROTL(a, 8)
+
+			static SLIB_INLINE void Store_NEON(const sl_uint8* src, sl_uint8* dst, sl_size offset, uint32x4_t v) noexcept
+			{
+				uint8x16_t b = vreinterpretq_u8_u32(v);
+				if (src) {
+					b = veorq_u8(b, vld1q_u8(src + offset));
+				}
+				vst1q_u8(dst + offset, b);
+			}
+
+#define PRIV_CHACHA_STORE_NEON(g) \
+	{ \
+		uint32x4x2_t t0 = vtrnq_u32(x[4 * g], x[4 * g + 1]); \
+		uint32x4x2_t t1 = vtrnq_u32(x[4 * g + 2], x[4 * g + 3]); \
+		Store_NEON(src, dst, (g << 4), vcombine_u32(vget_low_u32(t0.val[0]), vget_low_u32(t1.val[0]))); \
+		Store_NEON(src, dst, 64 + (g << 4), vcombine_u32(vget_low_u32(t0.val[1]), vget_low_u32(t1.val[1]))); \
+		Store_NEON(src, dst, 128 + (g << 4), vcombine_u32(vget_high_u32(t0.val[0]), vget_high_u32(t1.val[0]))); \
+		Store_NEON(src, dst, 192 + (g << 4), vcombine_u32(vget_high_u32(t0.val[1]), vget_high_u32(t1.val[1]))); \
+	}
+
+			sl_size EncryptBlocks(const sl_uint32* input, const sl_uint32* nonces, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks) noexcept
+			{
+				uint32x4_t s[16];
+				sl_uint32 i;
+				for (i = 0; i < 12; i++) {
+					s[i] = vdupq_n_u32(input[i]);
+				}
+				sl_size nGroups = nBlocks >> 2;
+				for (sl_size k = 0; k < nGroups; k++) {
+					// deinterleaves the nonce words of 4 blocks
+					uint32x4x4_t n = vld4q_u32(nonces);
+					s[12] = n.val[0];
+					s[13] = n.val[1];
+					s[14] = n.val[2];
+					s[15] = n.val[3];
+					uint32x4_t x[16];
+					PRIV_CHACHA_16(PRIV_CHACHA_COPY_STATE)
+					PRIV_CHACHA_ROUNDS(x)
+					PRIV_CHACHA_16(PRIV_CHACHA_ADD_STATE)
+					PRIV_CHACHA_4(PRIV_CHACHA_STORE_NEON)
+					nonces += 16;
+					if (src) {
+						src += 256;
+					}
+					dst += 256;
+				}
+				return nGroups << 2;
+			}
+
+			sl_bool IsSupportedPoly1305() noexcept
+			{
+				return sl_false;
+			}
+
+			void Poly1305_UpdateBlocks(const sl_uint32* r, sl_uint32* h, const sl_uint8* m, sl_size nBlocks, sl_uint32 hibit) noexcept
+			{
+			}
+
+#else
+
+			sl_size EncryptBlocks(const sl_uint32* input, const sl_uint32* nonces, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks) noexcept
+			{
+				return 0;
+			}
+
+			sl_bool IsSupportedPoly1305() noexcept
+			{
+				return sl_false;
+			}
+
+			void Poly1305_UpdateBlocks(const sl_uint32* r, sl_uint32* h, const sl_uint8* m, sl_size nBlocks, sl_uint32 hibit) noexcept
+			{
+			}
+
+#endif
+
+		}
+	}
+
+}
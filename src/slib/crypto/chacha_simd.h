@@ -0,0 +1,61 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CRYPTO_CHACHA_SIMD
+#define CHECKHEADER_SLIB_CRYPTO_CHACHA_SIMD
+
+#include "slib/crypto/definition.h"
+
+/*
+	Multi-block SIMD kernels of ChaCha20 and Poly1305 (SSE2, AVX2, AVX-512, NEON)
+
+	ChaCha20 computes 4, 8 or 16 blocks in parallel, one state word of all blocks per register.
+	Poly1305 runs 4 interleaved accumulators with the powers r^1 ~ r^4 (radix 2^26).
+*/
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace chacha_simd
+		{
+
+			// input: state words 0 ~ 11 (constants and key)
+			// nonces: state words 12 ~ 15 of each block, 4 words per block
+			// src: null to output the key stream
+			// returns the number of processed blocks (multiple of 4)
+			sl_size EncryptBlocks(const sl_uint32* input, const sl_uint32* nonces, const sl_uint8* src, sl_uint8* dst, sl_size nBlocks) noexcept;
+
+			sl_bool IsSupportedPoly1305() noexcept;
+
+			// r: r^1 ~ r^4, 5 limbs (radix 2^26) per each power
+			// h: accumulator, 5 limbs (inout)
+			// nBlocks: multiple of 4
+			void Poly1305_UpdateBlocks(const sl_uint32* r, sl_uint32* h, const sl_uint8* m, sl_size nBlocks, sl_uint32 hibit) noexcept;
+
+		}
+	}
+
+}
+
+#endif
@@ -0,0 +1,592 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/crypto/compress_parallel.h"
+#include "slib/crypto/crc32.h"
+
+#include "slib/core/thread_pool.h"
+#include "slib/core/event.h"
+#include "slib/core/mutex.h"
+#include "slib/core/memory.h"
+#include "slib/core/mio.h"
+#include "slib/core/linked_list.h"
+#include "slib/core/cpu.h"
+
+#include "zlib/zlib.h"
+#include "zstd/zstd.h"
+
+#undef compress
+
+#define DEFLATE_DICTIONARY_SIZE 32768
+#define DEFAULT_BLOCK_SIZE_DEFLATE 0x20000
+#define DEFAULT_BLOCK_SIZE_ZSTD 0x100000
+#define MIN_BLOCK_SIZE 0x1000
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace compress_parallel
+		{
+
+			class Block : public Referable
+			{
+			public:
+				Memory input;
+				Memory dictionary;
+				sl_bool flagLast;
+
+				Memory output;
+				sl_size sizeOutput;
+				sl_uint32 check;
+				sl_bool flagError;
+
+				volatile sl_bool flagDone;
+				Ref<Event> event;
+
+			public:
+				Block(): flagLast(sl_false), sizeOutput(0), check(0), flagError(sl_false), flagDone(sl_false) {}
+
+			public:
+				void wait()
+				{
+					while (!flagDone) {
+						event->wait();
+					}
+				}
+
+			};
+
+			class Context : public Referable
+			{
+			public:
+				ParallelCompressionFormat format;
+				sl_int32 level;
+				sl_size blockSize;
+				sl_uint32 maxPendingBlocks;
+				Ref<ThreadPool> threadPool;
+				sl_bool flagOwnThreadPool;
+
+				// Accessed only by the thread calling `pass()` and `finish()`
+				LinkedList< Ref<Block> > blocks;
+				Memory current;
+				sl_size sizeCurrent;
+				Memory previous;
+				sl_bool flagFinishing;
+
+				Memory pending;
+				sl_size posPending;
+				Memory trailer;
+
+				sl_uint32 check;
+				sl_uint64 sizeTotal;
+
+				// Zstd contexts shared by the workers
+				Mutex lockZstd;
+				List<void*> contextsZstd;
+
+			public:
+				Context(): flagOwnThreadPool(sl_false), sizeCurrent(0), flagFinishing(sl_false), posPending(0), check(0), sizeTotal(0) {}
+
+				~Context()
+				{
+					ListElements<void*> contexts(contextsZstd);
+					for (sl_size i = 0; i < contexts.count; i++) {
+						ZSTD_freeCCtx((ZSTD_CCtx*)(contexts[i]));
+					}
+				}
+
+			public:
+				sl_bool isDeflate()
+				{
+					return format != ParallelCompressionFormat::Zstd;
+				}
+
+				void compressDeflate(Block* block)
+				{
+					z_stream stream;
+					Base::zeroMemory(&stream, sizeof(stream));
+					if (deflateInit2(&stream, (int)level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+						return;
+					}
+					sl_size sizeInput = block->input.getSize();
+					if (block->dictionary.isNotNull()) {
+						if (deflateSetDictionary(&stream, (Bytef*)(block->dictionary.getData()), (uInt)(block->dictionary.getSize())) != Z_OK) {
+							deflateEnd(&stream);
+							return;
+						}
+					}
+					// The sync flush appends an empty stored block (5 bytes)
+					sl_size sizeBound = (sl_size)(deflateBound(&stream, (uLong)sizeInput)) + 16;
+					Memory output = Memory::create(sizeBound);
+					if (output.isNotNull()) {
+						stream.next_in = (Bytef*)(block->input.getData());
+						stream.avail_in = (uInt)sizeInput;
+						stream.next_out = (Bytef*)(output.getData());
+						stream.avail_out = (uInt)sizeBound;
+						int iRet = deflate(&stream, block->flagLast ? Z_FINISH : Z_SYNC_FLUSH);
+						if ((block->flagLast ? iRet == Z_STREAM_END : iRet == Z_OK) && !(stream.avail_in)) {
+							block->output = Move(output);
+							block->sizeOutput = sizeBound - stream.avail_out;
+							if (format == ParallelCompressionFormat::Gzip) {
+								block->check = Crc32::get(block->input.getData(), sizeInput);
+							} else if (format == ParallelCompressionFormat::Zlib) {
+								block->check = (sl_uint32)(adler32_z(1, (Bytef*)(block->input.getData()), (z_size_t)sizeInput));
+							}
+							block->flagError = sl_false;
+						}
+					}
+					deflateEnd(&stream);
+				}
+
+				void compressZstd(Block* block)
+				{
+					ZSTD_CCtx* cctx = sl_null;
+					{
+						MutexLocker lock(&lockZstd);
+						contextsZstd.popBack_NoLock((void**)&cctx);
+					}
+					if (!cctx) {
+						cctx = ZSTD_createCCtx();
+						if (!cctx) {
+							return;
+						}
+					}
+					sl_size sizeInput = block->input.getSize();
+					sl_size sizeBound = (sl_size)(ZSTD_compressBound((size_t)sizeInput));
+					Memory output = Memory::create(sizeBound);
+					if (output.isNotNull()) {
+						size_t ret = ZSTD_compressCCtx(cctx, output.getData(), (size_t)sizeBound, block->input.getData(), (size_t)sizeInput, (int)level);
+						if (!(ZSTD_isError(ret))) {
+							block->output = Move(output);
+							block->sizeOutput = (sl_size)ret;
+							block->flagError = sl_false;
+						}
+					}
+					MutexLocker lock(&lockZstd);
+					contextsZstd.add_NoLock((void*)cctx);
+				}
+
+				void compress(Block* block)
+				{
+					block->flagError = sl_true;
+					if (isDeflate()) {
+						compressDeflate(block);
+					} else {
+						compressZstd(block);
+					}
+					// Release the input before signaling so the memory is bounded by pending blocks
+					block->dictionary.setNull();
+					block->flagDone = sl_true;
+					block->event->set();
+				}
+
+				sl_bool submit(sl_bool flagLast)
+				{
+					Ref<Block> block = new Block;
+					if (block.isNull()) {
+						return sl_false;
+					}
+					block->event = Event::create(sl_false);
+					if (block->event.isNull()) {
+						return sl_false;
+					}
+					block->flagLast = flagLast;
+					Memory input = current.sub(0, sizeCurrent);
+					if (isDeflate() && previous.isNotNull()) {
+						sl_size n = previous.getSize();
+						if (n > DEFLATE_DICTIONARY_SIZE) {
+							block->dictionary = previous.sub(n - DEFLATE_DICTIONARY_SIZE);
+						} else {
+							block->dictionary = previous;
+						}
+					}
+					block->input = input;
+					if (!(blocks.pushBack_NoLock(block))) {
+						return sl_false;
+					}
+					previous = Move(input);
+					sizeCurrent = 0;
+					if (!flagLast) {
+						current = Memory::create(blockSize);
+						if (current.isNull()) {
+							return sl_false;
+						}
+					} else {
+						current.setNull();
+					}
+					Ref<Context> context = this;
+					if (!(threadPool->addTask([context, block]() {
+						context->compress(block.get());
+					}))) {
+						compress(block.get());
+					}
+					return sl_true;
+				}
+
+				void onEmitBlock(Block* block)
+				{
+					sl_size n = block->input.getSize();
+					if (format == ParallelCompressionFormat::Gzip) {
+						check = Crc32::combine(check, block->check, n);
+					} else if (format == ParallelCompressionFormat::Zlib) {
+						check = (sl_uint32)(adler32_combine(check, block->check, (z_off_t)n));
+					}
+					sizeTotal += n;
+					block->input.setNull();
+					if (block->flagLast) {
+						if (format == ParallelCompressionFormat::Gzip) {
+							sl_uint8 t[8];
+							MIO::writeUint32LE(t, check);
+							MIO::writeUint32LE(t + 4, (sl_uint32)sizeTotal);
+							trailer = Memory::create(t, 8);
+						} else if (format == ParallelCompressionFormat::Zlib) {
+							sl_uint8 t[4];
+							MIO::writeUint32BE(t, check);
+							trailer = Memory::create(t, 4);
+						}
+					}
+				}
+
+				// Copies the compressed blocks to the output in order. When `flagWait` is set, waits for the blocks while the output has space.
+				sl_bool flush(sl_uint8*& output, sl_size& sizeOutput, sl_bool flagWait)
+				{
+					for (;;) {
+						sl_size n = pending.getSize() - posPending;
+						if (n) {
+							if (!sizeOutput) {
+								return sl_true;
+							}
+							if (n > sizeOutput) {
+								n = sizeOutput;
+							}
+							Base::copyMemory(output, (sl_uint8*)(pending.getData()) + posPending, n);
+							output += n;
+							sizeOutput -= n;
+							posPending += n;
+							continue;
+						}
+						pending.setNull();
+						posPending = 0;
+						if (trailer.isNotNull()) {
+							pending = Move(trailer);
+							continue;
+						}
+						Ref<Block> block;
+						if (!(blocks.getFrontValue_NoLock(&block))) {
+							return sl_true;
+						}
+						if (!(block->flagDone)) {
+							if (!flagWait || !sizeOutput) {
+								return sl_true;
+							}
+							block->wait();
+						}
+						blocks.popFront_NoLock();
+						if (block->flagError) {
+							return sl_false;
+						}
+						pending = block->output.sub(0, block->sizeOutput);
+						onEmitBlock(block.get());
+					}
+				}
+
+				sl_bool isFlushed()
+				{
+					return pending.isNull() && trailer.isNull() && blocks.isEmpty();
+				}
+
+				void waitAll()
+				{
+					Link< Ref<Block> >* link = blocks.getFront();
+					while (link) {
+						link->value->wait();
+						link = link->next;
+					}
+				}
+
+			};
+
+			static Memory CreateHeader(const ParallelCompressorParam& param, sl_int32 level)
+			{
+				if (param.format == ParallelCompressionFormat::Zlib) {
+					sl_uint8 h[2];
+					h[0] = 0x78; // deflate, 32KB window
+					sl_uint32 flevel;
+					if (level < 2) {
+						flevel = 0;
+					} else if (level < 6) {
+						flevel = 1;
+					} else if (level == 6) {
+						flevel = 2;
+					} else {
+						flevel = 3;
+					}
+					h[1] = (sl_uint8)(flevel << 6);
+					h[1] += (sl_uint8)(31 - (((sl_uint32)(h[0]) << 8) | h[1]) % 31);
+					return Memory::create(h, 2);
+				} else if (param.format == ParallelCompressionFormat::Gzip) {
+					String fileName = param.fileName.toString();
+					String comment = param.comment.toString();
+					sl_size nFileName = fileName.getLength();
+					sl_size nComment = comment.getLength();
+					sl_size size = 10 + (nFileName ? nFileName + 1 : 0) + (nComment ? nComment + 1 : 0);
+					Memory mem = Memory::create(size);
+					if (mem.isNull()) {
+						return sl_null;
+					}
+					sl_uint8* h = (sl_uint8*)(mem.getData());
+					h[0] = 0x1f;
+					h[1] = 0x8b;
+					h[2] = 8; // deflate
+					h[3] = (nFileName ? 8 : 0) | (nComment ? 16 : 0); // FNAME, FCOMMENT
+					MIO::writeUint32LE(h + 4, 0); // MTIME
+					h[8] = level == 9 ? 2 : (level == 1 ? 4 : 0);
+					h[9] = 255; // OS: unknown
+					sl_uint8* p = h + 10;
+					if (nFileName) {
+						Base::copyMemory(p, fileName.getData(), nFileName + 1);
+						p += nFileName + 1;
+					}
+					if (nComment) {
+						Base::copyMemory(p, comment.getData(), nComment + 1);
+					}
+					return mem;
+				}
+				return sl_null;
+			}
+
+		}
+	}
+
+	using namespace priv::compress_parallel;
+
+	ParallelCompressorParam::ParallelCompressorParam()
+	{
+		format = ParallelCompressionFormat::Zlib;
+		level = 6;
+		threadCount = 0;
+		blockSize = 0;
+		maxPendingBlocks = 0;
+	}
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(ParallelCompressorParam)
+
+
+	ParallelCompressor::ParallelCompressor()
+	{
+	}
+
+	ParallelCompressor::~ParallelCompressor()
+	{
+		Context* context = (Context*)(m_context.get());
+		if (context) {
+			context->waitAll();
+			if (context->flagOwnThreadPool) {
+				context->threadPool->release();
+			}
+		}
+	}
+
+	sl_bool ParallelCompressor::isStarted()
+	{
+		return m_context.isNotNull();
+	}
+
+	sl_bool ParallelCompressor::start(const ParallelCompressorParam& param)
+	{
+		if (m_context.isNotNull()) {
+			return sl_false;
+		}
+		Ref<Context> context = new Context;
+		if (context.isNull()) {
+			return sl_false;
+		}
+		context->format = param.format;
+		sl_int32 level = param.level;
+		if (context->isDeflate()) {
+			if (level < 0) {
+				level = Z_DEFAULT_COMPRESSION;
+			} else if (level > 9) {
+				level = 9;
+			}
+		}
+		context->level = level;
+		sl_uint32 nThreads = param.threadCount;
+		if (!nThreads) {
+			nThreads = Cpu::getCoreCount();
+			if (!nThreads) {
+				nThreads = 1;
+			}
+		}
+		sl_size blockSize = param.blockSize;
+		if (!blockSize) {
+			blockSize = context->isDeflate() ? DEFAULT_BLOCK_SIZE_DEFLATE : DEFAULT_BLOCK_SIZE_ZSTD;
+		} else if (blockSize < MIN_BLOCK_SIZE) {
+			blockSize = MIN_BLOCK_SIZE;
+		}
+		if (context->isDeflate() && blockSize > 0x40000000) {
+			blockSize = 0x40000000;
+		}
+		context->blockSize = blockSize;
+		sl_uint32 maxPendingBlocks = param.maxPendingBlocks;
+		if (!maxPendingBlocks) {
+			maxPendingBlocks = nThreads << 1;
+		}
+		context->maxPendingBlocks = maxPendingBlocks;
+		if (param.threadPool.isNotNull()) {
+			context->threadPool = param.threadPool;
+		} else {
+			context->threadPool = ThreadPool::create(0, nThreads);
+			if (context->threadPool.isNull()) {
+				return sl_false;
+			}
+			context->flagOwnThreadPool = sl_true;
+		}
+		context->current = Memory::create(blockSize);
+		if (context->current.isNull()) {
+			return sl_false;
+		}
+		if (param.format == ParallelCompressionFormat::Zlib) {
+			context->check = 1;
+			context->pending = CreateHeader(param, level < 0 ? 6 : level);
+		} else if (param.format == ParallelCompressionFormat::Gzip) {
+			context->pending = CreateHeader(param, level);
+		}
+		m_context = Move(context);
+		return sl_true;
+	}
+
+	DataFilterResult ParallelCompressor::pass(const void* _input, sl_size sizeInputAvailable, sl_size& sizeInputPassed,
+		void* _output, sl_size sizeOutputAvailable, sl_size& sizeOutputUsed)
+	{
+		sizeInputPassed = 0;
+		sizeOutputUsed = 0;
+		Context* context = (Context*)(m_context.get());
+		if (!context || context->flagFinishing) {
+			return DataFilterResult::Error;
+		}
+		const sl_uint8* input = (const sl_uint8*)_input;
+		sl_uint8* output = (sl_uint8*)_output;
+		if (!(context->flush(output, sizeOutputAvailable, sl_false))) {
+			return DataFilterResult::Error;
+		}
+		for (;;) {
+			if (context->sizeCurrent == context->blockSize) {
+				while (context->blocks.getCount() >= context->maxPendingBlocks) {
+					if (!sizeOutputAvailable) {
+						// The caller should provide more output space
+						goto END;
+					}
+					if (!(context->flush(output, sizeOutputAvailable, sl_true))) {
+						return DataFilterResult::Error;
+					}
+				}
+				if (!(context->submit(sl_false))) {
+					return DataFilterResult::Error;
+				}
+			}
+			if (!sizeInputAvailable) {
+				break;
+			}
+			sl_size n = context->blockSize - context->sizeCurrent;
+			if (n > sizeInputAvailable) {
+				n = sizeInputAvailable;
+			}
+			Base::copyMemory((sl_uint8*)(context->current.getData()) + context->sizeCurrent, input, n);
+			context->sizeCurrent += n;
+			input += n;
+			sizeInputAvailable -= n;
+		}
+	END:
+		sizeInputPassed = input - (const sl_uint8*)_input;
+		sizeOutputUsed = output - (sl_uint8*)_output;
+		return DataFilterResult::Continue;
+	}
+
+	DataFilterResult ParallelCompressor::finish(void* _output, sl_size sizeOutputAvailable, sl_size& sizeOutputUsed)
+	{
+		sizeOutputUsed = 0;
+		Context* context = (Context*)(m_context.get());
+		if (!context) {
+			return DataFilterResult::Error;
+		}
+		sl_uint8* output = (sl_uint8*)_output;
+		if (!(context->flagFinishing)) {
+			// Empty zstd frames are only needed for an empty input
+			if (context->isDeflate() || context->sizeCurrent || context->previous.isNull()) {
+				while (context->blocks.getCount() >= context->maxPendingBlocks) {
+					if (!sizeOutputAvailable) {
+						sizeOutputUsed = output - (sl_uint8*)_output;
+						return DataFilterResult::Continue;
+					}
+					if (!(context->flush(output, sizeOutputAvailable, sl_true))) {
+						return DataFilterResult::Error;
+					}
+				}
+				if (!(context->submit(sl_true))) {
+					return DataFilterResult::Error;
+				}
+			}
+			context->current.setNull();
+			context->previous.setNull();
+			context->flagFinishing = sl_true;
+		}
+		if (!(context->flush(output, sizeOutputAvailable, sl_true))) {
+			return DataFilterResult::Error;
+		}
+		sizeOutputUsed = output - (sl_uint8*)_output;
+		if (context->isFlushed()) {
+			return DataFilterResult::Finished;
+		}
+		return DataFilterResult::Continue;
+	}
+
+	sl_size ParallelCompressor::getRecommendedInputSize()
+	{
+		Context* context = (Context*)(m_context.get());
+		if (context) {
+			return context->blockSize;
+		}
+		return DEFAULT_BLOCK_SIZE_DEFLATE;
+	}
+
+	sl_size ParallelCompressor::getRecommendedOutputSize()
+	{
+		Context* context = (Context*)(m_context.get());
+		if (context) {
+			return context->blockSize;
+		}
+		return DEFAULT_BLOCK_SIZE_DEFLATE;
+	}
+
+	Memory ParallelCompressor::compress(const ParallelCompressorParam& param, const void* data, sl_size size)
+	{
+		ParallelCompressor compressor;
+		if (compressor.start(param)) {
+			return compressor.passAndFinish(data, size);
+		}
+		return sl_null;
+	}
+
+}
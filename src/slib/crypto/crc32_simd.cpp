@@ -0,0 +1,292 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "crc32_simd.h"
+
+#include "slib/core/cpu.h"
+
+#if !defined(SLIB_PLATFORM_IS_MOBILE) && defined(SLIB_ARCH_IS_X64)
+#	define SUPPORT_PCLMUL
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#		define TARGET_PCLMUL
+#		define TARGET_VPCLMUL
+#	else
+#		include <immintrin.h>
+#		define TARGET_PCLMUL __attribute__((target("pclmul")))
+#		define TARGET_VPCLMUL __attribute__((target("pclmul,avx2,avx512f,vpclmulqdq")))
+#	endif
+#elif defined(SLIB_ARCH_IS_ARM64) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_AES))
+#	define SUPPORT_PMULL
+#	include <arm_neon.h>
+#endif
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace crc32_simd
+		{
+
+			SLIB_ALIGN(16) const sl_uint64 g_foldConstantsCrc32[14] = {
+				SLIB_UINT64(0x1751997D0), SLIB_UINT64(0x0CCAA009E),
+				SLIB_UINT64(0x0F1DA05AA), SLIB_UINT64(0x15A546366),
+				SLIB_UINT64(0x03DB1ECDC), SLIB_UINT64(0x174359406),
+				SLIB_UINT64(0x154442BD4), SLIB_UINT64(0x1C6E41596),
+				SLIB_UINT64(0x1E88EF372), SLIB_UINT64(0x14A7FE880),
+				SLIB_UINT64(0x1821D8BC0), SLIB_UINT64(0x12E958AC4),
+				SLIB_UINT64(0x11542778A), SLIB_UINT64(0x1322D1430)
+			};
+
+			SLIB_ALIGN(16) const sl_uint64 g_foldConstantsCrc32c[14] = {
+				SLIB_UINT64(0x0F20C0DFE), SLIB_UINT64(0x14CD00BD6),
+				SLIB_UINT64(0x1384AA63A), SLIB_UINT64(0x0BA4FC28E),
+				SLIB_UINT64(0x01C291D04), SLIB_UINT64(0x1D82C63DA),
+				SLIB_UINT64(0x0740EEF02), SLIB_UINT64(0x09E4ADDF8),
+				SLIB_UINT64(0x06992CEA2), SLIB_UINT64(0x00D3B6092),
+				SLIB_UINT64(0x0A87AB8A8), SLIB_UINT64(0x0AB7AFF2A),
+				SLIB_UINT64(0x0DCB17AA4), SLIB_UINT64(0x0B9E02B86)
+			};
+
+#define FOLD_128 0
+#define FOLD_256 2
+#define FOLD_384 4
+#define FOLD_512 6
+#define FOLD_1024 8
+#define FOLD_1536 10
+#define FOLD_2048 12
+
+#if defined(SUPPORT_PCLMUL)
+
+#define PRIV_CRC_LOAD(p) _mm_loadu_si128((const __m128i*)(p))
+#define PRIV_CRC_FOLD(x, K) _mm_xor_si128(_mm_clmulepi64_si128(x, K, 0x00), _mm_clmulepi64_si128(x, K, 0x11))
+
+			TARGET_PCLMUL
+			static void Fold_PCLMUL(sl_uint32 state, const sl_uint8* data, sl_size size, const sl_uint64* constants, sl_uint8* remainder) noexcept
+			{
+				__m128i x0 = _mm_xor_si128(PRIV_CRC_LOAD(data), _mm_cvtsi32_si128((int)state));
+				__m128i x1 = PRIV_CRC_LOAD(data + 16);
+				__m128i x2 = PRIV_CRC_LOAD(data + 32);
+				__m128i x3 = PRIV_CRC_LOAD(data + 48);
+				data += 64;
+				size -= 64;
+				__m128i k = PRIV_CRC_LOAD(constants + FOLD_512);
+				while (size >= 64) {
+					x0 = _mm_xor_si128(PRIV_CRC_FOLD(x0, k), PRIV_CRC_LOAD(data));
+					x1 = _mm_xor_si128(PRIV_CRC_FOLD(x1, k), PRIV_CRC_LOAD(data + 16));
+					x2 = _mm_xor_si128(PRIV_CRC_FOLD(x2, k), PRIV_CRC_LOAD(data + 32));
+					x3 = _mm_xor_si128(PRIV_CRC_FOLD(x3, k), PRIV_CRC_LOAD(data + 48));
+					data += 64;
+					size -= 64;
+				}
+				x0 = PRIV_CRC_FOLD(x0, PRIV_CRC_LOAD(constants + FOLD_384));
+				x1 = PRIV_CRC_FOLD(x1, PRIV_CRC_LOAD(constants + FOLD_256));
+				k = PRIV_CRC_LOAD(constants + FOLD_128);
+				x2 = PRIV_CRC_FOLD(x2, k);
+				x0 = _mm_xor_si128(_mm_xor_si128(x0, x1), _mm_xor_si128(x2, x3));
+				while (size >= 16) {
+					x0 = _mm_xor_si128(PRIV_CRC_FOLD(x0, k), PRIV_CRC_LOAD(data));
+					data += 16;
+					size -= 16;
+				}
+				_mm_storeu_si128((__m128i*)remainder, x0);
+			}
+
+#define PRIV_CRC_LOAD512(p) _mm512_loadu_si512((const void*)(p))
+#define PRIV_CRC_FOLD512(x, K) _mm512_xor_si512(_mm512_clmulepi64_epi128(x, K, 0x00), _mm512_clmulepi64_epi128(x, K, 0x11))
+#define PRIV_CRC_FOLD512_XOR(x, K, y) _mm512_ternarylogic_epi64(_mm512_clmulepi64_epi128(x, K, 0x00), _mm512_clmulepi64_epi128(x, K, 0x11), y, 0x96)
+
+			// 4 x 512-bit registers are folded by 256 bytes per iteration
+			TARGET_VPCLMUL
+			static void Fold_VPCLMUL(sl_uint32 state, const sl_uint8* data, sl_size size, const sl_uint64* constants, sl_uint8* remainder) noexcept
+			{
+				__m512i z0 = _mm512_xor_si512(PRIV_CRC_LOAD512(data), _mm512_inserti32x4(_mm512_setzero_si512(), _mm_cvtsi32_si128((int)state), 0));
+				__m512i z1 = PRIV_CRC_LOAD512(data + 64);
+				__m512i z2 = PRIV_CRC_LOAD512(data + 128);
+				__m512i z3 = PRIV_CRC_LOAD512(data + 192);
+				data += 256;
+				size -= 256;
+				__m512i k = _mm512_broadcast_i32x4(PRIV_CRC_LOAD(constants + FOLD_2048));
+				while (size >= 256) {
+					z0 = PRIV_CRC_FOLD512_XOR(z0, k, PRIV_CRC_LOAD512(data));
+					z1 = PRIV_CRC_FOLD512_XOR(z1, k, PRIV_CRC_LOAD512(data + 64));
+					z2 = PRIV_CRC_FOLD512_XOR(z2, k, PRIV_CRC_LOAD512(data + 128));
+					z3 = PRIV_CRC_FOLD512_XOR(z3, k, PRIV_CRC_LOAD512(data + 192));
+					data += 256;
+					size -= 256;
+				}
+				z0 = PRIV_CRC_FOLD512(z0, _mm512_broadcast_i32x4(PRIV_CRC_LOAD(constants + FOLD_1536)));
+				z1 = PRIV_CRC_FOLD512(z1, _mm512_broadcast_i32x4(PRIV_CRC_LOAD(constants + FOLD_1024)));
+				k = _mm512_broadcast_i32x4(PRIV_CRC_LOAD(constants + FOLD_512));
+				z0 = _mm512_ternarylogic_epi64(z0, z1, PRIV_CRC_FOLD512(z2, k), 0x96);
+				z0 = _mm512_xor_si512(z0, z3);
+				while (size >= 64) {
+					z0 = PRIV_CRC_FOLD512_XOR(z0, k, PRIV_CRC_LOAD512(data));
+					data += 64;
+					size -= 64;
+				}
+				// Reduce the 4 lanes to a 128-bit register
+				__m128i x0 = PRIV_CRC_FOLD(_mm512_extracti32x4_epi32(z0, 0), PRIV_CRC_LOAD(constants + FOLD_384));
+				__m128i x1 = PRIV_CRC_FOLD(_mm512_extracti32x4_epi32(z0, 1), PRIV_CRC_LOAD(constants + FOLD_256));
+				__m128i k128 = PRIV_CRC_LOAD(constants + FOLD_128);
+				__m128i x2 = PRIV_CRC_FOLD(_mm512_extracti32x4_epi32(z0, 2), k128);
+				x0 = _mm_xor_si128(_mm_xor_si128(x0, x1), _mm_xor_si128(x2, _mm512_extracti32x4_epi32(z0, 3)));
+				while (size >= 16) {
+					x0 = _mm_xor_si128(PRIV_CRC_FOLD(x0, k128), PRIV_CRC_LOAD(data));
+					data += 16;
+					size -= 16;
+				}
+				_mm_storeu_si128((__m128i*)remainder, x0);
+			}
+
+#undef PRIV_CRC_LOAD512
+#undef PRIV_CRC_FOLD512
+#undef PRIV_CRC_FOLD512_XOR
+#undef PRIV_CRC_LOAD
+#undef PRIV_CRC_FOLD
+
+			sl_bool IsSupportedFold() noexcept
+			{
+				return Cpu::isSupportedPCLMUL();
+			}
+
+			void Fold(sl_uint32 state, const sl_uint8* data, sl_size size, const sl_uint64* constants, sl_uint8* remainder) noexcept
+			{
+				if (size >= 256 && Cpu::isSupportedVPCLMUL()) {
+					Fold_VPCLMUL(state, data, size, constants, remainder);
+				} else {
+					Fold_PCLMUL(state, data, size, constants, remainder);
+				}
+			}
+
+#elif defined(SUPPORT_PMULL)
+
+			static uint64x2_t FoldPMULL(uint64x2_t x, uint64x2_t k) noexcept
+			{
+				poly128_t lo = vmull_p64((poly64_t)vgetq_lane_u64(x, 0), (poly64_t)vgetq_lane_u64(k, 0));
+				poly128_t hi = vmull_high_p64(vreinterpretq_p64_u64(x), vreinterpretq_p64_u64(k));
+				return veorq_u64(vreinterpretq_u64_p128(lo), vreinterpretq_u64_p128(hi));
+			}
+
+#define PRIV_CRC_LOAD(p) vreinterpretq_u64_u8(vld1q_u8(p))
+
+			sl_bool IsSupportedFold() noexcept
+			{
+				return sl_true;
+			}
+
+			void Fold(sl_uint32 state, const sl_uint8* data, sl_size size, const sl_uint64* constants, sl_uint8* remainder) noexcept
+			{
+				uint64x2_t x0 = veorq_u64(PRIV_CRC_LOAD(data), vcombine_u64(vcreate_u64(state), vcreate_u64(0)));
+				uint64x2_t x1 = PRIV_CRC_LOAD(data + 16);
+				uint64x2_t x2 = PRIV_CRC_LOAD(data + 32);
+				uint64x2_t x3 = PRIV_CRC_LOAD(data + 48);
+				data += 64;
+				size -= 64;
+				uint64x2_t k = vld1q_u64(constants + FOLD_512);
+				while (size >= 64) {
+					x0 = veorq_u64(FoldPMULL(x0, k), PRIV_CRC_LOAD(data));
+					x1 = veorq_u64(FoldPMULL(x1, k), PRIV_CRC_LOAD(data + 16));
+					x2 = veorq_u64(FoldPMULL(x2, k), PRIV_CRC_LOAD(data + 32));
+					x3 = veorq_u64(FoldPMULL(x3, k), PRIV_CRC_LOAD(data + 48));
+					data += 64;
+					size -= 64;
+				}
+				x0 = FoldPMULL(x0, vld1q_u64(constants + FOLD_384));
+				x1 = FoldPMULL(x1, vld1q_u64(constants + FOLD_256));
+				k = vld1q_u64(constants + FOLD_128);
+				x2 = FoldPMULL(x2, k);
+				x0 = veorq_u64(veorq_u64(x0, x1), veorq_u64(x2, x3));
+				while (size >= 16) {
+					x0 = veorq_u64(FoldPMULL(x0, k), PRIV_CRC_LOAD(data));
+					data += 16;
+					size -= 16;
+				}
+				vst1q_u8(remainder, vreinterpretq_u8_u64(x0));
+			}
+
+#undef PRIV_CRC_LOAD
+
+#else
+
+			sl_bool IsSupportedFold() noexcept
+			{
+				return sl_false;
+			}
+
+			void Fold(sl_uint32 state, const sl_uint8* data, sl_size size, const sl_uint64* constants, sl_uint8* remainder) noexcept
+			{
+			}
+
+#endif
+
+#undef FOLD_128
+#undef FOLD_256
+#undef FOLD_384
+#undef FOLD_512
+#undef FOLD_1024
+#undef FOLD_1536
+#undef FOLD_2048
+
+			// Multiplies the polynomials `a` and `b` modulo P, in the reflected representation (x^0 is the bit 31)
+			static sl_uint32 MultiplyModP(sl_uint32 a, sl_uint32 b, sl_uint32 polynomial) noexcept
+			{
+				sl_uint32 m = (sl_uint32)1 << 31;
+				sl_uint32 p = 0;
+				for (;;) {
+					if (a & m) {
+						p ^= b;
+						if (!(a & (m - 1))) {
+							break;
+						}
+					}
+					m >>= 1;
+					b = (b & 1) ? ((b >> 1) ^ polynomial) : (b >> 1);
+				}
+				return p;
+			}
+
+			sl_uint32 Combine(sl_uint32 crc1, sl_uint32 crc2, sl_uint64 len2, sl_uint32 polynomial) noexcept
+			{
+				// crc1 * x^(8 * len2) mod P
+				sl_uint32 p = (sl_uint32)1 << 31;
+				sl_uint32 x = (sl_uint32)1 << 23; // x^8
+				while (len2) {
+					if (len2 & 1) {
+						p = MultiplyModP(x, p, polynomial);
+					}
+					len2 >>= 1;
+					if (len2) {
+						x = MultiplyModP(x, x, polynomial);
+					}
+				}
+				if (!crc1) {
+					return crc2;
+				}
+				return MultiplyModP(p, crc1, polynomial) ^ crc2;
+			}
+
+		}
+	}
+
+}
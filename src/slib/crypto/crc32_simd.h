@@ -0,0 +1,64 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CRYPTO_CRC32_SIMD
+#define CHECKHEADER_SLIB_CRYPTO_CRC32_SIMD
+
+#include "slib/crypto/definition.h"
+
+/*
+	Carry-less multiplication folding of the reflected CRC-32 polynomials (PCLMULQDQ, VPCLMULQDQ, ARMv8 PMULL),
+	and combining of the CRCs of adjacent buffers
+
+	`state` is the internal register of CRC, which is the complement of the CRC value.
+*/
+
+// Minimum size of the buffer that is worth folding
+#define PRIV_CRC32_FOLD_MIN_SIZE 256
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace crc32_simd
+		{
+
+			// Folding constants (x^(D+32) mod P, x^(D-32) mod P) for the distances D = 128, 256, 384, 512, 1024, 1536, 2048 bits
+			extern const sl_uint64 g_foldConstantsCrc32[14];
+			extern const sl_uint64 g_foldConstantsCrc32c[14];
+
+			sl_bool IsSupportedFold() noexcept;
+
+			// `size`: multiple of 16, at least 64 bytes
+			// `remainder`: 16 bytes, whose CRC computed from zero state is the state after `data`
+			void Fold(sl_uint32 state, const sl_uint8* data, sl_size size, const sl_uint64* constants, sl_uint8* remainder) noexcept;
+
+			// `polynomial`: reflected polynomial. Returns CRC of (A || B) from `crc1` = CRC(A), `crc2` = CRC(B), `len2` = length of B
+			sl_uint32 Combine(sl_uint32 crc1, sl_uint32 crc2, sl_uint64 len2, sl_uint32 polynomial) noexcept;
+
+		}
+	}
+
+}
+
+#endif
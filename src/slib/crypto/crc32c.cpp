@@ -26,6 +26,8 @@
 #include "slib/core/cpu.h"
 #include "slib/core/memory.h"
 
+#include "crc32_simd.h"
+
 /*
  
  Extracted from https://github.com/google/crc32c
@@ -663,9 +665,8 @@ namespace slib
 			}
 #endif
 			
-			static sl_uint32 extend(sl_uint32 crc, const void* _data, sl_size count)
+			static sl_uint32 extendScalar(sl_uint32 crc, const sl_uint8* data, sl_size count)
 			{
-				const sl_uint8* data = (const sl_uint8*)_data;
 #if defined(SUPPORT_SSE42)
 				if (Cpu::isSupportedSSE42()) {
 					return sse42::extendSse42(crc, data, count);
@@ -673,6 +674,32 @@ namespace slib
 #endif
 				return extendPortable(crc, data, count);
 			}
+
+			// The 3-way `crc32` instruction path is as fast as 128-bit folding, so SSE4.2 machines fold only the large buffers with 512-bit registers (0: no folding)
+			static sl_size GetFoldingMinSize()
+			{
+#if defined(SUPPORT_SSE42)
+				if (Cpu::isSupportedSSE42()) {
+					return Cpu::isSupportedVPCLMUL() ? 1024 : 0;
+				}
+#endif
+				return crc32_simd::IsSupportedFold() ? PRIV_CRC32_FOLD_MIN_SIZE : 0;
+			}
+
+			static sl_uint32 extend(sl_uint32 crc, const void* _data, sl_size count)
+			{
+				const sl_uint8* data = (const sl_uint8*)_data;
+				static sl_size sizeMinFolding = GetFoldingMinSize();
+				if (sizeMinFolding && count >= sizeMinFolding) {
+					sl_size n = count & ~((sl_size)15);
+					sl_uint8 remainder[16];
+					crc32_simd::Fold(crc ^ kCRC32Xor, data, n, crc32_simd::g_foldConstantsCrc32c, remainder);
+					crc = extendScalar(kCRC32Xor, remainder, 16);
+					data += n;
+					count -= n;
+				}
+				return extendScalar(crc, data, count);
+			}
 			
 		}
 	}
@@ -697,4 +724,9 @@ namespace slib
 		return priv::crc32c::extend(0, mem.data, mem.size);
 	}
 
+	sl_uint32 Crc32c::combine(sl_uint32 crc1, sl_uint32 crc2, sl_uint64 len2)
+	{
+		return priv::crc32_simd::Combine(crc1, crc2, len2, 0x82f63b78);
+	}
+
 }
@@ -26,6 +26,9 @@
 
 #include "slib/core/string_buffer.h"
 #include "slib/core/math.h"
+#include "slib/core/mio.h"
+#include "slib/core/hash_map.h"
+#include "slib/core/scoped_buffer.h"
 #include "slib/core/safe_static.h"
 
 namespace slib
@@ -89,6 +92,7 @@ namespace slib
 				Curve_secp112r2()
 				{
 					id = EllipticCurveId::secp112r2;
+					h = 4;
 					static const sl_uint8 _p[] = {
 						0xDB, 0x7C, 0x2A, 0xBF, 0x62, 0xE3, 0x5E, 0x66,
 						0x80, 0x76, 0xBE, 0xAD, 0x20, 0x8B
@@ -183,6 +187,7 @@ namespace slib
 				Curve_secp128r2()
 				{
 					id = EllipticCurveId::secp128r2;
+					h = 4;
 					static const sl_uint8 _p[] = {
 						0xFF, 0xFF, 0xFF, 0xFD, 0xFF, 0xFF, 0xFF, 0xFF,
 						0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
@@ -639,6 +644,1061 @@ namespace slib
 				}
 			};
 
+#if defined(SLIB_COMPILER_IS_GCC) && defined(__SIZEOF_INT128__)
+#	define PRIV_SLIB_ECC_UINT128
+#endif
+
+#define G_TABLE_WINDOW_BITS 4
+#define G_TABLE_WINDOW_SIZE 15
+#define G_WNAF_BITS 7
+#define G_WNAF_TABLE_SIZE 32
+#define POINT_WNAF_BITS 5
+#define POINT_WNAF_TABLE_SIZE 8
+
+			// (hi, lo) = a * b + c + d
+			SLIB_INLINE static void MulAdd(sl_uint64& hi, sl_uint64& lo, sl_uint64 a, sl_uint64 b, sl_uint64 c, sl_uint64 d) noexcept
+			{
+#ifdef PRIV_SLIB_ECC_UINT128
+				unsigned __int128 m = (unsigned __int128)a * b + c + d;
+				hi = (sl_uint64)(m >> 64);
+				lo = (sl_uint64)m;
+#else
+				sl_uint64 h, l;
+				Math::mul64(a, b, h, l);
+				l += c;
+				h += l < c;
+				l += d;
+				h += l < d;
+				hi = h;
+				lo = l;
+#endif
+			}
+
+			SLIB_INLINE static sl_uint64 AddCarry(sl_uint64 a, sl_uint64 b, sl_uint64& carry) noexcept
+			{
+				sl_uint64 s = a + carry;
+				sl_uint64 c = s < carry;
+				sl_uint64 r = s + b;
+				carry = c + (r < b);
+				return r;
+			}
+
+			SLIB_INLINE static sl_uint64 SubBorrow(sl_uint64 a, sl_uint64 b, sl_uint64& borrow) noexcept
+			{
+				sl_uint64 d = a - b;
+				sl_uint64 c = a < b;
+				sl_uint64 r = d - borrow;
+				borrow = c + (d < borrow);
+				return r;
+			}
+
+			// All bits are set when `v` is zero
+			SLIB_INLINE static sl_uint64 GetZeroMask(sl_uint64 v) noexcept
+			{
+				return (sl_uint64)0 - (((v | ((sl_uint64)0 - v)) >> 63) ^ 1);
+			}
+
+			template <sl_uint32 N>
+			static void ToLimbs(sl_uint64* r, const BigInt& a) noexcept
+			{
+				sl_uint8 buf[N << 3];
+				a.getBytesLE(buf, sizeof(buf));
+				for (sl_uint32 i = 0; i < N; i++) {
+					r[i] = MIO::readUint64LE(buf + (i << 3));
+				}
+			}
+
+			template <sl_uint32 N>
+			static BigInt FromLimbs(const sl_uint64* a) noexcept
+			{
+				sl_uint8 buf[N << 3];
+				for (sl_uint32 i = 0; i < N; i++) {
+					MIO::writeUint64LE(buf + (i << 3), a[i]);
+				}
+				return BigInt::fromBytesLE(buf, sizeof(buf));
+			}
+
+			template <sl_uint32 N>
+			static void Select(sl_uint64* r, const sl_uint64* a, sl_uint64 mask) noexcept
+			{
+				for (sl_uint32 i = 0; i < N; i++) {
+					r[i] = (a[i] & mask) | (r[i] & ~mask);
+				}
+			}
+
+			// Field elements of `N` 64-bit limbs in Montgomery form (a * R mod p, R = 2^(64N)). Arithmetic does not branch on the values
+			template <sl_uint32 N>
+			class MontgomeryField
+			{
+			public:
+				sl_uint64 p[N];
+				sl_uint64 k0; // -p^(-1) mod 2^64
+				sl_uint64 one[N]; // R mod p
+				sl_uint64 r2[N]; // R^2 mod p
+				BigInt P;
+
+			public:
+				sl_bool initialize(const BigInt& _p) noexcept
+				{
+					if (_p.getSign() < 0 || _p.isEven()) {
+						return sl_false;
+					}
+					sl_size nBits = _p.getMostSignificantBits();
+					if (nBits < 2 || nBits > (N << 6)) {
+						return sl_false;
+					}
+					P = _p;
+					ToLimbs<N>(p, _p);
+					// Newton's iteration doubles the number of correct bits (p * p = 1 mod 8)
+					sl_uint64 inv = p[0];
+					for (sl_uint32 i = 0; i < 5; i++) {
+						inv *= 2 - p[0] * inv;
+					}
+					k0 = (sl_uint64)0 - inv;
+					BigInt R = BigInt::mod(BigInt::shiftLeft(BigInt::fromUint32(1), N << 6), _p, sl_true);
+					ToLimbs<N>(one, R);
+					ToLimbs<N>(r2, BigInt::mod(R * R, _p, sl_true));
+					return sl_true;
+				}
+
+				// r = a * b / R mod p (CIOS)
+				void mul(sl_uint64* r, const sl_uint64* a, const sl_uint64* b) const noexcept
+				{
+					sl_uint64 t[N + 2];
+					sl_uint32 i, j;
+					for (i = 0; i < N + 2; i++) {
+						t[i] = 0;
+					}
+					for (i = 0; i < N; i++) {
+						sl_uint64 c = 0;
+						for (j = 0; j < N; j++) {
+							MulAdd(c, t[j], a[j], b[i], t[j], c);
+						}
+						sl_uint64 s = t[N] + c;
+						t[N + 1] = s < c;
+						t[N] = s;
+						sl_uint64 m = t[0] * k0;
+						sl_uint64 lo;
+						MulAdd(c, lo, m, p[0], t[0], 0);
+						for (j = 1; j < N; j++) {
+							MulAdd(c, t[j - 1], m, p[j], t[j], c);
+						}
+						s = t[N] + c;
+						t[N - 1] = s;
+						t[N] = t[N + 1] + (s < c);
+					}
+					_reduce(r, t, t[N]);
+				}
+
+				void sqr(sl_uint64* r, const sl_uint64* a) const noexcept
+				{
+					mul(r, a, a);
+				}
+
+				void add(sl_uint64* r, const sl_uint64* a, const sl_uint64* b) const noexcept
+				{
+					sl_uint64 t[N];
+					sl_uint64 carry = 0;
+					for (sl_uint32 i = 0; i < N; i++) {
+						t[i] = AddCarry(a[i], b[i], carry);
+					}
+					_reduce(r, t, carry);
+				}
+
+				void sub(sl_uint64* r, const sl_uint64* a, const sl_uint64* b) const noexcept
+				{
+					sl_uint64 t[N];
+					sl_uint64 borrow = 0;
+					sl_uint32 i;
+					for (i = 0; i < N; i++) {
+						t[i] = SubBorrow(a[i], b[i], borrow);
+					}
+					sl_uint64 mask = (sl_uint64)0 - borrow;
+					sl_uint64 carry = 0;
+					for (i = 0; i < N; i++) {
+						r[i] = AddCarry(t[i], p[i] & mask, carry);
+					}
+				}
+
+				void neg(sl_uint64* r, const sl_uint64* a) const noexcept
+				{
+					sl_uint64 zero[N] = { 0 };
+					sub(r, zero, a);
+				}
+
+				sl_uint64 getZeroMask(const sl_uint64* a) const noexcept
+				{
+					sl_uint64 v = 0;
+					for (sl_uint32 i = 0; i < N; i++) {
+						v |= a[i];
+					}
+					return GetZeroMask(v);
+				}
+
+				sl_bool isZero(const sl_uint64* a) const noexcept
+				{
+					return getZeroMask(a) != 0;
+				}
+
+				sl_bool equals(const sl_uint64* a, const sl_uint64* b) const noexcept
+				{
+					sl_uint64 v = 0;
+					for (sl_uint32 i = 0; i < N; i++) {
+						v |= a[i] ^ b[i];
+					}
+					return !v;
+				}
+
+				// r = a^(p-2) = a^(-1). The exponent is public, so the time does not depend on `a`
+				void inverse(sl_uint64* r, const sl_uint64* a) const noexcept
+				{
+					sl_uint64 e[N];
+					sl_uint64 borrow = 2;
+					sl_uint32 i;
+					for (i = 0; i < N; i++) {
+						e[i] = SubBorrow(p[i], 0, borrow);
+					}
+					sl_uint64 t[N];
+					for (i = 0; i < N; i++) {
+						t[i] = one[i];
+					}
+					sl_uint32 k = (N << 6);
+					while (k--) {
+						sqr(t, t);
+						if ((e[k >> 6] >> (k & 63)) & 1) {
+							mul(t, t, a);
+						}
+					}
+					for (i = 0; i < N; i++) {
+						r[i] = t[i];
+					}
+				}
+
+				void toMontgomery(sl_uint64* r, const BigInt& a) const noexcept
+				{
+					sl_uint64 t[N];
+					if (a.getSign() < 0 || a >= P) {
+						ToLimbs<N>(t, BigInt::mod(a, P, sl_true));
+					} else {
+						ToLimbs<N>(t, a);
+					}
+					mul(r, t, r2);
+				}
+
+				BigInt fromMontgomery(const sl_uint64* a) const noexcept
+				{
+					sl_uint64 t[N] = { 1 };
+					sl_uint64 r[N];
+					mul(r, a, t);
+					return FromLimbs<N>(r);
+				}
+
+			private:
+				// r = t mod p, where t = (carry, t[0..N-1]) < 2p
+				void _reduce(sl_uint64* r, const sl_uint64* t, sl_uint64 carry) const noexcept
+				{
+					sl_uint64 d[N];
+					sl_uint64 borrow = 0;
+					sl_uint32 i;
+					for (i = 0; i < N; i++) {
+						d[i] = SubBorrow(t[i], p[i], borrow);
+					}
+					sl_uint64 mask = (sl_uint64)0 - ((carry | (borrow ^ 1)) & 1);
+					for (i = 0; i < N; i++) {
+						r[i] = (d[i] & mask) | (t[i] & ~mask);
+					}
+				}
+
+			};
+
+			// Computes wNAF digits (odd digits in (-2^(w-1), 2^(w-1)) separated by at least w-1 zeros). Returns the number of digits
+			static sl_uint32 GetWNAF(sl_int8* naf, const BigInt& k, sl_uint32 w) noexcept
+			{
+				sl_size nLimbs = ((k.getMostSignificantBits() + 63) >> 6) + 1;
+				SLIB_SCOPED_BUFFER(sl_uint64, 16, t, nLimbs)
+				if (!t) {
+					return 0;
+				}
+				{
+					SLIB_SCOPED_BUFFER(sl_uint8, 128, buf, nLimbs << 3)
+					if (!buf) {
+						return 0;
+					}
+					k.getBytesLE(buf, nLimbs << 3);
+					for (sl_size i = 0; i < nLimbs; i++) {
+						t[i] = MIO::readUint64LE(buf + (i << 3));
+					}
+				}
+				sl_int32 window = 1 << w;
+				sl_int32 half = window >> 1;
+				sl_uint32 n = 0;
+				for (;;) {
+					sl_size i;
+					sl_uint64 v = 0;
+					for (i = 0; i < nLimbs; i++) {
+						v |= t[i];
+					}
+					if (!v) {
+						break;
+					}
+					sl_int32 d = 0;
+					if (t[0] & 1) {
+						d = (sl_int32)(t[0] & (window - 1));
+						if (d >= half) {
+							d -= window;
+						}
+						if (d > 0) {
+							sl_uint64 borrow = 0;
+							t[0] = SubBorrow(t[0], (sl_uint64)d, borrow);
+							for (i = 1; i < nLimbs && borrow; i++) {
+								t[i] = SubBorrow(t[i], 0, borrow);
+							}
+						} else {
+							sl_uint64 carry = 0;
+							t[0] = AddCarry(t[0], (sl_uint64)(-d), carry);
+							for (i = 1; i < nLimbs && carry; i++) {
+								t[i] = AddCarry(t[i], 0, carry);
+							}
+						}
+					}
+					naf[n++] = (sl_int8)d;
+					for (i = 0; i + 1 < nLimbs; i++) {
+						t[i] = (t[i] >> 1) | (t[i + 1] << 63);
+					}
+					t[nLimbs - 1] >>= 1;
+				}
+				return n;
+			}
+
+			class EcEngine : public Referable
+			{
+			public:
+				BigInt p;
+				BigInt a;
+				BigInt b;
+				BigInt n;
+				ECPoint G;
+				sl_uint32 h;
+
+			public:
+				sl_bool isMatched(const EllipticCurve& curve) const noexcept
+				{
+					return p == curve.p && a == curve.a && b == curve.b && n == curve.n && G.x == curve.G.x && G.y == curve.G.y && h == curve.h;
+				}
+
+			public:
+				// Constant-time for `k`
+				virtual ECPoint multiplyPoint(const ECPoint& pt, const BigInt& k) noexcept = 0;
+
+				// Constant-time for `k`
+				virtual ECPoint multiplyG(const BigInt& k) noexcept = 0;
+
+				// k1 * G + k2 * pt (variable-time)
+				virtual ECPoint multiplyGAndPoint(const BigInt& k1, const ECPoint& pt, const BigInt& k2) noexcept = 0;
+
+				// Checks (k1 * G + k2 * pt).x mod n == r without converting to affine coordinates (variable-time)
+				virtual sl_bool verifyX(const BigInt& k1, const ECPoint& pt, const BigInt& k2, const BigInt& r) noexcept = 0;
+
+			};
+
+			template <sl_uint32 N>
+			class EcEngineImpl : public EcEngine
+			{
+			public:
+				struct JPoint
+				{
+					sl_uint64 x[N];
+					sl_uint64 y[N];
+					sl_uint64 z[N]; // Infinity when z == 0
+				};
+
+				struct APoint
+				{
+					sl_uint64 x[N];
+					sl_uint64 y[N];
+				};
+
+				enum class CoefficientA
+				{
+					General,
+					Zero,
+					Minus3
+				};
+
+			public:
+				MontgomeryField<N> F;
+				sl_uint64 m_a[N];
+				CoefficientA m_typeA;
+				sl_uint32 m_nBitsOrder;
+				APoint m_g;
+
+				// m_tableG[i * 15 + j - 1] = j * 16^i * G
+				APoint* m_tableG;
+				sl_uint32 m_nWindowsG;
+				// m_oddG[i] = (2i + 1) * G
+				APoint m_oddG[G_WNAF_TABLE_SIZE];
+
+			public:
+				EcEngineImpl() noexcept: m_tableG(sl_null), m_nWindowsG(0) {}
+
+				~EcEngineImpl()
+				{
+					if (m_tableG) {
+						delete[] m_tableG;
+					}
+				}
+
+			public:
+				static Ref<EcEngine> create(const EllipticCurve& curve, sl_bool flagPrecompute) noexcept
+				{
+					Ref<EcEngineImpl> ret = new EcEngineImpl;
+					if (ret.isNotNull()) {
+						if (ret->_initialize(curve, flagPrecompute)) {
+							return Ref<EcEngine>::from(ret);
+						}
+					}
+					return sl_null;
+				}
+
+			public:
+				ECPoint multiplyPoint(const ECPoint& pt, const BigInt& k) noexcept override
+				{
+					if (pt.isO() || k.isZero()) {
+						return ECPoint();
+					}
+					sl_size nBits = k.getMostSignificantBits();
+					if (nBits < m_nBitsOrder) {
+						nBits = m_nBitsOrder;
+					}
+					sl_size nWindows = (nBits + 3) >> 2;
+					SLIB_SCOPED_BUFFER(sl_uint8, 128, bytes, (nWindows + 1) >> 1)
+					if (!bytes) {
+						return ECPoint();
+					}
+					k.getBytesLE(bytes, (nWindows + 1) >> 1);
+					// table[i] = i * pt
+					JPoint table[16];
+					_setInfinity(table[0]);
+					_fromPoint(table[1], pt);
+					_double(table[2], table[1]);
+					sl_uint32 i;
+					for (i = 3; i < 16; i++) {
+						_add(table[i], table[i - 1], table[1]);
+					}
+					JPoint acc, q;
+					_setInfinity(acc);
+					sl_size iWindow = nWindows;
+					while (iWindow--) {
+						for (i = 0; i < 4; i++) {
+							_double(acc, acc);
+						}
+						sl_uint32 digit = (bytes[iWindow >> 1] >> ((iWindow & 1) << 2)) & 15;
+						_selectJacobian(q, table, 16, digit);
+						_addConstantTime(acc, acc, q);
+					}
+					return _toPoint(acc);
+				}
+
+				ECPoint multiplyG(const BigInt& _k) noexcept override
+				{
+					if (!m_tableG) {
+						return multiplyPoint(G, _k);
+					}
+					BigInt k = _k;
+					if (k.getSign() < 0 || k >= n) {
+						k = BigInt::mod(k, n, sl_true);
+					}
+					SLIB_SCOPED_BUFFER(sl_uint8, 128, bytes, (m_nWindowsG + 1) >> 1)
+					if (!bytes) {
+						return ECPoint();
+					}
+					k.getBytesLE(bytes, (m_nWindowsG + 1) >> 1);
+					JPoint acc;
+					_setInfinity(acc);
+					APoint q;
+					for (sl_uint32 i = 0; i < m_nWindowsG; i++) {
+						sl_uint32 digit = (bytes[i >> 1] >> ((i & 1) << 2)) & 15;
+						_selectAffine(q, m_tableG + i * G_TABLE_WINDOW_SIZE, G_TABLE_WINDOW_SIZE, digit);
+						_addMixedConstantTime(acc, acc, q, ~GetZeroMask(digit));
+					}
+					return _toPoint(acc);
+				}
+
+				ECPoint multiplyGAndPoint(const BigInt& k1, const ECPoint& pt, const BigInt& k2) noexcept override
+				{
+					JPoint acc;
+					if (_multiplyGAndPoint(acc, k1, pt, k2)) {
+						return _toPoint(acc);
+					}
+					return ECPoint();
+				}
+
+				sl_bool verifyX(const BigInt& k1, const ECPoint& pt, const BigInt& k2, const BigInt& r) noexcept override
+				{
+					JPoint acc;
+					if (!(_multiplyGAndPoint(acc, k1, pt, k2))) {
+						return sl_false;
+					}
+					if (F.isZero(acc.z)) {
+						return sl_false;
+					}
+					// x = X / Z^2: checks r * Z^2 == X for every candidate x = r + i * n < p
+					sl_uint64 zz[N], c[N], t[N];
+					F.sqr(zz, acc.z);
+					BigInt x = r;
+					while (x < p) {
+						F.toMontgomery(c, x);
+						F.mul(t, c, zz);
+						if (F.equals(t, acc.x)) {
+							return sl_true;
+						}
+						x = x + n;
+					}
+					return sl_false;
+				}
+
+			private:
+				sl_bool _initialize(const EllipticCurve& curve, sl_bool flagPrecompute) noexcept
+				{
+					if (!(F.initialize(curve.p))) {
+						return sl_false;
+					}
+					if (curve.n.getSign() <= 0 || curve.G.isO()) {
+						return sl_false;
+					}
+					p = curve.p;
+					a = curve.a;
+					b = curve.b;
+					n = curve.n;
+					G = curve.G;
+					h = curve.h;
+					m_nBitsOrder = (sl_uint32)(n.getMostSignificantBits());
+					F.toMontgomery(m_a, a);
+					if (F.isZero(m_a)) {
+						m_typeA = CoefficientA::Zero;
+					} else if (BigInt::mod(a + 3, p, sl_true).isZero()) {
+						m_typeA = CoefficientA::Minus3;
+					} else {
+						m_typeA = CoefficientA::General;
+					}
+					F.toMontgomery(m_g.x, G.x);
+					F.toMontgomery(m_g.y, G.y);
+					if (flagPrecompute) {
+						return _precomputeG();
+					}
+					return sl_true;
+				}
+
+				sl_bool _precomputeG() noexcept
+				{
+					sl_uint32 nWindows = (m_nBitsOrder + G_TABLE_WINDOW_BITS - 1) / G_TABLE_WINDOW_BITS;
+					sl_uint32 nPoints = nWindows * G_TABLE_WINDOW_SIZE;
+					JPoint* points = new JPoint[nPoints + G_WNAF_TABLE_SIZE];
+					if (!points) {
+						return sl_false;
+					}
+					APoint* table = new APoint[nPoints];
+					if (!table) {
+						delete[] points;
+						return sl_false;
+					}
+					JPoint base;
+					_fromAffine(base, m_g);
+					sl_uint32 i, j;
+					for (i = 0; i < nWindows; i++) {
+						JPoint* row = points + i * G_TABLE_WINDOW_SIZE;
+						row[0] = base;
+						for (j = 1; j < G_TABLE_WINDOW_SIZE; j++) {
+							_add(row[j], row[j - 1], base);
+						}
+						_double(base, row[7]); // 16 * base
+					}
+					JPoint* odd = points + nPoints;
+					_fromAffine(odd[0], m_g);
+					JPoint g2;
+					_double(g2, odd[0]);
+					for (i = 1; i < G_WNAF_TABLE_SIZE; i++) {
+						_add(odd[i], odd[i - 1], g2);
+					}
+					sl_bool bRet = _normalize(points, nPoints + G_WNAF_TABLE_SIZE);
+					if (bRet) {
+						for (i = 0; i < nPoints; i++) {
+							_toAffine(table[i], points[i]);
+						}
+						for (i = 0; i < G_WNAF_TABLE_SIZE; i++) {
+							_toAffine(m_oddG[i], odd[i]);
+						}
+						m_tableG = table;
+						m_nWindowsG = nWindows;
+					} else {
+						delete[] table;
+					}
+					delete[] points;
+					return bRet;
+				}
+
+				sl_bool _multiplyGAndPoint(JPoint& acc, const BigInt& k1, const ECPoint& pt, const BigInt& k2) noexcept
+				{
+					_setInfinity(acc);
+					if (k1.getSign() < 0 || k2.getSign() < 0) {
+						return sl_false;
+					}
+					sl_bool flagPoint = k2.isNotZero() && !(pt.isO());
+					sl_uint32 wG = m_tableG ? G_WNAF_BITS : POINT_WNAF_BITS;
+					SLIB_SCOPED_BUFFER(sl_int8, 1024, naf1, k1.getMostSignificantBits() + 1)
+					SLIB_SCOPED_BUFFER(sl_int8, 1024, naf2, k2.getMostSignificantBits() + 1)
+					if (!naf1 || !naf2) {
+						return sl_false;
+					}
+					sl_uint32 n1 = GetWNAF(naf1, k1, wG);
+					sl_uint32 n2 = flagPoint ? GetWNAF(naf2, k2, POINT_WNAF_BITS) : 0;
+					// Odd multiples of the points
+					JPoint tablePoint[POINT_WNAF_TABLE_SIZE];
+					JPoint tableG[POINT_WNAF_TABLE_SIZE];
+					if (flagPoint) {
+						_fromPoint(tablePoint[0], pt);
+						_makeOddMultiples(tablePoint);
+					}
+					if (!m_tableG && n1) {
+						_fromAffine(tableG[0], m_g);
+						_makeOddMultiples(tableG);
+					}
+					// Shamir's trick: the doublings are shared by both scalars
+					sl_uint32 i = n1 > n2 ? n1 : n2;
+					while (i--) {
+						_double(acc, acc);
+						if (i < n1) {
+							sl_int32 d = naf1[i];
+							if (d) {
+								if (m_tableG) {
+									_addWNAF(acc, m_oddG, d);
+								} else {
+									_addWNAF(acc, tableG, d);
+								}
+							}
+						}
+						if (i < n2) {
+							sl_int32 d = naf2[i];
+							if (d) {
+								_addWNAF(acc, tablePoint, d);
+							}
+						}
+					}
+					return sl_true;
+				}
+
+				void _makeOddMultiples(JPoint* table) noexcept
+				{
+					JPoint t2;
+					_double(t2, table[0]);
+					for (sl_uint32 i = 1; i < POINT_WNAF_TABLE_SIZE; i++) {
+						_add(table[i], table[i - 1], t2);
+					}
+				}
+
+				void _addWNAF(JPoint& acc, const APoint* table, sl_int32 d) noexcept
+				{
+					if (d > 0) {
+						_addMixed(acc, acc, table[d >> 1]);
+					} else {
+						APoint q = table[(-d) >> 1];
+						F.neg(q.y, q.y);
+						_addMixed(acc, acc, q);
+					}
+				}
+
+				void _addWNAF(JPoint& acc, const JPoint* table, sl_int32 d) noexcept
+				{
+					if (d > 0) {
+						_add(acc, acc, table[d >> 1]);
+					} else {
+						JPoint q = table[(-d) >> 1];
+						F.neg(q.y, q.y);
+						_add(acc, acc, q);
+					}
+				}
+
+				void _setInfinity(JPoint& r) noexcept
+				{
+					for (sl_uint32 i = 0; i < N; i++) {
+						r.x[i] = F.one[i];
+						r.y[i] = F.one[i];
+						r.z[i] = 0;
+					}
+				}
+
+				void _fromAffine(JPoint& r, const APoint& q) noexcept
+				{
+					for (sl_uint32 i = 0; i < N; i++) {
+						r.x[i] = q.x[i];
+						r.y[i] = q.y[i];
+						r.z[i] = F.one[i];
+					}
+				}
+
+				void _fromPoint(JPoint& r, const ECPoint& pt) noexcept
+				{
+					F.toMontgomery(r.x, pt.x);
+					F.toMontgomery(r.y, pt.y);
+					for (sl_uint32 i = 0; i < N; i++) {
+						r.z[i] = F.one[i];
+					}
+				}
+
+				// `q` must not be infinity
+				void _toAffine(APoint& r, const JPoint& q) noexcept
+				{
+					sl_uint64 zInv[N], zInv2[N];
+					F.inverse(zInv, q.z);
+					F.sqr(zInv2, zInv);
+					F.mul(r.x, q.x, zInv2);
+					F.mul(zInv2, zInv2, zInv);
+					F.mul(r.y, q.y, zInv2);
+				}
+
+				ECPoint _toPoint(const JPoint& q) noexcept
+				{
+					if (F.isZero(q.z)) {
+						return ECPoint();
+					}
+					APoint t;
+					_toAffine(t, q);
+					ECPoint ret;
+					ret.x = F.fromMontgomery(t.x);
+					ret.y = F.fromMontgomery(t.y);
+					return ret;
+				}
+
+				// Sets z = 1 for all points by one inversion (Montgomery's trick)
+				sl_bool _normalize(JPoint* points, sl_uint32 nPoints) noexcept
+				{
+					if (!nPoints) {
+						return sl_true;
+					}
+					typedef sl_uint64 Element[N];
+					Element* prefix = new Element[nPoints];
+					if (!prefix) {
+						return sl_false;
+					}
+					sl_uint32 i, j;
+					for (j = 0; j < N; j++) {
+						prefix[0][j] = points[0].z[j];
+					}
+					for (i = 1; i < nPoints; i++) {
+						F.mul(prefix[i], prefix[i - 1], points[i].z);
+					}
+					sl_uint64 inv[N], zInv[N], zInv2[N];
+					F.inverse(inv, prefix[nPoints - 1]);
+					i = nPoints;
+					while (i--) {
+						JPoint& pt = points[i];
+						if (i) {
+							F.mul(zInv, inv, prefix[i - 1]);
+							F.mul(inv, inv, pt.z);
+						} else {
+							for (j = 0; j < N; j++) {
+								zInv[j] = inv[j];
+							}
+						}
+						F.sqr(zInv2, zInv);
+						F.mul(pt.x, pt.x, zInv2);
+						F.mul(zInv2, zInv2, zInv);
+						F.mul(pt.y, pt.y, zInv2);
+						for (j = 0; j < N; j++) {
+							pt.z[j] = F.one[j];
+						}
+					}
+					delete[] prefix;
+					return sl_true;
+				}
+
+				void _selectAffine(APoint& r, const APoint* table, sl_uint32 nTable, sl_uint32 index) noexcept
+				{
+					// Scans all entries: table[i - 1] for index i, zero for index 0
+					sl_uint32 i;
+					for (i = 0; i < N; i++) {
+						r.x[i] = 0;
+						r.y[i] = 0;
+					}
+					for (i = 0; i < nTable; i++) {
+						sl_uint64 mask = GetZeroMask((sl_uint64)(i + 1) ^ index);
+						Select<N>(r.x, table[i].x, mask);
+						Select<N>(r.y, table[i].y, mask);
+					}
+				}
+
+				void _selectJacobian(JPoint& r, const JPoint* table, sl_uint32 nTable, sl_uint32 index) noexcept
+				{
+					r = table[0];
+					for (sl_uint32 i = 1; i < nTable; i++) {
+						sl_uint64 mask = GetZeroMask((sl_uint64)i ^ index);
+						Select<N>(r.x, table[i].x, mask);
+						Select<N>(r.y, table[i].y, mask);
+						Select<N>(r.z, table[i].z, mask);
+					}
+				}
+
+				// dbl-2007-bl. Infinity (z = 0) results in infinity without branch
+				void _double(JPoint& r, const JPoint& q) noexcept
+				{
+					sl_uint64 xx[N], yy[N], yyyy[N], zz[N], s[N], m[N], t[N], t2[N];
+					F.sqr(xx, q.x);
+					F.sqr(yy, q.y);
+					F.sqr(yyyy, yy);
+					F.sqr(zz, q.z);
+					// S = 2 * ((X + YY)^2 - XX - YYYY)
+					F.add(t, q.x, yy);
+					F.sqr(t, t);
+					F.sub(t, t, xx);
+					F.sub(t, t, yyyy);
+					F.add(s, t, t);
+					// M = 3 * XX + a * ZZ^2
+					if (m_typeA == CoefficientA::Minus3) {
+						F.sub(t, q.x, zz);
+						F.add(t2, q.x, zz);
+						F.mul(t, t, t2);
+						F.add(m, t, t);
+						F.add(m, m, t);
+					} else {
+						F.add(m, xx, xx);
+						F.add(m, m, xx);
+						if (m_typeA == CoefficientA::General) {
+							F.sqr(t, zz);
+							F.mul(t, t, m_a);
+							F.add(m, m, t);
+						}
+					}
+					// Z3 = (Y + Z)^2 - YY - ZZ
+					F.add(t, q.y, q.z);
+					F.sqr(t, t);
+					F.sub(t, t, yy);
+					F.sub(r.z, t, zz);
+					// X3 = M^2 - 2 * S
+					F.sqr(t, m);
+					F.sub(t, t, s);
+					F.sub(r.x, t, s);
+					// Y3 = M * (S - X3) - 8 * YYYY
+					F.sub(t, s, r.x);
+					F.mul(t, m, t);
+					F.add(t2, yyyy, yyyy);
+					F.add(t2, t2, t2);
+					F.add(t2, t2, t2);
+					F.sub(r.y, t, t2);
+				}
+
+				// add-2007-bl. Returns sl_false when p1 == p2 or p1 == -p2 (not computed)
+				sl_bool _addRaw(JPoint& r, const JPoint& p1, const JPoint& p2, sl_bool& flagDouble) noexcept
+				{
+					sl_uint64 z1z1[N], z2z2[N], u1[N], u2[N], s1[N], s2[N], h[N], rr[N], i[N], j[N], v[N], t[N];
+					F.sqr(z1z1, p1.z);
+					F.sqr(z2z2, p2.z);
+					F.mul(u1, p1.x, z2z2);
+					F.mul(u2, p2.x, z1z1);
+					F.mul(s1, p1.y, p2.z);
+					F.mul(s1, s1, z2z2);
+					F.mul(s2, p2.y, p1.z);
+					F.mul(s2, s2, z1z1);
+					F.sub(h, u2, u1);
+					F.sub(rr, s2, s1);
+					if (F.isZero(h)) {
+						flagDouble = F.isZero(rr);
+						return sl_false;
+					}
+					F.add(rr, rr, rr);
+					// I = (2 * H)^2, J = H * I, V = U1 * I
+					F.add(i, h, h);
+					F.sqr(i, i);
+					F.mul(j, h, i);
+					F.mul(v, u1, i);
+					// Z3 = ((Z1 + Z2)^2 - Z1Z1 - Z2Z2) * H
+					F.add(t, p1.z, p2.z);
+					F.sqr(t, t);
+					F.sub(t, t, z1z1);
+					F.sub(t, t, z2z2);
+					F.mul(r.z, t, h);
+					// X3 = r^2 - J - 2 * V
+					F.sqr(t, rr);
+					F.sub(t, t, j);
+					F.sub(t, t, v);
+					F.sub(r.x, t, v);
+					// Y3 = r * (V - X3) - 2 * S1 * J
+					F.sub(t, v, r.x);
+					F.mul(t, rr, t);
+					F.mul(s1, s1, j);
+					F.add(s1, s1, s1);
+					F.sub(r.y, t, s1);
+					return sl_true;
+				}
+
+				// madd-2007-bl. Returns sl_false when p1 == p2 or p1 == -p2 (not computed)
+				sl_bool _addMixedRaw(JPoint& r, const JPoint& p1, const APoint& p2, sl_bool& flagDouble) noexcept
+				{
+					sl_uint64 z1z1[N], u2[N], s2[N], h[N], hh[N], i[N], j[N], rr[N], v[N], t[N];
+					F.sqr(z1z1, p1.z);
+					F.mul(u2, p2.x, z1z1);
+					F.mul(s2, p2.y, p1.z);
+					F.mul(s2, s2, z1z1);
+					F.sub(h, u2, p1.x);
+					F.sub(rr, s2, p1.y);
+					if (F.isZero(h)) {
+						flagDouble = F.isZero(rr);
+						return sl_false;
+					}
+					F.add(rr, rr, rr);
+					// HH = H^2, I = 4 * HH, J = H * I, V = X1 * I
+					F.sqr(hh, h);
+					F.add(i, hh, hh);
+					F.add(i, i, i);
+					F.mul(j, h, i);
+					F.mul(v, p1.x, i);
+					// Y1 * J is computed before p1 is overwritten (r may be p1)
+					F.mul(s2, p1.y, j);
+					F.add(s2, s2, s2);
+					// Z3 = (Z1 + H)^2 - Z1Z1 - HH
+					F.add(t, p1.z, h);
+					F.sqr(t, t);
+					F.sub(t, t, z1z1);
+					F.sub(r.z, t, hh);
+					// X3 = r^2 - J - 2 * V
+					F.sqr(t, rr);
+					F.sub(t, t, j);
+					F.sub(t, t, v);
+					F.sub(r.x, t, v);
+					// Y3 = r * (V - X3) - 2 * Y1 * J
+					F.sub(t, v, r.x);
+					F.mul(t, rr, t);
+					F.sub(r.y, t, s2);
+					return sl_true;
+				}
+
+				void _add(JPoint& r, const JPoint& p1, const JPoint& p2) noexcept
+				{
+					if (F.isZero(p1.z)) {
+						r = p2;
+						return;
+					}
+					if (F.isZero(p2.z)) {
+						r = p1;
+						return;
+					}
+					JPoint t;
+					sl_bool flagDouble;
+					if (_addRaw(t, p1, p2, flagDouble)) {
+						r = t;
+					} else if (flagDouble) {
+						_double(r, p1);
+					} else {
+						_setInfinity(r);
+					}
+				}
+
+				void _addMixed(JPoint& r, const JPoint& p1, const APoint& p2) noexcept
+				{
+					if (F.isZero(p1.z)) {
+						_fromAffine(r, p2);
+						return;
+					}
+					JPoint t;
+					sl_bool flagDouble;
+					if (_addMixedRaw(t, p1, p2, flagDouble)) {
+						r = t;
+					} else if (flagDouble) {
+						_double(r, p1);
+					} else {
+						_setInfinity(r);
+					}
+				}
+
+				// The operations do not depend on the infinity of the points. p1 == +-p2 is handled by branch, which happens with negligible probability for random scalars
+				void _addConstantTime(JPoint& r, const JPoint& p1, const JPoint& p2) noexcept
+				{
+					sl_uint64 maskInf1 = F.getZeroMask(p1.z);
+					sl_uint64 maskInf2 = F.getZeroMask(p2.z);
+					JPoint t;
+					sl_bool flagDouble;
+					if (!(_addRaw(t, p1, p2, flagDouble)) && !(maskInf1 | maskInf2)) {
+						if (flagDouble) {
+							_double(t, p1);
+						} else {
+							_setInfinity(t);
+						}
+					}
+					_selectPoint(t, p2, maskInf1);
+					_selectPoint(t, p1, maskInf2);
+					r = t;
+				}
+
+				// `maskValid`: all bits are set when `p2` is used
+				void _addMixedConstantTime(JPoint& r, const JPoint& p1, const APoint& p2, sl_uint64 maskValid) noexcept
+				{
+					sl_uint64 maskInf1 = F.getZeroMask(p1.z);
+					JPoint t;
+					sl_bool flagDouble;
+					if (!(_addMixedRaw(t, p1, p2, flagDouble)) && (maskValid & ~maskInf1)) {
+						if (flagDouble) {
+							_double(t, p1);
+						} else {
+							_setInfinity(t);
+						}
+					}
+					JPoint q;
+					_fromAffine(q, p2);
+					_selectPoint(t, q, maskInf1);
+					_selectPoint(t, p1, ~maskValid);
+					r = t;
+				}
+
+				static void _selectPoint(JPoint& r, const JPoint& q, sl_uint64 mask) noexcept
+				{
+					Select<N>(r.x, q.x, mask);
+					Select<N>(r.y, q.y, mask);
+					Select<N>(r.z, q.z, mask);
+				}
+
+			};
+
+			static Ref<EcEngine> CreateEngine(const EllipticCurve& curve, sl_bool flagPrecompute) noexcept
+			{
+				// `a` is null for the curves of a = 0
+				if (curve.p.isNull() || curve.n.isNull() || curve.G.isO()) {
+					return sl_null;
+				}
+				sl_size nBits = curve.p.getMostSignificantBits();
+				if (nBits <= 256) {
+					return EcEngineImpl<4>::create(curve, flagPrecompute);
+				} else if (nBits <= 384) {
+					return EcEngineImpl<6>::create(curve, flagPrecompute);
+				} else if (nBits <= 576) {
+					return EcEngineImpl<9>::create(curve, flagPrecompute);
+				}
+				return sl_null;
+			}
+
+			// Engines of the named curves are cached with the precomputed tables of G
+			static Ref<EcEngine> GetEngine(const EllipticCurve& curve) noexcept
+			{
+				if (curve.id == EllipticCurveId::Unknown) {
+					return CreateEngine(curve, sl_false);
+				}
+				typedef CHashMap< sl_uint32, Ref<EcEngine> > EngineMap;
+				SLIB_SAFE_LOCAL_STATIC(EngineMap, engines)
+				if (SLIB_SAFE_STATIC_CHECK_FREED(engines)) {
+					return sl_null;
+				}
+				Ref<EcEngine> engine;
+				if (engines.get((sl_uint32)(curve.id), &engine)) {
+					if (engine->isMatched(curve)) {
+						return engine;
+					}
+					return CreateEngine(curve, sl_false);
+				}
+				engine = CreateEngine(curve, sl_true);
+				if (engine.isNotNull()) {
+					engines.put((sl_uint32)(curve.id), engine);
+				}
+				return engine;
+			}
+
 		}
 	}
 
@@ -885,6 +1945,12 @@ namespace slib
 	
 	ECPoint EllipticCurve::multiplyPoint(const ECPoint& pt, const BigInt& _k) const noexcept
 	{
+		if (_k.getSign() >= 0) {
+			Ref<EcEngine> engine = GetEngine(*this);
+			if (engine.isNotNull()) {
+				return engine->multiplyPoint(pt, _k);
+			}
+		}
 		CBigInt* k = _k.ref.get();
 		if (!k) {
 			return ECPoint();
@@ -909,9 +1975,26 @@ namespace slib
 	
 	ECPoint EllipticCurve::multiplyG(const BigInt& _k) const noexcept
 	{
+		if (_k.getSign() >= 0) {
+			Ref<EcEngine> engine = GetEngine(*this);
+			if (engine.isNotNull()) {
+				return engine->multiplyG(_k);
+			}
+		}
 		return multiplyPoint(G, _k);
 	}
 
+	ECPoint EllipticCurve::multiplyGAndPoint(const BigInt& kG, const ECPoint& pt, const BigInt& kPt) const noexcept
+	{
+		if (kG.getSign() >= 0 && kPt.getSign() >= 0) {
+			Ref<EcEngine> engine = GetEngine(*this);
+			if (engine.isNotNull()) {
+				return engine->multiplyGAndPoint(kG, pt, kPt);
+			}
+		}
+		return addPoint(multiplyG(kG), multiplyPoint(pt, kPt));
+	}
+
 	BigInt EllipticCurve::getY(const BigInt& x, sl_bool yBit) const noexcept
 	{	
 		// y ^ 2 = x ^ 3 + ax + b (mod p)
@@ -960,9 +2043,12 @@ namespace slib
 		if (dy.isNotZero()) {
 			return sl_false;
 		}
-		ECPoint nQ = curve.multiplyPoint(Q, curve.n);
-		if (!(nQ.isO())) {
-			return sl_false;
+		// Every point on the curve has the order `n` when the cofactor is 1
+		if (curve.h != 1) {
+			ECPoint nQ = curve.multiplyPoint(Q, curve.n);
+			if (!(nQ.isO())) {
+				return sl_false;
+			}
 		}
 		return sl_true;
 	}
@@ -1156,7 +2242,9 @@ namespace slib
 				}
 				continue;
 			}
-			BigInt k1 = BigInt::inverseMod(k, curve.n);
+			// Blinds `k` by random `b` while inverting: k^(-1) = (k * b)^(-1) * b
+			BigInt b = BigInt::mod(BigInt::random(nBitsOrder), curve.n - 1, sl_true) + 1;
+			BigInt k1 = BigInt::mod(BigInt::inverseMod(BigInt::mod(k * b, curve.n, sl_true), curve.n) * b, curve.n, sl_true);
 			s = BigInt::mod(k1 * (z + r * key.d), curve.n, sl_true);
 			if (s.isZero()) {
 				if (flagInputK) {
@@ -1220,6 +2308,10 @@ namespace slib
 		BigInt s1 = BigInt::inverseMod(signature.s, curve.n);
 		BigInt u1 = BigInt::mod(z * s1, curve.n, sl_true);
 		BigInt u2 = BigInt::mod(signature.r * s1, curve.n, sl_true);
+		Ref<EcEngine> engine = GetEngine(curve);
+		if (engine.isNotNull()) {
+			return engine->verifyX(u1, key.Q, u2, signature.r);
+		}
 		ECPoint p1 = curve.multiplyG(u1);
 		ECPoint p2 = curve.multiplyPoint(key.Q, u2);
 		ECPoint kG = curve.addPoint(p1, p2);
@@ -1229,6 +2321,70 @@ namespace slib
 		return kG.x == signature.r;
 	}
 	
+	sl_bool ECDSA::verifyBatch(const EllipticCurve& curve, const ECPublicKey* keys, const BigInt* z, const ECDSA_Signature* signatures, sl_size nSignatures, sl_bool* outResults) noexcept
+	{
+		if (!nSignatures) {
+			return sl_true;
+		}
+		Ref<EcEngine> engine = GetEngine(curve);
+		if (engine.isNull()) {
+			sl_bool bRet = sl_true;
+			for (sl_size i = 0; i < nSignatures; i++) {
+				sl_bool flag = verify(curve, keys[i], z[i], signatures[i]);
+				if (outResults) {
+					outResults[i] = flag;
+				}
+				bRet = bRet && flag;
+			}
+			return bRet;
+		}
+		const BigInt& n = curve.n;
+		SLIB_SCOPED_BUFFER(BigInt, 16, prefix, nSignatures)
+		SLIB_SCOPED_BUFFER(sl_bool, 64, flags, nSignatures)
+		if (!prefix || !flags) {
+			return sl_false;
+		}
+		sl_size i;
+		// Inverts all `s` by one modular inversion (Montgomery's trick)
+		BigInt product = BigInt::fromUint32(1);
+		for (i = 0; i < nSignatures; i++) {
+			const ECDSA_Signature& signature = signatures[i];
+			sl_bool flag = signature.r.isNotZero() && signature.r < n && signature.s.isNotZero() && signature.s < n;
+			flags[i] = flag;
+			if (flag) {
+				product = BigInt::mod(product * signature.s, n, sl_true);
+			}
+			prefix[i] = product;
+		}
+		BigInt inv = BigInt::inverseMod(product, n);
+		sl_bool bRet = sl_true;
+		i = nSignatures;
+		while (i--) {
+			sl_bool flag = flags[i];
+			if (flag) {
+				const ECDSA_Signature& signature = signatures[i];
+				BigInt s1;
+				if (i) {
+					s1 = BigInt::mod(inv * prefix[i - 1], n, sl_true);
+				} else {
+					s1 = inv;
+				}
+				inv = BigInt::mod(inv * signature.s, n, sl_true);
+				flag = keys[i].checkValid(curve);
+				if (flag) {
+					BigInt u1 = BigInt::mod(z[i] * s1, n, sl_true);
+					BigInt u2 = BigInt::mod(signature.r * s1, n, sl_true);
+					flag = engine->verifyX(u1, keys[i].Q, u2, signature.r);
+				}
+			}
+			if (outResults) {
+				outResults[i] = flag;
+			}
+			bRet = bRet && flag;
+		}
+		return bRet;
+	}
+
 	sl_bool ECDSA::verify(const EllipticCurve& curve, const ECPublicKey& key, const void* hash, sl_size size, const ECDSA_Signature& signature) noexcept
 	{
 		return verify(curve, key, priv::ecdsa::MakeZ(curve, hash, size), signature);
@@ -24,6 +24,8 @@
 
 #include "slib/core/base.h"
 
+#include "aes_hw.h"
+
 namespace slib
 {
 
@@ -62,12 +64,21 @@ namespace slib
 			}
 			i <<= 1;
 		}
+
+		flagCLMUL = priv::aes_hw::IsSupportedGHash();
+		if (flagCLMUL) {
+			priv::aes_hw::GHash_GenerateTable((const sl_uint8*)inH, HP);
+		}
 	}
 
 	void GCM_Table::multiplyH(const void* inX, void* inO) const
 	{
 		const sl_uint8* X = (const sl_uint8*)inX;
 		sl_uint8* O = (sl_uint8*)inO;
+		if (flagCLMUL) {
+			priv::aes_hw::GHash_MultiplyH(HP, X, O);
+			return;
+		}
 		Uint128 Z;
 		
 		static const sl_uint64 R[16] =
@@ -132,6 +143,13 @@ namespace slib
 		sl_size i, k, n;
 
 		n = lenD >> 4;
+		if (flagCLMUL) {
+			if (n) {
+				priv::aes_hw::GHash_MultiplyData(HP, X, D, n);
+				D += n << 4;
+			}
+			n = 0;
+		}
 		for (i = 0; i < n; i++) {
 			for (k = 0; k < 16; k++) {
 				X[k] ^= *D;
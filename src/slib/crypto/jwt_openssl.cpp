@@ -110,8 +110,15 @@ namespace slib
 		if (!s) {
 			return sl_false;
 		}
-		sl_uint32 sizeSig = (sl_uint32)(sig.getSize());
-		switch (getAlgorithm()) {
+		return verifySignature_OpenSSL(key, getAlgorithm(), s, sig.getSize(), data, size);
+	}
+
+	sl_bool Jwt::verifySignature_OpenSSL(const Ref<OpenSSL_Key>& key, JwtAlgorithm algorithm, const void* s, sl_size sizeSig, const void* data, sl_size size) noexcept
+	{
+		if (key.isNull()) {
+			return sl_false;
+		}
+		switch (algorithm) {
 			case JwtAlgorithm::RS256:
 				return key->verify_RSA_SHA256(data, size, s, sizeSig);
 			case JwtAlgorithm::RS384:
@@ -0,0 +1,525 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/crypto/jwt.h"
+
+#include "slib/crypto/base64.h"
+#include "slib/crypto/hmac.h"
+#include "slib/crypto/sha2.h"
+
+#include "slib/core/thread_pool.h"
+#include "slib/core/event.h"
+#include "slib/core/spin_lock.h"
+#include "slib/core/cpu.h"
+#include "slib/core/mio.h"
+#include "slib/core/scoped_buffer.h"
+
+#define CACHE_WAYS 2
+#define CACHE_LOCK_COUNT 64
+#define MAX_SIGNATURE_BASE64_LENGTH 0x4000
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace jwt_verifier
+		{
+
+			SLIB_STATIC_STRING(g_field_exp, "exp")
+			SLIB_STATIC_STRING(g_field_nbf, "nbf")
+
+			class Claims
+			{
+			public:
+				sl_bool flagExp;
+				sl_int64 exp;
+				sl_bool flagNbf;
+				sl_int64 nbf;
+
+			public:
+				Claims(): flagExp(sl_false), exp(0), flagNbf(sl_false), nbf(0) {}
+
+			};
+
+			class CacheEntry
+			{
+			public:
+				sl_bool flagValid;
+				sl_uint8 digest[SHA256::HashSize];
+				Claims claims;
+				sl_int64 tick;
+
+			public:
+				CacheEntry(): flagValid(sl_false), tick(0) {}
+
+			};
+
+			class BatchState : public Referable
+			{
+			public:
+				const StringView* tokens;
+				sl_size count;
+				sl_bool* results;
+				Jwt* jwts;
+
+				volatile sl_reg next;
+				volatile sl_reg nRunning;
+				Ref<Event> event;
+
+			public:
+				BatchState(): next(0), nRunning(0) {}
+
+			};
+
+			template <class HASH>
+			static sl_bool VerifyHMAC(const HMAC<HASH>& base, const void* data, sl_size size, const sl_uint8* signature, sl_size sizeSignature)
+			{
+				if (sizeSignature != HASH::HashSize) {
+					return sl_false;
+				}
+				HMAC<HASH> hmac(base);
+				hmac.update(data, size);
+				sl_uint8 h[HASH::HashSize];
+				hmac.finish(h);
+				// Compares in constant time
+				sl_uint8 d = 0;
+				for (sl_uint32 i = 0; i < HASH::HashSize; i++) {
+					d |= h[i] ^ signature[i];
+				}
+				return !d;
+			}
+
+			static sl_bool ParseJson(const sl_char8* base64, sl_size len, Json& out)
+			{
+				if (!len) {
+					return sl_true;
+				}
+				SLIB_SCOPED_BUFFER(sl_char8, 1024, buf, Base64::getDecodeOutputSize(len));
+				if (!buf) {
+					return sl_false;
+				}
+				sl_size n = Base64::decode(base64, len, buf);
+				if (!n) {
+					return sl_false;
+				}
+				JsonParseParam pp;
+				out = Json::parse(buf, n, pp);
+				return !(pp.flagError);
+			}
+
+			static void GetTimeClaim(const Json& payload, const String& field, sl_bool& flag, sl_int64& value)
+			{
+				Json item = payload.getItem(field);
+				if (item.isNotNull()) {
+					flag = sl_true;
+					value = item.getInt64();
+				}
+			}
+
+			class Context : public Referable
+			{
+			public:
+				JwtAlgorithm algorithm;
+				HMAC<SHA256> hmac256;
+				HMAC<SHA384> hmac384;
+				HMAC<SHA512> hmac512;
+				Ref<OpenSSL_Key> key;
+
+				sl_int64 leeway;
+				sl_bool flagRequireExp;
+
+				Array<CacheEntry> cache;
+				sl_uint32 maskCacheSet;
+				SpinLock lockCache[CACHE_LOCK_COUNT];
+				volatile sl_int64 tick;
+
+				sl_uint32 threadCount;
+				Ref<ThreadPool> threadPool;
+				sl_bool flagOwnThreadPool;
+				SpinLock lockThreadPool;
+
+			public:
+				Context(): algorithm(JwtAlgorithm::None), leeway(0), flagRequireExp(sl_false), maskCacheSet(0), tick(0), threadCount(1), flagOwnThreadPool(sl_false) {}
+
+				~Context()
+				{
+					if (flagOwnThreadPool && threadPool.isNotNull()) {
+						threadPool->release();
+					}
+				}
+
+			public:
+				sl_bool verifySignature(const sl_char8* token, sl_size lenSigned, const sl_char8* base64, sl_size lenBase64)
+				{
+					if (!lenBase64 || lenBase64 > MAX_SIGNATURE_BASE64_LENGTH) {
+						return sl_false;
+					}
+					SLIB_SCOPED_BUFFER(sl_uint8, 1024, signature, Base64::getDecodeOutputSize(lenBase64));
+					if (!signature) {
+						return sl_false;
+					}
+					sl_size sizeSignature = Base64::decode(base64, lenBase64, signature);
+					if (!sizeSignature) {
+						return sl_false;
+					}
+					switch (algorithm) {
+						case JwtAlgorithm::HS256:
+							return VerifyHMAC(hmac256, token, lenSigned, signature, sizeSignature);
+						case JwtAlgorithm::HS384:
+							return VerifyHMAC(hmac384, token, lenSigned, signature, sizeSignature);
+						case JwtAlgorithm::HS512:
+							return VerifyHMAC(hmac512, token, lenSigned, signature, sizeSignature);
+						default:
+							return Jwt::verifySignature_OpenSSL(key, algorithm, signature, sizeSignature, token, lenSigned);
+					}
+				}
+
+				// Checks the signature before parsing any JSON, so the forged tokens cost no parsing
+				// `flagVerifySignature`: sl_false for the tokens found in the cache
+				sl_bool decode(const StringView& token, Jwt& jwt, Claims& claims, sl_bool flagVerifySignature = sl_true)
+				{
+					sl_char8* data = token.getData();
+					sl_reg pos1 = token.indexOf('.');
+					if (pos1 <= 0) {
+						return sl_false;
+					}
+					sl_reg pos2 = token.indexOf('.', pos1 + 1);
+					if (pos2 < 0) {
+						return sl_false;
+					}
+					sl_size len = token.getLength();
+					if (flagVerifySignature) {
+						if (!(verifySignature(data, pos2, data + pos2 + 1, len - pos2 - 1))) {
+							return sl_false;
+						}
+					}
+					if (!(ParseJson(data, pos1, jwt.header))) {
+						return sl_false;
+					}
+					if (jwt.getAlgorithm() != algorithm) {
+						return sl_false;
+					}
+					if (!(ParseJson(data + pos1 + 1, pos2 - pos1 - 1, jwt.payload))) {
+						return sl_false;
+					}
+					GetTimeClaim(jwt.payload, g_field_exp, claims.flagExp, claims.exp);
+					GetTimeClaim(jwt.payload, g_field_nbf, claims.flagNbf, claims.nbf);
+					return sl_true;
+				}
+
+				sl_bool checkTime(const Claims& claims, sl_int64 now)
+				{
+					if (claims.flagExp) {
+						if (now >= claims.exp + leeway) {
+							return sl_false;
+						}
+					} else if (flagRequireExp) {
+						return sl_false;
+					}
+					if (claims.flagNbf) {
+						if (now + leeway < claims.nbf) {
+							return sl_false;
+						}
+					}
+					return sl_true;
+				}
+
+				CacheEntry* getCacheSet(const sl_uint8* digest, SpinLock*& lock)
+				{
+					sl_uint32 index = MIO::readUint32LE(digest) & maskCacheSet;
+					lock = lockCache + (index & (CACHE_LOCK_COUNT - 1));
+					return cache.getData() + index * CACHE_WAYS;
+				}
+
+				// Returns 0 when not found, 1 for the valid token, -1 for the expired token
+				sl_int32 findCache(const sl_uint8* digest, sl_int64 now)
+				{
+					SpinLock* lock;
+					CacheEntry* set = getCacheSet(digest, lock);
+					SpinLocker locker(lock);
+					for (sl_uint32 i = 0; i < CACHE_WAYS; i++) {
+						CacheEntry& entry = set[i];
+						if (entry.flagValid && Base::equalsMemory(entry.digest, digest, SHA256::HashSize)) {
+							if (!(checkTime(entry.claims, now))) {
+								if (entry.claims.flagExp && now >= entry.claims.exp + leeway) {
+									entry.flagValid = sl_false;
+								}
+								return -1;
+							}
+							entry.tick = Base::interlockedIncrement64(&tick);
+							return 1;
+						}
+					}
+					return 0;
+				}
+
+				void putCache(const sl_uint8* digest, const Claims& claims)
+				{
+					SpinLock* lock;
+					CacheEntry* set = getCacheSet(digest, lock);
+					SpinLocker locker(lock);
+					// Replaces the least recently used way
+					CacheEntry* target = set;
+					for (sl_uint32 i = 0; i < CACHE_WAYS; i++) {
+						CacheEntry& entry = set[i];
+						if (!(entry.flagValid)) {
+							target = &entry;
+							break;
+						}
+						if (entry.tick < target->tick) {
+							target = &entry;
+						}
+					}
+					Base::copyMemory(target->digest, digest, SHA256::HashSize);
+					target->claims = claims;
+					target->tick = Base::interlockedIncrement64(&tick);
+					target->flagValid = sl_true;
+				}
+
+				sl_bool verify(const StringView& token, Jwt* jwt)
+				{
+					sl_int64 now = Time::now().toUnixTime();
+					sl_uint8 digest[SHA256::HashSize];
+					sl_bool flagCache = cache.isNotNull();
+					if (flagCache) {
+						SHA256::hash(token.getData(), token.getLength(), digest);
+						sl_int32 iRet = findCache(digest, now);
+						if (iRet > 0 && jwt) {
+							// The cache keeps only the claims, so each caller gets its own Json objects parsed from the token
+							Claims claims;
+							return decode(token, *jwt, claims, sl_false);
+						}
+						if (iRet) {
+							return iRet > 0;
+						}
+					}
+					Jwt decoded;
+					Claims claims;
+					if (!(decode(token, decoded, claims))) {
+						return sl_false;
+					}
+					// Keeps the tokens not yet valid (`nbf`), since their signatures were verified
+					if (flagCache && !(claims.flagExp && now >= claims.exp + leeway)) {
+						putCache(digest, claims);
+					}
+					if (!(checkTime(claims, now))) {
+						return sl_false;
+					}
+					if (jwt) {
+						*jwt = Move(decoded);
+					}
+					return sl_true;
+				}
+
+				void clearCache()
+				{
+					sl_size n = cache.getCount();
+					CacheEntry* entries = cache.getData();
+					for (sl_size i = 0; i < n; i++) {
+						SpinLocker locker(lockCache + ((i / CACHE_WAYS) & (CACHE_LOCK_COUNT - 1)));
+						CacheEntry& entry = entries[i];
+						entry.flagValid = sl_false;
+					}
+				}
+
+				Ref<ThreadPool> getThreadPool()
+				{
+					SpinLocker locker(&lockThreadPool);
+					if (threadPool.isNull()) {
+						threadPool = ThreadPool::create(0, threadCount);
+						flagOwnThreadPool = threadPool.isNotNull();
+					}
+					return threadPool;
+				}
+
+				void runBatch(BatchState* state)
+				{
+					for (;;) {
+						sl_reg i = Base::interlockedIncrement(&(state->next)) - 1;
+						if ((sl_size)i >= state->count) {
+							break;
+						}
+						state->results[i] = verify(state->tokens[i], state->jwts ? state->jwts + i : sl_null);
+					}
+					if (!(Base::interlockedDecrement(&(state->nRunning)))) {
+						state->event->set();
+					}
+				}
+
+				void verifyBatch(const StringView* tokens, sl_size count, sl_bool* results, Jwt* jwts)
+				{
+					sl_size nWorkers = threadCount;
+					if (nWorkers > count) {
+						nWorkers = count;
+					}
+					Ref<ThreadPool> pool;
+					Ref<BatchState> state;
+					if (nWorkers > 1) {
+						pool = getThreadPool();
+						state = new BatchState;
+						if (state.isNotNull()) {
+							state->event = Event::create(sl_false);
+							if (state->event.isNull()) {
+								state.setNull();
+							}
+						}
+					}
+					if (pool.isNull() || state.isNull()) {
+						for (sl_size i = 0; i < count; i++) {
+							results[i] = verify(tokens[i], jwts ? jwts + i : sl_null);
+						}
+						return;
+					}
+					state->tokens = tokens;
+					state->count = count;
+					state->results = results;
+					state->jwts = jwts;
+					// The calling thread works as one of the workers
+					state->nRunning = 1;
+					Ref<Context> context = this;
+					for (sl_size i = 1; i < nWorkers; i++) {
+						Base::interlockedIncrement(&(state->nRunning));
+						if (!(pool->addTask([context, state]() {
+							context->runBatch(state.get());
+						}))) {
+							Base::interlockedDecrement(&(state->nRunning));
+							break;
+						}
+					}
+					runBatch(state.get());
+					while (state->nRunning) {
+						state->event->wait();
+					}
+				}
+
+			};
+
+		}
+	}
+
+	using namespace priv::jwt_verifier;
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(JwtVerifierParam)
+
+	JwtVerifierParam::JwtVerifierParam() noexcept
+	{
+		algorithm = JwtAlgorithm::HS256;
+		cacheSize = 1024;
+		leeway = 0;
+		flagRequireExpirationTime = sl_false;
+		threadCount = 0;
+	}
+
+
+	JwtVerifier::JwtVerifier() noexcept
+	{
+	}
+
+	JwtVerifier::~JwtVerifier() noexcept
+	{
+	}
+
+	Ref<JwtVerifier> JwtVerifier::create(const JwtVerifierParam& param) noexcept
+	{
+		Ref<Context> context = new Context;
+		if (context.isNull()) {
+			return sl_null;
+		}
+		JwtAlgorithm algorithm = param.algorithm;
+		switch (algorithm) {
+			case JwtAlgorithm::HS256:
+				context->hmac256.start(param.secret.getData(), param.secret.getSize());
+				break;
+			case JwtAlgorithm::HS384:
+				context->hmac384.start(param.secret.getData(), param.secret.getSize());
+				break;
+			case JwtAlgorithm::HS512:
+				context->hmac512.start(param.secret.getData(), param.secret.getSize());
+				break;
+			case JwtAlgorithm::RS256:
+			case JwtAlgorithm::RS384:
+			case JwtAlgorithm::RS512:
+			case JwtAlgorithm::ES256:
+			case JwtAlgorithm::ES384:
+			case JwtAlgorithm::ES512:
+			case JwtAlgorithm::PS256:
+			case JwtAlgorithm::PS384:
+			case JwtAlgorithm::PS512:
+				if (param.key.isNull()) {
+					return sl_null;
+				}
+				context->key = param.key;
+				break;
+			default:
+				return sl_null;
+		}
+		context->algorithm = algorithm;
+		context->leeway = param.leeway;
+		context->flagRequireExp = param.flagRequireExpirationTime;
+		if (param.cacheSize) {
+			sl_uint32 nSets = 1;
+			while (nSets * CACHE_WAYS < param.cacheSize && nSets < 0x40000000) {
+				nSets <<= 1;
+			}
+			context->cache = Array<CacheEntry>::create(nSets * CACHE_WAYS);
+			if (context->cache.isNull()) {
+				return sl_null;
+			}
+			context->maskCacheSet = nSets - 1;
+		}
+		sl_uint32 nThreads = param.threadCount;
+		if (!nThreads) {
+			nThreads = Cpu::getCoreCount();
+			if (!nThreads) {
+				nThreads = 1;
+			}
+		}
+		context->threadCount = nThreads;
+		context->threadPool = param.threadPool;
+		Ref<JwtVerifier> ret = new JwtVerifier;
+		if (ret.isNotNull()) {
+			ret->m_context = Move(context);
+			return ret;
+		}
+		return sl_null;
+	}
+
+	sl_bool JwtVerifier::verify(const StringView& token, Jwt* jwt) noexcept
+	{
+		return ((Context*)(m_context.get()))->verify(token, jwt);
+	}
+
+	void JwtVerifier::verify(const StringView* tokens, sl_size count, sl_bool* results, Jwt* jwts) noexcept
+	{
+		if (!count) {
+			return;
+		}
+		((Context*)(m_context.get()))->verifyBatch(tokens, count, results, jwts);
+	}
+
+	void JwtVerifier::clearCache() noexcept
+	{
+		((Context*)(m_context.get()))->clearCache();
+	}
+
+}
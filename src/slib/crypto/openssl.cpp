@@ -23,6 +23,7 @@
 #include "slib/crypto/openssl.h"
 
 #include "slib/core/thread.h"
+#include "slib/core/memory_output.h"
 
 #include "openssl/ssl.h"
 
@@ -238,6 +239,7 @@ namespace slib
 				SSL_CTX* m_context;
 				HashMap< String, Ref<KeyStore> > m_keyStores;
 				String m_serverName;
+				Memory m_applicationProtocols; // ALPN wire format: length-prefixed names
 				
 			public:
 				ContextImpl()
@@ -288,6 +290,23 @@ namespace slib
 							if (keyStores.isNotEmpty() || param.serverName.isNotEmpty()) {
 								SSL_CTX_set_client_hello_cb(ctx, client_hello_callback, ret.get());
 							}
+							if (param.applicationProtocols.isNotEmpty()) {
+								MemoryOutput protocols;
+								for (auto& name : param.applicationProtocols) {
+									sl_size len = name.getLength();
+									if (len && len < 256) {
+										protocols.writeUint8((sl_uint8)len);
+										protocols.write(name.getData(), len);
+									}
+								}
+								ret->m_applicationProtocols = protocols.getData();
+								Memory& wire = ret->m_applicationProtocols;
+								if (wire.isNotNull()) {
+									// The server selects by `alpn_select_callback`, and the client offers the list
+									SSL_CTX_set_alpn_select_cb(ctx, alpn_select_callback, ret.get());
+									SSL_CTX_set_alpn_protos(ctx, (const unsigned char*)(wire.getData()), (unsigned int)(wire.getSize()));
+								}
+							}
 							return ret;
 						}
 						SSL_CTX_free(ctx);
@@ -331,6 +350,17 @@ namespace slib
 					return SSL_CLIENT_HELLO_SUCCESS;
 				}
 				
+				static int alpn_select_callback(SSL* ssl, const unsigned char** out, unsigned char* outlen, const unsigned char* in, unsigned int inlen, void* arg)
+				{
+					ContextImpl* context = (ContextImpl*)arg;
+					Memory& wire = context->m_applicationProtocols;
+					// Prefers the order of the server
+					if (SSL_select_next_proto((unsigned char**)out, outlen, (const unsigned char*)(wire.getData()), (unsigned int)(wire.getSize()), in, inlen) == OPENSSL_NPN_NEGOTIATED) {
+						return SSL_TLSEXT_ERR_OK;
+					}
+					return SSL_TLSEXT_ERR_NOACK;
+				}
+				
 				SSL_CTX* getContext() override
 				{
 					return m_context;
@@ -706,6 +736,17 @@ namespace slib
 					m_flagInitHandshake = sl_true;
 					doHandshake(lock);
 				}
+
+				String getApplicationProtocol() override
+				{
+					const unsigned char* data = sl_null;
+					unsigned int len = 0;
+					SSL_get0_alpn_selected(m_ssl, &data, &len);
+					if (data && len) {
+						return String((const char*)data, len);
+					}
+					return sl_null;
+				}
 				
 				void doHandshake(ObjectLocker& lock)
 				{
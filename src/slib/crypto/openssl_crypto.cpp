@@ -359,7 +359,7 @@ namespace slib
 				if (!sig) {
 					return sl_null;
 				}
-				ECDSA_SIG_set0(sig, r.get(), s.get());
+				ECDSA_SIG_set0(sig, r.release(), s.release());
 				return sig;
 			}
 
@@ -32,10 +32,49 @@
 
 #include "slib/core/mio.h"
 
+#include "chacha_simd.h"
+
+// minimum number of blocks for the multi-block kernel
+#define MULTI_BLOCK_THRESHOLD 16
+
 namespace slib
 {
 	
 #define U8TO32(A,B,C,D) ((((sl_uint32)(sl_uint8)(A))) | (((sl_uint32)(sl_uint8)(B))<<8) | (((sl_uint32)(sl_uint8)(C))<<16) | (((sl_uint32)(sl_uint8)(D))<<24))
+
+	namespace priv
+	{
+		namespace poly1305
+		{
+
+			// out = a * r (mod 2^130 - 5), partially reduced
+			static void Multiply(sl_uint32* out, const sl_uint32* a, const sl_uint32* r) noexcept
+			{
+				sl_uint32 s1 = r[1] * 5;
+				sl_uint32 s2 = r[2] * 5;
+				sl_uint32 s3 = r[3] * 5;
+				sl_uint32 s4 = r[4] * 5;
+				sl_uint64 d0 = ((sl_uint64)a[0] * r[0]) + ((sl_uint64)a[1] * s4) + ((sl_uint64)a[2] * s3) + ((sl_uint64)a[3] * s2) + ((sl_uint64)a[4] * s1);
+				sl_uint64 d1 = ((sl_uint64)a[0] * r[1]) + ((sl_uint64)a[1] * r[0]) + ((sl_uint64)a[2] * s4) + ((sl_uint64)a[3] * s3) + ((sl_uint64)a[4] * s2);
+				sl_uint64 d2 = ((sl_uint64)a[0] * r[2]) + ((sl_uint64)a[1] * r[1]) + ((sl_uint64)a[2] * r[0]) + ((sl_uint64)a[3] * s4) + ((sl_uint64)a[4] * s3);
+				sl_uint64 d3 = ((sl_uint64)a[0] * r[3]) + ((sl_uint64)a[1] * r[2]) + ((sl_uint64)a[2] * r[1]) + ((sl_uint64)a[3] * r[0]) + ((sl_uint64)a[4] * s4);
+				sl_uint64 d4 = ((sl_uint64)a[0] * r[4]) + ((sl_uint64)a[1] * r[3]) + ((sl_uint64)a[2] * r[2]) + ((sl_uint64)a[3] * r[1]) + ((sl_uint64)a[4] * r[0]);
+				sl_uint32 h0 = (sl_uint32)d0 & 0x3ffffff;
+				d1 += (sl_uint32)(d0 >> 26);
+				out[1] = (sl_uint32)d1 & 0x3ffffff;
+				d2 += (sl_uint32)(d1 >> 26);
+				out[2] = (sl_uint32)d2 & 0x3ffffff;
+				d3 += (sl_uint32)(d2 >> 26);
+				out[3] = (sl_uint32)d3 & 0x3ffffff;
+				d4 += (sl_uint32)(d3 >> 26);
+				out[4] = (sl_uint32)d4 & 0x3ffffff;
+				h0 += ((sl_uint32)(d4 >> 26)) * 5;
+				out[0] = h0 & 0x3ffffff;
+				out[1] += h0 >> 26;
+			}
+
+		}
+	}
 	
 	Poly1305::Poly1305()
 	{
@@ -72,6 +111,7 @@ namespace slib
 		pad[2] = U8TO32(key[24], key[25], key[26], key[27]);
 		pad[3] = U8TO32(key[28], key[29], key[30], key[31]);
 		
+		m_flagPowers = sl_false;
 		m_leftOver = 0;
 		m_flagFinal = sl_false;
 	}
@@ -82,6 +122,19 @@ namespace slib
 		
 		const sl_uint32 hibit = m_flagFinal ? 0 : (1 << 24); // 1 << 128
 		
+		if (nBlocks >= MULTI_BLOCK_THRESHOLD && priv::chacha_simd::IsSupportedPoly1305()) {
+			if (!m_flagPowers) {
+				priv::poly1305::Multiply(m_r + 5, m_r, m_r);
+				priv::poly1305::Multiply(m_r + 10, m_r + 5, m_r);
+				priv::poly1305::Multiply(m_r + 15, m_r + 10, m_r);
+				m_flagPowers = sl_true;
+			}
+			sl_size n = nBlocks & ~((sl_size)3);
+			priv::chacha_simd::Poly1305_UpdateBlocks(m_r, m_h, m, n, hibit);
+			m += n << 4;
+			nBlocks -= n;
+		}
+
 		sl_uint32 r0 = m_r[0];
 		sl_uint32 r1 = m_r[1];
 		sl_uint32 r2 = m_r[2];
@@ -26,6 +26,27 @@
 namespace slib
 {
 
+	namespace priv
+	{
+		namespace rsa
+		{
+
+			static Ref<MontgomeryContext> GetMontgomeryContext(AtomicRef<MontgomeryContext>& cache, const BigInt& M) noexcept
+			{
+				Ref<MontgomeryContext> context = cache;
+				if (context.isNotNull() && context->getModulus() == M) {
+					return context;
+				}
+				context = MontgomeryContext::create(M);
+				if (context.isNotNull()) {
+					cache = context;
+				}
+				return context;
+			}
+
+		}
+	}
+
 	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(RSAPublicKey)
 	
 	RSAPublicKey::RSAPublicKey()
@@ -42,6 +63,11 @@ namespace slib
 		return (sl_uint32)(N.getMostSignificantBytes());
 	}
 
+	Ref<MontgomeryContext> RSAPublicKey::getMontgomeryContextN() const noexcept
+	{
+		return priv::rsa::GetMontgomeryContext(m_montgomeryN, N);
+	}
+
 
 	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(RSAPrivateKey)
 	
@@ -116,20 +142,47 @@ namespace slib
 		return c == 3;
 	}
 
+	Ref<MontgomeryContext> RSAPrivateKey::getMontgomeryContextP() const noexcept
+	{
+		return priv::rsa::GetMontgomeryContext(m_montgomeryP, P);
+	}
+
+	Ref<MontgomeryContext> RSAPrivateKey::getMontgomeryContextQ() const noexcept
+	{
+		return priv::rsa::GetMontgomeryContext(m_montgomeryQ, Q);
+	}
+
 
 	BigInt RSA::executePublic(const RSAPublicKey& key, const BigInt& input)
 	{
+		Ref<MontgomeryContext> context = key.getMontgomeryContextN();
+		if (context.isNotNull()) {
+			return context->pow(input, key.E);
+		}
 		return BigInt::pow_montgomery(input, key.E, key.N);
 	}
 
 	BigInt RSA::executePrivate(const RSAPrivateKey& key, const BigInt& input)
 	{
 		if (!(key.flagUseOnlyD) && key.P.isNotNull() && key.Q.isNotNull() && key.DP.isNotNull() && key.DQ.isNotNull() && key.IQ.isNotNull()) {
+			Ref<MontgomeryContext> contextP = key.getMontgomeryContextP();
+			Ref<MontgomeryContext> contextQ = key.getMontgomeryContextQ();
+			if (contextP.isNotNull() && contextQ.isNotNull()) {
+				// Garner: C = TQ + Q * ((TP - TQ) * IQ mod P)
+				BigInt TP = contextP->pow(input, key.DP);
+				BigInt TQ = contextQ->pow(input, key.DQ);
+				BigInt T = contextP->mulMod(TP - TQ, key.IQ);
+				return TQ + T * key.Q;
+			}
 			BigInt TP = BigInt::pow_montgomery(input, key.DP, key.P);
 			BigInt TQ = BigInt::pow_montgomery(input, key.DQ, key.Q);
 			BigInt T = BigInt::mod((TP - TQ) * key.IQ, key.P, sl_true);
 			return TQ + T * key.Q;
 		} else {
+			Ref<MontgomeryContext> context = key.getMontgomeryContextN();
+			if (context.isNotNull()) {
+				return context->pow(input, key.D);
+			}
 			return BigInt::pow_montgomery(input, key.D, key.N);
 		}
 	}
@@ -25,6 +25,8 @@
 #include "slib/core/mio.h"
 #include "slib/core/math.h"
 
+#include "sha_simd.h"
+
 namespace slib
 {
 
@@ -75,10 +77,20 @@ namespace slib
 				}
 			}
 		}
-		while (sizeInput >= 64) {
-			_updateSection(input);
-			sizeInput -= 64;
-			input += 64;
+		if (sizeInput >= 64) {
+			if (priv::sha_simd::IsSupportedSHA1()) {
+				sl_size nBlocks = sizeInput >> 6;
+				priv::sha_simd::SHA1_UpdateBlocks(h, input, nBlocks);
+				nBlocks <<= 6;
+				sizeInput -= nBlocks;
+				input += nBlocks;
+			} else {
+				do {
+					_updateSection(input);
+					sizeInput -= 64;
+					input += 64;
+				} while (sizeInput >= 64);
+			}
 		}
 		if (sizeInput) {
 			Base::copyMemory(rdata, input, sizeInput);
@@ -118,6 +130,11 @@ namespace slib
 			0x5A827999ul, 0x6ED9EBA1ul, 0x8F1BBCDCul, 0xCA62C1D6ul
 		};
 
+		if (priv::sha_simd::IsSupportedSHA1()) {
+			priv::sha_simd::SHA1_UpdateBlocks(h, input, 1);
+			return;
+		}
+
 		sl_uint32 W[80];
 		sl_uint32 v[5];
 		sl_uint32 i;
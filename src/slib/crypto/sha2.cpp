@@ -21,10 +21,13 @@
  */
 
 #include "slib/crypto/sha2.h"
+#include "slib/crypto/pbkdf.h"
 
 #include "slib/core/mio.h"
 #include "slib/core/math.h"
 
+#include "sha_simd.h"
+
 namespace slib
 {
 
@@ -33,6 +36,198 @@ namespace slib
 		namespace sha2
 		{
 
+			static const sl_uint32 g_K256[64] = {
+				0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul,
+				0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
+				0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul,
+				0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
+				0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul,
+				0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
+				0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul,
+				0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
+				0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul,
+				0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
+				0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul,
+				0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
+				0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul,
+				0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
+				0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul,
+				0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul,
+			};
+
+			static const sl_uint32 g_IV256[8] = {
+				0x6a09e667ul, 0xbb67ae85ul, 0x3c6ef372ul, 0xa54ff53aul,
+				0x510e527ful, 0x9b05688cul, 0x1f83d9abul, 0x5be0cd19ul
+			};
+
+			static void UpdateWords(sl_uint32* h, sl_uint32* W) noexcept
+			{
+				sl_uint32 v[8];
+				sl_uint32 i;
+				for (i = 16; i < 64; i++) {
+					sl_uint32 s0 = Math::rotateRight(W[i - 15], 7) ^ Math::rotateRight(W[i - 15], 18) ^ (W[i - 15] >> 3);
+					sl_uint32 s1 = Math::rotateRight(W[i - 2], 17) ^ Math::rotateRight(W[i - 2], 19) ^ (W[i - 2] >> 10);
+					W[i] = W[i - 16] + s0 + W[i - 7] + s1;
+				}
+				for (i = 0; i < 8; i++) {
+					v[i] = h[i];
+				}
+				for (i = 0; i < 64; i++) {
+					sl_uint32 S1 = Math::rotateRight(v[4], 6) ^ Math::rotateRight(v[4], 11) ^ Math::rotateRight(v[4], 25);
+					sl_uint32 ch = (v[4] & v[5]) ^ ((~v[4]) & v[6]);
+					sl_uint32 temp1 = v[7] + S1 + ch + g_K256[i] + W[i];
+					sl_uint32 S0 = Math::rotateRight(v[0], 2) ^ Math::rotateRight(v[0], 13) ^ Math::rotateRight(v[0], 22);
+					sl_uint32 maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
+					sl_uint32 temp2 = S0 + maj;
+					v[7] = v[6];
+					v[6] = v[5];
+					v[5] = v[4];
+					v[4] = v[3] + temp1;
+					v[3] = v[2];
+					v[2] = v[1];
+					v[1] = v[0];
+					v[0] = temp1 + temp2;
+				}
+				for (i = 0; i < 8; i++) {
+					h[i] += v[i];
+				}
+			}
+
+			static void UpdateBlocks(sl_uint32* h, const sl_uint8* input, sl_size nBlocks) noexcept
+			{
+				if (sha_simd::IsSupportedSHA256()) {
+					sha_simd::SHA256_UpdateBlocks(h, input, nBlocks);
+					return;
+				}
+				sl_uint32 W[64];
+				for (; nBlocks; nBlocks--) {
+					for (sl_uint32 i = 0; i < 16; i++) {
+						W[i] = MIO::readUint32BE(input + (i << 2));
+					}
+					UpdateWords(h, W);
+					input += 64;
+				}
+			}
+
+			// Lanes to hash `n` messages in parallel, or 0 if hashing them one by one is faster.
+			// Measured cost of a lane pass: 16-lane AVX-512 ~ 10 SHA-NI blocks, 8-lane AVX2 ~ 11 SHA-NI blocks or 1.4 scalar blocks
+			static sl_uint32 GetHashManyLaneCount(sl_size n) noexcept
+			{
+				sl_uint32 nLanes = sha_simd::GetSHA256LaneCount();
+				if (!nLanes || n < 2) {
+					return 0;
+				}
+				if (sha_simd::IsSupportedSHA256()) {
+					if (nLanes == 16 && n >= 12) {
+						return 16;
+					}
+					return 0;
+				}
+				return nLanes;
+			}
+
+			// Same as above, for the single-block HMAC iterations of PBKDF2.
+			// Measured cost of a lane pass: 16-lane AVX-512 ~ 4.5 SHA-NI iterations, 8-lane AVX2 ~ 6.5 SHA-NI iterations
+			static sl_uint32 GetPBKDF2LaneCount(sl_size n) noexcept
+			{
+				sl_uint32 nLanes = sha_simd::GetSHA256LaneCount();
+				if (!nLanes || n < 2) {
+					return 0;
+				}
+				if (sha_simd::IsSupportedSHA256()) {
+					if (n < (nLanes == 16 ? 5 : 7)) {
+						return 0;
+					}
+				}
+				return nLanes;
+			}
+
+			struct HashManyLane
+			{
+				const sl_uint8* data;
+				sl_size nBlocks; // remaining data blocks
+				sl_uint32 nPadBlocks;
+				sl_uint32 iPadBlock;
+				sl_uint8* output; // null for idle lane
+				sl_uint8 pad[128];
+			};
+
+			static void StartLane(HashManyLane& lane, sl_uint32* states, sl_uint32 nLanes, sl_uint32 iLane, const void* input, sl_size size, sl_uint8* output) noexcept
+			{
+				for (sl_uint32 i = 0; i < 8; i++) {
+					states[i * nLanes + iLane] = g_IV256[i];
+				}
+				lane.data = (const sl_uint8*)input;
+				lane.nBlocks = size >> 6;
+				sl_uint32 nRemain = (sl_uint32)(size & 63);
+				lane.nPadBlocks = nRemain < 56 ? 1 : 2;
+				lane.iPadBlock = 0;
+				lane.output = output;
+				sl_uint32 sizePad = lane.nPadBlocks << 6;
+				Base::copyMemory(lane.pad, lane.data + (lane.nBlocks << 6), nRemain);
+				lane.pad[nRemain] = 0x80;
+				Base::zeroMemory(lane.pad + nRemain + 1, sizePad - 9 - nRemain);
+				MIO::writeUint64BE(lane.pad + sizePad - 8, (sl_uint64)size << 3);
+			}
+
+			static void FinishLane(HashManyLane& lane, sl_uint32* states, sl_uint32 nLanes, sl_uint32 iLane) noexcept
+			{
+				for (sl_uint32 i = 0; i < 8; i++) {
+					MIO::writeUint32BE(lane.output + (i << 2), states[i * nLanes + iLane]);
+				}
+				lane.output = sl_null;
+			}
+
+			// u: 8 words of U(1) (in), U(nIteration) (out), f: 8 words of F (inout)
+			static void IterateHMAC(const sl_uint32* istate, const sl_uint32* ostate, sl_uint32* u, sl_uint32* f, sl_uint32 nIteration) noexcept
+			{
+				sl_uint32 s[8];
+				sl_uint32 i, k;
+				if (sha_simd::IsSupportedSHA256()) {
+					sl_uint8 block[64];
+					Base::zeroMemory(block + 32, 32);
+					block[32] = 0x80;
+					MIO::writeUint64BE(block + 56, (64 + 32) << 3);
+					for (k = 1; k < nIteration; k++) {
+						for (i = 0; i < 8; i++) {
+							MIO::writeUint32BE(block + (i << 2), u[i]);
+							s[i] = istate[i];
+						}
+						sha_simd::SHA256_UpdateBlocks(s, block, 1);
+						for (i = 0; i < 8; i++) {
+							MIO::writeUint32BE(block + (i << 2), s[i]);
+							u[i] = ostate[i];
+						}
+						sha_simd::SHA256_UpdateBlocks(u, block, 1);
+						for (i = 0; i < 8; i++) {
+							f[i] ^= u[i];
+						}
+					}
+				} else {
+					sl_uint32 W[64];
+					for (k = 1; k < nIteration; k++) {
+						for (i = 0; i < 8; i++) {
+							W[i] = u[i];
+							s[i] = istate[i];
+						}
+						W[8] = 0x80000000;
+						for (i = 9; i < 15; i++) {
+							W[i] = 0;
+						}
+						W[15] = (64 + 32) << 3;
+						UpdateWords(s, W);
+						for (i = 0; i < 8; i++) {
+							W[i] = s[i];
+							u[i] = ostate[i];
+						}
+						UpdateWords(u, W);
+						for (i = 0; i < 8; i++) {
+							f[i] ^= u[i];
+						}
+					}
+				}
+			}
+
 			SHA256Base::SHA256Base() noexcept
 			{
 				rdata_len = 0;
@@ -72,10 +267,12 @@ namespace slib
 						}
 					}
 				}
-				while (sizeInput >= 64) {
-					_updateSection(input);
-					sizeInput -= 64;
-					input += 64;
+				if (sizeInput >= 64) {
+					sl_size nBlocks = sizeInput >> 6;
+					UpdateBlocks(h, input, nBlocks);
+					nBlocks <<= 6;
+					sizeInput -= nBlocks;
+					input += nBlocks;
 				}
 				if (sizeInput) {
 					Base::copyMemory(rdata, input, sizeInput);
@@ -102,58 +299,7 @@ namespace slib
 
 			void SHA256Base::_updateSection(const sl_uint8* input) noexcept
 			{
-				static sl_uint32 K[64] = {
-					0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul,
-					0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
-					0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul,
-					0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
-					0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul,
-					0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
-					0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul,
-					0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
-					0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul,
-					0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
-					0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul,
-					0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
-					0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul,
-					0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
-					0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul,
-					0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul,
-				};
-
-				sl_uint32 W[64];
-				sl_uint32 v[8];
-				sl_uint32 i;
-				for (i = 0; i < 16; i++) {
-					W[i] = MIO::readUint32BE(input + (i << 2));
-				}
-				for (i = 16; i < 64; i++) {
-					sl_uint32 s0 = Math::rotateRight(W[i - 15], 7) ^ Math::rotateRight(W[i - 15], 18) ^ (W[i - 15] >> 3);
-					sl_uint32 s1 = Math::rotateRight(W[i - 2], 17) ^ Math::rotateRight(W[i - 2], 19) ^ (W[i - 2] >> 10);
-					W[i] = W[i - 16] + s0 + W[i - 7] + s1;
-				}
-				for (i = 0; i < 8; i++) {
-					v[i] = h[i];
-				}
-				for (i = 0; i < 64; i++) {
-					sl_uint32 S1 = Math::rotateRight(v[4], 6) ^ Math::rotateRight(v[4], 11) ^ Math::rotateRight(v[4], 25);
-					sl_uint32 ch = (v[4] & v[5]) ^ ((~v[4]) & v[6]);
-					sl_uint32 temp1 = v[7] + S1 + ch + K[i] + W[i];
-					sl_uint32 S0 = Math::rotateRight(v[0], 2) ^ Math::rotateRight(v[0], 13) ^ Math::rotateRight(v[0], 22);
-					sl_uint32 maj = (v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]);
-					sl_uint32 temp2 = S0 + maj;
-					v[7] = v[6];
-					v[6] = v[5];
-					v[5] = v[4];
-					v[4] = v[3] + temp1;
-					v[3] = v[2];
-					v[2] = v[1];
-					v[1] = v[0];
-					v[0] = temp1 + temp2;
-				}
-				for (i = 0; i < 8; i++) {
-					h[i] += v[i];
-				}
+				UpdateBlocks(h, input, 1);
 			}
 
 			SHA512Base::SHA512Base() noexcept
@@ -419,4 +565,216 @@ namespace slib
 		return MIO::readUint32LE(hash);
 	}
 
+	void SHA256::hashMany(const void* const* inputs, const sl_size* sizes, sl_size count, void* _outputs) noexcept
+	{
+		sl_uint8* outputs = (sl_uint8*)_outputs;
+		sl_uint32 nLanes = priv::sha2::GetHashManyLaneCount(count);
+		if (!nLanes) {
+			for (sl_size i = 0; i < count; i++) {
+				hash(inputs[i], sizes[i], outputs + (i << 5));
+			}
+			return;
+		}
+		SLIB_ALIGN(64) sl_uint32 states[8 * PRIV_SHA256_MAX_LANES];
+		priv::sha2::HashManyLane lanes[PRIV_SHA256_MAX_LANES];
+		const sl_uint8* blocks[PRIV_SHA256_MAX_LANES];
+		sl_uint8 zero[64] = {0};
+		sl_size iNext = 0;
+		sl_uint32 nActive = 0;
+		sl_uint32 k;
+		for (k = 0; k < nLanes; k++) {
+			if (iNext < count) {
+				priv::sha2::StartLane(lanes[k], states, nLanes, k, inputs[iNext], sizes[iNext], outputs + (iNext << 5));
+				iNext++;
+				nActive++;
+			} else {
+				lanes[k].output = sl_null;
+			}
+		}
+		while (nActive) {
+			if (iNext >= count && priv::sha2::GetHashManyLaneCount(nActive) != nLanes) {
+				// Few long messages are left, hashing them one by one
+				for (k = 0; k < nLanes; k++) {
+					priv::sha2::HashManyLane& lane = lanes[k];
+					if (lane.output) {
+						sl_uint32 h[8];
+						sl_uint32 i;
+						for (i = 0; i < 8; i++) {
+							h[i] = states[i * nLanes + k];
+						}
+						if (lane.nBlocks) {
+							priv::sha2::UpdateBlocks(h, lane.data, lane.nBlocks);
+						}
+						priv::sha2::UpdateBlocks(h, lane.pad + (lane.iPadBlock << 6), lane.nPadBlocks - lane.iPadBlock);
+						for (i = 0; i < 8; i++) {
+							MIO::writeUint32BE(lane.output + (i << 2), h[i]);
+						}
+					}
+				}
+				return;
+			}
+			for (k = 0; k < nLanes; k++) {
+				priv::sha2::HashManyLane& lane = lanes[k];
+				if (lane.output) {
+					if (lane.nBlocks) {
+						blocks[k] = lane.data;
+						lane.data += 64;
+						lane.nBlocks--;
+					} else {
+						blocks[k] = lane.pad + (lane.iPadBlock << 6);
+						lane.iPadBlock++;
+					}
+				} else {
+					blocks[k] = zero;
+				}
+			}
+			priv::sha_simd::SHA256_UpdateLanes(states, blocks);
+			for (k = 0; k < nLanes; k++) {
+				priv::sha2::HashManyLane& lane = lanes[k];
+				if (lane.output && !(lane.nBlocks) && lane.iPadBlock == lane.nPadBlocks) {
+					priv::sha2::FinishLane(lane, states, nLanes, k);
+					if (iNext < count) {
+						priv::sha2::StartLane(lane, states, nLanes, k, inputs[iNext], sizes[iNext], outputs + (iNext << 5));
+						iNext++;
+					} else {
+						nActive--;
+					}
+				}
+			}
+		}
+	}
+
+	template <>
+	void PBKDF2< HMAC<SHA256> >::generateKey(
+		const void* password, sl_size lenPassword,
+		const void* salt, sl_size lenSalt,
+		sl_uint32 nIteration,
+		void* _outDK, sl_size lenDK)
+	{
+		if (!lenDK) {
+			return;
+		}
+
+		sl_uint8* outDK = (sl_uint8*)_outDK;
+		sl_uint32 i, k;
+
+		// States after hashing the i_key_pad and o_key_pad
+		sl_uint32 istate[8], ostate[8];
+		{
+			sl_uint8 key[64];
+			if (lenPassword > 64) {
+				SHA256::hash(password, lenPassword, key);
+				Base::zeroMemory(key + 32, 32);
+			} else {
+				Base::copyMemory(key, password, lenPassword);
+				Base::zeroMemory(key + lenPassword, 64 - lenPassword);
+			}
+			sl_uint8 pad[64];
+			for (i = 0; i < 64; i++) {
+				pad[i] = key[i] ^ 0x36;
+			}
+			for (i = 0; i < 8; i++) {
+				istate[i] = priv::sha2::g_IV256[i];
+			}
+			priv::sha2::UpdateBlocks(istate, pad, 1);
+			for (i = 0; i < 64; i++) {
+				pad[i] = key[i] ^ 0x5c;
+			}
+			for (i = 0; i < 8; i++) {
+				ostate[i] = priv::sha2::g_IV256[i];
+			}
+			priv::sha2::UpdateBlocks(ostate, pad, 1);
+		}
+
+		sl_uint32 nBlocks = (sl_uint32)((lenDK + 31) >> 5);
+		sl_uint32 nLanes = priv::sha2::GetPBKDF2LaneCount(nBlocks);
+		HMAC<SHA256> hmac;
+		sl_uint8 bi[4];
+		sl_uint8 t[32];
+
+		sl_uint32 iBlock = 0;
+		if (nLanes && nIteration > 1) {
+			// The word i of the lane k is stored at [i * nLanes + k]
+			SLIB_ALIGN(64) sl_uint32 words[16 * PRIV_SHA256_MAX_LANES];
+			SLIB_ALIGN(64) sl_uint32 states[8 * PRIV_SHA256_MAX_LANES];
+			SLIB_ALIGN(64) sl_uint32 f[8 * PRIV_SHA256_MAX_LANES];
+			SLIB_ALIGN(64) sl_uint32 istates[8 * PRIV_SHA256_MAX_LANES];
+			SLIB_ALIGN(64) sl_uint32 ostates[8 * PRIV_SHA256_MAX_LANES];
+			sl_uint32 sizeStates = nLanes << 5;
+			for (i = 0; i < 8; i++) {
+				for (k = 0; k < nLanes; k++) {
+					istates[i * nLanes + k] = istate[i];
+					ostates[i * nLanes + k] = ostate[i];
+					words[(i + 8) * nLanes + k] = i ? (i == 7 ? (64 + 32) << 3 : 0) : 0x80000000;
+				}
+			}
+			while (priv::sha2::GetPBKDF2LaneCount(nBlocks - iBlock) == nLanes) {
+				sl_uint32 n = nBlocks - iBlock;
+				if (n > nLanes) {
+					n = nLanes;
+				}
+				for (k = 0; k < nLanes; k++) {
+					if (k < n) {
+						MIO::writeUint32BE(bi, iBlock + k + 1);
+						hmac.start(password, lenPassword);
+						hmac.update(salt, lenSalt);
+						hmac.update(bi, 4);
+						hmac.finish(t);
+						for (i = 0; i < 8; i++) {
+							words[i * nLanes + k] = MIO::readUint32BE(t + (i << 2));
+						}
+					} else {
+						for (i = 0; i < 8; i++) {
+							words[i * nLanes + k] = 0;
+						}
+					}
+				}
+				Base::copyMemory(f, words, sizeStates);
+				for (sl_uint32 m = 1; m < nIteration; m++) {
+					Base::copyMemory(states, istates, sizeStates);
+					priv::sha_simd::SHA256_UpdateLanes(states, words);
+					Base::copyMemory(words, states, sizeStates);
+					Base::copyMemory(states, ostates, sizeStates);
+					priv::sha_simd::SHA256_UpdateLanes(states, words);
+					Base::copyMemory(words, states, sizeStates);
+					sl_uint32 nWords = nLanes << 3;
+					for (i = 0; i < nWords; i++) {
+						f[i] ^= states[i];
+					}
+				}
+				for (k = 0; k < n; k++) {
+					for (i = 0; i < 8; i++) {
+						MIO::writeUint32BE(t + (i << 2), f[i * nLanes + k]);
+					}
+					sl_size m = lenDK - ((sl_size)(iBlock + k) << 5);
+					if (m > 32) {
+						m = 32;
+					}
+					Base::copyMemory(outDK + ((sl_size)(iBlock + k) << 5), t, m);
+				}
+				iBlock += n;
+			}
+		}
+		for (; iBlock < nBlocks; iBlock++) {
+			MIO::writeUint32BE(bi, iBlock + 1);
+			hmac.start(password, lenPassword);
+			hmac.update(salt, lenSalt);
+			hmac.update(bi, 4);
+			hmac.finish(t);
+			sl_uint32 u[8], f[8];
+			for (i = 0; i < 8; i++) {
+				u[i] = f[i] = MIO::readUint32BE(t + (i << 2));
+			}
+			priv::sha2::IterateHMAC(istate, ostate, u, f, nIteration);
+			for (i = 0; i < 8; i++) {
+				MIO::writeUint32BE(t + (i << 2), f[i]);
+			}
+			sl_size m = lenDK - ((sl_size)iBlock << 5);
+			if (m > 32) {
+				m = 32;
+			}
+			Base::copyMemory(outDK + ((sl_size)iBlock << 5), t, m);
+		}
+	}
+
 }
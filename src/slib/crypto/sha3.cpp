@@ -24,6 +24,14 @@
 
 #include "slib/core/mio.h"
 #include "slib/core/math.h"
+#include "slib/core/cpu.h"
+#include "slib/core/thread.h"
+#include "slib/core/scoped_buffer.h"
+
+#include "sha3_simd.h"
+
+#define PARALLEL_HASH_MAX_BATCH 1024
+#define PARALLEL_HASH_MIN_THREAD_SIZE 0x40000
 
 namespace slib
 {
@@ -33,6 +41,67 @@ namespace slib
 		namespace sha3
 		{
 
+			const sl_uint64 g_roundConstants64[24] = {
+				SLIB_UINT64(0x0000000000000001), SLIB_UINT64(0x0000000000008082), SLIB_UINT64(0x800000000000808A), SLIB_UINT64(0x8000000080008000),
+				SLIB_UINT64(0x000000000000808B), SLIB_UINT64(0x0000000080000001), SLIB_UINT64(0x8000000080008081), SLIB_UINT64(0x8000000000008009),
+				SLIB_UINT64(0x000000000000008A), SLIB_UINT64(0x0000000000000088), SLIB_UINT64(0x0000000080008009), SLIB_UINT64(0x000000008000000A),
+				SLIB_UINT64(0x000000008000808B), SLIB_UINT64(0x800000000000008B), SLIB_UINT64(0x8000000000008089), SLIB_UINT64(0x8000000000008003),
+				SLIB_UINT64(0x8000000000008002), SLIB_UINT64(0x8000000000000080), SLIB_UINT64(0x000000000000800A), SLIB_UINT64(0x800000008000000A),
+				SLIB_UINT64(0x8000000080008081), SLIB_UINT64(0x8000000000008080), SLIB_UINT64(0x0000000080000001), SLIB_UINT64(0x8000000080008008)
+			};
+
+#if defined(SLIB_ARCH_IS_64BIT)
+
+#define XOR(a, b) ((a) ^ (b))
+#define XOR5(a, b, c, d, e) ((a) ^ (b) ^ (c) ^ (d) ^ (e))
+#define CHI(a, b, c) ((a) ^ ((~(b)) & (c)))
+#define ROL(a, n) (((a) << (n)) | ((a) >> (64 - (n))))
+#define XOR_RC(a, i) ((a) ^ g_roundConstants64[i])
+#define PRIV_KECCAK_LOAD_LANE(name, index) sl_uint64 A##name = state[index]; sl_uint64 E##name;
+#define PRIV_KECCAK_STORE_LANE(name, index) state[index] = A##name;
+
+			static void Permute(sl_uint64* state) noexcept
+			{
+				sl_uint64 Ca, Ce, Ci, Co, Cu, Da, De, Di, Do, Du, Bba, Bbe, Bbi, Bbo, Bbu;
+				PRIV_KECCAK_LANES(PRIV_KECCAK_LOAD_LANE)
+				for (sl_uint32 i = 0; i < 24; i += 2) {
+					PRIV_KECCAK_ROUND(A, E, i)
+					PRIV_KECCAK_ROUND(E, A, i + 1)
+				}
+				PRIV_KECCAK_LANES(PRIV_KECCAK_STORE_LANE)
+			}
+
+#undef XOR
+#undef XOR5
+#undef CHI
+#undef ROL
+#undef XOR_RC
+
+			static void Absorb(sl_uint64* state, const sl_uint8* data, sl_uint32 nLanes) noexcept
+			{
+				for (sl_uint32 i = 0; i < nLanes; i++) {
+					state[i] ^= MIO::readUint64LE(data);
+					data += 8;
+				}
+			}
+
+			static void Extract(const sl_uint64* state, sl_uint8* output, sl_uint32 size) noexcept
+			{
+				sl_uint32 nLanes = size >> 3;
+				for (sl_uint32 i = 0; i < nLanes; i++) {
+					MIO::writeUint64LE(output, state[i]);
+					output += 8;
+				}
+				size &= 7;
+				if (size) {
+					sl_uint8 buf[8];
+					MIO::writeUint64LE(buf, state[nLanes]);
+					Base::copyMemory(output, buf, size);
+				}
+			}
+
+#else
+
 			// The round constants, pre-interleaved
 			static const BitInterleaved64 g_roundConstants[24] = {
 				{ 0x00000001, 0x00000000 },{ 0x00000000, 0x00000089 },
@@ -129,10 +198,197 @@ namespace slib
 				}
 			}
 
+			static void Permute(sl_uint64* state) noexcept
+			{
+				BitInterleaved64 (*A)[5] = (BitInterleaved64(*)[5])state;
+				for (sl_uint32 r = 0; r < 24; r++)
+				{
+					// theta
+					{
+						sl_uint32 x;
+						BitInterleaved64 C[5], D[5];
+						for (x = 0; x < 5; x++) {
+							C[x].odd = A[x][0].odd ^ A[x][1].odd ^ A[x][2].odd ^ A[x][3].odd ^ A[x][4].odd;
+							C[x].even = A[x][0].even ^ A[x][1].even ^ A[x][2].even ^ A[x][3].even ^ A[x][4].even;
+						}
+						for (x = 0; x < 5; x++) {
+							BitInterleaved64 r;
+							RotateBi1(&r, &C[MOD5(x + 1)]);
+							D[x].odd = C[MOD5(x - 1)].odd ^ r.odd;
+							D[x].even = C[MOD5(x - 1)].even ^ r.even;
+							for (int y = 0; y < 5; y++) {
+								A[x][y].odd ^= D[x].odd;
+								A[x][y].even ^= D[x].even;
+							}
+						}
+					}
+					// rho pi chi
+					{
+						sl_uint32 x, y;
+						BitInterleaved64 B[5][5] = { { { 0 } } };
+						for (x = 0; x < 5; x++) {
+							for (y = 0; y < 5; y++) {
+								RotateBiN(&B[y][MOD5(2 * x + 3 * y)], &A[x][y], g_rotationConstants[y][x]);
+							}
+						}
+						for (x = 0; x < 5; x++) {
+							sl_uint32 x1 = MOD5(x + 1);
+							sl_uint32 x2 = MOD5(x + 2);
+							for (y = 0; y < 5; y++) {
+								A[x][y].odd = B[x][y].odd ^ ((~B[x1][y].odd) & B[x2][y].odd);
+								A[x][y].even = B[x][y].even ^ ((~B[x1][y].even) & B[x2][y].even);
+							}
+						}
+					}
+					// iota
+					A[0][0].odd ^= g_roundConstants[r].odd;
+					A[0][0].even ^= g_roundConstants[r].even;
+				}
+			}
+
+			static void Absorb(sl_uint64* state, const sl_uint8* data, sl_uint32 nLanes) noexcept
+			{
+				BitInterleaved64 (*A)[5] = (BitInterleaved64(*)[5])state;
+				for (sl_uint32 x = 0, y = 0, i = 0; i < nLanes; i++) {
+					BitInterleaved64 bi;
+					ReadBi(&bi, data);
+					A[x][y].odd ^= bi.odd;
+					A[x][y].even ^= bi.even;
+					data += 8;
+					x++;
+					if (x == 5) {
+						y++;
+						x = 0;
+					}
+				}
+			}
+
+			static void Extract(const sl_uint64* state, sl_uint8* output, sl_uint32 size) noexcept
+			{
+				const BitInterleaved64 (*A)[5] = (const BitInterleaved64(*)[5])state;
+				sl_uint32 lanes = (size + 7) >> 3;
+				for (sl_uint32 x = 0, y = 0, i = 0; i < lanes; i++) {
+					if (size >= 8) {
+						WriteBi(&A[x][y], output);
+						output += 8;
+						size -= 8;
+					} else {
+						sl_uint8 buf[8];
+						WriteBi(&A[x][y], buf);
+						Base::copyMemory(output, buf, size);
+						return;
+					}
+					x++;
+					if (x == 5) {
+						y++;
+						x = 0;
+					}
+				}
+			}
+
+#endif
+
+			// Returns the length of encoded
+			static sl_uint32 LeftEncode(sl_uint8* output, sl_uint64 x) noexcept
+			{
+				sl_uint32 n = 1;
+				while (n < 8 && (x >> (n << 3))) {
+					n++;
+				}
+				output[0] = (sl_uint8)n;
+				for (sl_uint32 i = 1; i <= n; i++) {
+					output[i] = (sl_uint8)(x >> ((n - i) << 3));
+				}
+				return n + 1;
+			}
+
+			// Returns the length of encoded
+			static sl_uint32 RightEncode(sl_uint8* output, sl_uint64 x) noexcept
+			{
+				sl_uint32 n = 1;
+				while (n < 8 && (x >> (n << 3))) {
+					n++;
+				}
+				for (sl_uint32 i = 0; i < n; i++) {
+					output[i] = (sl_uint8)(x >> ((n - 1 - i) << 3));
+				}
+				output[n] = (sl_uint8)n;
+				return n + 1;
+			}
+
+			// SHAKE256 of the blocks, 64 bytes output per block
+			static void HashBlocks(const sl_uint8* input, sl_uint32 blockSize, sl_size nBlocks, sl_uint8* output) noexcept
+			{
+				sl_uint32 nParallel = sha3_simd::GetParallelCount();
+				if (nParallel) {
+					const sl_uint8* inputs[PRIV_KECCAK_MAX_PARALLEL];
+					while (nBlocks >= nParallel) {
+						for (sl_uint32 k = 0; k < nParallel; k++) {
+							inputs[k] = input;
+							input += blockSize;
+						}
+						sha3_simd::SHAKE256_Parallel(inputs, blockSize, output);
+						output += nParallel << 6;
+						nBlocks -= nParallel;
+					}
+				}
+				for (; nBlocks; nBlocks--) {
+					SHAKE256 hash;
+					hash.start();
+					hash.update(input, blockSize);
+					hash.finish(output);
+					input += blockSize;
+					output += 64;
+				}
+			}
+
+			static void HashBlocks(const sl_uint8* input, sl_uint32 blockSize, sl_size nBlocks, sl_uint8* output, sl_uint32 nThreads) noexcept
+			{
+				sl_size nMaxThreads = (sl_size)blockSize * nBlocks / PARALLEL_HASH_MIN_THREAD_SIZE;
+				if (nThreads > nMaxThreads) {
+					nThreads = (sl_uint32)nMaxThreads;
+				}
+				if (nThreads < 2) {
+					HashBlocks(input, blockSize, nBlocks, output);
+					return;
+				}
+				// Each thread hashes a range of blocks, aligned to the count of parallel lanes
+				sl_size nBlocksPerThread = (nBlocks + nThreads - 1) / nThreads;
+				nBlocksPerThread = (nBlocksPerThread + PRIV_KECCAK_MAX_PARALLEL - 1) & ~((sl_size)(PRIV_KECCAK_MAX_PARALLEL - 1));
+				if (nBlocksPerThread >= nBlocks) {
+					HashBlocks(input, blockSize, nBlocks, output);
+					return;
+				}
+				List< Ref<Thread> > threads;
+				sl_size iStart = nBlocksPerThread;
+				while (iStart < nBlocks) {
+					sl_size n = nBlocks - iStart;
+					if (n > nBlocksPerThread) {
+						n = nBlocksPerThread;
+					}
+					const sl_uint8* p = input + iStart * blockSize;
+					sl_uint8* o = output + (iStart << 6);
+					Ref<Thread> thread = Thread::start([p, blockSize, n, o]() {
+						HashBlocks(p, blockSize, n, o);
+					});
+					if (thread.isNotNull()) {
+						threads.add_NoLock(Move(thread));
+					} else {
+						HashBlocks(p, blockSize, n, o);
+					}
+					iStart += n;
+				}
+				HashBlocks(input, blockSize, nBlocksPerThread, output);
+				ListElements< Ref<Thread> > listThreads(threads);
+				for (sl_size i = 0; i < listThreads.count; i++) {
+					listThreads[i]->join();
+				}
+			}
 
 			SHA3Base::SHA3Base() noexcept
 			{
 				rdata_len = 0;
+				suffix = 0x06;
 			}
 
 			SHA3Base::~SHA3Base()
@@ -179,109 +435,45 @@ namespace slib
 				}
 			}
 
-			void SHA3Base::finish(void* _output) noexcept
+			void SHA3Base::finish(void* output) noexcept
+			{
+				_finish(output, nhash);
+			}
+
+			void SHA3Base::_updateBlock(const sl_uint8* data) noexcept
+			{
+				Absorb(A, data, rate >> 3);
+				Permute(A);
+			}
+
+			void SHA3Base::_finish(void* _output, sl_size size) noexcept
 			{
-				// Append SHA-3 Domain Suffix (01) and padding (10*1)
+				// Append Domain Suffix and padding (10*1)
 				{
 					sl_uint32 rate_1 = rate - 1;
 					if (rdata_len < rate_1) {
-						rdata[rdata_len] = (sl_uint8)0x06;
+						rdata[rdata_len] = suffix;
 						for (sl_uint32 i = rdata_len + 1; i < rate_1; i++) {
 							rdata[i] = 0;
 						}
 						rdata[rate_1] = (sl_uint8)0x80;
 					} else {
-						rdata[rdata_len] = (sl_uint8)0x86;
+						rdata[rdata_len] = suffix | 0x80;
 					}
 					_updateBlock(rdata);
 					rdata_len = 0;
 				}
-				// Extract
-				{
-					sl_uint8* output = (sl_uint8*)_output;
-					sl_uint32 n = nhash;
-					sl_uint32 lanes = (n + 7) >> 3;
-					for (sl_uint32 x = 0, y = 0, i = 0; i < lanes; i++) {
-						if (n >= 8) {
-							WriteBi(&A[x][y], output);
-							output += 8;
-							n -= 8;
-						} else {
-							sl_uint8 buf[8];
-							WriteBi(&A[x][y], buf);
-							Base::copyMemory(output, buf, n);
-							return;
-						}
-						x++;
-						if (x == 5) {
-							y++;
-							x = 0;
-						}
-					}
-				}
-			}
-
-			void SHA3Base::_updateBlock(const sl_uint8* data) noexcept
-			{
-				// absorb
-				{
-					sl_uint32 lanes = rate >> 3;
-					for (sl_uint32 x = 0, y = 0, i = 0; i < lanes; i++) {
-						BitInterleaved64 bi;
-						ReadBi(&bi, data);
-						A[x][y].odd ^= bi.odd;
-						A[x][y].even ^= bi.even;
-						data += 8;
-						x++;
-						if (x == 5) {
-							y++;
-							x = 0;
-						}
-					}
-				}
-				// permute
-				for (sl_uint32 r = 0; r < 24; r++)
-				{
-					// theta
-					{
-						sl_uint32 x;
-						BitInterleaved64 C[5], D[5];
-						for (x = 0; x < 5; x++) {
-							C[x].odd = A[x][0].odd ^ A[x][1].odd ^ A[x][2].odd ^ A[x][3].odd ^ A[x][4].odd;
-							C[x].even = A[x][0].even ^ A[x][1].even ^ A[x][2].even ^ A[x][3].even ^ A[x][4].even;
-						}
-						for (x = 0; x < 5; x++) {
-							BitInterleaved64 r;
-							RotateBi1(&r, &C[MOD5(x + 1)]);
-							D[x].odd = C[MOD5(x - 1)].odd ^ r.odd;
-							D[x].even = C[MOD5(x - 1)].even ^ r.even;
-							for (int y = 0; y < 5; y++) {
-								A[x][y].odd ^= D[x].odd;
-								A[x][y].even ^= D[x].even;
-							}
-						}
-					}
-					// rho pi chi
-					{
-						sl_uint32 x, y;
-						BitInterleaved64 B[5][5] = { { { 0 } } };
-						for (x = 0; x < 5; x++) {
-							for (y = 0; y < 5; y++) {
-								RotateBiN(&B[y][MOD5(2 * x + 3 * y)], &A[x][y], g_rotationConstants[y][x]);
-							}
-						}
-						for (x = 0; x < 5; x++) {
-							sl_uint32 x1 = MOD5(x + 1);
-							sl_uint32 x2 = MOD5(x + 2);
-							for (y = 0; y < 5; y++) {
-								A[x][y].odd = B[x][y].odd ^ ((~B[x1][y].odd) & B[x2][y].odd);
-								A[x][y].even = B[x][y].even ^ ((~B[x1][y].even) & B[x2][y].even);
-							}
-						}
+				// Squeeze
+				sl_uint8* output = (sl_uint8*)_output;
+				for (;;) {
+					sl_uint32 n = size < rate ? (sl_uint32)size : rate;
+					Extract(A, output, n);
+					size -= n;
+					if (!size) {
+						break;
 					}
-					// iota
-					A[0][0].odd ^= g_roundConstants[r].odd;
-					A[0][0].even ^= g_roundConstants[r].even;
+					output += n;
+					Permute(A);
 				}
 			}
 
@@ -331,4 +523,195 @@ namespace slib
 	{
 	}
 
+
+	SHAKE128::SHAKE128() noexcept
+	{
+		rate = BlockSize;
+		nhash = HashSize;
+		suffix = 0x1F;
+	}
+
+	SHAKE128::~SHAKE128()
+	{
+	}
+
+	void SHAKE128::finish(void* output, sl_size size) noexcept
+	{
+		_finish(output, size);
+	}
+
+
+	SHAKE256::SHAKE256() noexcept
+	{
+		rate = BlockSize;
+		nhash = HashSize;
+		suffix = 0x1F;
+	}
+
+	SHAKE256::~SHAKE256()
+	{
+	}
+
+	void SHAKE256::finish(void* output, sl_size size) noexcept
+	{
+		_finish(output, size);
+	}
+
+
+	CSHAKE256::CSHAKE256() noexcept
+	{
+	}
+
+	CSHAKE256::~CSHAKE256()
+	{
+	}
+
+	void CSHAKE256::start(const void* N, sl_size lenN, const void* S, sl_size lenS) noexcept
+	{
+		SHAKE256::start();
+		if (!lenN && !lenS) {
+			suffix = 0x1F;
+			return;
+		}
+		suffix = 0x04;
+		// bytepad(encode_string(N) || encode_string(S), rate)
+		sl_uint8 buf[10];
+		sl_uint32 n = priv::sha3::LeftEncode(buf, rate);
+		sl_uint64 size = n;
+		update(buf, n);
+		n = priv::sha3::LeftEncode(buf, (sl_uint64)lenN << 3);
+		update(buf, n);
+		update(N, lenN);
+		size += n + lenN;
+		n = priv::sha3::LeftEncode(buf, (sl_uint64)lenS << 3);
+		update(buf, n);
+		update(S, lenS);
+		size += n + lenS;
+		sl_uint32 nPad = (sl_uint32)(size % rate);
+		if (nPad) {
+			sl_uint8 zero[BlockSize] = {0};
+			update(zero, rate - nPad);
+		}
+	}
+
+
+	ParallelHash256::ParallelHash256() noexcept
+	{
+		m_blockSize = DefaultBlockSize;
+		m_blockSizeCurrent = DefaultBlockSize;
+		m_nThreads = 0;
+		m_sizeLeaf = 0;
+		m_nBlocks = 0;
+	}
+
+	ParallelHash256::~ParallelHash256()
+	{
+	}
+
+	sl_uint32 ParallelHash256::getBlockSize() const noexcept
+	{
+		return m_blockSize;
+	}
+
+	void ParallelHash256::setBlockSize(sl_uint32 size) noexcept
+	{
+		if (size) {
+			m_blockSize = size;
+		}
+	}
+
+	sl_uint32 ParallelHash256::getThreadCount() const noexcept
+	{
+		return m_nThreads;
+	}
+
+	void ParallelHash256::setThreadCount(sl_uint32 n) noexcept
+	{
+		m_nThreads = n;
+	}
+
+	void ParallelHash256::start() noexcept
+	{
+		m_blockSizeCurrent = m_blockSize;
+		m_sizeLeaf = 0;
+		m_nBlocks = 0;
+		m_outer.start("ParallelHash", 12, sl_null, 0);
+		sl_uint8 buf[10];
+		sl_uint32 n = priv::sha3::LeftEncode(buf, m_blockSizeCurrent);
+		m_outer.update(buf, n);
+	}
+
+	void ParallelHash256::update(const void* _input, sl_size size) noexcept
+	{
+		const sl_uint8* input = (const sl_uint8*)_input;
+		sl_uint32 blockSize = m_blockSizeCurrent;
+		if (m_sizeLeaf) {
+			sl_uint32 n = blockSize - m_sizeLeaf;
+			if (size < n) {
+				m_leaf.update(input, size);
+				m_sizeLeaf += (sl_uint32)size;
+				return;
+			}
+			m_leaf.update(input, n);
+			sl_uint8 h[64];
+			m_leaf.finish(h);
+			m_outer.update(h, 64);
+			m_nBlocks++;
+			m_sizeLeaf = 0;
+			input += n;
+			size -= n;
+		}
+		sl_size nBlocks = size / blockSize;
+		if (nBlocks) {
+			_updateBlocks(input, nBlocks);
+			nBlocks *= blockSize;
+			input += nBlocks;
+			size -= nBlocks;
+		}
+		if (size) {
+			m_leaf.start();
+			m_leaf.update(input, size);
+			m_sizeLeaf = (sl_uint32)size;
+		}
+	}
+
+	void ParallelHash256::finish(void* output) noexcept
+	{
+		if (m_sizeLeaf) {
+			sl_uint8 h[64];
+			m_leaf.finish(h);
+			m_outer.update(h, 64);
+			m_nBlocks++;
+			m_sizeLeaf = 0;
+		}
+		sl_uint8 buf[10];
+		sl_uint32 n = priv::sha3::RightEncode(buf, m_nBlocks);
+		m_outer.update(buf, n);
+		n = priv::sha3::RightEncode(buf, HashSize << 3);
+		m_outer.update(buf, n);
+		m_outer.finish(output, HashSize);
+	}
+
+	void ParallelHash256::_updateBlocks(const sl_uint8* input, sl_size nBlocks) noexcept
+	{
+		sl_uint32 blockSize = m_blockSizeCurrent;
+		sl_uint32 nThreads = m_nThreads;
+		if (!nThreads) {
+			nThreads = Cpu::getCoreCount();
+		}
+		sl_size nBatch = nBlocks < PARALLEL_HASH_MAX_BATCH ? nBlocks : PARALLEL_HASH_MAX_BATCH;
+		SLIB_SCOPED_BUFFER(sl_uint8, 4096, hashes, nBatch << 6)
+		if (!hashes) {
+			return;
+		}
+		while (nBlocks) {
+			sl_size n = nBlocks < nBatch ? nBlocks : nBatch;
+			priv::sha3::HashBlocks(input, blockSize, n, hashes, nThreads);
+			m_outer.update(hashes, n << 6);
+			m_nBlocks += n;
+			input += n * blockSize;
+			nBlocks -= n;
+		}
+	}
+
 }
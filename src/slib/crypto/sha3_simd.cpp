@@ -0,0 +1,201 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "sha3_simd.h"
+
+#include "slib/core/cpu.h"
+#include "slib/core/base.h"
+#include "slib/core/mio.h"
+
+#if !defined(SLIB_PLATFORM_IS_MOBILE) && defined(SLIB_ARCH_IS_X64)
+#	define SUPPORT_PARALLEL
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#		define TARGET_AVX2
+#		define TARGET_AVX512
+#	else
+#		include <immintrin.h>
+#		define TARGET_AVX2 __attribute__((target("avx2")))
+#		define TARGET_AVX512 __attribute__((target("avx2,avx512f")))
+#	endif
+#endif
+
+#define SHAKE256_RATE 136
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace sha3_simd
+		{
+
+#if defined(SUPPORT_PARALLEL)
+
+#define PRIV_KECCAK_DECLARE_LANE(name, index) VEC A##name = VEC_ZERO; VEC E##name;
+#define PRIV_KECCAK_ABSORB_LANE(name, index) if (index < (SHAKE256_RATE >> 3)) { A##name = XOR(A##name, VEC_GATHER(base + ((index) << 3), offsets)); }
+#define PRIV_KECCAK_EXTRACT_LANE(name, index) if (index < 8) { VEC_STORE(t + (index) * N, A##name); }
+
+#define PRIV_KECCAK_PERMUTE \
+	for (sl_uint32 i = 0; i < 24; i += 2) { \
+		PRIV_KECCAK_ROUND(A, E, i) \
+		PRIV_KECCAK_ROUND(E, A, i + 1) \
+	}
+
+			// Same as the scalar SHAKE256 running on the lanes, the state of the message k is held in the element k of vectors
+#define PRIV_SHAKE256_PARALLEL \
+	VEC Ca, Ce, Ci, Co, Cu, Da, De, Di, Do, Du, Bba, Bbe, Bbi, Bbo, Bbu; \
+	PRIV_KECCAK_LANES(PRIV_KECCAK_DECLARE_LANE) \
+	sl_int64 _offsets[N]; \
+	sl_uint32 k; \
+	const sl_uint8* base = inputs[0]; \
+	for (k = 0; k < N; k++) { \
+		_offsets[k] = inputs[k] - base; \
+	} \
+	VEC offsets = VEC_LOAD(_offsets); \
+	sl_size nBlocks = size / SHAKE256_RATE; \
+	for (; nBlocks; nBlocks--) { \
+		PRIV_KECCAK_LANES(PRIV_KECCAK_ABSORB_LANE) \
+		PRIV_KECCAK_PERMUTE \
+		base += SHAKE256_RATE; \
+	} \
+	sl_uint32 nRemain = (sl_uint32)(size % SHAKE256_RATE); \
+	sl_size offsetRemain = size - nRemain; \
+	sl_uint8 pads[N][SHAKE256_RATE]; \
+	for (k = 0; k < N; k++) { \
+		sl_uint8* pad = pads[k]; \
+		Base::copyMemory(pad, inputs[k] + offsetRemain, nRemain); \
+		pad[nRemain] = 0x1F; \
+		Base::zeroMemory(pad + nRemain + 1, SHAKE256_RATE - 1 - nRemain); \
+		pad[SHAKE256_RATE - 1] |= 0x80; \
+		_offsets[k] = k * SHAKE256_RATE; \
+	} \
+	base = pads[0]; \
+	offsets = VEC_LOAD(_offsets); \
+	PRIV_KECCAK_LANES(PRIV_KECCAK_ABSORB_LANE) \
+	PRIV_KECCAK_PERMUTE \
+	sl_uint64 t[8 * N]; \
+	PRIV_KECCAK_LANES(PRIV_KECCAK_EXTRACT_LANE) \
+	for (k = 0; k < N; k++) { \
+		sl_uint8* output = outputs + (k << 6); \
+		for (sl_uint32 i = 0; i < 8; i++) { \
+			MIO::writeUint64LE(output + (i << 3), t[i * N + k]); \
+		} \
+	}
+
+#define N 4
+#define VEC __m256i
+#define VEC_ZERO _mm256_setzero_si256()
+#define VEC_LOAD(p) _mm256_loadu_si256((const __m256i*)(p))
+#define VEC_STORE(p, a) _mm256_storeu_si256((__m256i*)(p), a)
+#define VEC_GATHER(p, offsets) _mm256_i64gather_epi64((const long long*)(p), offsets, 1)
+#define XOR(a, b) _mm256_xor_si256(a, b)
+#define XOR5(a, b, c, d, e) _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(c, d)), e)
+#define CHI(a, b, c) _mm256_xor_si256(a, _mm256_andnot_si256(b, c))
+#define ROL(a, n) _mm256_or_si256(_mm256_slli_epi64(a, n), _mm256_srli_epi64(a, 64 - (n)))
+#define XOR_RC(a, i) _mm256_xor_si256(a, _mm256_set1_epi64x((long long)(sha3::g_roundConstants64[i])))
+
+			TARGET_AVX2
+			static void SHAKE256_Parallel_AVX2(const sl_uint8* const* inputs, sl_size size, sl_uint8* outputs) noexcept
+			{
+				PRIV_SHAKE256_PARALLEL
+			}
+
+#undef N
+#undef VEC
+#undef VEC_ZERO
+#undef VEC_LOAD
+#undef VEC_STORE
+#undef VEC_GATHER
+#undef XOR
+#undef XOR5
+#undef CHI
+#undef ROL
+#undef XOR_RC
+
+#define N 8
+#define VEC __m512i
+#define VEC_ZERO _mm512_setzero_si512()
+#define VEC_LOAD(p) _mm512_loadu_si512((const void*)(p))
+#define VEC_STORE(p, a) _mm512_storeu_si512((void*)(p), a)
+#define VEC_GATHER(p, offsets) _mm512_i64gather_epi64(offsets, (const void*)(p), 1)
+#define XOR(a, b) _mm512_xor_si512(a, b)
+#define XOR5(a, b, c, d, e) _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a, b, c, 0x96), d, e, 0x96)
+#define CHI(a, b, c) _mm512_ternarylogic_epi64(a, b, c, 0xD2)
+#define ROL(a, n) _mm512_rol_epi64(a, n)
+#define XOR_RC(a, i) _mm512_xor_si512(a, _mm512_set1_epi64((long long)(sha3::g_roundConstants64[i])))
+
+			TARGET_AVX512
+			static void SHAKE256_Parallel_AVX512(const sl_uint8* const* inputs, sl_size size, sl_uint8* outputs) noexcept
+			{
+				PRIV_SHAKE256_PARALLEL
+			}
+
+#undef N
+#undef VEC
+#undef VEC_ZERO
+#undef VEC_LOAD
+#undef VEC_STORE
+#undef VEC_GATHER
+#undef XOR
+#undef XOR5
+#undef CHI
+#undef ROL
+#undef XOR_RC
+
+			sl_uint32 GetParallelCount() noexcept
+			{
+				if (Cpu::isSupportedAVX512F()) {
+					return 8;
+				}
+				if (Cpu::isSupportedAVX2()) {
+					return 4;
+				}
+				return 0;
+			}
+
+			void SHAKE256_Parallel(const sl_uint8* const* inputs, sl_size size, sl_uint8* outputs) noexcept
+			{
+				if (Cpu::isSupportedAVX512F()) {
+					SHAKE256_Parallel_AVX512(inputs, size, outputs);
+				} else {
+					SHAKE256_Parallel_AVX2(inputs, size, outputs);
+				}
+			}
+
+#else
+
+			sl_uint32 GetParallelCount() noexcept
+			{
+				return 0;
+			}
+
+			void SHAKE256_Parallel(const sl_uint8* const* inputs, sl_size size, sl_uint8* outputs) noexcept
+			{
+			}
+
+#endif
+
+		}
+	}
+
+}
@@ -0,0 +1,138 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CRYPTO_SHA3_SIMD
+#define CHECKHEADER_SLIB_CRYPTO_SHA3_SIMD
+
+#include "slib/crypto/definition.h"
+
+/*
+	Keccak-f[1600] on 64-bit lanes, and the multi-way permutations running 4 (AVX2) or 8 (AVX-512) independent states in the lanes of vector registers
+*/
+
+#define PRIV_KECCAK_MAX_PARALLEL 8
+
+/*
+	One round of Keccak-f[1600] from the lanes `A##xy` to `E##xy`, where `y` is one of (b, g, k, m, s) and `x` is one of (a, e, i, o, u).
+	The lane (x, y) of the state is stored at [x + 5 * y].
+	Expects the local variables `Cx`, `Dx`, `Bbx`, and the operations `XOR(a, b)`, `XOR5(a, b, c, d, e)`, `CHI(a, b, c)`: (a ^ (~b & c)), `ROL(a, n)`, `XOR_RC(a, i)`: (a ^ RC[i])
+*/
+#define PRIV_KECCAK_ROUND(A, E, i) \
+	Ca = XOR5(A##ba, A##ga, A##ka, A##ma, A##sa); \
+	Ce = XOR5(A##be, A##ge, A##ke, A##me, A##se); \
+	Ci = XOR5(A##bi, A##gi, A##ki, A##mi, A##si); \
+	Co = XOR5(A##bo, A##go, A##ko, A##mo, A##so); \
+	Cu = XOR5(A##bu, A##gu, A##ku, A##mu, A##su); \
+	Da = XOR(Cu, ROL(Ce, 1)); \
+	De = XOR(Ca, ROL(Ci, 1)); \
+	Di = XOR(Ce, ROL(Co, 1)); \
+	Do = XOR(Ci, ROL(Cu, 1)); \
+	Du = XOR(Co, ROL(Ca, 1)); \
+	Bba = XOR(A##ba, Da); \
+	Bbe = ROL(XOR(A##ge, De), 44); \
+	Bbi = ROL(XOR(A##ki, Di), 43); \
+	Bbo = ROL(XOR(A##mo, Do), 21); \
+	Bbu = ROL(XOR(A##su, Du), 14); \
+	E##ba = XOR_RC(CHI(Bba, Bbe, Bbi), i); \
+	E##be = CHI(Bbe, Bbi, Bbo); \
+	E##bi = CHI(Bbi, Bbo, Bbu); \
+	E##bo = CHI(Bbo, Bbu, Bba); \
+	E##bu = CHI(Bbu, Bba, Bbe); \
+	Bba = ROL(XOR(A##bo, Do), 28); \
+	Bbe = ROL(XOR(A##gu, Du), 20); \
+	Bbi = ROL(XOR(A##ka, Da), 3); \
+	Bbo = ROL(XOR(A##me, De), 45); \
+	Bbu = ROL(XOR(A##si, Di), 61); \
+	E##ga = CHI(Bba, Bbe, Bbi); \
+	E##ge = CHI(Bbe, Bbi, Bbo); \
+	E##gi = CHI(Bbi, Bbo, Bbu); \
+	E##go = CHI(Bbo, Bbu, Bba); \
+	E##gu = CHI(Bbu, Bba, Bbe); \
+	Bba = ROL(XOR(A##be, De), 1); \
+	Bbe = ROL(XOR(A##gi, Di), 6); \
+	Bbi = ROL(XOR(A##ko, Do), 25); \
+	Bbo = ROL(XOR(A##mu, Du), 8); \
+	Bbu = ROL(XOR(A##sa, Da), 18); \
+	E##ka = CHI(Bba, Bbe, Bbi); \
+	E##ke = CHI(Bbe, Bbi, Bbo); \
+	E##ki = CHI(Bbi, Bbo, Bbu); \
+	E##ko = CHI(Bbo, Bbu, Bba); \
+	E##ku = CHI(Bbu, Bba, Bbe); \
+	Bba = ROL(XOR(A##bu, Du), 27); \
+	Bbe = ROL(XOR(A##ga, Da), 36); \
+	Bbi = ROL(XOR(A##ke, De), 10); \
+	Bbo = ROL(XOR(A##mi, Di), 15); \
+	Bbu = ROL(XOR(A##so, Do), 56); \
+	E##ma = CHI(Bba, Bbe, Bbi); \
+	E##me = CHI(Bbe, Bbi, Bbo); \
+	E##mi = CHI(Bbi, Bbo, Bbu); \
+	E##mo = CHI(Bbo, Bbu, Bba); \
+	E##mu = CHI(Bbu, Bba, Bbe); \
+	Bba = ROL(XOR(A##bi, Di), 62); \
+	Bbe = ROL(XOR(A##go, Do), 55); \
+	Bbi = ROL(XOR(A##ku, Du), 39); \
+	Bbo = ROL(XOR(A##ma, Da), 41); \
+	Bbu = ROL(XOR(A##se, De), 2); \
+	E##sa = CHI(Bba, Bbe, Bbi); \
+	E##se = CHI(Bbe, Bbi, Bbo); \
+	E##si = CHI(Bbi, Bbo, Bbu); \
+	E##so = CHI(Bbo, Bbu, Bba); \
+	E##su = CHI(Bbu, Bba, Bbe);
+
+// Applies `OP(name, index)` to all lanes
+#define PRIV_KECCAK_LANES(OP) \
+	OP(ba, 0) OP(be, 1) OP(bi, 2) OP(bo, 3) OP(bu, 4) \
+	OP(ga, 5) OP(ge, 6) OP(gi, 7) OP(go, 8) OP(gu, 9) \
+	OP(ka, 10) OP(ke, 11) OP(ki, 12) OP(ko, 13) OP(ku, 14) \
+	OP(ma, 15) OP(me, 16) OP(mi, 17) OP(mo, 18) OP(mu, 19) \
+	OP(sa, 20) OP(se, 21) OP(si, 22) OP(so, 23) OP(su, 24)
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace sha3
+		{
+
+			extern const sl_uint64 g_roundConstants64[24];
+
+		}
+
+		namespace sha3_simd
+		{
+
+			// 8 (AVX-512), 4 (AVX2), 0 (not supported)
+			sl_uint32 GetParallelCount() noexcept;
+
+			/*
+				Hashes `GetParallelCount()` messages having same size by SHAKE256, extracting 64 bytes from each
+				outputs: 64 bytes per message
+			*/
+			void SHAKE256_Parallel(const sl_uint8* const* inputs, sl_size size, sl_uint8* outputs) noexcept;
+
+		}
+	}
+
+}
+
+#endif
@@ -0,0 +1,542 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "sha_simd.h"
+
+#include "slib/core/cpu.h"
+
+#if !defined(SLIB_PLATFORM_IS_MOBILE) && defined(SLIB_ARCH_IS_X64)
+#	define SUPPORT_SHA_NI
+#	define SUPPORT_MULTI_BUFFER
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#		define TARGET_SHA
+#		define TARGET_AVX2
+#		define TARGET_AVX512
+#	else
+#		include <immintrin.h>
+#		define TARGET_SHA __attribute__((target("sha,sse4.1")))
+#		define TARGET_AVX2 __attribute__((target("avx2")))
+#		define TARGET_AVX512 __attribute__((target("avx2,avx512f")))
+#	endif
+#elif defined(SLIB_ARCH_IS_ARM64) && (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#	define SUPPORT_ARM_SHA
+#	include <arm_neon.h>
+#endif
+
+#define PRIV_SHA_16(STEP) STEP(0) STEP(1) STEP(2) STEP(3) STEP(4) STEP(5) STEP(6) STEP(7) STEP(8) STEP(9) STEP(10) STEP(11) STEP(12) STEP(13) STEP(14) STEP(15)
+#define PRIV_SHA_20(STEP) PRIV_SHA_16(STEP) STEP(16) STEP(17) STEP(18) STEP(19)
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace sha_simd
+		{
+
+#if defined(SUPPORT_SHA_NI) || defined(SUPPORT_ARM_SHA) || defined(SUPPORT_MULTI_BUFFER)
+			SLIB_ALIGN(16) static const sl_uint32 g_K256[64] = {
+				0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul,
+				0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
+				0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul,
+				0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
+				0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul,
+				0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
+				0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul,
+				0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
+				0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul,
+				0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
+				0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul,
+				0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
+				0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul,
+				0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
+				0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul,
+				0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul,
+			};
+#endif
+
+#if defined(SUPPORT_SHA_NI)
+
+			TARGET_SHA
+			static void SHA1_UpdateBlocks_NI(sl_uint32* h, const sl_uint8* input, sl_size nBlocks) noexcept
+			{
+				const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+				__m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)h), 0x1B);
+				__m128i e0 = _mm_set_epi32((int)(h[4]), 0, 0, 0);
+				__m128i e1;
+				for (; nBlocks; nBlocks--) {
+					__m128i saveABCD = abcd;
+					__m128i saveE = e0;
+					__m128i m[4];
+					m[0] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)input), mask);
+					m[1] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 16)), mask);
+					m[2] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 32)), mask);
+					m[3] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 48)), mask);
+					// 4 rounds per step, m[k & 3] holds the words (4 * k) ~ (4 * k + 3)
+#define PRIV_SHA1_NI_STEP(k) \
+	if (!(k)) { \
+		e0 = _mm_add_epi32(e0, m[0]); \
+		e1 = abcd; \
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, 0); \
+	} else if ((k) & 1) { \
+		e1 = _mm_sha1nexte_epu32(e1, m[(k) & 3]); \
+		e0 = abcd; \
+		abcd = _mm_sha1rnds4_epu32(abcd, e1, (k) / 5); \
+	} else { \
+		e0 = _mm_sha1nexte_epu32(e0, m[(k) & 3]); \
+		e1 = abcd; \
+		abcd = _mm_sha1rnds4_epu32(abcd, e0, (k) / 5); \
+	} \
+	if ((k) >= 3 && (k) < 19) { \
+		m[((k) + 1) & 3] = _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(m[((k) + 1) & 3], m[((k) + 2) & 3]), m[((k) + 3) & 3]), m[(k) & 3]); \
+	}
+					PRIV_SHA_20(PRIV_SHA1_NI_STEP)
+#undef PRIV_SHA1_NI_STEP
+					e0 = _mm_sha1nexte_epu32(e0, saveE);
+					abcd = _mm_add_epi32(abcd, saveABCD);
+					input += 64;
+				}
+				_mm_storeu_si128((__m128i*)h, _mm_shuffle_epi32(abcd, 0x1B));
+				h[4] = (sl_uint32)(_mm_extract_epi32(e0, 3));
+			}
+
+			TARGET_SHA
+			static void SHA256_UpdateBlocks_NI(sl_uint32* h, const sl_uint8* input, sl_size nBlocks) noexcept
+			{
+				const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+				__m128i t = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)h), 0xB1); // CDAB
+				__m128i s1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(h + 4)), 0x1B); // EFGH
+				__m128i s0 = _mm_alignr_epi8(t, s1, 8); // ABEF
+				s1 = _mm_blend_epi16(s1, t, 0xF0); // CDGH
+				for (; nBlocks; nBlocks--) {
+					__m128i save0 = s0;
+					__m128i save1 = s1;
+					__m128i m[4];
+					m[0] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)input), mask);
+					m[1] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 16)), mask);
+					m[2] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 32)), mask);
+					m[3] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(input + 48)), mask);
+					// 4 rounds per step, m[k & 3] holds the words (4 * k) ~ (4 * k + 3)
+#define PRIV_SHA256_NI_STEP(k) \
+	{ \
+		__m128i w = _mm_add_epi32(m[(k) & 3], _mm_load_si128((const __m128i*)(g_K256 + 4 * (k)))); \
+		s1 = _mm_sha256rnds2_epu32(s1, s0, w); \
+		s0 = _mm_sha256rnds2_epu32(s0, s1, _mm_shuffle_epi32(w, 0x0E)); \
+		if ((k) >= 3 && (k) < 15) { \
+			m[((k) + 1) & 3] = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(m[((k) + 1) & 3], m[((k) + 2) & 3]), _mm_alignr_epi8(m[(k) & 3], m[((k) + 3) & 3], 4)), m[(k) & 3]); \
+		} \
+	}
+					PRIV_SHA_16(PRIV_SHA256_NI_STEP)
+#undef PRIV_SHA256_NI_STEP
+					s0 = _mm_add_epi32(s0, save0);
+					s1 = _mm_add_epi32(s1, save1);
+					input += 64;
+				}
+				t = _mm_shuffle_epi32(s0, 0x1B); // FEBA
+				s1 = _mm_shuffle_epi32(s1, 0xB1); // DCHG
+				_mm_storeu_si128((__m128i*)h, _mm_blend_epi16(t, s1, 0xF0)); // DCBA
+				_mm_storeu_si128((__m128i*)(h + 4), _mm_alignr_epi8(s1, t, 8)); // HGFE
+			}
+
+			sl_bool IsSupportedSHA1() noexcept
+			{
+				return Cpu::isSupportedSHA();
+			}
+
+			void SHA1_UpdateBlocks(sl_uint32* h, const sl_uint8* input, sl_size nBlocks) noexcept
+			{
+				SHA1_UpdateBlocks_NI(h, input, nBlocks);
+			}
+
+			sl_bool IsSupportedSHA256() noexcept
+			{
+				return Cpu::isSupportedSHA();
+			}
+
+			void SHA256_UpdateBlocks(sl_uint32* h, const sl_uint8* input, sl_size nBlocks) noexcept
+			{
+				SHA256_UpdateBlocks_NI(h, input, nBlocks);
+			}
+
+#elif defined(SUPPORT_ARM_SHA)
+
+			sl_bool IsSupportedSHA1() noexcept
+			{
+				return sl_true;
+			}
+
+			void SHA1_UpdateBlocks(sl_uint32* h, const sl_uint8* input, sl_size nBlocks) noexcept
+			{
+				static const sl_uint32 K[4] = { 0x5A827999ul, 0x6ED9EBA1ul, 0x8F1BBCDCul, 0xCA62C1D6ul };
+				uint32x4_t abcd = vld1q_u32(h);
+				sl_uint32 e0 = h[4];
+				for (; nBlocks; nBlocks--) {
+					uint32x4_t saveABCD = abcd;
+					sl_uint32 saveE = e0;
+					uint32x4_t m[4];
+					m[0] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(input)));
+					m[1] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(input + 16)));
+					m[2] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(input + 32)));
+					m[3] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(input + 48)));
+					// 4 rounds per step, m[k & 3] holds the words (4 * k) ~ (4 * k + 3)
+#define PRIV_SHA1_ARM_STEP(k) \
+	{ \
+		uint32x4_t w = vaddq_u32(m[(k) & 3], vdupq_n_u32(K[(k) / 5])); \
+		sl_uint32 e1 = vsha1h_u32(vgetq_lane_u32(abcd, 0)); \
+		if ((k) < 5) { \
+			abcd = vsha1cq_u32(abcd, e0, w); \
+		} else if ((k) >= 10 && (k) < 15) { \
+			abcd = vsha1mq_u32(abcd, e0, w); \
+		} else { \
+			abcd = vsha1pq_u32(abcd, e0, w); \
+		} \
+		e0 = e1; \
+		if ((k) < 16) { \
+			m[(k) & 3] = vsha1su1q_u32(vsha1su0q_u32(m[(k) & 3], m[((k) + 1) & 3], m[((k) + 2) & 3]), m[((k) + 3) & 3]); \
+		} \
+	}
+					PRIV_SHA_20(PRIV_SHA1_ARM_STEP)
+#undef PRIV_SHA1_ARM_STEP
+					abcd = vaddq_u32(abcd, saveABCD);
+					e0 += saveE;
+					input += 64;
+				}
+				vst1q_u32(h, abcd);
+				h[4] = e0;
+			}
+
+			sl_bool IsSupportedSHA256() noexcept
+			{
+				return sl_true;
+			}
+
+			void SHA256_UpdateBlocks(sl_uint32* h, const sl_uint8* input, sl_size nBlocks) noexcept
+			{
+				uint32x4_t s0 = vld1q_u32(h);
+				uint32x4_t s1 = vld1q_u32(h + 4);
+				for (; nBlocks; nBlocks--) {
+					uint32x4_t save0 = s0;
+					uint32x4_t save1 = s1;
+					uint32x4_t m[4];
+					m[0] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(input)));
+					m[1] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(input + 16)));
+					m[2] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(input + 32)));
+					m[3] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(input + 48)));
+					// 4 rounds per step, m[k & 3] holds the words (4 * k) ~ (4 * k + 3)
+#define PRIV_SHA256_ARM_STEP(k) \
+	{ \
+		uint32x4_t w = vaddq_u32(m[(k) & 3], vld1q_u32(g_K256 + 4 * (k))); \
+		uint32x4_t t = s0; \
+		s0 = vsha256hq_u32(s0, s1, w); \
+		s1 = vsha256h2q_u32(s1, t, w); \
+		if ((k) < 12) { \
+			m[(k) & 3] = vsha256su1q_u32(vsha256su0q_u32(m[(k) & 3], m[((k) + 1) & 3]), m[((k) + 2) & 3], m[((k) + 3) & 3]); \
+		} \
+	}
+					PRIV_SHA_16(PRIV_SHA256_ARM_STEP)
+#undef PRIV_SHA256_ARM_STEP
+					s0 = vaddq_u32(s0, save0);
+					s1 = vaddq_u32(s1, save1);
+					input += 64;
+				}
+				vst1q_u32(h, s0);
+				vst1q_u32(h + 4, s1);
+			}
+
+#else
+
+			sl_bool IsSupportedSHA1() noexcept
+			{
+				return sl_false;
+			}
+
+			void SHA1_UpdateBlocks(sl_uint32* h, const sl_uint8* input, sl_size nBlocks) noexcept
+			{
+			}
+
+			sl_bool IsSupportedSHA256() noexcept
+			{
+				return sl_false;
+			}
+
+			void SHA256_UpdateBlocks(sl_uint32* h, const sl_uint8* input, sl_size nBlocks) noexcept
+			{
+			}
+
+#endif
+
+#if defined(SUPPORT_MULTI_BUFFER)
+
+#define PRIV_SHA256_S0(x) VEC_XOR3(VEC_ROTR(x, 2), VEC_ROTR(x, 13), VEC_ROTR(x, 22))
+#define PRIV_SHA256_S1(x) VEC_XOR3(VEC_ROTR(x, 6), VEC_ROTR(x, 11), VEC_ROTR(x, 25))
+#define PRIV_SHA256_SIGMA0(x) VEC_XOR3(VEC_ROTR(x, 7), VEC_ROTR(x, 18), VEC_SHR(x, 3))
+#define PRIV_SHA256_SIGMA1(x) VEC_XOR3(VEC_ROTR(x, 17), VEC_ROTR(x, 19), VEC_SHR(x, 10))
+
+#define PRIV_SHA256_ROUND(a, b, c, d, e, f, g, h, i) \
+	{ \
+		VEC t1 = VEC_ADD(VEC_ADD(h, PRIV_SHA256_S1(e)), VEC_ADD(VEC_CH(e, f, g), VEC_ADD(VEC_SET1(g_K256[i]), W[i]))); \
+		VEC t2 = VEC_ADD(PRIV_SHA256_S0(a), VEC_MAJ(a, b, c)); \
+		d = VEC_ADD(d, t1); \
+		h = VEC_ADD(t1, t2); \
+	}
+
+			// W[0] ~ W[15]: message words; S[0] ~ S[7]: states
+#define PRIV_SHA256_COMPRESS \
+	{ \
+		sl_uint32 i; \
+		for (i = 16; i < 64; i++) { \
+			W[i] = VEC_ADD(VEC_ADD(PRIV_SHA256_SIGMA1(W[i - 2]), W[i - 7]), VEC_ADD(PRIV_SHA256_SIGMA0(W[i - 15]), W[i - 16])); \
+		} \
+		VEC a = S[0]; VEC b = S[1]; VEC c = S[2]; VEC d = S[3]; \
+		VEC e = S[4]; VEC f = S[5]; VEC g = S[6]; VEC h = S[7]; \
+		for (i = 0; i < 64; i += 8) { \
+			PRIV_SHA256_ROUND(a, b, c, d, e, f, g, h, i) \
+			PRIV_SHA256_ROUND(h, a, b, c, d, e, f, g, i + 1) \
+			PRIV_SHA256_ROUND(g, h, a, b, c, d, e, f, i + 2) \
+			PRIV_SHA256_ROUND(f, g, h, a, b, c, d, e, i + 3) \
+			PRIV_SHA256_ROUND(e, f, g, h, a, b, c, d, i + 4) \
+			PRIV_SHA256_ROUND(d, e, f, g, h, a, b, c, i + 5) \
+			PRIV_SHA256_ROUND(c, d, e, f, g, h, a, b, i + 6) \
+			PRIV_SHA256_ROUND(b, c, d, e, f, g, h, a, i + 7) \
+		} \
+		S[0] = VEC_ADD(S[0], a); S[1] = VEC_ADD(S[1], b); S[2] = VEC_ADD(S[2], c); S[3] = VEC_ADD(S[3], d); \
+		S[4] = VEC_ADD(S[4], e); S[5] = VEC_ADD(S[5], f); S[6] = VEC_ADD(S[6], g); S[7] = VEC_ADD(S[7], h); \
+	}
+
+#define VEC __m256i
+#define VEC_ADD(a, b) _mm256_add_epi32(a, b)
+#define VEC_SET1(a) _mm256_set1_epi32((int)(a))
+#define VEC_ROTR(a, n) _mm256_or_si256(_mm256_srli_epi32(a, n), _mm256_slli_epi32(a, 32 - (n)))
+#define VEC_SHR(a, n) _mm256_srli_epi32(a, n)
+#define VEC_XOR3(a, b, c) _mm256_xor_si256(_mm256_xor_si256(a, b), c)
+#define VEC_CH(e, f, g) _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g))
+#define VEC_MAJ(a, b, c) _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b)))
+
+			TARGET_AVX2
+			static void SHA256_Compress_AVX2(sl_uint32* states, __m256i* W) noexcept
+			{
+				__m256i S[8];
+				for (sl_uint32 k = 0; k < 8; k++) {
+					S[k] = _mm256_loadu_si256((const __m256i*)(states + (k << 3)));
+				}
+				PRIV_SHA256_COMPRESS
+				for (sl_uint32 k = 0; k < 8; k++) {
+					_mm256_storeu_si256((__m256i*)(states + (k << 3)), S[k]);
+				}
+			}
+
+			TARGET_AVX2
+			static void SHA256_UpdateLanes_AVX2(sl_uint32* states, const sl_uint32* words) noexcept
+			{
+				__m256i W[64];
+				for (sl_uint32 k = 0; k < 16; k++) {
+					W[k] = _mm256_loadu_si256((const __m256i*)(words + (k << 3)));
+				}
+				SHA256_Compress_AVX2(states, W);
+			}
+
+			TARGET_AVX2
+			static void SHA256_UpdateLanes_AVX2(sl_uint32* states, const sl_uint8* const* blocks) noexcept
+			{
+				const __m256i swap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+				__m256i W[64];
+				// 8x8 transpose of each half block
+				for (sl_uint32 k = 0; k < 16; k += 8) {
+					sl_uint32 offset = k << 2;
+					__m256i t0 = _mm256_loadu_si256((const __m256i*)(blocks[0] + offset));
+					__m256i t1 = _mm256_loadu_si256((const __m256i*)(blocks[1] + offset));
+					__m256i t2 = _mm256_loadu_si256((const __m256i*)(blocks[2] + offset));
+					__m256i t3 = _mm256_loadu_si256((const __m256i*)(blocks[3] + offset));
+					__m256i t4 = _mm256_loadu_si256((const __m256i*)(blocks[4] + offset));
+					__m256i t5 = _mm256_loadu_si256((const __m256i*)(blocks[5] + offset));
+					__m256i t6 = _mm256_loadu_si256((const __m256i*)(blocks[6] + offset));
+					__m256i t7 = _mm256_loadu_si256((const __m256i*)(blocks[7] + offset));
+					__m256i u0 = _mm256_unpacklo_epi32(t0, t1);
+					__m256i u1 = _mm256_unpackhi_epi32(t0, t1);
+					__m256i u2 = _mm256_unpacklo_epi32(t2, t3);
+					__m256i u3 = _mm256_unpackhi_epi32(t2, t3);
+					__m256i u4 = _mm256_unpacklo_epi32(t4, t5);
+					__m256i u5 = _mm256_unpackhi_epi32(t4, t5);
+					__m256i u6 = _mm256_unpacklo_epi32(t6, t7);
+					__m256i u7 = _mm256_unpackhi_epi32(t6, t7);
+					t0 = _mm256_unpacklo_epi64(u0, u2);
+					t1 = _mm256_unpackhi_epi64(u0, u2);
+					t2 = _mm256_unpacklo_epi64(u1, u3);
+					t3 = _mm256_unpackhi_epi64(u1, u3);
+					t4 = _mm256_unpacklo_epi64(u4, u6);
+					t5 = _mm256_unpackhi_epi64(u4, u6);
+					t6 = _mm256_unpacklo_epi64(u5, u7);
+					t7 = _mm256_unpackhi_epi64(u5, u7);
+					W[k] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(t0, t4, 0x20), swap);
+					W[k + 1] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(t1, t5, 0x20), swap);
+					W[k + 2] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(t2, t6, 0x20), swap);
+					W[k + 3] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(t3, t7, 0x20), swap);
+					W[k + 4] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(t0, t4, 0x31), swap);
+					W[k + 5] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(t1, t5, 0x31), swap);
+					W[k + 6] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(t2, t6, 0x31), swap);
+					W[k + 7] = _mm256_shuffle_epi8(_mm256_permute2x128_si256(t3, t7, 0x31), swap);
+				}
+				SHA256_Compress_AVX2(states, W);
+			}
+
+#undef VEC
+#undef VEC_ADD
+#undef VEC_SET1
+#undef VEC_ROTR
+#undef VEC_SHR
+#undef VEC_XOR3
+#undef VEC_CH
+#undef VEC_MAJ
+
+#define VEC __m512i
+#define VEC_ADD(a, b) _mm512_add_epi32(a, b)
+#define VEC_SET1(a) _mm512_set1_epi32((int)(a))
+#define VEC_ROTR(a, n) _mm512_ror_epi32(a, n)
+#define VEC_SHR(a, n) _mm512_srli_epi32(a, n)
+#define VEC_XOR3(a, b, c) _mm512_ternarylogic_epi32(a, b, c, 0x96)
+#define VEC_CH(e, f, g) _mm512_ternarylogic_epi32(e, f, g, 0xCA)
+#define VEC_MAJ(a, b, c) _mm512_ternarylogic_epi32(a, b, c, 0xE8)
+
+			TARGET_AVX512
+			static void SHA256_Compress_AVX512(sl_uint32* states, __m512i* W) noexcept
+			{
+				__m512i S[8];
+				for (sl_uint32 k = 0; k < 8; k++) {
+					S[k] = _mm512_loadu_si512((const void*)(states + (k << 4)));
+				}
+				PRIV_SHA256_COMPRESS
+				for (sl_uint32 k = 0; k < 8; k++) {
+					_mm512_storeu_si512((void*)(states + (k << 4)), S[k]);
+				}
+			}
+
+			TARGET_AVX512
+			static void SHA256_UpdateLanes_AVX512(sl_uint32* states, const sl_uint32* words) noexcept
+			{
+				__m512i W[64];
+				for (sl_uint32 k = 0; k < 16; k++) {
+					W[k] = _mm512_loadu_si512((const void*)(words + (k << 4)));
+				}
+				SHA256_Compress_AVX512(states, W);
+			}
+
+			TARGET_AVX512
+			static void SHA256_UpdateLanes_AVX512(sl_uint32* states, const sl_uint8* const* blocks) noexcept
+			{
+				const __m512i maskOdd = _mm512_set1_epi32(0xFF00FF00);
+				__m512i W[64];
+				__m512i v[16];
+				// 4x4 transpose of the words in each 128-bit lane of 4 blocks
+				// after that, the 128-bit lane L of v[4 * G + j] holds the words (4 * L + j) of the blocks (4 * G) ~ (4 * G + 3)
+				for (sl_uint32 G = 0; G < 4; G++) {
+					const sl_uint8* const* p = blocks + (G << 2);
+					__m512i t0 = _mm512_loadu_si512((const void*)(p[0]));
+					__m512i t1 = _mm512_loadu_si512((const void*)(p[1]));
+					__m512i t2 = _mm512_loadu_si512((const void*)(p[2]));
+					__m512i t3 = _mm512_loadu_si512((const void*)(p[3]));
+					__m512i u0 = _mm512_unpacklo_epi32(t0, t1);
+					__m512i u1 = _mm512_unpacklo_epi32(t2, t3);
+					__m512i u2 = _mm512_unpackhi_epi32(t0, t1);
+					__m512i u3 = _mm512_unpackhi_epi32(t2, t3);
+					v[G << 2] = _mm512_unpacklo_epi64(u0, u1);
+					v[(G << 2) + 1] = _mm512_unpackhi_epi64(u0, u1);
+					v[(G << 2) + 2] = _mm512_unpacklo_epi64(u2, u3);
+					v[(G << 2) + 3] = _mm512_unpackhi_epi64(u2, u3);
+				}
+				for (sl_uint32 j = 0; j < 4; j++) {
+					__m512i a = _mm512_shuffle_i32x4(v[j], v[4 + j], 0x44);
+					__m512i b = _mm512_shuffle_i32x4(v[j], v[4 + j], 0xEE);
+					__m512i c = _mm512_shuffle_i32x4(v[8 + j], v[12 + j], 0x44);
+					__m512i d = _mm512_shuffle_i32x4(v[8 + j], v[12 + j], 0xEE);
+					W[j] = _mm512_shuffle_i32x4(a, c, 0x88);
+					W[4 + j] = _mm512_shuffle_i32x4(a, c, 0xDD);
+					W[8 + j] = _mm512_shuffle_i32x4(b, d, 0x88);
+					W[12 + j] = _mm512_shuffle_i32x4(b, d, 0xDD);
+				}
+				// byte swap of 32-bit words, without AVX512BW
+				for (sl_uint32 k = 0; k < 16; k++) {
+					__m512i x = W[k];
+					W[k] = _mm512_or_si512(_mm512_ror_epi32(_mm512_andnot_si512(maskOdd, x), 8), _mm512_rol_epi32(_mm512_and_si512(maskOdd, x), 8));
+				}
+				SHA256_Compress_AVX512(states, W);
+			}
+
+#undef VEC
+#undef VEC_ADD
+#undef VEC_SET1
+#undef VEC_ROTR
+#undef VEC_SHR
+#undef VEC_XOR3
+#undef VEC_CH
+#undef VEC_MAJ
+
+			sl_uint32 GetSHA256LaneCount() noexcept
+			{
+				if (Cpu::isSupportedAVX512F()) {
+					return 16;
+				}
+				if (Cpu::isSupportedAVX2()) {
+					return 8;
+				}
+				return 0;
+			}
+
+			void SHA256_UpdateLanes(sl_uint32* states, const sl_uint32* words) noexcept
+			{
+				if (Cpu::isSupportedAVX512F()) {
+					SHA256_UpdateLanes_AVX512(states, words);
+				} else {
+					SHA256_UpdateLanes_AVX2(states, words);
+				}
+			}
+
+			void SHA256_UpdateLanes(sl_uint32* states, const sl_uint8* const* blocks) noexcept
+			{
+				if (Cpu::isSupportedAVX512F()) {
+					SHA256_UpdateLanes_AVX512(states, blocks);
+				} else {
+					SHA256_UpdateLanes_AVX2(states, blocks);
+				}
+			}
+
+#else
+
+			sl_uint32 GetSHA256LaneCount() noexcept
+			{
+				return 0;
+			}
+
+			void SHA256_UpdateLanes(sl_uint32* states, const sl_uint32* words) noexcept
+			{
+			}
+
+			void SHA256_UpdateLanes(sl_uint32* states, const sl_uint8* const* blocks) noexcept
+			{
+			}
+
+#endif
+
+		}
+	}
+
+}
@@ -0,0 +1,69 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CRYPTO_SHA_SIMD
+#define CHECKHEADER_SLIB_CRYPTO_SHA_SIMD
+
+#include "slib/crypto/definition.h"
+
+/*
+	Hardware-accelerated kernels of SHA-1 and SHA-256 (SHA extensions, ARMv8 Crypto Extension),
+	and multi-buffer SHA-256 hashing independent messages in parallel lanes (AVX2, AVX-512)
+
+	Hash states are the native words (h[0] ~ h[7]), not serialized.
+*/
+
+#define PRIV_SHA256_MAX_LANES 16
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace sha_simd
+		{
+
+			sl_bool IsSupportedSHA1() noexcept;
+
+			void SHA1_UpdateBlocks(sl_uint32* h /* 5 words */, const sl_uint8* input, sl_size nBlocks) noexcept;
+
+			sl_bool IsSupportedSHA256() noexcept;
+
+			void SHA256_UpdateBlocks(sl_uint32* h /* 8 words */, const sl_uint8* input, sl_size nBlocks) noexcept;
+
+			// 16 (AVX-512), 8 (AVX2), 0 (not supported)
+			sl_uint32 GetSHA256LaneCount() noexcept;
+
+			// The word i of the lane k is stored at [i * nLanes + k]
+			// states: 8 words per lane (inout)
+			// words: 16 message words per lane, as the big-endian values
+			void SHA256_UpdateLanes(sl_uint32* states, const sl_uint32* words) noexcept;
+
+			// blocks: a 64-byte block per lane
+			void SHA256_UpdateLanes(sl_uint32* states, const sl_uint8* const* blocks) noexcept;
+
+		}
+	}
+
+}
+
+#endif
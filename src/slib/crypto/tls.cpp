@@ -269,4 +269,9 @@ namespace slib
 	{
 	}
 
+	String TlsAsyncStream::getApplicationProtocol()
+	{
+		return sl_null;
+	}
+
 }
@@ -27,6 +27,8 @@
 
 #include "zlib/zlib.h"
 
+#include "crc32_simd.h"
+
 #undef compress
 
 #define STREAM ((z_stream*)(m_stream))
@@ -109,6 +111,36 @@ namespace slib
 		return DataFilterResult::Error;
 	}
 
+	DataFilterResult ZlibCompressor::flush32(void* output, sl_uint32 sizeOutputAvailable, sl_uint32& sizeOutputUsed)
+	{
+		if (m_flagStarted) {
+			z_stream* stream = STREAM;
+			stream->next_in = sl_null;
+			stream->avail_in = 0;
+			stream->next_out = (Bytef*)output;
+			stream->avail_out = sizeOutputAvailable;
+			int iRet = deflate(stream, Z_SYNC_FLUSH);
+			if (iRet >= 0 || iRet == Z_BUF_ERROR) {
+				sizeOutputUsed = sizeOutputAvailable - stream->avail_out;
+				if (stream->avail_out) {
+					return DataFilterResult::Finished;
+				} else {
+					return DataFilterResult::Continue;
+				}
+			}
+		}
+		sizeOutputUsed = 0;
+		return DataFilterResult::Error;
+	}
+
+	sl_bool ZlibCompressor::reset()
+	{
+		if (m_flagStarted) {
+			return deflateReset(STREAM) == Z_OK;
+		}
+		return sl_false;
+	}
+
 
 	ZlibDecompressor::ZlibDecompressor()
 	{
@@ -161,6 +193,12 @@ namespace slib
 					return DataFilterResult::Continue;
 				}
 			}
+			if (iRet == Z_BUF_ERROR) {
+				// No progress was possible (no input or no room for output), which is not fatal
+				sizeInputPassed = 0;
+				sizeOutputUsed = 0;
+				return DataFilterResult::Continue;
+			}
 		}
 		sizeInputPassed = 0;
 		sizeOutputUsed = 0;
@@ -191,6 +229,14 @@ namespace slib
 		return DataFilterResult::Error;
 	}
 
+	sl_bool ZlibDecompressor::reset()
+	{
+		if (m_flagStarted) {
+			return inflateReset(STREAM) == Z_OK;
+		}
+		return sl_false;
+	}
+
 
 	ZlibRawCompressor::ZlibRawCompressor()
 	{
@@ -347,6 +393,14 @@ namespace slib
 	sl_uint32 Crc32::extend(sl_uint32 crc, const void* _data, sl_size size)
 	{
 		const char* data = (const char*)_data;
+		if (size >= PRIV_CRC32_FOLD_MIN_SIZE && priv::crc32_simd::IsSupportedFold()) {
+			sl_size n = size & ~((sl_size)15);
+			sl_uint8 remainder[16];
+			priv::crc32_simd::Fold(~crc, (const sl_uint8*)data, n, priv::crc32_simd::g_foldConstantsCrc32, remainder);
+			crc = (sl_uint32)(::z_crc32(0xffffffff, remainder, 16));
+			data += n;
+			size -= n;
+		}
 		while (size > 0) {
 			sl_uint32 n = 0x10000000;
 			if (size < n) {
@@ -374,4 +428,9 @@ namespace slib
 		return extend(0, mem.data, mem.size);
 	}
 
+	sl_uint32 Crc32::combine(sl_uint32 crc1, sl_uint32 crc2, sl_uint64 len2)
+	{
+		return priv::crc32_simd::Combine(crc1, crc2, len2, 0xedb88320);
+	}
+
 }
@@ -23,12 +23,17 @@
 #include "slib/crypto/zstd.h"
 
 #include "slib/core/memory.h"
+#include "slib/core/thread.h"
+#include "slib/core/cpu.h"
+#include "slib/core/list.h"
 
 #include "zstd/zstd.h"
 
 #define CSTREAM ((ZSTD_CCtx*)(m_stream))
 #define DSTREAM ((ZSTD_DCtx*)(m_stream))
 
+#define MIN_PARALLEL_DECOMPRESS_SIZE 0x100000
+
 namespace slib
 {
 
@@ -164,7 +169,8 @@ namespace slib
 			if (!(ZSTD_isError(ret))) {
 				sizeInputPassed = (sl_size)(in.pos);
 				sizeOutputUsed = (sl_size)(out.pos);
-				if (ret) {
+				// Concatenated frames decode to the concatenation of their contents
+				if (ret || in.pos < in.size) {
 					return DataFilterResult::Continue;
 				} else {
 					return DataFilterResult::Finished;
@@ -242,5 +248,103 @@ namespace slib
 		return sl_null;
 	}
 
+	Memory Zstd::decompressParallel(const void* _data, sl_size size, sl_uint32 nThreads)
+	{
+		struct Frame
+		{
+			const sl_uint8* data;
+			sl_size size;
+			sl_uint8* output;
+			sl_size sizeOutput;
+		};
+		List<Frame> frames;
+		const sl_uint8* data = (const sl_uint8*)_data;
+		sl_size sizeTotal = 0;
+		while (size) {
+			size_t n = ZSTD_findFrameCompressedSize(data, (size_t)size);
+			if (ZSTD_isError(n)) {
+				return sl_null;
+			}
+			unsigned long long m = ZSTD_getFrameContentSize(data, n);
+			if (m == ZSTD_CONTENTSIZE_UNKNOWN || m == ZSTD_CONTENTSIZE_ERROR || m > (unsigned long long)(SLIB_SIZE_MAX - sizeTotal)) {
+				// Frames without the content size can only be decoded by streaming
+				return decompress(_data, (data - (const sl_uint8*)_data) + size);
+			}
+			Frame frame;
+			frame.data = data;
+			frame.size = (sl_size)n;
+			frame.output = sl_null;
+			frame.sizeOutput = (sl_size)m;
+			if (!(frames.add_NoLock(frame))) {
+				return sl_null;
+			}
+			sizeTotal += (sl_size)m;
+			data += n;
+			size -= n;
+		}
+		if (!sizeTotal) {
+			return sl_null;
+		}
+		Memory ret = Memory::create(sizeTotal);
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		sl_uint8* output = (sl_uint8*)(ret.getData());
+		ListElements<Frame> listFrames(frames);
+		sl_size i;
+		for (i = 0; i < listFrames.count; i++) {
+			listFrames[i].output = output;
+			output += listFrames[i].sizeOutput;
+		}
+		if (!nThreads) {
+			nThreads = Cpu::getCoreCount();
+		}
+		if (nThreads > listFrames.count) {
+			nThreads = (sl_uint32)(listFrames.count);
+		}
+		if (sizeTotal < MIN_PARALLEL_DECOMPRESS_SIZE) {
+			nThreads = 1;
+		}
+		Frame* pFrames = listFrames.data;
+		sl_size nFrames = listFrames.count;
+		volatile sl_reg indexLast = -1;
+		volatile sl_bool flagFailed = sl_false;
+		Function<void()> worker = [pFrames, nFrames, &indexLast, &flagFailed]() {
+			ZSTD_DCtx* dctx = ZSTD_createDCtx();
+			if (!dctx) {
+				flagFailed = sl_true;
+				return;
+			}
+			while (!flagFailed) {
+				sl_reg index = Base::interlockedIncrement(&indexLast);
+				if ((sl_size)index >= nFrames) {
+					break;
+				}
+				Frame& frame = pFrames[index];
+				size_t n = ZSTD_decompressDCtx(dctx, frame.output, (size_t)(frame.sizeOutput), frame.data, (size_t)(frame.size));
+				if (ZSTD_isError(n) || n != (size_t)(frame.sizeOutput)) {
+					flagFailed = sl_true;
+				}
+			}
+			ZSTD_freeDCtx(dctx);
+		};
+		List< Ref<Thread> > threads;
+		for (sl_uint32 k = 1; k < nThreads; k++) {
+			Ref<Thread> thread = Thread::start(worker);
+			if (thread.isNotNull()) {
+				threads.add_NoLock(Move(thread));
+			}
+		}
+		worker();
+		ListElements< Ref<Thread> > listThreads(threads);
+		for (i = 0; i < listThreads.count; i++) {
+			listThreads[i]->join();
+		}
+		if (flagFailed) {
+			return sl_null;
+		}
+		return ret;
+	}
+
 
 }
@@ -28,6 +28,12 @@
 #include "slib/crypto/sha3.h"
 #include "slib/core/file.h"
 #include "slib/core/lender.h"
+#include "slib/core/thread_pool.h"
+#include "slib/core/event.h"
+#include "slib/core/cpu.h"
+#include "slib/core/math.h"
+#include "slib/core/scoped_buffer.h"
+#include "slib/core/serialize/variable_length_integer.h"
 
 /*
 
@@ -57,6 +63,10 @@
 */
 
 #define FILE_HEADER_MIN_SIZE 256
+#define ITEM_HEADER_MAX_SIZE 56
+#define WRITE_BUFFER_SIZE 0x400000
+#define MIN_PARALLEL_HASH_SIZE 0x10000
+#define MANIFEST_ENTRY_SIZE 40
 
 namespace slib
 {
@@ -357,6 +367,9 @@ namespace slib
 				sl_uint64 m_sizeItemData;
 				sl_uint64 m_sizeItemDataWritten;
 				SHA3_256 m_hasher;
+				ParallelHash256 m_hasherTree;
+				sl_uint64 m_treeHashThreshold;
+				sl_bool m_flagTreeHash;
 
 				sl_bool m_flagEncrypted;
 				ChaCha20_IO m_ioEncrypted;
@@ -367,6 +380,8 @@ namespace slib
 				{
 					m_flagWrittenItemHeader = sl_false;
 					m_flagLockFile = sl_false;
+					m_treeHashThreshold = 0;
+					m_flagTreeHash = sl_false;
 				}
 
 				~DataPackageWriterImpl()
@@ -421,6 +436,7 @@ namespace slib
 				void _initialize(const DataPackageWriterParam& param)
 				{
 					m_flagLockFile = param.flagLockFile;
+					m_treeHashThreshold = param.treeHashThreshold;
 					if (param.encryptionKey && param.encryptionIV) {
 						m_flagEncrypted = sl_true;
 						m_ioEncrypted.setKey(param.encryptionKey);
@@ -439,21 +455,8 @@ namespace slib
 					if (!dataSize) {
 						return sl_false;
 					}
-
-					// Write File Header
-					if (!(m_file.getSize())) {
-						if (!(m_file.seekToBegin())) {
-							return sl_false;
-						}
-						m_headerFile.creationTime = m_headerFile.modifiedTime = Time::now();
-						ObjectId packageId = ObjectId::generate();
-						Base::copyMemory(m_headerFile.packageId, packageId.data, sizeof(packageId));
-						if (!(m_headerFile.write(&m_file))) {
-							return sl_false;
-						}
-						if (!(m_file.setSize(m_headerFile.endingPosition))) {
-							return sl_false;
-						}
+					if (!(_writeFileHeader())) {
+						return sl_false;
 					}
 					if (!(m_file.seek(m_headerFile.endingPosition, SeekPosition::Begin))) {
 						return sl_false;
@@ -475,7 +478,12 @@ namespace slib
 					if (m_file.writeFully(hash, sizeof(hash)) != sizeof(hash)) {
 						return sl_false;
 					}
-					m_hasher.start();
+					m_flagTreeHash = m_treeHashThreshold && dataSize >= m_treeHashThreshold;
+					if (m_flagTreeHash) {
+						m_hasherTree.start();
+					} else {
+						m_hasher.start();
+					}
 					m_positionEndingItem = m_positionItemDataHash + sizeof(hash) + dataSize;
 
 					m_sizeItemData = dataSize;
@@ -518,7 +526,11 @@ namespace slib
 							return sl_false;
 						}
 					}
-					m_hasher.update(data, size);
+					if (m_flagTreeHash) {
+						m_hasherTree.update(data, size);
+					} else {
+						m_hasher.update(data, size);
+					}
 					m_sizeItemDataWritten += size;
 					return sl_true;
 				}
@@ -537,7 +549,11 @@ namespace slib
 						return sl_false;
 					}
 					if (m_positionItemDataHash) {
-						m_hasher.finish(h);
+						if (m_flagTreeHash) {
+							m_hasherTree.finish(h);
+						} else {
+							m_hasher.finish(h);
+						}
 						if (!(m_file.seek(m_positionItemDataHash, SeekPosition::Begin))) {
 							return sl_false;
 						}
@@ -557,11 +573,179 @@ namespace slib
 					} else {
 						Base::zeroMemory(h, sizeof(_h));
 					}
+					if (!(_writeEndingPosition(m_positionEndingItem))) {
+						return sl_false;
+					}
+					m_flagWrittenItemHeader = sl_false;
+					return sl_true;
+				}
+
+				sl_bool writeItems(const DataStoreItem* items, sl_size nItems, sl_uint64* outPositions) override
+				{
+					if (m_flagWrittenItemHeader) {
+						return sl_false;
+					}
+					if (!nItems) {
+						return sl_true;
+					}
+					sl_size i;
+					for (i = 0; i < nItems; i++) {
+						if (!(items[i].size) || !(items[i].hash)) {
+							return sl_false;
+						}
+					}
+					if (!(_writeFileHeader())) {
+						return sl_false;
+					}
+					sl_uint64 positionStart = m_headerFile.endingPosition;
+					sl_uint64 position = positionStart;
+					sl_size sizeBuf = 0;
+					for (i = 0; i < nItems; i++) {
+						sl_size n = ITEM_HEADER_MAX_SIZE + items[i].size;
+						if (n > WRITE_BUFFER_SIZE) {
+							sizeBuf = WRITE_BUFFER_SIZE;
+							break;
+						}
+						sizeBuf += n;
+						if (sizeBuf > WRITE_BUFFER_SIZE) {
+							sizeBuf = WRITE_BUFFER_SIZE;
+							break;
+						}
+					}
+					Memory memBuf = Memory::create(sizeBuf);
+					if (memBuf.isNull()) {
+						return sl_false;
+					}
+					sl_uint8* buf = (sl_uint8*)(memBuf.getData());
+					// `position` of the first byte in `buf`
+					sl_uint64 positionBuf = position;
+					sl_size nBuf = 0;
+					for (i = 0; i < nItems; i++) {
+						const DataStoreItem& item = items[i];
+						if (nBuf + ITEM_HEADER_MAX_SIZE > sizeBuf) {
+							if (!(_writeBuffer(positionBuf, buf, nBuf))) {
+								return sl_false;
+							}
+							positionBuf += nBuf;
+							nBuf = 0;
+						}
+						if (outPositions) {
+							outPositions[i] = position;
+						}
+						// Item Header
+						sl_uint8* p = buf + nBuf;
+						CVLI::serialize(&p, (sl_uint32)0);
+						CVLI::serialize(&p, (sl_uint32)(item.type));
+						CVLI::serialize(&p, (sl_uint64)(item.size));
+						if (m_flagEncrypted) {
+							sl_uint8* h = (sl_uint8*)(item.hash);
+							for (sl_size k = 0; k < 32; k++) {
+								p[k] = h[k] ^ m_maskHash[k];
+							}
+						} else {
+							Base::copyMemory(p, item.hash, 32);
+						}
+						p += 32;
+						sl_size sizeHeader = p - (buf + nBuf);
+						nBuf += sizeHeader;
+						position += sizeHeader;
+						// Item Data
+						sl_uint8* data = (sl_uint8*)(item.data);
+						sl_size sizeRemain = item.size;
+						while (sizeRemain) {
+							if (nBuf == sizeBuf) {
+								if (!(_writeBuffer(positionBuf, buf, nBuf))) {
+									return sl_false;
+								}
+								positionBuf += nBuf;
+								nBuf = 0;
+							}
+							sl_size n = sizeBuf - nBuf;
+							if (n > sizeRemain) {
+								n = sizeRemain;
+							}
+							if (m_flagEncrypted) {
+								m_ioEncrypted.encrypt(position, data, buf + nBuf, n);
+							} else {
+								Base::copyMemory(buf + nBuf, data, n);
+							}
+							nBuf += n;
+							data += n;
+							position += n;
+							sizeRemain -= n;
+						}
+					}
+					if (nBuf) {
+						if (!(_writeBuffer(positionBuf, buf, nBuf))) {
+							return sl_false;
+						}
+					}
+					return _writeEndingPosition(position);
+				}
+
+				sl_bool sync() override
+				{
+					return m_file.flush();
+				}
+
+				sl_bool rollback(sl_uint64 position) override
+				{
+					m_flagWrittenItemHeader = sl_false;
+					if (position < m_headerFile.firstItemPosition || position > m_headerFile.endingPosition) {
+						return sl_false;
+					}
+					if (position == m_headerFile.endingPosition) {
+						return sl_true;
+					}
+					if (!(_writeEndingPosition(position))) {
+						return sl_false;
+					}
+					return m_file.setSize(position);
+				}
+
+				void getId(void* outId) override
+				{
+					Base::copyMemory(outId, m_headerFile.packageId, sizeof(m_headerFile.packageId));
+				}
+
+				sl_uint64 getCurrentPosition() override
+				{
+					return m_headerFile.endingPosition;
+				}
+
+			private:
+				sl_bool _writeFileHeader()
+				{
+					if (m_file.getSize()) {
+						return sl_true;
+					}
+					if (!(m_file.seekToBegin())) {
+						return sl_false;
+					}
+					m_headerFile.creationTime = m_headerFile.modifiedTime = Time::now();
+					ObjectId packageId = ObjectId::generate();
+					Base::copyMemory(m_headerFile.packageId, packageId.data, sizeof(packageId));
+					if (!(m_headerFile.write(&m_file))) {
+						return sl_false;
+					}
+					return m_file.setSize(m_headerFile.endingPosition);
+				}
+
+				sl_bool _writeBuffer(sl_uint64 position, const void* buf, sl_size size)
+				{
+					if (!(m_file.seek(position, SeekPosition::Begin))) {
+						return sl_false;
+					}
+					return m_file.writeFully(buf, size) == size;
+				}
+
+				sl_bool _writeEndingPosition(sl_uint64 position)
+				{
 					// Seek to offset of `positionEndingItem`
 					if (!(m_file.seek(36, SeekPosition::Begin))) {
 						return sl_false;
 					}
-					if (!(m_file.writeUint64(m_positionEndingItem))) {
+					if (!(m_file.writeUint64(position))) {
 						return sl_false;
 					}
 					Time time = Time::now();
@@ -569,21 +753,273 @@ namespace slib
 					if (!(m_file.writeUint64(time.toInt()))) {
 						return sl_false;
 					}
-					m_headerFile.endingPosition = m_positionEndingItem;
-					m_flagWrittenItemHeader = sl_false;
+					m_headerFile.endingPosition = position;
 					return sl_true;
 				}
 
-				void getId(void* outId) override
+			};
+
+			// `nThreads`: used by tree hash (0: number of CPU cores)
+			static void ComputeItemHash(const void* data, sl_size size, sl_uint64 treeHashThreshold, sl_uint32 nThreads, void* outHash)
+			{
+				if (treeHashThreshold && size >= treeHashThreshold) {
+					ParallelHash256 hash;
+					hash.setThreadCount(nThreads);
+					hash.start();
+					hash.update(data, size);
+					hash.finish(outHash);
+				} else {
+					SHA3_256::hash(data, size, outHash);
+				}
+			}
+
+			static sl_bool VerifyItemHash(const DataStoreItem& item, sl_uint64 treeHashThreshold, sl_uint32 nThreads)
+			{
+				if (!(item.hash) || !(item.size)) {
+					return sl_false;
+				}
+				sl_uint8 h[32];
+				ComputeItemHash(item.data, item.size, treeHashThreshold, nThreads, h);
+				return Base::equalsMemory(h, item.hash, 32);
+			}
+
+			class TaskBatch : public Referable
+			{
+			public:
+				Function<sl_bool(sl_size index)> task;
+				sl_size count;
+
+				volatile sl_reg indexLast;
+				volatile sl_reg nRunning;
+				volatile sl_bool flagFailed;
+				Ref<Event> event;
+
+			public:
+				TaskBatch(): count(0), indexLast(-1), nRunning(0), flagFailed(sl_false) {}
+
+			public:
+				void run()
 				{
-					Base::copyMemory(outId, m_headerFile.packageId, sizeof(m_headerFile.packageId));
+					while (!flagFailed) {
+						sl_reg index = Base::interlockedIncrement(&indexLast);
+						if ((sl_size)index >= count) {
+							break;
+						}
+						if (!(task(index))) {
+							flagFailed = sl_true;
+						}
+					}
+					if (!(Base::interlockedDecrement(&nRunning))) {
+						event->set();
+					}
 				}
 
-				sl_uint64 getCurrentPosition() override
+			};
+
+			static sl_uint32 GetThreadCount(sl_uint32 nMaxThreads, sl_uint64 sizeTotal)
+			{
+				if (sizeTotal < MIN_PARALLEL_HASH_SIZE) {
+					return 1;
+				}
+				return nMaxThreads ? nMaxThreads : Cpu::getCoreCount();
+			}
+
+			// FastCDC: Gear-hash based content-defined chunking with normalized chunk sizes
+			class ContentDefinedChunker
+			{
+			public:
+				sl_size sizeMin;
+				sl_size sizeNormal;
+				sl_size sizeMax;
+				sl_uint64 maskSmall; // Used before `sizeNormal`, more bits than average
+				sl_uint64 maskLarge; // Used after `sizeNormal`, less bits than average
+				sl_uint64 gear[256];
+				sl_uint64 gearShifted[256]; // gear[i] << 1
+
+			public:
+				ContentDefinedChunker()
 				{
-					return m_headerFile.endingPosition;
+					// SplitMix64 with fixed seed: chunk boundaries must not change between runs
+					sl_uint64 seed = 0;
+					for (sl_uint32 i = 0; i < 256; i++) {
+						seed += SLIB_UINT64(0x9E3779B97F4A7C15);
+						sl_uint64 z = seed;
+						z = (z ^ (z >> 30)) * SLIB_UINT64(0xBF58476D1CE4E5B9);
+						z = (z ^ (z >> 27)) * SLIB_UINT64(0x94D049BB133111EB);
+						gear[i] = z ^ (z >> 31);
+						gearShifted[i] = gear[i] << 1;
+					}
+					setAverageSize(0x10000);
+				}
+
+			public:
+				void setAverageSize(sl_uint32 sizeAverage)
+				{
+					sl_uint32 nBits = Math::getMostSignificantBits(sizeAverage);
+					if (nBits < 9) {
+						nBits = 9;
+					} else if (nBits > 29) {
+						nBits = 29;
+					}
+					nBits--;
+					sizeNormal = (sl_size)1 << nBits;
+					sizeMin = sizeNormal >> 2;
+					sizeMax = sizeNormal << 2;
+					// Masks never use the most significant bit, so that they can be tested against the shifted states
+					maskSmall = GetMask(nBits + 1);
+					maskLarge = GetMask(nBits - 1);
+				}
+
+				sl_size getChunkSize(const sl_uint8* data, sl_size size) const
+				{
+					if (size <= sizeMin) {
+						return size;
+					}
+					sl_size n = size < sizeMax ? size : sizeMax;
+					sl_size normal = sizeNormal < n ? sizeNormal : n;
+					sl_uint64 maskSmallShifted = maskSmall << 1;
+					sl_uint64 maskLargeShifted = maskLarge << 1;
+					sl_uint64 fp = 0;
+					sl_size i = sizeMin;
+					// Rolls two bytes per step: after adding the shifted gear of the first byte, `fp` holds the state of the first byte shifted by 1
+					for (; i + 2 <= normal; i += 2) {
+						fp = (fp << 2) + gearShifted[data[i]];
+						if (!(fp & maskSmallShifted)) {
+							return i + 1;
+						}
+						fp += gear[data[i + 1]];
+						if (!(fp & maskSmall)) {
+							return i + 2;
+						}
+					}
+					for (; i + 2 <= n; i += 2) {
+						fp = (fp << 2) + gearShifted[data[i]];
+						if (!(fp & maskLargeShifted)) {
+							return i + 1;
+						}
+						fp += gear[data[i + 1]];
+						if (!(fp & maskLarge)) {
+							return i + 2;
+						}
+					}
+					return n;
+				}
+
+			private:
+				static sl_uint64 GetMask(sl_uint32 nBits)
+				{
+					return ((SLIB_UINT64(1) << nBits) - 1) << (63 - nBits);
+				}
+
+			};
+
+			class ChunkInfo
+			{
+			public:
+				const sl_uint8* data;
+				sl_size size;
+				sl_uint8 hash[32];
+			};
+
+			class MemoryItemReader : public DataStoreItemReader
+			{
+			public:
+				MemoryItemReader(DataStoreItemType type, const Memory& content): m_type(type), m_content(content), m_offset(0) {}
+
+			public:
+				DataStoreItemType getType() override
+				{
+					return m_type;
+				}
+
+				sl_uint64 getSize() override
+				{
+					return m_content.getSize();
+				}
+
+				sl_reg read(void* buf, sl_size size) override
+				{
+					if (!size) {
+						return SLIB_IO_EMPTY_CONTENT;
+					}
+					sl_size sizeContent = m_content.getSize();
+					if (m_offset >= sizeContent) {
+						return SLIB_IO_ENDED;
+					}
+					sl_size limit = sizeContent - m_offset;
+					if (size > limit) {
+						size = limit;
+					}
+					Base::copyMemory(buf, (sl_uint8*)(m_content.getData()) + m_offset, size);
+					m_offset += size;
+					return size;
+				}
+
+			private:
+				DataStoreItemType m_type;
+				Memory m_content;
+				sl_size m_offset;
+
+			};
+
+			// Reads the chunks listed in the manifest one by one
+			class ChunkedItemReader : public DataStoreItemReader
+			{
+			public:
+				ChunkedItemReader(DataStore* store, DataStoreItemType type, sl_uint64 size, const Memory& manifest): m_store(store), m_type(type), m_size(size), m_manifest(manifest), m_indexChunk(0), m_offsetChunk(0)
+				{
+					m_nChunks = (manifest.getSize() - 1) / MANIFEST_ENTRY_SIZE;
+				}
+
+			public:
+				DataStoreItemType getType() override
+				{
+					return m_type;
+				}
+
+				sl_uint64 getSize() override
+				{
+					return m_size;
+				}
+
+				sl_reg read(void* buf, sl_size size) override
+				{
+					if (!size) {
+						return SLIB_IO_EMPTY_CONTENT;
+					}
+					while (m_offsetChunk >= m_chunk.getSize()) {
+						if (m_indexChunk >= m_nChunks) {
+							return SLIB_IO_ENDED;
+						}
+						const sl_uint8* entry = (const sl_uint8*)(m_manifest.getData()) + 1 + m_indexChunk * MANIFEST_ENTRY_SIZE;
+						DataStoreItemType type;
+						m_chunk = m_store->getItem(entry, &type);
+						if (m_chunk.getSize() != MIO::readUint64LE(entry + 32) || type != DataStoreItemType::Data) {
+							m_chunk.setNull();
+							return SLIB_IO_ERROR;
+						}
+						m_indexChunk++;
+						m_offsetChunk = 0;
+					}
+					sl_size limit = m_chunk.getSize() - m_offsetChunk;
+					if (size > limit) {
+						size = limit;
+					}
+					Base::copyMemory(buf, (sl_uint8*)(m_chunk.getData()) + m_offsetChunk, size);
+					m_offsetChunk += size;
+					return size;
 				}
 
+			private:
+				Ref<DataStore> m_store;
+				DataStoreItemType m_type;
+				sl_uint64 m_size;
+				Memory m_manifest;
+				sl_size m_nChunks;
+				sl_size m_indexChunk;
+				Memory m_chunk;
+				sl_size m_offsetChunk;
+
 			};
 
 			class PackageReaderLender : public SingleLender< Ref<DataPackageReader> >
@@ -619,13 +1055,37 @@ namespace slib
 				CHashMap<ObjectId, String> m_mapPackagePath;
 				CHashMap<ObjectId, PackageReaderLender> m_mapPackageReaders;
 				Ref<DataPackageWriter> m_writer;
+				String m_pathWriter;
+				sl_bool m_flagRegisteredWriter;
 				Time m_timeCreationWriter;
+
+				sl_bool m_flagSync;
+				sl_uint32 m_maxThreadCount;
+				Ref<ThreadPool> m_threadPool;
+				sl_bool m_flagOwnThreadPool;
+				SpinLock m_lockThreadPool;
+
+				sl_bool m_flagChunking;
+				sl_uint64 m_chunkingThreshold;
+				ContentDefinedChunker m_chunker;
+
+				sl_uint64 m_treeHashThreshold;
 				
 				sl_bool m_flagEncrypted;
 				sl_uint8 m_encryptionKey[32];
 				sl_uint8 m_encryptionIV[16];
 				sl_uint8 m_maskHash[32];
 
+			public:
+				DataStoreImpl(): m_flagOwnThreadPool(sl_false) {}
+
+				~DataStoreImpl()
+				{
+					if (m_flagOwnThreadPool && m_threadPool.isNotNull()) {
+						m_threadPool->release();
+					}
+				}
+
 			public:
 				static Ref<DataStoreImpl> open(const DataStoreParam& param)
 				{
@@ -660,6 +1120,19 @@ namespace slib
 			public:
 				sl_bool _initialize(const DataStoreParam& param)
 				{
+					m_flagRegisteredWriter = sl_false;
+					m_flagSync = param.flagSync;
+					m_maxThreadCount = param.maxThreadCount;
+					m_threadPool = param.threadPool;
+					m_flagChunking = param.flagChunking;
+					m_chunkingThreshold = param.chunkingThreshold;
+					m_treeHashThreshold = param.treeHashThreshold;
+					if (m_flagChunking) {
+						m_chunker.setAverageSize(param.averageChunkSize);
+						if (m_chunkingThreshold < m_chunker.sizeMax) {
+							m_chunkingThreshold = m_chunker.sizeMax;
+						}
+					}
 					// Check encryption
 					{
 						ChaCha20_FileEncryptor enc;
@@ -711,6 +1184,25 @@ namespace slib
 							SHA3_256::hash(m_encryptionKey, 32, m_maskHash);
 						}
 					}
+					// Check tree hash threshold: the content addresses depend on it, so it is fixed at the creation of the store
+					{
+						String pathTreeHash = File::concatPath(param.path, "TREEHASH");
+						Memory mem = File::readAllBytes(pathTreeHash);
+						if (mem.isNotNull()) {
+							if (mem.getSize() != 8) {
+								return sl_false;
+							}
+							if (MIO::readUint64LE(mem.getData()) != m_treeHashThreshold) {
+								return sl_false;
+							}
+						} else {
+							sl_uint8 buf[8];
+							MIO::writeUint64LE(buf, m_treeHashThreshold);
+							if (!(File::writeAllBytes(pathTreeHash, buf, sizeof(buf)))) {
+								return sl_false;
+							}
+						}
+					}
 					// enumerate package files
 					ListElements<String> files = File::getFiles(m_pathPackage);
 					for (sl_size i = 0; i < files.count; i++) {
@@ -732,37 +1224,36 @@ namespace slib
 			public:
 				Memory getItem(const void* hash, DataStoreItemType* pOutType) override
 				{
-					sl_uint8 buf[28];
-					sl_reg n;
-					if (m_flagEncrypted) {
-						sl_uint8* h = (sl_uint8*)hash;
-						sl_uint8 t[32];
-						for (sl_size i = 0; i < sizeof(t); i++) {
-							t[i] = h[i] ^ m_maskHash[i];
+					DataPackageItem item;
+					Memory mem;
+					sl_uint64 size;
+					if (_getStoredItem(hash, item, mem, size)) {
+						if (item.type == DataStoreItemType::Manifest) {
+							return _readChunkedItem(mem, size, pOutType);
+						}
+						if (mem.getSize() == size) {
+							if (pOutType) {
+								*pOutType = item.type;
+							}
+							return mem;
 						}
-						n = m_dbHash->get(t, 32, buf, sizeof(buf));
-					} else {
-						n = m_dbHash->get(hash, 32, buf, sizeof(buf));
 					}
-					if (n == sizeof(buf)) {
-						PackageReaderLender* lender = getReaderLender(ObjectId(buf));
-						if (lender) {
-							Borrower< Ref<DataPackageReader>, PackageReaderLender > borrower;
-							if (borrower.borrow(lender)) {
-								Ref<DataPackageReader>& reader = borrower.value;
-								sl_uint64 offset = MIO::readUint64LE(buf + 12);
-								DataPackageItem item;
-								Memory mem;
-								if (reader->getItemAt(offset, item, &mem)) {
-									sl_uint64 size = MIO::readUint64(buf + 20);
-									if (mem.getSize() == size) {
-										if (pOutType) {
-											*pOutType = item.type;
-										}
-										return mem;
-									}
-								}
+					return sl_null;
+				}
+
+				Ref<DataStoreItemReader> openItem(const void* hash) override
+				{
+					DataPackageItem item;
+					Memory mem;
+					sl_uint64 size;
+					if (_getStoredItem(hash, item, mem, size)) {
+						if (item.type == DataStoreItemType::Manifest) {
+							DataStoreItemType type;
+							if (CheckManifest(mem, type)) {
+								return new ChunkedItemReader(this, type, size, mem);
 							}
+						} else if (mem.getSize() == size) {
+							return new MemoryItemReader(item.type, mem);
 						}
 					}
 					return sl_null;
@@ -770,57 +1261,491 @@ namespace slib
 
 				sl_bool putItem(DataStoreItemType type, const void* hash, const void* data, sl_size size) override
 				{
+					if (m_flagChunking && size >= m_chunkingThreshold) {
+						return _putChunkedItem(type, hash, data, size, sl_false);
+					}
 					ObjectLocker lock(this);
 					sl_uint8 buf[28];
 					sl_uint8 hashMasked[32];
-					if (m_flagEncrypted) {
-						sl_uint8* h = (sl_uint8*)hash;
-						for (sl_size i = 0; i < sizeof(hashMasked); i++) {
-							hashMasked[i] = h[i] ^ m_maskHash[i];
+					const void* key = _getIndexKey(hash, hashMasked);
+					if (m_dbHash->get(key, 32, buf, sizeof(buf)) == sizeof(buf)) {
+						return MIO::readUint64LE(buf + 20) == size;
+					}
+					if (!(_prepareWriter())) {
+						return sl_false;
+					}
+					sl_uint8 hashResult[32];
+					sl_uint64 position = m_writer->getCurrentPosition();
+					if (m_writer->writeItem(type, data, size, hashResult)) {
+						if (Base::equalsMemory(hash, hashResult, sizeof(hashResult))) {
+							_registerWriter();
+							if (m_flagSync) {
+								if (!(m_writer->sync())) {
+									return sl_false;
+								}
+							}
+							m_writer->getId(buf);
+							MIO::writeUint64LE(buf + 12, position);
+							MIO::writeUint64LE(buf + 20, size);
+							return m_dbHash->put(key, 32, buf, sizeof(buf));
 						}
-						if (m_dbHash->get(hashMasked, 32, buf, sizeof(buf)) == sizeof(buf)) {
-							return MIO::readUint64LE(buf + 20) == size;
+					}
+					return sl_false;
+				}
+
+				sl_bool putItem(DataStoreItemType type, const void* data, sl_size size, void* outHash) override
+				{
+					if (!size) {
+						return sl_false;
+					}
+					if (m_flagChunking && size >= m_chunkingThreshold) {
+						ComputeItemHash(data, size, m_treeHashThreshold, m_maxThreadCount, outHash);
+						return _putChunkedItem(type, outHash, data, size, sl_true);
+					}
+					ObjectLocker lock(this);
+					if (!(_prepareWriter())) {
+						return sl_false;
+					}
+					// The item is hashed while it is written, and discarded when it is already stored
+					sl_uint64 position = m_writer->getCurrentPosition();
+					if (!(m_writer->writeItem(type, data, size, outHash))) {
+						m_writer->rollback(position);
+						return sl_false;
+					}
+					sl_uint8 buf[28];
+					sl_uint8 hashMasked[32];
+					const void* key = _getIndexKey(outHash, hashMasked);
+					if (m_dbHash->get(key, 32, buf, sizeof(buf)) == sizeof(buf)) {
+						if (!(m_writer->rollback(position))) {
+							return sl_false;
 						}
-					} else {
-						if (m_dbHash->get(hash, 32, buf, sizeof(buf)) == sizeof(buf)) {
-							return MIO::readUint64LE(buf + 20) == size;
+						return MIO::readUint64LE(buf + 20) == size;
+					}
+					_registerWriter();
+					if (m_flagSync) {
+						if (!(m_writer->sync())) {
+							return sl_false;
 						}
 					}
-					Time time = Time::now();
-					time = Time(time.getYear(), time.getMonth(), 1);
-					if (m_writer.isNull() || time != m_timeCreationWriter) {
-						String path = File::concatPath(m_pathPackage, String::concat(String::fromInt32(time.getYear()), String::fromInt32(time.getMonth(), 10, 2), ".pkg"));
-						DataPackageWriterParam param;
-						param.path = path;
-						param.flagLockFile = sl_true;
+					m_writer->getId(buf);
+					MIO::writeUint64LE(buf + 12, position);
+					MIO::writeUint64LE(buf + 20, size);
+					return m_dbHash->put(key, 32, buf, sizeof(buf));
+				}
+
+				void computeHash(const void* data, sl_size size, void* outHash) override
+				{
+					ComputeItemHash(data, size, m_treeHashThreshold, m_maxThreadCount, outHash);
+				}
+
+				sl_bool putItems(const DataStoreItem* items, sl_size nItems) override
+				{
+					if (!nItems) {
+						return sl_true;
+					}
+					if (m_flagChunking) {
+						for (sl_size i = 0; i < nItems; i++) {
+							if (items[i].size >= m_chunkingThreshold) {
+								return _putItemsWithChunking(items, nItems);
+							}
+						}
+					}
+					// Hashing is the most expensive part, so it runs without locking the store
+					if (!(_verifyItemHashes(items, nItems))) {
+						return sl_false;
+					}
+					return _putVerifiedItems(items, nItems);
+				}
+
+			private:
+				Ref<ThreadPool> _getThreadPool()
+				{
+					SpinLocker locker(&m_lockThreadPool);
+					if (m_threadPool.isNull()) {
+						m_threadPool = ThreadPool::create(0, m_maxThreadCount ? m_maxThreadCount : Cpu::getCoreCount());
+						m_flagOwnThreadPool = m_threadPool.isNotNull();
+					}
+					return m_threadPool;
+				}
+
+				// Runs `task` for the indices from 0 to `nTasks - 1` on the thread pool. The calling thread works as one of the workers
+				sl_bool _runTasks(sl_size nTasks, sl_uint64 sizeTotal, const Function<sl_bool(sl_size index)>& task)
+				{
+					sl_size nWorkers = GetThreadCount(m_maxThreadCount, sizeTotal);
+					if (nWorkers > nTasks) {
+						nWorkers = nTasks;
+					}
+					Ref<ThreadPool> pool;
+					Ref<TaskBatch> batch;
+					if (nWorkers > 1) {
+						pool = _getThreadPool();
+						batch = new TaskBatch;
+						if (batch.isNotNull()) {
+							batch->event = Event::create(sl_false);
+							if (batch->event.isNull()) {
+								batch.setNull();
+							}
+						}
+					}
+					if (pool.isNull() || batch.isNull()) {
+						for (sl_size i = 0; i < nTasks; i++) {
+							if (!(task(i))) {
+								return sl_false;
+							}
+						}
+						return sl_true;
+					}
+					batch->task = task;
+					batch->count = nTasks;
+					batch->nRunning = 1;
+					for (sl_size i = 1; i < nWorkers; i++) {
+						Base::interlockedIncrement(&(batch->nRunning));
+						if (!(pool->addTask([batch]() {
+							batch->run();
+						}))) {
+							Base::interlockedDecrement(&(batch->nRunning));
+							break;
+						}
+					}
+					batch->run();
+					while (batch->nRunning) {
+						batch->event->wait();
+					}
+					return !(batch->flagFailed);
+				}
+
+				sl_bool _verifyItemHashes(const DataStoreItem* items, sl_size nItems)
+				{
+					if (nItems == 1) {
+						return VerifyItemHash(*items, m_treeHashThreshold, m_maxThreadCount);
+					}
+					sl_uint64 sizeTotal = 0;
+					for (sl_size i = 0; i < nItems; i++) {
+						sizeTotal += items[i].size;
+					}
+					// The items are already hashed in parallel, so each tree hash runs in its task thread
+					sl_uint64 treeHashThreshold = m_treeHashThreshold;
+					return _runTasks(nItems, sizeTotal, [items, treeHashThreshold](sl_size index) {
+						return VerifyItemHash(items[index], treeHashThreshold, 1);
+					});
+				}
+
+				sl_bool _putVerifiedItems(const DataStoreItem* items, sl_size nItems)
+				{
+					SLIB_SCOPED_BUFFER(sl_uint8, 1024, bufKeys, nItems << 5)
+					SLIB_SCOPED_BUFFER(DataStoreItem, 64, newItems, nItems)
+					SLIB_SCOPED_BUFFER(sl_uint8*, 64, newKeys, nItems)
+					SLIB_SCOPED_BUFFER(sl_uint64, 64, positions, nItems)
+					if (!bufKeys || !newItems || !newKeys || !positions) {
+						return sl_false;
+					}
+					sl_size i;
+					for (i = 0; i < nItems; i++) {
+						sl_uint8* key = bufKeys + (i << 5);
 						if (m_flagEncrypted) {
-							param.encryptionKey = m_encryptionKey;
-							param.encryptionIV = m_encryptionIV;
+							_getIndexKey(items[i].hash, key);
+						} else {
+							Base::copyMemory(key, items[i].hash, 32);
+						}
+					}
+
+					ObjectLocker lock(this);
+
+					sl_size nNewItems = 0;
+					CHashMap<sl_uint64, sl_size> mapNewItems;
+					for (i = 0; i < nItems; i++) {
+						const DataStoreItem& item = items[i];
+						sl_uint8* key = bufKeys + (i << 5);
+						sl_uint8 buf[28];
+						if (m_dbHash->get(key, 32, buf, sizeof(buf)) == sizeof(buf)) {
+							if (MIO::readUint64LE(buf + 20) != item.size) {
+								return sl_false;
+							}
+							continue;
+						}
+						// skip the duplicated items in the batch
+						sl_uint64 prefix = MIO::readUint64LE(key);
+						sl_size* pIndex = mapNewItems.getItemPointer(prefix);
+						if (pIndex) {
+							if (Base::equalsMemory(newKeys[*pIndex], key, 32)) {
+								continue;
+							}
+						} else {
+							mapNewItems.put_NoLock(prefix, nNewItems);
+						}
+						newItems[nNewItems] = item;
+						newKeys[nNewItems] = key;
+						nNewItems++;
+					}
+					if (!nNewItems) {
+						return sl_true;
+					}
+
+					if (!(_prepareWriter())) {
+						return sl_false;
+					}
+					// Encryption stays in `writeItems`, under the lock: the ChaCha20 key stream is selected by the file position, which is only known while appending
+					if (!(m_writer->writeItems(newItems, nNewItems, positions))) {
+						return sl_false;
+					}
+					_registerWriter();
+					if (m_flagSync) {
+						if (!(m_writer->sync())) {
+							return sl_false;
 						}
-						m_writer = DataPackage::openWriter(param);
-						if (m_writer.isNull()) {
+					}
+
+					// The hash index is committed after the items are written, so that `getItem` never sees an incomplete item
+					Ref<KeyValueWriteBatch> batch = m_dbHash->createWriteBatch();
+					if (batch.isNull()) {
+						return sl_false;
+					}
+					sl_uint8 buf[28];
+					m_writer->getId(buf);
+					for (i = 0; i < nNewItems; i++) {
+						MIO::writeUint64LE(buf + 12, positions[i]);
+						MIO::writeUint64LE(buf + 20, newItems[i].size);
+						if (!(batch->put(newKeys[i], 32, buf, sizeof(buf)))) {
 							return sl_false;
 						}
-						m_timeCreationWriter = time;
 					}
-					sl_uint8 hashResult[32];
+					return batch->commit();
+				}
+
+				sl_bool _putItemsWithChunking(const DataStoreItem* items, sl_size nItems)
+				{
+					SLIB_SCOPED_BUFFER(DataStoreItem, 64, smallItems, nItems)
+					if (!smallItems) {
+						return sl_false;
+					}
+					sl_size nSmallItems = 0;
+					for (sl_size i = 0; i < nItems; i++) {
+						const DataStoreItem& item = items[i];
+						if (item.size >= m_chunkingThreshold) {
+							if (!(_putChunkedItem(item.type, item.hash, item.data, item.size, sl_false))) {
+								return sl_false;
+							}
+						} else {
+							smallItems[nSmallItems] = item;
+							nSmallItems++;
+						}
+					}
+					if (!nSmallItems) {
+						return sl_true;
+					}
+					if (!(_verifyItemHashes(smallItems, nSmallItems))) {
+						return sl_false;
+					}
+					return _putVerifiedItems(smallItems, nSmallItems);
+				}
+
+				// Stores the chunks as `Data` items (shared by all items through the hash index), and then the manifest under the hash of whole content
+				// `flagVerified`: `hash` is computed from `data` by the caller
+				sl_bool _putChunkedItem(DataStoreItemType type, const void* hash, const void* data, sl_size size, sl_bool flagVerified)
+				{
+					if (!hash || !size) {
+						return sl_false;
+					}
+					sl_uint8 hashMasked[32];
+					const void* key = _getIndexKey(hash, hashMasked);
+					sl_uint8 buf[28];
+					if (m_dbHash->get(key, 32, buf, sizeof(buf)) == sizeof(buf)) {
+						return MIO::readUint64LE(buf + 20) == size;
+					}
+
+					List<ChunkInfo> listChunks;
+					sl_size offset = 0;
+					while (offset < size) {
+						ChunkInfo chunk;
+						chunk.data = (const sl_uint8*)data + offset;
+						chunk.size = m_chunker.getChunkSize(chunk.data, size - offset);
+						if (!(listChunks.add_NoLock(chunk))) {
+							return sl_false;
+						}
+						offset += chunk.size;
+					}
+					ListElements<ChunkInfo> chunks(listChunks);
+					// Task 0 verifies the hash of whole content, and the others compute the hashes of the chunks
+					sl_uint64 treeHashThreshold = m_treeHashThreshold;
+					sl_bool flagSuccess = _runTasks(chunks.count + 1, size, [hash, data, size, treeHashThreshold, flagVerified, &chunks](sl_size index) {
+						if (!index) {
+							if (flagVerified) {
+								return sl_true;
+							}
+							sl_uint8 h[32];
+							ComputeItemHash(data, size, treeHashThreshold, 1, h);
+							return Base::equalsMemory(h, hash, 32);
+						}
+						ChunkInfo& chunk = chunks[index - 1];
+						ComputeItemHash(chunk.data, chunk.size, treeHashThreshold, 1, chunk.hash);
+						return sl_true;
+					});
+					if (!flagSuccess) {
+						return sl_false;
+					}
+
+					SLIB_SCOPED_BUFFER(DataStoreItem, 64, chunkItems, chunks.count)
+					if (!chunkItems) {
+						return sl_false;
+					}
+					Memory manifest = Memory::create(1 + chunks.count * MANIFEST_ENTRY_SIZE);
+					if (manifest.isNull()) {
+						return sl_false;
+					}
+					sl_uint8* entry = (sl_uint8*)(manifest.getData());
+					*(entry++) = (sl_uint8)type;
+					for (sl_size i = 0; i < chunks.count; i++) {
+						ChunkInfo& chunk = chunks[i];
+						chunkItems[i] = DataStoreItem(DataStoreItemType::Data, chunk.hash, chunk.data, chunk.size);
+						Base::copyMemory(entry, chunk.hash, 32);
+						MIO::writeUint64LE(entry + 32, chunk.size);
+						entry += MANIFEST_ENTRY_SIZE;
+					}
+					if (!(_putVerifiedItems(chunkItems, chunks.count))) {
+						return sl_false;
+					}
+
+					ObjectLocker lock(this);
+					if (!(_prepareWriter())) {
+						return sl_false;
+					}
 					sl_uint64 position = m_writer->getCurrentPosition();
-					if (m_writer->writeItem(type, data, size, hashResult)) {
-						if (Base::equalsMemory(hash, hashResult, sizeof(hashResult))) {
-							m_writer->getId(buf);
-							MIO::writeUint64LE(buf + 12, position);
-							MIO::writeUint64LE(buf + 20, size);
-							if (m_flagEncrypted) {
-								return m_dbHash->put(hashMasked, 32, buf, sizeof(buf));
-							} else {
-								return m_dbHash->put(hash, 32, buf, sizeof(buf));
+					if (!(m_writer->writeItem(DataStoreItemType::Manifest, manifest.getData(), manifest.getSize()))) {
+						return sl_false;
+					}
+					_registerWriter();
+					if (m_flagSync) {
+						if (!(m_writer->sync())) {
+							return sl_false;
+						}
+					}
+					// The index of manifest holds the size of whole content
+					m_writer->getId(buf);
+					MIO::writeUint64LE(buf + 12, position);
+					MIO::writeUint64LE(buf + 20, size);
+					return m_dbHash->put(key, 32, buf, sizeof(buf));
+				}
+
+				sl_bool _getStoredItem(const void* hash, DataPackageItem& item, Memory& mem, sl_uint64& size)
+				{
+					sl_uint8 buf[28];
+					sl_uint8 hashMasked[32];
+					const void* key = _getIndexKey(hash, hashMasked);
+					if (m_dbHash->get(key, 32, buf, sizeof(buf)) == sizeof(buf)) {
+						PackageReaderLender* lender = getReaderLender(ObjectId(buf));
+						if (lender) {
+							Borrower< Ref<DataPackageReader>, PackageReaderLender > borrower;
+							if (borrower.borrow(lender)) {
+								Ref<DataPackageReader>& reader = borrower.value;
+								sl_uint64 offset = MIO::readUint64LE(buf + 12);
+								if (reader->getItemAt(offset, item, &mem)) {
+									size = MIO::readUint64LE(buf + 20);
+									return sl_true;
+								}
 							}
 						}
 					}
 					return sl_false;
 				}
 
-			private:
+				Memory _readChunkedItem(const Memory& manifest, sl_uint64 size, DataStoreItemType* pOutType)
+				{
+					DataStoreItemType type;
+					if (!(CheckManifest(manifest, type))) {
+						return sl_null;
+					}
+					if (size > SLIB_SIZE_MAX) {
+						return sl_null;
+					}
+					Memory ret = Memory::create((sl_size)size);
+					if (ret.isNull()) {
+						return sl_null;
+					}
+					sl_uint8* output = (sl_uint8*)(ret.getData());
+					sl_size offset = 0;
+					const sl_uint8* entry = (const sl_uint8*)(manifest.getData()) + 1;
+					sl_size nChunks = (manifest.getSize() - 1) / MANIFEST_ENTRY_SIZE;
+					for (sl_size i = 0; i < nChunks; i++) {
+						DataStoreItemType typeChunk;
+						Memory chunk = getItem(entry, &typeChunk);
+						sl_size sizeChunk = chunk.getSize();
+						if (typeChunk != DataStoreItemType::Data || sizeChunk != MIO::readUint64LE(entry + 32) || sizeChunk > size - offset) {
+							return sl_null;
+						}
+						Base::copyMemory(output + offset, chunk.getData(), sizeChunk);
+						offset += sizeChunk;
+						entry += MANIFEST_ENTRY_SIZE;
+					}
+					if (offset != size) {
+						return sl_null;
+					}
+					if (pOutType) {
+						*pOutType = type;
+					}
+					return ret;
+				}
+
+				static sl_bool CheckManifest(const Memory& manifest, DataStoreItemType& outType)
+				{
+					sl_size size = manifest.getSize();
+					if (!size || (size - 1) % MANIFEST_ENTRY_SIZE) {
+						return sl_false;
+					}
+					outType = (DataStoreItemType)(*((sl_uint8*)(manifest.getData())));
+					return outType != DataStoreItemType::Manifest;
+				}
+
+				const void* _getIndexKey(const void* hash, sl_uint8* hashMasked)
+				{
+					if (m_flagEncrypted) {
+						sl_uint8* h = (sl_uint8*)hash;
+						for (sl_size i = 0; i < 32; i++) {
+							hashMasked[i] = h[i] ^ m_maskHash[i];
+						}
+						return hashMasked;
+					} else {
+						return hash;
+					}
+				}
+
+				sl_bool _prepareWriter()
+				{
+					Time time = Time::now();
+					time = Time(time.getYear(), time.getMonth(), 1);
+					if (m_writer.isNotNull() && time == m_timeCreationWriter) {
+						return sl_true;
+					}
+					String path = File::concatPath(m_pathPackage, String::concat(String::fromInt32(time.getYear()), String::fromInt32(time.getMonth(), 10, 2), ".pkg"));
+					DataPackageWriterParam param;
+					param.path = path;
+					param.flagLockFile = sl_true;
+					param.treeHashThreshold = m_treeHashThreshold;
+					if (m_flagEncrypted) {
+						param.encryptionKey = m_encryptionKey;
+						param.encryptionIV = m_encryptionIV;
+					}
+					m_writer = DataPackage::openWriter(param);
+					if (m_writer.isNull()) {
+						return sl_false;
+					}
+					m_pathWriter = Move(path);
+					m_flagRegisteredWriter = sl_false;
+					m_timeCreationWriter = time;
+					return sl_true;
+				}
+
+				// Package ID is determined after the first item is written to a new package
+				void _registerWriter()
+				{
+					if (m_flagRegisteredWriter) {
+						return;
+					}
+					sl_uint8 id[12];
+					m_writer->getId(id);
+					m_mapPackagePath.put(ObjectId(id), m_pathWriter);
+					m_flagRegisteredWriter = sl_true;
+				}
+
 				PackageReaderLender* getReaderLender(const ObjectId& packageId)
 				{
 					ObjectLocker locker(&m_mapPackageReaders);
@@ -882,7 +1807,7 @@ namespace slib
 
 	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(DataPackageWriterParam)
 
-	DataPackageWriterParam::DataPackageWriterParam(): flagLockFile(sl_false)
+	DataPackageWriterParam::DataPackageWriterParam(): flagLockFile(sl_false), treeHashThreshold(0)
 	{
 	}
 
@@ -959,7 +1884,29 @@ namespace slib
 
 	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(DataStoreParam)
 
-	DataStoreParam::DataStoreParam()
+	DataStoreParam::DataStoreParam(): flagSync(sl_false), maxThreadCount(0), flagChunking(sl_false), chunkingThreshold(0x400000), averageChunkSize(0x10000), treeHashThreshold(0)
+	{
+	}
+
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(DataStoreItem)
+
+	DataStoreItem::DataStoreItem(): type(DataStoreItemType::Data), hash(sl_null), data(sl_null), size(0)
+	{
+	}
+
+	DataStoreItem::DataStoreItem(DataStoreItemType _type, const void* _hash, const void* _data, sl_size _size): type(_type), hash(_hash), data(_data), size(_size)
+	{
+	}
+
+
+	SLIB_DEFINE_OBJECT(DataStoreItemReader, Object)
+
+	DataStoreItemReader::DataStoreItemReader()
+	{
+	}
+
+	DataStoreItemReader::~DataStoreItemReader()
 	{
 	}
 
@@ -978,5 +1925,43 @@ namespace slib
 	{
 		return Ref<DataStore>::from(DataStoreImpl::open(param));
 	}
+
+	Ref<DataStoreItemReader> DataStore::openItem(const void* hash)
+	{
+		DataStoreItemType type;
+		Memory mem = getItem(hash, &type);
+		if (mem.isNotNull()) {
+			return new MemoryItemReader(type, mem);
+		}
+		return sl_null;
+	}
+
+	sl_bool DataStore::putItem(DataStoreItemType type, const void* data, sl_size size, void* outHash)
+	{
+		computeHash(data, size, outHash);
+		return putItem(type, outHash, data, size);
+	}
+
+	void DataStore::computeHash(const void* data, sl_size size, void* outHash)
+	{
+		SHA3_256::hash(data, size, outHash);
+	}
+
+	sl_bool DataStore::putItems(const DataStoreItem* items, sl_size nItems)
+	{
+		for (sl_size i = 0; i < nItems; i++) {
+			const DataStoreItem& item = items[i];
+			if (!(putItem(item.type, item.hash, item.data, item.size))) {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
+	sl_bool DataStore::putItems(const List<DataStoreItem>& items)
+	{
+		ListLocker<DataStoreItem> list(items);
+		return putItems(list.data, list.count);
+	}
 	
 }
@@ -23,6 +23,7 @@
 #include "slib/db/key_value_store.h"
 
 #include "slib/core/variant.h"
+#include "slib/core/memory.h"
 #include "slib/core/serialize.h"
 
 #define VALUE_BUFFER_SIZE 1024
@@ -68,6 +69,13 @@ namespace slib
 	using namespace priv::kvs;
 
 
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(KeyValueIteratorParam)
+
+	KeyValueIteratorParam::KeyValueIteratorParam(): flagFillCache(sl_true), readaheadSize(0)
+	{
+	}
+
+
 	KeyValueReader::KeyValueReader()
 	{
 	}
@@ -130,6 +138,41 @@ namespace slib
 		}
 	}
 
+	sl_size KeyValueReader::multiGet(const MemoryView* keys, sl_size nKeys, MemoryData* outValues, sl_bool* outFlagsFound)
+	{
+		sl_size nFound = 0;
+		for (sl_size i = 0; i < nKeys; i++) {
+			MemoryData& value = outValues[i];
+			if (get(keys[i].data, keys[i].size, &value)) {
+				if (outFlagsFound) {
+					outFlagsFound[i] = sl_true;
+				}
+				nFound++;
+			} else {
+				value = MemoryData();
+				if (outFlagsFound) {
+					outFlagsFound[i] = sl_false;
+				}
+			}
+		}
+		return nFound;
+	}
+
+	sl_bool KeyValueReader::getPinned(const void* key, sl_size sizeKey, MemoryData* pOutValue)
+	{
+		MemoryData value;
+		if (get(key, sizeKey, &value)) {
+			*pOutValue = Move(value);
+			return sl_true;
+		}
+		return sl_false;
+	}
+
+	Ref<KeyValueIterator> KeyValueReader::getIterator(const KeyValueIteratorParam& param)
+	{
+		return getIterator();
+	}
+
 	Variant KeyValueReader::deserialize(const MemoryData& data)
 	{
 		return DeserializeValue(MemoryData(data));
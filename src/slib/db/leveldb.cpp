@@ -76,6 +76,34 @@ namespace slib
 				return sl_false;
 			}
 
+			static sl_size MultiGet(leveldb::DB* db, const leveldb::ReadOptions& options, const MemoryView* keys, sl_size nKeys, MemoryData* outValues, sl_bool* outFlagsFound)
+			{
+				sl_size nFound = 0;
+				for (sl_size i = 0; i < nKeys; i++) {
+					std::string str;
+					leveldb::Status status = db->Get(options, leveldb::Slice((char*)(keys[i].data), keys[i].size), &str);
+					sl_bool flagFound = sl_false;
+					if (status.ok()) {
+						flagFound = DecodeValue(Move(str), outValues + i);
+					}
+					if (flagFound) {
+						nFound++;
+					} else {
+						outValues[i] = MemoryData();
+					}
+					if (outFlagsFound) {
+						outFlagsFound[i] = flagFound;
+					}
+				}
+				return nFound;
+			}
+
+			static void ApplyIteratorParam(leveldb::ReadOptions& options, const KeyValueIteratorParam& param)
+			{
+				// LevelDB does not support read-ahead option
+				options.fill_cache = (bool)(param.flagFillCache);
+			}
+
 			class DefaultEnvironmentManager : public Referable
 			{
 			public:
@@ -499,6 +527,8 @@ namespace slib
 
 				Ref<KeyValueIterator> getIterator() override;
 
+				Ref<KeyValueIterator> getIterator(const KeyValueIteratorParam& param) override;
+
 				Ref<KeyValueSnapshot> getSnapshot() override;
 
 				sl_bool get(const void* key, sl_size sizeKey, MemoryData* value) override
@@ -511,6 +541,19 @@ namespace slib
 					return sl_false;
 				}
 
+				sl_size multiGet(const MemoryView* keys, sl_size nKeys, MemoryData* outValues, sl_bool* outFlagsFound) override
+				{
+					// All keys are read from the same snapshot
+					const leveldb::Snapshot* snapshot = m_db->GetSnapshot();
+					leveldb::ReadOptions options(m_optionsRead);
+					options.snapshot = snapshot;
+					sl_size nFound = MultiGet(m_db, options, keys, nKeys, outValues, outFlagsFound);
+					if (snapshot) {
+						m_db->ReleaseSnapshot(snapshot);
+					}
+					return nFound;
+				}
+
 				sl_bool put(const void* key, sl_size sizeKey, const void* value, sl_size sizeValue) override
 				{
 					leveldb::Status status = m_db->Put(m_optionsWrite, leveldb::Slice((char*)key, sizeKey), leveldb::Slice((char*)value, sizeValue));
@@ -684,11 +727,11 @@ namespace slib
 
 			};
 
-			Ref<KeyValueIterator> LevelDBImpl::getIterator()
+			static Ref<KeyValueIterator> CreateIterator(LevelDBImpl* instance, const leveldb::ReadOptions& options)
 			{
-				leveldb::Iterator* iterator = m_db->NewIterator(m_optionsRead);
+				leveldb::Iterator* iterator = instance->m_db->NewIterator(options);
 				if (iterator) {
-					Ref<KeyValueIterator> ret = new LevelDBIterator(this, iterator);
+					Ref<KeyValueIterator> ret = new LevelDBIterator(instance, iterator);
 					if (ret.isNotNull()) {
 						return ret;
 					}
@@ -697,6 +740,18 @@ namespace slib
 				return sl_null;
 			}
 
+			Ref<KeyValueIterator> LevelDBImpl::getIterator()
+			{
+				return CreateIterator(this, m_optionsRead);
+			}
+
+			Ref<KeyValueIterator> LevelDBImpl::getIterator(const KeyValueIteratorParam& param)
+			{
+				leveldb::ReadOptions options(m_optionsRead);
+				ApplyIteratorParam(options, param);
+				return CreateIterator(this, options);
+			}
+
 			class LevelDBSnapshot : public KeyValueSnapshot
 			{
 			public:
@@ -728,17 +783,21 @@ namespace slib
 					return sl_false;
 				}
 
+				sl_size multiGet(const MemoryView* keys, sl_size nKeys, MemoryData* outValues, sl_bool* outFlagsFound) override
+				{
+					return MultiGet(m_db, m_optionsRead, keys, nKeys, outValues, outFlagsFound);
+				}
+
 				Ref<KeyValueIterator> getIterator() override
 				{
-					leveldb::Iterator* iterator = m_db->NewIterator(m_optionsRead);
-					if (iterator) {
-						Ref<KeyValueIterator> ret = new LevelDBIterator(m_instance.get(), iterator);
-						if (ret.isNotNull()) {
-							return ret;
-						}
-						delete iterator;
-					}
-					return sl_null;
+					return CreateIterator(m_instance.get(), m_optionsRead);
+				}
+
+				Ref<KeyValueIterator> getIterator(const KeyValueIteratorParam& param) override
+				{
+					leveldb::ReadOptions options(m_optionsRead);
+					ApplyIteratorParam(options, param);
+					return CreateIterator(m_instance.get(), options);
 				}
 
 			};
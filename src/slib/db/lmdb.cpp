@@ -35,11 +35,106 @@ namespace slib
 		namespace lmdb
 		{
 
+			static sl_bool CopyValue(const MDB_val& v, MemoryData* value)
+			{
+				sl_size size = (sl_size)(v.mv_size);
+				if (size <= value->size) {
+					if (size) {
+						Base::copyMemory(value->data, v.mv_data, size);
+					}
+					value->size = size;
+					return sl_true;
+				}
+				Memory mem = Memory::create(v.mv_data, size);
+				if (mem.isNotNull()) {
+					*value = Move(mem);
+					return sl_true;
+				}
+				return sl_false;
+			}
+
+			static sl_size MultiGet(const Ref<Referable>& holder, MDB_txn* txn, MDB_dbi dbi, const MemoryView* keys, sl_size nKeys, MemoryData* outValues, sl_bool* outFlagsFound)
+			{
+				sl_size nFound = 0;
+				for (sl_size i = 0; i < nKeys; i++) {
+					MDB_val k, v;
+					k.mv_data = (void*)(keys[i].data);
+					k.mv_size = (size_t)(keys[i].size);
+					sl_bool flagFound = !(mdb_get(txn, dbi, &k, &v));
+					if (flagFound) {
+						outValues[i] = MemoryData(v.mv_data, (sl_size)(v.mv_size), holder);
+						nFound++;
+					} else {
+						outValues[i] = MemoryData();
+					}
+					if (outFlagsFound) {
+						outFlagsFound[i] = flagFound;
+					}
+				}
+				return nFound;
+			}
+
+			// Keeps the mapped pages of the pinned values valid
+			class LMDBReadTransaction : public Referable
+			{
+			public:
+				Ref<Referable> m_instance;
+				MDB_env* m_env;
+				MDB_txn* m_txn;
+				MDB_dbi m_dbi;
+				// Serializes the lookups, when the transaction is shared by the threads
+				SpinLock m_lock;
+
+			public:
+				LMDBReadTransaction(Referable* instance, MDB_env* env, MDB_txn* txn, MDB_dbi dbi): m_instance(instance), m_env(env), m_txn(txn), m_dbi(dbi) {}
+
+				~LMDBReadTransaction()
+				{
+					mdb_dbi_close(m_env, m_dbi);
+					mdb_txn_abort(m_txn);
+				}
+
+			public:
+				static Ref<LMDBReadTransaction> begin(Referable* instance, MDB_env* env)
+				{
+					MDB_txn* txn = sl_null;
+					int iResult = mdb_txn_begin(env, sl_null, MDB_RDONLY, &txn);
+					if (!iResult) {
+						MDB_dbi dbi = 0;
+						iResult = mdb_dbi_open(txn, sl_null, 0, &dbi);
+						if (!iResult) {
+							Ref<LMDBReadTransaction> ret = new LMDBReadTransaction(instance, env, txn, dbi);
+							if (ret.isNotNull()) {
+								return ret;
+							}
+							mdb_dbi_close(env, dbi);
+						}
+						mdb_txn_abort(txn);
+					}
+					return sl_null;
+				}
+
+				// Returns sl_false when a newer transaction was committed (also by the other processes) after this transaction began
+				sl_bool isLatest()
+				{
+					MDB_envinfo info;
+					if (mdb_env_info(m_env, &info)) {
+						return sl_false;
+					}
+					return info.me_last_txnid == mdb_txn_id(m_txn);
+				}
+
+			};
+
 			class LMDBImpl : public LMDB
 			{
 			public:
 				MDB_env* m_env;
 
+				// Shared by the pinned values which are read from the same version of the database
+				WeakRef<LMDBReadTransaction> m_txnPinned;
+				SpinLock m_lockTxnPinned;
+
 			public:
 				LMDBImpl()
 				{
@@ -70,7 +165,11 @@ namespace slib
 					MDB_env* env = sl_null;
 					int iResult = mdb_env_create(&env);
 					if (!iResult) {
-						iResult = mdb_env_open(env, path.getData(), 0, (int)(param.mode));
+						if (param.maxReaders) {
+							mdb_env_set_maxreaders(env, (unsigned int)(param.maxReaders));
+						}
+						// Read transactions are not bound to threads, because pinned values can keep them alive
+						iResult = mdb_env_open(env, path.getData(), MDB_NOTLS, (int)(param.mode));
 						if (!iResult) {
 							Ref<LMDBImpl> ret = new LMDBImpl;
 							if (ret.isNotNull()) {
@@ -104,9 +203,8 @@ namespace slib
 							k.mv_size = (size_t)sizeKey;
 							iResult = mdb_get(txn, dbi, &k, &v);
 							if (!iResult) {
-								value->data = v.mv_data;
-								value->size = (sl_size)(v.mv_size);
-								bRet = sl_true;
+								// The mapped page is not valid after the transaction ends
+								bRet = CopyValue(v, value);
 							}
 							mdb_dbi_close(m_env, dbi);
 						}
@@ -115,6 +213,27 @@ namespace slib
 					return bRet;
 				}
 
+				sl_size multiGet(const MemoryView* keys, sl_size nKeys, MemoryData* outValues, sl_bool* outFlagsFound) override;
+
+				sl_bool getPinned(const void* key, sl_size sizeKey, MemoryData* pOutValue) override;
+
+				Ref<LMDBReadTransaction> getPinnedTransaction()
+				{
+					{
+						SpinLocker lock(&m_lockTxnPinned);
+						Ref<LMDBReadTransaction> txn = m_txnPinned;
+						if (txn.isNotNull() && txn->isLatest()) {
+							return txn;
+						}
+					}
+					Ref<LMDBReadTransaction> txn = LMDBReadTransaction::begin(this, m_env);
+					if (txn.isNotNull()) {
+						SpinLocker lock(&m_lockTxnPinned);
+						m_txnPinned = txn;
+					}
+					return txn;
+				}
+
 				sl_bool put(const void* key, sl_size sizeKey, const void* value, sl_size sizeValue) override
 				{
 					sl_bool bRet = sl_false;
@@ -165,6 +284,37 @@ namespace slib
 
 			};
 
+			sl_size LMDBImpl::multiGet(const MemoryView* keys, sl_size nKeys, MemoryData* outValues, sl_bool* outFlagsFound)
+			{
+				Ref<LMDBReadTransaction> txn = LMDBReadTransaction::begin(this, m_env);
+				if (txn.isNull()) {
+					return 0;
+				}
+				return MultiGet(Ref<Referable>::from(txn), txn->m_txn, txn->m_dbi, keys, nKeys, outValues, outFlagsFound);
+			}
+
+			sl_bool LMDBImpl::getPinned(const void* key, sl_size sizeKey, MemoryData* pOutValue)
+			{
+				// One read transaction is shared until the next commit, so that the pinned values do not take a reader slot each
+				Ref<LMDBReadTransaction> txn = getPinnedTransaction();
+				if (txn.isNull()) {
+					return sl_false;
+				}
+				MDB_val k, v;
+				k.mv_data = (void*)key;
+				k.mv_size = (size_t)sizeKey;
+				int iResult;
+				{
+					SpinLocker lock(&(txn->m_lock));
+					iResult = mdb_get(txn->m_txn, txn->m_dbi, &k, &v);
+				}
+				if (!iResult) {
+					*pOutValue = MemoryData(v.mv_data, (sl_size)(v.mv_size), Move(txn));
+					return sl_true;
+				}
+				return sl_false;
+			}
+
 			class LMDBWriteBatch : public KeyValueWriteBatch
 			{
 			public:
@@ -371,6 +521,23 @@ namespace slib
 					return sl_false;
 				}
 
+				sl_size multiGet(const MemoryView* keys, sl_size nKeys, MemoryData* outValues, sl_bool* outFlagsFound) override
+				{
+					return MultiGet(this, m_txn, m_dbi, keys, nKeys, outValues, outFlagsFound);
+				}
+
+				sl_bool getPinned(const void* key, sl_size sizeKey, MemoryData* pOutValue) override
+				{
+					MDB_val k, v;
+					k.mv_data = (void*)key;
+					k.mv_size = (size_t)sizeKey;
+					if (!(mdb_get(m_txn, m_dbi, &k, &v))) {
+						*pOutValue = MemoryData(v.mv_data, (sl_size)(v.mv_size), this);
+						return sl_true;
+					}
+					return sl_false;
+				}
+
 				Ref<KeyValueIterator> getIterator() override
 				{
 					MDB_cursor* cursor = sl_null;
@@ -390,7 +557,7 @@ namespace slib
 			Ref<KeyValueSnapshot> LMDBImpl::getSnapshot()
 			{
 				MDB_txn* txn = sl_null;
-				int iResult = mdb_txn_begin(m_env, sl_null, 0, &txn);
+				int iResult = mdb_txn_begin(m_env, sl_null, MDB_RDONLY, &txn);
 				if (!iResult) {
 					MDB_dbi dbi = 0;
 					iResult = mdb_dbi_open(txn, sl_null, 0, &dbi);
@@ -418,6 +585,7 @@ namespace slib
 	{
 		flagCreateIfMissing = sl_true;
 		mode = 0664;
+		maxReaders = 0;
 	}
 
 
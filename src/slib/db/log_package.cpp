@@ -1,6 +1,11 @@
 #include "slib/db/log_package.h"
 
 #include "slib/core/mio.h"
+#include "slib/core/system.h"
+#include "slib/core/scoped_buffer.h"
+#include "slib/crypto/zstd.h"
+
+#define SIZE_INDEX 32
 
 namespace slib
 {
@@ -15,7 +20,8 @@ namespace slib
 				sl_uint8 position[8];
 				sl_uint8 size[8];
 				sl_uint8 id[8];
-				sl_uint8 reserved[8];
+				sl_uint8 offsetInBlock[4];
+				sl_uint8 sizeBlock[4]; // 0: Not compressed
 			};
 
 		}
@@ -23,12 +29,41 @@ namespace slib
 
 	using namespace priv::log_package;
 
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(LogPackageAppenderParam)
+
+	LogPackageAppenderParam::LogPackageAppenderParam()
+	{
+		blockSize = 0;
+		flagCompress = sl_false;
+		compressionLevel = 3;
+		syncInterval = 0;
+		syncSize = 0;
+	}
+
+
 	LogPackageAppender::LogPackageAppender()
 	{
+		m_sizeBlock = 0;
+		m_flagCompress = sl_false;
+		m_compressionLevel = 3;
+		m_syncInterval = 0;
+		m_syncSize = 0;
+
+		m_sizeContent = 0;
+		m_countPending = 0;
+		m_maxPending = 0;
+		m_countCopying[0] = 0;
+		m_countCopying[1] = 0;
+		m_indexBuffer = 0;
+
+		m_positionContent = 0;
+		m_sizeNotSynced = 0;
+		m_tickLastSync = 0;
 	}
 
 	LogPackageAppender::~LogPackageAppender()
 	{
+		close();
 	}
 
 	sl_bool LogPackageAppender::open(const StringParam& pathContent)
@@ -38,45 +73,284 @@ namespace slib
 
 	sl_bool LogPackageAppender::open(const StringParam& pathContent, const StringParam& pathIndex)
 	{
-		m_fileContent = File::open(pathContent, FileMode::Append | FileMode::ShareAll);
+		LogPackageAppenderParam param;
+		param.pathContent = pathContent;
+		param.pathIndex = pathIndex;
+		return open(param);
+	}
+
+	sl_bool LogPackageAppender::open(const LogPackageAppenderParam& param)
+	{
+		close();
+		MutexLocker lock(&m_lockWrite);
+		m_fileContent = File::open(param.pathContent, FileMode::Append | FileMode::ShareAll);
 		if (m_fileContent.isNone()) {
 			return sl_false;
 		}
-		m_fileIndex = File::open(pathIndex, FileMode::Append | FileMode::ShareAll);
+		if (param.pathIndex.isNotNull()) {
+			m_fileIndex = File::open(param.pathIndex, FileMode::Append | FileMode::ShareAll);
+		} else {
+			m_fileIndex = File::open(String::concat(param.pathContent, ".idx"), FileMode::Append | FileMode::ShareAll);
+		}
 		if (m_fileIndex.isNone()) {
+			m_fileContent.close();
 			return sl_false;
 		}
 		sl_uint64 pos = m_fileIndex.getPosition();
-		if (pos & 31) { // sizeof(INDEX) == 32
+		if (pos & (SIZE_INDEX - 1)) {
 			sl_uint64 nIndices = pos >> 5;
 			if (!(m_fileIndex.seek(nIndices << 5, SeekPosition::Begin))) {
 				return sl_false;
 			}
 		}
+		if (!(m_fileContent.getSize(m_positionContent))) {
+			return sl_false;
+		}
+		m_sizeBlock = param.blockSize;
+		m_flagCompress = param.flagCompress;
+		m_compressionLevel = param.compressionLevel;
+		m_syncInterval = param.syncInterval;
+		m_syncSize = param.syncSize;
+		if (m_sizeBlock) {
+			m_bufContent = Memory::create(m_sizeBlock);
+			if (m_bufContent.isNull()) {
+				return sl_false;
+			}
+			m_maxPending = (m_sizeBlock >> 4) + 1;
+			m_bufPending = Memory::create(m_maxPending * sizeof(PendingRecord));
+			if (m_bufPending.isNull()) {
+				return sl_false;
+			}
+		}
+		m_sizeNotSynced = 0;
+		m_tickLastSync = System::getTickCount64();
 		return sl_true;
 	}
 
+	void LogPackageAppender::close()
+	{
+		MutexLocker lock(&m_lockWrite);
+		if (m_fileContent.isNone()) {
+			return;
+		}
+		_flush();
+		if (m_syncInterval || m_syncSize) {
+			_sync(sl_true);
+		}
+		m_fileContent.close();
+		m_fileIndex.close();
+		m_bufContent.setNull();
+		m_bufSpare.setNull();
+		m_sizeContent = 0;
+		m_bufPending.setNull();
+		m_bufPendingSpare.setNull();
+		m_countPending = 0;
+	}
+
 	sl_bool LogPackageAppender::appendRecord(sl_uint64 id, const MemoryView& content)
 	{
-		sl_uint64 pos;
-		if (!(m_fileContent.getPosition(pos))) {
+		sl_size size = content.size;
+		if (!m_sizeBlock || size >= m_sizeBlock) {
+			MutexLocker lock(&m_lockWrite);
+			if (m_fileContent.isNone()) {
+				return sl_false;
+			}
+			if (!(_flush())) {
+				return sl_false;
+			}
+			PendingRecord record = { id, 0, size };
+			if (!(_writeBlock(content.data, size, &record, 1))) {
+				return sl_false;
+			}
+			return _sync(sl_false);
+		}
+		// Reserves the space and the pending record in the current block under the spin lock, and copies the content out of it. Blocks are written by the thread holding `m_lockWrite`.
+		sl_bool flagFull;
+		sl_uint8* dst;
+		volatile sl_reg* pCountCopying;
+		for (;;) {
+			{
+				SpinLocker lock(&m_lockBuffer);
+				sl_size offset = m_sizeContent;
+				if (offset + size <= m_sizeBlock && m_countPending < m_maxPending) {
+					PendingRecord& record = ((PendingRecord*)(m_bufPending.getData()))[m_countPending];
+					record.id = id;
+					record.offset = offset;
+					record.size = size;
+					m_countPending++;
+					m_sizeContent = offset + size;
+					flagFull = m_sizeContent == m_sizeBlock || m_countPending == m_maxPending;
+					dst = (sl_uint8*)(m_bufContent.getData()) + offset;
+					pCountCopying = m_countCopying + m_indexBuffer;
+					Base::interlockedIncrement(pCountCopying);
+					break;
+				}
+			}
+			MutexLocker lock(&m_lockWrite);
+			if (m_fileContent.isNone()) {
+				return sl_false;
+			}
+			if (!(_flush())) {
+				return sl_false;
+			}
+		}
+		Base::copyMemory(dst, content.data, size);
+		Base::interlockedDecrement(pCountCopying);
+		if (!flagFull && !m_syncInterval) {
+			return sl_true;
+		}
+		// Group commit: when another thread is writing, it will take the buffered records
+		if (m_lockWrite.tryLock()) {
+			sl_bool bRet = sl_true;
+			if (flagFull || System::getTickCount64() - m_tickLastSync >= m_syncInterval) {
+				bRet = _flush() && _sync(sl_false);
+			}
+			m_lockWrite.unlock();
+			return bRet;
+		}
+		return sl_true;
+	}
+
+	sl_bool LogPackageAppender::flush()
+	{
+		MutexLocker lock(&m_lockWrite);
+		if (m_fileContent.isNone()) {
+			return sl_false;
+		}
+		return _flush() && _sync(sl_false);
+	}
+
+	sl_bool LogPackageAppender::sync()
+	{
+		MutexLocker lock(&m_lockWrite);
+		if (m_fileContent.isNone()) {
 			return sl_false;
 		}
-		if (m_fileContent.writeFully(content) != content.size) {
+		return _flush() && _sync(sl_true);
+	}
+
+	sl_bool LogPackageAppender::_flush()
+	{
+		if (!m_sizeBlock) {
+			return sl_true;
+		}
+		if (m_bufSpare.isNull()) {
+			m_bufSpare = Memory::create(m_sizeBlock);
+			if (m_bufSpare.isNull()) {
+				return sl_false;
+			}
+		}
+		if (m_bufPendingSpare.isNull()) {
+			m_bufPendingSpare = Memory::create(m_maxPending * sizeof(PendingRecord));
+			if (m_bufPendingSpare.isNull()) {
+				return sl_false;
+			}
+		}
+		Memory content;
+		sl_size sizeContent;
+		Memory pending;
+		sl_size countPending;
+		sl_uint32 indexBuffer;
+		{
+			SpinLocker lock(&m_lockBuffer);
+			countPending = m_countPending;
+			if (!countPending) {
+				return sl_true;
+			}
+			sizeContent = m_sizeContent;
+			content = Move(m_bufContent);
+			m_bufContent = Move(m_bufSpare);
+			m_sizeContent = 0;
+			pending = Move(m_bufPending);
+			m_bufPending = Move(m_bufPendingSpare);
+			m_countPending = 0;
+			indexBuffer = m_indexBuffer;
+			m_indexBuffer = indexBuffer ^ 1;
+		}
+		// Waits for the copies into the detached buffer
+		while (m_countCopying[indexBuffer]) {
+			System::yield();
+		}
+		m_bufSpare = content;
+		m_bufPendingSpare = pending;
+		return _writeBlock(content.getData(), sizeContent, (PendingRecord*)(pending.getData()), countPending);
+	}
+
+	sl_bool LogPackageAppender::_writeBlock(const void* data, sl_size size, const PendingRecord* records, sl_size nRecords)
+	{
+		if (!nRecords) {
+			return sl_true;
+		}
+		Memory memCompressed;
+		if (m_flagCompress) {
+			memCompressed = Zstd::compress(data, size, m_compressionLevel);
+			sl_size sizeCompressed = memCompressed.getSize();
+			if (sizeCompressed >= size || sizeCompressed > 0xFFFFFFFF) {
+				memCompressed.setNull();
+			}
+		}
+		SLIB_SCOPED_BUFFER(INDEX, 64, indices, nRecords)
+		if (!indices) {
+			return sl_false;
+		}
+		Base::zeroMemory(indices, nRecords * sizeof(INDEX));
+		sl_uint64 pos = m_positionContent;
+		sl_uint32 sizeBlock = (sl_uint32)(memCompressed.getSize());
+		for (sl_size i = 0; i < nRecords; i++) {
+			INDEX& index = indices[i];
+			const PendingRecord& record = records[i];
+			if (sizeBlock) {
+				MIO::writeUint64LE(index.position, pos);
+				MIO::writeUint32LE(index.offsetInBlock, (sl_uint32)(record.offset));
+				MIO::writeUint32LE(index.sizeBlock, sizeBlock);
+			} else {
+				MIO::writeUint64LE(index.position, pos + record.offset);
+			}
+			MIO::writeUint64LE(index.size, record.size);
+			MIO::writeUint64LE(index.id, record.id);
+		}
+		if (sizeBlock) {
+			data = memCompressed.getData();
+			size = sizeBlock;
+		}
+		if (m_fileContent.writeFully(data, size) != size) {
 			return sl_false;
 		}
-		INDEX index = { 0 };
-		MIO::writeUint64LE(index.position, pos);
-		MIO::writeUint64LE(index.size, content.size);
-		MIO::writeUint64LE(index.id, id);
-		if (m_fileIndex.writeFully(&index, sizeof(index)) != sizeof(index)) {
+		m_positionContent = pos + size;
+		sl_size sizeIndices = nRecords * sizeof(INDEX);
+		if (m_fileIndex.writeFully(indices, sizeIndices) != sizeIndices) {
 			return sl_false;
 		}
+		m_sizeNotSynced += size + sizeIndices;
 		return sl_true;
 	}
 
+	sl_bool LogPackageAppender::_sync(sl_bool flagForce)
+	{
+		if (!flagForce) {
+			if (!m_syncInterval && !m_syncSize) {
+				return sl_true;
+			}
+			if (!m_sizeNotSynced) {
+				return sl_true;
+			}
+			if (!(m_syncSize && m_sizeNotSynced >= m_syncSize)) {
+				if (!m_syncInterval || System::getTickCount64() - m_tickLastSync < m_syncInterval) {
+					return sl_true;
+				}
+			}
+		}
+		sl_bool bRet = m_fileContent.flush();
+		if (!(m_fileIndex.flush())) {
+			bRet = sl_false;
+		}
+		m_sizeNotSynced = 0;
+		m_tickLastSync = System::getTickCount64();
+		return bRet;
+	}
+
 
-	LogPackageReader::LogPackageReader(): m_indices(sl_null), m_nIndices(0)
+	LogPackageReader::LogPackageReader(): m_indices(sl_null), m_nIndices(0), m_positionCachedBlock(0)
 	{
 	}
 
@@ -102,7 +376,7 @@ namespace slib
 		if (m_fileContent.isNone()) {
 			return sl_false;
 		}
-		m_nIndices = memIndex.getSize() >> 5; // sizeof(INDEX) == 32
+		m_nIndices = memIndex.getSize() / SIZE_INDEX;
 		if (!m_nIndices) {
 			return sl_false;
 		}
@@ -116,6 +390,8 @@ namespace slib
 			index.position = MIO::readUint64LE(dataIndex->position);
 			index.size = MIO::readUint64LE(dataIndex->size);
 			index.id = MIO::readUint64LE(dataIndex->id);
+			index.offsetInBlock = MIO::readUint32LE(dataIndex->offsetInBlock);
+			index.sizeBlock = MIO::readUint32LE(dataIndex->sizeBlock);
 			dataIndex++;
 		}
 		return sl_true;
@@ -130,7 +406,7 @@ namespace slib
 	{
 		Index& index = m_indices[n];
 		if (index.size <= maxSize) {
-			return { index.id, _readRecord(index.position, index.size) };
+			return { index.id, _readRecord(index) };
 		}
 		return { 0, sl_null };
 	}
@@ -141,7 +417,7 @@ namespace slib
 			Index& index = m_indices[i];
 			if (index.id == id) {
 				if (index.size <= maxSize) {
-					return _readRecord(index.position, index.size);
+					return _readRecord(index);
 				} else {
 					return sl_null;
 				}
@@ -159,7 +435,7 @@ namespace slib
 		for (sl_size i = 0; i < m_nIndices; i++) {
 			Index& index = m_indices[i];
 			if (index.id >= start && index.id < end && index.size <= maxSize) {
-				Memory mem = _readRecord(index.position, index.size);
+				Memory mem = _readRecord(index);
 				if (mem.isNotNull()) {
 					if (!(ret.add_NoLock(Pair<sl_uint64, Memory>(index.id, Move(mem))))) {
 						return sl_null;
@@ -170,17 +446,53 @@ namespace slib
 		return ret;
 	}
 
-	Memory LogPackageReader::_readRecord(sl_uint64 position, sl_size size)
+	Memory LogPackageReader::_readRecord(const Index& index)
 	{
+		sl_size size = (sl_size)(index.size);
+		if (index.sizeBlock) {
+			Memory block = _readBlock(index.position, index.sizeBlock);
+			if (block.isNull()) {
+				return sl_null;
+			}
+			if ((sl_uint64)(index.offsetInBlock) + index.size > block.getSize()) {
+				return sl_null;
+			}
+			return Memory::create((sl_uint8*)(block.getData()) + index.offsetInBlock, size);
+		}
 		Memory mem = Memory::create(size);
 		if (mem.isNull()) {
 			return sl_null;
 		}
-		if (m_fileContent.readFullyAt(position, mem.getData(), size) == size) {
+		if (m_fileContent.readFullyAt(index.position, mem.getData(), size) == size) {
 			return mem;
 		} else {
 			return sl_null;
 		}
 	}
 
+	Memory LogPackageReader::_readBlock(sl_uint64 position, sl_uint32 size)
+	{
+		{
+			SpinLocker lock(&m_lockCachedBlock);
+			if (m_cachedBlock.isNotNull() && m_positionCachedBlock == position) {
+				return m_cachedBlock;
+			}
+		}
+		Memory mem = Memory::create(size);
+		if (mem.isNull()) {
+			return sl_null;
+		}
+		if (m_fileContent.readFullyAt(position, mem.getData(), size) != size) {
+			return sl_null;
+		}
+		Memory block = Zstd::decompress(mem.getData(), size);
+		if (block.isNull()) {
+			return sl_null;
+		}
+		SpinLocker lock(&m_lockCachedBlock);
+		m_positionCachedBlock = position;
+		m_cachedBlock = block;
+		return block;
+	}
+
 }
@@ -31,7 +31,7 @@
 #define KEY_BUFFER_SIZE (KEY_LENGTH_MAX + 16)
 #define VALUE_BUFFER_SIZE 1024
 #define DICTIONARY_BUFFER_SIZE 128
-#define DICTIONARY_REMOVE_BATCH_SIZE 1024
+#define DICTIONARY_CACHE_SIZE_MAX 65536
 #define KEY_NAME_LAST_DICTIONARY_ID "last_dictionary_id"
 
 namespace slib
@@ -74,11 +74,46 @@ namespace slib
 
 			class DictionaryImpl;
 
+			// Removes the keys of a dictionary tree by one write batch, so the removal is atomic
+			class RemoveContext
+			{
+			public:
+				Ref<KeyValueIterator> iterator;
+				Ref<KeyValueWriteBatch> batch;
+
+			public:
+				sl_bool prepare(const Ref<KeyValueStore>& store)
+				{
+					batch = store->createWriteBatch();
+					if (batch.isNull()) {
+						return sl_false;
+					}
+					// The iterator reads from the implicit snapshot, so it can be reused for all prefixes while the keys are being removed
+					iterator = store->getIterator();
+					return iterator.isNotNull();
+				}
+
+				sl_bool remove(const void* key, sl_size size)
+				{
+					return batch->remove(key, size);
+				}
+
+				sl_bool commit()
+				{
+					iterator.setNull();
+					return batch->commit();
+				}
+
+			};
+
 			class ObjectStoreManagerImpl : public ObjectStoreManager
 			{
 			public:
 				Ref<KeyValueStore> m_store;
 
+				// Prepared dictionary key (parentId + key) => dictionary id
+				CHashMap<String, sl_uint64> m_cacheDictionaryIds;
+
 			public:
 				static Ref<ObjectStoreManagerImpl> open(const ObjectStoreParam& param)
 				{
@@ -106,6 +141,13 @@ namespace slib
 				}
 
 				Ref<ObjectStoreDictionary> getRootDictionary() override;
+
+				Ref<ObjectStoreWriteBatch> createWriteBatch() override;
+
+				void clearCache() override
+				{
+					m_cacheDictionaryIds.removeAll();
+				}
 				
 			public:
 				Ref<ObjectStoreDictionary> createDictionary(sl_uint64 parentId, const StringView& key);
@@ -119,12 +161,15 @@ namespace slib
 					if (!nKey) {
 						return sl_false;
 					}
+					ObjectLocker lock(this);
 					sl_uint64 childId = getDictionaryId(key, nKey);
 					if (childId) {
-						if (removeChildDictionaries(childId)) {
-							if (removeChildItems(childId)) {
-								if (m_store->remove(StringView((char*)key, nKey))) {
-									return sl_true;
+						RemoveContext context;
+						if (context.prepare(m_store)) {
+							m_cacheDictionaryIds.remove(String((sl_char8*)key, nKey));
+							if (context.remove(key, nKey)) {
+								if (removeChildren(context, childId)) {
+									return context.commit();
 								}
 							}
 						}
@@ -171,145 +216,90 @@ namespace slib
 
 				sl_uint64 getDictionaryId(sl_uint8* key, sl_uint32 nKey)
 				{
+					String strKey((sl_char8*)key, nKey);
+					sl_uint64 dictionaryId;
+					if (m_cacheDictionaryIds.get(strKey, &dictionaryId)) {
+						return dictionaryId;
+					}
 					char buf[DICTIONARY_BUFFER_SIZE];
 					sl_reg n = m_store->get(key, nKey, buf, sizeof(buf));
 					if (n > 0) {
-						return DeserializeDictionaryId(buf, n);
+						dictionaryId = DeserializeDictionaryId(buf, n);
+						if (dictionaryId) {
+							// Filling the cache is serialized with creating and removing dictionaries
+							ObjectLocker lock(this);
+							n = m_store->get(key, nKey, buf, sizeof(buf));
+							if (n > 0 && DeserializeDictionaryId(buf, n) == dictionaryId) {
+								putDictionaryIdToCache(Move(strKey), dictionaryId);
+							}
+						}
+						return dictionaryId;
 					}
 					return 0;
 				}
 
-				sl_bool removeChildDictionaries(sl_uint64 parentId)
+				void putDictionaryIdToCache(String&& key, sl_uint64 dictionaryId)
 				{
-					sl_uint8 key[KEY_BUFFER_SIZE];
-					sl_uint32 nKey = PrepareKey(key, parentId, sl_true);
-					for (;;) {
-						List<Memory> listKeys;
-						List<sl_uint64> listIds;
-						{
-							Ref<KeyValueIterator> iterator = m_store->getIterator();
-							if (iterator.isNull()) {
-								return sl_false;
-							}
-							if (!(iterator->seek(key, nKey))) {
-								break;
-							}
-							do {
-								sl_uint8 subKey[KEY_BUFFER_SIZE];
-								sl_reg n = iterator->getKey(subKey, sizeof(subKey));
-								if (n <= (sl_reg)nKey) {
-									break;
-								}
-								if (!(Base::equalsMemory(key, subKey, nKey))) {
-									break;
-								}
-								Memory memKey = Memory::create(subKey, n);
-								if (memKey.isNull()) {
-									return sl_false;
-								}
-								if (!(listKeys.add_NoLock(Move(memKey)))) {
-									return sl_false;
-								}
-								char value[DICTIONARY_BUFFER_SIZE];
-								sl_reg nValue = iterator->getValue(value, sizeof(value));
-								if (nValue >= 0) {
-									sl_uint64 childId = DeserializeDictionaryId(value, nValue);
-									if (childId) {
-										if (!(listIds.add_NoLock(childId))) {
-											return sl_false;
-										}
-									}
-								}
-								if (listKeys.getCount() >= DICTIONARY_REMOVE_BATCH_SIZE) {
-									break;
-								}
-							} while (iterator->moveNext());
-						}
-						{
-							ListElements<sl_uint64> ids(listIds);
-							for (sl_size i = 0; i < ids.count; i++) {
-								if (!(removeChildDictionaries(ids[i]))) {
-									return sl_false;
-								}
-								if (!(removeChildItems(ids[i]))) {
-									return sl_false;
-								}
-							}
-						}
-						{
-							ListElements<Memory> keys(listKeys);
-							if (!(keys.count)) {
-								break;
-							}
-							Ref<KeyValueWriteBatch> batch = m_store->createWriteBatch();
-							if (batch.isNull()) {
-								return sl_false;
-							}
-							for (sl_size i = 0; i < keys.count; i++) {
-								if (!(batch->remove(keys[i].getData(), keys[i].getSize()))) {
-									return sl_false;
-								}
-							}
-							if (!(batch->commit())) {
-								return sl_false;
-							}
-						}
+					if (m_cacheDictionaryIds.getCount() >= DICTIONARY_CACHE_SIZE_MAX) {
+						m_cacheDictionaryIds.removeAll();
 					}
-					return sl_true;
+					m_cacheDictionaryIds.put(Move(key), dictionaryId);
 				}
 
-				sl_bool removeChildItems(sl_uint64 parentId)
+				// Collects the items and the dictionaries under `parentId` into `context`, by reusing its iterator
+				sl_bool removeChildren(RemoveContext& context, sl_uint64 parentId)
 				{
+					KeyValueIterator* iterator = context.iterator.get();
 					sl_uint8 key[KEY_BUFFER_SIZE];
+					sl_uint8 subKey[KEY_BUFFER_SIZE];
+					// Items
 					sl_uint32 nKey = PrepareKey(key, parentId, sl_false);
-					for (;;) {
-						List<Memory> listItems;
-						{
-							Ref<KeyValueIterator> iterator = m_store->getIterator();
-							if (iterator.isNull()) {
-								return sl_false;
-							}
-							if (!(iterator->seek(key, nKey))) {
+					if (iterator->seek(key, nKey)) {
+						do {
+							sl_reg n = iterator->getKey(subKey, sizeof(subKey));
+							if (n <= (sl_reg)nKey) {
 								break;
 							}
-							do {
-								sl_uint8 subKey[KEY_BUFFER_SIZE];
-								sl_reg n = iterator->getKey(subKey, sizeof(subKey));
-								if (n <= (sl_reg)nKey) {
-									break;
-								}
-								if (!(Base::equalsMemory(key, subKey, nKey))) {
-									break;
-								}
-								Memory memKey = Memory::create(subKey, n);
-								if (memKey.isNull()) {
-									return sl_false;
-								}
-								if (!(listItems.add_NoLock(Move(memKey)))) {
-									return sl_false;
-								}
-								if (listItems.getCount() >= DICTIONARY_REMOVE_BATCH_SIZE) {
-									break;
-								}
-							} while (iterator->moveNext());
-						}
-						{
-							ListElements<Memory> items(listItems);
-							if (!(items.count)) {
+							if (!(Base::equalsMemory(key, subKey, nKey))) {
 								break;
 							}
-							Ref<KeyValueWriteBatch> batch = m_store->createWriteBatch();
-							if (batch.isNull()) {
+							if (!(context.remove(subKey, n))) {
 								return sl_false;
 							}
-							for (sl_size i = 0; i < items.count; i++) {
-								if (!(batch->remove(items[i].getData(), items[i].getSize()))) {
-									return sl_false;
+						} while (iterator->moveNext());
+					}
+					// Dictionaries
+					List<sl_uint64> listIds;
+					nKey = PrepareKey(key, parentId, sl_true);
+					if (iterator->seek(key, nKey)) {
+						do {
+							sl_reg n = iterator->getKey(subKey, sizeof(subKey));
+							if (n <= (sl_reg)nKey) {
+								break;
+							}
+							if (!(Base::equalsMemory(key, subKey, nKey))) {
+								break;
+							}
+							char value[DICTIONARY_BUFFER_SIZE];
+							sl_reg nValue = iterator->getValue(value, sizeof(value));
+							if (nValue >= 0) {
+								sl_uint64 childId = DeserializeDictionaryId(value, nValue);
+								if (childId) {
+									if (!(listIds.add_NoLock(childId))) {
+										return sl_false;
+									}
 								}
 							}
-							if (!(batch->commit())) {
+							m_cacheDictionaryIds.remove(String((sl_char8*)subKey, n));
+							if (!(context.remove(subKey, n))) {
 								return sl_false;
 							}
+						} while (iterator->moveNext());
+					}
+					ListElements<sl_uint64> ids(listIds);
+					for (sl_size i = 0; i < ids.count; i++) {
+						if (!(removeChildren(context, ids[i]))) {
+							return sl_false;
 						}
 					}
 					return sl_true;
@@ -374,11 +364,75 @@ namespace slib
 
 			};
 
+			class WriteBatchImpl : public ObjectStoreWriteBatch
+			{
+			public:
+				Ref<ObjectStoreManagerImpl> m_manager;
+				Ref<KeyValueWriteBatch> m_batch;
+
+			public:
+				WriteBatchImpl(ObjectStoreManagerImpl* manager, Ref<KeyValueWriteBatch>&& batch): m_manager(manager), m_batch(Move(batch)) {}
+
+			public:
+				sl_bool putItem(const ObjectStore& dictionary, const StringView& _key, const Variant& value) override
+				{
+					sl_uint8 key[KEY_BUFFER_SIZE];
+					sl_uint32 nKey = prepareKey(key, dictionary, _key);
+					if (nKey) {
+						return m_batch->put(StringView((char*)key, nKey), value);
+					}
+					return sl_false;
+				}
+
+				sl_bool removeItem(const ObjectStore& dictionary, const StringView& _key) override
+				{
+					sl_uint8 key[KEY_BUFFER_SIZE];
+					sl_uint32 nKey = prepareKey(key, dictionary, _key);
+					if (nKey) {
+						return m_batch->remove(key, nKey);
+					}
+					return sl_false;
+				}
+
+				sl_bool commit() override
+				{
+					return m_batch->commit();
+				}
+
+				void discard() override
+				{
+					m_batch->discard();
+				}
+
+			private:
+				sl_uint32 prepareKey(sl_uint8* _out, const ObjectStore& store, const StringView& key)
+				{
+					Ref<ObjectStoreDictionary> dictionary = store.getDictionary();
+					if (dictionary.isNotNull()) {
+						// All dictionaries of the manager are `DictionaryImpl`
+						if (dictionary->getManager() == m_manager) {
+							return PrepareKey(_out, ((DictionaryImpl*)(dictionary.get()))->m_id, sl_false, key);
+						}
+					}
+					return 0;
+				}
+
+			};
+
 			Ref<ObjectStoreDictionary> ObjectStoreManagerImpl::getRootDictionary()
 			{
 				return new DictionaryImpl(this, 0);
 			}
 
+			Ref<ObjectStoreWriteBatch> ObjectStoreManagerImpl::createWriteBatch()
+			{
+				Ref<KeyValueWriteBatch> batch = m_store->createWriteBatch();
+				if (batch.isNotNull()) {
+					return new WriteBatchImpl(this, Move(batch));
+				}
+				return sl_null;
+			}
+
 			Ref<ObjectStoreDictionary> ObjectStoreManagerImpl::createDictionary(sl_uint64 parentId, const StringView& _key)
 			{
 				sl_uint8 key[KEY_BUFFER_SIZE];
@@ -398,6 +452,7 @@ namespace slib
 							sl_uint32 size = CVLI::serialize(buf, newId);
 							if (batch->put(key, nKey, buf, size)) {
 								if (batch->commit()) {
+									putDictionaryIdToCache(String((sl_char8*)key, nKey), newId);
 									return new DictionaryImpl(this, newId);
 								}
 							}
@@ -586,6 +641,17 @@ namespace slib
 	}
 
 
+	SLIB_DEFINE_OBJECT(ObjectStoreWriteBatch, Referable)
+
+	ObjectStoreWriteBatch::ObjectStoreWriteBatch()
+	{
+	}
+
+	ObjectStoreWriteBatch::~ObjectStoreWriteBatch()
+	{
+	}
+
+
 	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(ObjectStoreParam)
 
 	ObjectStoreParam::ObjectStoreParam()
@@ -725,6 +791,15 @@ namespace slib
 		return sl_null;
 	}
 
+	Ref<ObjectStoreWriteBatch> ObjectStore::createWriteBatch() const
+	{
+		Ref<ObjectStoreManager> manager = getManager();
+		if (manager.isNotNull()) {
+			return manager->createWriteBatch();
+		}
+		return sl_null;
+	}
+
 	sl_bool ObjectStore::isUndefined() const noexcept
 	{
 		return value.isUndefined();
@@ -34,6 +34,8 @@
 #include "rocksdb/write_batch.h"
 #include "rocksdb/env.h"
 
+#include <vector>
+
 namespace slib
 {
 
@@ -75,6 +77,80 @@ namespace slib
 				return sl_false;
 			}
 
+			class PinnableSliceContainer : public Referable
+			{
+			public:
+				rocksdb::PinnableSlice slice;
+
+			};
+
+			class PinnableSliceArrayContainer : public Referable
+			{
+			public:
+				std::vector<rocksdb::PinnableSlice> slices;
+
+			public:
+				PinnableSliceArrayContainer(sl_size n): slices(n) {}
+
+			};
+
+			static sl_bool GetPinned(rocksdb::DB* db, const rocksdb::ReadOptions& options, const void* key, sl_size sizeKey, MemoryData* pOutValue)
+			{
+				Ref<PinnableSliceContainer> container = new PinnableSliceContainer;
+				if (container.isNull()) {
+					return sl_false;
+				}
+				rocksdb::Status status = db->Get(options, db->DefaultColumnFamily(), rocksdb::Slice((char*)key, sizeKey), &(container->slice));
+				if (status.ok()) {
+					rocksdb::PinnableSlice& slice = container->slice;
+					*pOutValue = MemoryData(slice.data(), (sl_size)(slice.size()), Move(container));
+					return sl_true;
+				}
+				return sl_false;
+			}
+
+			static sl_size MultiGet(rocksdb::DB* db, const rocksdb::ReadOptions& options, const MemoryView* keys, sl_size nKeys, MemoryData* outValues, sl_bool* outFlagsFound)
+			{
+				if (!nKeys) {
+					return 0;
+				}
+				// The values share one container, so that the pinned blocks are released together
+				Ref<PinnableSliceArrayContainer> container = new PinnableSliceArrayContainer(nKeys);
+				if (container.isNull()) {
+					return 0;
+				}
+				std::vector<rocksdb::Slice> slices(nKeys);
+				std::vector<rocksdb::Status> statuses(nKeys);
+				sl_size i;
+				for (i = 0; i < nKeys; i++) {
+					slices[i] = rocksdb::Slice((char*)(keys[i].data), keys[i].size);
+				}
+				db->MultiGet(options, db->DefaultColumnFamily(), nKeys, slices.data(), container->slices.data(), statuses.data());
+				sl_size nFound = 0;
+				for (i = 0; i < nKeys; i++) {
+					sl_bool flagFound = statuses[i].ok();
+					if (flagFound) {
+						rocksdb::PinnableSlice& slice = container->slices[i];
+						outValues[i] = MemoryData(slice.data(), (sl_size)(slice.size()), container);
+						nFound++;
+					} else {
+						outValues[i] = MemoryData();
+					}
+					if (outFlagsFound) {
+						outFlagsFound[i] = flagFound;
+					}
+				}
+				return nFound;
+			}
+
+			static void ApplyIteratorParam(rocksdb::ReadOptions& options, const KeyValueIteratorParam& param)
+			{
+				options.fill_cache = (bool)(param.flagFillCache);
+				if (param.readaheadSize) {
+					options.readahead_size = (size_t)(param.readaheadSize);
+				}
+			}
+
 			class RocksDBImpl : public RocksDB
 			{
 			public:
@@ -125,6 +201,8 @@ namespace slib
 
 				Ref<KeyValueIterator> getIterator() override;
 
+				Ref<KeyValueIterator> getIterator(const KeyValueIteratorParam& param) override;
+
 				Ref<KeyValueSnapshot> getSnapshot() override;
 
 				sl_bool get(const void* key, sl_size sizeKey, MemoryData* value) override
@@ -137,6 +215,16 @@ namespace slib
 					return sl_false;
 				}
 
+				sl_size multiGet(const MemoryView* keys, sl_size nKeys, MemoryData* outValues, sl_bool* outFlagsFound) override
+				{
+					return MultiGet(m_db, m_optionsRead, keys, nKeys, outValues, outFlagsFound);
+				}
+
+				sl_bool getPinned(const void* key, sl_size sizeKey, MemoryData* pOutValue) override
+				{
+					return GetPinned(m_db, m_optionsRead, key, sizeKey, pOutValue);
+				}
+
 				sl_bool put(const void* key, sl_size sizeKey, const void* value, sl_size sizeValue) override
 				{
 					rocksdb::Status status = m_db->Put(m_optionsWrite, rocksdb::Slice((char*)key, sizeKey), rocksdb::Slice((char*)value, sizeValue));
@@ -310,11 +398,11 @@ namespace slib
 
 			};
 
-			Ref<KeyValueIterator> RocksDBImpl::getIterator()
+			static Ref<KeyValueIterator> CreateIterator(RocksDBImpl* instance, const rocksdb::ReadOptions& options)
 			{
-				rocksdb::Iterator* iterator = m_db->NewIterator(m_optionsRead);
+				rocksdb::Iterator* iterator = instance->m_db->NewIterator(options);
 				if (iterator) {
-					Ref<KeyValueIterator> ret = new RocksDBIterator(this, iterator);
+					Ref<KeyValueIterator> ret = new RocksDBIterator(instance, iterator);
 					if (ret.isNotNull()) {
 						return ret;
 					}
@@ -323,6 +411,18 @@ namespace slib
 				return sl_null;
 			}
 
+			Ref<KeyValueIterator> RocksDBImpl::getIterator()
+			{
+				return CreateIterator(this, m_optionsRead);
+			}
+
+			Ref<KeyValueIterator> RocksDBImpl::getIterator(const KeyValueIteratorParam& param)
+			{
+				rocksdb::ReadOptions options(m_optionsRead);
+				ApplyIteratorParam(options, param);
+				return CreateIterator(this, options);
+			}
+
 			class RocksDBSnapshot : public KeyValueSnapshot
 			{
 			public:
@@ -354,17 +454,26 @@ namespace slib
 					return sl_false;
 				}
 
+				sl_size multiGet(const MemoryView* keys, sl_size nKeys, MemoryData* outValues, sl_bool* outFlagsFound) override
+				{
+					return MultiGet(m_db, m_optionsRead, keys, nKeys, outValues, outFlagsFound);
+				}
+
+				sl_bool getPinned(const void* key, sl_size sizeKey, MemoryData* pOutValue) override
+				{
+					return GetPinned(m_db, m_optionsRead, key, sizeKey, pOutValue);
+				}
+
 				Ref<KeyValueIterator> getIterator() override
 				{
-					rocksdb::Iterator* iterator = m_db->NewIterator(m_optionsRead);
-					if (iterator) {
-						Ref<KeyValueIterator> ret = new RocksDBIterator(m_instance.get(), iterator);
-						if (ret.isNotNull()) {
-							return ret;
-						}
-						delete iterator;
-					}
-					return sl_null;
+					return CreateIterator(m_instance.get(), m_optionsRead);
+				}
+
+				Ref<KeyValueIterator> getIterator(const KeyValueIteratorParam& param) override
+				{
+					rocksdb::ReadOptions options(m_optionsRead);
+					ApplyIteratorParam(options, param);
+					return CreateIterator(m_instance.get(), options);
 				}
 
 			};
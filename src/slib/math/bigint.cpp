@@ -1792,6 +1792,314 @@ namespace slib
 		return sub(*this, v);
 	}
 
+	namespace priv
+	{
+		namespace bigint
+		{
+
+#if defined(SLIB_COMPILER_IS_GCC) && defined(__SIZEOF_INT128__)
+#	define PRIV_SLIB_BIGINT_UINT128
+#endif
+
+// in 64-bit limbs
+#define KARATSUBA_THRESHOLD 32
+#define KARATSUBA_SQUARE_THRESHOLD 48
+
+			// (hi, lo) = a * b + c + d
+			SLIB_INLINE static void MulAdd(sl_uint64& hi, sl_uint64& lo, sl_uint64 a, sl_uint64 b, sl_uint64 c, sl_uint64 d) noexcept
+			{
+#ifdef PRIV_SLIB_BIGINT_UINT128
+				unsigned __int128 m = (unsigned __int128)a * b + c + d;
+				hi = (sl_uint64)(m >> 64);
+				lo = (sl_uint64)m;
+#else
+				sl_uint64 h, l;
+				Math::mul64(a, b, h, l);
+				l += c;
+				h += l < c;
+				l += d;
+				h += l < d;
+				hi = h;
+				lo = l;
+#endif
+			}
+
+			SLIB_INLINE static sl_uint64 AddCarry(sl_uint64 a, sl_uint64 b, sl_uint64& carry) noexcept
+			{
+				sl_uint64 s = a + carry;
+				sl_uint64 c = s < carry;
+				sl_uint64 r = s + b;
+				carry = c + (r < b);
+				return r;
+			}
+
+			SLIB_INLINE static sl_uint64 SubBorrow(sl_uint64 a, sl_uint64 b, sl_uint64& borrow) noexcept
+			{
+				sl_uint64 d = a - b;
+				sl_uint64 c = a < b;
+				sl_uint64 r = d - borrow;
+				borrow = c + (d < borrow);
+				return r;
+			}
+
+			// r = a + b + carry, returns carry
+			static sl_uint64 AddLimbs(sl_uint64* r, const sl_uint64* a, const sl_uint64* b, sl_size n, sl_uint64 carry) noexcept
+			{
+				for (sl_size i = 0; i < n; i++) {
+					r[i] = AddCarry(a[i], b[i], carry);
+				}
+				return carry;
+			}
+
+			// r = a - b - borrow, returns borrow
+			static sl_uint64 SubLimbs(sl_uint64* r, const sl_uint64* a, const sl_uint64* b, sl_size n, sl_uint64 borrow) noexcept
+			{
+				for (sl_size i = 0; i < n; i++) {
+					r[i] = SubBorrow(a[i], b[i], borrow);
+				}
+				return borrow;
+			}
+
+			// r += carry, returns carry
+			static sl_uint64 PropagateCarry(sl_uint64* r, sl_size n, sl_uint64 carry) noexcept
+			{
+				for (sl_size i = 0; i < n && carry; i++) {
+					sl_uint64 s = r[i] + carry;
+					carry = s < carry;
+					r[i] = s;
+				}
+				return carry;
+			}
+
+			// r = a * b, returns carry
+			static sl_uint64 MulLimbs(sl_uint64* r, const sl_uint64* a, sl_size n, sl_uint64 b) noexcept
+			{
+				sl_uint64 c = 0;
+				for (sl_size i = 0; i < n; i++) {
+					MulAdd(c, r[i], a[i], b, c, 0);
+				}
+				return c;
+			}
+
+			// r += a * b, returns carry
+			static sl_uint64 MulAddLimbs(sl_uint64* r, const sl_uint64* a, sl_size n, sl_uint64 b) noexcept
+			{
+				sl_uint64 c = 0;
+				for (sl_size i = 0; i < n; i++) {
+					MulAdd(c, r[i], a[i], b, r[i], c);
+				}
+				return c;
+			}
+
+			// r[0..na+nb) = a * b
+			static void MulSchoolbook(sl_uint64* r, const sl_uint64* a, sl_size na, const sl_uint64* b, sl_size nb) noexcept
+			{
+				r[na] = MulLimbs(r, a, na, b[0]);
+				for (sl_size i = 1; i < nb; i++) {
+					r[na + i] = MulAddLimbs(r + i, a, na, b[i]);
+				}
+			}
+
+			// r[0..2n) = a * a: the cross products are computed once and doubled
+			static void SqrSchoolbook(sl_uint64* r, const sl_uint64* a, sl_size n) noexcept
+			{
+				sl_size i;
+				r[0] = 0;
+				r[(n << 1) - 1] = 0;
+				if (n > 1) {
+					r[n] = MulLimbs(r + 1, a + 1, n - 1, a[0]);
+					for (i = 1; i + 1 < n; i++) {
+						r[n + i] = MulAddLimbs(r + (i << 1) + 1, a + i + 1, n - i - 1, a[i]);
+					}
+				}
+				sl_uint64 c = 0;
+				for (i = 0; i < (n << 1); i++) {
+					sl_uint64 t = r[i];
+					r[i] = (t << 1) | c;
+					c = t >> 63;
+				}
+				c = 0;
+				for (i = 0; i < n; i++) {
+					sl_uint64 hi, lo;
+					MulAdd(hi, lo, a[i], a[i], 0, 0);
+					r[i << 1] = AddCarry(r[i << 1], lo, c);
+					r[(i << 1) + 1] = AddCarry(r[(i << 1) + 1], hi, c);
+				}
+			}
+
+			// r[0..n) = |a - b| (na, nb <= n), returns sl_true when a < b
+			static sl_bool AbsDiff(sl_uint64* r, const sl_uint64* a, sl_size na, const sl_uint64* b, sl_size nb, sl_size n) noexcept
+			{
+				sl_size i = n;
+				sl_bool flagLess = sl_false;
+				while (i > 0) {
+					i--;
+					sl_uint64 x = i < na ? a[i] : 0;
+					sl_uint64 y = i < nb ? b[i] : 0;
+					if (x != y) {
+						flagLess = x < y;
+						break;
+					}
+				}
+				if (flagLess) {
+					const sl_uint64* t = a;
+					a = b;
+					b = t;
+					sl_size nt = na;
+					na = nb;
+					nb = nt;
+				}
+				sl_uint64 borrow = 0;
+				for (i = 0; i < n; i++) {
+					r[i] = SubBorrow(i < na ? a[i] : 0, i < nb ? b[i] : 0, borrow);
+				}
+				return flagLess;
+			}
+
+			SLIB_INLINE static sl_size GetKaratsubaScratchSize(sl_size n) noexcept
+			{
+				return (n << 2) + 256;
+			}
+
+			// r[0..2n) = a * b, splitting a = a1 * B^l + a0 (l = ceil(n/2)) and using a0*b1 + a1*b0 = a0*b0 + a1*b1 + (a0 - a1)(b1 - b0)
+			static void MulKaratsuba(sl_uint64* r, const sl_uint64* a, const sl_uint64* b, sl_size n, sl_uint64* t) noexcept
+			{
+				if (n < KARATSUBA_THRESHOLD) {
+					MulSchoolbook(r, a, n, b, n);
+					return;
+				}
+				sl_size h = n >> 1;
+				sl_size l = n - h;
+				sl_uint64* da = t;
+				sl_uint64* db = t + l;
+				sl_uint64* z1 = t + (l << 1);
+				sl_uint64* next = t + (l << 2);
+				sl_bool fa = AbsDiff(da, a, l, a + l, h, l);
+				sl_bool fb = AbsDiff(db, b + l, h, b, l, l);
+				MulKaratsuba(z1, da, db, l, next);
+				MulKaratsuba(r, a, b, l, next);
+				MulKaratsuba(r + (l << 1), a + l, b + l, h, next);
+				// middle = z0 + z2 +/- z1
+				sl_size nm = (l << 1) + 1;
+				sl_uint64* m = next;
+				Base::copyMemory(m, r, (l << 1) << 3);
+				m[l << 1] = 0;
+				sl_uint64 c = AddLimbs(m, m, r + (l << 1), h << 1, 0);
+				PropagateCarry(m + (h << 1), nm - (h << 1), c);
+				if (fa == fb) {
+					c = AddLimbs(m, m, z1, l << 1, 0);
+					m[l << 1] += c;
+				} else {
+					c = SubLimbs(m, m, z1, l << 1, 0);
+					m[l << 1] -= c;
+				}
+				c = AddLimbs(r + l, r + l, m, nm, 0);
+				PropagateCarry(r + l + nm, (n << 1) - l - nm, c);
+			}
+
+			// r[0..2n) = a * a, using 2*a0*a1 = a0^2 + a1^2 - (a0 - a1)^2
+			static void SqrKaratsuba(sl_uint64* r, const sl_uint64* a, sl_size n, sl_uint64* t) noexcept
+			{
+				if (n < KARATSUBA_SQUARE_THRESHOLD) {
+					SqrSchoolbook(r, a, n);
+					return;
+				}
+				sl_size h = n >> 1;
+				sl_size l = n - h;
+				sl_uint64* da = t;
+				sl_uint64* z1 = t + l;
+				sl_uint64* next = t + l * 3;
+				AbsDiff(da, a, l, a + l, h, l);
+				SqrKaratsuba(z1, da, l, next);
+				SqrKaratsuba(r, a, l, next);
+				SqrKaratsuba(r + (l << 1), a + l, h, next);
+				sl_size nm = (l << 1) + 1;
+				sl_uint64* m = next;
+				Base::copyMemory(m, r, (l << 1) << 3);
+				m[l << 1] = 0;
+				sl_uint64 c = AddLimbs(m, m, r + (l << 1), h << 1, 0);
+				PropagateCarry(m + (h << 1), nm - (h << 1), c);
+				c = SubLimbs(m, m, z1, l << 1, 0);
+				m[l << 1] -= c;
+				c = AddLimbs(r + l, r + l, m, nm, 0);
+				PropagateCarry(r + l + nm, (n << 1) - l - nm, c);
+			}
+
+			// r[0..na+nb) = a * b, t: GetKaratsubaScratchSize(max(na, nb)) * 2 limbs
+			static void MulLimbs(sl_uint64* r, const sl_uint64* a, sl_size na, const sl_uint64* b, sl_size nb, sl_uint64* t) noexcept
+			{
+				if (na < nb) {
+					const sl_uint64* x = a;
+					a = b;
+					b = x;
+					sl_size nx = na;
+					na = nb;
+					nb = nx;
+				}
+				if (nb < KARATSUBA_THRESHOLD) {
+					MulSchoolbook(r, a, na, b, nb);
+					return;
+				}
+				if (na == nb) {
+					MulKaratsuba(r, a, b, na, t);
+					return;
+				}
+				// split the longer operand into pieces of the size of the shorter one
+				sl_uint64* p = t;
+				t += nb << 1;
+				Base::zeroMemory(r, (na + nb) << 3);
+				for (sl_size k = 0; k < na; k += nb) {
+					sl_size m = Math::min(nb, na - k);
+					MulLimbs(p, a + k, m, b, nb, t);
+					sl_uint64 c = AddLimbs(r + k, r + k, p, m + nb, 0);
+					PropagateCarry(r + k + m + nb, na - k - m, c);
+				}
+			}
+
+			// Reads the absolute value into `n` limbs
+			static void ToLimbs(sl_uint64* r, sl_size n, const CBigInt& a) noexcept
+			{
+				const sl_uint32* e = a.elements;
+				sl_size ne = Math::min(a.length, n << 1);
+				sl_size i = 0;
+				for (; i + 1 < ne; i += 2) {
+					r[i >> 1] = SLIB_MAKE_QWORD4(e[i + 1], e[i]);
+				}
+				if (i < ne) {
+					r[i >> 1] = e[i];
+					i += 2;
+				}
+				for (i >>= 1; i < n; i++) {
+					r[i] = 0;
+				}
+			}
+
+			static sl_bool FromLimbs(CBigInt& r, const sl_uint64* a, sl_size n) noexcept
+			{
+				while (n > 0 && !(a[n - 1])) {
+					n--;
+				}
+				sl_size ne = n << 1;
+				if (ne && !((sl_uint32)(a[n - 1] >> 32))) {
+					ne--;
+				}
+				if (!(r.growLength(ne))) {
+					return sl_false;
+				}
+				sl_uint32* e = r.elements;
+				for (sl_size i = 0; i < ne; i++) {
+					sl_uint64 v = a[i >> 1];
+					e[i] = (i & 1) ? (sl_uint32)(v >> 32) : (sl_uint32)v;
+				}
+				for (sl_size i = ne; i < r.length; i++) {
+					e[i] = 0;
+				}
+				return sl_true;
+			}
+
+		}
+	}
+
 	sl_bool CBigInt::mulAbs(const CBigInt& a, const CBigInt& b) noexcept
 	{
 		sl_size na = a.getMostSignificantElements();
@@ -1800,50 +2108,26 @@ namespace slib
 			setZero();
 			return sl_true;
 		}
-		sl_size nd;
-		if (&a == this) {
-			nd = na;
-		} else if (&b == this) {
-			nd = nb;
-		} else {
-			nd = getMostSignificantElements();
-		}
+		na = (na + 1) >> 1;
+		nb = (nb + 1) >> 1;
 		sl_size n = na + nb;
-		SLIB_SCOPED_BUFFER(sl_uint64, STACK_BUFFER_SIZE, out, n);
-		if (!out) {
+		sl_size nt = priv::bigint::GetKaratsubaScratchSize(Math::max(na, nb)) << 1;
+		SLIB_SCOPED_BUFFER(sl_uint64, STACK_BUFFER_SIZE, mem, na + nb + n + nt);
+		if (!mem) {
 			return sl_false;
 		}
-		Base::zeroMemory(out, 8 * n);
-		for (sl_size ib = 0; ib < nb; ib++) {
-			for (sl_size ia = 0; ia < na; ia++) {
-				sl_uint64 c = a.elements[ia];
-				c *= b.elements[ib];
-				out[ia + ib] += (sl_uint32)c;
-				out[ia + ib + 1] += (sl_uint32)(c >> 32);
-			}
-		}
-		sl_uint32 o = 0;
-		sl_size i;
-		sl_size m = 0;
-		for (i = 0; i < n; i++) {
-			sl_uint64 c = out[i] + o;
-			sl_uint32 t = (sl_uint32)c;
-			out[i] = t;
-			if (t) {
-				m = i;
-			}
-			o = (sl_uint32)(c >> 32);
-		}
-		if (growLength(m + 1)) {
-			for (i = 0; i <= m; i++) {
-				elements[i] = (sl_uint32)(out[i]);
-			}
-			for (; i < nd; i++) {
-				elements[i] = 0;
-			}
-			return sl_true;
+		sl_uint64* la = mem;
+		sl_uint64* lb = la + na;
+		sl_uint64* out = lb + nb;
+		sl_uint64* t = out + n;
+		priv::bigint::ToLimbs(la, na, a);
+		if (&a == &b) {
+			priv::bigint::SqrKaratsuba(out, la, na, t);
+		} else {
+			priv::bigint::ToLimbs(lb, nb, b);
+			priv::bigint::MulLimbs(out, la, na, lb, nb, t);
 		}
-		return sl_false;
+		return priv::bigint::FromLimbs(*this, out, n);
 	}
 
 	sl_bool CBigInt::mul(const CBigInt& a, const CBigInt& b) noexcept
@@ -2660,174 +2944,346 @@ namespace slib
 	{
 		namespace bigint
 		{
-			
-			// Montgomery multiplication: A = A * B * R^-1 mod M
-			static sl_bool mont_mul(CBigInt& A, const CBigInt& B, const CBigInt& M, sl_uint32 MI) noexcept
+
+#define POW_WINDOW_MAX_BITS 5
+// in 64-bit limbs, below this CIOS is faster than Karatsuba followed by reduction
+#define MONTGOMERY_KARATSUBA_THRESHOLD 48
+
+			static sl_compare_result CompareLimbs(const sl_uint64* a, const sl_uint64* b, sl_size n) noexcept
 			{
-				sl_size nM = M.length;
-				sl_size nB = Math::min(nM, B.length);
-				
-				sl_size nOut = nM * 2 + 1;
-				SLIB_SCOPED_BUFFER(sl_uint32, STACK_BUFFER_SIZE, out, nOut);
-				if (!out) {
-					return sl_false;
-				}
-				Base::zeroMemory(out, nOut << 2);
-				for (sl_size i = 0; i < nM; i++) {
-					// T = (T + cB*B + cM*M) / 2^(32*nM)
-					sl_uint32 cB = i < A.length ? A.elements[i] : 0;
-					sl_uint32 cM = (out[0] + cB * B.elements[0]) * MI;
-					priv::bigint::MulAdd_uint32(out, out, nOut, B.elements, nB, cB, 0);
-					priv::bigint::MulAdd_uint32(out, out, nOut, M.elements, nM, cM, 0);
-					*out = cB;
-					nOut--;
-					out++;
-				}
-				if (!(A.setValueFromElements(out, nM + 1))) {
-					return sl_false;
-				}
-				if (A.compareAbs(M) >= 0) {
-					if (!(A.subAbs(A, M))) {
-						return sl_false;
+				for (sl_size i = n; i > 0; i--) {
+					if (a[i - 1] != b[i - 1]) {
+						return a[i - 1] < b[i - 1] ? -1 : 1;
 					}
 				}
-				return sl_true;
+				return 0;
 			}
-			
-			// Montgomery reduction: A = A * R^-1 mod M
-			SLIB_INLINE static sl_bool mont_reduction(CBigInt& A, const CBigInt& M, sl_uint32 MI) noexcept
+
+			// All bits are set when `v` is zero
+			SLIB_INLINE static sl_uint64 GetZeroMask(sl_uint64 v) noexcept
 			{
-				CBIGINT_UINT32(o, 1);
-				return priv::bigint::mont_mul(A, o, M, MI);
+				return (sl_uint64)0 - (((v | ((sl_uint64)0 - v)) >> 63) ^ 1);
 			}
-			
-			struct PowMontgomeryContext
-			{
-				CBigInt M;
-				CBigInt T;
-			};
-			
-			static sl_bool pow_montgomery(priv::bigint::PowMontgomeryContext& context, CBigInt& ret, const CBigInt& A, const CBigInt& inE, const CBigInt& inM) noexcept
+
+			static sl_uint32 GetBits(const CBigInt& E, sl_size pos, sl_uint32 nBits) noexcept
 			{
-				CBigInt& M = context.M;
-				CBigInt& T = context.T;
-				
-				M.copyFrom(inM);
-				if (!(M.compact())) {
-					return sl_false;
+				sl_uint32 v = 0;
+				for (sl_uint32 i = 0; i < nBits; i++) {
+					v |= ((sl_uint32)(E.getBit(pos + i))) << i;
 				}
-				sl_size nM = M.getMostSignificantElements();
-				if (!nM) {
-					return sl_false;
-				}
-				if (M.sign < 0) {
-					return sl_false;
+				return v;
+			}
+
+			// Montgomery arithmetic modulo odd M of `n` 64-bit limbs (R = 2^(64n)). Multiplications do not branch on the values
+			class Montgomery
+			{
+			public:
+				sl_size n;
+				sl_uint64* m;
+				sl_uint64* rr; // R^2 mod M
+				sl_uint64 k0; // -M^(-1) mod 2^64
+
+			public:
+				static sl_size getLimbCount(const CBigInt& M) noexcept
+				{
+					return (M.getMostSignificantElements() + 1) >> 1;
 				}
-				const CBigInt* pE;
-				CBigInt _t_E;
-				if (&inE == &ret) {
-					pE = &_t_E;
-					if (!(_t_E.copyFrom(inE))) {
+
+				// `buf`: 2 * getLimbCount(M) limbs, used for `m` and `rr`
+				sl_bool initialize(const CBigInt& M, sl_uint64* buf) noexcept
+				{
+					n = getLimbCount(M);
+					if (!n || M.sign < 0 || !(M.elements[0] & 1)) {
 						return sl_false;
 					}
-				} else {
-					pE = &inE;
-				}
-				const CBigInt& E = *pE;
-				sl_size nE = E.getMostSignificantElements();
-				if (!nE) {
-					if (!(ret.setValue((sl_uint32)1))) {
+					m = buf;
+					rr = buf + n;
+					ToLimbs(m, n, M);
+					// Newton's iteration doubles the number of correct bits (m * m = 1 mod 8)
+					sl_uint64 inv = m[0];
+					for (sl_uint32 i = 0; i < 5; i++) {
+						inv *= 2 - m[0] * inv;
+					}
+					k0 = (sl_uint64)0 - inv;
+					CBigInt R2;
+					if (!(R2.setValue((sl_uint32)1))) {
 						return sl_false;
 					}
-					ret.sign = 1;
+					if (!(R2.shiftLeft(R2, n << 7, &M))) {
+						return sl_false;
+					}
+					ToLimbs(rr, n, R2);
 					return sl_true;
 				}
-				if (E.sign < 0) {
-					return sl_false;
+
+				// scratch size of mul(), sqr(), reduce(), toMontgomery() and fromMontgomery()
+				static sl_size getScratchSize(sl_size n) noexcept
+				{
+					return (n << 1) + 2 + GetKaratsubaScratchSize(n);
 				}
-				sl_size nA = A.getMostSignificantElements();
-				if (!nA) {
-					ret.setZero();
-					return sl_true;
+
+				// r = a * b / R mod M
+				void mul(sl_uint64* r, const sl_uint64* a, const sl_uint64* b, sl_uint64* t) const noexcept
+				{
+					if (n >= MONTGOMERY_KARATSUBA_THRESHOLD) {
+						MulKaratsuba(t, a, b, n, t + (n << 1));
+						reduce(r, t);
+						return;
+					}
+					// CIOS
+					sl_size i, j;
+					for (i = 0; i < n + 2; i++) {
+						t[i] = 0;
+					}
+					for (i = 0; i < n; i++) {
+						sl_uint64 c = 0;
+						sl_uint64 bi = b[i];
+						for (j = 0; j < n; j++) {
+							MulAdd(c, t[j], a[j], bi, t[j], c);
+						}
+						sl_uint64 s = t[n] + c;
+						t[n + 1] = s < c;
+						t[n] = s;
+						sl_uint64 u = t[0] * k0;
+						sl_uint64 lo;
+						MulAdd(c, lo, u, m[0], t[0], 0);
+						for (j = 1; j < n; j++) {
+							MulAdd(c, t[j - 1], u, m[j], t[j], c);
+						}
+						s = t[n] + c;
+						t[n - 1] = s;
+						t[n] = t[n + 1] + (s < c);
+					}
+					finalSubtract(r, t, t[n]);
 				}
-				
-				// MI = -(M0^-1) mod (2^32)
-				sl_uint32 MI;
-				// initialize montgomery
+
+				// r = a * a / R mod M
+				void sqr(sl_uint64* r, const sl_uint64* a, sl_uint64* t) const noexcept
+				{
+					SqrKaratsuba(t, a, n, t + (n << 1));
+					reduce(r, t);
+				}
+
+				// r = t / R mod M, where t (2n limbs, overwritten) < M * R
+				void reduce(sl_uint64* r, sl_uint64* t) const noexcept
 				{
-					sl_uint32 M0 = M.elements[0];
-					sl_uint32 K = M0;
-					K += ((M0 + 2) & 4) << 1;
-					for (sl_uint32 i = 32; i >= 8; i /= 2) {
-						K *= (2 - (M0 * K));
+					sl_uint64 carry = 0;
+					for (sl_size i = 0; i < n; i++) {
+						sl_uint64 c = MulAddLimbs(t + i, m, n, t[i] * k0);
+						sl_uint64 s = t[i + n] + c;
+						sl_uint64 o = s < c;
+						sl_uint64 v = s + carry;
+						o += v < carry;
+						t[i + n] = v;
+						carry = o;
 					}
-					MI = 0 - K;
+					finalSubtract(r, t + n, carry);
 				}
-				
-				// pre-compute R^2 mod M
-				// R = 2^(nM*32)
-				CBigInt R2;
+
+				// r = A * R mod M
+				sl_bool toMontgomery(sl_uint64* r, const CBigInt& A, sl_uint64* t) const noexcept
 				{
-					if (!(R2.setValue((sl_uint32)1))) {
-						return sl_false;
+					sl_size nA = getLimbCount(A);
+					if (nA <= n) {
+						ToLimbs(r, n, A);
+						mul(r, r, rr, t);
+					} else {
+						sl_uint64* x = t + getScratchSize(n);
+						if (nA <= (n << 1)) {
+							ToLimbs(x, n << 1, A);
+						}
+						if (nA <= (n << 1) && CompareLimbs(x + n, m, n) < 0) {
+							// A / R mod M, then multiplied by R^2 twice
+							reduce(r, x);
+							mul(r, r, rr, t);
+							mul(r, r, rr, t);
+						} else {
+							CBigInt M, T;
+							if (!(FromLimbs(M, m, n))) {
+								return sl_false;
+							}
+							if (!(CBigInt::divAbs(A, M, sl_null, &T))) {
+								return sl_false;
+							}
+							ToLimbs(r, n, T);
+							mul(r, r, rr, t);
+						}
 					}
-					if (!(R2.shiftLeft(R2, nM * 64, &M))) {
-						return sl_false;
+					if (A.sign < 0) {
+						sl_uint64 v = 0;
+						for (sl_size i = 0; i < n; i++) {
+							v |= r[i];
+						}
+						if (v) {
+							SubLimbs(r, m, r, n, 0);
+						}
 					}
+					return sl_true;
 				}
-				
-				sl_bool flagNegative = A.sign < 0;
-				// T = A * R^2 * R^-1 mod M = A * R mod M
-				if (!(T.mod(A, M, sl_true))) {
-					return sl_false;
-				}
-				if (!(mont_mul(T, R2, M, MI))) {
-					return sl_false;
-				}
-				
-				// C = R^2 * R^-1 mod M = R mod M
-				ret.moveFrom(R2);
-				if (!(mont_reduction(ret, M, MI))) {
-					return sl_false;
+
+				// r = a / R mod M
+				void fromMontgomery(sl_uint64* r, const sl_uint64* a, sl_uint64* t) const noexcept
+				{
+					Base::copyMemory(t, a, n << 3);
+					Base::zeroMemory(t + n, n << 3);
+					reduce(r, t);
 				}
-				
-				sl_size nbE = E.getMostSignificantBits();
-				for (sl_size ib = 0; ib < nbE; ib++) {
-					sl_size ke = ib >> 5;
-					sl_uint32 kb = (sl_uint32)(ib & 31);
-					if (((E.elements[ke]) >> kb) & 1) {
-						// C = C * T * R^-1 mod M
-						if (!(mont_mul(ret, T, M, MI))) {
-							return sl_false;
+
+				/*
+					ret = A^E mod M (E > 0)
+					Exponents longer than 64 bits use fixed windows with a full scan of the table, so that the sequence of the operations and the memory access pattern does not depend on the exponent bits.
+					Shorter (public) exponents use left-to-right binary exponentiation.
+				*/
+				sl_bool pow(CBigInt& ret, const CBigInt& A, const CBigInt& E) const noexcept
+				{
+					sl_size nbE = E.getMostSignificantBits();
+					sl_uint32 nWindowBits;
+					if (nbE <= 64) {
+						nWindowBits = 1;
+					} else if (nbE <= 512) {
+						nWindowBits = 4;
+					} else {
+						nWindowBits = POW_WINDOW_MAX_BITS;
+					}
+					sl_uint32 nTable = nWindowBits > 1 ? (1 << nWindowBits) : 2;
+					sl_size nScratch = getScratchSize(n);
+					SLIB_SCOPED_BUFFER(sl_uint64, STACK_BUFFER_SIZE, mem, n * (nTable + 2) + nScratch + (n << 1));
+					if (!mem) {
+						return sl_false;
+					}
+					sl_uint64* table = mem;
+					sl_uint64* acc = table + n * nTable;
+					sl_uint64* sel = acc + n;
+					sl_uint64* t = sel + n;
+					sl_uint64* a = table + n;
+					if (!(toMontgomery(a, A, t))) {
+						return sl_false;
+					}
+					if (nWindowBits == 1) {
+						Base::copyMemory(acc, a, n << 3);
+						for (sl_size i = nbE - 1; i > 0; i--) {
+							sqr(acc, acc, t);
+							if (E.getBit(i - 1)) {
+								mul(acc, acc, a, t);
+							}
+						}
+					} else {
+						// table[0] = R mod M
+						Base::zeroMemory(table, n << 3);
+						table[0] = 1;
+						mul(table, table, rr, t);
+						for (sl_uint32 k = 2; k < nTable; k++) {
+							mul(table + n * k, table + n * (k - 1), a, t);
+						}
+						sl_size nWindows = (nbE + nWindowBits - 1) / nWindowBits;
+						for (sl_size w = nWindows; w > 0; w--) {
+							sl_size pos = (w - 1) * nWindowBits;
+							sl_uint64 digit = GetBits(E, pos, nWindowBits);
+							Base::zeroMemory(sel, n << 3);
+							for (sl_uint32 k = 0; k < nTable; k++) {
+								sl_uint64 mask = GetZeroMask(digit ^ k);
+								const sl_uint64* entry = table + n * k;
+								for (sl_size i = 0; i < n; i++) {
+									sel[i] |= entry[i] & mask;
+								}
+							}
+							if (w == nWindows) {
+								Base::copyMemory(acc, sel, n << 3);
+							} else {
+								for (sl_uint32 k = 0; k < nWindowBits; k++) {
+									sqr(acc, acc, t);
+								}
+								mul(acc, acc, sel, t);
+							}
 						}
 					}
-					// T = T * T * R^-1 mod M
-					if (!(mont_mul(T, T, M, MI))) {
+					fromMontgomery(acc, acc, t);
+					if (!(FromLimbs(ret, acc, n))) {
 						return sl_false;
 					}
+					ret.sign = 1;
+					return sl_true;
 				}
-				if (!(mont_reduction(ret, M, MI))) {
-					return sl_false;
-				}
-				if (flagNegative && (E.elements[0] & 1) != 0) {
-					ret.sign = -1;
-					if (!(ret.add(M))) {
+
+				// ret = A * B mod M
+				sl_bool mulMod(CBigInt& ret, const CBigInt& A, const CBigInt& B) const noexcept
+				{
+					sl_size nScratch = getScratchSize(n);
+					SLIB_SCOPED_BUFFER(sl_uint64, STACK_BUFFER_SIZE, mem, (n << 2) + nScratch);
+					if (!mem) {
+						return sl_false;
+					}
+					sl_uint64* a = mem;
+					sl_uint64* b = a + n;
+					sl_uint64* t = b + n;
+					if (!(toMontgomery(a, A, t))) {
+						return sl_false;
+					}
+					if (!(toMontgomery(b, B, t))) {
+						return sl_false;
+					}
+					mul(a, a, b, t);
+					fromMontgomery(a, a, t);
+					if (!(FromLimbs(ret, a, n))) {
 						return sl_false;
 					}
-				} else {
 					ret.sign = 1;
+					return sl_true;
 				}
-				return sl_true;
-			}
-			
+
+			private:
+				// r = t mod M, where (carry, t) < 2M. `r` must not overlap `t`
+				void finalSubtract(sl_uint64* r, const sl_uint64* t, sl_uint64 carry) const noexcept
+				{
+					sl_uint64 borrow = SubLimbs(r, t, m, n, 0);
+					// keep `t` only when t < M (borrow without carry)
+					sl_uint64 mask = (sl_uint64)0 - ((carry | (borrow ^ 1)) & 1);
+					for (sl_size i = 0; i < n; i++) {
+						r[i] = (r[i] & mask) | (t[i] & ~mask);
+					}
+				}
+
+			};
+
 		}
 	}
 
-	
-	sl_bool CBigInt::pow_montgomery(const CBigInt& A, const CBigInt& inE, const CBigInt& inM) noexcept
+	sl_bool CBigInt::pow_montgomery(const CBigInt& A, const CBigInt& E, const CBigInt& M) noexcept
 	{
-		priv::bigint::PowMontgomeryContext context;
-		return priv::bigint::pow_montgomery(context, *this, A, inE, inM);
+		if (M.sign < 0) {
+			return sl_false;
+		}
+		sl_size nM = M.getMostSignificantElements();
+		if (!nM) {
+			return sl_false;
+		}
+		if (!(M.elements[0] & 1)) {
+			return pow(A, E, &M);
+		}
+		if (E.sign < 0) {
+			return sl_false;
+		}
+		if (E.isZero()) {
+			if (!(setValue((sl_uint32)1))) {
+				return sl_false;
+			}
+			sign = 1;
+			return sl_true;
+		}
+		if (A.isZero()) {
+			setZero();
+			return sl_true;
+		}
+		sl_size n = priv::bigint::Montgomery::getLimbCount(M);
+		SLIB_SCOPED_BUFFER(sl_uint64, 256, buf, n << 1);
+		if (!buf) {
+			return sl_false;
+		}
+		priv::bigint::Montgomery mont;
+		if (!(mont.initialize(M, buf))) {
+			return sl_false;
+		}
+		return mont.pow(*this, A, E);
 	}
 	
 	sl_bool CBigInt::pow_montgomery(const CBigInt& E, const CBigInt& M) noexcept
@@ -3358,8 +3814,6 @@ namespace slib
 				CBigInt n3;
 				CBigInt x;
 				CBigInt y;
-				
-				priv::bigint::PowMontgomeryContext contextPowMontgomery;
 			};
 			
 			static sl_bool isProbablePrime(priv::bigint::ProbablePrimeCheckContext& context, const CBigInt& n, sl_uint32 nChecks, sl_bool* pFlagError) noexcept
@@ -3404,7 +3858,7 @@ namespace slib
 					if (!(a.add(2))) {
 						RETURN_ERROR;
 					}
-					if (!(priv::bigint::pow_montgomery(context.contextPowMontgomery, x, a, d, n))) {
+					if (!(x.pow_montgomery(a, d, n))) {
 						RETURN_ERROR;
 					}
 					if (!(x.equals((sl_uint32)1)) && !(x.equals(n1))) { // x = 1 or x = n - 1 => probably prime
@@ -3956,7 +4410,7 @@ namespace slib
 			if (b) {
 				return b->isZero();
 			} else {
-				return 0;
+				return sl_true;
 			}
 		}
 	}
@@ -6184,4 +6638,116 @@ namespace slib
 		return *this;
 	}
 
+
+	namespace priv
+	{
+		namespace bigint
+		{
+
+			class MontgomeryContextImpl : public MontgomeryContext
+			{
+			public:
+				Montgomery m_engine;
+				sl_uint64* m_limbs;
+
+			public:
+				MontgomeryContextImpl() noexcept: m_limbs(sl_null)
+				{
+				}
+
+				~MontgomeryContextImpl() noexcept
+				{
+					if (m_limbs) {
+						Base::freeMemory(m_limbs);
+					}
+				}
+
+			public:
+				sl_bool initialize(const BigInt& M) noexcept
+				{
+					CBigInt* m = M.ref.ptr;
+					if (!m) {
+						return sl_false;
+					}
+					sl_size n = Montgomery::getLimbCount(*m);
+					if (!n) {
+						return sl_false;
+					}
+					m_limbs = (sl_uint64*)(Base::createMemory(n << 4));
+					if (!m_limbs) {
+						return sl_false;
+					}
+					if (!(m_engine.initialize(*m, m_limbs))) {
+						return sl_false;
+					}
+					m_modulus = M;
+					return sl_true;
+				}
+
+			};
+
+		}
+	}
+
+	MontgomeryContext::MontgomeryContext() noexcept
+	{
+	}
+
+	MontgomeryContext::~MontgomeryContext() noexcept
+	{
+	}
+
+	Ref<MontgomeryContext> MontgomeryContext::create(const BigInt& M) noexcept
+	{
+		Ref<priv::bigint::MontgomeryContextImpl> ret = new priv::bigint::MontgomeryContextImpl;
+		if (ret.isNotNull()) {
+			if (ret->initialize(M)) {
+				return ret;
+			}
+		}
+		return sl_null;
+	}
+
+	const BigInt& MontgomeryContext::getModulus() const noexcept
+	{
+		return m_modulus;
+	}
+
+	BigInt MontgomeryContext::pow(const BigInt& A, const BigInt& E) const noexcept
+	{
+		CBigInt* a = A.ref.ptr;
+		CBigInt* e = E.ref.ptr;
+		if (!e || e->isZero()) {
+			return BigInt::fromUint32(1);
+		}
+		if (!a || a->isZero() || e->sign < 0) {
+			return sl_null;
+		}
+		CBigInt* r = new CBigInt;
+		if (r) {
+			if (((priv::bigint::MontgomeryContextImpl*)this)->m_engine.pow(*r, *a, *e)) {
+				return r;
+			}
+			delete r;
+		}
+		return sl_null;
+	}
+
+	BigInt MontgomeryContext::mulMod(const BigInt& A, const BigInt& B) const noexcept
+	{
+		CBigInt* a = A.ref.ptr;
+		CBigInt* b = B.ref.ptr;
+		if (!a || !b) {
+			return sl_null;
+		}
+		CBigInt* r = new CBigInt;
+		if (r) {
+			if (((priv::bigint::MontgomeryContextImpl*)this)->m_engine.mulMod(*r, *a, *b)) {
+				return r;
+			}
+			delete r;
+		}
+		return sl_null;
+	}
+
 }
@@ -26,6 +26,7 @@
 #include "slib/core/scoped_buffer.h"
 #include "slib/core/mio.h"
 #include "slib/core/log.h"
+#include "slib/core/system.h"
 
 #define PRIV_MAX_NAME SLIB_NETWORK_DNS_NAME_MAX_LENGTH
 
@@ -711,10 +712,543 @@ namespace slib
 	}
 
 
+	namespace priv
+	{
+		namespace dns
+		{
+
+#define DNS_TYPE_OPT 41
+#define DNS_MIN_UDP_PAYLOAD_SIZE 512
+#define MAX_QUESTION_KEY_LENGTH (PRIV_MAX_NAME + 6)
+#define QUESTION_KEY_FLAG_CD 1
+#define QUESTION_KEY_FLAG_DO 2
+
+			// Finds the OPT record (RFC 6891) among the records starting at `offset`. Returns the UDP payload size of the sender (512 without OPT), 0 when the records are malformed
+			static sl_uint32 ParseEdns(const void* packet, sl_uint32 size, sl_uint32 offset, sl_bool& flagDO, sl_uint32* pOffsetOPT = sl_null, sl_uint32* pSizeOPT = sl_null)
+			{
+				const sl_uint8* buf = (const sl_uint8*)packet;
+				DnsHeader* header = (DnsHeader*)buf;
+				flagDO = sl_false;
+				sl_uint32 n = header->getAnswerCount() + header->getAuthorityCount() + header->getAdditionalCount();
+				for (sl_uint32 i = 0; i < n; i++) {
+					DnsResponseRecord record;
+					sl_uint32 next = record.parseRecord(buf, offset, size);
+					if (!next) {
+						return 0;
+					}
+					if ((sl_uint32)(record.getType()) == DNS_TYPE_OPT) {
+						// TTL: extended RCODE (8 bits), VERSION (8 bits), DO (1 bit), Z (15 bits)
+						flagDO = (record.getTTL() & 0x8000) != 0;
+						if (pOffsetOPT) {
+							*pOffsetOPT = offset;
+						}
+						if (pSizeOPT) {
+							*pSizeOPT = next - offset;
+						}
+						sl_uint32 sizePayload = (sl_uint32)(record.getClass());
+						return sizePayload > DNS_MIN_UDP_PAYLOAD_SIZE ? sizePayload : DNS_MIN_UDP_PAYLOAD_SIZE;
+					}
+					offset = next;
+				}
+				return DNS_MIN_UDP_PAYLOAD_SIZE;
+			}
+
+			// Writes the question name (in lower case), type and class of `packet`, followed by a byte of CD and DO flags (RFC 4035), into `key`. Returns the length of the key, 0 when the question is not cacheable
+			static sl_uint32 GetQuestionKey(const void* packet, sl_uint32 size, sl_uint8* key)
+			{
+				const sl_uint8* buf = (const sl_uint8*)packet;
+				if (size < sizeof(DnsHeader)) {
+					return 0;
+				}
+				DnsHeader* header = (DnsHeader*)buf;
+				if (header->getOpcode() != DnsOpcode::Query || header->getQuestionCount() != 1) {
+					return 0;
+				}
+				sl_uint32 pos = sizeof(DnsHeader);
+				sl_uint32 lenKey = 0;
+				for (;;) {
+					if (pos >= size) {
+						return 0;
+					}
+					sl_uint32 lenLabel = buf[pos];
+					if (lenLabel > SLIB_NETWORK_DNS_LABEL_MAX_LENGTH) {
+						// compressed name is not expected in the question
+						return 0;
+					}
+					if (pos + 1 + lenLabel > size || lenKey + 1 + lenLabel > PRIV_MAX_NAME) {
+						return 0;
+					}
+					key[lenKey++] = (sl_uint8)lenLabel;
+					pos++;
+					for (sl_uint32 i = 0; i < lenLabel; i++) {
+						sl_uint8 ch = buf[pos++];
+						if (ch >= 'A' && ch <= 'Z') {
+							ch = ch - 'A' + 'a';
+						}
+						key[lenKey++] = ch;
+					}
+					if (!lenLabel) {
+						break;
+					}
+				}
+				if (pos + 4 > size) {
+					return 0;
+				}
+				if (MIO::readUint16BE(buf + pos) >= (sl_uint16)(DnsRecordType::Question_AXFR)) {
+					return 0;
+				}
+				Base::copyMemory(key + lenKey, buf + pos, 4);
+				lenKey += 4;
+				// Answers differ by DNSSEC: the signatures are added for DO, and the validation is skipped for CD
+				sl_bool flagDO;
+				if (!(ParseEdns(buf, size, pos + 4, flagDO))) {
+					return 0;
+				}
+				sl_uint8 flags = 0;
+				if (header->isCD()) {
+					flags |= QUESTION_KEY_FLAG_CD;
+				}
+				if (flagDO) {
+					flags |= QUESTION_KEY_FLAG_DO;
+				}
+				key[lenKey++] = flags;
+				return lenKey;
+			}
+
+			// Sets the transaction id, and copies the question name of `query` to keep its letter case (the names are equal ignoring the case)
+			static void PatchQuestion(void* response, sl_uint32 size, sl_uint16 id, const void* query, sl_uint32 sizeQuery, sl_uint32 lenKey)
+			{
+				((DnsHeader*)response)->setId(id);
+				if (query && lenKey && sizeof(DnsHeader) + lenKey <= size && sizeof(DnsHeader) + lenKey <= sizeQuery) {
+					Base::copyMemory((sl_uint8*)response + sizeof(DnsHeader), (const sl_uint8*)query + sizeof(DnsHeader), lenKey - 5);
+				}
+			}
+
+			// When `response` exceeds the UDP payload size of `query` (512 bytes without EDNS), leaves the header having TC flag, the question and the OPT record. Returns the size of the response
+			static sl_uint32 TruncateResponse(void* response, sl_uint32 size, const void* query, sl_uint32 sizeQuery, sl_uint32 lenKey)
+			{
+				sl_uint32 offsetRecords = (sl_uint32)sizeof(DnsHeader) + lenKey - 1;
+				if (size <= DNS_MIN_UDP_PAYLOAD_SIZE || offsetRecords > size) {
+					return size;
+				}
+				sl_bool flagDO;
+				sl_uint32 sizeLimit = DNS_MIN_UDP_PAYLOAD_SIZE;
+				if (query && offsetRecords <= sizeQuery) {
+					sizeLimit = ParseEdns(query, sizeQuery, offsetRecords, flagDO);
+					if (!sizeLimit) {
+						sizeLimit = DNS_MIN_UDP_PAYLOAD_SIZE;
+					}
+				}
+				if (size <= sizeLimit) {
+					return size;
+				}
+				sl_uint8* buf = (sl_uint8*)response;
+				sl_uint32 offsetOPT = 0;
+				sl_uint32 sizeOPT = 0;
+				ParseEdns(buf, size, offsetRecords, flagDO, &offsetOPT, &sizeOPT);
+				DnsHeader* header = (DnsHeader*)buf;
+				header->setTC(sl_true);
+				header->setAnswerCount(0);
+				header->setAuthorityCount(0);
+				header->setAdditionalCount(0);
+				if (sizeOPT && offsetRecords + sizeOPT <= sizeLimit) {
+					Base::moveMemory(buf + offsetRecords, buf + offsetOPT, sizeOPT);
+					header->setAdditionalCount(1);
+					return offsetRecords + sizeOPT;
+				}
+				return offsetRecords;
+			}
+
+			class CacheEntry
+			{
+			public:
+				Memory response;
+				List<sl_uint16> offsetsTTL;
+				sl_uint64 timeInsert; // milliseconds
+				sl_uint64 timeExpire; // milliseconds
+				sl_uint32 TTL; // seconds
+				sl_uint32 countHits;
+				sl_bool flagNegative;
+				sl_bool flagPrefetching;
+
+			public:
+				CacheEntry()
+				{
+					timeInsert = 0;
+					timeExpire = 0;
+					TTL = 0;
+					countHits = 0;
+					flagNegative = sl_false;
+					flagPrefetching = sl_false;
+				}
+
+			};
+
+			class CacheShard
+			{
+			public:
+				CHashMap<String, CacheEntry> entries;
+				sl_uint64 countHits = 0;
+				sl_uint64 countNegativeHits = 0;
+				sl_uint64 countMisses = 0;
+				sl_uint64 countInsertions = 0;
+				sl_uint64 countEvictions = 0;
+				sl_uint64 countPrefetches = 0;
+
+			};
+
+			class CacheImpl : public DnsCache
+			{
+			public:
+				DnsCacheParam m_param;
+				CacheShard* m_shards;
+				sl_uint32 m_nShards;
+				sl_size m_maxEntriesPerShard;
+
+			public:
+				CacheImpl()
+				{
+					m_shards = sl_null;
+					m_nShards = 0;
+					m_maxEntriesPerShard = 0;
+				}
+
+				~CacheImpl()
+				{
+					if (m_shards) {
+						delete[] m_shards;
+					}
+				}
+
+			public:
+				static Ref<CacheImpl> create(const DnsCacheParam& param)
+				{
+					Ref<CacheImpl> ret = new CacheImpl;
+					if (ret.isNull()) {
+						return sl_null;
+					}
+					sl_uint32 nShards = param.shardCount;
+					if (!nShards) {
+						nShards = 1;
+					}
+					ret->m_shards = new CacheShard[nShards];
+					if (!(ret->m_shards)) {
+						return sl_null;
+					}
+					ret->m_nShards = nShards;
+					ret->m_param = param;
+					if (param.maxEntries) {
+						ret->m_maxEntriesPerShard = (param.maxEntries + nShards - 1) / nShards;
+					}
+					return ret;
+				}
+
+			public:
+				Memory getResponse(const void* query, sl_uint32 sizeQuery, sl_bool* pFlagPrefetch) override
+				{
+					if (pFlagPrefetch) {
+						*pFlagPrefetch = sl_false;
+					}
+					sl_uint8 key[MAX_QUESTION_KEY_LENGTH];
+					sl_uint32 lenKey = GetQuestionKey(query, sizeQuery, key);
+					if (!lenKey) {
+						return sl_null;
+					}
+					String strKey((sl_char8*)key, lenKey);
+					CacheShard& shard = _getShard(key, lenKey);
+					sl_uint64 now = System::getTickCount64();
+
+					MutexLocker lock(shard.entries.getLocker());
+					CacheEntry* entry = shard.entries.getItemPointer(strKey);
+					if (!entry) {
+						shard.countMisses++;
+						return sl_null;
+					}
+					if (now >= entry->timeExpire) {
+						shard.entries.remove_NoLock(strKey);
+						shard.countMisses++;
+						return sl_null;
+					}
+					entry->countHits++;
+					shard.countHits++;
+					if (entry->flagNegative) {
+						shard.countNegativeHits++;
+					} else if (m_param.prefetchPercent && !(entry->flagPrefetching) && entry->countHits >= m_param.prefetchMinHits) {
+						if (entry->timeExpire - now < (sl_uint64)(entry->TTL) * 10 * m_param.prefetchPercent) {
+							entry->flagPrefetching = sl_true;
+							shard.countPrefetches++;
+							if (pFlagPrefetch) {
+								*pFlagPrefetch = sl_true;
+							}
+						}
+					}
+					Memory response = entry->response;
+					List<sl_uint16> offsetsTTL = entry->offsetsTTL;
+					sl_uint32 elapsed = (sl_uint32)((now - entry->timeInsert) / 1000);
+					sl_uint32 remain = (sl_uint32)((entry->timeExpire - now + 999) / 1000);
+					lock.unlock();
+
+					sl_uint32 size = (sl_uint32)(response.getSize());
+					Memory ret = Memory::create(response.getData(), size);
+					if (ret.isNull()) {
+						return sl_null;
+					}
+					sl_uint8* buf = (sl_uint8*)(ret.getData());
+					PatchQuestion(buf, size, ((DnsHeader*)query)->getId(), query, sizeQuery, lenKey);
+					ListElements<sl_uint16> offsets(offsetsTTL);
+					for (sl_size i = 0; i < offsets.count; i++) {
+						sl_uint8* p = buf + offsets[i];
+						sl_uint32 TTL = MIO::readUint32BE(p);
+						TTL = TTL > elapsed ? TTL - elapsed : 0;
+						if (TTL > remain) {
+							TTL = remain;
+						}
+						MIO::writeUint32BE(p, TTL);
+					}
+					sl_uint32 sizeTruncated = TruncateResponse(buf, size, query, sizeQuery, lenKey);
+					if (sizeTruncated < size) {
+						return ret.sub(0, sizeTruncated);
+					}
+					return ret;
+				}
+
+				sl_bool putResponse(const void* response, sl_uint32 size) override
+				{
+					const sl_uint8* buf = (const sl_uint8*)response;
+					sl_uint8 key[MAX_QUESTION_KEY_LENGTH];
+					sl_uint32 lenKey = GetQuestionKey(response, size, key);
+					if (!lenKey) {
+						return sl_false;
+					}
+					DnsHeader* header = (DnsHeader*)buf;
+					if (header->isQuestion() || header->isTC()) {
+						return sl_false;
+					}
+					DnsResponseCode code = header->getResponseCode();
+					if (code != DnsResponseCode::NoError && code != DnsResponseCode::NameError) {
+						return sl_false;
+					}
+
+					CacheEntry entry;
+					sl_uint32 nAnswers = header->getAnswerCount();
+					sl_uint32 nAuthorities = header->getAuthorityCount();
+					sl_uint32 n = nAnswers + nAuthorities + header->getAdditionalCount();
+					sl_uint32 minAnswerTTL = 0xFFFFFFFF;
+					sl_uint32 negativeTTL = 0;
+					sl_bool flagSOA = sl_false;
+					sl_uint32 offset = sizeof(DnsHeader) + lenKey - 1;
+					for (sl_uint32 i = 0; i < n; i++) {
+						DnsResponseRecord record;
+						offset = record.parseRecord(buf, offset, size);
+						if (!offset) {
+							return sl_false;
+						}
+						sl_uint32 type = (sl_uint32)(record.getType());
+						if (type == DNS_TYPE_OPT) {
+							continue;
+						}
+						sl_uint32 TTL = record.getTTL();
+						entry.offsetsTTL.add_NoLock((sl_uint16)(record.getDataOffset() - 6));
+						if (i < nAnswers) {
+							if (TTL < minAnswerTTL) {
+								minAnswerTTL = TTL;
+							}
+						} else if (i < nAnswers + nAuthorities) {
+							if (type == (sl_uint32)(DnsRecordType::SOA) && record.getDataLength() >= 22) {
+								// RFC 2308: TTL of the negative answer is the minimum of SOA's TTL and SOA.MINIMUM
+								sl_uint32 minimum = MIO::readUint32BE(buf + record.getDataOffset() + record.getDataLength() - 4);
+								if (!flagSOA || TTL < negativeTTL) {
+									negativeTTL = TTL;
+								}
+								if (minimum < negativeTTL) {
+									negativeTTL = minimum;
+								}
+								flagSOA = sl_true;
+							}
+						}
+					}
+
+					sl_uint32 TTL;
+					if (code == DnsResponseCode::NameError || !nAnswers) {
+						if (!flagSOA) {
+							return sl_false;
+						}
+						TTL = Math::min(negativeTTL, m_param.maxNegativeTTL);
+						entry.flagNegative = sl_true;
+					} else {
+						TTL = Math::clamp(minAnswerTTL, m_param.minTTL, m_param.maxTTL);
+					}
+					if (!TTL) {
+						return sl_false;
+					}
+					entry.response = Memory::create(buf, size);
+					if (entry.response.isNull()) {
+						return sl_false;
+					}
+					sl_uint64 now = System::getTickCount64();
+					entry.timeInsert = now;
+					entry.timeExpire = now + (sl_uint64)TTL * 1000;
+					entry.TTL = TTL;
+
+					String strKey((sl_char8*)key, lenKey);
+					CacheShard& shard = _getShard(key, lenKey);
+					MutexLocker lock(shard.entries.getLocker());
+					if (m_maxEntriesPerShard && shard.entries.getCount() >= m_maxEntriesPerShard) {
+						if (!(shard.entries.find_NoLock(strKey))) {
+							_evict(shard, now);
+						}
+					}
+					if (shard.entries.put_NoLock(Move(strKey), Move(entry))) {
+						shard.countInsertions++;
+						return sl_true;
+					}
+					return sl_false;
+				}
+
+				void removeAll() override
+				{
+					for (sl_uint32 i = 0; i < m_nShards; i++) {
+						m_shards[i].entries.removeAll();
+					}
+				}
+
+				void getStatistics(DnsCacheStatistics& statistics) override
+				{
+					statistics = DnsCacheStatistics();
+					for (sl_uint32 i = 0; i < m_nShards; i++) {
+						CacheShard& shard = m_shards[i];
+						MutexLocker lock(shard.entries.getLocker());
+						statistics.countHits += shard.countHits;
+						statistics.countNegativeHits += shard.countNegativeHits;
+						statistics.countMisses += shard.countMisses;
+						statistics.countInsertions += shard.countInsertions;
+						statistics.countEvictions += shard.countEvictions;
+						statistics.countPrefetches += shard.countPrefetches;
+						statistics.countEntries += shard.entries.getCount();
+					}
+				}
+
+			public:
+				CacheShard& _getShard(const sl_uint8* key, sl_uint32 lenKey)
+				{
+					return m_shards[HashBytes32(key, lenKey) % m_nShards];
+				}
+
+				// Removes the expired entries, and then the oldest entries until 1/8 of the shard is free
+				void _evict(CacheShard& shard, sl_uint64 now)
+				{
+					auto node = shard.entries.getFirstNode();
+					while (node) {
+						auto next = node->getNext();
+						if (now >= node->value.timeExpire) {
+							shard.entries.removeAt(node);
+						}
+						node = next;
+					}
+					sl_size n = shard.entries.getCount();
+					sl_size limit = m_maxEntriesPerShard - (m_maxEntriesPerShard >> 3) - 1;
+					if (n > limit) {
+						shard.countEvictions += shard.entries.removeAt(shard.entries.getFirstNode(), n - limit);
+					}
+				}
+
+			};
+
+		}
+	}
+
+	using namespace priv::dns;
+
+
+	DnsCacheParam::DnsCacheParam()
+	{
+		shardCount = 16;
+		maxEntries = 100000;
+
+		minTTL = 0;
+		maxTTL = 86400;
+		maxNegativeTTL = 3600;
+
+		prefetchPercent = 10;
+		prefetchMinHits = 3;
+	}
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(DnsCacheParam)
+
+
+	DnsCacheStatistics::DnsCacheStatistics()
+	{
+		countHits = 0;
+		countNegativeHits = 0;
+		countMisses = 0;
+		countInsertions = 0;
+		countEvictions = 0;
+		countPrefetches = 0;
+		countEntries = 0;
+	}
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(DnsCacheStatistics)
+
+
+	SLIB_DEFINE_OBJECT(DnsCache, Object)
+
+	DnsCache::DnsCache()
+	{
+	}
+
+	DnsCache::~DnsCache()
+	{
+	}
+
+	Ref<DnsCache> DnsCache::create(const DnsCacheParam& param)
+	{
+		return Ref<DnsCache>::from(CacheImpl::create(param));
+	}
+
+	Ref<DnsCache> DnsCache::create()
+	{
+		return create(DnsCacheParam());
+	}
+
+	Memory DnsCache::getResponse(sl_uint16 id, const String& name, DnsRecordType type, sl_bool* pFlagPrefetch)
+	{
+		sl_uint8 buf[sizeof(DnsHeader) + SLIB_NETWORK_DNS_RECORD_HEADER_MAX_LENGTH];
+		Base::zeroMemory(buf, sizeof(DnsHeader));
+		DnsHeader* header = (DnsHeader*)buf;
+		header->setQuestion(sl_true);
+		header->setId(id);
+		header->setOpcode(DnsOpcode::Query);
+		header->setQuestionCount(1);
+		DnsQuestionRecord record;
+		record.setName(name);
+		record.setType(type);
+		sl_uint32 size = record.buildRecord(buf, sizeof(DnsHeader), sizeof(buf));
+		if (!size) {
+			if (pFlagPrefetch) {
+				*pFlagPrefetch = sl_false;
+			}
+			return sl_null;
+		}
+		return getResponse(buf, size, pFlagPrefetch);
+	}
+
+	String DnsCache::getQuestionKey(const void* packet, sl_uint32 size)
+	{
+		sl_uint8 key[MAX_QUESTION_KEY_LENGTH];
+		sl_uint32 lenKey = GetQuestionKey(packet, size, key);
+		if (lenKey) {
+			return String((sl_char8*)key, lenKey);
+		}
+		return sl_null;
+	}
+
+
 	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(DnsClientParam)
 	
 	DnsClientParam::DnsClientParam()
 	{
+		flagCache = sl_true;
+		coalesceTimeout = 3000;
 	}
 
 	
@@ -723,6 +1257,7 @@ namespace slib
 	DnsClient::DnsClient()
 	{
 		m_idLast = 0;
+		m_coalesceTimeout = 0;
 	}
 
 	DnsClient::~DnsClient()
@@ -734,6 +1269,14 @@ namespace slib
 		Ref<DnsClient> ret = new DnsClient;
 		if (ret.isNotNull()) {
 			ret->m_onAnswer = param.onAnswer;
+			if (param.flagCache) {
+				if (param.cache.isNotNull()) {
+					ret->m_cache = param.cache;
+				} else {
+					ret->m_cache = DnsCache::create(param.cacheParam);
+				}
+			}
+			ret->m_coalesceTimeout = param.coalesceTimeout;
 			AsyncUdpSocketParam up;
 			up.onReceiveFrom = SLIB_FUNCTION_WEAKREF(ret, _onReceiveFrom);
 			up.packetSize = 4096;
@@ -750,9 +1293,51 @@ namespace slib
 	{
 		sl_uint16 id = m_idLast++;
 		Memory mem = DnsPacket::buildQuestionPacket(id, hostName);
-		if (mem.isNotNull()) {
-			m_udp->sendTo(serverAddress, mem);
+		if (mem.isNull()) {
+			return;
+		}
+		const void* query = mem.getData();
+		sl_uint32 sizeQuery = (sl_uint32)(mem.getSize());
+		if (m_cache.isNotNull()) {
+			sl_bool flagPrefetch = sl_false;
+			Memory answer = m_cache->getResponse(query, sizeQuery, &flagPrefetch);
+			if (answer.isNotNull()) {
+				Ref<AsyncIoLoop> loop = m_udp->getIoLoop();
+				if (loop.isNotNull()) {
+					loop->dispatch(SLIB_BIND_WEAKREF(void(), this, _onCachedAnswer, serverAddress, answer));
+				}
+				if (!flagPrefetch) {
+					return;
+				}
+			}
+		}
+		String questionKey = DnsCache::getQuestionKey(query, sizeQuery);
+		if (questionKey.isNotNull()) {
+			sl_uint64 now = System::getTickCount64();
+			String keyPending = serverAddress.toString() + "/" + questionKey;
+			MutexLocker lock(m_mapPending.getLocker());
+			sl_uint16 idPending;
+			if (m_coalesceTimeout && m_mapPendingQuestion.get_NoLock(keyPending, &idPending)) {
+				PendingQuestion* pending = m_mapPending.getItemPointer(idPending);
+				if (pending && pending->questionKey == questionKey && now - pending->timeSent < m_coalesceTimeout) {
+					return;
+				}
+			}
+			PendingQuestion old;
+			if (m_mapPending.remove_NoLock(id, &old)) {
+				String keyOld = old.serverAddress.toString() + "/" + old.questionKey;
+				if (m_mapPendingQuestion.get_NoLock(keyOld, &idPending) && idPending == id) {
+					m_mapPendingQuestion.remove_NoLock(keyOld);
+				}
+			}
+			PendingQuestion pending;
+			pending.serverAddress = serverAddress;
+			pending.questionKey = questionKey;
+			pending.timeSent = now;
+			m_mapPending.put_NoLock(id, Move(pending));
+			m_mapPendingQuestion.put_NoLock(Move(keyPending), id);
 		}
+		m_udp->sendTo(serverAddress, mem);
 	}
 
 	void DnsClient::sendQuestion(const IPv4Address& serverIp, const String& hostName)
@@ -760,10 +1345,37 @@ namespace slib
 		sendQuestion(SocketAddress(serverIp, SLIB_NETWORK_DNS_PORT), hostName);
 	}
 
+	Ref<DnsCache> DnsClient::getCache()
+	{
+		return m_cache;
+	}
+
 	void DnsClient::_onReceiveFrom(AsyncUdpSocket* socket, const SocketAddress& address, void* data, sl_uint32 sizeReceive)
 	{
 		DnsPacket packet;
 		if (packet.parsePacket(data, sizeReceive)) {
+			if (!(packet.flagQuestion)) {
+				PendingQuestion pending;
+				sl_bool flagPending = sl_false;
+				{
+					MutexLocker lock(m_mapPending.getLocker());
+					PendingQuestion* p = m_mapPending.getItemPointer(packet.id);
+					if (p && p->serverAddress == address) {
+						pending = Move(*p);
+						m_mapPending.remove_NoLock(packet.id);
+						String keyPending = pending.serverAddress.toString() + "/" + pending.questionKey;
+						sl_uint16 idPending;
+						if (m_mapPendingQuestion.get_NoLock(keyPending, &idPending) && idPending == packet.id) {
+							m_mapPendingQuestion.remove_NoLock(keyPending);
+						}
+						flagPending = sl_true;
+					}
+				}
+				// Only the answers of the sent questions are cached
+				if (flagPending && m_cache.isNotNull() && pending.questionKey == DnsCache::getQuestionKey(data, sizeReceive)) {
+					m_cache->putResponse(data, sizeReceive);
+				}
+			}
 			_onAnswer(address, packet);
 		}
 	}
@@ -773,6 +1385,14 @@ namespace slib
 		m_onAnswer(this, serverAddress, packet);
 	}
 
+	void DnsClient::_onCachedAnswer(const SocketAddress& serverAddress, const Memory& answer)
+	{
+		DnsPacket packet;
+		if (packet.parsePacket(answer.getData(), (sl_uint32)(answer.getSize()))) {
+			_onAnswer(serverAddress, packet);
+		}
+	}
+
 
 	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(DnsResolveHostParam)
 	
@@ -800,6 +1420,9 @@ namespace slib
 		flagEncryptDefaultForward = sl_false;
 
 		flagAutoStart = sl_true;
+
+		flagCache = sl_true;
+		coalesceTimeout = 3000;
 	}
 
 	void DnsServerParam::parse(const Json& conf)
@@ -813,6 +1436,8 @@ namespace slib
 		IPv4Address defaultForwardAddressIp = IPv4Address(8, 8, 4, 4);
 		defaultForwardAddressIp.parse(conf.getItem("forward_dns").getString());
 		defaultForwardAddress = SocketAddress(defaultForwardAddressIp, SLIB_NETWORK_DNS_PORT);
+
+		flagCache = conf.getItem("cache").getBoolean(sl_true);
 	}
 
 
@@ -824,6 +1449,9 @@ namespace slib
 		m_flagRunning = sl_false;
 
 		m_lastForwardId = 0;
+		m_coalesceTimeout = 0;
+		m_countForwarded = 0;
+		m_countCoalesced = 0;
 
 		m_flagEncryptDefaultForward = sl_false;
 		m_flagProxy = sl_false;
@@ -874,6 +1502,15 @@ namespace slib
 				ret->m_defaultForwardAddress = param.defaultForwardAddress;
 				ret->m_flagEncryptDefaultForward = param.flagEncryptDefaultForward;
 
+				if (param.flagCache) {
+					if (param.cache.isNotNull()) {
+						ret->m_cache = param.cache;
+					} else {
+						ret->m_cache = DnsCache::create(param.cacheParam);
+					}
+				}
+				ret->m_coalesceTimeout = param.coalesceTimeout;
+
 				ret->m_onResolve = param.onResolve;
 				ret->m_onCache = param.onCache;
 
@@ -929,6 +1566,21 @@ namespace slib
 		return m_flagRunning;
 	}
 
+	Ref<DnsCache> DnsServer::getCache()
+	{
+		return m_cache;
+	}
+
+	sl_uint64 DnsServer::getForwardedQuestionCount()
+	{
+		return m_countForwarded;
+	}
+
+	sl_uint64 DnsServer::getCoalescedQuestionCount()
+	{
+		return m_countCoalesced;
+	}
+
 	void DnsServer::_processReceivedDnsQuestion(const SocketAddress& clientAddress, sl_uint16 id, const String& hostName, sl_bool flagEncryptedRequest)
 	{
 		if (hostName.indexOf('.') < 0) {
@@ -947,7 +1599,37 @@ namespace slib
 			_sendPacket(flagEncryptedRequest, clientAddress, _buildHostAddressAnswerPacket(id, hostName, rp.hostAddress, flagEncryptedRequest));
 			return;
 		}
-		if (rp.hostAddress.isNotZero()) {
+
+		String questionKey;
+		sl_bool flagPrefetch = sl_false;
+		if (m_cache.isNotNull() || m_coalesceTimeout) {
+			Memory query = DnsPacket::buildQuestionPacket(id, hostName);
+			sl_uint32 sizeQuery = (sl_uint32)(query.getSize());
+			questionKey = DnsCache::getQuestionKey(query.getData(), sizeQuery);
+			if (questionKey.isNotNull()) {
+				if (rp.hostAddress.isNotZero()) {
+					_sendPacket(flagEncryptedRequest, clientAddress, _buildHostAddressAnswerPacket(id, hostName, rp.hostAddress, flagEncryptedRequest));
+					// The question is forwarded only to refresh `onCache`
+					if (m_cache.isNotNull()) {
+						if (m_cache->getResponse(query.getData(), sizeQuery, &flagPrefetch).isNotNull() && !flagPrefetch) {
+							return;
+						}
+					}
+					if (!flagPrefetch && _coalesceQuestion(questionKey, SocketAddress::none(), id, hostName, sl_null, 0, flagEncryptedRequest)) {
+						return;
+					}
+				} else {
+					if (_sendCachedAnswer(clientAddress, query.getData(), sizeQuery, flagEncryptedRequest, &flagPrefetch)) {
+						if (!flagPrefetch) {
+							return;
+						}
+					} else if (_coalesceQuestion(questionKey, clientAddress, id, hostName, sl_null, 0, flagEncryptedRequest)) {
+						return;
+					}
+				}
+			}
+		}
+		if (questionKey.isNull() && rp.hostAddress.isNotZero()) {
 			_sendPacket(flagEncryptedRequest, clientAddress, _buildHostAddressAnswerPacket(id, hostName, rp.hostAddress, flagEncryptedRequest));
 		}
 		
@@ -958,27 +1640,29 @@ namespace slib
 			fe.requestedId = id;
 			fe.requestedHostName = hostName;
 			fe.flagEncrypted = flagEncryptedRequest;
-			if (rp.hostAddress.isNotZero()) {
-				fe.clientAddress.ip.setNone();
-				fe.clientAddress.port = 0;
+			if (rp.hostAddress.isNotZero() || flagPrefetch) {
+				fe.clientAddress.setNone();
 			} else {
 				fe.clientAddress = clientAddress;
 			}
-			m_mapForward.put(idForward, fe);
+			fe.questionKey = questionKey;
+			_registerForward(idForward, fe);
 			_sendPacket(rp.flagEncryptForward, rp.forwardAddress, _buildQuestionPacket(idForward, hostName, rp.flagEncryptForward));
 		}
 
 	}
 
-	void DnsServer::_processReceivedDnsAnswer(const DnsPacket& packet)
+	void DnsServer::_processReceivedDnsAnswer(const DnsPacket& packet, const void* data, sl_uint32 size)
 	{
 
 		sl_uint16 idForward = packet.id;
 
 		ForwardElement fe;
-		if (m_mapForward.get(idForward, &fe)) {
+		if (_takeForward(idForward, fe)) {
 
-			m_mapForward.remove(idForward);
+			if (m_cache.isNotNull() && fe.questionKey.isNotNull() && fe.questionKey == DnsCache::getQuestionKey(data, size)) {
+				m_cache->putResponse(data, size);
+			}
 
 			String reqNameLower = fe.requestedHostName.toLower();
 
@@ -1050,6 +1734,13 @@ namespace slib
 			if (fe.clientAddress.isValid()) {
 				_sendPacket(fe.flagEncrypted, fe.clientAddress, _buildHostAddressAnswerPacket(fe.requestedId, fe.requestedHostName, resolvedAddress, fe.flagEncrypted));
 			}
+			ListElements<ForwardClient> clients(fe.coalescedClients);
+			for (sl_size i = 0; i < clients.count; i++) {
+				ForwardClient& client = clients[i];
+				if (client.clientAddress.isValid()) {
+					_sendPacket(client.flagEncrypted, client.clientAddress, _buildHostAddressAnswerPacket(client.requestedId, client.requestedHostName, resolvedAddress, client.flagEncrypted));
+				}
+			}
 		}
 	}
 
@@ -1057,12 +1748,29 @@ namespace slib
 	{
 		DnsHeader* header = (DnsHeader*)data;
 
+		String questionKey = DnsCache::getQuestionKey(data, size);
+		sl_bool flagPrefetch = sl_false;
+		if (questionKey.isNotNull()) {
+			if (_sendCachedAnswer(clientAddress, data, size, flagEncryptedRequest, &flagPrefetch)) {
+				if (!flagPrefetch) {
+					return;
+				}
+			} else if (_coalesceQuestion(questionKey, clientAddress, header->getId(), sl_null, data, size, flagEncryptedRequest)) {
+				return;
+			}
+		}
+
 		sl_uint16 idForward = m_lastForwardId++;
 
 		ForwardElement fe;
 		fe.requestedId = header->getId();
 		fe.flagEncrypted = flagEncryptedRequest;
-		fe.clientAddress = clientAddress;
+		if (flagPrefetch) {
+			fe.clientAddress.setNone();
+		} else {
+			fe.clientAddress = clientAddress;
+		}
+		fe.questionKey = questionKey;
 
 		header->setId(idForward);
 		Memory packet = Memory::create(data, size);
@@ -1073,7 +1781,7 @@ namespace slib
 			return;
 		}
 
-		m_mapForward.put(idForward, fe);
+		_registerForward(idForward, fe);
 
 		_sendPacket(m_flagEncryptDefaultForward, m_defaultForwardAddress, packet);
 
@@ -1084,20 +1792,43 @@ namespace slib
 		DnsHeader* header = (DnsHeader*)data;
 		sl_uint16 idForward = header->getId();
 		ForwardElement fe;
-		if (m_mapForward.get(idForward, &fe)) {
+		if (_takeForward(idForward, fe)) {
 
-			m_mapForward.remove(idForward);
-
-			header->setId(fe.requestedId);
-			Memory packet = Memory::create(data, size);
-			if (fe.flagEncrypted) {
-				packet = m_encrypt.encrypt_CBC_PKCS7Padding(packet);
+			if (m_cache.isNotNull() && fe.questionKey.isNotNull() && fe.questionKey == DnsCache::getQuestionKey(data, size)) {
+				m_cache->putResponse(data, size);
 			}
-			if (packet.isNull()) {
-				return;
+
+			if (fe.clientAddress.isValid()) {
+				header->setId(fe.requestedId);
+				Memory packet = Memory::create(data, size);
+				if (fe.flagEncrypted) {
+					packet = m_encrypt.encrypt_CBC_PKCS7Padding(packet);
+				}
+				if (packet.isNotNull()) {
+					_sendPacket(fe.flagEncrypted, fe.clientAddress, packet);
+				}
 			}
 
-			_sendPacket(fe.flagEncrypted, fe.clientAddress, packet);
+			sl_uint32 lenKey = (sl_uint32)(fe.questionKey.getLength());
+			ListElements<ForwardClient> clients(fe.coalescedClients);
+			for (sl_size i = 0; i < clients.count; i++) {
+				ForwardClient& client = clients[i];
+				Memory packet = Memory::create(data, size);
+				if (packet.isNull()) {
+					return;
+				}
+				PatchQuestion(packet.getData(), size, client.requestedId, client.query.getData(), (sl_uint32)(client.query.getSize()), lenKey);
+				sl_uint32 sizePacket = TruncateResponse(packet.getData(), size, client.query.getData(), (sl_uint32)(client.query.getSize()), lenKey);
+				if (sizePacket < size) {
+					packet = packet.sub(0, sizePacket);
+				}
+				if (client.flagEncrypted) {
+					packet = m_encrypt.encrypt_CBC_PKCS7Padding(packet);
+				}
+				if (packet.isNotNull()) {
+					_sendPacket(client.flagEncrypted, client.clientAddress, packet);
+				}
+			}
 		}
 	}
 
@@ -1116,6 +1847,85 @@ namespace slib
 		}
 	}
 
+	sl_bool DnsServer::_sendCachedAnswer(const SocketAddress& clientAddress, const void* query, sl_uint32 sizeQuery, sl_bool flagEncrypted, sl_bool* pFlagPrefetch)
+	{
+		if (m_cache.isNull()) {
+			return sl_false;
+		}
+		Memory answer = m_cache->getResponse(query, sizeQuery, pFlagPrefetch);
+		if (answer.isNull()) {
+			return sl_false;
+		}
+		if (flagEncrypted) {
+			answer = m_encrypt.encrypt_CBC_PKCS7Padding(answer);
+		}
+		_sendPacket(flagEncrypted, clientAddress, answer);
+		return sl_true;
+	}
+
+	sl_bool DnsServer::_coalesceQuestion(const String& questionKey, const SocketAddress& clientAddress, sl_uint16 requestedId, const String& requestedHostName, const void* query, sl_uint32 sizeQuery, sl_bool flagEncrypted)
+	{
+		if (!m_coalesceTimeout) {
+			return sl_false;
+		}
+		MutexLocker lock(m_mapForward.getLocker());
+		sl_uint16 idForward;
+		if (!(m_mapForwardQuestion.get_NoLock(questionKey, &idForward))) {
+			return sl_false;
+		}
+		ForwardElement* fe = m_mapForward.getItemPointer(idForward);
+		if (!fe || fe->questionKey != questionKey || System::getTickCount64() - fe->timeForward >= m_coalesceTimeout) {
+			// The upstream did not answer in time
+			m_mapForwardQuestion.remove_NoLock(questionKey);
+			return sl_false;
+		}
+		ForwardClient client;
+		client.clientAddress = clientAddress;
+		client.requestedId = requestedId;
+		client.requestedHostName = requestedHostName;
+		client.flagEncrypted = flagEncrypted;
+		if (query) {
+			client.query = Memory::create(query, sizeQuery);
+		}
+		fe->coalescedClients.add_NoLock(Move(client));
+		m_countCoalesced++;
+		return sl_true;
+	}
+
+	void DnsServer::_registerForward(sl_uint16 idForward, ForwardElement& fe)
+	{
+		fe.timeForward = System::getTickCount64();
+		MutexLocker lock(m_mapForward.getLocker());
+		// Forward ids are recycled. The unanswered question having the same id is dropped
+		ForwardElement old;
+		if (m_mapForward.remove_NoLock(idForward, &old) && old.questionKey.isNotNull()) {
+			sl_uint16 id;
+			if (m_mapForwardQuestion.get_NoLock(old.questionKey, &id) && id == idForward) {
+				m_mapForwardQuestion.remove_NoLock(old.questionKey);
+			}
+		}
+		if (fe.questionKey.isNotNull()) {
+			m_mapForwardQuestion.put_NoLock(fe.questionKey, idForward);
+		}
+		m_mapForward.put_NoLock(idForward, fe);
+		m_countForwarded++;
+	}
+
+	sl_bool DnsServer::_takeForward(sl_uint16 idForward, ForwardElement& fe)
+	{
+		MutexLocker lock(m_mapForward.getLocker());
+		if (!(m_mapForward.remove_NoLock(idForward, &fe))) {
+			return sl_false;
+		}
+		if (fe.questionKey.isNotNull()) {
+			sl_uint16 id;
+			if (m_mapForwardQuestion.get_NoLock(fe.questionKey, &id) && id == idForward) {
+				m_mapForwardQuestion.remove_NoLock(fe.questionKey);
+			}
+		}
+		return sl_true;
+	}
+
 	Memory DnsServer::_buildQuestionPacket(sl_uint16 id, const String& host, sl_bool flagEncrypt)
 	{
 		Memory mem = DnsPacket::buildQuestionPacket(id, host);
@@ -1169,7 +1979,7 @@ namespace slib
 						}
 					}
 				} else {
-					_processReceivedDnsAnswer(packet);
+					_processReceivedDnsAnswer(packet, buf, size);
 				}
 			}
 		}
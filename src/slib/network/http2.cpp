@@ -0,0 +1,798 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/network/http2.h"
+
+#include "slib/core/scoped_buffer.h"
+#include "slib/core/safe_static.h"
+
+#define HPACK_STATIC_TABLE_SIZE 61
+#define HPACK_DEFAULT_TABLE_SIZE 4096
+#define HPACK_ENTRY_OVERHEAD 32
+#define HPACK_EOS 256
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace http2
+		{
+
+			// RFC 7541 Appendix B. The code is canonical: sorted by the length, then by the symbol
+			static const sl_uint32 g_huffmanCodes[257] = {
+				0x1ff8, 0x7fffd8, 0xfffffe2, 0xfffffe3, 0xfffffe4, 0xfffffe5, 0xfffffe6, 0xfffffe7,
+				0xfffffe8, 0xffffea, 0x3ffffffc, 0xfffffe9, 0xfffffea, 0x3ffffffd, 0xfffffeb, 0xfffffec,
+				0xfffffed, 0xfffffee, 0xfffffef, 0xffffff0, 0xffffff1, 0xffffff2, 0x3ffffffe, 0xffffff3,
+				0xffffff4, 0xffffff5, 0xffffff6, 0xffffff7, 0xffffff8, 0xffffff9, 0xffffffa, 0xffffffb,
+				0x14, 0x3f8, 0x3f9, 0xffa, 0x1ff9, 0x15, 0xf8, 0x7fa,
+				0x3fa, 0x3fb, 0xf9, 0x7fb, 0xfa, 0x16, 0x17, 0x18,
+				0x0, 0x1, 0x2, 0x19, 0x1a, 0x1b, 0x1c, 0x1d,
+				0x1e, 0x1f, 0x5c, 0xfb, 0x7ffc, 0x20, 0xffb, 0x3fc,
+				0x1ffa, 0x21, 0x5d, 0x5e, 0x5f, 0x60, 0x61, 0x62,
+				0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+				0x6b, 0x6c, 0x6d, 0x6e, 0x6f, 0x70, 0x71, 0x72,
+				0xfc, 0x73, 0xfd, 0x1ffb, 0x7fff0, 0x1ffc, 0x3ffc, 0x22,
+				0x7ffd, 0x3, 0x23, 0x4, 0x24, 0x5, 0x25, 0x26,
+				0x27, 0x6, 0x74, 0x75, 0x28, 0x29, 0x2a, 0x7,
+				0x2b, 0x76, 0x2c, 0x8, 0x9, 0x2d, 0x77, 0x78,
+				0x79, 0x7a, 0x7b, 0x7ffe, 0x7fc, 0x3ffd, 0x1ffd, 0xffffffc,
+				0xfffe6, 0x3fffd2, 0xfffe7, 0xfffe8, 0x3fffd3, 0x3fffd4, 0x3fffd5, 0x7fffd9,
+				0x3fffd6, 0x7fffda, 0x7fffdb, 0x7fffdc, 0x7fffdd, 0x7fffde, 0xffffeb, 0x7fffdf,
+				0xffffec, 0xffffed, 0x3fffd7, 0x7fffe0, 0xffffee, 0x7fffe1, 0x7fffe2, 0x7fffe3,
+				0x7fffe4, 0x1fffdc, 0x3fffd8, 0x7fffe5, 0x3fffd9, 0x7fffe6, 0x7fffe7, 0xffffef,
+				0x3fffda, 0x1fffdd, 0xfffe9, 0x3fffdb, 0x3fffdc, 0x7fffe8, 0x7fffe9, 0x1fffde,
+				0x7fffea, 0x3fffdd, 0x3fffde, 0xfffff0, 0x1fffdf, 0x3fffdf, 0x7fffeb, 0x7fffec,
+				0x1fffe0, 0x1fffe1, 0x3fffe0, 0x1fffe2, 0x7fffed, 0x3fffe1, 0x7fffee, 0x7fffef,
+				0xfffea, 0x3fffe2, 0x3fffe3, 0x3fffe4, 0x7ffff0, 0x3fffe5, 0x3fffe6, 0x7ffff1,
+				0x3ffffe0, 0x3ffffe1, 0xfffeb, 0x7fff1, 0x3fffe7, 0x7ffff2, 0x3fffe8, 0x1ffffec,
+				0x3ffffe2, 0x3ffffe3, 0x3ffffe4, 0x7ffffde, 0x7ffffdf, 0x3ffffe5, 0xfffff1, 0x1ffffed,
+				0x7fff2, 0x1fffe3, 0x3ffffe6, 0x7ffffe0, 0x7ffffe1, 0x3ffffe7, 0x7ffffe2, 0xfffff2,
+				0x1fffe4, 0x1fffe5, 0x3ffffe8, 0x3ffffe9, 0xffffffd, 0x7ffffe3, 0x7ffffe4, 0x7ffffe5,
+				0xfffec, 0xfffff3, 0xfffed, 0x1fffe6, 0x3fffe9, 0x1fffe7, 0x1fffe8, 0x7ffff3,
+				0x3fffea, 0x3fffeb, 0x1ffffee, 0x1ffffef, 0xfffff4, 0xfffff5, 0x3ffffea, 0x7ffff4,
+				0x3ffffeb, 0x7ffffe6, 0x3ffffec, 0x3ffffed, 0x7ffffe7, 0x7ffffe8, 0x7ffffe9, 0x7ffffea,
+				0x7ffffeb, 0xffffffe, 0x7ffffec, 0x7ffffed, 0x7ffffee, 0x7ffffef, 0x7fffff0, 0x3ffffee,
+				0x3fffffff,
+			};
+
+			static const sl_uint8 g_huffmanLengths[257] = {
+				13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28,
+				28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 28,
+				6, 10, 10, 12, 13, 6, 8, 11, 10, 10, 8, 11, 8, 6, 6, 6,
+				5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 7, 8, 15, 6, 12, 10,
+				13, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+				7, 7, 7, 7, 7, 7, 7, 7, 8, 7, 8, 13, 19, 13, 14, 6,
+				15, 5, 6, 5, 6, 5, 6, 6, 6, 5, 7, 7, 6, 6, 6, 5,
+				6, 7, 6, 5, 5, 6, 7, 7, 7, 7, 7, 15, 11, 14, 13, 28,
+				20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24, 23,
+				24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24,
+				22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22, 24, 21, 22, 23, 23,
+				21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23,
+				26, 26, 20, 19, 22, 23, 22, 25, 26, 26, 26, 27, 27, 26, 24, 25,
+				19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27,
+				20, 24, 20, 21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23,
+				26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27, 26,
+				30,
+			};
+
+			// RFC 7541 Appendix A
+			static const char* g_staticTable[HPACK_STATIC_TABLE_SIZE][2] = {
+				{ ":authority", "" },
+				{ ":method", "GET" },
+				{ ":method", "POST" },
+				{ ":path", "/" },
+				{ ":path", "/index.html" },
+				{ ":scheme", "http" },
+				{ ":scheme", "https" },
+				{ ":status", "200" },
+				{ ":status", "204" },
+				{ ":status", "206" },
+				{ ":status", "304" },
+				{ ":status", "400" },
+				{ ":status", "404" },
+				{ ":status", "500" },
+				{ "accept-charset", "" },
+				{ "accept-encoding", "gzip, deflate" },
+				{ "accept-language", "" },
+				{ "accept-ranges", "" },
+				{ "accept", "" },
+				{ "access-control-allow-origin", "" },
+				{ "age", "" },
+				{ "allow", "" },
+				{ "authorization", "" },
+				{ "cache-control", "" },
+				{ "content-disposition", "" },
+				{ "content-encoding", "" },
+				{ "content-language", "" },
+				{ "content-length", "" },
+				{ "content-location", "" },
+				{ "content-range", "" },
+				{ "content-type", "" },
+				{ "cookie", "" },
+				{ "date", "" },
+				{ "etag", "" },
+				{ "expect", "" },
+				{ "expires", "" },
+				{ "from", "" },
+				{ "host", "" },
+				{ "if-match", "" },
+				{ "if-modified-since", "" },
+				{ "if-none-match", "" },
+				{ "if-range", "" },
+				{ "if-unmodified-since", "" },
+				{ "last-modified", "" },
+				{ "link", "" },
+				{ "location", "" },
+				{ "max-forwards", "" },
+				{ "proxy-authenticate", "" },
+				{ "proxy-authorization", "" },
+				{ "range", "" },
+				{ "referer", "" },
+				{ "refresh", "" },
+				{ "retry-after", "" },
+				{ "server", "" },
+				{ "set-cookie", "" },
+				{ "strict-transport-security", "" },
+				{ "transfer-encoding", "" },
+				{ "user-agent", "" },
+				{ "vary", "" },
+				{ "via", "" },
+				{ "www-authenticate", "" },
+			};
+
+			class StaticTable
+			{
+			public:
+				HpackHeaderField fields[HPACK_STATIC_TABLE_SIZE];
+
+			public:
+				StaticTable()
+				{
+					for (sl_uint32 i = 0; i < HPACK_STATIC_TABLE_SIZE; i++) {
+						fields[i].name = String::fromStatic(g_staticTable[i][0], Base::getStringLength(g_staticTable[i][0]));
+						fields[i].value = String::fromStatic(g_staticTable[i][1], Base::getStringLength(g_staticTable[i][1]));
+					}
+				}
+
+			public:
+				// Returns 1-based index of the first entry with `name`, or 0
+				sl_uint32 findName(const StringView& name)
+				{
+					sl_size len = name.getLength();
+					const sl_char8* s = name.getData();
+					for (sl_uint32 i = 0; i < HPACK_STATIC_TABLE_SIZE; i++) {
+						const String& n = fields[i].name;
+						if (n.getLength() == len && Base::equalsMemory(n.getData(), s, len)) {
+							return i + 1;
+						}
+					}
+					return 0;
+				}
+
+			};
+
+			SLIB_SAFE_STATIC_GETTER(StaticTable, GetStaticTable)
+
+			class HuffmanDecodingTable
+			{
+			public:
+				// Symbols sorted by the code
+				sl_uint16 symbols[257];
+				// Indexed by the code length
+				sl_uint32 firstCode[31];
+				sl_uint32 firstIndex[31];
+				sl_uint32 count[31];
+				// Indexed by the leading 8 bits. High byte: length (0 for the longer codes), low byte: symbol
+				sl_uint16 fast[256];
+
+			public:
+				HuffmanDecodingTable()
+				{
+					Base::zeroMemory(firstCode, sizeof(firstCode));
+					Base::zeroMemory(firstIndex, sizeof(firstIndex));
+					Base::zeroMemory(count, sizeof(count));
+					Base::zeroMemory(fast, sizeof(fast));
+					sl_uint32 n = 0;
+					for (sl_uint32 len = 1; len <= 30; len++) {
+						firstIndex[len] = n;
+						for (sl_uint32 sym = 0; sym < 257; sym++) {
+							if (g_huffmanLengths[sym] == len) {
+								if (!(count[len])) {
+									firstCode[len] = g_huffmanCodes[sym];
+								}
+								symbols[n++] = (sl_uint16)sym;
+								count[len]++;
+							}
+						}
+					}
+					for (sl_uint32 sym = 0; sym < 256; sym++) {
+						sl_uint32 len = g_huffmanLengths[sym];
+						if (len <= 8) {
+							sl_uint32 shift = 8 - len;
+							sl_uint32 first = g_huffmanCodes[sym] << shift;
+							for (sl_uint32 k = 0; k < ((sl_uint32)1 << shift); k++) {
+								fast[first | k] = (sl_uint16)((len << 8) | sym);
+							}
+						}
+					}
+				}
+
+			};
+
+			SLIB_SAFE_STATIC_GETTER(HuffmanDecodingTable, GetHuffmanDecodingTable)
+
+			static sl_bool IsSensitiveField(const StringView& name)
+			{
+				return name == StringView::literal("authorization") || name == StringView::literal("proxy-authorization") || name == StringView::literal("cookie") || name == StringView::literal("set-cookie");
+			}
+
+			// Values which are rarely repeated would only evict the useful entries
+			static sl_bool IsIndexingField(const StringView& name)
+			{
+				return !(name == StringView::literal("content-length") || name == StringView::literal("content-range") || name == StringView::literal("etag") || name == StringView::literal("last-modified") || name == StringView::literal("location") || name == StringView::literal(":path"));
+			}
+
+		}
+	}
+
+	using namespace priv::http2;
+
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(HpackHeaderField)
+
+	HpackHeaderField::HpackHeaderField()
+	{
+	}
+
+	HpackHeaderField::HpackHeaderField(const String& _name, const String& _value): name(_name), value(_value)
+	{
+	}
+
+	sl_size HpackHeaderField::getSize() const
+	{
+		return name.getLength() + value.getLength() + HPACK_ENTRY_OVERHEAD;
+	}
+
+
+	HpackDynamicTable::HpackDynamicTable()
+	{
+		m_first = 0;
+		m_count = 0;
+		m_size = 0;
+		m_maxSize = HPACK_DEFAULT_TABLE_SIZE;
+	}
+
+	HpackDynamicTable::~HpackDynamicTable()
+	{
+	}
+
+	sl_uint32 HpackDynamicTable::getCount() const
+	{
+		return m_count;
+	}
+
+	sl_size HpackDynamicTable::getSize() const
+	{
+		return m_size;
+	}
+
+	sl_size HpackDynamicTable::getMaxSize() const
+	{
+		return m_maxSize;
+	}
+
+	void HpackDynamicTable::setMaxSize(sl_size size)
+	{
+		m_maxSize = size;
+		_evict(0);
+	}
+
+	const HpackHeaderField* HpackDynamicTable::getAt(sl_uint32 index) const
+	{
+		if (index < m_count) {
+			sl_uint32 capacity = (sl_uint32)(m_entries.getCount());
+			return m_entries.getData() + ((m_first + m_count - 1 - index) % capacity);
+		}
+		return sl_null;
+	}
+
+	void HpackDynamicTable::add(const String& name, const String& value)
+	{
+		sl_size size = name.getLength() + value.getLength() + HPACK_ENTRY_OVERHEAD;
+		if (size > m_maxSize) {
+			clear();
+			return;
+		}
+		_evict(size);
+		sl_uint32 capacity = (sl_uint32)(m_entries.getCount());
+		if (m_count >= capacity) {
+			sl_uint32 capacityNew = capacity ? capacity << 1 : 16;
+			List<HpackHeaderField> entries = List<HpackHeaderField>::create(capacityNew);
+			if (entries.isNull()) {
+				return;
+			}
+			HpackHeaderField* src = m_entries.getData();
+			HpackHeaderField* dst = entries.getData();
+			for (sl_uint32 i = 0; i < m_count; i++) {
+				dst[i] = Move(src[(m_first + i) % capacity]);
+			}
+			m_entries = Move(entries);
+			m_first = 0;
+			capacity = capacityNew;
+		}
+		HpackHeaderField& entry = m_entries.getData()[(m_first + m_count) % capacity];
+		entry.name = name;
+		entry.value = value;
+		m_count++;
+		m_size += size;
+	}
+
+	void HpackDynamicTable::clear()
+	{
+		m_entries.setNull();
+		m_first = 0;
+		m_count = 0;
+		m_size = 0;
+	}
+
+	void HpackDynamicTable::_evict(sl_size sizeRequired)
+	{
+		sl_uint32 capacity = (sl_uint32)(m_entries.getCount());
+		HpackHeaderField* entries = m_entries.getData();
+		while (m_count && m_size + sizeRequired > m_maxSize) {
+			HpackHeaderField& entry = entries[m_first];
+			m_size -= entry.getSize();
+			entry.name.setNull();
+			entry.value.setNull();
+			m_first = (m_first + 1) % capacity;
+			m_count--;
+		}
+		if (!m_count) {
+			m_first = 0;
+			m_size = 0;
+		}
+	}
+
+
+	HpackEncoder::HpackEncoder()
+	{
+		m_maxTableSizeLimit = HPACK_DEFAULT_TABLE_SIZE;
+		m_maxTableSizeUpdate = HPACK_DEFAULT_TABLE_SIZE;
+		m_flagTableSizeUpdate = sl_false;
+	}
+
+	HpackEncoder::~HpackEncoder()
+	{
+	}
+
+	void HpackEncoder::setMaxTableSize(sl_uint32 size)
+	{
+		// The table does not grow over the default size
+		if (size > HPACK_DEFAULT_TABLE_SIZE) {
+			size = HPACK_DEFAULT_TABLE_SIZE;
+		}
+		if (size == m_table.getMaxSize() && !m_flagTableSizeUpdate) {
+			return;
+		}
+		if (m_flagTableSizeUpdate) {
+			// The smallest size since the last header block is signaled first, so the peer evicts the same entries
+			if (size < m_maxTableSizeUpdate) {
+				m_maxTableSizeUpdate = size;
+			}
+		} else {
+			m_maxTableSizeUpdate = size;
+		}
+		m_flagTableSizeUpdate = sl_true;
+		m_maxTableSizeLimit = size;
+		m_table.setMaxSize(size);
+	}
+
+	sl_bool HpackEncoder::encode(MemoryOutput& output, const StringView& name, const StringView& value)
+	{
+		if (IsSensitiveField(name)) {
+			return encode(output, name, value, sl_false, sl_true);
+		} else {
+			return encode(output, name, value, IsIndexingField(name), sl_false);
+		}
+	}
+
+	sl_bool HpackEncoder::encode(MemoryOutput& output, const StringView& name, const StringView& value, sl_bool flagIndexing, sl_bool flagNeverIndexed)
+	{
+		StaticTable* table = GetStaticTable();
+		if (!table) {
+			return sl_false;
+		}
+		if (m_flagTableSizeUpdate) {
+			m_flagTableSizeUpdate = sl_false;
+			if (!(encodeInteger(output, 0x20, 5, m_maxTableSizeUpdate))) {
+				return sl_false;
+			}
+			if (m_maxTableSizeUpdate != m_maxTableSizeLimit) {
+				if (!(encodeInteger(output, 0x20, 5, m_maxTableSizeLimit))) {
+					return sl_false;
+				}
+			}
+		}
+
+		sl_size lenName = name.getLength();
+		sl_size lenValue = value.getLength();
+		sl_uint32 indexName = table->findName(name);
+		if (indexName) {
+			for (sl_uint32 i = indexName - 1; i < HPACK_STATIC_TABLE_SIZE; i++) {
+				HpackHeaderField& field = table->fields[i];
+				if (field.name.getLength() != lenName || !(Base::equalsMemory(field.name.getData(), name.getData(), lenName))) {
+					break;
+				}
+				if (field.value.getLength() == lenValue && Base::equalsMemory(field.value.getData(), value.getData(), lenValue)) {
+					return encodeInteger(output, 0x80, 7, i + 1);
+				}
+			}
+		}
+		sl_uint32 nDynamic = m_table.getCount();
+		for (sl_uint32 i = 0; i < nDynamic; i++) {
+			const HpackHeaderField* field = m_table.getAt(i);
+			if (field->name.getLength() == lenName && Base::equalsMemory(field->name.getData(), name.getData(), lenName)) {
+				if (field->value.getLength() == lenValue && Base::equalsMemory(field->value.getData(), value.getData(), lenValue)) {
+					return encodeInteger(output, 0x80, 7, HPACK_STATIC_TABLE_SIZE + 1 + i);
+				}
+				if (!indexName) {
+					indexName = HPACK_STATIC_TABLE_SIZE + 1 + i;
+				}
+			}
+		}
+
+		sl_bool bRet;
+		if (flagNeverIndexed) {
+			bRet = encodeInteger(output, 0x10, 4, indexName);
+		} else if (flagIndexing) {
+			bRet = encodeInteger(output, 0x40, 6, indexName);
+		} else {
+			bRet = encodeInteger(output, 0x00, 4, indexName);
+		}
+		if (!bRet) {
+			return sl_false;
+		}
+		if (!indexName) {
+			if (!(encodeString(output, name))) {
+				return sl_false;
+			}
+		}
+		if (!(encodeString(output, value))) {
+			return sl_false;
+		}
+		if (flagIndexing && !flagNeverIndexed) {
+			m_table.add(name, value);
+		}
+		return sl_true;
+	}
+
+	sl_bool HpackEncoder::encodeInteger(MemoryOutput& output, sl_uint8 prefix, sl_uint32 nPrefixBits, sl_uint64 value)
+	{
+		sl_uint8 buf[16];
+		sl_uint32 n = 0;
+		sl_uint32 max = (1 << nPrefixBits) - 1;
+		if (value < max) {
+			buf[n++] = (sl_uint8)(prefix | value);
+		} else {
+			buf[n++] = (sl_uint8)(prefix | max);
+			value -= max;
+			while (value >= 0x80) {
+				buf[n++] = (sl_uint8)(value | 0x80);
+				value >>= 7;
+			}
+			buf[n++] = (sl_uint8)value;
+		}
+		return output.write(buf, n) == n;
+	}
+
+	sl_bool HpackEncoder::encodeString(MemoryOutput& output, const StringView& str)
+	{
+		sl_size len = str.getLength();
+		sl_size lenHuffman = HpackHuffman::getEncodedLength(str.getData(), len);
+		if (lenHuffman < len) {
+			if (!(encodeInteger(output, 0x80, 7, lenHuffman))) {
+				return sl_false;
+			}
+			SLIB_SCOPED_BUFFER(sl_uint8, 512, buf, lenHuffman)
+			if (!buf) {
+				return sl_false;
+			}
+			HpackHuffman::encode(str.getData(), len, buf);
+			return output.write(buf, lenHuffman) == (sl_reg)lenHuffman;
+		} else {
+			if (!(encodeInteger(output, 0x00, 7, len))) {
+				return sl_false;
+			}
+			if (!len) {
+				return sl_true;
+			}
+			return output.write(str.getData(), len) == (sl_reg)len;
+		}
+	}
+
+
+	HpackDecoder::HpackDecoder()
+	{
+		m_maxTableSizeLimit = HPACK_DEFAULT_TABLE_SIZE;
+	}
+
+	HpackDecoder::~HpackDecoder()
+	{
+	}
+
+	void HpackDecoder::setMaxTableSizeLimit(sl_uint32 size)
+	{
+		m_maxTableSizeLimit = size;
+		if (m_table.getMaxSize() > size) {
+			m_table.setMaxSize(size);
+		}
+	}
+
+	sl_bool HpackDecoder::decode(const void* _data, sl_size size, List<HpackHeaderField>& fields, sl_size maxHeaderListSize)
+	{
+		StaticTable* table = GetStaticTable();
+		if (!table) {
+			return sl_false;
+		}
+		const sl_uint8* data = (const sl_uint8*)_data;
+		const sl_uint8* end = data + size;
+		sl_bool flagField = sl_false;
+		sl_size sizeList = 0;
+		while (data < end) {
+			sl_uint8 b = *data;
+			HpackHeaderField field;
+			if (b & 0x80) {
+				// Indexed Header Field
+				sl_uint32 index;
+				if (!(decodeInteger(data, end, 7, index))) {
+					return sl_false;
+				}
+				if (!index) {
+					return sl_false;
+				}
+				if (index <= HPACK_STATIC_TABLE_SIZE) {
+					field = table->fields[index - 1];
+				} else {
+					const HpackHeaderField* entry = m_table.getAt(index - HPACK_STATIC_TABLE_SIZE - 1);
+					if (!entry) {
+						return sl_false;
+					}
+					field = *entry;
+				}
+			} else if ((b & 0xe0) == 0x20) {
+				// Dynamic Table Size Update, allowed only at the beginning of a header block
+				if (flagField) {
+					return sl_false;
+				}
+				sl_uint32 sizeTable;
+				if (!(decodeInteger(data, end, 5, sizeTable))) {
+					return sl_false;
+				}
+				if (sizeTable > m_maxTableSizeLimit) {
+					return sl_false;
+				}
+				m_table.setMaxSize(sizeTable);
+				continue;
+			} else {
+				// Literal Header Field: with incremental indexing (01), without indexing (0000), never indexed (0001)
+				sl_bool flagIndexing = (b & 0xc0) == 0x40;
+				sl_uint32 index;
+				if (!(decodeInteger(data, end, flagIndexing ? 6 : 4, index))) {
+					return sl_false;
+				}
+				if (index) {
+					if (index <= HPACK_STATIC_TABLE_SIZE) {
+						field.name = table->fields[index - 1].name;
+					} else {
+						const HpackHeaderField* entry = m_table.getAt(index - HPACK_STATIC_TABLE_SIZE - 1);
+						if (!entry) {
+							return sl_false;
+						}
+						field.name = entry->name;
+					}
+				} else {
+					if (!(decodeString(data, end, field.name))) {
+						return sl_false;
+					}
+				}
+				if (!(decodeString(data, end, field.value))) {
+					return sl_false;
+				}
+				if (flagIndexing) {
+					m_table.add(field.name, field.value);
+				}
+			}
+			flagField = sl_true;
+			sizeList += field.getSize();
+			if (maxHeaderListSize && sizeList > maxHeaderListSize) {
+				return sl_false;
+			}
+			if (!(fields.add_NoLock(Move(field)))) {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
+	sl_bool HpackDecoder::decodeInteger(const sl_uint8*& data, const sl_uint8* end, sl_uint32 nPrefixBits, sl_uint32& value)
+	{
+		if (data >= end) {
+			return sl_false;
+		}
+		sl_uint32 max = (1 << nPrefixBits) - 1;
+		sl_uint32 v = *(data++) & max;
+		if (v < max) {
+			value = v;
+			return sl_true;
+		}
+		sl_uint64 n = v;
+		sl_uint32 shift = 0;
+		for (;;) {
+			if (data >= end || shift > 28) {
+				return sl_false;
+			}
+			sl_uint8 b = *(data++);
+			n += (sl_uint64)(b & 0x7f) << shift;
+			if (n > 0xffffffff) {
+				return sl_false;
+			}
+			shift += 7;
+			if (!(b & 0x80)) {
+				break;
+			}
+		}
+		value = (sl_uint32)n;
+		return sl_true;
+	}
+
+	sl_bool HpackDecoder::decodeString(const sl_uint8*& data, const sl_uint8* end, String& str)
+	{
+		if (data >= end) {
+			return sl_false;
+		}
+		sl_bool flagHuffman = (*data & 0x80) != 0;
+		sl_uint32 len;
+		if (!(decodeInteger(data, end, 7, len))) {
+			return sl_false;
+		}
+		if (len > (sl_size)(end - data)) {
+			return sl_false;
+		}
+		sl_bool bRet;
+		if (flagHuffman) {
+			bRet = HpackHuffman::decode(data, len, str);
+		} else {
+			str = String((const sl_char8*)data, len);
+			bRet = !len || str.isNotNull();
+		}
+		data += len;
+		return bRet;
+	}
+
+
+	sl_size HpackHuffman::getEncodedLength(const void* _data, sl_size size)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		sl_size nBits = 0;
+		for (sl_size i = 0; i < size; i++) {
+			nBits += g_huffmanLengths[data[i]];
+		}
+		return (nBits + 7) >> 3;
+	}
+
+	sl_size HpackHuffman::encode(const void* _data, sl_size size, void* _output)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		sl_uint8* output = (sl_uint8*)_output;
+		sl_uint8* start = output;
+		sl_uint64 bits = 0;
+		sl_uint32 nBits = 0;
+		for (sl_size i = 0; i < size; i++) {
+			sl_uint8 c = data[i];
+			sl_uint32 len = g_huffmanLengths[c];
+			bits = (bits << len) | g_huffmanCodes[c];
+			nBits += len;
+			while (nBits >= 8) {
+				nBits -= 8;
+				*(output++) = (sl_uint8)(bits >> nBits);
+			}
+		}
+		if (nBits) {
+			// Padded with the most significant bits of EOS
+			*(output++) = (sl_uint8)((bits << (8 - nBits)) | (0xff >> nBits));
+		}
+		return output - start;
+	}
+
+	sl_bool HpackHuffman::decode(const void* _data, sl_size size, String& str)
+	{
+		HuffmanDecodingTable* table = GetHuffmanDecodingTable();
+		if (!table) {
+			return sl_false;
+		}
+		const sl_uint8* data = (const sl_uint8*)_data;
+		const sl_uint8* end = data + size;
+		// Each symbol takes 5 bits at least
+		SLIB_SCOPED_BUFFER(sl_char8, 1024, output, (size << 3) / 5 + 1)
+		if (!output) {
+			return sl_false;
+		}
+		sl_char8* out = output;
+		sl_uint64 bits = 0;
+		sl_uint32 nBits = 0;
+		for (;;) {
+			while (nBits <= 56 && data < end) {
+				bits = (bits << 8) | *(data++);
+				nBits += 8;
+			}
+			if (nBits >= 8) {
+				sl_uint16 entry = table->fast[(bits >> (nBits - 8)) & 0xff];
+				sl_uint32 len = entry >> 8;
+				if (len) {
+					*(out++) = (sl_char8)(entry & 0xff);
+					nBits -= len;
+					continue;
+				}
+			} else if (nBits < 5) {
+				break;
+			}
+			sl_uint32 len = 5;
+			sl_uint32 nMax = nBits < 30 ? nBits : 30;
+			for (; len <= nMax; len++) {
+				sl_uint32 code = (sl_uint32)((bits >> (nBits - len)) & (((sl_uint32)1 << len) - 1));
+				sl_uint32 offset = code - table->firstCode[len];
+				if (offset < table->count[len]) {
+					break;
+				}
+			}
+			if (len > nMax) {
+				if (nBits >= 8) {
+					// Invalid code, or a truncated code longer than the padding
+					return sl_false;
+				}
+				break;
+			}
+			sl_uint32 code = (sl_uint32)((bits >> (nBits - len)) & (((sl_uint32)1 << len) - 1));
+			sl_uint16 symbol = table->symbols[table->firstIndex[len] + code - table->firstCode[len]];
+			if (symbol == HPACK_EOS) {
+				return sl_false;
+			}
+			*(out++) = (sl_char8)symbol;
+			nBits -= len;
+		}
+		// Padding: less than 8 bits of ones (the prefix of EOS)
+		if (nBits >= 8) {
+			return sl_false;
+		}
+		if (nBits) {
+			sl_uint32 mask = ((sl_uint32)1 << nBits) - 1;
+			if (((sl_uint32)bits & mask) != mask) {
+				return sl_false;
+			}
+		}
+		sl_size len = out - output;
+		str = String(output, len);
+		return !len || str.isNotNull();
+	}
+
+}
@@ -212,6 +212,7 @@ namespace slib
 	DEFINE_HTTP_HEADER(CacheControl, "Cache-Control")
 	DEFINE_HTTP_HEADER(ContentDisposition, "Content-Disposition")
 	DEFINE_HTTP_HEADER(Authorization, "Authorization")
+	DEFINE_HTTP_HEADER(Upgrade, "Upgrade")
 
 	DEFINE_HTTP_HEADER(ContentLength, "Content-Length")
 	DEFINE_HTTP_HEADER(ContentType, "Content-Type")
@@ -224,6 +225,8 @@ namespace slib
 	DEFINE_HTTP_HEADER(Range, "Range")
 	DEFINE_HTTP_HEADER(IfModifiedSince, "If-Modified-Since")
 	DEFINE_HTTP_HEADER(Depth, "Depth")
+	DEFINE_HTTP_HEADER(SecWebSocketKey, "Sec-WebSocket-Key")
+	DEFINE_HTTP_HEADER(SecWebSocketVersion, "Sec-WebSocket-Version")
 
 	DEFINE_HTTP_HEADER(TransferEncoding, "Transfer-Encoding")
 	DEFINE_HTTP_HEADER(AccessControlAllowOrigin, "Access-Control-Allow-Origin")
@@ -237,8 +240,12 @@ namespace slib
 	DEFINE_HTTP_HEADER(ContentRange, "Content-Range")
 	DEFINE_HTTP_HEADER(LastModified, "Last-Modified")
 	DEFINE_HTTP_HEADER(Location, "Location")
+	DEFINE_HTTP_HEADER(SecWebSocketAccept, "Sec-WebSocket-Accept")
 	DEFINE_HTTP_HEADER(DAV, "DAV")
 
+	DEFINE_HTTP_HEADER(SecWebSocketProtocol, "Sec-WebSocket-Protocol")
+	DEFINE_HTTP_HEADER(SecWebSocketExtensions, "Sec-WebSocket-Extensions")
+
 	sl_reg HttpHeaderHelper::parseHeaders(HttpHeaderMap& map, const void* _data, sl_size size)
 	{
 		const sl_char8* data = (const sl_char8*)_data;
@@ -62,7 +62,11 @@ namespace slib
 				{
 					Ref<OpenSSL_Context> context = Ref<OpenSSL_Context>::from(tlsParam.context);
 					if (!(IsInstanceOf<OpenSSL_Context>(context))) {
-						context = OpenSSL::createContext(tlsParam);
+						TlsContextParam contextParam = tlsParam;
+						if (server->getParam().flagSupportHttp2 && contextParam.applicationProtocols.isEmpty()) {
+							contextParam.applicationProtocols = List<String>::createFromElements("h2", "http/1.1");
+						}
+						context = OpenSSL::createContext(contextParam);
 						if (context.isNull()) {
 							return sl_null;
 						}
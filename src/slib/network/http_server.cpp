@@ -22,10 +22,13 @@
 
 #include "slib/network/http_server.h"
 
+#include "http_server_http2.h"
+
 #include "slib/network/url.h"
 #include "slib/core/app.h"
 #include "slib/core/asset.h"
 #include "slib/core/async_file.h"
+#include "slib/core/memory_pool.h"
 #include "slib/core/file_util.h"
 #include "slib/core/thread_pool.h"
 #include "slib/core/dispatch_loop.h"
@@ -54,6 +57,8 @@ namespace slib
 		m_flagKeepAlive = sl_true;
 		
 		m_flagBeganProcessing = sl_false;
+
+		m_http2StreamId = 0;
 	}
 
 	HttpServerContext::~HttpServerContext()
@@ -198,6 +203,11 @@ namespace slib
 		m_flagKeepAlive = flag;
 	}
 
+	sl_uint32 HttpServerContext::getHttp2StreamId() const
+	{
+		return m_http2StreamId;
+	}
+
 
 #define SIZE_READ_BUF 0x10000
 #define SIZE_COPY_BUF 0x10000
@@ -211,6 +221,7 @@ namespace slib
 		m_flagReading = sl_false;
 		m_flagKeepAlive = sl_true;
 		m_timeLastRead = System::getTickCount64();
+		m_flagFirstRequest = sl_true;
 	}
 
 	HttpServerConnection::~HttpServerConnection()
@@ -221,8 +232,12 @@ namespace slib
 	Ref<HttpServerConnection> HttpServerConnection::create(HttpServer* server, AsyncStream* io)
 	{
 		if (server && io) {
-			Memory bufRead = Memory::create(SIZE_READ_BUF);
-			if (bufRead.isNotNull()) {
+			Ref<MemoryPool> poolRead = server->getReadBufferPool();
+			Memory bufRead;
+			if (poolRead.isNull()) {
+				bufRead = Memory::create(SIZE_READ_BUF);
+			}
+			if (poolRead.isNotNull() || bufRead.isNotNull()) {
 				Ref<HttpServerConnection> ret = new HttpServerConnection;
 				if (ret.isNotNull()) {
 					AsyncOutputParam op;
@@ -234,7 +249,9 @@ namespace slib
 						ret->m_server = server;
 						ret->m_io = io;
 						ret->m_output = output;
-						ret->m_bufRead = bufRead;
+						ret->m_bufRead = Move(bufRead);
+						ret->m_poolRead = Move(poolRead);
+						ret->m_callbackRead = SLIB_FUNCTION_WEAKREF(ret, onReadStream);
 						ret->m_flagFreed = sl_false;
 						return ret;
 					}
@@ -259,6 +276,13 @@ namespace slib
 			server->closeConnection(this);
 		}
 		m_bufReadUnprocessed.setNull();
+		if (m_poolRead.isNotNull()) {
+			m_bufRead.setNull();
+		}
+		Ref<Http2ServerSession> http2 = m_http2;
+		if (http2.isNotNull()) {
+			http2->close();
+		}
 		_free();
 	}
 
@@ -278,7 +302,7 @@ namespace slib
 		if (m_bufReadUnprocessed.isNotEmpty()) {
 			_processInput(sl_null);
 		} else {
-			_read(sl_null);
+			_read();
 		}
 	}
 
@@ -297,7 +321,7 @@ namespace slib
 		return m_contextCurrent;
 	}
 
-	void HttpServerConnection::_read(AsyncStreamResult* result)
+	void HttpServerConnection::_read()
 	{
 		ObjectLocker lock(this);
 		if (m_flagClosed) {
@@ -308,10 +332,11 @@ namespace slib
 		}
 		m_flagReading = sl_true;
 		sl_bool bSuccess;
-		if (result) {
-			bSuccess = m_io->read(result->data, result->requestSize, result->callback, result->userObject);
+		if (m_bufRead.isNotNull()) {
+			bSuccess = m_io->read(m_bufRead, m_callbackRead);
 		} else {
-			bSuccess = m_io->read(m_bufRead, SLIB_FUNCTION_WEAKREF(this, onReadStream));
+			// Borrows the buffer from the pool when the data arrives
+			bSuccess = m_io->waitRead(m_callbackRead);
 		}
 		if (!bSuccess) {
 			m_flagReading = sl_false;
@@ -340,6 +365,10 @@ namespace slib
 		if (result) {
 			data = (char*)(result->data);
 			size = result->size;
+			if (size < result->requestSize && m_poolRead.isNotNull()) {
+				// No more data is pending. The request keeps the buffer until `data` is processed
+				m_bufRead.setNull();
+			}
 		} else {
 			data = sl_null;
 			size = 0;
@@ -357,11 +386,41 @@ namespace slib
 		}
 		
 		if (!size) {
-			_read(result);
+			_read();
 			return;
 		}
 		
 		const HttpServerParam& param = server->getParam();
+
+		Ref<Http2ServerSession> http2 = m_http2;
+		if (http2.isNull() && param.flagSupportHttp2 && m_flagFirstRequest && m_contextCurrent.isNull()) {
+			// HTTP/2 with prior knowledge (or negotiated by ALPN) starts with the connection preface
+			sl_size n = size < SLIB_HTTP2_CONNECTION_PREFACE_SIZE ? size : SLIB_HTTP2_CONNECTION_PREFACE_SIZE;
+			if (Base::equalsMemory(data, SLIB_HTTP2_CONNECTION_PREFACE, n)) {
+				if (n < SLIB_HTTP2_CONNECTION_PREFACE_SIZE) {
+					if (m_bufReadUnprocessed.isEmpty()) {
+						m_bufReadUnprocessed = List<char>::create(data, size);
+					}
+					_read();
+					return;
+				}
+				http2 = Http2ServerSession::create(this);
+				if (http2.isNull()) {
+					close();
+					return;
+				}
+				m_http2 = http2;
+			}
+		}
+		if (http2.isNotNull()) {
+			sl_bool flagContinue = http2->processInput(data, size);
+			m_bufReadUnprocessed.setNull();
+			if (flagContinue) {
+				_read();
+			}
+			return;
+		}
+		
 		sl_uint64 maxRequestHeadersSize = param.maxRequestHeadersSize;
 		sl_uint64 maxRequestBodySize = param.maxRequestBodySize;
 
@@ -466,40 +525,13 @@ namespace slib
 				sl_size sizeCurrent = context->m_requestBodyBuffer.getSize();
 
 				if (sizeCurrent >= sizeBody) {
-					
-					context->m_flagBeganProcessing = sl_true;
-
-					if (sizeBody) {
-						if (Memory(context->m_requestBody).getSize() < sizeBody) {
-							context->m_requestBody = context->m_requestBodyBuffer.merge();
-							if (context->m_requestBody.isNull()) {
-								sendResponseAndClose_ServerError();
-								return;
-							}
-						}
-					}
-					context->m_requestBodyBuffer.clear();
-
-					String multipartBoundary = context->getRequestMultipartFormDataBoundary();
-					if (multipartBoundary.isNotEmpty()) {
-						Memory body = context->getRequestBody();
-						context->applyMultipartFormData(multipartBoundary, body);
-					} else if (context->getMethod() == HttpMethod::POST) {
-						String reqContentType = context->getRequestContentTypeNoParams();
-						if (reqContentType == ContentType::WebForm) {
-							Memory body = context->getRequestBody();
-							context->applyFormUrlEncoded(body.getData(), body.getSize());
+					if (param.flagSupportHttp2 && m_flagFirstRequest) {
+						if (_upgradeHttp2(_context)) {
+							return;
 						}
 					}
-					if (context->isProcessingByThread()) {
-						Ref<ThreadPool> threadPool = server->getThreadPool();
-						if (threadPool.isNotNull()) {
-							threadPool->addTask(SLIB_BIND_WEAKREF(void(), this, _processContext, _context));
-						} else {
-							sendResponseAndClose_ServerError();
-						}
-					} else {
-						_processContext(context);
+					if (!(_beginProcessing(_context))) {
+						sendResponseAndClose_ServerError();
 					}
 					return;
 				}
@@ -510,7 +542,51 @@ namespace slib
 		if (server->isReleased()) {
 			return;
 		}
-		_read(result);
+		_read();
+	}
+
+	sl_bool HttpServerConnection::_beginProcessing(const Ref<HttpServerContext>& _context)
+	{
+		Ref<HttpServer> server = m_server;
+		if (server.isNull()) {
+			return sl_false;
+		}
+		HttpServerContext* context = _context.get();
+		context->m_flagBeganProcessing = sl_true;
+
+		sl_size sizeBody = (sl_size)(context->m_requestContentLength);
+		if (sizeBody) {
+			if (Memory(context->m_requestBody).getSize() < sizeBody) {
+				context->m_requestBody = context->m_requestBodyBuffer.merge();
+				if (context->m_requestBody.isNull()) {
+					return sl_false;
+				}
+			}
+		}
+		context->m_requestBodyBuffer.clear();
+
+		String multipartBoundary = context->getRequestMultipartFormDataBoundary();
+		if (multipartBoundary.isNotEmpty()) {
+			Memory body = context->getRequestBody();
+			context->applyMultipartFormData(multipartBoundary, body);
+		} else if (context->getMethod() == HttpMethod::POST) {
+			String reqContentType = context->getRequestContentTypeNoParams();
+			if (reqContentType == ContentType::WebForm) {
+				Memory body = context->getRequestBody();
+				context->applyFormUrlEncoded(body.getData(), body.getSize());
+			}
+		}
+		if (context->isProcessingByThread()) {
+			Ref<ThreadPool> threadPool = server->getThreadPool();
+			if (threadPool.isNotNull()) {
+				return threadPool->addTask(SLIB_BIND_WEAKREF(void(), this, _processContext, _context));
+			} else {
+				return sl_false;
+			}
+		} else {
+			_processContext(_context);
+		}
+		return sl_true;
 	}
 
 	void HttpServerConnection::_processContext(const Ref<HttpServerContext>& context)
@@ -520,14 +596,59 @@ namespace slib
 			return;
 		}
 		if (context->getMethod() == HttpMethod::CONNECT) {
-			sendConnectResponse_Failed();
+			if (context->m_http2StreamId) {
+				context->setResponseCode(HttpStatus::NotImplemented);
+				context->setProcessed();
+				completeContext(context.get());
+			} else {
+				sendConnectResponse_Failed();
+			}
 			return;
 		}
 		server->processRequest(context.get(), this);
 	}
 
+	sl_bool HttpServerConnection::_upgradeHttp2(const Ref<HttpServerContext>& context)
+	{
+		Memory settings;
+		if (!(Http2ServerSession::isUpgradeRequest(context.get(), settings))) {
+			return sl_false;
+		}
+		Ref<Http2ServerSession> http2 = Http2ServerSession::create(this);
+		if (http2.isNull()) {
+			return sl_false;
+		}
+		if (!(http2->startUpgrade(context.get(), settings))) {
+			return sl_false;
+		}
+		m_http2 = http2;
+		m_contextCurrent.setNull();
+		if (!(_beginProcessing(context))) {
+			http2->resetStream(context.get(), Http2ErrorCode::InternalError);
+		}
+		// The remaining bytes begin with the connection preface
+		if (m_bufReadUnprocessed.isNotEmpty()) {
+			_processInput(sl_null);
+		} else {
+			_read();
+		}
+		return sl_true;
+	}
+
 	void HttpServerConnection::completeContext(HttpServerContext* context)
 	{
+		if (m_flagClosed) {
+			// Closed or detached while processing the request
+			return;
+		}
+		if (context->m_http2StreamId) {
+			Ref<Http2ServerSession> http2 = m_http2;
+			if (http2.isNotNull()) {
+				http2->completeContext(context);
+			}
+			return;
+		}
+		m_flagFirstRequest = sl_false;
 		Memory header = context->makeResponsePacket();
 		if (header.isNull()) {
 			close();
@@ -555,7 +676,23 @@ namespace slib
 			close();
 		} else {
 			m_timeLastRead = System::getTickCount64();
-			_processInput(&result);
+			if (result.requestSize) {
+				_processInput(&result);
+			} else {
+				// Completion of `waitRead()`
+				ObjectLocker lock(this);
+				if (m_flagClosed) {
+					return;
+				}
+				if (m_bufRead.isNull()) {
+					m_bufRead = m_poolRead->allocate();
+					if (m_bufRead.isNull()) {
+						close();
+						return;
+					}
+				}
+				_read();
+			}
 		}
 	}
 
@@ -644,6 +781,28 @@ namespace slib
 		sendResponseAndClose(Memory::createStatic(s, sizeof(s) - 1));
 	}
 
+	Ref<AsyncStream> HttpServerConnection::detachIO(Memory& dataUnprocessed)
+	{
+		ObjectLocker lock(this);
+		if (m_flagClosed || m_flagReading) {
+			return sl_null;
+		}
+		m_flagClosed = sl_true;
+		// The stream is not closed by this connection any more
+		m_flagFreed = sl_true;
+		Ref<HttpServer> server = m_server;
+		if (server.isNotNull()) {
+			server->closeConnection(this);
+		}
+		if (m_bufReadUnprocessed.isNotEmpty()) {
+			dataUnprocessed = Memory::create(m_bufReadUnprocessed.getData(), m_bufReadUnprocessed.getCount());
+		}
+		m_bufReadUnprocessed.setNull();
+		m_bufRead.setNull();
+		m_output->close();
+		return m_io;
+	}
+
 
 	SLIB_DEFINE_OBJECT(HttpServerConnectionProvider, Object)
 
@@ -1177,7 +1336,14 @@ namespace slib
 
 		flagSupportWebDAV = sl_false;
 
+		flagSupportHttp2 = sl_false;
+		http2MaxConcurrentStreams = 100;
+		http2MaxResetRate = 200;
+		http2InitialWindowSize = 0x100000; // 1MB
+
 		connectionExpiringDuration = 43200000; // 12 hours
+
+		readBufferPoolSize = 64;
 		
 		flagLogDebug = sl_false;
 		
@@ -1222,6 +1388,18 @@ namespace slib
 				maxRequestBodySize = n * 1024 * 1024;
 			}
 		}
+
+		Json http2 = conf["http2"];
+		if (http2.isNotNull()) {
+			if (http2.isBoolean()) {
+				flagSupportHttp2 = http2.getBoolean(flagSupportHttp2);
+			} else {
+				flagSupportHttp2 = http2["enabled"].getBoolean(sl_true);
+				http2MaxConcurrentStreams = http2["max_concurrent_streams"].getUint32(http2MaxConcurrentStreams);
+				http2MaxResetRate = http2["max_reset_rate"].getUint32(http2MaxResetRate);
+				http2InitialWindowSize = http2["initial_window_size"].getUint32(http2InitialWindowSize);
+			}
+		}
 	}
 	
 	sl_bool HttpServerParam::parseJsonFile(const String& filePath)
@@ -1278,6 +1456,9 @@ namespace slib
 			return sl_false;
 		}
 		m_ioLoop = Move(ioLoop);
+		if (param.readBufferPoolSize) {
+			m_poolReadBuffer = MemoryPool::create(SIZE_READ_BUF, param.readBufferPoolSize);
+		}
 		if (param.port) {
 			if (!(addHttpBinding(param.bindAddress, param.port))) {
 				return sl_false;
@@ -1311,6 +1492,10 @@ namespace slib
 		if (connection->m_output->isWriting()) {
 			return sl_false;
 		}
+		Ref<Http2ServerSession> http2 = connection->m_http2;
+		if (http2.isNotNull() && http2->isActive()) {
+			return sl_false;
+		}
 		sl_uint64 tick = connection->m_timeLastRead;
 		return !(now >= tick && now - tick < m_param.connectionExpiringDuration);
 	}
@@ -1389,6 +1574,7 @@ namespace slib
 		}
 
 		m_connections.removeAll();
+		m_webSockets.removeAll();
 
 		{
 			ListLocker< Ref<HttpServerConnectionProvider> > cp(m_connectionProviders);
@@ -1425,6 +1611,18 @@ namespace slib
 		return m_param;
 	}
 
+	Ref<MemoryPool> HttpServer::getReadBufferPool()
+	{
+		return m_poolReadBuffer;
+	}
+
+	void HttpServer::getReadBufferPoolStatus(MemoryPoolStatus& status)
+	{
+		if (m_poolReadBuffer.isNotNull()) {
+			m_poolReadBuffer->getStatus(status);
+		}
+	}
+
 	sl_bool HttpServer::preprocessRequest(HttpServerContext* context)
 	{
 		return sl_false;
@@ -1919,6 +2117,33 @@ namespace slib
 		m_connectionProviders.remove(provider);
 	}
 
+	List< Ref<WebSocket> > HttpServer::getWebSockets()
+	{
+		return m_webSockets.getAllValues();
+	}
+
+	sl_size HttpServer::getWebSocketCount()
+	{
+		return m_webSockets.getCount();
+	}
+
+	void HttpServer::addWebSocket(const Ref<WebSocket>& socket)
+	{
+		if (socket.isNotNull()) {
+			m_webSockets.put(socket.get(), socket);
+		}
+	}
+
+	void HttpServer::removeWebSocket(WebSocket* socket)
+	{
+		m_webSockets.remove(socket);
+	}
+
+	sl_size HttpServer::broadcastWebSocket(WebSocketOpcode opcode, const void* data, sl_size size)
+	{
+		return WebSocket::broadcast(m_webSockets.getAllValues(), opcode, data, size);
+	}
+
 	sl_bool HttpServer::addHttpBinding(const SocketAddress& addr)
 	{
 		Ref<HttpServerConnectionProvider> provider = priv::http_server::DefaultConnectionProvider::create(this, addr);
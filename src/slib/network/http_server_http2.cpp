@@ -0,0 +1,1611 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "http_server_http2.h"
+
+#include "slib/core/mio.h"
+#include "slib/core/scoped_buffer.h"
+#include "slib/core/string_buffer.h"
+#include "slib/core/system.h"
+#include "slib/crypto/base64.h"
+
+#define HTTP2_MAX_FRAME_SIZE 16384
+#define HTTP2_SEND_LIMIT 0x20000
+#define HTTP2_BATCH_SIZE 0x10000
+#define HTTP2_MAX_WRITE_VECTOR 64
+#define HTTP2_READ_BODY_SIZE 0x10000
+#define HTTP2_DEFAULT_URGENCY 3
+
+#define OUTPUT_READY 0
+#define OUTPUT_WAITING 1
+#define OUTPUT_END 2
+#define OUTPUT_ERROR 3
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace http_server_http2
+		{
+
+			static void WriteFrameHeader(void* buf, Http2FrameType type, sl_uint8 flags, sl_uint32 streamId, sl_uint32 size)
+			{
+				Http2FrameHeader* header = (Http2FrameHeader*)buf;
+				header->setLength(size);
+				header->setType(type);
+				header->setFlags(flags);
+				header->setStreamId(streamId);
+			}
+
+			static sl_bool EqualsName(const String& name, const StringView& other)
+			{
+				return name.getLength() == other.getLength() && Base::equalsMemory(name.getData(), other.getData(), other.getLength());
+			}
+
+			// Lowercase, and no separators which are not allowed in HTTP/2
+			static sl_bool IsValidFieldName(const String& name)
+			{
+				sl_size len = name.getLength();
+				if (!len) {
+					return sl_false;
+				}
+				const sl_uint8* s = (const sl_uint8*)(name.getData());
+				for (sl_size i = 0; i < len; i++) {
+					sl_uint8 c = s[i];
+					if (c <= 0x20 || c >= 0x7f || (c >= 'A' && c <= 'Z') || c == ':') {
+						return sl_false;
+					}
+				}
+				return sl_true;
+			}
+
+			static sl_bool IsValidFieldValue(const String& value)
+			{
+				sl_size len = value.getLength();
+				if (!len) {
+					return sl_true;
+				}
+				const sl_uint8* s = (const sl_uint8*)(value.getData());
+				if (s[0] == ' ' || s[0] == '\t' || s[len - 1] == ' ' || s[len - 1] == '\t') {
+					return sl_false;
+				}
+				for (sl_size i = 0; i < len; i++) {
+					sl_uint8 c = s[i];
+					if (!c || c == '\r' || c == '\n') {
+						return sl_false;
+					}
+				}
+				return sl_true;
+			}
+
+			static sl_bool IsConnectionSpecificField(const String& name)
+			{
+				return EqualsName(name, StringView::literal("connection")) || EqualsName(name, StringView::literal("keep-alive")) || EqualsName(name, StringView::literal("proxy-connection")) || EqualsName(name, StringView::literal("transfer-encoding")) || EqualsName(name, StringView::literal("upgrade"));
+			}
+
+			// Structured field dictionary of RFC 9218: "u=<0-7>, i"
+			static void ParsePriority(const StringView& value, sl_uint32& urgency, sl_bool& flagIncremental)
+			{
+				const sl_char8* s = value.getData();
+				sl_size len = value.getLength();
+				sl_size pos = 0;
+				while (pos < len) {
+					while (pos < len && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == ',')) {
+						pos++;
+					}
+					sl_size start = pos;
+					while (pos < len && s[pos] != ',') {
+						pos++;
+					}
+					StringView member(s + start, pos - start);
+					sl_reg index = member.indexOf(';');
+					if (index >= 0) {
+						member = member.substring(0, index);
+					}
+					member = member.trim();
+					if (member.isEmpty()) {
+						continue;
+					}
+					const sl_char8* m = member.getData();
+					sl_size n = member.getLength();
+					if (m[0] == 'u') {
+						if (n == 3 && m[1] == '=' && m[2] >= '0' && m[2] <= '7') {
+							urgency = m[2] - '0';
+						}
+					} else if (m[0] == 'i') {
+						if (n == 1 || (n == 4 && m[1] == '=' && m[2] == '?' && m[3] == '1')) {
+							flagIncremental = sl_true;
+						} else if (n == 4 && m[1] == '=' && m[2] == '?' && m[3] == '0') {
+							flagIncremental = sl_false;
+						}
+					}
+				}
+			}
+
+			class WriteBatch : public Referable
+			{
+			public:
+				List<MemoryData> pieces;
+				Memory frameHeaders;
+				sl_size size;
+
+			};
+
+		}
+	}
+
+	using namespace priv::http_server_http2;
+
+
+	Http2ServerStream::Http2ServerStream(sl_uint32 _id): id(_id)
+	{
+		flagClosed = sl_false;
+
+		flagEndStreamReceived = sl_false;
+		flagDispatched = sl_false;
+		flagProcessing = sl_false;
+		flagDiscardBody = sl_false;
+		contentLength = -1;
+		sizeBody = 0;
+		windowReceive = 0;
+		sizeReceivedUnacked = 0;
+
+		urgency = HTTP2_DEFAULT_URGENCY;
+		flagIncremental = sl_false;
+
+		flagResponding = sl_false;
+		flagHeadersSent = sl_false;
+		flagEndStreamSent = sl_false;
+		flagNoBody = sl_false;
+		flagBodyError = sl_false;
+		windowSend = 0;
+		sizeBodyOutput = 0;
+		flagReadingBody = sl_false;
+	}
+
+	Http2ServerStream::~Http2ServerStream()
+	{
+	}
+
+
+	Http2ServerSession::Http2ServerSession()
+	{
+		m_maxConcurrentStreams = 100;
+		m_maxResetRate = 200;
+		m_initialWindowSize = Http2FrameHeader::DefaultWindowSize;
+		m_maxRequestHeadersSize = 0x10000;
+		m_maxRequestBodySize = 0;
+		m_flagProcessByThreads = sl_true;
+
+		m_flagClosed = sl_false;
+		m_flagPrefaceSent = sl_false;
+		m_flagPrefaceReceived = sl_false;
+		m_flagSettingsReceived = sl_false;
+		m_flagGoingAway = sl_false;
+		m_flagWriteError = sl_false;
+		m_flagCloseRequested = sl_false;
+
+		m_streamIdHeaders = 0;
+		m_flagHeadersEndStream = sl_false;
+		m_errorHeaders = Http2ErrorCode::NoError;
+		m_lastStreamId = 0;
+
+		m_nClosedProcessingStreams = 0;
+		m_timeResetCounting = 0;
+		m_nResetsCounted = 0;
+		m_lastIncrementalStreamId = 0;
+
+		m_windowSend = Http2FrameHeader::DefaultWindowSize;
+		m_windowReceive = Http2FrameHeader::DefaultWindowSize;
+		m_sizeReceivedUnacked = 0;
+		m_peerInitialWindowSize = Http2FrameHeader::DefaultWindowSize;
+		m_peerMaxFrameSize = Http2FrameHeader::DefaultMaxFrameSize;
+
+		m_sizeWriting = 0;
+		m_flagSending = sl_false;
+		m_flagFlushing = sl_false;
+	}
+
+	Http2ServerSession::~Http2ServerSession()
+	{
+	}
+
+	Ref<Http2ServerSession> Http2ServerSession::create(HttpServerConnection* connection)
+	{
+		Ref<HttpServer> server = connection->getServer();
+		if (server.isNull()) {
+			return sl_null;
+		}
+		Ref<AsyncStream> io = connection->getIO();
+		if (io.isNull()) {
+			return sl_null;
+		}
+		Ref<Http2ServerSession> ret = new Http2ServerSession;
+		if (ret.isNotNull()) {
+			const HttpServerParam& param = server->getParam();
+			ret->m_connection = connection;
+			ret->m_io = Move(io);
+			ret->m_maxConcurrentStreams = param.http2MaxConcurrentStreams;
+			ret->m_maxResetRate = param.http2MaxResetRate;
+			if (param.http2InitialWindowSize && param.http2InitialWindowSize <= Http2FrameHeader::MaxWindowSize) {
+				ret->m_initialWindowSize = param.http2InitialWindowSize;
+			}
+			ret->m_maxRequestHeadersSize = param.maxRequestHeadersSize;
+			ret->m_maxRequestBodySize = param.maxRequestBodySize;
+			ret->m_flagProcessByThreads = param.flagProcessByThreads;
+			return ret;
+		}
+		return sl_null;
+	}
+
+	sl_bool Http2ServerSession::isUpgradeRequest(HttpServerContext* context, Memory& settings)
+	{
+		if (context->getRequestVersion() != StringView::literal("HTTP/1.1")) {
+			return sl_false;
+		}
+		if (!(context->getRequestHeader(HttpHeader::Upgrade).toLower().contains(StringView::literal("h2c")))) {
+			return sl_false;
+		}
+		if (!(context->getRequestHeader(HttpHeader::Connection).toLower().contains(StringView::literal("upgrade")))) {
+			return sl_false;
+		}
+		SLIB_STATIC_STRING(nameSettings, "HTTP2-Settings")
+		String value;
+		if (!(context->getRequestHeaders().get(nameSettings, &value))) {
+			return sl_false;
+		}
+		value = value.trim();
+		if (value.isNotEmpty()) {
+			settings = Base64::decode(value);
+			if (settings.isNull()) {
+				return sl_false;
+			}
+		}
+		return !(settings.getSize() % 6);
+	}
+
+	sl_bool Http2ServerSession::startUpgrade(HttpServerContext* context, const Memory& settings)
+	{
+		ObjectLocker lock(this);
+		if (!(_applySettings((const sl_uint8*)(settings.getData()), (sl_uint32)(settings.getSize())))) {
+			return sl_false;
+		}
+		Ref<Http2ServerStream> stream = new Http2ServerStream(1);
+		if (stream.isNull()) {
+			return sl_false;
+		}
+		if (!(m_streams.put_NoLock(1, stream))) {
+			return sl_false;
+		}
+		static const char s[] = "HTTP/1.1 101 Switching Protocols\r\nConnection: Upgrade\r\nUpgrade: h2c\r\n\r\n";
+		m_control.write(s, sizeof(s) - 1);
+		_sendPreface();
+		// Half-closed (remote): the request was received by HTTP/1.1
+		context->m_http2StreamId = 1;
+		stream->context = context;
+		stream->flagEndStreamReceived = sl_true;
+		stream->flagDispatched = sl_true;
+		stream->flagProcessing = sl_true;
+		stream->windowSend = m_peerInitialWindowSize;
+		SLIB_STATIC_STRING(namePriority, "priority")
+		String priority;
+		if (context->getRequestHeaders().get(namePriority, &priority)) {
+			ParsePriority(priority, stream->urgency, stream->flagIncremental);
+		}
+		m_lastStreamId = 1;
+		_send();
+		lock.unlock();
+		_flush();
+		return sl_true;
+	}
+
+	void Http2ServerSession::_sendPreface()
+	{
+		if (m_flagPrefaceSent) {
+			return;
+		}
+		m_flagPrefaceSent = sl_true;
+		sl_uint8 settings[24];
+		sl_uint32 n = 0;
+		MIO::writeUint16BE(settings, (sl_uint16)(Http2SettingId::MaxConcurrentStreams));
+		MIO::writeUint32BE(settings + 2, m_maxConcurrentStreams);
+		n += 6;
+		MIO::writeUint16BE(settings + n, (sl_uint16)(Http2SettingId::InitialWindowSize));
+		MIO::writeUint32BE(settings + n + 2, m_initialWindowSize);
+		n += 6;
+		MIO::writeUint16BE(settings + n, (sl_uint16)(Http2SettingId::EnablePush));
+		MIO::writeUint32BE(settings + n + 2, 0);
+		n += 6;
+		if (m_maxRequestHeadersSize < 0xffffffff) {
+			MIO::writeUint16BE(settings + n, (sl_uint16)(Http2SettingId::MaxHeaderListSize));
+			MIO::writeUint32BE(settings + n + 2, (sl_uint32)m_maxRequestHeadersSize);
+			n += 6;
+		}
+		_writeFrame(Http2FrameType::Settings, 0, 0, settings, n);
+		// SETTINGS_INITIAL_WINDOW_SIZE does not change the window of the connection
+		if (m_initialWindowSize > Http2FrameHeader::DefaultWindowSize) {
+			_writeWindowUpdate(0, m_initialWindowSize - Http2FrameHeader::DefaultWindowSize);
+			m_windowReceive = m_initialWindowSize;
+		}
+	}
+
+	sl_bool Http2ServerSession::processInput(const void* _data, sl_size size)
+	{
+		List< Ref<HttpServerContext> > contexts;
+		sl_bool flagContinue;
+		{
+			ObjectLocker lock(this);
+			if (m_flagClosed || m_flagGoingAway) {
+				return sl_false;
+			}
+			_sendPreface();
+			const sl_uint8* data = (const sl_uint8*)_data;
+			if (m_bufInput.isNotEmpty()) {
+				if (!(m_bufInput.addElements_NoLock(data, size))) {
+					return sl_false;
+				}
+				data = m_bufInput.getData();
+				size = m_bufInput.getCount();
+			}
+			sl_size pos = _processFrames(data, size, contexts);
+			if (pos < size) {
+				if (pos || m_bufInput.isEmpty()) {
+					m_bufInput = List<sl_uint8>::create(data + pos, size - pos);
+				}
+			} else {
+				m_bufInput.setNull();
+			}
+			_send();
+			flagContinue = !m_flagGoingAway && !m_flagCloseRequested;
+		}
+		_flush();
+		if (contexts.isNotEmpty()) {
+			Ref<HttpServerConnection> connection = m_connection;
+			if (connection.isNotNull()) {
+				for (auto& context : contexts) {
+					if (!(connection->_beginProcessing(context))) {
+						resetStream(context.get(), Http2ErrorCode::InternalError);
+					}
+				}
+			}
+		}
+		_closeConnectionIfRequested();
+		return flagContinue;
+	}
+
+	sl_size Http2ServerSession::_processFrames(const sl_uint8* data, sl_size size, List< Ref<HttpServerContext> >& contexts)
+	{
+		sl_size pos = 0;
+		if (!m_flagPrefaceReceived) {
+			if (size < SLIB_HTTP2_CONNECTION_PREFACE_SIZE) {
+				if (!(Base::equalsMemory(data, SLIB_HTTP2_CONNECTION_PREFACE, size))) {
+					_goAway(Http2ErrorCode::ProtocolError);
+					return size;
+				}
+				return 0;
+			}
+			if (!(Base::equalsMemory(data, SLIB_HTTP2_CONNECTION_PREFACE, SLIB_HTTP2_CONNECTION_PREFACE_SIZE))) {
+				_goAway(Http2ErrorCode::ProtocolError);
+				return size;
+			}
+			m_flagPrefaceReceived = sl_true;
+			pos = SLIB_HTTP2_CONNECTION_PREFACE_SIZE;
+		}
+		while (!m_flagGoingAway && size - pos >= Http2FrameHeader::HeaderSize) {
+			const Http2FrameHeader& header = *((const Http2FrameHeader*)(data + pos));
+			sl_uint32 len = header.getLength();
+			if (len > HTTP2_MAX_FRAME_SIZE) {
+				_goAway(Http2ErrorCode::FrameSizeError);
+				break;
+			}
+			if (size - pos - Http2FrameHeader::HeaderSize < len) {
+				break;
+			}
+			_processFrame(header, data + pos + Http2FrameHeader::HeaderSize, len, contexts);
+			pos += Http2FrameHeader::HeaderSize + len;
+		}
+		if (m_flagGoingAway) {
+			return size;
+		}
+		return pos;
+	}
+
+	void Http2ServerSession::_processFrame(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size, List< Ref<HttpServerContext> >& contexts)
+	{
+		Http2FrameType type = header.getType();
+		if (!m_flagSettingsReceived) {
+			// The client preface ends with SETTINGS
+			if (type != Http2FrameType::Settings || header.isAck()) {
+				_goAway(Http2ErrorCode::ProtocolError);
+				return;
+			}
+		}
+		if (m_streamIdHeaders) {
+			if (type != Http2FrameType::Continuation || header.getStreamId() != m_streamIdHeaders) {
+				_goAway(Http2ErrorCode::ProtocolError);
+				return;
+			}
+		}
+		switch (type) {
+			case Http2FrameType::Data:
+				_onData(header, payload, size, contexts);
+				break;
+			case Http2FrameType::Headers:
+				_onHeaders(header, payload, size, contexts);
+				break;
+			case Http2FrameType::Priority:
+				_onPriority(header, payload, size);
+				break;
+			case Http2FrameType::RstStream:
+				_onRstStream(header, payload, size);
+				break;
+			case Http2FrameType::Settings:
+				if (_onSettings(header, payload, size)) {
+					m_flagSettingsReceived = sl_true;
+				}
+				break;
+			case Http2FrameType::PushPromise:
+				_goAway(Http2ErrorCode::ProtocolError);
+				break;
+			case Http2FrameType::Ping:
+				_onPing(header, payload, size);
+				break;
+			case Http2FrameType::GoAway:
+				_onGoAway(header, payload, size);
+				break;
+			case Http2FrameType::WindowUpdate:
+				_onWindowUpdate(header, payload, size);
+				break;
+			case Http2FrameType::Continuation:
+				_onContinuation(header, payload, size, contexts);
+				break;
+			case Http2FrameType::PriorityUpdate:
+				_onPriorityUpdate(header, payload, size);
+				break;
+			default:
+				// Unknown frames are ignored
+				break;
+		}
+	}
+
+	void Http2ServerSession::_onData(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size, List< Ref<HttpServerContext> >& contexts)
+	{
+		sl_uint32 streamId = header.getStreamId();
+		if (!streamId) {
+			_goAway(Http2ErrorCode::ProtocolError);
+			return;
+		}
+		sl_uint32 sizeData = size;
+		if (header.isPadded()) {
+			if (!size || payload[0] >= size) {
+				_goAway(Http2ErrorCode::ProtocolError);
+				return;
+			}
+			sizeData = size - 1 - payload[0];
+			payload++;
+		}
+		// The whole frame counts for the flow control
+		m_windowReceive -= size;
+		if (m_windowReceive < 0) {
+			_goAway(Http2ErrorCode::FlowControlError);
+			return;
+		}
+		m_sizeReceivedUnacked += size;
+		if (m_sizeReceivedUnacked >= (m_initialWindowSize >> 1)) {
+			_writeWindowUpdate(0, m_sizeReceivedUnacked);
+			m_windowReceive += m_sizeReceivedUnacked;
+			m_sizeReceivedUnacked = 0;
+		}
+		Ref<Http2ServerStream> stream = m_streams.getValue_NoLock(streamId);
+		if (stream.isNull()) {
+			if (streamId > m_lastStreamId) {
+				_goAway(Http2ErrorCode::ProtocolError);
+			} else {
+				_resetStream(streamId, Http2ErrorCode::StreamClosed);
+			}
+			return;
+		}
+		if (stream->flagEndStreamReceived) {
+			_resetStream(stream.get(), Http2ErrorCode::StreamClosed);
+			return;
+		}
+		stream->windowReceive -= size;
+		if (stream->windowReceive < 0) {
+			_resetStream(stream.get(), Http2ErrorCode::FlowControlError);
+			return;
+		}
+		if (!(stream->flagDiscardBody) && sizeData) {
+			stream->sizeBody += sizeData;
+			if (stream->contentLength >= 0 && stream->sizeBody > (sl_uint64)(stream->contentLength)) {
+				_resetStream(stream.get(), Http2ErrorCode::ProtocolError);
+				return;
+			}
+			if (stream->sizeBody > m_maxRequestBodySize) {
+				_respondError(stream.get(), HttpStatus::BadRequest);
+			} else {
+				if (!(stream->context->m_requestBodyBuffer.addNew(payload, sizeData))) {
+					_resetStream(stream.get(), Http2ErrorCode::InternalError);
+					return;
+				}
+			}
+		}
+		if (header.isEndStream()) {
+			_onEndStream(stream.get(), contexts);
+		} else {
+			stream->sizeReceivedUnacked += size;
+			if (stream->sizeReceivedUnacked >= (m_initialWindowSize >> 1)) {
+				_writeWindowUpdate(streamId, stream->sizeReceivedUnacked);
+				stream->windowReceive += stream->sizeReceivedUnacked;
+				stream->sizeReceivedUnacked = 0;
+			}
+		}
+	}
+
+	void Http2ServerSession::_onHeaders(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size, List< Ref<HttpServerContext> >& contexts)
+	{
+		sl_uint32 streamId = header.getStreamId();
+		if (!streamId || !(streamId & 1)) {
+			_goAway(Http2ErrorCode::ProtocolError);
+			return;
+		}
+		sl_uint32 sizePadding = 0;
+		if (header.isPadded()) {
+			if (!size) {
+				_goAway(Http2ErrorCode::FrameSizeError);
+				return;
+			}
+			sizePadding = payload[0];
+			payload++;
+			size--;
+		}
+		m_errorHeaders = Http2ErrorCode::NoError;
+		if (header.isPriority()) {
+			if (size < 5) {
+				_goAway(Http2ErrorCode::FrameSizeError);
+				return;
+			}
+			if ((MIO::readUint32BE(payload) & 0x7fffffff) == streamId) {
+				m_errorHeaders = Http2ErrorCode::ProtocolError;
+			}
+			payload += 5;
+			size -= 5;
+		}
+		if (sizePadding > size) {
+			_goAway(Http2ErrorCode::ProtocolError);
+			return;
+		}
+		size -= sizePadding;
+		if (!(m_streams.find_NoLock(streamId))) {
+			if (streamId <= m_lastStreamId) {
+				_goAway(Http2ErrorCode::StreamClosed);
+				return;
+			}
+			m_lastStreamId = streamId;
+		}
+		m_streamIdHeaders = streamId;
+		m_flagHeadersEndStream = header.isEndStream();
+		m_headerBlock.clear();
+		if (size) {
+			m_headerBlock.write(payload, size);
+		}
+		if (header.isEndHeaders()) {
+			_onHeaderBlock(contexts);
+		}
+	}
+
+	void Http2ServerSession::_onContinuation(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size, List< Ref<HttpServerContext> >& contexts)
+	{
+		if (!m_streamIdHeaders) {
+			_goAway(Http2ErrorCode::ProtocolError);
+			return;
+		}
+		if (size) {
+			if (m_headerBlock.getSize() + size > m_maxRequestHeadersSize) {
+				_goAway(Http2ErrorCode::EnhanceYourCalm);
+				return;
+			}
+			m_headerBlock.write(payload, size);
+		}
+		if (header.isEndHeaders()) {
+			_onHeaderBlock(contexts);
+		}
+	}
+
+	void Http2ServerSession::_onHeaderBlock(List< Ref<HttpServerContext> >& contexts)
+	{
+		sl_uint32 streamId = m_streamIdHeaders;
+		m_streamIdHeaders = 0;
+		Memory block = m_headerBlock.getData();
+		m_headerBlock.clear();
+		// The header block is decoded in any case, to keep the dynamic table synchronized
+		List<HpackHeaderField> fields;
+		if (!(m_decoder.decode(block.getData(), block.getSize(), fields, (sl_size)m_maxRequestHeadersSize))) {
+			_goAway(Http2ErrorCode::CompressionError);
+			return;
+		}
+		Ref<Http2ServerStream> stream = m_streams.getValue_NoLock(streamId);
+		if (stream.isNotNull()) {
+			// Trailers
+			if (stream->flagEndStreamReceived) {
+				_resetStream(stream.get(), Http2ErrorCode::StreamClosed);
+				return;
+			}
+			if (!m_flagHeadersEndStream || m_errorHeaders != Http2ErrorCode::NoError) {
+				_resetStream(stream.get(), Http2ErrorCode::ProtocolError);
+				return;
+			}
+			for (auto& field : fields) {
+				if (!(IsValidFieldName(field.name)) || !(IsValidFieldValue(field.value)) || IsConnectionSpecificField(field.name)) {
+					_resetStream(stream.get(), Http2ErrorCode::ProtocolError);
+					return;
+				}
+			}
+			if (!(stream->flagDiscardBody)) {
+				for (auto& field : fields) {
+					stream->context->addRequestHeader(field.name, field.value);
+				}
+			}
+			_onEndStream(stream.get(), contexts);
+			return;
+		}
+		if (m_errorHeaders != Http2ErrorCode::NoError) {
+			_resetStream(streamId, m_errorHeaders);
+			return;
+		}
+		// The contexts of the closed streams are still processed, so they are counted until completed (CVE-2023-44487)
+		if (m_flagGoingAway || m_streams.getCount() + m_nClosedProcessingStreams >= m_maxConcurrentStreams) {
+			_resetStream(streamId, Http2ErrorCode::RefusedStream);
+			if (_isResettingRapidly()) {
+				_goAway(Http2ErrorCode::EnhanceYourCalm);
+			}
+			return;
+		}
+		Ref<HttpServerConnection> connection = m_connection;
+		if (connection.isNull()) {
+			return;
+		}
+		Ref<HttpServerContext> context = HttpServerContext::create(connection);
+		if (context.isNull()) {
+			_resetStream(streamId, Http2ErrorCode::InternalError);
+			return;
+		}
+		stream = new Http2ServerStream(streamId);
+		if (stream.isNull()) {
+			_resetStream(streamId, Http2ErrorCode::InternalError);
+			return;
+		}
+		context->m_http2StreamId = streamId;
+		context->setProcessingByThread(m_flagProcessByThreads);
+		stream->context = Move(context);
+		stream->windowSend = m_peerInitialWindowSize;
+		stream->windowReceive = m_initialWindowSize > Http2FrameHeader::DefaultWindowSize ? m_initialWindowSize : Http2FrameHeader::DefaultWindowSize;
+		if (!(_applyRequestHeaders(stream.get(), fields))) {
+			_resetStream(streamId, Http2ErrorCode::ProtocolError);
+			return;
+		}
+		if (!(m_streams.put_NoLock(streamId, stream))) {
+			_resetStream(streamId, Http2ErrorCode::InternalError);
+			return;
+		}
+		if (stream->contentLength > 0 && (sl_uint64)(stream->contentLength) > m_maxRequestBodySize) {
+			_respondError(stream.get(), HttpStatus::BadRequest);
+		}
+		if (m_flagHeadersEndStream) {
+			_onEndStream(stream.get(), contexts);
+		}
+	}
+
+	sl_bool Http2ServerSession::_applyRequestHeaders(Http2ServerStream* stream, List<HpackHeaderField>& fields)
+	{
+		HttpServerContext* context = stream->context.get();
+		String method, scheme, path, authority;
+		sl_uint32 flagsPseudo = 0;
+		sl_bool flagRegular = sl_false;
+		List<String> cookies;
+		for (auto& field : fields) {
+			String& name = field.name;
+			String& value = field.value;
+			if (name.startsWith(':')) {
+				if (flagRegular) {
+					return sl_false;
+				}
+				sl_uint32 flag;
+				String* target;
+				if (EqualsName(name, StringView::literal(":method"))) {
+					flag = 1;
+					target = &method;
+				} else if (EqualsName(name, StringView::literal(":scheme"))) {
+					flag = 2;
+					target = &scheme;
+				} else if (EqualsName(name, StringView::literal(":path"))) {
+					flag = 4;
+					target = &path;
+				} else if (EqualsName(name, StringView::literal(":authority"))) {
+					flag = 8;
+					target = &authority;
+				} else {
+					return sl_false;
+				}
+				if (flagsPseudo & flag) {
+					return sl_false;
+				}
+				flagsPseudo |= flag;
+				*target = value;
+			} else {
+				flagRegular = sl_true;
+				if (!(IsValidFieldName(name)) || !(IsValidFieldValue(value))) {
+					return sl_false;
+				}
+				if (IsConnectionSpecificField(name)) {
+					return sl_false;
+				}
+				if (EqualsName(name, StringView::literal("te"))) {
+					if (value != StringView::literal("trailers")) {
+						return sl_false;
+					}
+				} else if (EqualsName(name, StringView::literal("cookie"))) {
+					cookies.add_NoLock(value);
+					continue;
+				} else if (EqualsName(name, StringView::literal("content-length"))) {
+					sl_uint64 n;
+					if (!(value.parseUint64(10, &n)) || n > 0x7fffffffffffffff) {
+						return sl_false;
+					}
+					if (stream->contentLength >= 0 && (sl_uint64)(stream->contentLength) != n) {
+						return sl_false;
+					}
+					stream->contentLength = (sl_int64)n;
+				} else if (EqualsName(name, StringView::literal("priority"))) {
+					ParsePriority(value, stream->urgency, stream->flagIncremental);
+				}
+				context->addRequestHeader(name, value);
+			}
+		}
+		if (method.isEmpty()) {
+			return sl_false;
+		}
+		if (method == StringView::literal("CONNECT")) {
+			if (authority.isEmpty() || (flagsPseudo & 6)) {
+				return sl_false;
+			}
+		} else {
+			if (scheme.isEmpty() || path.isEmpty()) {
+				return sl_false;
+			}
+			if (path.getAt(0) != '/' && !(path == StringView::literal("*") && method == StringView::literal("OPTIONS"))) {
+				return sl_false;
+			}
+		}
+		context->setMethod(method);
+		sl_reg indexQuery = path.indexOf('?');
+		if (indexQuery >= 0) {
+			context->setPath(path.substring(0, indexQuery));
+			context->setQuery(path.substring(indexQuery + 1));
+		} else {
+			context->setPath(path);
+		}
+		SLIB_STATIC_STRING(version, "HTTP/2")
+		context->setRequestVersion(version);
+		if (authority.isNotEmpty()) {
+			context->setRequestHeader(HttpHeader::Host, authority);
+		}
+		if (cookies.isNotEmpty()) {
+			context->setRequestHeader(HttpHeader::Cookie, String::join(cookies, StringView::literal("; ")));
+		}
+		context->applyQueryToParameters();
+		return sl_true;
+	}
+
+	void Http2ServerSession::_onEndStream(Http2ServerStream* stream, List< Ref<HttpServerContext> >& contexts)
+	{
+		stream->flagEndStreamReceived = sl_true;
+		if (stream->flagDiscardBody) {
+			if (stream->flagEndStreamSent) {
+				_closeStream(stream);
+			}
+			return;
+		}
+		if (stream->contentLength >= 0 && (sl_uint64)(stream->contentLength) != stream->sizeBody) {
+			_resetStream(stream, Http2ErrorCode::ProtocolError);
+			return;
+		}
+		if (!(stream->flagDispatched)) {
+			stream->flagDispatched = sl_true;
+			stream->flagProcessing = sl_true;
+			stream->context->m_requestContentLength = stream->sizeBody;
+			contexts.add_NoLock(stream->context);
+		}
+	}
+
+	void Http2ServerSession::_respondError(Http2ServerStream* stream, HttpStatus status)
+	{
+		if (stream->flagDispatched) {
+			return;
+		}
+		stream->flagDispatched = sl_true;
+		stream->flagDiscardBody = sl_true;
+		HttpServerContext* context = stream->context.get();
+		context->m_requestBodyBuffer.clear();
+		context->setResponseCode(status);
+		context->setResponseContentLengthHeader(0);
+		_completeStream(stream);
+	}
+
+	void Http2ServerSession::_onPriority(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size)
+	{
+		// The priority signals of RFC 7540 are deprecated by RFC 9113. Validated, and ignored
+		sl_uint32 streamId = header.getStreamId();
+		if (!streamId) {
+			_goAway(Http2ErrorCode::ProtocolError);
+			return;
+		}
+		if (size != 5) {
+			_resetStream(streamId, Http2ErrorCode::FrameSizeError);
+			return;
+		}
+		if ((MIO::readUint32BE(payload) & 0x7fffffff) == streamId) {
+			_resetStream(streamId, Http2ErrorCode::ProtocolError);
+		}
+	}
+
+	void Http2ServerSession::_onRstStream(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size)
+	{
+		sl_uint32 streamId = header.getStreamId();
+		if (!streamId) {
+			_goAway(Http2ErrorCode::ProtocolError);
+			return;
+		}
+		if (size != 4) {
+			_goAway(Http2ErrorCode::FrameSizeError);
+			return;
+		}
+		if (streamId > m_lastStreamId) {
+			_goAway(Http2ErrorCode::ProtocolError);
+			return;
+		}
+		Ref<Http2ServerStream> stream = m_streams.getValue_NoLock(streamId);
+		if (stream.isNotNull()) {
+			_closeStream(stream.get());
+			if (_isResettingRapidly()) {
+				_goAway(Http2ErrorCode::EnhanceYourCalm);
+			}
+		}
+	}
+
+	sl_bool Http2ServerSession::_isResettingRapidly()
+	{
+		// Rapid reset (CVE-2023-44487): the streams canceled by the client or refused by the limit are counted per second
+		if (!m_maxResetRate) {
+			return sl_false;
+		}
+		sl_uint64 now = System::getTickCount64();
+		if (!m_nResetsCounted || now < m_timeResetCounting || now - m_timeResetCounting >= 1000) {
+			m_timeResetCounting = now;
+			m_nResetsCounted = 0;
+		}
+		m_nResetsCounted++;
+		return m_nResetsCounted > m_maxResetRate;
+	}
+
+	sl_bool Http2ServerSession::_onSettings(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size)
+	{
+		if (header.getStreamId()) {
+			_goAway(Http2ErrorCode::ProtocolError);
+			return sl_false;
+		}
+		if (header.isAck()) {
+			if (size) {
+				_goAway(Http2ErrorCode::FrameSizeError);
+				return sl_false;
+			}
+			return sl_true;
+		}
+		if (size % 6) {
+			_goAway(Http2ErrorCode::FrameSizeError);
+			return sl_false;
+		}
+		if (!(_applySettings(payload, size))) {
+			return sl_false;
+		}
+		_writeFrame(Http2FrameType::Settings, Http2FrameHeader::FlagAck, 0, sl_null, 0);
+		return sl_true;
+	}
+
+	sl_bool Http2ServerSession::_applySettings(const sl_uint8* payload, sl_uint32 size)
+	{
+		for (sl_uint32 pos = 0; pos + 6 <= size; pos += 6) {
+			sl_uint32 value = MIO::readUint32BE(payload + pos + 2);
+			switch ((Http2SettingId)(MIO::readUint16BE(payload + pos))) {
+				case Http2SettingId::HeaderTableSize:
+					m_encoder.setMaxTableSize(value);
+					break;
+				case Http2SettingId::EnablePush:
+					if (value > 1) {
+						_goAway(Http2ErrorCode::ProtocolError);
+						return sl_false;
+					}
+					break;
+				case Http2SettingId::InitialWindowSize:
+					{
+						if (value > Http2FrameHeader::MaxWindowSize) {
+							_goAway(Http2ErrorCode::FlowControlError);
+							return sl_false;
+						}
+						sl_int64 delta = (sl_int64)value - (sl_int64)m_peerInitialWindowSize;
+						m_peerInitialWindowSize = value;
+						for (auto& item : m_streams) {
+							Http2ServerStream* stream = item.value.get();
+							stream->windowSend += delta;
+							if (stream->windowSend > Http2FrameHeader::MaxWindowSize) {
+								_goAway(Http2ErrorCode::FlowControlError);
+								return sl_false;
+							}
+						}
+					}
+					break;
+				case Http2SettingId::MaxFrameSize:
+					if (value < Http2FrameHeader::DefaultMaxFrameSize || value > 0xffffff) {
+						_goAway(Http2ErrorCode::ProtocolError);
+						return sl_false;
+					}
+					m_peerMaxFrameSize = value;
+					break;
+				default:
+					break;
+			}
+		}
+		return sl_true;
+	}
+
+	void Http2ServerSession::_onPing(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size)
+	{
+		if (header.getStreamId()) {
+			_goAway(Http2ErrorCode::ProtocolError);
+			return;
+		}
+		if (size != 8) {
+			_goAway(Http2ErrorCode::FrameSizeError);
+			return;
+		}
+		if (!(header.isAck())) {
+			_writeFrame(Http2FrameType::Ping, Http2FrameHeader::FlagAck, 0, payload, 8);
+		}
+	}
+
+	void Http2ServerSession::_onGoAway(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size)
+	{
+		if (header.getStreamId()) {
+			_goAway(Http2ErrorCode::ProtocolError);
+			return;
+		}
+		if (size < 8) {
+			_goAway(Http2ErrorCode::FrameSizeError);
+			return;
+		}
+		// The client closes the connection after the active streams complete
+	}
+
+	void Http2ServerSession::_onWindowUpdate(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size)
+	{
+		if (size != 4) {
+			_goAway(Http2ErrorCode::FrameSizeError);
+			return;
+		}
+		sl_uint32 streamId = header.getStreamId();
+		sl_uint32 increment = MIO::readUint32BE(payload) & 0x7fffffff;
+		if (!streamId) {
+			if (!increment) {
+				_goAway(Http2ErrorCode::ProtocolError);
+				return;
+			}
+			m_windowSend += increment;
+			if (m_windowSend > Http2FrameHeader::MaxWindowSize) {
+				_goAway(Http2ErrorCode::FlowControlError);
+			}
+			return;
+		}
+		Ref<Http2ServerStream> stream = m_streams.getValue_NoLock(streamId);
+		if (stream.isNull()) {
+			if (streamId > m_lastStreamId) {
+				_goAway(Http2ErrorCode::ProtocolError);
+			}
+			return;
+		}
+		if (!increment) {
+			_resetStream(stream.get(), Http2ErrorCode::ProtocolError);
+			return;
+		}
+		stream->windowSend += increment;
+		if (stream->windowSend > Http2FrameHeader::MaxWindowSize) {
+			_resetStream(stream.get(), Http2ErrorCode::FlowControlError);
+		}
+	}
+
+	void Http2ServerSession::_onPriorityUpdate(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size)
+	{
+		if (header.getStreamId()) {
+			_goAway(Http2ErrorCode::ProtocolError);
+			return;
+		}
+		if (size < 4) {
+			_goAway(Http2ErrorCode::FrameSizeError);
+			return;
+		}
+		sl_uint32 streamId = MIO::readUint32BE(payload) & 0x7fffffff;
+		if (!streamId) {
+			_goAway(Http2ErrorCode::ProtocolError);
+			return;
+		}
+		// The updates for the idle streams are not kept
+		Ref<Http2ServerStream> stream = m_streams.getValue_NoLock(streamId);
+		if (stream.isNotNull()) {
+			stream->urgency = HTTP2_DEFAULT_URGENCY;
+			stream->flagIncremental = sl_false;
+			ParsePriority(StringView((const sl_char8*)(payload + 4), size - 4), stream->urgency, stream->flagIncremental);
+		}
+	}
+
+	void Http2ServerSession::completeContext(HttpServerContext* context)
+	{
+		{
+			ObjectLocker lock(this);
+			if (m_flagClosed) {
+				return;
+			}
+			Ref<Http2ServerStream> stream = m_streams.getValue_NoLock(context->m_http2StreamId);
+			if (stream.isNull() || stream->context != context || stream->flagResponding) {
+				// Reset by the client
+				if (m_nClosedProcessingStreams) {
+					m_nClosedProcessingStreams--;
+				}
+				return;
+			}
+			stream->flagProcessing = sl_false;
+			if (context->getMethod() == HttpMethod::HEAD) {
+				stream->flagNoBody = sl_true;
+			}
+			_completeStream(stream.get());
+			_send();
+		}
+		_flush();
+		_closeConnectionIfRequested();
+	}
+
+	void Http2ServerSession::_completeStream(Http2ServerStream* stream)
+	{
+		HttpServerContext* context = stream->context.get();
+		Ref<AsyncOutputBufferElement> element;
+		while (context->m_bufferOutput.popOutput(element)) {
+			if (!(stream->flagNoBody)) {
+				stream->queueOutput.push_NoLock(Move(element));
+			}
+		}
+		stream->flagResponding = sl_true;
+		m_streamsSending.add_NoLock(stream);
+	}
+
+	void Http2ServerSession::_closeStream(Http2ServerStream* stream)
+	{
+		if (stream->flagClosed) {
+			return;
+		}
+		stream->flagClosed = sl_true;
+		if (stream->flagProcessing) {
+			m_nClosedProcessingStreams++;
+		}
+		Ref<Http2ServerStream> ref = stream;
+		m_streams.remove_NoLock(stream->id);
+		m_streamsSending.remove_NoLock(ref);
+		if (stream->bodyOutput.isNotNull()) {
+			stream->bodyOutput->close();
+			stream->bodyOutput.setNull();
+		}
+		stream->queueOutput.removeAll_NoLock();
+		stream->elementOutput.setNull();
+		stream->dataOutput = MemoryData();
+	}
+
+	void Http2ServerSession::resetStream(HttpServerContext* context, Http2ErrorCode code)
+	{
+		{
+			ObjectLocker lock(this);
+			if (m_flagClosed) {
+				return;
+			}
+			Ref<Http2ServerStream> stream = m_streams.getValue_NoLock(context->m_http2StreamId);
+			if (stream.isNotNull() && stream->context == context) {
+				stream->flagProcessing = sl_false;
+				_resetStream(stream.get(), code);
+			} else if (m_nClosedProcessingStreams) {
+				m_nClosedProcessingStreams--;
+			}
+			_send();
+		}
+		_flush();
+		_closeConnectionIfRequested();
+	}
+
+	void Http2ServerSession::_resetStream(Http2ServerStream* stream, Http2ErrorCode code)
+	{
+		_closeStream(stream);
+		_resetStream(stream->id, code);
+	}
+
+	void Http2ServerSession::_resetStream(sl_uint32 streamId, Http2ErrorCode code)
+	{
+		sl_uint8 payload[4];
+		MIO::writeUint32BE(payload, (sl_uint32)code);
+		_writeFrame(Http2FrameType::RstStream, 0, streamId, payload, 4);
+	}
+
+	void Http2ServerSession::_goAway(Http2ErrorCode code)
+	{
+		if (m_flagGoingAway) {
+			return;
+		}
+		m_flagGoingAway = sl_true;
+		sl_uint8 payload[8];
+		MIO::writeUint32BE(payload, m_lastStreamId);
+		MIO::writeUint32BE(payload + 4, (sl_uint32)code);
+		_writeFrame(Http2FrameType::GoAway, 0, 0, payload, 8);
+	}
+
+	void Http2ServerSession::_writeFrame(Http2FrameType type, sl_uint8 flags, sl_uint32 streamId, const void* payload, sl_uint32 size)
+	{
+		sl_uint8 header[Http2FrameHeader::HeaderSize];
+		WriteFrameHeader(header, type, flags, streamId, size);
+		m_control.write(header, sizeof(header));
+		if (size) {
+			m_control.write(payload, size);
+		}
+	}
+
+	void Http2ServerSession::_writeWindowUpdate(sl_uint32 streamId, sl_uint32 increment)
+	{
+		sl_uint8 payload[4];
+		MIO::writeUint32BE(payload, increment);
+		_writeFrame(Http2FrameType::WindowUpdate, 0, streamId, payload, 4);
+	}
+
+	sl_bool Http2ServerSession::isActive()
+	{
+		ObjectLocker lock(this);
+		return m_streams.isNotEmpty() || m_sizeWriting;
+	}
+
+	void Http2ServerSession::close()
+	{
+		ObjectLocker lock(this);
+		if (m_flagClosed) {
+			return;
+		}
+		m_flagClosed = sl_true;
+		for (auto& item : m_streams) {
+			Http2ServerStream* stream = item.value.get();
+			stream->flagClosed = sl_true;
+			if (stream->bodyOutput.isNotNull()) {
+				stream->bodyOutput->close();
+			}
+		}
+		m_streams.setNull();
+		m_streamsSending.setNull();
+		m_bufInput.setNull();
+		m_control.clear();
+		m_queueWriting.removeAll_NoLock();
+	}
+
+	void Http2ServerSession::_send()
+	{
+		if (m_flagClosed || m_flagWriteError || m_flagSending) {
+			return;
+		}
+		m_flagSending = sl_true;
+		while (m_sizeWriting < HTTP2_SEND_LIMIT) {
+			Ref<WriteBatch> batch = new WriteBatch;
+			if (batch.isNull()) {
+				m_flagWriteError = sl_true;
+				break;
+			}
+			List<MemoryData>& pieces = batch->pieces;
+			sl_size sizeBatch = 0;
+			if (m_control.getSize()) {
+				Memory control = m_control.getData();
+				m_control.clear();
+				sizeBatch += control.getSize();
+				pieces.add_NoLock(Move(control));
+			}
+			if (!m_flagGoingAway && m_flagPrefaceReceived) {
+				sl_uint32 nFrames = 0;
+				while (pieces.getCount() + 2 <= HTTP2_MAX_WRITE_VECTOR && sizeBatch < HTTP2_BATCH_SIZE) {
+					Http2ServerStream* stream = _pickStream();
+					if (!stream) {
+						break;
+					}
+					if (batch->frameHeaders.isNull()) {
+						batch->frameHeaders = Memory::create(Http2FrameHeader::HeaderSize * (HTTP2_MAX_WRITE_VECTOR / 2));
+						if (batch->frameHeaders.isNull()) {
+							m_flagWriteError = sl_true;
+							break;
+						}
+					}
+					_sendFrame(stream, pieces, (sl_uint8*)(batch->frameHeaders.getData()) + Http2FrameHeader::HeaderSize * nFrames, sizeBatch);
+					nFrames++;
+					if (m_control.getSize()) {
+						// RST_STREAM after the last frame of the stream
+						Memory control = m_control.getData();
+						m_control.clear();
+						sizeBatch += control.getSize();
+						pieces.add_NoLock(Move(control));
+					}
+				}
+			}
+			if (pieces.isEmpty() || m_flagWriteError) {
+				break;
+			}
+			batch->size = sizeBatch;
+			m_sizeWriting += sizeBatch;
+			m_queueWriting.push_NoLock(Move(batch));
+		}
+		m_flagSending = sl_false;
+		if (m_flagWriteError || (m_flagGoingAway && !m_sizeWriting)) {
+			m_flagCloseRequested = sl_true;
+		}
+	}
+
+	void Http2ServerSession::_flush()
+	{
+		for (;;) {
+			Ref<Referable> _batch;
+			{
+				ObjectLocker lock(this);
+				if (m_flagFlushing) {
+					// The writing thread takes the batch
+					return;
+				}
+				if (!(m_queueWriting.pop_NoLock(&_batch))) {
+					return;
+				}
+				m_flagFlushing = sl_true;
+			}
+			WriteBatch* batch = (WriteBatch*)(_batch.get());
+			sl_size sizeBatch = batch->size;
+			sl_size nPieces = batch->pieces.getCount();
+			sl_bool flagSuccess = sl_false;
+			SLIB_SCOPED_BUFFER(MemoryView, HTTP2_MAX_WRITE_VECTOR, views, nPieces)
+			if (views) {
+				MemoryData* data = batch->pieces.getData();
+				for (sl_size i = 0; i < nPieces; i++) {
+					views[i] = data[i];
+				}
+				WeakRef<Http2ServerSession> weakThis = this;
+				flagSuccess = m_io->writeVector(views, nPieces, [weakThis, sizeBatch](AsyncStreamResult& result) {
+					Ref<Http2ServerSession> thiz = weakThis;
+					if (thiz.isNotNull()) {
+						thiz->_onWrite(sizeBatch, result.isSuccess());
+					}
+				}, batch);
+			}
+			ObjectLocker lock(this);
+			m_flagFlushing = sl_false;
+			if (!flagSuccess) {
+				m_sizeWriting -= sizeBatch;
+				m_flagWriteError = sl_true;
+				m_flagCloseRequested = sl_true;
+				m_queueWriting.removeAll_NoLock();
+				return;
+			}
+		}
+	}
+
+	Http2ServerStream* Http2ServerSession::_pickStream()
+	{
+		sl_size n = m_streamsSending.getCount();
+		if (!n) {
+			return sl_null;
+		}
+		Ref<Http2ServerStream>* streams = m_streamsSending.getData();
+		// Lower urgency first. In the same urgency, the non-incremental responses are sent one by one in the order of the streams,
+		// and the incremental responses take turns by the frames
+		Http2ServerStream* streamSequential = sl_null;
+		Http2ServerStream* streamNext = sl_null;
+		Http2ServerStream* streamFirst = sl_null;
+		sl_uint32 urgency = 8;
+		for (sl_size i = 0; i < n; i++) {
+			Http2ServerStream* stream = streams[i].get();
+			if (stream->urgency > urgency) {
+				continue;
+			}
+			if (!(_isSendable(stream))) {
+				continue;
+			}
+			if (stream->urgency < urgency) {
+				urgency = stream->urgency;
+				streamSequential = sl_null;
+				streamNext = sl_null;
+				streamFirst = sl_null;
+			}
+			if (stream->flagIncremental) {
+				if (!streamFirst || stream->id < streamFirst->id) {
+					streamFirst = stream;
+				}
+				if (stream->id > m_lastIncrementalStreamId) {
+					if (!streamNext || stream->id < streamNext->id) {
+						streamNext = stream;
+					}
+				}
+			} else {
+				if (!streamSequential || stream->id < streamSequential->id) {
+					streamSequential = stream;
+				}
+			}
+		}
+		if (streamSequential) {
+			return streamSequential;
+		}
+		if (streamNext) {
+			m_lastIncrementalStreamId = streamNext->id;
+			return streamNext;
+		}
+		if (streamFirst) {
+			m_lastIncrementalStreamId = streamFirst->id;
+		}
+		return streamFirst;
+	}
+
+	sl_bool Http2ServerSession::_isSendable(Http2ServerStream* stream)
+	{
+		if (!(stream->flagResponding) || stream->flagEndStreamSent) {
+			return sl_false;
+		}
+		if (!(stream->flagHeadersSent)) {
+			return sl_true;
+		}
+		sl_int32 state = _prepareOutput(stream);
+		if (state == OUTPUT_READY) {
+			return stream->windowSend > 0 && m_windowSend > 0;
+		}
+		return state != OUTPUT_WAITING;
+	}
+
+	sl_int32 Http2ServerSession::_prepareOutput(Http2ServerStream* stream)
+	{
+		for (;;) {
+			if (stream->flagBodyError) {
+				return OUTPUT_ERROR;
+			}
+			if (stream->dataOutput.size) {
+				return OUTPUT_READY;
+			}
+			if (stream->flagReadingBody) {
+				return OUTPUT_WAITING;
+			}
+			if (stream->bodyOutput.isNotNull()) {
+				if (!(stream->sizeBodyOutput)) {
+					stream->bodyOutput.setNull();
+					continue;
+				}
+				sl_size sizeRead = stream->sizeBodyOutput < HTTP2_READ_BODY_SIZE ? (sl_size)(stream->sizeBodyOutput) : HTTP2_READ_BODY_SIZE;
+				Memory buf = Memory::create(sizeRead);
+				if (buf.isNull()) {
+					stream->flagBodyError = sl_true;
+					continue;
+				}
+				WeakRef<Http2ServerSession> weakThis = this;
+				Ref<Http2ServerStream> refStream = stream;
+				stream->flagReadingBody = sl_true;
+				if (!(stream->bodyOutput->read(buf, [weakThis, refStream, buf](AsyncStreamResult& result) {
+					Ref<Http2ServerSession> thiz = weakThis;
+					if (thiz.isNotNull()) {
+						Memory mem = buf;
+						thiz->_onReadBody(refStream.get(), mem, result);
+					}
+				}))) {
+					stream->flagReadingBody = sl_false;
+					stream->flagBodyError = sl_true;
+				}
+				// The reading might be completed already
+				continue;
+			}
+			if (stream->elementOutput.isNotNull()) {
+				MemoryData data;
+				if (stream->elementOutput->getHeader().pop_NoLock(data)) {
+					if (data.size) {
+						stream->dataOutput = Move(data);
+					}
+					continue;
+				}
+				Ref<AsyncStream> body = stream->elementOutput->getBody();
+				sl_uint64 sizeBody = stream->elementOutput->getBodySize();
+				stream->elementOutput.setNull();
+				if (body.isNotNull() && sizeBody) {
+					stream->bodyOutput = Move(body);
+					stream->sizeBodyOutput = sizeBody;
+				}
+				continue;
+			}
+			if (!(stream->queueOutput.pop_NoLock(&(stream->elementOutput)))) {
+				return OUTPUT_END;
+			}
+		}
+	}
+
+	void Http2ServerSession::_onReadBody(Http2ServerStream* stream, Memory& buf, AsyncStreamResult& result)
+	{
+		{
+			ObjectLocker lock(this);
+			stream->flagReadingBody = sl_false;
+			if (m_flagClosed || stream->flagClosed) {
+				return;
+			}
+			if (result.isSuccess() && result.size) {
+				sl_size size = result.size;
+				if (size > stream->sizeBodyOutput) {
+					size = (sl_size)(stream->sizeBodyOutput);
+				}
+				stream->dataOutput = MemoryData(buf.getData(), size, buf.ref);
+				stream->sizeBodyOutput -= size;
+			} else {
+				// The promised length of the content can't be sent
+				stream->flagBodyError = sl_true;
+			}
+			_send();
+		}
+		_flush();
+		_closeConnectionIfRequested();
+	}
+
+	void Http2ServerSession::_sendFrame(Http2ServerStream* stream, List<MemoryData>& pieces, sl_uint8* frameHeader, sl_size& sizeBatch)
+	{
+		if (!(stream->flagHeadersSent)) {
+			stream->flagHeadersSent = sl_true;
+			sl_bool flagEndStream = stream->flagNoBody || _prepareOutput(stream) == OUTPUT_END;
+			Memory frames = _encodeResponseHeaders(stream, flagEndStream);
+			if (frames.isNull()) {
+				_resetStream(stream, Http2ErrorCode::InternalError);
+				return;
+			}
+			sizeBatch += frames.getSize();
+			pieces.add_NoLock(Move(frames));
+			if (flagEndStream) {
+				stream->flagEndStreamSent = sl_true;
+			}
+		} else {
+			sl_int32 state = _prepareOutput(stream);
+			if (state == OUTPUT_ERROR) {
+				_resetStream(stream, Http2ErrorCode::InternalError);
+				return;
+			}
+			if (state == OUTPUT_END) {
+				WriteFrameHeader(frameHeader, Http2FrameType::Data, Http2FrameHeader::FlagEndStream, stream->id, 0);
+				pieces.add_NoLock(MemoryData(frameHeader, Http2FrameHeader::HeaderSize));
+				sizeBatch += Http2FrameHeader::HeaderSize;
+				stream->flagEndStreamSent = sl_true;
+			} else {
+				MemoryData& data = stream->dataOutput;
+				sl_size size = data.size;
+				sl_int64 window = stream->windowSend < m_windowSend ? stream->windowSend : m_windowSend;
+				if ((sl_int64)size > window) {
+					size = (sl_size)window;
+				}
+				if (size > m_peerMaxFrameSize) {
+					size = m_peerMaxFrameSize;
+				}
+				MemoryData piece(data.data, size, data.ref);
+				data.data = (sl_uint8*)(data.data) + size;
+				data.size -= size;
+				if (!(data.size)) {
+					data.ref.setNull();
+				}
+				stream->windowSend -= size;
+				m_windowSend -= size;
+				sl_uint8 flags = 0;
+				if (!(data.size) && _prepareOutput(stream) == OUTPUT_END) {
+					flags = Http2FrameHeader::FlagEndStream;
+					stream->flagEndStreamSent = sl_true;
+				}
+				WriteFrameHeader(frameHeader, Http2FrameType::Data, flags, stream->id, (sl_uint32)size);
+				pieces.add_NoLock(MemoryData(frameHeader, Http2FrameHeader::HeaderSize));
+				pieces.add_NoLock(Move(piece));
+				sizeBatch += Http2FrameHeader::HeaderSize + size;
+			}
+		}
+		if (stream->flagEndStreamSent) {
+			if (!(stream->flagEndStreamReceived)) {
+				// The request body is not needed any more
+				_resetStream(stream->id, Http2ErrorCode::NoError);
+			}
+			_closeStream(stream);
+		}
+	}
+
+	Memory Http2ServerSession::_encodeResponseHeaders(Http2ServerStream* stream, sl_bool flagEndStream)
+	{
+		HttpServerContext* context = stream->context.get();
+		MemoryOutput block;
+		SLIB_STATIC_STRING(nameStatus, ":status")
+		if (!(m_encoder.encode(block, nameStatus, String::fromUint32((sl_uint32)(context->getResponseCode()))))) {
+			return sl_null;
+		}
+		for (auto& item : context->getResponseHeaders()) {
+			String name = item.key.toLower();
+			if (IsConnectionSpecificField(name)) {
+				continue;
+			}
+			if (!(m_encoder.encode(block, name, item.value))) {
+				return sl_null;
+			}
+		}
+		Memory mem = block.getData();
+		const sl_uint8* data = (const sl_uint8*)(mem.getData());
+		sl_size size = mem.getSize();
+		MemoryOutput frames;
+		Http2FrameType type = Http2FrameType::Headers;
+		sl_uint8 flagsEndStream = flagEndStream ? Http2FrameHeader::FlagEndStream : 0;
+		do {
+			sl_uint32 n = size > m_peerMaxFrameSize ? m_peerMaxFrameSize : (sl_uint32)size;
+			sl_uint8 flags = flagsEndStream;
+			if (n == size) {
+				flags |= Http2FrameHeader::FlagEndHeaders;
+			}
+			sl_uint8 header[Http2FrameHeader::HeaderSize];
+			WriteFrameHeader(header, type, flags, stream->id, n);
+			frames.write(header, sizeof(header));
+			if (n) {
+				frames.write(data, n);
+			}
+			data += n;
+			size -= n;
+			type = Http2FrameType::Continuation;
+			flagsEndStream = 0;
+		} while (size);
+		return frames.getData();
+	}
+
+	void Http2ServerSession::_onWrite(sl_size size, sl_bool flagSuccess)
+	{
+		{
+			ObjectLocker lock(this);
+			m_sizeWriting -= size;
+			if (flagSuccess) {
+				_send();
+			} else {
+				m_flagWriteError = sl_true;
+				m_flagCloseRequested = sl_true;
+			}
+		}
+		_flush();
+		_closeConnectionIfRequested();
+	}
+
+	void Http2ServerSession::_closeConnectionIfRequested()
+	{
+		if (!m_flagCloseRequested) {
+			return;
+		}
+		Ref<HttpServerConnection> connection = m_connection;
+		if (connection.isNotNull()) {
+			connection->close();
+		}
+	}
+
+}
@@ -0,0 +1,241 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_NETWORK_HTTP_SERVER_HTTP2
+#define CHECKHEADER_SLIB_NETWORK_HTTP_SERVER_HTTP2
+
+#include "slib/network/http_server.h"
+#include "slib/network/http2.h"
+
+#include "slib/core/hash_map.h"
+#include "slib/core/queue.h"
+
+namespace slib
+{
+
+	class Http2ServerStream : public Referable
+	{
+	public:
+		sl_uint32 id;
+		Ref<HttpServerContext> context;
+		sl_bool flagClosed;
+
+		// Request
+		sl_bool flagEndStreamReceived;
+		sl_bool flagDispatched;
+		sl_bool flagProcessing; // The context is processed by the server, and `completeContext()` is not called yet
+		sl_bool flagDiscardBody; // Answered before the request body was received
+		sl_int64 contentLength; // -1: not specified
+		sl_uint64 sizeBody;
+		sl_int64 windowReceive;
+		sl_uint32 sizeReceivedUnacked;
+
+		// RFC 9218
+		sl_uint32 urgency;
+		sl_bool flagIncremental;
+
+		// Response
+		sl_bool flagResponding;
+		sl_bool flagHeadersSent;
+		sl_bool flagEndStreamSent;
+		sl_bool flagNoBody;
+		sl_bool flagBodyError;
+		sl_int64 windowSend;
+		LinkedQueue< Ref<AsyncOutputBufferElement> > queueOutput;
+		Ref<AsyncOutputBufferElement> elementOutput;
+		MemoryData dataOutput;
+		Ref<AsyncStream> bodyOutput;
+		sl_uint64 sizeBodyOutput;
+		sl_bool flagReadingBody;
+
+	public:
+		Http2ServerStream(sl_uint32 id);
+
+		~Http2ServerStream();
+
+	};
+
+	/*
+		Serves the HTTP/2 connection on behalf of `HttpServerConnection`.
+		The requests are dispatched through `HttpServerConnection` as the HTTP/1.x requests, and the responses are framed when
+		`completeContext()` is called. The responses are sent by RFC 9218 urgency, where the non-incremental responses are sent
+		one by one in the order of the stream identifiers, and the incremental responses share the connection by the frames.
+	*/
+	class Http2ServerSession : public Object
+	{
+	protected:
+		Http2ServerSession();
+
+		~Http2ServerSession();
+
+	public:
+		static Ref<Http2ServerSession> create(HttpServerConnection* connection);
+
+		// `Upgrade: h2c` with `HTTP2-Settings`. `settings` receives the decoded payload of SETTINGS
+		static sl_bool isUpgradeRequest(HttpServerContext* context, Memory& settings);
+
+	public:
+		// Answers `101 Switching Protocols`, and the upgraded request becomes the stream 1
+		sl_bool startUpgrade(HttpServerContext* context, const Memory& settings);
+
+		// Returns `sl_false` when the connection should stop reading
+		sl_bool processInput(const void* data, sl_size size);
+
+		void completeContext(HttpServerContext* context);
+
+		// Resets the stream of the context whose processing failed. The context is not completed
+		void resetStream(HttpServerContext* context, Http2ErrorCode code);
+
+		sl_bool isActive();
+
+		void close();
+
+	protected:
+		void _sendPreface();
+
+		sl_size _processFrames(const sl_uint8* data, sl_size size, List< Ref<HttpServerContext> >& contexts);
+
+		void _processFrame(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size, List< Ref<HttpServerContext> >& contexts);
+
+		void _onData(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size, List< Ref<HttpServerContext> >& contexts);
+
+		void _onHeaders(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size, List< Ref<HttpServerContext> >& contexts);
+
+		void _onContinuation(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size, List< Ref<HttpServerContext> >& contexts);
+
+		void _onHeaderBlock(List< Ref<HttpServerContext> >& contexts);
+
+		void _onPriority(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size);
+
+		void _onRstStream(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size);
+
+		sl_bool _isResettingRapidly();
+
+		sl_bool _onSettings(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size);
+
+		void _onPing(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size);
+
+		void _onGoAway(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size);
+
+		void _onWindowUpdate(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size);
+
+		void _onPriorityUpdate(const Http2FrameHeader& header, const sl_uint8* payload, sl_uint32 size);
+
+		sl_bool _applySettings(const sl_uint8* payload, sl_uint32 size);
+
+		sl_bool _applyRequestHeaders(Http2ServerStream* stream, List<HpackHeaderField>& fields);
+
+		void _onEndStream(Http2ServerStream* stream, List< Ref<HttpServerContext> >& contexts);
+
+		void _respondError(Http2ServerStream* stream, HttpStatus status);
+
+		void _completeStream(Http2ServerStream* stream);
+
+		void _closeStream(Http2ServerStream* stream);
+
+		void _resetStream(Http2ServerStream* stream, Http2ErrorCode code);
+
+		void _resetStream(sl_uint32 streamId, Http2ErrorCode code);
+
+		void _goAway(Http2ErrorCode code);
+
+		void _writeFrame(Http2FrameType type, sl_uint8 flags, sl_uint32 streamId, const void* payload, sl_uint32 size);
+
+		void _writeWindowUpdate(sl_uint32 streamId, sl_uint32 increment);
+
+		// Queues the frames to be written. Called in the lock
+		void _send();
+
+		// Writes the queued frames out of the lock, because the TLS stream runs the reading callbacks in its own lock
+		void _flush();
+
+		Http2ServerStream* _pickStream();
+
+		sl_bool _isSendable(Http2ServerStream* stream);
+
+		sl_int32 _prepareOutput(Http2ServerStream* stream);
+
+		void _sendFrame(Http2ServerStream* stream, List<MemoryData>& pieces, sl_uint8* frameHeader, sl_size& sizeBatch);
+
+		Memory _encodeResponseHeaders(Http2ServerStream* stream, sl_bool flagEndStream);
+
+		void _onWrite(sl_size size, sl_bool flagSuccess);
+
+		void _onReadBody(Http2ServerStream* stream, Memory& buf, AsyncStreamResult& result);
+
+		void _closeConnectionIfRequested();
+
+	protected:
+		WeakRef<HttpServerConnection> m_connection;
+		Ref<AsyncStream> m_io;
+
+		sl_uint32 m_maxConcurrentStreams;
+		sl_uint32 m_maxResetRate;
+		sl_uint32 m_initialWindowSize;
+		sl_uint64 m_maxRequestHeadersSize;
+		sl_uint64 m_maxRequestBodySize;
+		sl_bool m_flagProcessByThreads;
+
+		sl_bool m_flagClosed;
+		sl_bool m_flagPrefaceSent;
+		sl_bool m_flagPrefaceReceived;
+		sl_bool m_flagSettingsReceived;
+		sl_bool m_flagGoingAway;
+		sl_bool m_flagWriteError;
+		sl_bool m_flagCloseRequested;
+
+		List<sl_uint8> m_bufInput;
+
+		sl_uint32 m_streamIdHeaders; // Stream receiving CONTINUATION frames. 0: none
+		sl_bool m_flagHeadersEndStream;
+		Http2ErrorCode m_errorHeaders;
+		MemoryOutput m_headerBlock;
+		sl_uint32 m_lastStreamId;
+
+		HpackEncoder m_encoder;
+		HpackDecoder m_decoder;
+
+		HashMap< sl_uint32, Ref<Http2ServerStream> > m_streams;
+		// Streams closed (reset by the client) while their contexts are processed. Counted as the concurrent streams until `completeContext()`
+		sl_uint32 m_nClosedProcessingStreams;
+		sl_uint64 m_timeResetCounting;
+		sl_uint32 m_nResetsCounted;
+		List< Ref<Http2ServerStream> > m_streamsSending;
+		sl_uint32 m_lastIncrementalStreamId;
+
+		sl_int64 m_windowSend;
+		sl_int64 m_windowReceive;
+		sl_uint32 m_sizeReceivedUnacked;
+		sl_uint32 m_peerInitialWindowSize;
+		sl_uint32 m_peerMaxFrameSize;
+
+		MemoryOutput m_control;
+		sl_size m_sizeWriting;
+		sl_bool m_flagSending;
+		LinkedQueue< Ref<Referable> > m_queueWriting;
+		sl_bool m_flagFlushing;
+
+	};
+
+}
+
+#endif
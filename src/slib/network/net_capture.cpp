@@ -32,6 +32,19 @@
 #include "slib/network/tcpip.h"
 #include "slib/network/ethernet.h"
 
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+#	include <linux/if_packet.h>
+#	include <linux/if_ether.h>
+#	include <sys/socket.h>
+#	include <sys/mman.h>
+#	include <arpa/inet.h>
+#	include <unistd.h>
+#	include <errno.h>
+#	ifndef PACKET_FANOUT_FLAG_UNIQUEID
+#		define PACKET_FANOUT_FLAG_UNIQUEID 0x2000
+#	endif
+#endif
+
 #define TAG "NetCapture"
 
 #define MAX_PACKET_SIZE 65535
@@ -54,6 +67,21 @@ namespace slib
 		flagPromiscuous = sl_false;
 
 		flagAutoStart = sl_true;
+
+		ringBlockSize = 0x100000;
+		ringBlockCount = 64;
+		ringBlockTimeout = 10;
+		threadCount = 1;
+	}
+
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(NetCaptureStatistics)
+
+	NetCaptureStatistics::NetCaptureStatistics()
+	{
+		countPackets = 0;
+		countDrops = 0;
+		countFreezes = 0;
 	}
 	
 	
@@ -78,6 +106,11 @@ namespace slib
 		return sl_null;
 	}
 
+	sl_bool NetCapture::getStatistics(NetCaptureStatistics& _out)
+	{
+		return sl_false;
+	}
+
 	const String& NetCapture::getDeviceName()
 	{
 		return m_deviceName;
@@ -111,12 +144,28 @@ namespace slib
 	{
 		m_deviceName = param.deviceName.toString();
 		m_onCapturePacket = param.onCapturePacket;
+		m_onCapturePackets = param.onCapturePackets;
 		m_onError = param.onError;
 	}
 	
 	void NetCapture::_onCapturePacket(NetCapturePacket& packet)
 	{
-		m_onCapturePacket(this, packet);
+		if (m_onCapturePackets.isNotNull()) {
+			m_onCapturePackets(this, &packet, 1);
+		} else {
+			m_onCapturePacket(this, packet);
+		}
+	}
+
+	void NetCapture::_onCapturePackets(NetCapturePacket* packets, sl_uint32 nPackets)
+	{
+		if (m_onCapturePackets.isNotNull()) {
+			m_onCapturePackets(this, packets, nPackets);
+		} else {
+			for (sl_uint32 i = 0; i < nPackets; i++) {
+				m_onCapturePacket(this, packets[i]);
+			}
+		}
 	}
 
 	void NetCapture::_onError()
@@ -129,6 +178,47 @@ namespace slib
 		namespace net_capture
 		{
 
+			static sl_bool SendL2Packet(const Socket& socket, NetworkLinkDeviceType deviceType, sl_uint32 iface, const void* buf, sl_uint32 size)
+			{
+				if (iface == 0) {
+					return sl_false;
+				}
+				L2PacketInfo info;
+				info.type = L2PacketType::OutGoing;
+				info.iface = iface;
+				if (deviceType == NetworkLinkDeviceType::Ethernet) {
+					EthernetFrame* frame = (EthernetFrame*)buf;
+					if (size < EthernetFrame::HeaderSize) {
+						return sl_false;
+					}
+					info.protocol = frame->getProtocol();
+					info.setMacAddress(frame->getDestinationAddress());
+				} else {
+					info.protocol = NetworkLinkProtocol::IPv4;
+					info.clearAddress();
+				}
+				sl_uint32 ret = socket.sendPacket(buf, size, info);
+				return ret == size;
+			}
+
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+			// The kernel resets the counters on every read
+			static void AddPacketStatistics(const Socket& socket, sl_bool flagRing, NetCaptureStatistics& statistics)
+			{
+				struct tpacket_stats_v3 stats;
+				Base::zeroMemory(&stats, sizeof(stats));
+				socklen_t len = flagRing ? sizeof(struct tpacket_stats_v3) : sizeof(struct tpacket_stats);
+				if (!(getsockopt((int)(socket.get()), SOL_PACKET, PACKET_STATISTICS, &stats, &len))) {
+					// `tp_packets` includes the dropped packets
+					statistics.countPackets += stats.tp_packets - stats.tp_drops;
+					statistics.countDrops += stats.tp_drops;
+					if (flagRing) {
+						statistics.countFreezes += stats.tp_freeze_q_cnt;
+					}
+				}
+			}
+#endif
+
 			class RawPacketCapture : public NetCapture
 			{
 			public:
@@ -141,6 +231,8 @@ namespace slib
 				
 				sl_bool m_flagInit;
 				sl_bool m_flagRunning;
+
+				NetCaptureStatistics m_statistics;
 				
 			public:
 				RawPacketCapture()
@@ -297,31 +389,24 @@ namespace slib
 				
 				sl_bool sendPacket(const void* buf, sl_uint32 size)
 				{
-					if (m_ifaceIndex == 0) {
-						return sl_false;
-					}
 					if (m_flagInit) {
-						L2PacketInfo info;
-						info.type = L2PacketType::OutGoing;
-						info.iface = m_ifaceIndex;
-						if (m_deviceType == NetworkLinkDeviceType::Ethernet) {
-							EthernetFrame* frame = (EthernetFrame*)buf;
-							if (size < EthernetFrame::HeaderSize) {
-								return sl_false;
-							}
-							info.protocol = frame->getProtocol();
-							info.setMacAddress(frame->getDestinationAddress());
-						} else {
-							info.protocol = NetworkLinkProtocol::IPv4;
-							info.clearAddress();
-						}
-						sl_uint32 ret = m_socket.sendPacket(buf, size, info);
-						if (ret == size) {
-							return sl_true;
-						}
+						return SendL2Packet(m_socket, m_deviceType, m_ifaceIndex, buf, size);
 					}
 					return sl_false;
 				}
+
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+				sl_bool getStatistics(NetCaptureStatistics& _out) override
+				{
+					ObjectLocker lock(this);
+					if (!m_flagInit) {
+						return sl_false;
+					}
+					AddPacketStatistics(m_socket, sl_false, m_statistics);
+					_out = m_statistics;
+					return sl_true;
+				}
+#endif
 				
 			};
 
@@ -545,6 +630,371 @@ namespace slib
 				
 			};
 
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+
+			static Socket OpenPacketSocket(NetworkLinkDeviceType deviceType)
+			{
+				Socket socket;
+				if (deviceType == NetworkLinkDeviceType::Raw) {
+					socket = Socket::openPacketDatagram(NetworkLinkProtocol::All);
+				} else {
+					socket = Socket::openPacketRaw(NetworkLinkProtocol::All);
+				}
+				return socket;
+			}
+
+			static sl_bool BindPacketSocket(const Socket& socket, sl_uint32 iface)
+			{
+				struct sockaddr_ll addr;
+				Base::zeroMemory(&addr, sizeof(addr));
+				addr.sll_family = AF_PACKET;
+				addr.sll_protocol = htons(ETH_P_ALL);
+				addr.sll_ifindex = (int)iface;
+				return !(bind((int)(socket.get()), (struct sockaddr*)&addr, sizeof(addr)));
+			}
+
+			static sl_bool JoinFanoutGroup(const Socket& socket, sl_uint32 id, sl_uint32 type)
+			{
+				int arg = (int)((id & 0xFFFF) | (type << 16));
+				return !(setsockopt((int)(socket.get()), SOL_PACKET, PACKET_FANOUT, &arg, sizeof(arg)));
+			}
+
+			class PacketRing : public Referable
+			{
+			public:
+				Socket socket;
+				sl_uint8* blocks;
+				sl_uint32 sizeBlock;
+				sl_uint32 nBlocks;
+				Ref<Thread> thread;
+
+			public:
+				PacketRing()
+				{
+					blocks = sl_null;
+					sizeBlock = 0;
+					nBlocks = 0;
+				}
+
+				~PacketRing()
+				{
+					if (blocks) {
+						munmap(blocks, (size_t)sizeBlock * nBlocks);
+					}
+				}
+
+			public:
+				static Ref<PacketRing> open(const NetCaptureParam& param, NetworkLinkDeviceType deviceType, sl_uint32 iface)
+				{
+					Socket socket = OpenPacketSocket(deviceType);
+					if (socket.isNone()) {
+						LogError(TAG, "Failed to create Packet socket");
+						return sl_null;
+					}
+					int fd = (int)(socket.get());
+					int version = TPACKET_V3;
+					if (setsockopt(fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version))) {
+						LogError(TAG, "TPACKET_V3 is not supported");
+						return sl_null;
+					}
+
+					sl_uint32 sizePage = (sl_uint32)(getpagesize());
+					sl_uint32 sizeBlock = param.ringBlockSize;
+					sl_uint32 nBlocks = param.ringBlockCount;
+					if (sizeBlock < sizePage) {
+						sizeBlock = sizePage;
+					}
+					sizeBlock = (sl_uint32)(Math::roundUpToPowerOfTwo(sizeBlock));
+					if (!nBlocks) {
+						nBlocks = 1;
+					}
+					struct tpacket_req3 req;
+					Base::zeroMemory(&req, sizeof(req));
+					req.tp_block_size = sizeBlock;
+					req.tp_block_nr = nBlocks;
+					req.tp_frame_size = TPACKET_ALIGNMENT << 7;
+					req.tp_frame_nr = sizeBlock / req.tp_frame_size * nBlocks;
+					req.tp_retire_blk_tov = param.ringBlockTimeout;
+					if (setsockopt(fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req))) {
+						LogError(TAG, "Failed to set up the packet ring: %d blocks of %d bytes", nBlocks, sizeBlock);
+						return sl_null;
+					}
+
+					Ref<PacketRing> ret = new PacketRing;
+					if (ret.isNull()) {
+						return sl_null;
+					}
+					void* blocks = mmap(sl_null, (size_t)sizeBlock * nBlocks, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+					if (blocks == MAP_FAILED) {
+						LogError(TAG, "Failed to map the packet ring");
+						return sl_null;
+					}
+					ret->blocks = (sl_uint8*)blocks;
+					ret->sizeBlock = sizeBlock;
+					ret->nBlocks = nBlocks;
+
+					if (!(BindPacketSocket(socket, iface))) {
+						LogError(TAG, "Failed to bind the packet socket");
+						return sl_null;
+					}
+					socket.setNonBlockingMode();
+					ret->socket = Move(socket);
+					return ret;
+				}
+
+				sl_bool joinFanoutGroup(sl_uint32 id)
+				{
+					return JoinFanoutGroup(socket, id, PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG);
+				}
+
+				// Creates a fanout group of which identifier is not used by the other groups in the network namespace
+				sl_bool createFanoutGroup(NetworkLinkDeviceType deviceType, sl_uint32 iface, sl_uint32& outId)
+				{
+					if (JoinFanoutGroup(socket, 0, PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG | PACKET_FANOUT_FLAG_UNIQUEID)) {
+						// The identifier is assigned by the kernel (Linux 4.13 or later)
+						int arg = 0;
+						socklen_t len = sizeof(arg);
+						if (getsockopt((int)(socket.get()), SOL_PACKET, PACKET_FANOUT, &arg, &len)) {
+							return sl_false;
+						}
+						outId = (sl_uint32)arg & 0xFFFF;
+						return sl_true;
+					}
+					if (errno != EINVAL) {
+						return sl_false;
+					}
+					// A group of the same type would be joined silently, so a probe socket tries to create a group of another type by the identifier
+					sl_uint32 start = (sl_uint32)getpid();
+					for (sl_uint32 i = 0; i < 0x10000; i++) {
+						sl_uint32 id = (start + i) & 0xFFFF;
+						sl_bool flagFree = sl_false;
+						{
+							Socket probe = OpenPacketSocket(deviceType);
+							if (probe.isNone() || !(BindPacketSocket(probe, iface))) {
+								return sl_false;
+							}
+							flagFree = JoinFanoutGroup(probe, id, PACKET_FANOUT_CPU);
+						}
+						if (flagFree && joinFanoutGroup(id)) {
+							outId = id;
+							return sl_true;
+						}
+					}
+					return sl_false;
+				}
+
+			};
+
+			class PacketRingCapture : public NetCapture
+			{
+			public:
+				List< Ref<PacketRing> > m_rings;
+				NetworkLinkDeviceType m_deviceType;
+				sl_uint32 m_ifaceIndex;
+
+				sl_bool m_flagInit;
+				sl_bool m_flagRunning;
+
+				NetCaptureStatistics m_statistics;
+
+			public:
+				PacketRingCapture()
+				{
+					m_deviceType = NetworkLinkDeviceType::Ethernet;
+					m_ifaceIndex = 0;
+
+					m_flagInit = sl_false;
+					m_flagRunning = sl_false;
+				}
+
+				~PacketRingCapture()
+				{
+					release();
+				}
+
+			public:
+				static Ref<PacketRingCapture> create(const NetCaptureParam& param)
+				{
+					sl_uint32 iface = 0;
+					StringCstr deviceName = param.deviceName;
+					if (deviceName.isNotEmpty()) {
+						iface = Network::getInterfaceIndexFromName(deviceName);
+						if (iface == 0) {
+							LogError(TAG, "Failed to find the interface index of device: %s", deviceName);
+							return sl_null;
+						}
+					}
+					NetworkLinkDeviceType deviceType = param.preferedLinkDeviceType;
+					if (deviceType != NetworkLinkDeviceType::Raw) {
+						deviceType = NetworkLinkDeviceType::Ethernet;
+					}
+					sl_uint32 nThreads = param.threadCount;
+					if (!nThreads) {
+						nThreads = 1;
+					}
+					sl_uint32 fanoutId = 0;
+					Ref<PacketRingCapture> ret = new PacketRingCapture;
+					if (ret.isNull()) {
+						return sl_null;
+					}
+					ret->_initWithParam(param);
+					ret->m_deviceType = deviceType;
+					ret->m_ifaceIndex = iface;
+					for (sl_uint32 i = 0; i < nThreads; i++) {
+						Ref<PacketRing> ring = PacketRing::open(param, deviceType, iface);
+						if (ring.isNull()) {
+							return sl_null;
+						}
+						if (nThreads > 1) {
+							if (i ? !(ring->joinFanoutGroup(fanoutId)) : !(ring->createFanoutGroup(deviceType, iface, fanoutId))) {
+								LogError(TAG, "Failed to join the fanout group");
+								return sl_null;
+							}
+						}
+						ring->thread = Thread::create(SLIB_BIND_MEMBER(void(), ret.get(), _run, ring.get()));
+						if (ring->thread.isNull()) {
+							LogError(TAG, "Failed to create thread");
+							return sl_null;
+						}
+						if (!i && iface > 0 && param.flagPromiscuous) {
+							if (!(ring->socket.setPromiscuousMode(deviceName, sl_true))) {
+								Log(TAG, "Failed to set promiscuous mode to the network device: %s", deviceName);
+							}
+						}
+						ret->m_rings.add_NoLock(Move(ring));
+					}
+					ret->m_flagInit = sl_true;
+					if (param.flagAutoStart) {
+						ret->start();
+					}
+					return ret;
+				}
+
+				void release() override
+				{
+					ObjectLocker lock(this);
+					if (!m_flagInit) {
+						return;
+					}
+					m_flagInit = sl_false;
+
+					m_flagRunning = sl_false;
+					ListElements< Ref<PacketRing> > rings(m_rings);
+					for (sl_size i = 0; i < rings.count; i++) {
+						rings[i]->thread->finish();
+					}
+					for (sl_size i = 0; i < rings.count; i++) {
+						rings[i]->thread->finishAndWait();
+					}
+					m_rings.setNull();
+				}
+
+				void start() override
+				{
+					ObjectLocker lock(this);
+					if (!m_flagInit) {
+						return;
+					}
+					if (m_flagRunning) {
+						return;
+					}
+					ListElements< Ref<PacketRing> > rings(m_rings);
+					for (sl_size i = 0; i < rings.count; i++) {
+						rings[i]->thread->start();
+					}
+					m_flagRunning = sl_true;
+				}
+
+				sl_bool isRunning() override
+				{
+					return m_flagRunning;
+				}
+
+				void _run(PacketRing* ring)
+				{
+					Thread* thread = Thread::getCurrent();
+					if (!thread) {
+						return;
+					}
+					Ref<SocketEvent> event = SocketEvent::createRead(ring->socket);
+					if (event.isNull()) {
+						return;
+					}
+					List<NetCapturePacket> listPackets;
+					sl_uint32 indexBlock = 0;
+					while (thread->isNotStopping()) {
+						struct tpacket_block_desc* desc = (struct tpacket_block_desc*)(ring->blocks + (sl_size)indexBlock * ring->sizeBlock);
+						volatile sl_uint32& status = *((volatile sl_uint32*)&(desc->hdr.bh1.block_status));
+						if (!(status & TP_STATUS_USER)) {
+							event->wait(100);
+							continue;
+						}
+						__sync_synchronize();
+						sl_uint32 nPackets = desc->hdr.bh1.num_pkts;
+						if (nPackets) {
+							if (listPackets.getCount() < nPackets) {
+								listPackets.setCount_NoLock(nPackets);
+							}
+							NetCapturePacket* packets = listPackets.getData();
+							if (packets) {
+								sl_uint8* p = (sl_uint8*)desc + desc->hdr.bh1.offset_to_first_pkt;
+								for (sl_uint32 i = 0; i < nPackets; i++) {
+									struct tpacket3_hdr* hdr = (struct tpacket3_hdr*)p;
+									NetCapturePacket& packet = packets[i];
+									// For the datagram socket, `tp_mac` is the offset of the network header
+									packet.data = p + hdr->tp_mac;
+									packet.length = hdr->tp_snaplen;
+									packet.time = (sl_int64)(hdr->tp_sec) * 1000000 + hdr->tp_nsec / 1000;
+									p += hdr->tp_next_offset;
+								}
+								_onCapturePackets(packets, nPackets);
+							}
+						}
+						// Returns the block to the kernel
+						__sync_synchronize();
+						status = TP_STATUS_KERNEL;
+						indexBlock++;
+						if (indexBlock >= ring->nBlocks) {
+							indexBlock = 0;
+						}
+					}
+				}
+
+				NetworkLinkDeviceType getLinkType() override
+				{
+					return m_deviceType;
+				}
+
+				sl_bool sendPacket(const void* buf, sl_uint32 size) override
+				{
+					ObjectLocker lock(this);
+					if (m_flagInit) {
+						Ref<PacketRing> ring = m_rings.getValueAt_NoLock(0);
+						if (ring.isNotNull()) {
+							return SendL2Packet(ring->socket, m_deviceType, m_ifaceIndex, buf, size);
+						}
+					}
+					return sl_false;
+				}
+
+				sl_bool getStatistics(NetCaptureStatistics& _out) override
+				{
+					ObjectLocker lock(this);
+					if (!m_flagInit) {
+						return sl_false;
+					}
+					ListElements< Ref<PacketRing> > rings(m_rings);
+					for (sl_size i = 0; i < rings.count; i++) {
+						AddPacketStatistics(rings[i]->socket, sl_true, m_statistics);
+					}
+					_out = m_statistics;
+					return sl_true;
+				}
+
+			};
+
+#endif
+
 		}
 	}
 
@@ -560,6 +1010,15 @@ namespace slib
 	{
 		return RawIPv4Capture::create(param);
 	}
+
+	Ref<NetCapture> NetCapture::createPacketRing(const NetCaptureParam& param)
+	{
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+		return PacketRingCapture::create(param);
+#else
+		return sl_null;
+#endif
+	}
 	
 	
 	LinuxCookedPacketType LinuxCookedFrame::getPacketType() const
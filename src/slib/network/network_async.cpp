@@ -24,6 +24,7 @@
 
 #include "network_async.h"
 #include "slib/core/handle_ptr.h"
+#include "slib/core/memory_view.h"
 
 namespace slib
 {
@@ -34,6 +35,8 @@ namespace slib
 	{
 		m_flagRequestConnect = sl_false;
 		m_flagSupportingConnect = sl_true;
+		m_flagCorked = sl_false;
+		m_timeoutConnect = 0;
 	}
 
 	AsyncTcpSocketInstance::~AsyncTcpSocketInstance()
@@ -58,6 +61,21 @@ namespace slib
 		return sl_true;
 	}
 
+	sl_bool AsyncTcpSocketInstance::isCorked()
+	{
+		return m_flagCorked;
+	}
+
+	void AsyncTcpSocketInstance::setCorked(sl_bool flag)
+	{
+		m_flagCorked = flag;
+	}
+
+	void AsyncTcpSocketInstance::setConnectTimeout(sl_uint32 timeout)
+	{
+		m_timeoutConnect = timeout;
+	}
+
 	void AsyncTcpSocketInstance::onClose()
 	{
 		_free();
@@ -74,6 +92,14 @@ namespace slib
 			processStreamResult(m_requestWriting.get(), 0, AsyncStreamResultCode::Closed);
 			m_requestWriting.setNull();
 		}
+		if (m_requestsWriting.isNotNull()) {
+			List< Ref<AsyncStreamRequest> > requests = Move(m_requestsWriting);
+			ListElements< Ref<AsyncStreamRequest> > items(requests);
+			for (sl_size i = 0; i < items.count; i++) {
+				items[i]->sizeWritten = 0;
+				processStreamResult(items[i].get(), 0, AsyncStreamResultCode::Closed);
+			}
+		}
 		sl_socket socket = getSocket();
 		if (socket != SLIB_SOCKET_INVALID_HANDLE) {
 			Socket::close(socket);
@@ -89,6 +115,83 @@ namespace slib
 		}
 	}
 
+	void AsyncTcpSocketInstance::_gatherWriting()
+	{
+		sl_size nQueue = getWriteRequestCount();
+		while (nQueue > 0 && m_requestsWriting.getCount() < ASYNC_TCP_MAX_WRITE_VECTOR) {
+			nQueue--;
+			Ref<AsyncStreamRequest> request;
+			popWriteRequest(request);
+			if (request.isNotNull()) {
+				m_requestsWriting.add_NoLock(Move(request));
+			}
+		}
+	}
+
+	sl_uint32 AsyncTcpSocketInstance::_getWritingViews(MemoryView* views)
+	{
+		Ref<AsyncStreamRequest>* requests = m_requestsWriting.getData();
+		sl_size n = m_requestsWriting.getCount();
+		for (sl_size i = 0; i < n; i++) {
+			AsyncStreamRequest* request = requests[i].get();
+			char* data = (char*)(request->data);
+			sl_size size = request->size;
+			if (data && size > request->sizeWritten) {
+				views[i].data = data + request->sizeWritten;
+				views[i].size = size - request->sizeWritten;
+			} else {
+				views[i].data = sl_null;
+				views[i].size = 0;
+			}
+		}
+		return (sl_uint32)n;
+	}
+
+	void AsyncTcpSocketInstance::_onWritten(sl_size size)
+	{
+		Ref<AsyncStreamRequest>* requests = m_requestsWriting.getData();
+		sl_size nRequests = m_requestsWriting.getCount();
+		sl_size nCompleted = 0;
+		while (nCompleted < nRequests) {
+			AsyncStreamRequest* request = requests[nCompleted].get();
+			sl_size sizeRemain = 0;
+			if (request->data && request->size > request->sizeWritten) {
+				sizeRemain = request->size - request->sizeWritten;
+			}
+			if (size < sizeRemain) {
+				request->sizeWritten += size;
+				break;
+			}
+			size -= sizeRemain;
+			nCompleted++;
+		}
+		_completeWriting(nCompleted, AsyncStreamResultCode::Success);
+	}
+
+	void AsyncTcpSocketInstance::_completeWriting(sl_size count, AsyncStreamResultCode code)
+	{
+		if (!count) {
+			return;
+		}
+		// Detaches the requests before the callbacks, which can write again or close the socket
+		Ref<AsyncStreamRequest> requests[ASYNC_TCP_MAX_WRITE_VECTOR];
+		Ref<AsyncStreamRequest>* src = m_requestsWriting.getData();
+		for (sl_size i = 0; i < count; i++) {
+			requests[i] = Move(src[i]);
+		}
+		m_requestsWriting.removeRange_NoLock(0, count);
+		for (sl_size i = 0; i < count; i++) {
+			AsyncStreamRequest* request = requests[i].get();
+			sl_size sizeWritten = request->sizeWritten;
+			request->sizeWritten = 0;
+			if (code == AsyncStreamResultCode::Success) {
+				processStreamResult(request, request->data ? request->size : 0, code);
+			} else {
+				processStreamResult(request, sizeWritten, code);
+			}
+		}
+	}
+
 
 	SLIB_DEFINE_MOVEONLY_CLASS_DEFAULT_MEMBERS(AsyncTcpSocketParam)
 	
@@ -96,6 +199,7 @@ namespace slib
 	{
 		flagIPv6 = sl_false;
 		flagLogError = sl_true;
+		connectTimeout = 0;
 	}
 
 
@@ -138,15 +242,17 @@ namespace slib
 			}
 		}
 
-		Ref<AsyncTcpSocketInstance> instance = _createInstance(Move(socket), flagIPv6);
-		if (instance.isNotNull()) {
-			Ref<AsyncIoLoop> loop = param.ioLoop;
+		Ref<AsyncIoLoop> loop = param.ioLoop;
+		if (loop.isNull()) {
+			loop = AsyncIoLoop::getDefault();
 			if (loop.isNull()) {
-				loop = AsyncIoLoop::getDefault();
-				if (loop.isNull()) {
-					return sl_null;
-				}
+				return sl_null;
 			}
+		}
+
+		Ref<AsyncTcpSocketInstance> instance = _createInstance(Move(socket), flagIPv6, loop);
+		if (instance.isNotNull()) {
+			instance->setConnectTimeout(param.connectTimeout);
 			Ref<AsyncTcpSocket> ret = new AsyncTcpSocket;
 			if (ret.isNotNull()) {
 				if (ret->_initialize(instance.get(), AsyncIoMode::InOut, loop)) {
@@ -234,6 +340,31 @@ namespace slib
 	{
 		return AsyncStreamBase::write(mem.getData(), mem.getSize(), callback, mem.ref.get());
 	}
+
+	sl_bool AsyncTcpSocket::sendVector(const MemoryView* buffers, sl_size count, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject)
+	{
+		return AsyncStreamBase::writeVector(buffers, count, callback, userObject);
+	}
+
+	void AsyncTcpSocket::cork()
+	{
+		Ref<AsyncTcpSocketInstance> instance = _getIoInstance();
+		if (instance.isNotNull()) {
+			instance->setCorked(sl_true);
+		}
+	}
+
+	void AsyncTcpSocket::uncork()
+	{
+		Ref<AsyncTcpSocketInstance> instance = _getIoInstance();
+		if (instance.isNotNull()) {
+			instance->setCorked(sl_false);
+			Ref<AsyncIoLoop> loop = getIoLoop();
+			if (loop.isNotNull()) {
+				loop->requestOrder(instance.get());
+			}
+		}
+	}
 	
 	Ref<AsyncTcpSocketInstance> AsyncTcpSocket::_getIoInstance()
 	{
@@ -373,15 +504,15 @@ namespace slib
 		}
 		
 		if (socket.listen()) {
-			Ref<AsyncTcpServerInstance> instance = _createInstance(Move(socket), flagIPv6);
-			if (instance.isNotNull()) {
-				Ref<AsyncIoLoop> loop = param.ioLoop;
+			Ref<AsyncIoLoop> loop = param.ioLoop;
+			if (loop.isNull()) {
+				loop = AsyncIoLoop::getDefault();
 				if (loop.isNull()) {
-					loop = AsyncIoLoop::getDefault();
-					if (loop.isNull()) {
-						return sl_null;
-					}
+					return sl_null;
 				}
+			}
+			Ref<AsyncTcpServerInstance> instance = _createInstance(Move(socket), flagIPv6, loop);
+			if (instance.isNotNull()) {
 				Ref<AsyncTcpServer> ret = new AsyncTcpServer;
 				if (ret.isNotNull()) {
 					ret->m_onAccept = param.onAccept;
@@ -463,6 +594,9 @@ namespace slib
 	AsyncUdpSocketInstance::AsyncUdpSocketInstance()
 	{
 		m_flagRunning = sl_false;
+		m_packetSize = 0;
+		m_batchCount = 1;
+		m_flagReceiveOffload = sl_false;
 	}
 
 	AsyncUdpSocketInstance::~AsyncUdpSocketInstance()
@@ -513,6 +647,68 @@ namespace slib
 		}
 	}
 
+	void AsyncUdpSocketInstance::_onReceiveBatch(SocketMessage* messages, sl_uint32 count)
+	{
+		// Drops the truncated datagrams
+		sl_uint32 n = 0;
+		for (sl_uint32 i = 0; i < count; i++) {
+			if (!(messages[i].flagTruncated)) {
+				if (n != i) {
+					messages[n] = messages[i];
+				}
+				n++;
+			}
+		}
+		if (!n) {
+			return;
+		}
+		count = n;
+		Ref<AsyncUdpSocket> object = Ref<AsyncUdpSocket>::from(getObject());
+		if (object.isNotNull()) {
+			object->_onReceiveBatch(messages, count);
+		}
+	}
+
+	void AsyncUdpSocketInstance::_onReceiveSegments(SocketMessage* messages, sl_uint32 nMessages)
+	{
+		SocketMessage* segments = m_segments.getData();
+		if (!segments) {
+			_onReceiveBatch(messages, nMessages);
+			return;
+		}
+		sl_uint32 nSegments = 0;
+		for (sl_uint32 i = 0; i < nMessages; i++) {
+			SocketMessage& message = messages[i];
+			if (message.flagTruncated) {
+				// The last segments are lost, and the remaining one would be cut
+				continue;
+			}
+			sl_uint32 sizeSegment = message.segmentSize;
+			if (!sizeSegment) {
+				sizeSegment = message.size;
+			}
+			sl_uint32 offset = 0;
+			do {
+				if (nSegments == ASYNC_UDP_MAX_RECEIVE_BATCH) {
+					_onReceiveBatch(segments, nSegments);
+					nSegments = 0;
+				}
+				SocketMessage& segment = segments[nSegments];
+				segment.address = message.address;
+				segment.data = (sl_uint8*)(message.data) + offset;
+				sl_uint32 n = message.size - offset;
+				segment.size = n > sizeSegment ? sizeSegment : n;
+				segment.segmentSize = 0;
+				segment.flagTruncated = sl_false;
+				offset += segment.size;
+				nSegments++;
+			} while (offset < message.size);
+		}
+		if (nSegments) {
+			_onReceiveBatch(segments, nSegments);
+		}
+	}
+
 	void AsyncUdpSocketInstance::_onError()
 	{
 		Ref<AsyncUdpSocket> object = Ref<AsyncUdpSocket>::from(getObject());
@@ -530,6 +726,8 @@ namespace slib
 		flagAutoStart = sl_true;
 		flagLogError = sl_false;
 		packetSize = 65536;
+		receiveBatchCount = 1;
+		flagReceiveOffload = sl_false;
 	}
 
 
@@ -548,6 +746,10 @@ namespace slib
 		if (param.packetSize < 1) {
 			return sl_null;
 		}
+		// A coalesced message can hold up to 64KB, and the kernel truncates it to the buffer
+		if (param.flagReceiveOffload && param.packetSize < 65536) {
+			param.packetSize = 65536;
+		}
 		
 		Socket& socket = param.socket;
 		if (socket.isNone()) {
@@ -584,19 +786,25 @@ namespace slib
 		if (param.flagBroadcast) {
 			socket.setOption_Broadcast(sl_true);
 		}
+		if (param.flagReceiveOffload) {
+			socket.setOption_UdpGro(sl_true);
+		}
 		
-		Ref<AsyncUdpSocketInstance> instance = _createInstance(Move(socket), param.packetSize);
-		if (instance.isNotNull()) {
-			Ref<AsyncIoLoop> loop = param.ioLoop;
+		Ref<AsyncIoLoop> loop = param.ioLoop;
+		if (loop.isNull()) {
+			loop = AsyncIoLoop::getDefault();
 			if (loop.isNull()) {
-				loop = AsyncIoLoop::getDefault();
-				if (loop.isNull()) {
-					return sl_null;
-				}
+				return sl_null;
 			}
+		}
+		
+		Ref<AsyncUdpSocketInstance> instance = _createInstance(Move(socket), param, loop);
+		if (instance.isNotNull()) {
 			Ref<AsyncUdpSocket> ret = new AsyncUdpSocket;
 			if (ret.isNotNull()) {
 				ret->m_onReceiveFrom = param.onReceiveFrom;
+				ret->m_onReceiveBatch = param.onReceiveBatch;
+				ret->m_onError = param.onError;
 				instance->setObject(ret.get());
 				ret->setIoInstance(instance.get());
 				ret->setIoLoop(loop);
@@ -685,6 +893,27 @@ namespace slib
 	{
 		return sendTo(addressTo, mem.data, (sl_uint32)(mem.size));
 	}
+
+	sl_uint32 AsyncUdpSocket::sendToBatch(const SocketMessage* messages, sl_uint32 count)
+	{
+		HandlePtr<Socket> socket(getSocket());
+		if (socket->isNotNone()) {
+			sl_int32 n = socket->sendToBatch(messages, count);
+			if (n > 0) {
+				return (sl_uint32)n;
+			}
+		}
+		return 0;
+	}
+
+	sl_bool AsyncUdpSocket::sendToSegmented(const SocketAddress& addressTo, const void* data, sl_size size, sl_uint32 segmentSize)
+	{
+		HandlePtr<Socket> socket(getSocket());
+		if (socket->isNotNone()) {
+			return socket->sendToSegmented(addressTo, data, size, segmentSize) == (sl_int32)size;
+		}
+		return sl_false;
+	}
 	
 	Ref<AsyncUdpSocketInstance> AsyncUdpSocket::_getIoInstance()
 	{
@@ -693,7 +922,27 @@ namespace slib
 
 	void AsyncUdpSocket::_onReceive(SocketAddress& address, void* data, sl_uint32 sizeReceived)
 	{
-		m_onReceiveFrom(this, address, data, sizeReceived);
+		if (m_onReceiveBatch.isNotNull()) {
+			SocketMessage message;
+			message.address = address;
+			message.data = data;
+			message.size = sizeReceived;
+			m_onReceiveBatch(this, &message, 1);
+		} else {
+			m_onReceiveFrom(this, address, data, sizeReceived);
+		}
+	}
+
+	void AsyncUdpSocket::_onReceiveBatch(SocketMessage* messages, sl_uint32 count)
+	{
+		if (m_onReceiveBatch.isNotNull()) {
+			m_onReceiveBatch(this, messages, count);
+		} else {
+			for (sl_uint32 i = 0; i < count; i++) {
+				SocketMessage& message = messages[i];
+				m_onReceiveFrom(this, message.address, message.data, message.size);
+			}
+		}
 	}
 
 	void AsyncUdpSocket::_onError()
@@ -30,6 +30,8 @@
 #define TAG "AsyncSocket"
 
 #define ASYNC_UDP_PACKET_SIZE 65535
+#define ASYNC_UDP_MAX_RECEIVE_BATCH 64
+#define ASYNC_TCP_MAX_WRITE_VECTOR 64
 
 namespace slib
 {
@@ -50,12 +52,29 @@ namespace slib
 		
 	public:
 		sl_bool connect(const SocketAddress& address);
+
+		sl_bool isCorked();
+
+		void setCorked(sl_bool flag);
+
+		void setConnectTimeout(sl_uint32 timeout);
 		
 	protected:
 		void onClose() override;
 
 		void _onConnect(sl_bool flagError);
 
+		// Moves the queued write requests to `m_requestsWriting`
+		void _gatherWriting();
+
+		// Fills the unwritten parts of `m_requestsWriting`
+		sl_uint32 _getWritingViews(MemoryView* views);
+
+		// Completes the requests covered by `size` bytes, from the front of `m_requestsWriting`
+		void _onWritten(sl_size size);
+
+		void _completeWriting(sl_size count, AsyncStreamResultCode code);
+
 	private:
 		void _free();
 
@@ -66,6 +85,9 @@ namespace slib
 		
 		Ref<AsyncStreamRequest> m_requestReading;
 		Ref<AsyncStreamRequest> m_requestWriting;
+		List< Ref<AsyncStreamRequest> > m_requestsWriting; // gathered for a vectored write. The first one can be partially written
+		sl_bool m_flagCorked;
+		sl_uint32 m_timeoutConnect;
 	};
 
 	class SLIB_EXPORT AsyncTcpServerInstance : public AsyncIoInstance
@@ -119,6 +141,11 @@ namespace slib
 		void onClose() override;
 
 		void _onReceive(SocketAddress& address, sl_uint32 size);
+
+		void _onReceiveBatch(SocketMessage* messages, sl_uint32 count);
+
+		// Splits the datagrams coalesced by UDP GRO
+		void _onReceiveSegments(SocketMessage* messages, sl_uint32 count);
 		
 		void _onError();
 
@@ -128,8 +155,29 @@ namespace slib
 	protected:
 		sl_bool m_flagRunning;
 		Memory m_buffer;
+		sl_uint32 m_packetSize;
+		sl_uint32 m_batchCount;
+		sl_bool m_flagReceiveOffload;
+		Array<SocketMessage> m_segments;
 		
 	};
+
+#if defined(SLIB_PLATFORM_IS_LINUX)
+	namespace priv
+	{
+		namespace network_async
+		{
+
+			// io_uring instances. `socket` is released only on success
+			Ref<AsyncTcpSocketInstance> CreateUringTcpInstance(Socket& socket, const Ref<AsyncIoLoop>& loop);
+
+			Ref<AsyncTcpServerInstance> CreateUringTcpServerInstance(Socket& socket, const Ref<AsyncIoLoop>& loop);
+
+			Ref<AsyncUdpSocketInstance> CreateUringUdpInstance(Socket& socket, const AsyncUdpSocketParam& param, const Ref<AsyncIoLoop>& loop);
+
+		}
+	}
+#endif
 	
 }
 
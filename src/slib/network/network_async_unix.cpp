@@ -28,6 +28,8 @@
 
 #include "slib/core/thread.h"
 #include "slib/core/handle_ptr.h"
+#include "slib/core/memory_view.h"
+#include "slib/core/async_uring.h"
 
 namespace slib
 {
@@ -41,11 +43,13 @@ namespace slib
 			{
 			public:				
 				sl_bool m_flagConnecting;
+				sl_uint32 m_idConnect;
 
 			public:
 				TcpInstance()
 				{
 					m_flagConnecting = sl_false;
+					m_idConnect = 0;
 				}
 				
 			public:
@@ -92,10 +96,17 @@ namespace slib
 						}
 						char* data = (char*)(request->data);
 						sl_size size = request->size;
-						if (data && size) {
-							sl_int32 n = socket->receive(data, size);
+						if (data || !size) {
+							sl_int32 n;
+							if (size) {
+								n = socket->receive(data, size);
+							} else {
+								// Zero-size request: waits for the incoming data without consuming it
+								char c;
+								n = socket->peek(&c, 1);
+							}
 							if (n > 0) {
-								processStreamResult(request.get(), n, flagError ? AsyncStreamResultCode::Unknown : AsyncStreamResultCode::Success);
+								processStreamResult(request.get(), size ? n : 0, flagError ? AsyncStreamResultCode::Unknown : AsyncStreamResultCode::Success);
 							} else {
 								if (n == SLIB_IO_WOULD_BLOCK) {
 									if (flagError) {
@@ -124,56 +135,63 @@ namespace slib
 						return;
 					}
 
-					Ref<AsyncStreamRequest> request = Move(m_requestWriting);
-					sl_size nQueue = getWriteRequestCount();
-
 					Thread* thread = Thread::getCurrent();
 					while (!thread || thread->isNotStopping()) {
-						if (request.isNull()) {
-							if (nQueue > 0) {
-								nQueue--;
-								popWriteRequest(request);
-								if (request.isNull()) {
-									return;
-								}
-							} else {
-								return;
-							}
+						_gatherWriting();
+						sl_size nRequests = m_requestsWriting.getCount();
+						if (!nRequests) {
+							return;
 						}
-						char* data = (char*)(request->data);
-						sl_size size = request->size;
-						if (data && size) {
-							for (;;) {
-								sl_size sizeWritten = request->sizeWritten;
-								sl_int32 n = socket->send(data + sizeWritten, size - sizeWritten);
-								if (n >= 0) {
-									request->sizeWritten += n;
-									if (request->sizeWritten >= size) {
-										request->sizeWritten = 0;
-										processStreamResult(request.get(), size, flagError ? AsyncStreamResultCode::Unknown : AsyncStreamResultCode::Success);
-										break;
-									}
-								} else {
-									if (n == SLIB_IO_WOULD_BLOCK) {
-										if (flagError) {
-											request->sizeWritten = 0;
-											processStreamResult(request.get(), sizeWritten, AsyncStreamResultCode::Unknown);
-										} else {
-											m_requestWriting = Move(request);
-										}
-									} else {
-										request->sizeWritten = 0;
-										processStreamResult(request.get(), sizeWritten, AsyncStreamResultCode::Unknown);
-									}
-									return;
-								}
-							}
+						if (flagError) {
+							_completeWriting(nRequests, AsyncStreamResultCode::Unknown);
+							continue;
+						}
+						if (m_flagCorked && nRequests < ASYNC_TCP_MAX_WRITE_VECTOR) {
+							return;
+						}
+						// Sends all the gathered requests by one system call
+						MemoryView views[ASYNC_TCP_MAX_WRITE_VECTOR];
+						sl_uint32 nViews = _getWritingViews(views);
+						sl_int32 n = socket->sendVector(views, nViews);
+						if (n >= 0) {
+							_onWritten(n);
 						} else {
-							processStreamResult(request.get(), 0, AsyncStreamResultCode::Success);
+							if (n != SLIB_IO_WOULD_BLOCK) {
+								_completeWriting(nRequests, AsyncStreamResultCode::Unknown);
+							}
+							return;
 						}
-						request.setNull();
 					}
 				}
+
+				void startConnectTimer()
+				{
+					sl_uint32 timeout = m_timeoutConnect;
+					if (!timeout) {
+						return;
+					}
+					Ref<AsyncIoLoop> loop = getLoop();
+					if (loop.isNull()) {
+						return;
+					}
+					sl_uint32 id = ++m_idConnect;
+					WeakRef<TcpInstance> weak = this;
+					WeakRef<AsyncIoLoop> weakLoop = loop;
+					// The timer runs on the dispatch thread, and the timeout is processed on the loop thread
+					loop->dispatch([weak, weakLoop, id]() {
+						Ref<AsyncIoLoop> loop = weakLoop;
+						if (loop.isNull()) {
+							return;
+						}
+						loop->addTask([weak, id]() {
+							Ref<TcpInstance> instance = weak;
+							if (instance.isNotNull() && instance->m_flagConnecting && instance->m_idConnect == id && !(instance->isClosing())) {
+								instance->m_flagConnecting = sl_false;
+								instance->_onConnect(sl_true);
+							}
+						});
+					}, timeout);
+				}
 				
 				void onOrder() override
 				{
@@ -189,6 +207,7 @@ namespace slib
 						m_flagRequestConnect = sl_false;
 						if (socket->connect(m_addressRequestConnect)) {
 							m_flagConnecting = sl_true;
+							startConnectTimer();
 						} else {
 							_onConnect(sl_true);
 						}
@@ -305,15 +324,41 @@ namespace slib
 				}
 				
 			public:
-				static Ref<UdpInstance> create(Socket&& socket, const Memory& buffer)
+				static Ref<UdpInstance> create(Socket&& socket, const AsyncUdpSocketParam& param)
 				{
 					if (socket.isOpened()) {
 						if (socket.setNonBlockingMode()) {
 							sl_async_handle handle = (sl_async_handle)(socket.get());
 							if (handle != SLIB_ASYNC_INVALID_HANDLE) {
+								sl_uint32 packetSize = param.packetSize;
+								sl_uint32 batchCount = param.receiveBatchCount;
+								if (batchCount < 1) {
+									batchCount = 1;
+								} else if (batchCount > ASYNC_UDP_MAX_RECEIVE_BATCH) {
+									batchCount = ASYNC_UDP_MAX_RECEIVE_BATCH;
+								}
+								Memory buffer = Memory::create((sl_size)packetSize * batchCount);
+								if (buffer.isNull()) {
+									return sl_null;
+								}
 								Ref<UdpInstance> ret = new UdpInstance();
 								if (ret.isNotNull()) {
-									ret->m_buffer = buffer;
+									ret->m_buffer = Move(buffer);
+									ret->m_packetSize = packetSize;
+									ret->m_batchCount = batchCount;
+									ret->m_flagReceiveOffload = param.flagReceiveOffload;
+									if (batchCount > 1 || param.flagReceiveOffload) {
+										ret->m_messages = Array<SocketMessage>::create(batchCount);
+										if (ret->m_messages.isNull()) {
+											return sl_null;
+										}
+										if (param.flagReceiveOffload) {
+											ret->m_segments = Array<SocketMessage>::create(ASYNC_UDP_MAX_RECEIVE_BATCH);
+											if (ret->m_segments.isNull()) {
+												return sl_null;
+											}
+										}
+									}
 									ret->setHandle(handle);
 									socket.release();
 									return ret;
@@ -338,6 +383,11 @@ namespace slib
 				
 				void processReceive()
 				{
+					if (m_messages.isNotNull()) {
+						processReceiveBatch();
+						return;
+					}
+
 					HandlePtr<Socket> socket = getSocket();
 					if (socket->isNone()) {
 						return;
@@ -360,29 +410,85 @@ namespace slib
 						}
 					}
 				}
+
+				void processReceiveBatch()
+				{
+					HandlePtr<Socket> socket = getSocket();
+					if (socket->isNone()) {
+						return;
+					}
+
+					sl_uint8* buf = (sl_uint8*)(m_buffer.getData());
+					SocketMessage* messages = m_messages.getData();
+
+					Thread* thread = Thread::getCurrent();
+					while (!thread || thread->isNotStopping()) {
+						for (sl_uint32 i = 0; i < m_batchCount; i++) {
+							SocketMessage& message = messages[i];
+							message.data = buf + (sl_size)m_packetSize * i;
+							message.size = m_packetSize;
+						}
+						sl_int32 n = socket->receiveFromBatch(messages, m_batchCount);
+						if (n > 0) {
+							if (m_segments.isNotNull()) {
+								_onReceiveSegments(messages, n);
+							} else {
+								_onReceiveBatch(messages, n);
+							}
+						} else {
+							if (n != SLIB_IO_WOULD_BLOCK) {
+								_onError();
+							}
+							break;
+						}
+					}
+				}
+
+			protected:
+				Array<SocketMessage> m_messages;
 				
 			};
 
 		}
 	}
 
-	Ref<AsyncTcpSocketInstance> AsyncTcpSocket::_createInstance(Socket&& socket, sl_bool flagIPv6)
+	Ref<AsyncTcpSocketInstance> AsyncTcpSocket::_createInstance(Socket&& socket, sl_bool flagIPv6, const Ref<AsyncIoLoop>& loop)
 	{
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		if (AsyncUring::isEnabled(loop.get())) {
+			Ref<AsyncTcpSocketInstance> ret = priv::network_async::CreateUringTcpInstance(socket, loop);
+			if (ret.isNotNull()) {
+				return ret;
+			}
+		}
+#endif
 		return priv::network_async::TcpInstance::create(Move(socket));
 	}
 
-	Ref<AsyncTcpServerInstance> AsyncTcpServer::_createInstance(Socket&& socket, sl_bool flagIPv6)
+	Ref<AsyncTcpServerInstance> AsyncTcpServer::_createInstance(Socket&& socket, sl_bool flagIPv6, const Ref<AsyncIoLoop>& loop)
 	{
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		if (AsyncUring::isEnabled(loop.get())) {
+			Ref<AsyncTcpServerInstance> ret = priv::network_async::CreateUringTcpServerInstance(socket, loop);
+			if (ret.isNotNull()) {
+				return ret;
+			}
+		}
+#endif
 		return priv::network_async::TcpServerInstance::create(Move(socket));
 	}
 
-	Ref<AsyncUdpSocketInstance> AsyncUdpSocket::_createInstance(Socket&& socket, sl_uint32 packetSize)
+	Ref<AsyncUdpSocketInstance> AsyncUdpSocket::_createInstance(Socket&& socket, const AsyncUdpSocketParam& param, const Ref<AsyncIoLoop>& loop)
 	{
-		Memory buffer = Memory::create(packetSize);
-		if (buffer.isNotNull()) {
-			return priv::network_async::UdpInstance::create(Move(socket), buffer);
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		if (AsyncUring::isEnabled(loop.get())) {
+			Ref<AsyncUdpSocketInstance> ret = priv::network_async::CreateUringUdpInstance(socket, param, loop);
+			if (ret.isNotNull()) {
+				return ret;
+			}
 		}
-		return sl_null;
+#endif
+		return priv::network_async::UdpInstance::create(Move(socket), param);
 	}
 	
 }
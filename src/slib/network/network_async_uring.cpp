@@ -0,0 +1,588 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/network/definition.h"
+
+#if defined(SLIB_PLATFORM_IS_LINUX)
+
+#include "network_async.h"
+
+#include "slib/core/async_uring.h"
+#include "slib/core/memory_view.h"
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+
+#define OPERATION_CONNECT 1
+#define OPERATION_RECEIVE 2
+#define OPERATION_SEND 3
+#define OPERATION_ACCEPT 4
+#define OPERATION_RECEIVE_MESSAGES 5
+
+#define ACCEPT_RETRY_DELAY 100
+#define UDP_MIN_BUFFER_COUNT 16
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace network_async
+		{
+
+			class UringTcpInstance : public AsyncTcpSocketInstance
+			{
+			public:
+				WeakRef<AsyncIoLoop> m_loop;
+				sl_bool m_flagConnecting;
+				Ref<AsyncStreamRequest> m_requestReceiving;
+				List< Ref<AsyncStreamRequest> > m_requestsSending;
+				sl_bool m_flagSending;
+				sl_uint8 m_bufPeek;
+
+			public:
+				UringTcpInstance()
+				{
+					m_flagConnecting = sl_false;
+					m_flagSending = sl_false;
+				}
+
+				~UringTcpInstance()
+				{
+					if (m_requestReceiving.isNotNull()) {
+						processStreamResult(m_requestReceiving.get(), 0, AsyncStreamResultCode::Closed);
+					}
+					if (m_requestsSending.isNotNull()) {
+						m_requestsWriting = Move(m_requestsSending);
+						_completeWriting(m_requestsWriting.getCount(), AsyncStreamResultCode::Closed);
+					}
+				}
+
+			public:
+				static Ref<UringTcpInstance> create(Socket& socket, const Ref<AsyncIoLoop>& loop)
+				{
+					if (socket.isOpened()) {
+						if (socket.setNonBlockingMode()) {
+							sl_async_handle handle = (sl_async_handle)(socket.get());
+							if (handle != SLIB_ASYNC_INVALID_HANDLE) {
+								Ref<UringTcpInstance> ret = new UringTcpInstance();
+								if (ret.isNotNull()) {
+									ret->m_loop = loop;
+									ret->setHandle(handle);
+									socket.release();
+									return ret;
+								}
+							}
+						}
+					}
+					return sl_null;
+				}
+
+				sl_bool isUringInstance() override
+				{
+					return sl_true;
+				}
+
+				void processRead(AsyncIoLoop* loop)
+				{
+					while (m_requestReceiving.isNull()) {
+						Ref<AsyncStreamRequest> request;
+						if (!(popReadRequest(request))) {
+							return;
+						}
+						if (request.isNull()) {
+							return;
+						}
+						if (request->data && request->size) {
+							// Receives directly into the buffer of the request
+							sl_uint32 size = request->size > 0x40000000 ? 0x40000000 : (sl_uint32)(request->size);
+							if (AsyncUring::receive(loop, this, OPERATION_RECEIVE, request->data, size)) {
+								m_requestReceiving = Move(request);
+							} else {
+								processStreamResult(request.get(), 0, AsyncStreamResultCode::Unknown);
+							}
+							return;
+						} else if (!(request->size)) {
+							// Zero-size request: waits for the incoming data without consuming it
+							if (AsyncUring::receive(loop, this, OPERATION_RECEIVE, &m_bufPeek, 1, MSG_PEEK)) {
+								m_requestReceiving = Move(request);
+							} else {
+								processStreamResult(request.get(), 0, AsyncStreamResultCode::Unknown);
+							}
+							return;
+						} else {
+							processStreamResult(request.get(), 0, AsyncStreamResultCode::Success);
+						}
+					}
+				}
+
+				void processWrite(AsyncIoLoop* loop)
+				{
+					if (m_flagSending) {
+						return;
+					}
+					_gatherWriting();
+					sl_size nRequests = m_requestsWriting.getCount();
+					if (!nRequests) {
+						return;
+					}
+					if (m_flagCorked && nRequests < ASYNC_TCP_MAX_WRITE_VECTOR) {
+						return;
+					}
+					MemoryView views[ASYNC_TCP_MAX_WRITE_VECTOR];
+					sl_uint32 nViews = _getWritingViews(views);
+					if (AsyncUring::sendVector(loop, this, OPERATION_SEND, views, nViews)) {
+						m_requestsSending = Move(m_requestsWriting);
+						m_flagSending = sl_true;
+					} else {
+						_completeWriting(nRequests, AsyncStreamResultCode::Unknown);
+					}
+				}
+
+				void onOrder() override
+				{
+					if (isClosing()) {
+						return;
+					}
+					Ref<AsyncIoLoop> loop(m_loop);
+					if (loop.isNull()) {
+						return;
+					}
+					if (m_flagConnecting) {
+						return;
+					}
+					if (m_flagRequestConnect) {
+						m_flagRequestConnect = sl_false;
+						sockaddr_storage addr;
+						sl_uint32 sizeAddr = m_addressRequestConnect.getSystemSocketAddress(&addr);
+						if (sizeAddr && AsyncUring::connect(loop.get(), this, OPERATION_CONNECT, &addr, sizeAddr, m_timeoutConnect)) {
+							m_flagConnecting = sl_true;
+						} else {
+							_onConnect(sl_true);
+						}
+						return;
+					}
+					processRead(loop.get());
+					processWrite(loop.get());
+				}
+
+				void onEvent(EventDesc* pev) override
+				{
+					if (!(pev->flagCompletion)) {
+						return;
+					}
+					sl_int32 result = pev->result;
+					switch (pev->operation) {
+						case OPERATION_CONNECT:
+							m_flagConnecting = sl_false;
+							_onConnect(result < 0);
+							break;
+						case OPERATION_RECEIVE:
+							{
+								Ref<AsyncStreamRequest> request = Move(m_requestReceiving);
+								if (request.isNotNull()) {
+									if (result > 0) {
+										processStreamResult(request.get(), request->size ? result : 0, AsyncStreamResultCode::Success);
+									} else if (result < 0 && (isClosing() || result == -ECANCELED)) {
+										processStreamResult(request.get(), 0, AsyncStreamResultCode::Closed);
+									} else {
+										processStreamResult(request.get(), 0, AsyncStreamResultCode::Ended);
+									}
+								}
+							}
+							break;
+						case OPERATION_SEND:
+							{
+								m_flagSending = sl_false;
+								m_requestsWriting = Move(m_requestsSending);
+								if (result >= 0) {
+									_onWritten(result);
+								} else {
+									_completeWriting(m_requestsWriting.getCount(), isClosing() ? AsyncStreamResultCode::Closed : AsyncStreamResultCode::Unknown);
+								}
+								if (isClosing()) {
+									_completeWriting(m_requestsWriting.getCount(), AsyncStreamResultCode::Closed);
+								}
+							}
+							break;
+					}
+					onOrder();
+				}
+
+			};
+
+			class UringTcpServerInstance : public AsyncTcpServerInstance
+			{
+			public:
+				WeakRef<AsyncIoLoop> m_loop;
+				sl_bool m_flagAccepting;
+
+			public:
+				UringTcpServerInstance()
+				{
+					m_flagAccepting = sl_false;
+				}
+
+			public:
+				static Ref<UringTcpServerInstance> create(Socket& socket, const Ref<AsyncIoLoop>& loop)
+				{
+					if (socket.isOpened()) {
+						if (socket.setNonBlockingMode()) {
+							sl_async_handle handle = (sl_async_handle)(socket.get());
+							if (handle != SLIB_ASYNC_INVALID_HANDLE) {
+								Ref<UringTcpServerInstance> ret = new UringTcpServerInstance();
+								if (ret.isNotNull()) {
+									ret->m_loop = loop;
+									ret->setHandle(handle);
+									socket.release();
+									return ret;
+								}
+							}
+						}
+					}
+					return sl_null;
+				}
+
+				sl_bool isUringInstance() override
+				{
+					return sl_true;
+				}
+
+				void onOrder() override
+				{
+					if (!m_flagRunning || m_flagAccepting || isClosing()) {
+						return;
+					}
+					Ref<AsyncIoLoop> loop(m_loop);
+					if (loop.isNull()) {
+						return;
+					}
+					// One multishot accept serves all the incoming connections
+					if (AsyncUring::accept(loop.get(), this, OPERATION_ACCEPT)) {
+						m_flagAccepting = sl_true;
+					} else {
+						_onError();
+					}
+				}
+
+				void onEvent(EventDesc* pev) override
+				{
+					if (!(pev->flagCompletion)) {
+						return;
+					}
+					if (!(pev->flagMore)) {
+						m_flagAccepting = sl_false;
+					}
+					sl_int32 result = pev->result;
+					if (result >= 0) {
+						Socket socket((sl_socket)result);
+						if (isClosing()) {
+							return;
+						}
+						SocketAddress address;
+						socket.getRemoteAddress(address);
+						_onAccept(socket, address);
+					} else {
+						if (isClosing() || result == -ECANCELED) {
+							return;
+						}
+						_onError();
+						if (result == -EMFILE || result == -ENFILE || result == -ENOBUFS || result == -ENOMEM) {
+							// Retries later instead of spinning on the exhausted resource
+							Ref<AsyncIoLoop> loop(m_loop);
+							if (loop.isNotNull() && !m_flagAccepting) {
+								WeakRef<UringTcpServerInstance> weak = this;
+								loop->dispatch([weak]() {
+									Ref<UringTcpServerInstance> instance = weak;
+									if (instance.isNotNull()) {
+										instance->requestOrder();
+									}
+								}, ACCEPT_RETRY_DELAY);
+							}
+							return;
+						}
+					}
+					if (!m_flagAccepting) {
+						onOrder();
+					}
+				}
+
+			};
+
+			class UringUdpInstance : public AsyncUdpSocketInstance
+			{
+			public:
+				WeakRef<AsyncIoLoop> m_loop;
+				sl_int32 m_bufferGroup;
+				sl_uint32 m_bufferCount;
+				sl_uint32 m_bufferSize;
+				sl_uint32 m_sizeName;
+				sl_uint32 m_sizeControl;
+				sl_bool m_flagReceiving;
+
+				Array<SocketMessage> m_messages;
+				sl_uint32 m_indicesPending[ASYNC_UDP_MAX_RECEIVE_BATCH];
+				sl_uint32 m_nPending;
+
+			public:
+				UringUdpInstance()
+				{
+					m_bufferGroup = -1;
+					m_bufferCount = 0;
+					m_bufferSize = 0;
+					m_sizeName = sizeof(sockaddr_storage);
+					m_sizeControl = 0;
+					m_flagReceiving = sl_false;
+					m_nPending = 0;
+				}
+
+			public:
+				static Ref<UringUdpInstance> create(Socket& socket, const AsyncUdpSocketParam& param, const Ref<AsyncIoLoop>& loop)
+				{
+					if (socket.isOpened()) {
+						if (socket.setNonBlockingMode()) {
+							sl_async_handle handle = (sl_async_handle)(socket.get());
+							if (handle != SLIB_ASYNC_INVALID_HANDLE) {
+								sl_uint32 batchCount = param.receiveBatchCount;
+								if (batchCount < 1) {
+									batchCount = 1;
+								} else if (batchCount > ASYNC_UDP_MAX_RECEIVE_BATCH) {
+									batchCount = ASYNC_UDP_MAX_RECEIVE_BATCH;
+								}
+								Ref<UringUdpInstance> ret = new UringUdpInstance();
+								if (ret.isNotNull()) {
+									ret->m_messages = Array<SocketMessage>::create(batchCount);
+									if (ret->m_messages.isNull()) {
+										return sl_null;
+									}
+									if (param.flagReceiveOffload) {
+										ret->m_segments = Array<SocketMessage>::create(ASYNC_UDP_MAX_RECEIVE_BATCH);
+										if (ret->m_segments.isNull()) {
+											return sl_null;
+										}
+										ret->m_sizeControl = CMSG_SPACE(sizeof(int));
+									}
+									ret->m_loop = loop;
+									ret->m_packetSize = param.packetSize;
+									ret->m_batchCount = batchCount;
+									ret->m_flagReceiveOffload = param.flagReceiveOffload;
+									// Keeps receiving while a batch is waiting for the callback
+									sl_uint32 nBuffers = batchCount * 2;
+									if (nBuffers < UDP_MIN_BUFFER_COUNT) {
+										nBuffers = UDP_MIN_BUFFER_COUNT;
+									}
+									ret->m_bufferCount = nBuffers;
+									ret->m_bufferSize = AsyncUring::getMessageBufferSize(ret->m_sizeName, ret->m_sizeControl, param.packetSize);
+									ret->setHandle(handle);
+									socket.release();
+									return ret;
+								}
+							}
+						}
+					}
+					return sl_null;
+				}
+
+				sl_bool isUringInstance() override
+				{
+					return sl_true;
+				}
+
+				void onOrder() override
+				{
+					if (isClosing()) {
+						return;
+					}
+					flushMessages();
+					if (!m_flagRunning || m_flagReceiving || isClosing()) {
+						return;
+					}
+					Ref<AsyncIoLoop> loop(m_loop);
+					if (loop.isNull()) {
+						return;
+					}
+					if (m_bufferGroup < 0) {
+						// Registered on the loop thread, which is the only submitter of the ring
+						m_bufferGroup = AsyncUring::createBufferGroup(loop.get(), m_bufferCount, m_bufferSize);
+						if (m_bufferGroup < 0) {
+							_onError();
+							return;
+						}
+					}
+					if (AsyncUring::receiveMessages(loop.get(), this, OPERATION_RECEIVE_MESSAGES, m_bufferGroup, m_sizeName, m_sizeControl)) {
+						m_flagReceiving = sl_true;
+					} else {
+						_onError();
+					}
+				}
+
+				void onEvent(EventDesc* pev) override
+				{
+					if (!(pev->flagCompletion)) {
+						return;
+					}
+					if (!(pev->flagMore)) {
+						m_flagReceiving = sl_false;
+					}
+					Ref<AsyncIoLoop> loop(m_loop);
+					if (loop.isNull()) {
+						return;
+					}
+					sl_int32 result = pev->result;
+					if (pev->bufferIndex >= 0) {
+						sl_uint32 index = (sl_uint32)(pev->bufferIndex);
+						if (result > 0 && !(isClosing()) && addMessage(loop.get(), index, result)) {
+							if (m_nPending >= m_batchCount) {
+								flushMessages();
+							} else if (m_nPending == 1) {
+								// Delivers the batch after the other completions of this loop step
+								requestOrder();
+							}
+						} else {
+							AsyncUring::recycleBuffer(loop.get(), m_bufferGroup, index);
+						}
+					} else if (result < 0) {
+						if (!(isClosing()) && result != -ECANCELED && result != -ENOBUFS) {
+							_onError();
+						}
+					}
+					if (!m_flagReceiving) {
+						if (isClosing()) {
+							freeBuffers(loop.get());
+						} else {
+							// Resubmitted after the pending buffers are recycled
+							requestOrder();
+						}
+					}
+				}
+
+				void onClose() override
+				{
+					if (!m_flagReceiving) {
+						Ref<AsyncIoLoop> loop(m_loop);
+						if (loop.isNotNull()) {
+							freeBuffers(loop.get());
+						}
+					}
+					AsyncUdpSocketInstance::onClose();
+				}
+
+				sl_bool addMessage(AsyncIoLoop* loop, sl_uint32 index, sl_uint32 sizeReceived)
+				{
+					void* buf = AsyncUring::getBuffer(loop, m_bufferGroup, index);
+					if (!buf) {
+						return sl_false;
+					}
+					void* name;
+					sl_uint32 sizeName;
+					void* control;
+					sl_uint32 sizeControl;
+					void* payload;
+					sl_uint32 sizePayload;
+					if (!(AsyncUring::parseMessage(buf, sizeReceived, m_sizeName, m_sizeControl, name, sizeName, control, sizeControl, payload, sizePayload))) {
+						return sl_false;
+					}
+					SocketMessage& message = m_messages[m_nPending];
+					if (!(message.address.setSystemSocketAddress(name, sizeName))) {
+						message.address.setNone();
+					}
+					message.data = payload;
+					message.size = sizePayload;
+					message.segmentSize = 0;
+					message.flagTruncated = sl_false;
+					if (sizeControl) {
+						msghdr hdr;
+						Base::zeroMemory(&hdr, sizeof(hdr));
+						hdr.msg_control = control;
+						hdr.msg_controllen = sizeControl;
+						for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+							if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO) {
+								int seg;
+								Base::copyMemory(&seg, CMSG_DATA(cmsg), sizeof(int));
+								if (seg > 0 && (sl_uint32)seg < message.size) {
+									message.segmentSize = (sl_uint32)seg;
+								}
+							}
+						}
+					}
+					m_indicesPending[m_nPending] = index;
+					m_nPending++;
+					return sl_true;
+				}
+
+				void flushMessages()
+				{
+					sl_uint32 n = m_nPending;
+					if (!n) {
+						return;
+					}
+					if (m_flagReceiveOffload) {
+						_onReceiveSegments(m_messages.getData(), n);
+					} else {
+						_onReceiveBatch(m_messages.getData(), n);
+					}
+					m_nPending = 0;
+					Ref<AsyncIoLoop> loop(m_loop);
+					if (loop.isNotNull()) {
+						for (sl_uint32 i = 0; i < n; i++) {
+							AsyncUring::recycleBuffer(loop.get(), m_bufferGroup, m_indicesPending[i]);
+						}
+					}
+				}
+
+				void freeBuffers(AsyncIoLoop* loop)
+				{
+					if (m_bufferGroup >= 0) {
+						AsyncUring::freeBufferGroup(loop, m_bufferGroup);
+						m_bufferGroup = -1;
+					}
+					m_nPending = 0;
+				}
+
+			};
+
+			Ref<AsyncTcpSocketInstance> CreateUringTcpInstance(Socket& socket, const Ref<AsyncIoLoop>& loop)
+			{
+				return UringTcpInstance::create(socket, loop);
+			}
+
+			Ref<AsyncTcpServerInstance> CreateUringTcpServerInstance(Socket& socket, const Ref<AsyncIoLoop>& loop)
+			{
+				return UringTcpServerInstance::create(socket, loop);
+			}
+
+			Ref<AsyncUdpSocketInstance> CreateUringUdpInstance(Socket& socket, const AsyncUdpSocketParam& param, const Ref<AsyncIoLoop>& loop)
+			{
+				return UringUdpInstance::create(socket, param, loop);
+			}
+
+		}
+	}
+
+}
+
+#endif
@@ -109,7 +109,8 @@ namespace slib
 							if (req.isNotNull()) {
 								char* data = (char*)(req->data);
 								sl_size size = req->size;
-								if (data && size) {
+								// Zero-size request: the zero-byte receive completes when the data arrives, without consuming it
+								if (data || !size) {
 									Base::zeroMemory(&m_overlappedRead, sizeof(m_overlappedRead));
 									m_bufRead.buf = data;
 									if (size > 0x40000000) {
@@ -141,7 +142,7 @@ namespace slib
 							}
 						}
 					}
-					if (m_requestWriting.isNull()) {
+					if (m_requestWriting.isNull() && !m_flagCorked) {
 						Ref<AsyncStreamRequest> req;
 						if (popWriteRequest(req)) {
 							if (req.isNotNull()) {
@@ -242,7 +243,7 @@ namespace slib
 						if (req.isNotNull()) {
 							if (flagError) {
 								processStreamResult(req.get(), 0, AsyncStreamResultCode::Unknown);
-							} else if (dwSize) {
+							} else if (dwSize || !(req->size)) {
 								processStreamResult(req.get(), dwSize, AsyncStreamResultCode::Success);
 							} else {
 								processStreamResult(req.get(), 0, AsyncStreamResultCode::Ended);
@@ -555,20 +556,20 @@ namespace slib
 		}
 	}
 
-	Ref<AsyncTcpSocketInstance> AsyncTcpSocket::_createInstance(Socket&& socket, sl_bool flagIPv6)
+	Ref<AsyncTcpSocketInstance> AsyncTcpSocket::_createInstance(Socket&& socket, sl_bool flagIPv6, const Ref<AsyncIoLoop>& loop)
 	{
 		return priv::network_async::TcpInstance::create(Move(socket), flagIPv6);
 	}
 
 
-	Ref<AsyncTcpServerInstance> AsyncTcpServer::_createInstance(Socket&& socket, sl_bool flagIPv6)
+	Ref<AsyncTcpServerInstance> AsyncTcpServer::_createInstance(Socket&& socket, sl_bool flagIPv6, const Ref<AsyncIoLoop>& loop)
 	{
 		return priv::network_async::TcpServerInstance::create(Move(socket), flagIPv6);
 	}
 
-	Ref<AsyncUdpSocketInstance> AsyncUdpSocket::_createInstance(Socket&& socket, sl_uint32 packetSize)
+	Ref<AsyncUdpSocketInstance> AsyncUdpSocket::_createInstance(Socket&& socket, const AsyncUdpSocketParam& param, const Ref<AsyncIoLoop>& loop)
 	{
-		Memory buffer = Memory::create(packetSize);
+		Memory buffer = Memory::create(param.packetSize);
 		if (buffer.isNotNull()) {
 			return priv::network_async::UdpInstance::create(Move(socket), buffer);
 		}
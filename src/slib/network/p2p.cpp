@@ -32,6 +32,7 @@
 #include "slib/core/expiring_map.h"
 #include "slib/core/system.h"
 #include "slib/core/scoped_buffer.h"
+#include "slib/core/memory_pool.h"
 #include "slib/crypto/chacha.h"
 #include "slib/crypto/serialize/ecc.h"
 
@@ -149,6 +150,7 @@ CVLI		Uint32			Total Length (From next field)
 #define EXPIRE_DURATION_FIND_DIRECT_CONNECTION 3000
 #define EXPIRE_DURATION_IDLE_TCP_SOCKET 30000
 #define BUFFER_SIZE_TCP_STREAM 0x10000
+#define POOL_SIZE_TCP_STREAM_BUFFER 16
 
 namespace slib
 {
@@ -556,6 +558,7 @@ namespace slib
 
 				ExpiringMap< TcpStream*, Ref<TcpStream> > m_mapTcpStreams;
 				ExpiringMap< DirectConnection*, Ref<AsyncTcpSocket> > m_mapIdleTcpSockets;
+				Ref<MemoryPool> m_poolTcpStreamBuffer;
 
 				Ref<AsyncIoLoop> m_ioLoop;
 				Ref<DispatchLoop> m_dispatchLoop;
@@ -704,6 +707,10 @@ namespace slib
 					{
 						m_mapTcpStreams.setupTimer(param.tcpConnectionTimeout, m_dispatchLoop);
 						m_mapIdleTcpSockets.setupTimer(EXPIRE_DURATION_IDLE_TCP_SOCKET, m_dispatchLoop);
+						m_poolTcpStreamBuffer = MemoryPool::create(BUFFER_SIZE_TCP_STREAM, POOL_SIZE_TCP_STREAM_BUFFER);
+						if (m_poolTcpStreamBuffer.isNull()) {
+							return sl_false;
+						}
 
 						AsyncTcpServerParam serverParam;
 						serverParam.ioLoop = m_ioLoop;
@@ -716,26 +723,42 @@ namespace slib
 								Ref<TcpServerStream> stream = new TcpServerStream(Move(client), m_param.maximumMessageSize);
 								if (stream.isNotNull()) {
 									WeakRef<TcpServerStream> weakStream = stream;
-									if (stream->m_socket->receive(Memory::create(BUFFER_SIZE_TCP_STREAM), [this, weakStream](AsyncStreamResult& result) {
+									// The idle streams hold no buffer: waits for the data, and borrows a buffer from the pool until the socket is drained
+									if (stream->m_socket->waitRead([this, weakStream](AsyncStreamResult& result) {
 										Ref<TcpServerStream> stream = weakStream;
 										if (stream.isNull()) {
 											return;
 										}
 										if (result.isSuccess() && !(stream->m_flagWriting)) {
-											sl_int32 iRet = stream->processReceivedData((sl_uint8*)(result.data), result.size);
-											if (iRet >= 0) {
-												sl_bool flagSuccess = sl_true;
-												if (iRet > 0) {
-													if (_onReceivedTcpServerStream(stream.get(), stream->m_currentCommand, stream->getContent(), stream->getContentSize())) {
-														stream->clear();
-														m_mapTcpStreams.get(stream.get());
-													} else {
-														flagSuccess = sl_false;
+											if (!(result.requestSize)) {
+												Memory buf = m_poolTcpStreamBuffer->allocate();
+												if (buf.isNotNull()) {
+													if (stream->m_socket->receive(buf.getData(), buf.getSize(), result.callback, buf.ref.get())) {
+														return;
 													}
 												}
-												if (flagSuccess) {
-													if (stream->m_socket->receive(result.data, result.requestSize, result.callback, result.userObject)) {
-														return;
+											} else {
+												sl_int32 iRet = stream->processReceivedData((sl_uint8*)(result.data), result.size);
+												if (iRet >= 0) {
+													sl_bool flagSuccess = sl_true;
+													if (iRet > 0) {
+														if (_onReceivedTcpServerStream(stream.get(), stream->m_currentCommand, stream->getContent(), stream->getContentSize())) {
+															stream->clear();
+															m_mapTcpStreams.get(stream.get());
+														} else {
+															flagSuccess = sl_false;
+														}
+													}
+													if (flagSuccess) {
+														if (result.size < result.requestSize) {
+															if (stream->m_socket->waitRead(result.callback)) {
+																return;
+															}
+														} else {
+															if (stream->m_socket->receive(result.data, result.requestSize, result.callback, result.userObject)) {
+																return;
+															}
+														}
 													}
 												}
 											}
@@ -1489,7 +1512,7 @@ namespace slib
 								Ref<TcpClientStream> stream = weakStream;
 								if (stream.isNotNull()) {
 									if (result.isSuccess()) {
-										if (stream->m_socket->receive(Memory::create(BUFFER_SIZE_TCP_STREAM), [this, refNode, refConnection, weakStream, timeoutMonitor, callback](AsyncStreamResult& result) {
+										if (stream->m_socket->receive(m_poolTcpStreamBuffer->allocate(), [this, refNode, refConnection, weakStream, timeoutMonitor, callback](AsyncStreamResult& result) {
 											if (TimeoutMonitor::isFinished(timeoutMonitor)) {
 												return;
 											}
@@ -23,15 +23,25 @@
 #include "slib/network/packet_analyzer.h"
 
 #include "slib/core/rw_lock.h"
+#include "slib/core/spin_lock.h"
 #include "slib/core/thread.h"
+#include "slib/core/cpu.h"
 #include "slib/core/system.h"
 #include "slib/core/log.h"
 #include "slib/crypto/tls.h"
 #include "slib/network/capture.h"
 
 #define CONTENT_LOOKUP_SIZE 1024
-#define CONNECTION_TABLE_LENGTH 4096
-#define CONNECTION_TIMEOUT 30000
+#define DEFAULT_FLOW_TABLE_CAPACITY 65536
+#define DEFAULT_FLOW_TIMEOUT 30000
+#define DEFAULT_WORKER_QUEUE_SIZE 0x400000
+#define MAX_WORKER_COUNT 64
+#define SYNC_LANE_COUNT 16
+#define FLOW_ENTRY_CHUNK_SIZE 256
+#define TIMER_WHEEL_SIZE 64
+#define DISPATCH_BATCH_SIZE 256
+#define WORKER_IDLE_TIMEOUT 100
+#define INVALID_INDEX 0xFFFFFFFF
 
 namespace slib
 {
@@ -43,8 +53,11 @@ namespace slib
 
 			class PacketAnalyzerHelper : public PacketAnalyzer
 			{
+			public:
+				using PacketAnalyzer::PacketParam;
+
 				friend class ContentAnalyzer;
-				friend class TcpConnectionTableEntry;
+				friend class FlowPipeline;
 			};
 			
 			sl_uint64 ToKey(const IPv4Address& address, sl_uint16 port) noexcept
@@ -52,27 +65,104 @@ namespace slib
 				return SLIB_MAKE_QWORD4(address.getInt(), port);
 			}
 
-			class TcpConnection
+			static sl_uint32 MixHash(sl_uint64 x) noexcept
+			{
+				x ^= x >> 33;
+				x *= SLIB_UINT64(0xff51afd7ed558ccd);
+				x ^= x >> 33;
+				x *= SLIB_UINT64(0xc4ceb9fe1a85ec53);
+				x ^= x >> 33;
+				return (sl_uint32)x;
+			}
+
+			// Same value for both directions of a flow
+			static sl_uint32 GetLaneHash(const PacketAnalyzerHelper::PacketParam& param) noexcept
+			{
+				if (param.type == NetworkLinkDeviceType::Ethernet) {
+					if (((EthernetFrame*)(param.frame))->getProtocol() != NetworkLinkProtocol::IPv4) {
+						return 0;
+					}
+				}
+				if (param.sizePacket < IPv4Packet::HeaderSizeBeforeOptions) {
+					return 0;
+				}
+				IPv4Packet* ip = (IPv4Packet*)(param.packet);
+				sl_uint32 a = ip->getSourceAddress().getInt();
+				sl_uint32 b = ip->getDestinationAddress().getInt();
+				sl_uint32 pa = 0;
+				sl_uint32 pb = 0;
+				NetworkInternetProtocol protocol = ip->getProtocol();
+				if (protocol == NetworkInternetProtocol::TCP || protocol == NetworkInternetProtocol::UDP) {
+					// Fragments carry no ports: hash the addresses only
+					sl_uint32 sizeHeader = ip->getHeaderSize();
+					if (!(ip->isMF()) && !(ip->getFragmentOffset()) && sizeHeader + 4 <= param.sizePacket) {
+						sl_uint8* p = param.packet + sizeHeader;
+						pa = MIO::readUint16BE(p);
+						pb = MIO::readUint16BE(p + 2);
+					}
+				}
+				if (a > b || (a == b && pa > pb)) {
+					Swap(a, b);
+					Swap(pa, pb);
+				}
+				return MixHash(SLIB_MAKE_QWORD4(a, b) ^ ((sl_uint64)((pa << 16) | pb) * SLIB_UINT64(0x9e3779b97f4a7c15)) ^ (sl_uint32)protocol);
+			}
+
+			class FlowKey
 			{
 			public:
-				IPv4Address destinationIp;
+				sl_uint32 sourceIp;
+				sl_uint32 destinationIp;
+				sl_uint16 sourcePort;
 				sl_uint16 destinationPort;
-				sl_uint64 startTime;
-				sl_uint32 startSequenceNumber;
-				sl_uint32 sizeContent;
-				char content[CONTENT_LOOKUP_SIZE];
-
-				sl_bool flagNotHttp;
-				sl_bool flagNotHttps;
+				sl_uint32 protocol;
 
 			public:
-				TcpConnection() noexcept : startSequenceNumber(0), sizeContent(0)
+				sl_uint32 getHash() const noexcept
 				{
-					startTime = System::getHighResolutionTickCount();
-					flagNotHttp = sl_false;
-					flagNotHttps = sl_false;
+					return MixHash(SLIB_MAKE_QWORD4(sourceIp, destinationIp) ^ ((sl_uint64)(SLIB_MAKE_DWORD2(sourcePort, destinationPort)) << 8) ^ protocol);
 				}
 
+				sl_bool equals(const FlowKey& other) const noexcept
+				{
+					return sourceIp == other.sourceIp && destinationIp == other.destinationIp && sourcePort == other.sourcePort && destinationPort == other.destinationPort && protocol == other.protocol;
+				}
+
+				void setTcp(IPv4Packet* packet, TcpSegment* tcp, sl_bool flagReverse) noexcept
+				{
+					if (flagReverse) {
+						sourceIp = packet->getDestinationAddress().getInt();
+						destinationIp = packet->getSourceAddress().getInt();
+						sourcePort = tcp->getDestinationPort();
+						destinationPort = tcp->getSourcePort();
+					} else {
+						sourceIp = packet->getSourceAddress().getInt();
+						destinationIp = packet->getDestinationAddress().getInt();
+						sourcePort = tcp->getSourcePort();
+						destinationPort = tcp->getDestinationPort();
+					}
+					protocol = (sl_uint32)(NetworkInternetProtocol::TCP);
+				}
+
+			};
+
+			class FlowEntry
+			{
+			public:
+				FlowKey key;
+				sl_uint32 hash;
+				sl_uint32 index;
+				// Links of the timer wheel (or the free list)
+				sl_uint32 prev;
+				sl_uint32 next;
+				sl_uint64 tickExpire;
+
+				sl_uint32 startSequenceNumber;
+				sl_uint32 sizeContent;
+				sl_bool flagNotHttp;
+				sl_bool flagNotHttps;
+				char content[CONTENT_LOOKUP_SIZE];
+
 			public:
 				sl_bool addContent(TcpSegment* tcp, sl_uint8* data, sl_uint32 sizeData) noexcept
 				{
@@ -99,139 +189,344 @@ namespace slib
 
 			};
 
-			class TcpConnectionTableEntry
+			/*
+				Open addressing (linear probing, backward shift deletion) over the indices of the pooled entries.
+				The entries expire by the timer wheel: `TIMER_WHEEL_SIZE` slots covering twice of the timeout.
+				Not thread-safe: owned by a lane.
+			*/
+			class FlowTable
 			{
 			public:
-				Shared<TcpConnection> create(IPv4Packet* packet, TcpSegment* tcp) noexcept
+				sl_uint64 countCreated;
+				sl_uint64 countExpired;
+				sl_uint64 countEvicted;
+
+			public:
+				FlowTable() noexcept
+				{
+					countCreated = 0;
+					countExpired = 0;
+					countEvicted = 0;
+
+					m_cells = sl_null;
+					m_maskCells = 0;
+					m_chunks = sl_null;
+					m_nChunks = 0;
+					m_capacity = 0;
+					m_nAllocated = 0;
+					m_indexFree = INVALID_INDEX;
+					m_count = 0;
+
+					for (sl_uint32 i = 0; i < TIMER_WHEEL_SIZE; i++) {
+						m_wheel[i] = INVALID_INDEX;
+					}
+					m_tickCurrent = 0;
+					m_granularity = 1;
+					m_timeout = 0;
+				}
+
+				~FlowTable()
 				{
-					sl_uint64 key = ToKey(packet->getSourceAddress(), tcp->getSourcePort());
-					Shared<TcpConnection> connection = Shared<TcpConnection>::create();
-					if (connection.isNotNull()) {
-						connection->destinationIp = packet->getDestinationAddress();
-						connection->destinationPort = tcp->getDestinationPort();
-						connection->startSequenceNumber = tcp->getSequenceNumber();
-						WriteLocker locker(&m_lock);
-						if (m_table.put(key, connection)) {
-							return connection;
+					if (m_cells) {
+						Base::freeMemory(m_cells);
+					}
+					if (m_chunks) {
+						for (sl_uint32 i = 0; i < m_nChunks; i++) {
+							if (m_chunks[i]) {
+								Base::freeMemory(m_chunks[i]);
+							}
 						}
+						Base::freeMemory(m_chunks);
+					}
+				}
+
+			public:
+				sl_bool initialize(sl_uint32 capacity, sl_uint32 timeout) noexcept
+				{
+					if (!capacity) {
+						capacity = 1;
+					}
+					sl_uint32 nCells = Math::roundUpToPowerOfTwo(capacity << 1);
+					m_cells = (sl_uint64*)(Base::createZeroMemory(sizeof(sl_uint64) * nCells));
+					if (!m_cells) {
+						return sl_false;
+					}
+					m_maskCells = nCells - 1;
+					m_nChunks = (capacity + FLOW_ENTRY_CHUNK_SIZE - 1) / FLOW_ENTRY_CHUNK_SIZE;
+					m_chunks = (FlowEntry**)(Base::createZeroMemory(sizeof(FlowEntry*) * m_nChunks));
+					if (!m_chunks) {
+						return sl_false;
+					}
+					m_capacity = capacity;
+					m_timeout = timeout;
+					m_granularity = timeout / (TIMER_WHEEL_SIZE / 2) + 1;
+					return sl_true;
+				}
+
+				sl_uint32 getCount() noexcept
+				{
+					return m_count;
+				}
+
+				FlowEntry* find(const FlowKey& key, sl_uint32 hash) noexcept
+				{
+					sl_uint32 i = hash & m_maskCells;
+					for (;;) {
+						sl_uint64 cell = m_cells[i];
+						if (!cell) {
+							return sl_null;
+						}
+						if ((sl_uint32)(cell >> 32) == hash) {
+							FlowEntry* entry = getEntry((sl_uint32)cell - 1);
+							if (entry->key.equals(key)) {
+								return entry;
+							}
+						}
+						i = (i + 1) & m_maskCells;
 					}
-					return sl_null;
 				}
 
-				Shared<TcpConnection> get(const IPv4Address& address, sl_uint16 port) noexcept
+				// Replaces the existing entry of `key`
+				FlowEntry* create(const FlowKey& key, sl_uint32 hash, sl_uint64 now) noexcept
 				{
-					if (m_table.isEmpty()) {
+					expire(now);
+					FlowEntry* entry = find(key, hash);
+					if (entry) {
+						remove(entry);
+					}
+					entry = allocateEntry();
+					if (!entry) {
 						return sl_null;
 					}
-					sl_uint64 key = ToKey(address, port);
-					ReadLocker locker(&m_lock);
-					return m_table.getValue(key);
+					entry->key = key;
+					entry->hash = hash;
+					entry->tickExpire = (now + m_timeout) / m_granularity + 1;
+					entry->startSequenceNumber = 0;
+					entry->sizeContent = 0;
+					entry->flagNotHttp = sl_false;
+					entry->flagNotHttps = sl_false;
+					linkWheel(entry);
+					sl_uint32 i = hash & m_maskCells;
+					while (m_cells[i]) {
+						i = (i + 1) & m_maskCells;
+					}
+					m_cells[i] = SLIB_MAKE_QWORD4(hash, entry->index + 1);
+					m_count++;
+					countCreated++;
+					return entry;
+				}
+
+				void remove(FlowEntry* entry) noexcept
+				{
+					sl_uint64 cell = SLIB_MAKE_QWORD4(entry->hash, entry->index + 1);
+					sl_uint32 i = entry->hash & m_maskCells;
+					while (m_cells[i] != cell) {
+						if (!(m_cells[i])) {
+							return;
+						}
+						i = (i + 1) & m_maskCells;
+					}
+					removeCell(i);
+					unlinkWheel(entry);
+					entry->next = m_indexFree;
+					m_indexFree = entry->index;
+					m_count--;
 				}
 
-				void remove(const IPv4Address& address, sl_uint16 port) noexcept
+				void remove(const FlowKey& key) noexcept
 				{
-					if (m_table.isEmpty()) {
+					if (!m_count) {
 						return;
 					}
-					sl_uint64 key = ToKey(address, port);
-					WriteLocker locker(&m_lock);
-					m_table.remove(key);
+					FlowEntry* entry = find(key, key.getHash());
+					if (entry) {
+						remove(entry);
+					}
 				}
 
-				void removeOldConnections(sl_uint64 now) noexcept
+				void expire(sl_uint64 now) noexcept
 				{
-					CList<sl_uint64> listRemove;
-					sl_bool flagValidTable = sl_false;
-					{
-						ReadLocker lock(&m_lock);
-						for (auto& item : m_table) {
-							if (item.value->startTime + CONNECTION_TIMEOUT < now) {
-								listRemove.add_NoLock(item.key);
-							} else {
-								flagValidTable = sl_true;
-							}
-						}
+					sl_uint64 tick = now / m_granularity;
+					if (!m_tickCurrent) {
+						m_tickCurrent = tick;
 					}
-					if (flagValidTable) {
-						ListElements<sl_uint64> list(listRemove);
-						for (sl_size i = 0; i < list.count; i++) {
-							WriteLocker lock(&m_lock);
-							Shared<TcpConnection> old;
-							if (m_table.remove(list[i], &old)) {
-								if (old->startTime + CONNECTION_TIMEOUT > now) {
-									m_table.put(list[i], Move(old));
-								}
+					if (tick < m_tickCurrent) {
+						return;
+					}
+					sl_uint64 n = tick - m_tickCurrent + 1;
+					if (n > TIMER_WHEEL_SIZE) {
+						n = TIMER_WHEEL_SIZE;
+					}
+					if (m_count) {
+						for (sl_uint64 k = 0; k < n; k++) {
+							sl_uint32* head = m_wheel + ((m_tickCurrent + k) & (TIMER_WHEEL_SIZE - 1));
+							while (*head != INVALID_INDEX) {
+								remove(getEntry(*head));
+								countExpired++;
 							}
 						}
-					} else {
-						WriteLocker lock(&m_lock);
-						m_table.removeAll();
 					}
+					m_tickCurrent = tick + 1;
 				}
 
 			private:
-				HashTable< sl_uint64, Shared<TcpConnection> > m_table;
-				ReadWriteLock m_lock;
-			};
+				FlowEntry* getEntry(sl_uint32 index) noexcept
+				{
+					return m_chunks[index / FLOW_ENTRY_CHUNK_SIZE] + (index % FLOW_ENTRY_CHUNK_SIZE);
+				}
 
-			class TcpConnectionTable
-			{
-			public:
-				TcpConnectionTable()
+				FlowEntry* allocateEntry() noexcept
 				{
-					m_threadGC = Thread::start(SLIB_FUNCTION_MEMBER(this, onRunGC));
+					if (m_indexFree != INVALID_INDEX) {
+						FlowEntry* entry = getEntry(m_indexFree);
+						m_indexFree = entry->next;
+						return entry;
+					}
+					if (m_nAllocated < m_capacity) {
+						sl_uint32 index = m_nAllocated;
+						FlowEntry*& chunk = m_chunks[index / FLOW_ENTRY_CHUNK_SIZE];
+						if (!chunk) {
+							chunk = (FlowEntry*)(Base::createMemory(sizeof(FlowEntry) * FLOW_ENTRY_CHUNK_SIZE));
+							if (!chunk) {
+								return sl_null;
+							}
+						}
+						m_nAllocated++;
+						FlowEntry* entry = chunk + (index % FLOW_ENTRY_CHUNK_SIZE);
+						entry->index = index;
+						return entry;
+					}
+					// Evicts the entry expiring first
+					for (sl_uint32 k = 0; k < TIMER_WHEEL_SIZE; k++) {
+						sl_uint32 head = m_wheel[(m_tickCurrent + k) & (TIMER_WHEEL_SIZE - 1)];
+						if (head != INVALID_INDEX) {
+							remove(getEntry(head));
+							countEvicted++;
+							return allocateEntry();
+						}
+					}
+					return sl_null;
 				}
 
-				~TcpConnectionTable()
+				void removeCell(sl_uint32 i) noexcept
 				{
-					if (m_threadGC.isNotNull()) {
-						m_threadGC->finishAndWait();
+					sl_uint32 j = i;
+					for (;;) {
+						j = (j + 1) & m_maskCells;
+						sl_uint64 cell = m_cells[j];
+						if (!cell) {
+							break;
+						}
+						sl_uint32 k = (sl_uint32)(cell >> 32) & m_maskCells;
+						// Moves back the cell unless its home slot is in (i, j]
+						if (i <= j ? (k <= i || k > j) : (k <= i && k > j)) {
+							m_cells[i] = cell;
+							i = j;
+						}
 					}
+					m_cells[i] = 0;
 				}
 
-			public:
-				Shared<TcpConnection> get(const IPv4Address& address, sl_uint16 port) noexcept
+				void linkWheel(FlowEntry* entry) noexcept
 				{
-					return m_entries[port & (CONNECTION_TABLE_LENGTH - 1)].get(address, port);
+					sl_uint32& head = m_wheel[entry->tickExpire & (TIMER_WHEEL_SIZE - 1)];
+					entry->prev = INVALID_INDEX;
+					entry->next = head;
+					if (head != INVALID_INDEX) {
+						getEntry(head)->prev = entry->index;
+					}
+					head = entry->index;
 				}
 
-				Shared<TcpConnection> create(IPv4Packet* packet, TcpSegment* tcp) noexcept
+				void unlinkWheel(FlowEntry* entry) noexcept
 				{
-					return m_entries[tcp->getSourcePort() & (CONNECTION_TABLE_LENGTH - 1)].create(packet, tcp);
+					if (entry->prev != INVALID_INDEX) {
+						getEntry(entry->prev)->next = entry->next;
+					} else {
+						m_wheel[entry->tickExpire & (TIMER_WHEEL_SIZE - 1)] = entry->next;
+					}
+					if (entry->next != INVALID_INDEX) {
+						getEntry(entry->next)->prev = entry->prev;
+					}
 				}
 
-				void remove(const IPv4Address& address, sl_uint16 port) noexcept
+			private:
+				sl_uint64* m_cells;
+				sl_uint32 m_maskCells;
+
+				FlowEntry** m_chunks;
+				sl_uint32 m_nChunks;
+				sl_uint32 m_capacity;
+				sl_uint32 m_nAllocated;
+				sl_uint32 m_indexFree;
+				sl_uint32 m_count;
+
+				sl_uint32 m_wheel[TIMER_WHEEL_SIZE];
+				sl_uint64 m_tickCurrent;
+				sl_uint64 m_granularity;
+				sl_uint32 m_timeout;
+
+			};
+
+			class FlowLane
+			{
+			public:
+				FlowTable table;
+				PacketAnalyzerStatistics statistics;
+				Mutex lock; // Locked by the synchronous calls
+
+				// Queue of the worker
+				Ref<Thread> thread;
+				SpinLock lockQueue;
+				sl_uint8* queue;
+				sl_uint8* queueProcessing;
+				sl_uint32 sizeQueue;
+				sl_uint32 capacityQueue;
+				sl_bool flagWaiting;
+				sl_uint64 countDrops;
+
+			public:
+				FlowLane() noexcept
 				{
-					m_entries[port & (CONNECTION_TABLE_LENGTH - 1)].remove(address, port);
+					queue = sl_null;
+					queueProcessing = sl_null;
+					sizeQueue = 0;
+					capacityQueue = 0;
+					flagWaiting = sl_false;
+					countDrops = 0;
 				}
 
-				void onRunGC()
+				~FlowLane()
 				{
-					Thread* thread = Thread::getCurrent();
-					if (!thread) {
-						return;
+					if (queue) {
+						Base::freeMemory(queue);
 					}
-					while (thread->isNotStopping()) {
-						sl_uint64 now = System::getHighResolutionTickCount();
-						for (sl_size i = 0; i < CONNECTION_TABLE_LENGTH && thread->isNotStopping(); i++) {
-							m_entries[i].removeOldConnections(now);
-						}
-						thread->wait(CONNECTION_TIMEOUT);
+					if (queueProcessing) {
+						Base::freeMemory(queueProcessing);
 					}
 				}
 
-			private:
-				TcpConnectionTableEntry m_entries[CONNECTION_TABLE_LENGTH];
-				Ref<Thread> m_threadGC;
+			};
 
+			struct QueuedPacket
+			{
+				NetCapture* capture;
+				void* userData;
+				sl_uint32 type;
+				sl_uint32 sizeFrame;
+				sl_uint32 offsetPacket;
+				sl_uint32 sizeRecord;
 			};
 
-			class ContentAnalyzer : public Referable
+			class ContentAnalyzer
 			{
 			public:
-				void analyze(PacketAnalyzerHelper* parent, IPv4Packet* packet, TcpSegment* tcp, sl_uint8* data, sl_uint32 sizeData, void* userData)
+				static void analyze(PacketAnalyzerHelper* parent, FlowLane* lane, IPv4Packet* packet, TcpSegment* tcp, sl_uint8* data, sl_uint32 sizeData, void* userData)
 				{
-					Shared<TcpConnection> connection;
+					FlowTable& table = lane->table;
+					FlowKey key;
+					key.setTcp(packet, tcp, sl_false);
+					FlowEntry* flow;
 					if (tcp->isSYN()) {
 						if (tcp->isACK()) {
 							return;
@@ -239,64 +534,63 @@ namespace slib
 						if (parent->m_flagGatheringHostInfo) {
 							parent->resetHostInfo(packet, tcp);
 						}
-						connection = m_table.create(packet, tcp);
-						if (connection.isNull()) {
+						flow = table.create(key, key.getHash(), System::getTickCount64());
+						if (!flow) {
 							return;
 						}
+						flow->startSequenceNumber = tcp->getSequenceNumber();
 					} else if (tcp->isFIN() || tcp->isRST()) {
-						m_table.remove(packet->getSourceAddress(), tcp->getSourcePort());
-						m_table.remove(packet->getDestinationAddress(), tcp->getDestinationPort());
+						table.remove(key);
+						key.setTcp(packet, tcp, sl_true);
+						table.remove(key);
 						return;
 					} else {
-						connection = m_table.get(packet->getSourceAddress(), tcp->getSourcePort());
-						if (connection.isNotNull()) {
-							if (connection->destinationIp != packet->getDestinationAddress() || connection->destinationPort != tcp->getDestinationPort()) {
-								m_table.remove(packet->getSourceAddress(), tcp->getSourcePort());
-								if (parent->m_flagGatheringHostInfo) {
-									parent->resetHostInfo(packet, tcp);
-								}
-								return;
-							}
-						} else {
+						if (!(table.getCount())) {
+							return;
+						}
+						flow = table.find(key, key.getHash());
+						if (!flow) {
 							return;
 						}
 					}
 					if (!sizeData) {
 						return;
 					}
-					TcpConnection* c = connection.get();
-					if (!(c->addContent(tcp, data, sizeData))) {
-						m_table.remove(packet->getSourceAddress(), tcp->getSourcePort());
+					if (!(flow->addContent(tcp, data, sizeData))) {
+						table.remove(flow);
 						return;
 					}
+					sl_bool flagRemove = sl_false;
 					sl_bool flagNotHttp = sl_true;
 					if (parent->m_flagAnalyzeHttp) {
-						flagNotHttp = c->flagNotHttp;
+						flagNotHttp = flow->flagNotHttp;
 						if (!flagNotHttp) {
-							ContentResult result = analyzeHttp(parent, packet, tcp, c->content, c->sizeContent, userData);
+							ContentResult result = analyzeHttp(parent, packet, tcp, flow->content, flow->sizeContent, userData);
 							if (result == ContentResult::Success) {
-								m_table.remove(packet->getSourceAddress(), tcp->getSourcePort());
+								lane->statistics.countHttp++;
+								flagRemove = sl_true;
 							} else if (result == ContentResult::Error) {
-								c->flagNotHttp = sl_true;
+								flow->flagNotHttp = sl_true;
 								flagNotHttp = sl_true;
 							}
 						}
 					}
 					sl_bool flagNotHttps = sl_true;
-					if (parent->m_flagAnalyzeHttps) {
-						flagNotHttps = c->flagNotHttps;
+					if (parent->m_flagAnalyzeHttps && !flagRemove) {
+						flagNotHttps = flow->flagNotHttps;
 						if (!flagNotHttps) {
-							ContentResult result = analyzeHttps(parent, packet, tcp, c->content, c->sizeContent, userData);
+							ContentResult result = analyzeHttps(parent, packet, tcp, flow->content, flow->sizeContent, userData);
 							if (result == ContentResult::Success) {
-								m_table.remove(packet->getSourceAddress(), tcp->getSourcePort());
+								lane->statistics.countHttps++;
+								flagRemove = sl_true;
 							} else if (result == ContentResult::Error) {
-								c->flagNotHttps = sl_true;
+								flow->flagNotHttps = sl_true;
 								flagNotHttps = sl_true;
 							}
 						}
 					}
-					if (flagNotHttp && flagNotHttps) {
-						m_table.remove(packet->getSourceAddress(), tcp->getSourcePort());
+					if (flagRemove || (flagNotHttp && flagNotHttps)) {
+						table.remove(flow);
 					}
 				}
 
@@ -307,7 +601,7 @@ namespace slib
 					Error = 2
 				};
 
-				ContentResult analyzeHttp(PacketAnalyzerHelper* parent, IPv4Packet* packet, TcpSegment* tcp, char* content, sl_uint32 size, void* userData)
+				static ContentResult analyzeHttp(PacketAnalyzerHelper* parent, IPv4Packet* packet, TcpSegment* tcp, char* content, sl_uint32 size, void* userData)
 				{
 					if (size < 4) {
 						return ContentResult::InProgress;
@@ -382,7 +676,7 @@ namespace slib
 					}
 				}
 
-				ContentResult analyzeHttps(PacketAnalyzerHelper* parent, IPv4Packet* packet, TcpSegment* tcp, char* content, sl_uint32 size, void* userData)
+				static ContentResult analyzeHttps(PacketAnalyzerHelper* parent, IPv4Packet* packet, TcpSegment* tcp, char* content, sl_uint32 size, void* userData)
 				{
 					if (size <= sizeof(TlsRecordHeader) + sizeof(TlsHandshakeProtocolHeader)) {
 						return ContentResult::InProgress;
@@ -433,20 +727,339 @@ namespace slib
 					return ContentResult::Error;
 				}
 
+			};
+
+			class FlowPipeline : public Referable
+			{
+			public:
+				PacketAnalyzerHelper* analyzer;
+				FlowLane* lanes;
+				sl_uint32 nLanes;
+				sl_bool flagWorkers;
+
+			public:
+				FlowPipeline() noexcept
+				{
+					analyzer = sl_null;
+					lanes = sl_null;
+					nLanes = 0;
+					flagWorkers = sl_false;
+				}
+
+				~FlowPipeline()
+				{
+					stopWorkers();
+					if (lanes) {
+						delete[] lanes;
+					}
+				}
+
+			public:
+				static Ref<FlowPipeline> create(PacketAnalyzerHelper* analyzer, sl_uint32 nLanes, sl_uint32 capacity, sl_uint32 timeout) noexcept
+				{
+					Ref<FlowPipeline> ret = new FlowPipeline;
+					if (ret.isNull()) {
+						return sl_null;
+					}
+					ret->lanes = new FlowLane[nLanes];
+					if (!(ret->lanes)) {
+						return sl_null;
+					}
+					ret->analyzer = analyzer;
+					ret->nLanes = nLanes;
+					sl_uint32 capacityLane = capacity / nLanes;
+					for (sl_uint32 i = 0; i < nLanes; i++) {
+						if (!(ret->lanes[i].table.initialize(capacityLane, timeout))) {
+							return sl_null;
+						}
+					}
+					return ret;
+				}
+
+				sl_bool startWorkers(sl_uint32 sizeQueue) noexcept
+				{
+					for (sl_uint32 i = 0; i < nLanes; i++) {
+						FlowLane& lane = lanes[i];
+						lane.queue = (sl_uint8*)(Base::createMemory(sizeQueue));
+						lane.queueProcessing = (sl_uint8*)(Base::createMemory(sizeQueue));
+						if (!(lane.queue && lane.queueProcessing)) {
+							return sl_false;
+						}
+						lane.capacityQueue = sizeQueue;
+						lane.thread = Thread::create(SLIB_BIND_MEMBER(void(), this, runWorker, &lane));
+						if (lane.thread.isNull()) {
+							return sl_false;
+						}
+					}
+					flagWorkers = sl_true;
+					for (sl_uint32 i = 0; i < nLanes; i++) {
+						lanes[i].thread->start();
+					}
+					return sl_true;
+				}
+
+				void stopWorkers() noexcept
+				{
+					if (!flagWorkers) {
+						return;
+					}
+					for (sl_uint32 i = 0; i < nLanes; i++) {
+						lanes[i].thread->finish();
+					}
+					for (sl_uint32 i = 0; i < nLanes; i++) {
+						lanes[i].thread->finishAndWait();
+						lanes[i].thread.setNull();
+					}
+					flagWorkers = sl_false;
+				}
+
+				void put(const PacketAnalyzerHelper::PacketParam* params, sl_uint32 n) noexcept
+				{
+					if (n == 1) {
+						FlowLane* lane = lanes + (GetLaneHash(*params) % nLanes);
+						if (flagWorkers) {
+							sl_uint32 index = 0;
+							enqueue(lane, params, &index, 1);
+						} else {
+							MutexLocker lock(&(lane->lock));
+							analyze(lane, *params);
+						}
+						return;
+					}
+					// Groups the packets by the lane, so that each lane is locked once per batch
+					sl_uint32 laneIndices[DISPATCH_BATCH_SIZE];
+					sl_uint32 order[DISPATCH_BATCH_SIZE];
+					sl_uint32 offsets[MAX_WORKER_COUNT + 1];
+					while (n) {
+						sl_uint32 m = n;
+						if (m > DISPATCH_BATCH_SIZE) {
+							m = DISPATCH_BATCH_SIZE;
+						}
+						Base::zeroMemory(offsets, sizeof(sl_uint32) * (nLanes + 1));
+						for (sl_uint32 i = 0; i < m; i++) {
+							sl_uint32 k = GetLaneHash(params[i]) % nLanes;
+							laneIndices[i] = k;
+							offsets[k + 1]++;
+						}
+						for (sl_uint32 k = 0; k < nLanes; k++) {
+							offsets[k + 1] += offsets[k];
+						}
+						for (sl_uint32 i = 0; i < m; i++) {
+							order[offsets[laneIndices[i]]++] = i;
+						}
+						sl_uint32 start = 0;
+						for (sl_uint32 k = 0; k < nLanes; k++) {
+							sl_uint32 end = offsets[k];
+							if (end > start) {
+								FlowLane* lane = lanes + k;
+								if (flagWorkers) {
+									enqueue(lane, params, order + start, end - start);
+								} else {
+									MutexLocker lock(&(lane->lock));
+									for (sl_uint32 i = start; i < end; i++) {
+										analyze(lane, params[order[i]]);
+									}
+								}
+							}
+							start = end;
+						}
+						params += m;
+						n -= m;
+					}
+				}
+
+				void getStatistics(PacketAnalyzerStatistics& _out) noexcept
+				{
+					for (sl_uint32 i = 0; i < nLanes; i++) {
+						FlowLane& lane = lanes[i];
+						PacketAnalyzerStatistics& s = lane.statistics;
+						_out.countPackets += s.countPackets;
+						_out.countBytes += s.countBytes;
+						_out.countDrops += lane.countDrops;
+						_out.countIPv4 += s.countIPv4;
+						_out.countInvalidIPv4 += s.countInvalidIPv4;
+						_out.countArp += s.countArp;
+						_out.countTcp += s.countTcp;
+						_out.countUdp += s.countUdp;
+						_out.countIcmp += s.countIcmp;
+						_out.countDns += s.countDns;
+						_out.countHttp += s.countHttp;
+						_out.countHttps += s.countHttps;
+						_out.countBlocked += s.countBlocked;
+						_out.countFlowsCreated += lane.table.countCreated;
+						_out.countFlowsExpired += lane.table.countExpired;
+						_out.countFlowsEvicted += lane.table.countEvicted;
+						_out.countFlows += lane.table.getCount();
+					}
+				}
+
 			private:
-				TcpConnectionTable m_table;
+				void analyze(FlowLane* lane, const PacketAnalyzerHelper::PacketParam& _param) noexcept
+				{
+					PacketAnalyzerHelper::PacketParam param = _param;
+					param.lane = lane;
+					lane->statistics.countPackets++;
+					lane->statistics.countBytes += param.sizeFrame;
+					analyzer->analyzeFrame(param);
+				}
+
+				void enqueue(FlowLane* lane, const PacketAnalyzerHelper::PacketParam* params, sl_uint32* indices, sl_uint32 n) noexcept
+				{
+					sl_bool flagWake = sl_false;
+					{
+						SpinLocker lock(&(lane->lockQueue));
+						for (sl_uint32 i = 0; i < n; i++) {
+							const PacketAnalyzerHelper::PacketParam& param = params[indices[i]];
+							sl_uint32 sizeRecord = (sl_uint32)(sizeof(QueuedPacket) + param.sizeFrame + 7) & ~((sl_uint32)7);
+							if (lane->sizeQueue + sizeRecord > lane->capacityQueue) {
+								lane->countDrops++;
+								continue;
+							}
+							QueuedPacket* record = (QueuedPacket*)(lane->queue + lane->sizeQueue);
+							record->capture = param.capture;
+							record->userData = param.userData;
+							record->type = (sl_uint32)(param.type);
+							record->sizeFrame = param.sizeFrame;
+							record->offsetPacket = (sl_uint32)(param.packet - param.frame);
+							record->sizeRecord = sizeRecord;
+							Base::copyMemory(record + 1, param.frame, param.sizeFrame);
+							lane->sizeQueue += sizeRecord;
+						}
+						if (lane->flagWaiting && lane->sizeQueue) {
+							lane->flagWaiting = sl_false;
+							flagWake = sl_true;
+						}
+					}
+					if (flagWake) {
+						lane->thread->wakeSelfEvent();
+					}
+				}
+
+				void runWorker(FlowLane* lane)
+				{
+					Thread* thread = Thread::getCurrent();
+					if (!thread) {
+						return;
+					}
+					for (;;) {
+						sl_uint32 size;
+						{
+							SpinLocker lock(&(lane->lockQueue));
+							size = lane->sizeQueue;
+							if (size) {
+								Swap(lane->queue, lane->queueProcessing);
+								lane->sizeQueue = 0;
+							} else {
+								lane->flagWaiting = sl_true;
+							}
+						}
+						if (size) {
+							sl_uint8* p = lane->queueProcessing;
+							sl_uint8* end = p + size;
+							while (p < end) {
+								QueuedPacket* record = (QueuedPacket*)p;
+								PacketAnalyzerHelper::PacketParam param;
+								param.capture = record->capture;
+								param.type = (NetworkLinkDeviceType)(record->type);
+								param.frame = (sl_uint8*)(record + 1);
+								param.sizeFrame = record->sizeFrame;
+								param.packet = param.frame + record->offsetPacket;
+								param.sizePacket = record->sizeFrame - record->offsetPacket;
+								param.userData = record->userData;
+								analyze(lane, param);
+								p += record->sizeRecord;
+							}
+						} else {
+							// Stops after analyzing all the queued packets
+							if (thread->isStopping()) {
+								break;
+							}
+							thread->wait(WORKER_IDLE_TIMEOUT);
+						}
+						lane->table.expire(System::getTickCount64());
+					}
+				}
 
 			};
 
+			static sl_bool PrepareParam(PacketAnalyzerHelper::PacketParam& param, NetCapture* capture, NetworkLinkDeviceType type, const void* frame, sl_size size, void* userData) noexcept
+			{
+				param.capture = capture;
+				param.type = type;
+				param.frame = (sl_uint8*)frame;
+				param.sizeFrame = (sl_uint32)size;
+				param.userData = userData;
+				param.lane = sl_null;
+				if (type == NetworkLinkDeviceType::Ethernet) {
+					if (size <= EthernetFrame::HeaderSize) {
+						return sl_false;
+					}
+					param.packet = (sl_uint8*)frame + EthernetFrame::HeaderSize;
+					param.sizePacket = (sl_uint32)size - EthernetFrame::HeaderSize;
+					return sl_true;
+				} else if (type == NetworkLinkDeviceType::Raw) {
+					param.packet = (sl_uint8*)frame;
+					param.sizePacket = (sl_uint32)size;
+					return sl_true;
+				} else if (type == NetworkLinkDeviceType::Null) {
+					if (size > 4) {
+						if (MIO::readUint32LE(frame) == 2 /*AF_INET*/) {
+							param.packet = (sl_uint8*)frame + 4;
+							param.sizePacket = (sl_uint32)size - 4;
+							return sl_true;
+						}
+					}
+				}
+				return sl_false;
+			}
+
+			static FlowPipeline* GetPipeline(PacketAnalyzer* analyzer, Ref<Referable>& pipeline, Mutex& lock, sl_uint32 capacity, sl_uint32 timeout) noexcept
+			{
+				if (pipeline.isNull()) {
+					MutexLocker locker(&lock);
+					if (pipeline.isNull()) {
+						pipeline = FlowPipeline::create((PacketAnalyzerHelper*)analyzer, SYNC_LANE_COUNT, capacity, timeout);
+					}
+				}
+				return (FlowPipeline*)(pipeline.get());
+			}
+
 		}
 	}
 
 	using namespace priv::packet_analyzer;
 
+	PacketAnalyzerStatistics::PacketAnalyzerStatistics()
+	{
+		countPackets = 0;
+		countBytes = 0;
+		countDrops = 0;
+
+		countIPv4 = 0;
+		countInvalidIPv4 = 0;
+		countArp = 0;
+		countTcp = 0;
+		countUdp = 0;
+		countIcmp = 0;
+
+		countDns = 0;
+		countHttp = 0;
+		countHttps = 0;
+		countBlocked = 0;
+
+		countFlowsCreated = 0;
+		countFlowsExpired = 0;
+		countFlowsEvicted = 0;
+		countFlows = 0;
+	}
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(PacketAnalyzerStatistics)
+
 	PacketAnalyzer::PacketAnalyzer()
 	{
 		m_flagLogging = sl_false;
 
+		m_flagAnalyzeIPv4 = sl_false;
 		m_flagAnalyzeArp = sl_false;
 		m_flagAnalyzeTcp = sl_false;
 		m_flagAnalyzeUdp = sl_false;
@@ -461,36 +1074,26 @@ namespace slib
 		m_flagIgnoreLocalPackets = sl_false;
 		m_flagIgnoreUnknownPorts = sl_false;
 		m_flagBlockingTcpConnections = sl_false;
+
+		m_flowTableCapacity = DEFAULT_FLOW_TABLE_CAPACITY;
+		m_flowTimeout = DEFAULT_FLOW_TIMEOUT;
+		m_sizeWorkerQueue = DEFAULT_WORKER_QUEUE_SIZE;
 	}
 
 	PacketAnalyzer::~PacketAnalyzer()
 	{
+		stopWorkers();
 	}
 
 	void PacketAnalyzer::putCapturedPacket(NetCapture* capture, NetworkLinkDeviceType type, const void* frame, sl_size size, void* userData)
 	{
-		if (type == NetworkLinkDeviceType::Ethernet) {
-			putEthernet(capture, frame, size, userData);
-		} else {
-			PacketParam param;
-			param.capture = capture;
-			param.type = type;
-			param.frame = (sl_uint8*)frame;
-			param.sizeFrame = (sl_uint32)size;
-			param.userData = userData;
-			if (type == NetworkLinkDeviceType::Raw) {
-				param.packet = (sl_uint8*)frame;
-				param.sizePacket = (sl_uint32)size;
-				analyzeIP(param);
-			} else if (type == NetworkLinkDeviceType::Null) {
-				if (size > 4) {
-					if (MIO::readUint32LE(frame) == 2 /*AF_INET*/) {
-						param.packet = (sl_uint8*)frame + 4;
-						param.sizePacket = (sl_uint32)size - 4;
-						analyzeIP(param);
-					}
-				}
-			}
+		PacketParam param;
+		if (!(PrepareParam(param, capture, type, frame, size, userData))) {
+			return;
+		}
+		FlowPipeline* pipeline = GetPipeline(this, m_pipeline, m_lockPipeline, m_flowTableCapacity, m_flowTimeout);
+		if (pipeline) {
+			pipeline->put(&param, 1);
 		}
 	}
 
@@ -499,70 +1102,141 @@ namespace slib
 		putCapturedPacket(capture, capture->getLinkType(), packet, size, userData);
 	}
 
+	void PacketAnalyzer::putCapturedPackets(NetCapture* capture, NetworkLinkDeviceType type, NetCapturePacket* packets, sl_uint32 nPackets, void* userData)
+	{
+		FlowPipeline* pipeline = GetPipeline(this, m_pipeline, m_lockPipeline, m_flowTableCapacity, m_flowTimeout);
+		if (!pipeline) {
+			return;
+		}
+		PacketParam params[DISPATCH_BATCH_SIZE];
+		sl_uint32 n = 0;
+		for (sl_uint32 i = 0; i < nPackets; i++) {
+			if (PrepareParam(params[n], capture, type, packets[i].data, packets[i].length, userData)) {
+				n++;
+				if (n >= DISPATCH_BATCH_SIZE) {
+					pipeline->put(params, n);
+					n = 0;
+				}
+			}
+		}
+		if (n) {
+			pipeline->put(params, n);
+		}
+	}
+
+	void PacketAnalyzer::putCapturedPackets(NetCapture* capture, NetCapturePacket* packets, sl_uint32 nPackets, void* userData)
+	{
+		putCapturedPackets(capture, capture->getLinkType(), packets, nPackets, userData);
+	}
+
 	void PacketAnalyzer::putEthernet(NetCapture* capture, const void* frame, sl_size size, void* userData)
 	{
-		if (size <= EthernetFrame::HeaderSize) {
+		putCapturedPacket(capture, NetworkLinkDeviceType::Ethernet, frame, size, userData);
+	}
+
+	void PacketAnalyzer::putEthernet(const void* packet, sl_size size, void* userData)
+	{
+		putEthernet(sl_null, packet, size, userData);
+	}
+
+	void PacketAnalyzer::putIP(NetCapture* capture, const void* packet, sl_size size, void* userData)
+	{
+		putCapturedPacket(capture, NetworkLinkDeviceType::Raw, packet, size, userData);
+	}
+
+	void PacketAnalyzer::putIP(const void* packet, sl_size size, void* userData)
+	{
+		putIP(sl_null, packet, size, userData);
+	}
+
+	sl_bool PacketAnalyzer::startWorkers(sl_uint32 nWorkers)
+	{
+		MutexLocker lock(&m_lockPipeline);
+		FlowPipeline* current = (FlowPipeline*)(m_pipeline.get());
+		if (current && current->flagWorkers) {
+			return sl_false;
+		}
+		if (!nWorkers) {
+			nWorkers = Cpu::getCoreCount();
+		}
+		nWorkers = Math::clamp(nWorkers, (sl_uint32)1, (sl_uint32)MAX_WORKER_COUNT);
+		Ref<FlowPipeline> pipeline = FlowPipeline::create((PacketAnalyzerHelper*)this, nWorkers, m_flowTableCapacity, m_flowTimeout);
+		if (pipeline.isNull()) {
+			return sl_false;
+		}
+		if (!(pipeline->startWorkers(m_sizeWorkerQueue))) {
+			return sl_false;
+		}
+		m_pipeline = Move(pipeline);
+		return sl_true;
+	}
+
+	void PacketAnalyzer::stopWorkers()
+	{
+		MutexLocker lock(&m_lockPipeline);
+		FlowPipeline* pipeline = (FlowPipeline*)(m_pipeline.get());
+		if (pipeline) {
+			pipeline->stopWorkers();
+		}
+	}
+
+	sl_uint32 PacketAnalyzer::getWorkerCount()
+	{
+		MutexLocker lock(&m_lockPipeline);
+		FlowPipeline* pipeline = (FlowPipeline*)(m_pipeline.get());
+		if (pipeline && pipeline->flagWorkers) {
+			return pipeline->nLanes;
+		}
+		return 0;
+	}
+
+	void PacketAnalyzer::getStatistics(PacketAnalyzerStatistics& _out)
+	{
+		_out = PacketAnalyzerStatistics();
+		MutexLocker lock(&m_lockPipeline);
+		FlowPipeline* pipeline = (FlowPipeline*)(m_pipeline.get());
+		if (pipeline) {
+			pipeline->getStatistics(_out);
+		}
+	}
+
+	void PacketAnalyzer::analyzeFrame(const PacketAnalyzer::PacketParam& param)
+	{
+		if (param.type != NetworkLinkDeviceType::Ethernet) {
+			analyzeIP(param);
 			return;
 		}
-		EthernetFrame* eth = (EthernetFrame*)frame;
+		EthernetFrame* eth = (EthernetFrame*)(param.frame);
 		NetworkLinkProtocol protocol = eth->getProtocol();
 		if (protocol == NetworkLinkProtocol::IPv4) {
-			PacketParam param;
-			param.capture = capture;
-			param.type = NetworkLinkDeviceType::Ethernet;
-			param.frame = (sl_uint8*)frame;
-			param.sizeFrame = (sl_uint32)size;
-			param.userData = userData;
-			param.packet = (sl_uint8*)frame + EthernetFrame::HeaderSize;
-			param.sizePacket = (sl_uint32)size - EthernetFrame::HeaderSize;
 			analyzeIP(param);
 		} else if (protocol == NetworkLinkProtocol::ARP) {
 			if (m_flagAnalyzeArp) {
-				if (size >= EthernetFrame::HeaderSize + ArpPacket::SizeForIPv4) {
-					ArpPacket* arp = (ArpPacket*)((sl_uint8*)frame + EthernetFrame::HeaderSize);
+				if (param.sizePacket >= ArpPacket::SizeForIPv4) {
+					ArpPacket* arp = (ArpPacket*)(param.packet);
 					if (arp->isValidEthernetIPv4()) {
+						((FlowLane*)(param.lane))->statistics.countArp++;
 						ArpOperation op = arp->getOperation();
 						if (op == ArpOperation::Request) {
-							onARP_IPv4(eth, arp, sl_true, userData);
+							onARP_IPv4(eth, arp, sl_true, param.userData);
 						} else if (op == ArpOperation::Reply) {
-							onARP_IPv4(eth, arp, sl_false, userData);
+							onARP_IPv4(eth, arp, sl_false, param.userData);
 						}
 					}
 				}
 			}
 		} else {
 			if (m_flagCaptureUnknownFrames) {
-				onUnknownFrame(eth, (sl_uint8*)frame + EthernetFrame::HeaderSize, (sl_uint32)size - EthernetFrame::HeaderSize, userData);
+				onUnknownFrame(eth, param.packet, param.sizePacket, param.userData);
 			}
 		}
 	}
 
-	void PacketAnalyzer::putEthernet(const void* packet, sl_size size, void* userData)
-	{
-		putEthernet(sl_null, packet, size, userData);
-	}
-
-	void PacketAnalyzer::putIP(NetCapture* capture, const void* packet, sl_size size, void* userData)
-	{
-		PacketParam param;
-		param.capture = capture;
-		param.type = NetworkLinkDeviceType::Raw;
-		param.frame = (sl_uint8*)packet;
-		param.sizeFrame = (sl_uint32)size;
-		param.packet = (sl_uint8*)packet;
-		param.sizePacket = (sl_uint32)size;
-		param.userData = userData;
-		analyzeIP(param);
-	}
-
-	void PacketAnalyzer::putIP(const void* packet, sl_size size, void* userData)
-	{
-		putIP(sl_null, packet, size, userData);
-	}
-
 	void PacketAnalyzer::analyzeIP(const PacketAnalyzer::PacketParam& param)
 	{
+		PacketAnalyzerStatistics& statistics = ((FlowLane*)(param.lane))->statistics;
 		if (param.sizePacket <= IPv4Packet::HeaderSizeBeforeOptions) {
+			statistics.countInvalidIPv4++;
 			return;
 		}
 		sl_bool flagAnalyzeTcp = m_flagAnalyzeTcp || m_flagAnalyzeHttp || m_flagAnalyzeHttps || m_flagBlockingTcpConnections;
@@ -572,6 +1246,7 @@ namespace slib
 			sl_uint8 sizeHeader = ip->getHeaderSize();
 			sl_uint16 sizeTotal = ip->getTotalSize();
 			if (sizeTotal > param.sizePacket || sizeHeader > sizeTotal) {
+				statistics.countInvalidIPv4++;
 				return;
 			}
 			if (m_flagIgnoreLocalPackets) {
@@ -579,6 +1254,7 @@ namespace slib
 					return;
 				}
 			}
+			statistics.countIPv4++;
 			if (m_flagAnalyzeIPv4) {
 				onIPv4(ip, param.userData);
 			}
@@ -595,11 +1271,12 @@ namespace slib
 					if (sizeContent < sizeHeader) {
 						return;
 					}
+					statistics.countTcp++;
 					if (m_flagAnalyzeTcp) {
 						onTCP_IPv4(ip, tcp, tcp->getContent(), sizeContent - sizeHeader, param.userData);
 					}
 					if (m_flagAnalyzeHttp || m_flagAnalyzeHttps) {
-						analyzeTcpContent(ip, tcp, tcp->getContent(), sizeContent - sizeHeader, param.userData);
+						analyzeTcpContent(param, ip, tcp, tcp->getContent(), sizeContent - sizeHeader);
 					}
 					if (m_flagBlockingTcpConnections) {
 						sendBlockingIPv4TcpPacket(param, tcp);
@@ -611,6 +1288,7 @@ namespace slib
 						return;
 					}
 					UdpDatagram* udp = (UdpDatagram*)content;
+					statistics.countUdp++;
 					if (m_flagAnalyzeUdp) {
 						onUDP_IPv4(ip, udp, udp->getContent(), sizeContent - UdpDatagram::HeaderSize, param.userData);
 					}
@@ -618,6 +1296,7 @@ namespace slib
 						if (udp->getSourcePort() == 53 || udp->getDestinationPort() == 53) {
 							DnsPacket dns;
 							if (dns.parsePacket(udp->getContent(), sizeContent - UdpDatagram::HeaderSize)) {
+								statistics.countDns++;
 								if (m_flagGatheringHostInfo) {
 									if (!(dns.flagQuestion)) {
 										WriteLocker locker(&m_lockDnsInfo);
@@ -639,6 +1318,7 @@ namespace slib
 						return;
 					}
 					IcmpHeaderFormat* icmp = (IcmpHeaderFormat*)content;
+					statistics.countIcmp++;
 					onICMP_IPv4(ip, icmp, icmp->getContent(), sizeContent - sizeof(IcmpHeaderFormat), param.userData);
 				}
 			}
@@ -728,6 +1408,21 @@ namespace slib
 		m_flagBlockingTcpConnections = flag;
 	}
 
+	void PacketAnalyzer::setFlowTableCapacity(sl_uint32 capacity)
+	{
+		m_flowTableCapacity = capacity;
+	}
+
+	void PacketAnalyzer::setFlowTimeout(sl_uint32 timeout)
+	{
+		m_flowTimeout = timeout;
+	}
+
+	void PacketAnalyzer::setWorkerQueueSize(sl_uint32 size)
+	{
+		m_sizeWorkerQueue = size;
+	}
+
 	void PacketAnalyzer::onIPv4(IPv4Packet* packet, void* userData)
 	{
 		if (m_flagLogging) {
@@ -869,7 +1564,7 @@ namespace slib
 		return sl_false;
 	}
 
-	void PacketAnalyzer::analyzeTcpContent(IPv4Packet* packet, TcpSegment* tcp, sl_uint8* data, sl_uint32 sizeData, void* userData)
+	void PacketAnalyzer::analyzeTcpContent(const PacketAnalyzer::PacketParam& param, IPv4Packet* packet, TcpSegment* tcp, sl_uint8* data, sl_uint32 sizeData)
 	{
 		if (m_flagIgnoreUnknownPorts) {
 			sl_uint16 port = tcp->getDestinationPort();
@@ -877,16 +1572,7 @@ namespace slib
 				return;
 			}
 		}
-		if (m_contentAnalyzer.isNull()) {
-			MutexLocker lock(&m_lockContentAnalyzer);
-			if (m_contentAnalyzer.isNull()) {
-				m_contentAnalyzer = new ContentAnalyzer;
-				if (m_contentAnalyzer.isNull()) {
-					return;
-				}
-			}
-		}
-		((ContentAnalyzer*)(m_contentAnalyzer.get()))->analyze((PacketAnalyzerHelper*)this, packet, tcp, data, sizeData, userData);
+		ContentAnalyzer::analyze((PacketAnalyzerHelper*)this, (FlowLane*)(param.lane), packet, tcp, data, sizeData, param.userData);
 	}
 
 	void PacketAnalyzer::registerHostInfo(IPv4Packet* packet, TcpSegment* tcp, TcpConnectionType type, const String& host)
@@ -958,7 +1644,9 @@ namespace slib
 		tcpWrite->setSequenceNumber(tcp->getSequenceNumber() + ip->getTotalSize() - ip->getHeaderSize() - tcp->getHeaderSize());
 		tcpWrite->setWindowSize(0);
 		tcpWrite->updateChecksum(ipWrite, TcpSegment::HeaderSizeBeforeOptions);
-		param.capture->sendPacket(bufFrame, sizeFrame);
+		if (param.capture->sendPacket(bufFrame, sizeFrame)) {
+			((FlowLane*)(param.lane))->statistics.countBlocked++;
+		}
 	}
 
 }
@@ -65,6 +65,15 @@ namespace slib
 	{
 	}
 
+	Ref<NetCapture> Pcap::createWithPacketRing(const PcapParam& param)
+	{
+		Ref<NetCapture> capture = NetCapture::createPacketRing(param);
+		if (capture.isNotNull()) {
+			return capture;
+		}
+		return Ref<NetCapture>::from(create(param));
+	}
+
 }
 
 #if defined(SLIB_PLATFORM_IS_UNIX) || defined(SLIB_PLATFORM_IS_WIN32)
@@ -405,6 +414,22 @@ namespace slib
 					return sl_null;
 				}
 
+				sl_bool getStatistics(NetCaptureStatistics& _out) override
+				{
+					ObjectLocker lock(this);
+					if (m_flagInit) {
+						struct pcap_stat stat;
+						Base::zeroMemory(&stat, sizeof(stat));
+						if (!(pcap_stats(m_handle, &stat))) {
+							_out.countPackets = stat.ps_recv;
+							_out.countDrops = stat.ps_drop + stat.ps_ifdrop;
+							_out.countFreezes = 0;
+							return sl_true;
+						}
+					}
+					return sl_false;
+				}
+
 			};
 
 			static void ParseDeviceInfo(pcap_if_t* dev, PcapDeviceInfo& _out)
@@ -530,6 +555,20 @@ namespace slib
 					return reinterpret_cast<CList< Ref<Pcap> >*>(m_devices.duplicate());
 				}
 
+				sl_bool getStatistics(NetCaptureStatistics& _out) override
+				{
+					_out = NetCaptureStatistics();
+					ListLocker< Ref<PcapImpl> > devices(m_devices);
+					for (sl_size i = 0; i < devices.count; i++) {
+						NetCaptureStatistics statistics;
+						if (devices[i]->getStatistics(statistics)) {
+							_out.countPackets += statistics.countPackets;
+							_out.countDrops += statistics.countDrops;
+						}
+					}
+					return sl_true;
+				}
+
 			protected:
 				Ref<NetCapture> findDevice(const StringParam& _name)
 				{
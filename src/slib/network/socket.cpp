@@ -28,6 +28,8 @@
 #include "slib/core/file.h"
 #include "slib/core/system.h"
 #include "slib/core/handle_ptr.h"
+#include "slib/core/memory_view.h"
+#include "slib/core/scoped_buffer.h"
 #include "slib/core/io/impl.h"
 
 #if defined(SLIB_PLATFORM_IS_WINDOWS)
@@ -60,12 +62,19 @@ struct SOCKADDR_UN
 #		ifndef SO_REUSEPORT
 #			define SO_REUSEPORT 15
 #		endif
+#		ifndef UDP_SEGMENT
+#			define UDP_SEGMENT 103
+#		endif
+#		ifndef UDP_GRO
+#			define UDP_GRO 104
+#		endif
 #	else
 #		include <netinet/tcp.h>
 #	endif
 #	include <netinet/in.h>
 #	include <signal.h>
 #	include <stddef.h>
+#	include <limits.h>
 #	include <errno.h>
 
 typedef sockaddr_un SOCKADDR_UN;
@@ -73,6 +82,16 @@ typedef sockaddr_un SOCKADDR_UN;
 
 #endif
 
+#define MAX_MESSAGE_BATCH 64
+#define MAX_SEGMENTS_PER_SEND 64
+#define MAX_SEGMENTED_SEND_SIZE 65000
+
+#if defined(IOV_MAX)
+#	define MAX_SEND_VECTOR IOV_MAX
+#else
+#	define MAX_SEND_VECTOR 1024
+#endif
+
 namespace slib
 {
 
@@ -870,6 +889,79 @@ namespace slib
 		}
 	}
 
+	sl_int32 Socket::sendVector(const MemoryView* buffers, sl_uint32 count) const noexcept
+	{
+		if (isOpened()) {
+			if (count > MAX_SEND_VECTOR) {
+				count = MAX_SEND_VECTOR;
+			}
+			sl_size total = 0;
+#if defined(SLIB_PLATFORM_IS_WINDOWS)
+			SLIB_SCOPED_BUFFER(WSABUF, 64, bufs, count)
+			if (!bufs) {
+				return SLIB_IO_ERROR;
+			}
+			sl_uint32 n = 0;
+			for (sl_uint32 i = 0; i < count; i++) {
+				sl_size size = buffers[i].size;
+				if (total + size > 0x40000000) {
+					size = 0x40000000 - total;
+				}
+				bufs[n].buf = (CHAR*)(buffers[i].data);
+				bufs[n].len = (ULONG)size;
+				n++;
+				total += size;
+				if (total >= 0x40000000) {
+					break;
+				}
+			}
+			if (!total) {
+				return 0;
+			}
+			DWORD dwSent = 0;
+			if (!(WSASend(m_socket, bufs, (DWORD)n, &dwSent, 0, NULL, NULL))) {
+				return (sl_int32)dwSent;
+			}
+			return _processResult(SOCKET_ERROR);
+#else
+			SLIB_SCOPED_BUFFER(iovec, 64, iov, count)
+			if (!iov) {
+				return SLIB_IO_ERROR;
+			}
+			sl_uint32 n = 0;
+			for (sl_uint32 i = 0; i < count; i++) {
+				sl_size size = buffers[i].size;
+				if (total + size > 0x40000000) {
+					size = 0x40000000 - total;
+				}
+				iov[n].iov_base = buffers[i].data;
+				iov[n].iov_len = size;
+				n++;
+				total += size;
+				if (total >= 0x40000000) {
+					break;
+				}
+			}
+			if (!total) {
+				return 0;
+			}
+			msghdr hdr;
+			Base::zeroMemory(&hdr, sizeof(hdr));
+			hdr.msg_iov = iov;
+			hdr.msg_iovlen = n;
+#	if defined(SLIB_PLATFORM_IS_LINUX)
+			sl_int32 ret = (sl_int32)(::sendmsg(m_socket, &hdr, MSG_NOSIGNAL));
+#	else
+			sl_int32 ret = (sl_int32)(::sendmsg(m_socket, &hdr, 0));
+#	endif
+			return _processResult(ret);
+#endif
+		} else {
+			_setError(SocketError::Closed);
+		}
+		return SLIB_IO_ERROR;
+	}
+
 	sl_int32 Socket::write32(const void* buf, sl_uint32 size) const noexcept
 	{
 		return send(buf, size);
@@ -912,6 +1004,23 @@ namespace slib
 		return SLIB_IO_ERROR;
 	}
 
+	sl_int32 Socket::peek(void* buf, sl_size size) const noexcept
+	{
+		if (isOpened()) {
+			if (size > 0x40000000) {
+				size = 0x40000000;
+			}
+			if (!size) {
+				return SLIB_IO_EMPTY_CONTENT;
+			}
+			sl_int32 ret = (sl_int32)(::recv(m_socket, (char*)buf, (int)size, MSG_PEEK));
+			return _processResult(ret);
+		} else {
+			_setError(SocketError::Closed);
+		}
+		return SLIB_IO_ERROR;
+	}
+
 	sl_reg Socket::receiveFully(void* _buf, sl_size size, SocketEvent* ev) const noexcept
 	{
 		sl_uint8* buf = (sl_uint8*)_buf;
@@ -1088,6 +1197,264 @@ namespace slib
 		return SLIB_IO_ERROR;
 	}
 
+	sl_int32 Socket::receiveFromBatch(SocketMessage* messages, sl_uint32 count) const noexcept
+	{
+		if (!(isOpened())) {
+			_setError(SocketError::Closed);
+			return SLIB_IO_ERROR;
+		}
+		if (!count) {
+			return SLIB_IO_EMPTY_CONTENT;
+		}
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+		if (count > MAX_MESSAGE_BATCH) {
+			count = MAX_MESSAGE_BATCH;
+		}
+		mmsghdr msgs[MAX_MESSAGE_BATCH];
+		iovec iovs[MAX_MESSAGE_BATCH];
+		sockaddr_storage addrs[MAX_MESSAGE_BATCH];
+		union {
+			char buf[CMSG_SPACE(sizeof(int))];
+			cmsghdr align;
+		} controls[MAX_MESSAGE_BATCH];
+		sl_uint32 i;
+		for (i = 0; i < count; i++) {
+			iovs[i].iov_base = messages[i].data;
+			iovs[i].iov_len = messages[i].size;
+			msghdr& hdr = msgs[i].msg_hdr;
+			hdr.msg_name = addrs + i;
+			hdr.msg_namelen = sizeof(sockaddr_storage);
+			hdr.msg_iov = iovs + i;
+			hdr.msg_iovlen = 1;
+			hdr.msg_control = controls[i].buf;
+			hdr.msg_controllen = sizeof(controls[i].buf);
+			hdr.msg_flags = 0;
+			msgs[i].msg_len = 0;
+		}
+		int n = ::recvmmsg(m_socket, msgs, count, 0, sl_null);
+		if (n <= 0) {
+			return _processResult(n);
+		}
+		for (i = 0; i < (sl_uint32)n; i++) {
+			SocketMessage& message = messages[i];
+			msghdr& hdr = msgs[i].msg_hdr;
+			message.size = msgs[i].msg_len;
+			message.segmentSize = 0;
+			message.flagTruncated = (hdr.msg_flags & MSG_TRUNC) != 0;
+			if (!(message.address.setSystemSocketAddress(addrs + i, hdr.msg_namelen))) {
+				message.address.setNone();
+			}
+			for (cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+				if (cmsg->cmsg_level == IPPROTO_UDP && cmsg->cmsg_type == UDP_GRO) {
+					int seg;
+					Base::copyMemory(&seg, CMSG_DATA(cmsg), sizeof(int));
+					if (seg > 0 && (sl_uint32)seg < message.size) {
+						message.segmentSize = (sl_uint32)seg;
+					}
+				}
+			}
+		}
+		return n;
+#else
+		sl_uint32 i = 0;
+		for (; i < count; i++) {
+			SocketMessage& message = messages[i];
+			sl_int32 n = receiveFrom(message.address, message.data, message.size);
+			if (n < 0) {
+				if (i) {
+					break;
+				}
+				return n;
+			}
+			message.size = (sl_uint32)n;
+			message.segmentSize = 0;
+			message.flagTruncated = sl_false;
+		}
+		return (sl_int32)i;
+#endif
+	}
+
+	sl_int32 Socket::sendToBatch(const SocketMessage* messages, sl_uint32 count) const noexcept
+	{
+		if (!(isOpened())) {
+			_setError(SocketError::Closed);
+			return SLIB_IO_ERROR;
+		}
+		if (!count) {
+			return SLIB_IO_EMPTY_CONTENT;
+		}
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+		mmsghdr msgs[MAX_MESSAGE_BATCH];
+		iovec iovs[MAX_MESSAGE_BATCH];
+		sockaddr_storage addrs[MAX_MESSAGE_BATCH];
+		sl_uint32 nSent = 0;
+		while (nSent < count) {
+			sl_uint32 n = count - nSent;
+			if (n > MAX_MESSAGE_BATCH) {
+				n = MAX_MESSAGE_BATCH;
+			}
+			const SocketMessage* src = messages + nSent;
+			sl_uint32 i;
+			for (i = 0; i < n; i++) {
+				iovs[i].iov_base = src[i].data;
+				iovs[i].iov_len = src[i].size;
+				msghdr& hdr = msgs[i].msg_hdr;
+				hdr.msg_name = addrs + i;
+				hdr.msg_namelen = src[i].address.getSystemSocketAddress(addrs + i);
+				hdr.msg_iov = iovs + i;
+				hdr.msg_iovlen = 1;
+				hdr.msg_control = sl_null;
+				hdr.msg_controllen = 0;
+				hdr.msg_flags = 0;
+				if (!(hdr.msg_namelen)) {
+					break;
+				}
+			}
+			if (!i) {
+				_setError(SocketError::Invalid);
+				break;
+			}
+			int ret = ::sendmmsg(m_socket, msgs, i, 0);
+			if (ret <= 0) {
+				if (nSent) {
+					break;
+				}
+				if (!ret) {
+					return SLIB_IO_WOULD_BLOCK;
+				}
+				return _processResult(ret);
+			}
+			nSent += (sl_uint32)ret;
+			if ((sl_uint32)ret < n) {
+				break;
+			}
+		}
+		if (!nSent) {
+			return SLIB_IO_ERROR;
+		}
+		return (sl_int32)nSent;
+#else
+		sl_uint32 i = 0;
+		for (; i < count; i++) {
+			const SocketMessage& message = messages[i];
+			sl_int32 n = sendTo(message.address, message.data, message.size);
+			if (n < 0) {
+				if (i) {
+					break;
+				}
+				return n;
+			}
+		}
+		return (sl_int32)i;
+#endif
+	}
+
+	sl_int32 Socket::sendToSegmented(const SocketAddress& address, const void* _buf, sl_size size, sl_uint32 segmentSize) const noexcept
+	{
+		if (!(isOpened())) {
+			_setError(SocketError::Closed);
+			return SLIB_IO_ERROR;
+		}
+		if (!segmentSize || !size) {
+			return SLIB_IO_EMPTY_CONTENT;
+		}
+		if (size > 0x7fffffff) {
+			size = 0x7fffffff;
+		}
+		const sl_uint8* buf = (const sl_uint8*)_buf;
+		sl_size nSent = 0;
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+		sockaddr_storage addr;
+		socklen_t sizeAddr = (socklen_t)(address.getSystemSocketAddress(&addr));
+		if (!sizeAddr) {
+			_setError(SocketError::Invalid);
+			return SLIB_IO_ERROR;
+		}
+		sl_size maxChunk = (sl_size)segmentSize * MAX_SEGMENTS_PER_SEND;
+		if (maxChunk > MAX_SEGMENTED_SEND_SIZE) {
+			maxChunk = (MAX_SEGMENTED_SEND_SIZE / segmentSize) * segmentSize;
+		}
+		if (segmentSize < size && maxChunk > segmentSize) {
+			union {
+				char buf[CMSG_SPACE(sizeof(sl_uint16))];
+				cmsghdr align;
+			} control;
+			while (nSent < size) {
+				sl_size n = size - nSent;
+				if (n > maxChunk) {
+					n = maxChunk;
+				}
+				iovec iov;
+				iov.iov_base = (void*)(buf + nSent);
+				iov.iov_len = n;
+				msghdr hdr;
+				Base::zeroMemory(&hdr, sizeof(hdr));
+				hdr.msg_name = &addr;
+				hdr.msg_namelen = sizeAddr;
+				hdr.msg_iov = &iov;
+				hdr.msg_iovlen = 1;
+				if (n > segmentSize) {
+					hdr.msg_control = control.buf;
+					hdr.msg_controllen = sizeof(control.buf);
+					cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+					cmsg->cmsg_level = IPPROTO_UDP;
+					cmsg->cmsg_type = UDP_SEGMENT;
+					cmsg->cmsg_len = CMSG_LEN(sizeof(sl_uint16));
+					sl_uint16 seg = (sl_uint16)segmentSize;
+					Base::copyMemory(CMSG_DATA(cmsg), &seg, sizeof(seg));
+				}
+				sl_int32 ret = (sl_int32)(::sendmsg(m_socket, &hdr, 0));
+				if (ret < 0) {
+					int err = errno;
+					if (err == EINVAL || err == ENOPROTOOPT || err == EIO || err == EOPNOTSUPP) {
+						// Not supported by the kernel or the route: sends the segments one by one
+						break;
+					}
+					if (nSent) {
+						return (sl_int32)nSent;
+					}
+					return _processResult(ret);
+				}
+				nSent += n;
+			}
+			if (nSent >= size) {
+				return (sl_int32)nSent;
+			}
+		}
+#endif
+		SocketMessage messages[MAX_SEGMENTS_PER_SEND];
+		while (nSent < size) {
+			sl_uint32 nMessages = 0;
+			sl_size offset = nSent;
+			while (offset < size && nMessages < MAX_SEGMENTS_PER_SEND) {
+				sl_size n = size - offset;
+				if (n > segmentSize) {
+					n = segmentSize;
+				}
+				SocketMessage& message = messages[nMessages];
+				message.address = address;
+				message.data = (void*)(buf + offset);
+				message.size = (sl_uint32)n;
+				offset += n;
+				nMessages++;
+			}
+			sl_int32 ret = sendToBatch(messages, nMessages);
+			if (ret <= 0) {
+				if (nSent) {
+					break;
+				}
+				return ret;
+			}
+			for (sl_int32 i = 0; i < ret; i++) {
+				nSent += messages[i].size;
+			}
+			if ((sl_uint32)ret < nMessages) {
+				break;
+			}
+		}
+		return (sl_int32)nSent;
+	}
+
 	sl_int32 Socket::sendPacket(const void* buf, sl_size _size, const L2PacketInfo& info) const noexcept
 	{
 #if defined(SLIB_PLATFORM_IS_LINUX)
@@ -1435,6 +1802,17 @@ namespace slib
 	}
 
 
+	sl_bool Socket::setOption_TcpCork(sl_bool flagEnable) const noexcept
+	{
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		return setOption(IPPROTO_TCP, TCP_CORK, flagEnable ? 1 : 0);
+#elif defined(TCP_NOPUSH)
+		return setOption(IPPROTO_TCP, TCP_NOPUSH, flagEnable ? 1 : 0);
+#else
+		return sl_false;
+#endif
+	}
+
 	sl_bool Socket::setOption_IpTTL(sl_uint32 ttl) const noexcept
 	{
 		if (ttl > 255) {
@@ -1475,6 +1853,15 @@ namespace slib
 #endif
 	}
 
+	sl_bool Socket::setOption_UdpGro(sl_bool flagEnable) const noexcept
+	{
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		return setOption(IPPROTO_UDP, UDP_GRO, flagEnable ? 1 : 0);
+#else
+		return sl_false;
+#endif
+	}
+
 	sl_bool Socket::setOption_IpAddMembership(const IPv4Address& ipMulticast, const IPv4Address& ipInterface) const noexcept
 	{
 		ip_mreq mreq;
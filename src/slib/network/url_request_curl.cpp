@@ -24,6 +24,9 @@
 
 #include "slib/core/file.h"
 #include "slib/core/system.h"
+#include "slib/core/async.h"
+#include "slib/core/queue.h"
+#include "slib/core/safe_static.h"
 
 #if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
 #	include "slib/network/dl/linux/curl.h"
@@ -33,6 +36,11 @@
 
 #include <stdlib.h>
 
+#if defined(SLIB_PLATFORM_IS_UNIX)
+#	include <unistd.h>
+#	include <poll.h>
+#endif
+
 #if defined(SLIB_PLATFORM_IS_TIZEN)
 #	include <net_connection.h>
 #endif
@@ -48,7 +56,100 @@ namespace slib
 	{
 		namespace url_request
 		{
-			
+
+			// DNS cache, TLS sessions and (optionally) connections shared by the easy handles
+			class CurlShare : public Referable
+			{
+			public:
+				CURLSH* handle;
+				Mutex locks[CURL_LOCK_DATA_LAST];
+
+			public:
+				CurlShare()
+				{
+					handle = sl_null;
+				}
+
+				~CurlShare()
+				{
+					if (handle) {
+						curl_share_cleanup(handle);
+					}
+				}
+
+			public:
+				static Ref<CurlShare> create(sl_bool flagShareConnections)
+				{
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+					if (!(curl::getApi_curl_share_init())) {
+						return sl_null;
+					}
+#endif
+					CURLSH* handle = curl_share_init();
+					if (!handle) {
+						return sl_null;
+					}
+					Ref<CurlShare> ret = new CurlShare;
+					if (ret.isNull()) {
+						curl_share_cleanup(handle);
+						return sl_null;
+					}
+					ret->handle = handle;
+					curl_share_setopt(handle, CURLSHOPT_LOCKFUNC, &callbackLock);
+					curl_share_setopt(handle, CURLSHOPT_UNLOCKFUNC, &callbackUnlock);
+					curl_share_setopt(handle, CURLSHOPT_USERDATA, (void*)(ret.get()));
+					curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+					curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+					if (flagShareConnections) {
+						// Ignored by the libcurl older than 7.57
+						curl_share_setopt(handle, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+					}
+					return ret;
+				}
+
+				static void callbackLock(CURL*, curl_lock_data data, curl_lock_access, void* user_data)
+				{
+					if ((sl_uint32)data < CURL_LOCK_DATA_LAST) {
+						((CurlShare*)user_data)->locks[data].lock();
+					}
+				}
+
+				static void callbackUnlock(CURL*, curl_lock_data data, void* user_data)
+				{
+					if ((sl_uint32)data < CURL_LOCK_DATA_LAST) {
+						((CurlShare*)user_data)->locks[data].unlock();
+					}
+				}
+
+			};
+
+			class SharedCache
+			{
+			public:
+				Ref<CurlShare> share;
+
+			public:
+				SharedCache()
+				{
+					share = CurlShare::create(sl_true);
+				}
+
+			};
+
+			SLIB_SAFE_STATIC_GETTER(SharedCache, GetSharedCacheHolder)
+
+			// Used by the synchronous requests
+			static CurlShare* GetSharedCache()
+			{
+				SharedCache* cache = GetSharedCacheHolder();
+				if (cache) {
+					return cache->share.get();
+				}
+				return sl_null;
+			}
+
+			class CurlEngineImpl;
+
 			class CurlRequestImpl : public UrlRequest
 			{
 				friend class CurlRequest;
@@ -57,6 +158,8 @@ namespace slib
 				CURL* m_curl;
 				sl_bool m_flagClosed;
 				sl_bool m_flagProcessResponse;
+				curl_slist* m_headerChunk;
+				AtomicWeakRef<CurlEngineImpl> m_engine;
 				
 			public:
 				CurlRequestImpl()
@@ -64,10 +167,12 @@ namespace slib
 					m_curl = sl_null;
 					m_flagClosed = sl_false;
 					m_flagProcessResponse = sl_false;
+					m_headerChunk = sl_null;
 				}
 				
 				~CurlRequestImpl()
 				{
+					_free();
 				}
 				
 			public:
@@ -85,11 +190,10 @@ namespace slib
 					return sl_null;
 				}
 				
-				void _cancel() override
-				{
-					m_flagClosed = sl_true;
-				}
-				
+				void _cancel() override;
+
+				void _sendAsync() override;
+
 				void _sendSync() override
 				{
 #if defined(SLIB_PLATFORM_IS_TIZEN)
@@ -134,6 +238,28 @@ namespace slib
 					connection_set_proxy_address_changed_cb(connection, UrlRequest_Impl::callbackProxyChanged, (void*)this);
 #endif
 					
+					_prepare();
+
+					CurlShare* share = GetSharedCache();
+					if (share) {
+						curl_easy_setopt(curl, CURLOPT_SHARE, share->handle);
+					}
+					
+					/* getting data */
+					CURLcode err = curl_easy_perform(curl);
+					
+					_finish(err);
+#if defined(SLIB_PLATFORM_IS_TIZEN)
+					connection_destroy(connection);
+#endif
+					
+				}
+				
+				// Sets the options of the transfer to `m_curl`
+				void _prepare()
+				{
+					CURL* curl = m_curl;
+
 					StringCstr url = m_url;
 					curl_easy_setopt(curl, CURLOPT_URL, url.getData());
 					
@@ -190,6 +316,7 @@ namespace slib
 					}
 					if (headerChunk) {
 						curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headerChunk);
+						m_headerChunk = headerChunk;
 					}
 					
 					// post data
@@ -214,9 +341,12 @@ namespace slib
 					curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, CurlRequestImpl::callbackWrite);
 					curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void*)this);
 					
-					/* getting data */
-					CURLcode err = curl_easy_perform(curl);
-					
+					// the signals are not safe in the multi-threaded processes
+					curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+				}
+
+				void _finish(CURLcode err)
+				{
 					processResponse();
 					
 					if (err == CURLE_OK) {
@@ -227,15 +357,25 @@ namespace slib
 						onError();
 					}
 					
-					if (headerChunk) {
-						curl_slist_free_all(headerChunk);
+					_free();
+				}
+
+				void _fail(const String& message)
+				{
+					m_errorMessage = message;
+					onError();
+				}
+
+				void _free()
+				{
+					if (m_headerChunk) {
+						curl_slist_free_all(m_headerChunk);
+						m_headerChunk = sl_null;
+					}
+					if (m_curl) {
+						curl_easy_cleanup(m_curl);
+						m_curl = sl_null;
 					}
-					
-					curl_easy_cleanup(curl);
-#if defined(SLIB_PLATFORM_IS_TIZEN)
-					connection_destroy(connection);
-#endif
-					
 				}
 				
 				void processResponse()
@@ -395,7 +535,677 @@ namespace slib
 				
 			};
 
+#if defined(SLIB_PLATFORM_IS_UNIX)
+			// Maximum number of the actions on the sockets which are still ready, in one step
+#define MAX_SOCKET_ACTIONS_PER_STEP 256
+			// `CURLM_ABORTED_BY_CALLBACK` of libcurl 7.84 or later: the multi handle refuses the actions after the socket callback returned -1, until all of its transfers are removed
+#define CURLM_RESULT_ABORTED_BY_CALLBACK 11
+
+			// Socket of the multi handle, attached to the loop by a duplicated descriptor
+			// so that the registration never outlives the socket closed by libcurl
+			class CurlSocket : public AsyncIoInstance
+			{
+			public:
+				curl_socket_t socket;
+				int action;
+				sl_bool flagQueued;
+				WeakRef<CurlEngineImpl> engine;
+
+			public:
+				CurlSocket(curl_socket_t _socket, int handle): socket(_socket)
+				{
+					action = 0;
+					flagQueued = sl_false;
+					setHandle((sl_async_handle)handle);
+				}
+
+			public:
+				void onOrder() override
+				{
+				}
+
+				void onEvent(EventDesc* pev) override;
+
+				void onClose() override
+				{
+					int handle = (int)(getHandle());
+					if (handle >= 0) {
+						::close(handle);
+					}
+					setHandle(SLIB_ASYNC_INVALID_HANDLE);
+				}
+
+			};
+
+			class CurlEngineImpl : public CurlEngine
+			{
+			public:
+				CURLM* m_multi;
+				Ref<CurlShare> m_share;
+				Ref<AsyncIoLoop> m_loop;
+				sl_bool m_flagHttp2;
+				sl_bool m_flagHttp2PriorKnowledge;
+				sl_bool m_flagClosed;
+
+				// Accessed on the loop thread
+				CHashMap< CURL*, Ref<CurlRequestImpl> > m_requests;
+				CHashMap< curl_socket_t, Ref<CurlSocket> > m_sockets;
+				LinkedQueue< Ref<CurlSocket> > m_queueChecking;
+				sl_bool m_flagCheckingTask;
+				sl_uint64 m_tickTimeout;
+				sl_uint64 m_tickTimer;
+				sl_bool m_flagTimeoutTask;
+
+				CurlEngineStatistics m_statistics;
+
+			public:
+				CurlEngineImpl()
+				{
+					m_multi = sl_null;
+					m_flagHttp2 = sl_false;
+					m_flagHttp2PriorKnowledge = sl_false;
+					m_flagClosed = sl_false;
+					m_flagCheckingTask = sl_false;
+					m_tickTimeout = 0;
+					m_tickTimer = 0;
+					m_flagTimeoutTask = sl_false;
+				}
+
+				~CurlEngineImpl()
+				{
+					_close();
+				}
+
+			public:
+				static Ref<CurlEngineImpl> create(const CurlEngineParam& param)
+				{
+#if defined(SLIB_PLATFORM_IS_LINUX_DESKTOP)
+					if (!(curl::getApi_curl_easy_init()) || !(curl::getApi_curl_multi_socket_action())) {
+						return sl_null;
+					}
+#endif
+					Ref<AsyncIoLoop> loop = param.ioLoop;
+					if (loop.isNull()) {
+						loop = AsyncIoLoop::getDefault();
+						if (loop.isNull()) {
+							return sl_null;
+						}
+					}
+					CURLM* multi = curl_multi_init();
+					if (!multi) {
+						return sl_null;
+					}
+					Ref<CurlEngineImpl> ret = new CurlEngineImpl;
+					if (ret.isNull()) {
+						curl_multi_cleanup(multi);
+						return sl_null;
+					}
+					ret->m_multi = multi;
+					ret->m_loop = Move(loop);
+					ret->m_share = CurlShare::create(sl_false);
+					ret->m_flagHttp2 = param.flagHttp2 || param.flagHttp2PriorKnowledge;
+					ret->m_flagHttp2PriorKnowledge = param.flagHttp2PriorKnowledge;
+
+					curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, &callbackSocket);
+					curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, (void*)(ret.get()));
+					curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, &callbackTimer);
+					curl_multi_setopt(multi, CURLMOPT_TIMERDATA, (void*)(ret.get()));
+					if (ret->m_flagHttp2) {
+						curl_multi_setopt(multi, CURLMOPT_PIPELINING, (long)CURLPIPE_MULTIPLEX);
+					}
+					if (param.maxConnectionsPerHost) {
+						curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)(param.maxConnectionsPerHost));
+					}
+					if (param.maxConnections) {
+						curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, (long)(param.maxConnections));
+					}
+					if (param.maxIdleConnections) {
+						curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, (long)(param.maxIdleConnections));
+					}
+					return ret;
+				}
+
+			public:
+				Ref<UrlRequest> send(const UrlRequestParam& param) override
+				{
+					String url = param.url;
+					if (url.isNotEmpty()) {
+						if (param.parameters.isNotEmpty()) {
+							if (url.contains('?')) {
+								url += "&";
+							} else {
+								url += "?";
+							}
+						}
+						url += HttpRequest::buildQuery(param.parameters);
+						Ref<CurlRequestImpl> request = CurlRequestImpl::create(param, url);
+						if (request.isNotNull()) {
+							if (param.flagSynchronous) {
+								request->_sendSync();
+							} else {
+								sendRequest(request.get());
+							}
+							return Ref<UrlRequest>::from(request);
+						}
+					}
+					return CurlRequest::send(param);
+				}
+
+				Ref<AsyncIoLoop> getIoLoop() override
+				{
+					return m_loop;
+				}
+
+				void getStatistics(CurlEngineStatistics& statistics) override
+				{
+					ObjectLocker lock(this);
+					statistics = m_statistics;
+				}
+
+				void close() override
+				{
+					m_loop->addTask(SLIB_BIND_WEAKREF(void(), this, _close));
+				}
+
+			public:
+				void sendRequest(CurlRequestImpl* request)
+				{
+					request->m_engine = this;
+					if (!(m_loop->addTask(SLIB_BIND_WEAKREF(void(), this, _start, Ref<CurlRequestImpl>(request))))) {
+						request->_fail("Failed to add the request to the loop");
+					}
+				}
+
+				void cancelRequest(CurlRequestImpl* request)
+				{
+					m_loop->addTask(SLIB_BIND_WEAKREF(void(), this, _cancel, Ref<CurlRequestImpl>(request)));
+				}
+
+				void _start(const Ref<CurlRequestImpl>& request)
+				{
+					if (request->m_flagClosed) {
+						return;
+					}
+					if (m_flagClosed) {
+						request->_fail("The engine is closed");
+						return;
+					}
+					CURL* curl = curl_easy_init();
+					if (!curl) {
+						request->_fail("Failed to create the transfer");
+						return;
+					}
+					request->m_curl = curl;
+					request->_prepare();
+					curl_easy_setopt(curl, CURLOPT_PRIVATE, (void*)(request.get()));
+					if (m_share.isNotNull()) {
+						curl_easy_setopt(curl, CURLOPT_SHARE, m_share->handle);
+					}
+					if (m_flagHttp2) {
+						curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, m_flagHttp2PriorKnowledge ? (long)CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE : (long)CURL_HTTP_VERSION_2TLS);
+						// waits for the connection in progress to the same host to multiplex on it, instead of opening another one
+						curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+					}
+					if (curl_multi_add_handle(m_multi, curl) != CURLM_OK) {
+						request->_free();
+						request->_fail("Failed to add the transfer");
+						return;
+					}
+					m_requests.put_NoLock(curl, request);
+					ObjectLocker lock(this);
+					m_statistics.countActiveRequests++;
+					if (m_statistics.countActiveRequests > m_statistics.maxActiveRequests) {
+						m_statistics.maxActiveRequests = m_statistics.countActiveRequests;
+					}
+				}
+
+				void _cancel(const Ref<CurlRequestImpl>& request)
+				{
+					CURL* curl = request->m_curl;
+					if (curl && m_requests.remove_NoLock(curl)) {
+						curl_multi_remove_handle(m_multi, curl);
+						request->_free();
+						{
+							ObjectLocker lock(this);
+							m_statistics.countActiveRequests--;
+						}
+						_processChecks();
+					}
+				}
+
+				void _close()
+				{
+					if (m_flagClosed) {
+						return;
+					}
+					m_flagClosed = sl_true;
+					_failRequests("The engine is closed");
+					_release();
+				}
+
+				void _failRequests(const String& message)
+				{
+					if (!m_multi) {
+						return;
+					}
+					List< Ref<CurlRequestImpl> > requests = m_requests.getAllValues_NoLock();
+					for (auto& item : m_requests) {
+						curl_multi_remove_handle(m_multi, item.key);
+						item.value->_free();
+					}
+					m_requests.removeAll_NoLock();
+					{
+						ObjectLocker lock(this);
+						m_statistics.countActiveRequests = 0;
+					}
+					for (auto& request : requests) {
+						request->_fail(message);
+					}
+				}
+
+				void _release()
+				{
+					if (!m_multi) {
+						return;
+					}
+					// closes the pooled connections
+					curl_multi_cleanup(m_multi);
+					m_multi = sl_null;
+					for (auto& item : m_sockets) {
+						m_loop->closeInstance(item.value.get());
+					}
+					m_sockets.removeAll_NoLock();
+					m_queueChecking.removeAll_NoLock();
+				}
+
+				static int callbackSocket(CURL* easy, curl_socket_t s, int what, void* user_data, void* socket_data)
+				{
+					// reports the socket which the loop can't watch, so that the transfers fail instead of waiting for the events which never come
+					if (((CurlEngineImpl*)user_data)->_onSocket(s, what)) {
+						return 0;
+					} else {
+						return -1;
+					}
+				}
+
+				sl_bool _onSocket(curl_socket_t s, int what)
+				{
+					Ref<CurlSocket> socket;
+					m_sockets.get_NoLock(s, &socket);
+					if (what == CURL_POLL_REMOVE) {
+						if (socket.isNotNull()) {
+							m_sockets.remove_NoLock(s);
+							m_loop->closeInstance(socket.get());
+						}
+						return sl_true;
+					}
+					if (socket.isNull()) {
+						int handle = ::dup((int)s);
+						if (handle < 0) {
+							return sl_false;
+						}
+						socket = new CurlSocket(s, handle);
+						if (socket.isNull()) {
+							::close(handle);
+							return sl_false;
+						}
+						socket->engine = this;
+						if (!(m_loop->attachInstance(socket.get(), AsyncIoMode::InOut))) {
+							// `onClose()` is called only for the attached instances
+							::close(handle);
+							return sl_false;
+						}
+						if (!(m_sockets.put_NoLock(s, socket))) {
+							m_loop->closeInstance(socket.get());
+							return sl_false;
+						}
+					}
+					socket->action = what;
+					_queueCheck(socket.get());
+					return sl_true;
+				}
+
+				static int callbackTimer(CURLM* multi, long timeout_ms, void* user_data)
+				{
+					((CurlEngineImpl*)user_data)->_onTimer(timeout_ms);
+					return 0;
+				}
+
+				void _onTimer(long ms)
+				{
+					if (ms < 0) {
+						m_tickTimeout = 0;
+						return;
+					}
+					if (!ms) {
+						m_tickTimeout = 0;
+						if (!m_flagTimeoutTask) {
+							m_flagTimeoutTask = sl_true;
+							m_loop->addTask(SLIB_BIND_WEAKREF(void(), this, _onTimeoutTask));
+						}
+						return;
+					}
+					sl_uint64 tick = System::getTickCount64() + ms;
+					m_tickTimeout = tick;
+					// the pending timer which fires earlier reschedules itself
+					if (m_tickTimer && m_tickTimer <= tick) {
+						return;
+					}
+					_setTimer(tick, ms);
+				}
+
+				void _setTimer(sl_uint64 tick, sl_uint64 ms)
+				{
+					m_tickTimer = tick;
+					WeakRef<AsyncIoLoop> loop = m_loop;
+					Function<void()> task = SLIB_BIND_WEAKREF(void(), this, _onTimerTask, tick);
+					m_loop->dispatch([loop, task]() {
+						Ref<AsyncIoLoop> _loop = loop;
+						if (_loop.isNotNull()) {
+							_loop->addTask(task);
+						}
+					}, ms);
+				}
+
+				void _onTimerTask(sl_uint64 tick)
+				{
+					if (tick != m_tickTimer) {
+						return;
+					}
+					m_tickTimer = 0;
+					if (!m_tickTimeout) {
+						return;
+					}
+					sl_uint64 now = System::getTickCount64();
+					if (now < m_tickTimeout) {
+						_setTimer(m_tickTimeout, m_tickTimeout - now);
+						return;
+					}
+					m_tickTimeout = 0;
+					_doTimeout();
+				}
+
+				void _onTimeoutTask()
+				{
+					m_flagTimeoutTask = sl_false;
+					_doTimeout();
+				}
+
+				void _doTimeout()
+				{
+					if (!m_multi) {
+						return;
+					}
+					_doSocketAction(CURL_SOCKET_TIMEOUT, 0);
+					_processChecks();
+				}
+
+				void _onSocketEvent(CurlSocket* socket, sl_bool flagIn, sl_bool flagOut, sl_bool flagError)
+				{
+					if (!m_multi) {
+						return;
+					}
+					int flags = 0;
+					if (flagIn) {
+						flags |= CURL_CSELECT_IN;
+					}
+					if (flagOut) {
+						flags |= CURL_CSELECT_OUT;
+					}
+					if (flagError) {
+						flags |= CURL_CSELECT_ERR;
+					}
+					_doSocketAction(socket->socket, flags);
+					_queueCheck(socket);
+					_processChecks();
+				}
+
+				void _doSocketAction(curl_socket_t s, int flags)
+				{
+					int n = 0;
+					if (curl_multi_socket_action(m_multi, s, flags, &n) == (CURLMcode)CURLM_RESULT_ABORTED_BY_CALLBACK) {
+						_failRequests("Failed to watch the socket");
+					}
+				}
+
+				void _queueCheck(CurlSocket* socket)
+				{
+					if (!(socket->flagQueued)) {
+						socket->flagQueued = sl_true;
+						m_queueChecking.push_NoLock(socket);
+					}
+				}
+
+				/*
+					The loop reports the edges of the readiness, but libcurl may leave the data in the socket (or in the TLS buffer)
+					when it stops reading in the middle of a transfer. So the sockets touched by the actions are polled again,
+					and the actions are repeated while they are ready.
+				*/
+				void _processChecks()
+				{
+					sl_uint32 nActions = 0;
+					Ref<CurlSocket> socket;
+					while (m_multi && m_queueChecking.pop_NoLock(&socket)) {
+						socket->flagQueued = sl_false;
+						if (socket->isClosing() || !(socket->action)) {
+							continue;
+						}
+						pollfd fd;
+						fd.fd = (int)(socket->getHandle());
+						fd.events = 0;
+						fd.revents = 0;
+						if (socket->action & CURL_POLL_IN) {
+							fd.events |= POLLIN;
+						}
+						if (socket->action & CURL_POLL_OUT) {
+							fd.events |= POLLOUT;
+						}
+						if (::poll(&fd, 1, 0) <= 0) {
+							continue;
+						}
+						if (nActions >= MAX_SOCKET_ACTIONS_PER_STEP) {
+							// lets the other instances of the loop run
+							_queueCheck(socket.get());
+							if (!m_flagCheckingTask) {
+								m_flagCheckingTask = sl_true;
+								m_loop->addTask(SLIB_BIND_WEAKREF(void(), this, _onCheckingTask));
+							}
+							break;
+						}
+						nActions++;
+						int flags = 0;
+						if (fd.revents & (POLLIN | POLLHUP)) {
+							flags |= CURL_CSELECT_IN;
+						}
+						if (fd.revents & POLLOUT) {
+							flags |= CURL_CSELECT_OUT;
+						}
+						if (fd.revents & POLLERR) {
+							flags |= CURL_CSELECT_ERR;
+						}
+						_doSocketAction(socket->socket, flags);
+						_queueCheck(socket.get());
+					}
+					_processMessages();
+				}
+
+				void _onCheckingTask()
+				{
+					m_flagCheckingTask = sl_false;
+					_processChecks();
+				}
+
+				void _processMessages()
+				{
+					if (!m_multi) {
+						return;
+					}
+					CURLMsg* msg;
+					int nQueued = 0;
+					while ((msg = curl_multi_info_read(m_multi, &nQueued))) {
+						if (msg->msg != CURLMSG_DONE) {
+							continue;
+						}
+						CURL* curl = msg->easy_handle;
+						CURLcode result = msg->data.result;
+						long nConnects = 0;
+						curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &nConnects);
+						long version = 0;
+						curl_easy_getinfo(curl, CURLINFO_HTTP_VERSION, &version);
+						double timeTotal = 0;
+						curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME, &timeTotal);
+						double timeWait = 0;
+						curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME, &timeWait);
+						curl_multi_remove_handle(m_multi, curl);
+						{
+							ObjectLocker lock(this);
+							CurlEngineStatistics& s = m_statistics;
+							s.countRequests++;
+							s.countActiveRequests--;
+							if (result == CURLE_OK) {
+								if (nConnects) {
+									s.countConnections += nConnects;
+								} else {
+									s.countReusedConnections++;
+								}
+								if (version == CURL_HTTP_VERSION_2_0) {
+									s.countMultiplexedRequests++;
+								}
+							} else {
+								s.countErrors++;
+								s.countConnections += nConnects;
+							}
+							s.totalTime += (sl_uint64)(timeTotal * 1000000);
+							s.totalWaitTime += (sl_uint64)(timeWait * 1000000);
+						}
+						Ref<CurlRequestImpl> request;
+						if (m_requests.remove_NoLock(curl, &request)) {
+							request->_finish(result);
+						} else {
+							curl_easy_cleanup(curl);
+						}
+					}
+				}
+
+			};
+
+			void CurlSocket::onEvent(EventDesc* pev)
+			{
+				Ref<CurlEngineImpl> _engine = engine;
+				if (_engine.isNotNull()) {
+					_engine->_onSocketEvent(this, pev->flagIn, pev->flagOut, pev->flagError);
+				}
+			}
+
+			class DefaultEngine
+			{
+			public:
+				Ref<CurlEngine> engine;
+				sl_bool flagInit;
+				Mutex lock;
+
+			public:
+				DefaultEngine()
+				{
+					flagInit = sl_false;
+				}
+
+			};
+
+			SLIB_SAFE_STATIC_GETTER(DefaultEngine, GetDefaultEngine)
+#endif
+
+			void CurlRequestImpl::_cancel()
+			{
+				m_flagClosed = sl_true;
+#if defined(SLIB_PLATFORM_IS_UNIX)
+				Ref<CurlEngineImpl> engine = m_engine;
+				if (engine.isNotNull()) {
+					engine->cancelRequest(this);
+				}
+#endif
+			}
+
+			void CurlRequestImpl::_sendAsync()
+			{
+#if defined(SLIB_PLATFORM_IS_UNIX)
+				Ref<CurlEngine> engine = CurlEngine::getDefault();
+				if (engine.isNotNull()) {
+					((CurlEngineImpl*)(engine.get()))->sendRequest(this);
+					return;
+				}
+#endif
+				UrlRequest::_sendAsync();
+			}
+
+
+		}
+	}
+
+
+	CurlEngineParam::CurlEngineParam()
+	{
+		maxConnectionsPerHost = 16;
+		maxConnections = 0;
+		maxIdleConnections = 64;
+		flagHttp2 = sl_true;
+		flagHttp2PriorKnowledge = sl_false;
+	}
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(CurlEngineParam)
+
+
+	CurlEngineStatistics::CurlEngineStatistics()
+	{
+		countRequests = 0;
+		countErrors = 0;
+		countConnections = 0;
+		countReusedConnections = 0;
+		countMultiplexedRequests = 0;
+		countActiveRequests = 0;
+		maxActiveRequests = 0;
+		totalTime = 0;
+		totalWaitTime = 0;
+	}
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(CurlEngineStatistics)
+
+
+	SLIB_DEFINE_OBJECT(CurlEngine, Object)
+
+	CurlEngine::CurlEngine()
+	{
+	}
+
+	CurlEngine::~CurlEngine()
+	{
+	}
+
+	Ref<CurlEngine> CurlEngine::create(const CurlEngineParam& param)
+	{
+#if defined(SLIB_PLATFORM_IS_UNIX)
+		return Ref<CurlEngine>::from(priv::url_request::CurlEngineImpl::create(param));
+#else
+		return sl_null;
+#endif
+	}
+
+	Ref<CurlEngine> CurlEngine::getDefault()
+	{
+#if defined(SLIB_PLATFORM_IS_UNIX)
+		priv::url_request::DefaultEngine* def = priv::url_request::GetDefaultEngine();
+		if (!def) {
+			return sl_null;
+		}
+		MutexLocker lock(&(def->lock));
+		if (!(def->flagInit)) {
+			def->flagInit = sl_true;
+			def->engine = create(CurlEngineParam());
 		}
+		return def->engine;
+#else
+		return sl_null;
+#endif
 	}
 
 
@@ -0,0 +1,1393 @@
+/*
+ *   Copyright (c) 2008-2022 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/network/websocket.h"
+
+#include "slib/network/http_server.h"
+#include "slib/network/url.h"
+#include "slib/core/memory_pool.h"
+#include "slib/core/dispatch.h"
+#include "slib/core/mio.h"
+#include "slib/core/math.h"
+#include "slib/crypto/sha1.h"
+#include "slib/crypto/base64.h"
+
+#if defined(SLIB_ARCH_IS_X64)
+#	define SUPPORT_SSE2
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#	else
+#		include <emmintrin.h>
+#	endif
+#elif defined(SLIB_ARCH_IS_ARM64)
+#	define SUPPORT_NEON
+#	include <arm_neon.h>
+#endif
+
+#define MAX_FRAME_HEADER_SIZE 14
+#define MAX_CONTROL_PAYLOAD_SIZE 125
+#define MAX_HANDSHAKE_SIZE 0x10000
+#define READ_BUFFER_SIZE 0x10000
+#define INFLATE_BUFFER_SIZE 0x4000
+#define CLOSE_TIMEOUT 3000
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace websocket
+		{
+
+			SLIB_STATIC_STRING(g_strGuid, "258EAFA5-E914-47DA-95CA-C5AB0DC85B11")
+			SLIB_STATIC_STRING(g_strWebSocket, "websocket")
+			SLIB_STATIC_STRING(g_strUpgrade, "Upgrade")
+			SLIB_STATIC_STRING(g_strVersion, "13")
+			SLIB_STATIC_STRING(g_strDeflate, "permessage-deflate")
+			SLIB_STATIC_STRING(g_strServerDeflate, "permessage-deflate; server_no_context_takeover; client_no_context_takeover")
+			SLIB_STATIC_STRING(g_strClientDeflate, "permessage-deflate; client_no_context_takeover; server_no_context_takeover")
+
+			// Empty stored block ending a message flushed by Z_SYNC_FLUSH, which is not transmitted
+			static const sl_uint8 g_tailDeflate[4] = { 0, 0, 0xff, 0xff };
+
+			// The messages are compressed from a reset state, so the connections of a thread share the compressors
+			class ZlibCache
+			{
+			public:
+				ZlibRawCompressor compressors[10];
+				ZlibRawDecompressor decompressor;
+				sl_bool flagFreed = sl_false;
+
+			public:
+				~ZlibCache()
+				{
+					flagFreed = sl_true;
+				}
+
+			public:
+				ZlibRawCompressor* getCompressor(sl_uint32 level)
+				{
+					if (flagFreed) {
+						return sl_null;
+					}
+					if (level > 9) {
+						level = 9;
+					}
+					ZlibRawCompressor& compressor = compressors[level];
+					if (!(compressor.isStarted()) && !(compressor.start(level))) {
+						return sl_null;
+					}
+					return &compressor;
+				}
+
+				ZlibRawDecompressor* getDecompressor()
+				{
+					if (flagFreed) {
+						return sl_null;
+					}
+					if (!(decompressor.isStarted()) && !(decompressor.start())) {
+						return sl_null;
+					}
+					return &decompressor;
+				}
+
+			};
+
+			static SLIB_THREAD ZlibCache g_cacheZlib;
+
+			// `key`: 4 bytes of the mask in memory order
+			static void Mask(sl_uint8* data, sl_size size, sl_uint32 key)
+			{
+#if defined(SUPPORT_SSE2)
+				if (size >= 16) {
+					__m128i m = _mm_set1_epi32((int)key);
+					while (size >= 64) {
+						__m128i v0 = _mm_loadu_si128((const __m128i*)data);
+						__m128i v1 = _mm_loadu_si128((const __m128i*)(data + 16));
+						__m128i v2 = _mm_loadu_si128((const __m128i*)(data + 32));
+						__m128i v3 = _mm_loadu_si128((const __m128i*)(data + 48));
+						_mm_storeu_si128((__m128i*)data, _mm_xor_si128(v0, m));
+						_mm_storeu_si128((__m128i*)(data + 16), _mm_xor_si128(v1, m));
+						_mm_storeu_si128((__m128i*)(data + 32), _mm_xor_si128(v2, m));
+						_mm_storeu_si128((__m128i*)(data + 48), _mm_xor_si128(v3, m));
+						data += 64;
+						size -= 64;
+					}
+					while (size >= 16) {
+						__m128i v = _mm_loadu_si128((const __m128i*)data);
+						_mm_storeu_si128((__m128i*)data, _mm_xor_si128(v, m));
+						data += 16;
+						size -= 16;
+					}
+				}
+#elif defined(SUPPORT_NEON)
+				if (size >= 16) {
+					uint8x16_t m = vreinterpretq_u8_u32(vdupq_n_u32(key));
+					while (size >= 64) {
+						uint8x16_t v0 = vld1q_u8(data);
+						uint8x16_t v1 = vld1q_u8(data + 16);
+						uint8x16_t v2 = vld1q_u8(data + 32);
+						uint8x16_t v3 = vld1q_u8(data + 48);
+						vst1q_u8(data, veorq_u8(v0, m));
+						vst1q_u8(data + 16, veorq_u8(v1, m));
+						vst1q_u8(data + 32, veorq_u8(v2, m));
+						vst1q_u8(data + 48, veorq_u8(v3, m));
+						data += 64;
+						size -= 64;
+					}
+					while (size >= 16) {
+						vst1q_u8(data, veorq_u8(vld1q_u8(data), m));
+						data += 16;
+						size -= 16;
+					}
+				}
+#endif
+				if (size >= 8) {
+					sl_uint64 m = ((sl_uint64)key << 32) | key;
+					while (size >= 8) {
+						sl_uint64 v;
+						Base::copyMemory(&v, data, 8);
+						v ^= m;
+						Base::copyMemory(data, &v, 8);
+						data += 8;
+						size -= 8;
+					}
+				}
+				sl_uint8 k[4];
+				Base::copyMemory(k, &key, 4);
+				for (sl_size i = 0; i < size; i++) {
+					data[i] ^= k[i & 3];
+				}
+			}
+
+			static sl_uint32 GenerateMaskKey(sl_uint64& seed)
+			{
+				// xorshift64*
+				sl_uint64 s = seed;
+				s ^= s >> 12;
+				s ^= s << 25;
+				s ^= s >> 27;
+				seed = s;
+				return (sl_uint32)((s * SLIB_UINT64(2685821657736338717)) >> 32);
+			}
+
+			// Returns the size of the compressed message, or 0 when the output does not fit in `capacity`
+			static sl_size Deflate(ZlibRawCompressor* compressor, const void* _input, sl_size sizeInput, sl_uint8* output, sl_size capacity)
+			{
+				const sl_uint8* input = (const sl_uint8*)_input;
+				sl_size sizeOutput = 0;
+				sl_bool flagSuccess = sl_false;
+				for (;;) {
+					sl_uint32 nPassed = 0;
+					sl_uint32 nUsed = 0;
+					if (sizeInput) {
+						if (compressor->pass32(input, (sl_uint32)sizeInput, nPassed, output + sizeOutput, (sl_uint32)(capacity - sizeOutput), nUsed) == DataFilterResult::Error) {
+							break;
+						}
+						input += nPassed;
+						sizeInput -= nPassed;
+						sizeOutput += nUsed;
+						if (!nPassed && !nUsed) {
+							break;
+						}
+					} else {
+						DataFilterResult result = compressor->flush32(output + sizeOutput, (sl_uint32)(capacity - sizeOutput), nUsed);
+						sizeOutput += nUsed;
+						if (result == DataFilterResult::Finished) {
+							flagSuccess = sl_true;
+							break;
+						}
+						if (result == DataFilterResult::Error || !nUsed) {
+							break;
+						}
+					}
+				}
+				compressor->reset();
+				if (flagSuccess && sizeOutput >= 4 && Base::equalsMemory(output + sizeOutput - 4, g_tailDeflate, 4)) {
+					return sizeOutput - 4;
+				}
+				return 0;
+			}
+
+			static sl_bool Inflate(ZlibRawDecompressor* decompressor, const void* _input, sl_size sizeInput, MemoryBuffer& output, sl_size& sizeOutput, sl_size sizeLimit, sl_bool& flagEnded)
+			{
+				const sl_uint8* input = (const sl_uint8*)_input;
+				sl_uint8 buf[INFLATE_BUFFER_SIZE];
+				for (;;) {
+					sl_uint32 n = sizeInput > 0x40000000 ? 0x40000000 : (sl_uint32)sizeInput;
+					sl_uint32 nPassed = 0;
+					sl_uint32 nUsed = 0;
+					DataFilterResult result = decompressor->pass32(input, n, nPassed, buf, sizeof(buf), nUsed);
+					if (result == DataFilterResult::Error) {
+						return sl_false;
+					}
+					if (nUsed) {
+						sizeOutput += nUsed;
+						if (sizeOutput > sizeLimit) {
+							return sl_false;
+						}
+						if (!(output.addNew(buf, nUsed))) {
+							return sl_false;
+						}
+					}
+					input += nPassed;
+					sizeInput -= nPassed;
+					if (result == DataFilterResult::Finished) {
+						flagEnded = sl_true;
+						return sl_true;
+					}
+					if (!sizeInput && nUsed < sizeof(buf)) {
+						return sl_true;
+					}
+					if (!nPassed && !nUsed) {
+						return sl_false;
+					}
+				}
+			}
+
+			// `compressor`: null for no compression. `key`: mask of the client frames
+			static Memory BuildFrame(WebSocketOpcode opcode, const void* data, sl_size size, ZlibRawCompressor* compressor, const sl_uint32* key)
+			{
+				sl_size capacity = size;
+				if (compressor) {
+					if (size >> 31) {
+						compressor = sl_null;
+					} else {
+						capacity = size + (size >> 12) + (size >> 14) + 64;
+					}
+				}
+				Memory mem = Memory::create(MAX_FRAME_HEADER_SIZE + capacity);
+				if (mem.isNull()) {
+					return sl_null;
+				}
+				sl_uint8* payload = (sl_uint8*)(mem.getData()) + MAX_FRAME_HEADER_SIZE;
+				sl_size sizePayload = 0;
+				sl_bool flagCompressed = sl_false;
+				if (compressor) {
+					sizePayload = Deflate(compressor, data, size, payload, capacity);
+					// Sends as it is when the compression does not help
+					flagCompressed = sizePayload && sizePayload < size;
+				}
+				if (!flagCompressed) {
+					Base::copyMemory(payload, data, size);
+					sizePayload = size;
+				}
+				sl_uint8 bitMask = 0;
+				sl_size sizeHeader = 2;
+				if (key) {
+					bitMask = 0x80;
+					sizeHeader += 4;
+				}
+				if (sizePayload > 0xffff) {
+					sizeHeader += 8;
+				} else if (sizePayload > MAX_CONTROL_PAYLOAD_SIZE) {
+					sizeHeader += 2;
+				}
+				sl_uint8* header = payload - sizeHeader;
+				header[0] = (sl_uint8)(0x80 | (flagCompressed ? 0x40 : 0) | (sl_uint8)opcode);
+				if (sizePayload > 0xffff) {
+					header[1] = bitMask | 127;
+					MIO::writeUint64BE(header + 2, sizePayload);
+				} else if (sizePayload > MAX_CONTROL_PAYLOAD_SIZE) {
+					header[1] = bitMask | 126;
+					MIO::writeUint16BE(header + 2, (sl_uint16)sizePayload);
+				} else {
+					header[1] = bitMask | (sl_uint8)sizePayload;
+				}
+				if (key) {
+					Base::copyMemory(payload - 4, key, 4);
+					Mask(payload, sizePayload, *key);
+				}
+				return mem.sub(MAX_FRAME_HEADER_SIZE - sizeHeader, sizeHeader + sizePayload);
+			}
+
+			// Accepts permessage-deflate with the parameters which allow both endpoints to compress each message independently
+			static sl_bool ParseDeflateExtension(const String& extension, sl_bool flagClient, sl_bool& flagPeerResetsContext)
+			{
+				ListElements<String> params(extension.split(';'));
+				if (!(params.count) || !(params[0].trim().equalsIgnoreCase(g_strDeflate))) {
+					return sl_false;
+				}
+				for (sl_size i = 1; i < params.count; i++) {
+					String param = params[i].trim();
+					String name = param;
+					String value;
+					sl_reg index = param.indexOf('=');
+					if (index >= 0) {
+						name = param.substring(0, index).trim();
+						value = param.substring(index + 1).trim().removeAll('"');
+					}
+					if (name.equalsIgnoreCase(StringView::literal("server_no_context_takeover"))) {
+						if (flagClient) {
+							flagPeerResetsContext = sl_true;
+						}
+					} else if (name.equalsIgnoreCase(StringView::literal("client_no_context_takeover"))) {
+						if (!flagClient) {
+							flagPeerResetsContext = sl_true;
+						}
+					} else if (name.equalsIgnoreCase(StringView::literal("server_max_window_bits"))) {
+						// The server compresses with the 15-bit window
+						if (!flagClient && value.parseUint32() != 15) {
+							return sl_false;
+						}
+					} else if (name.equalsIgnoreCase(StringView::literal("client_max_window_bits"))) {
+						// The client does not offer this parameter
+						if (flagClient) {
+							return sl_false;
+						}
+					} else {
+						return sl_false;
+					}
+				}
+				return sl_true;
+			}
+
+			static sl_bool IsValidCloseCode(sl_uint16 code)
+			{
+				if (code < 1000 || code >= 5000) {
+					return sl_false;
+				}
+				if (code >= 3000) {
+					return sl_true;
+				}
+				return code <= 1011 && code != 1004 && code != 1005 && code != 1006;
+			}
+
+			// Strict UTF-8 (RFC 3629): rejects overlong forms, surrogates and code points above U+10FFFF
+			static sl_bool IsValidUtf8(const void* _data, sl_size size)
+			{
+				const sl_uint8* data = (const sl_uint8*)_data;
+				sl_size i = 0;
+				while (i < size) {
+					if (i + 8 <= size) {
+						sl_uint64 v;
+						Base::copyMemory(&v, data + i, 8);
+						if (!(v & SLIB_UINT64(0x8080808080808080))) {
+							i += 8;
+							continue;
+						}
+					}
+					sl_uint8 ch = data[i];
+					if (ch < 0x80) {
+						i++;
+						continue;
+					}
+					sl_size n;
+					sl_uint8 lower = 0x80;
+					sl_uint8 upper = 0xBF;
+					if (ch >= 0xC2 && ch <= 0xDF) {
+						n = 1;
+					} else if (ch >= 0xE0 && ch <= 0xEF) {
+						n = 2;
+						if (ch == 0xE0) {
+							lower = 0xA0;
+						} else if (ch == 0xED) {
+							upper = 0x9F;
+						}
+					} else if (ch >= 0xF0 && ch <= 0xF4) {
+						n = 3;
+						if (ch == 0xF0) {
+							lower = 0x90;
+						} else if (ch == 0xF4) {
+							upper = 0x8F;
+						}
+					} else {
+						return sl_false;
+					}
+					if (i + n >= size) {
+						return sl_false;
+					}
+					sl_uint8 ch1 = data[i + 1];
+					if (ch1 < lower || ch1 > upper) {
+						return sl_false;
+					}
+					for (sl_size k = 2; k <= n; k++) {
+						if ((data[i + k] & 0xC0) != 0x80) {
+							return sl_false;
+						}
+					}
+					i += n + 1;
+				}
+				return sl_true;
+			}
+
+		}
+	}
+
+	using namespace priv::websocket;
+
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(WebSocketMessage)
+
+	WebSocketMessage::WebSocketMessage()
+	{
+		opcode = WebSocketOpcode::Binary;
+	}
+
+	sl_bool WebSocketMessage::isText() const
+	{
+		return opcode == WebSocketOpcode::Text;
+	}
+
+	String WebSocketMessage::getText() const
+	{
+		return String::fromUtf8(data);
+	}
+
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(WebSocketParam)
+
+	WebSocketParam::WebSocketParam()
+	{
+		maxMessageSize = 16 << 20;
+		maxSendQueueSize = 4 << 20;
+
+		flagCompress = sl_true;
+		compressionLevel = 6;
+		compressionThreshold = 128;
+	}
+
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(WebSocketClientParam)
+
+	WebSocketClientParam::WebSocketClientParam()
+	{
+		connectTimeout = 0;
+	}
+
+
+	SLIB_DEFINE_OBJECT(WebSocket, Object)
+
+	WebSocket::WebSocket()
+	{
+		m_flagClient = sl_false;
+		m_flagCompress = sl_false;
+		m_flagPeerResetsContext = sl_false;
+
+		m_flagOpened = sl_false;
+		m_flagClosed = sl_false;
+		m_flagCloseSent = sl_false;
+		m_flagCloseReceived = sl_false;
+		m_flagCloseStreamAfterWrite = sl_false;
+		m_codeClose = (sl_uint16)(WebSocketCloseCode::Abnormal);
+
+		m_sizeHeader = 0;
+		m_sizeHeaderRequired = 2;
+		m_flagPayload = sl_false;
+		m_sizePayload = 0;
+		m_offsetPayload = 0;
+		m_flagMessage = sl_false;
+		m_flagMessageCompressed = sl_false;
+		m_opcodeMessage = WebSocketOpcode::Binary;
+
+		m_sizeSendQueue = 0;
+		m_flagSendQueueFull = sl_false;
+		m_seedMask = 1;
+
+		m_flagOfferCompress = sl_false;
+	}
+
+	WebSocket::~WebSocket()
+	{
+		if (!m_flagClosed && m_io.isNotNull()) {
+			m_io->close();
+		}
+	}
+
+	Ref<WebSocket> WebSocket::connect(const WebSocketClientParam& param)
+	{
+		Url url(param.url);
+		String scheme = url.scheme.toLower();
+		sl_bool flagSecure;
+		if (scheme == StringView::literal("ws") || scheme == StringView::literal("http")) {
+			flagSecure = sl_false;
+		} else if (scheme == StringView::literal("wss") || scheme == StringView::literal("https")) {
+			flagSecure = sl_true;
+			if (param.stream.isNull()) {
+				// TLS is layered by the caller
+				return sl_null;
+			}
+		} else {
+			return sl_null;
+		}
+		if (url.host.isEmpty()) {
+			return sl_null;
+		}
+
+		Ref<WebSocket> ret = new WebSocket;
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		ret->_init(param, sl_true);
+		ret->m_onConnect = param.onConnect;
+		ret->m_bufRead = Memory::create(READ_BUFFER_SIZE);
+		if (ret->m_bufRead.isNull()) {
+			return sl_null;
+		}
+
+		sl_uint8 nonce[16];
+		Math::randomMemory(nonce, sizeof(nonce));
+		String key = Base64::encode(nonce, sizeof(nonce));
+		ret->m_acceptHandshake = getAcceptKey(key);
+		ret->m_flagOfferCompress = param.flagCompress;
+
+		HttpRequest request;
+		request.setMethod(HttpMethod::GET);
+		request.setPath(url.path);
+		request.setQuery(url.query);
+		request.setRequestVersion(StringView::literal("HTTP/1.1"));
+		request.setRequestHeader(HttpHeader::Host, url.host);
+		request.setRequestHeader(HttpHeader::Upgrade, g_strWebSocket);
+		request.setRequestHeader(HttpHeader::Connection, g_strUpgrade);
+		request.setRequestHeader(HttpHeader::SecWebSocketKey, key);
+		request.setRequestHeader(HttpHeader::SecWebSocketVersion, g_strVersion);
+		if (param.protocol.isNotEmpty()) {
+			request.setRequestHeader(HttpHeader::SecWebSocketProtocol, param.protocol);
+		}
+		if (param.flagCompress) {
+			request.setRequestHeader(HttpHeader::SecWebSocketExtensions, g_strClientDeflate);
+		}
+		ret->m_requestHandshake = request.makeRequestPacket();
+		if (ret->m_requestHandshake.isNull()) {
+			return sl_null;
+		}
+
+		if (param.stream.isNotNull()) {
+			ret->m_io = param.stream;
+			ret->_onConnect(sl_null, sl_false);
+			return ret;
+		}
+
+		SocketAddress address;
+		if (!(address.setHostAddress(url.host))) {
+			return sl_null;
+		}
+		if (!(address.port)) {
+			address.port = flagSecure ? 443 : 80;
+		}
+		AsyncTcpSocketParam cp;
+		cp.ioLoop = param.ioLoop;
+		cp.connectTimeout = param.connectTimeout;
+		cp.flagIPv6 = address.ip.isIPv6();
+		Ref<AsyncTcpSocket> socket = AsyncTcpSocket::create(cp);
+		if (socket.isNull()) {
+			return sl_null;
+		}
+		ret->m_io = socket;
+		ret->setRemoteAddress(address);
+		if (socket->connect(address, SLIB_FUNCTION_WEAKREF(ret, _onConnect))) {
+			return ret;
+		}
+		return sl_null;
+	}
+
+	Ref<WebSocket> WebSocket::create(const Ref<AsyncStream>& stream, const WebSocketParam& param, sl_bool flagClient, sl_bool flagCompress, const Memory& dataReceived)
+	{
+		if (stream.isNull()) {
+			return sl_null;
+		}
+		Ref<WebSocket> ret = new WebSocket;
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		ret->_init(param, flagClient);
+		ret->m_io = stream;
+		ret->m_flagCompress = flagCompress;
+		ret->m_bufRead = Memory::create(READ_BUFFER_SIZE);
+		if (ret->m_bufRead.isNull()) {
+			return sl_null;
+		}
+		ret->m_flagOpened = sl_true;
+		// The received bytes are unmasked in place
+		ret->_start(Memory::create(dataReceived.getData(), dataReceived.getSize()));
+		return ret;
+	}
+
+	void WebSocket::close(sl_uint16 code, const StringParam& reason)
+	{
+		if (m_flagClosed || m_flagCloseSent) {
+			return;
+		}
+		if (!m_flagOpened) {
+			_closeStream();
+			return;
+		}
+		StringData s(reason);
+		if (_sendClose(code, s, sl_false)) {
+			// Waits for the answer of the peer
+			Dispatch::setTimeout(SLIB_FUNCTION_WEAKREF(this, _closeStream), CLOSE_TIMEOUT);
+		} else {
+			_closeStream();
+		}
+	}
+
+	void WebSocket::close()
+	{
+		close((sl_uint16)(WebSocketCloseCode::Normal));
+	}
+
+	sl_bool WebSocket::isOpened()
+	{
+		return m_flagOpened && !m_flagClosed && !m_flagCloseSent;
+	}
+
+	sl_bool WebSocket::isClient()
+	{
+		return m_flagClient;
+	}
+
+	sl_bool WebSocket::isCompressing()
+	{
+		return m_flagCompress;
+	}
+
+	Ref<AsyncStream> WebSocket::getIO()
+	{
+		return m_io;
+	}
+
+	sl_bool WebSocket::send(WebSocketOpcode opcode, const void* data, sl_size size)
+	{
+		if (!(isOpened())) {
+			return sl_false;
+		}
+		switch (opcode) {
+			case WebSocketOpcode::Text:
+			case WebSocketOpcode::Binary:
+				break;
+			case WebSocketOpcode::Ping:
+			case WebSocketOpcode::Pong:
+				if (size > MAX_CONTROL_PAYLOAD_SIZE) {
+					return sl_false;
+				}
+				return _sendFrame(_buildFrame(opcode, data, size), sl_true);
+			default:
+				return sl_false;
+		}
+		{
+			// Checks before building the frame
+			ObjectLocker lock(this);
+			if (m_sizeSendQueue && m_sizeSendQueue >= m_param.maxSendQueueSize) {
+				m_flagSendQueueFull = sl_true;
+				return sl_false;
+			}
+		}
+		return _sendFrame(_buildFrame(opcode, data, size), sl_false);
+	}
+
+	sl_bool WebSocket::sendText(const StringParam& _text)
+	{
+		StringData text(_text);
+		return send(WebSocketOpcode::Text, text.getData(), text.getLength());
+	}
+
+	sl_bool WebSocket::sendBinary(const void* data, sl_size size)
+	{
+		return send(WebSocketOpcode::Binary, data, size);
+	}
+
+	sl_bool WebSocket::sendBinary(const MemoryView& data)
+	{
+		return send(WebSocketOpcode::Binary, data.data, data.size);
+	}
+
+	sl_bool WebSocket::ping(const void* data, sl_size size)
+	{
+		return send(WebSocketOpcode::Ping, data, size);
+	}
+
+	sl_size WebSocket::getSendQueueSize()
+	{
+		return m_sizeSendQueue;
+	}
+
+	sl_bool WebSocket::isSendQueueFull()
+	{
+		return m_sizeSendQueue >= m_param.maxSendQueueSize;
+	}
+
+	sl_size WebSocket::broadcast(const Ref<WebSocket>* sockets, sl_size count, WebSocketOpcode opcode, const void* data, sl_size size)
+	{
+		if (opcode != WebSocketOpcode::Text && opcode != WebSocketOpcode::Binary) {
+			return 0;
+		}
+		// [0]: plain, [1]: compressed
+		Memory frames[2];
+		sl_bool flagBuilt[2] = { sl_false, sl_false };
+		sl_size n = 0;
+		for (sl_size i = 0; i < count; i++) {
+			WebSocket* socket = sockets[i].get();
+			if (!socket || !(socket->isOpened())) {
+				continue;
+			}
+			if (socket->m_flagClient) {
+				// The client frames are masked by their own keys
+				if (socket->send(opcode, data, size)) {
+					n++;
+				}
+				continue;
+			}
+			sl_uint32 k = socket->_isCompressingMessage(opcode, size) ? 1 : 0;
+			if (!(flagBuilt[k])) {
+				flagBuilt[k] = sl_true;
+				frames[k] = BuildFrame(opcode, data, size, k ? g_cacheZlib.getCompressor(socket->m_param.compressionLevel) : sl_null, sl_null);
+			}
+			if (socket->_sendFrame(frames[k], sl_false)) {
+				n++;
+			}
+		}
+		return n;
+	}
+
+	sl_size WebSocket::broadcast(const List< Ref<WebSocket> >& sockets, WebSocketOpcode opcode, const void* data, sl_size size)
+	{
+		ListLocker< Ref<WebSocket> > list(sockets);
+		return broadcast(list.data, list.count, opcode, data, size);
+	}
+
+	String WebSocket::getAcceptKey(const StringParam& _key)
+	{
+		StringData key(_key);
+		SHA1 sha;
+		sha.start();
+		sha.update(key.getData(), key.getLength());
+		sha.update(g_strGuid.getData(), g_strGuid.getLength());
+		sl_uint8 hash[SHA1::HashSize];
+		sha.finish(hash);
+		return Base64::encode(hash, sizeof(hash));
+	}
+
+	void WebSocket::mask(void* data, sl_size size, const sl_uint8* mask, sl_uint64 offset)
+	{
+		sl_uint8 k[4];
+		for (sl_uint32 i = 0; i < 4; i++) {
+			k[i] = mask[(offset + i) & 3];
+		}
+		sl_uint32 key;
+		Base::copyMemory(&key, k, 4);
+		Mask((sl_uint8*)data, size, key);
+	}
+
+	void WebSocket::_init(const WebSocketParam& param, sl_bool flagClient)
+	{
+		m_param = param;
+		m_flagClient = flagClient;
+		m_callbackRead = SLIB_FUNCTION_WEAKREF(this, onReadStream);
+		m_callbackWrite = SLIB_FUNCTION_WEAKREF(this, onWriteStream);
+		m_callbackWriteClose = SLIB_FUNCTION_WEAKREF(this, onWriteClose);
+		if (flagClient) {
+			Math::randomMemory(&m_seedMask, sizeof(m_seedMask));
+			if (!m_seedMask) {
+				m_seedMask = 1;
+			}
+		}
+	}
+
+	void WebSocket::_start(const Memory& dataReceived)
+	{
+		if (dataReceived.isNotNull()) {
+			if (!(_processFrames((sl_uint8*)(dataReceived.getData()), dataReceived.getSize()))) {
+				return;
+			}
+		}
+		_read();
+	}
+
+	void WebSocket::_read()
+	{
+		if (m_flagClosed) {
+			m_bufRead.setNull();
+			return;
+		}
+		sl_bool bRet;
+		if (m_bufRead.isNotNull()) {
+			bRet = m_io->read(m_bufRead, m_callbackRead);
+		} else {
+			// Borrows the buffer from the pool when the data arrives
+			bRet = m_io->waitRead(m_callbackRead);
+		}
+		if (!bRet) {
+			_closeStream();
+		}
+	}
+
+	sl_bool WebSocket::_processFrames(sl_uint8* data, sl_size size)
+	{
+		while (size) {
+			if (!m_flagPayload) {
+				sl_uint32 n = m_sizeHeaderRequired - m_sizeHeader;
+				if (n > size) {
+					n = (sl_uint32)size;
+				}
+				Base::copyMemory(m_header + m_sizeHeader, data, n);
+				m_sizeHeader += n;
+				data += n;
+				size -= n;
+				if (m_sizeHeader < m_sizeHeaderRequired) {
+					break;
+				}
+				if (m_sizeHeaderRequired == 2) {
+					sl_uint32 sizeRequired = 2;
+					sl_uint8 len = m_header[1] & 0x7f;
+					if (len == 126) {
+						sizeRequired += 2;
+					} else if (len == 127) {
+						sizeRequired += 8;
+					}
+					if (m_header[1] & 0x80) {
+						sizeRequired += 4;
+					}
+					if (sizeRequired > 2) {
+						m_sizeHeaderRequired = sizeRequired;
+						continue;
+					}
+				}
+				if (!(_beginFrame())) {
+					return sl_false;
+				}
+				if (m_sizePayload) {
+					m_flagPayload = sl_true;
+				} else {
+					if (!(_endFrame())) {
+						return sl_false;
+					}
+				}
+				continue;
+			}
+			sl_size n = size;
+			sl_uint64 sizeRemain = m_sizePayload - m_offsetPayload;
+			if (n > sizeRemain) {
+				n = (sl_size)sizeRemain;
+			}
+			if (m_header[1] & 0x80) {
+				mask(data, n, m_maskPayload, m_offsetPayload);
+			}
+			if (m_header[0] & 0x08) {
+				Base::copyMemory(m_bufControl + m_offsetPayload, data, n);
+			} else {
+				if (!(m_bufMessage.addNew(data, n))) {
+					_fail(WebSocketCloseCode::InternalError);
+					return sl_false;
+				}
+			}
+			m_offsetPayload += n;
+			data += n;
+			size -= n;
+			if (m_offsetPayload == m_sizePayload) {
+				if (!(_endFrame())) {
+					return sl_false;
+				}
+			}
+		}
+		return sl_true;
+	}
+
+	sl_bool WebSocket::_beginFrame()
+	{
+		sl_uint8 b0 = m_header[0];
+		sl_uint8 b1 = m_header[1];
+		sl_uint8 opcode = b0 & 0x0f;
+		sl_bool flagFinal = (b0 & 0x80) != 0;
+		sl_bool flagCompressed = (b0 & 0x40) != 0;
+		sl_bool flagMasked = (b1 & 0x80) != 0;
+		// RSV2 and RSV3 are not used. The client frames are masked, and the server frames are not
+		if ((b0 & 0x30) || flagMasked == m_flagClient) {
+			_fail(WebSocketCloseCode::ProtocolError);
+			return sl_false;
+		}
+		sl_uint64 len = b1 & 0x7f;
+		const sl_uint8* p = m_header + 2;
+		if (len == 126) {
+			len = MIO::readUint16BE(p);
+			p += 2;
+		} else if (len == 127) {
+			len = MIO::readUint64BE(p);
+			p += 8;
+		}
+		if (flagMasked) {
+			Base::copyMemory(m_maskPayload, p, 4);
+		}
+		if (opcode & 0x08) {
+			if (!flagFinal || flagCompressed || len > MAX_CONTROL_PAYLOAD_SIZE || opcode > (sl_uint8)(WebSocketOpcode::Pong)) {
+				_fail(WebSocketCloseCode::ProtocolError);
+				return sl_false;
+			}
+		} else {
+			if (opcode == (sl_uint8)(WebSocketOpcode::Continuation)) {
+				if (!m_flagMessage || flagCompressed) {
+					_fail(WebSocketCloseCode::ProtocolError);
+					return sl_false;
+				}
+			} else if (opcode == (sl_uint8)(WebSocketOpcode::Text) || opcode == (sl_uint8)(WebSocketOpcode::Binary)) {
+				if (m_flagMessage || (flagCompressed && !m_flagCompress)) {
+					_fail(WebSocketCloseCode::ProtocolError);
+					return sl_false;
+				}
+				m_flagMessage = sl_true;
+				m_flagMessageCompressed = flagCompressed;
+				m_opcodeMessage = (WebSocketOpcode)opcode;
+			} else {
+				_fail(WebSocketCloseCode::ProtocolError);
+				return sl_false;
+			}
+			if (len > m_param.maxMessageSize || m_bufMessage.getSize() + len > m_param.maxMessageSize) {
+				_fail(WebSocketCloseCode::MessageTooBig);
+				return sl_false;
+			}
+		}
+		m_sizePayload = len;
+		m_offsetPayload = 0;
+		return sl_true;
+	}
+
+	sl_bool WebSocket::_endFrame()
+	{
+		WebSocketOpcode opcode = (WebSocketOpcode)(m_header[0] & 0x0f);
+		sl_bool flagFinal = (m_header[0] & 0x80) != 0;
+		sl_size sizePayload = (sl_size)m_sizePayload;
+		m_flagPayload = sl_false;
+		m_sizeHeader = 0;
+		m_sizeHeaderRequired = 2;
+		m_sizePayload = 0;
+		m_offsetPayload = 0;
+
+		switch (opcode) {
+			case WebSocketOpcode::Close:
+				{
+					sl_uint16 code = (sl_uint16)(WebSocketCloseCode::NoStatus);
+					String reason;
+					if (sizePayload) {
+						if (sizePayload < 2) {
+							_fail(WebSocketCloseCode::ProtocolError);
+							return sl_false;
+						}
+						code = MIO::readUint16BE(m_bufControl);
+						if (!(IsValidCloseCode(code))) {
+							_fail(WebSocketCloseCode::ProtocolError);
+							return sl_false;
+						}
+						if (!(IsValidUtf8(m_bufControl + 2, sizePayload - 2))) {
+							_fail(WebSocketCloseCode::InvalidData);
+							return sl_false;
+						}
+						reason = String::fromUtf8(m_bufControl + 2, sizePayload - 2);
+					}
+					sl_bool flagAnswered;
+					{
+						ObjectLocker lock(this);
+						m_flagCloseReceived = sl_true;
+						m_codeClose = code;
+						m_reasonClose = reason;
+						flagAnswered = m_flagCloseSent;
+					}
+					if (flagAnswered || !(_sendClose(code == (sl_uint16)(WebSocketCloseCode::NoStatus) ? 0 : code, reason, sl_true))) {
+						_closeStream();
+					}
+					return sl_false;
+				}
+			case WebSocketOpcode::Ping:
+				_sendFrame(_buildFrame(WebSocketOpcode::Pong, m_bufControl, sizePayload), sl_true);
+				return sl_true;
+			case WebSocketOpcode::Pong:
+				return sl_true;
+			default:
+				break;
+		}
+
+		if (!flagFinal) {
+			return sl_true;
+		}
+		Memory data = m_bufMessage.merge();
+		m_bufMessage.clear();
+		m_flagMessage = sl_false;
+		if (m_flagMessageCompressed) {
+			ZlibRawDecompressor* decompressor;
+			if (m_flagPeerResetsContext) {
+				decompressor = g_cacheZlib.getDecompressor();
+			} else {
+				decompressor = &m_decompressor;
+				if (!(decompressor->isStarted()) && !(decompressor->start())) {
+					decompressor = sl_null;
+				}
+			}
+			if (!decompressor) {
+				_fail(WebSocketCloseCode::InternalError);
+				return sl_false;
+			}
+			MemoryBuffer output;
+			sl_size sizeOutput = 0;
+			sl_bool flagEnded = sl_false;
+			sl_bool bRet = Inflate(decompressor, data.getData(), data.getSize(), output, sizeOutput, m_param.maxMessageSize, flagEnded);
+			if (bRet && !flagEnded) {
+				bRet = Inflate(decompressor, g_tailDeflate, sizeof(g_tailDeflate), output, sizeOutput, m_param.maxMessageSize, flagEnded);
+			}
+			if (m_flagPeerResetsContext || flagEnded || !bRet) {
+				decompressor->reset();
+			}
+			if (!bRet) {
+				_fail(sizeOutput > m_param.maxMessageSize ? WebSocketCloseCode::MessageTooBig : WebSocketCloseCode::InvalidData);
+				return sl_false;
+			}
+			data = output.merge();
+		}
+		if (m_opcodeMessage == WebSocketOpcode::Text && !(IsValidUtf8(data.getData(), data.getSize()))) {
+			_fail(WebSocketCloseCode::InvalidData);
+			return sl_false;
+		}
+		WebSocketMessage message;
+		message.opcode = m_opcodeMessage;
+		message.data = Move(data);
+		m_param.onMessage(this, message);
+		return !m_flagClosed;
+	}
+
+	sl_bool WebSocket::_processHandshake(sl_uint8* data, sl_size size)
+	{
+		sl_size posBody;
+		if (!(m_readerHandshake.add(data, size, posBody))) {
+			if (m_readerHandshake.getHeaderSize() > MAX_HANDSHAKE_SIZE) {
+				_closeStream();
+				return sl_false;
+			}
+			return sl_true;
+		}
+		Memory header = m_readerHandshake.mergeHeader();
+		m_readerHandshake.clear();
+		HttpResponse response;
+		if (header.isNull() || response.parseResponsePacket(header.getData(), header.getSize()) <= 0) {
+			_closeStream();
+			return sl_false;
+		}
+		if (response.getResponseCode() != HttpStatus::SwitchingProtocols || !(response.getResponseHeader(HttpHeader::Upgrade).equalsIgnoreCase(g_strWebSocket)) || response.getResponseHeader(HttpHeader::SecWebSocketAccept) != m_acceptHandshake) {
+			_closeStream();
+			return sl_false;
+		}
+		String extension = response.getResponseHeader(HttpHeader::SecWebSocketExtensions);
+		if (extension.isNotEmpty()) {
+			if (!m_flagOfferCompress || !(ParseDeflateExtension(extension, sl_true, m_flagPeerResetsContext))) {
+				_closeStream();
+				return sl_false;
+			}
+			m_flagCompress = sl_true;
+		}
+		m_flagOpened = sl_true;
+		m_onConnect(this, sl_false);
+		if (posBody < size) {
+			return _processFrames(data + posBody, size - posBody);
+		}
+		return !m_flagClosed;
+	}
+
+	sl_bool WebSocket::_isCompressingMessage(WebSocketOpcode opcode, sl_size size)
+	{
+		return m_flagCompress && size >= m_param.compressionThreshold && (opcode == WebSocketOpcode::Text || opcode == WebSocketOpcode::Binary);
+	}
+
+	Memory WebSocket::_buildFrame(WebSocketOpcode opcode, const void* data, sl_size size)
+	{
+		ZlibRawCompressor* compressor = sl_null;
+		if (_isCompressingMessage(opcode, size)) {
+			compressor = g_cacheZlib.getCompressor(m_param.compressionLevel);
+		}
+		if (m_flagClient) {
+			sl_uint32 key;
+			{
+				ObjectLocker lock(this);
+				key = GenerateMaskKey(m_seedMask);
+			}
+			return BuildFrame(opcode, data, size, compressor, &key);
+		} else {
+			return BuildFrame(opcode, data, size, compressor, sl_null);
+		}
+	}
+
+	sl_bool WebSocket::_sendFrame(const Memory& frame, sl_bool flagControl)
+	{
+		if (frame.isNull()) {
+			return sl_false;
+		}
+		sl_size size = frame.getSize();
+		ObjectLocker lock(this);
+		if (m_flagClosed || m_flagCloseSent) {
+			return sl_false;
+		}
+		if (!flagControl && m_sizeSendQueue && m_sizeSendQueue + size > m_param.maxSendQueueSize) {
+			m_flagSendQueueFull = sl_true;
+			return sl_false;
+		}
+		m_sizeSendQueue += size;
+		if (m_io->write(frame, m_callbackWrite)) {
+			return sl_true;
+		}
+		m_sizeSendQueue -= size;
+		return sl_false;
+	}
+
+	sl_bool WebSocket::_sendClose(sl_uint16 code, const StringView& reason, sl_bool flagCloseStream)
+	{
+		sl_uint8 payload[MAX_CONTROL_PAYLOAD_SIZE];
+		sl_size sizePayload = 0;
+		if (code) {
+			MIO::writeUint16BE(payload, code);
+			sl_size len = reason.getLength();
+			if (len > MAX_CONTROL_PAYLOAD_SIZE - 2) {
+				len = MAX_CONTROL_PAYLOAD_SIZE - 2;
+			}
+			Base::copyMemory(payload + 2, reason.getData(), len);
+			sizePayload = 2 + len;
+		}
+		Memory frame = _buildFrame(WebSocketOpcode::Close, payload, sizePayload);
+		if (frame.isNull()) {
+			return sl_false;
+		}
+		sl_size size = frame.getSize();
+		ObjectLocker lock(this);
+		if (m_flagClosed || m_flagCloseSent) {
+			return sl_false;
+		}
+		m_flagCloseSent = sl_true;
+		m_flagCloseStreamAfterWrite = flagCloseStream;
+		if (!m_flagCloseReceived) {
+			m_codeClose = code ? code : (sl_uint16)(WebSocketCloseCode::NoStatus);
+			m_reasonClose = reason;
+		}
+		m_sizeSendQueue += size;
+		if (m_io->write(frame, m_callbackWriteClose)) {
+			return sl_true;
+		}
+		m_sizeSendQueue -= size;
+		return sl_false;
+	}
+
+	void WebSocket::_fail(WebSocketCloseCode code)
+	{
+		if (!(_sendClose((sl_uint16)code, sl_null, sl_true))) {
+			_closeStream();
+		}
+	}
+
+	void WebSocket::_closeStream()
+	{
+		Ref<WebSocket> thiz = this;
+		sl_uint16 code;
+		String reason;
+		{
+			ObjectLocker lock(this);
+			if (m_flagClosed) {
+				return;
+			}
+			m_flagClosed = sl_true;
+			code = m_codeClose;
+			reason = m_reasonClose;
+		}
+		if (m_io.isNotNull()) {
+			m_io->close();
+		}
+		if (m_flagOpened) {
+			m_param.onClose(this, code, reason);
+		} else if (m_flagClient) {
+			m_onConnect(this, sl_true);
+		}
+	}
+
+	void WebSocket::_onConnect(AsyncTcpSocket*, sl_bool flagError)
+	{
+		if (flagError || !(_sendFrame(m_requestHandshake, sl_true))) {
+			_closeStream();
+			return;
+		}
+		m_requestHandshake.setNull();
+		_read();
+	}
+
+	void WebSocket::onReadStream(AsyncStreamResult& result)
+	{
+		if (!(result.isSuccess())) {
+			_closeStream();
+			return;
+		}
+		if (!(result.requestSize)) {
+			// Completion of `waitRead()`
+			if (m_bufRead.isNull()) {
+				m_bufRead = m_poolRead->allocate();
+				if (m_bufRead.isNull()) {
+					_closeStream();
+					return;
+				}
+			}
+			_read();
+			return;
+		}
+		// Keeps the buffer until the data is processed
+		Memory buf = m_bufRead;
+		if (result.size < result.requestSize && m_poolRead.isNotNull()) {
+			// No more data is pending
+			m_bufRead.setNull();
+		}
+		sl_uint8* data = (sl_uint8*)(result.data);
+		sl_bool bRet;
+		if (m_flagOpened) {
+			bRet = _processFrames(data, result.size);
+		} else {
+			bRet = _processHandshake(data, result.size);
+		}
+		if (bRet) {
+			_read();
+		}
+	}
+
+	void WebSocket::onWriteStream(AsyncStreamResult& result)
+	{
+		sl_bool flagDrain = sl_false;
+		{
+			ObjectLocker lock(this);
+			m_sizeSendQueue -= result.requestSize;
+			if (m_flagSendQueueFull && m_sizeSendQueue <= (m_param.maxSendQueueSize >> 1)) {
+				m_flagSendQueueFull = sl_false;
+				flagDrain = sl_true;
+			}
+		}
+		if (!(result.isSuccess())) {
+			_closeStream();
+			return;
+		}
+		if (flagDrain) {
+			m_param.onDrain(this);
+		}
+	}
+
+	void WebSocket::onWriteClose(AsyncStreamResult& result)
+	{
+		onWriteStream(result);
+		if (result.isSuccess() && m_flagCloseStreamAfterWrite) {
+			_closeStream();
+		}
+	}
+
+
+	sl_bool HttpServerContext::isWebSocketRequest() const
+	{
+		if (getMethod() != HttpMethod::GET) {
+			return sl_false;
+		}
+		if (!(getRequestHeader(HttpHeader::Upgrade).toLower().contains(g_strWebSocket))) {
+			return sl_false;
+		}
+		if (!(getRequestHeader(HttpHeader::Connection).toLower().contains(StringView::literal("upgrade")))) {
+			return sl_false;
+		}
+		if (getRequestHeader(HttpHeader::SecWebSocketKey).isEmpty()) {
+			return sl_false;
+		}
+		return getRequestHeader(HttpHeader::SecWebSocketVersion).trim() == g_strVersion;
+	}
+
+	Ref<WebSocket> HttpServerContext::acceptWebSocket(const WebSocketParam& param, const String& protocol)
+	{
+		if (!(isWebSocketRequest())) {
+			return sl_null;
+		}
+		Ref<HttpServerConnection> connection = getConnection();
+		if (connection.isNull()) {
+			return sl_null;
+		}
+		Ref<HttpServer> server = connection->getServer();
+		if (server.isNull()) {
+			return sl_null;
+		}
+
+		sl_bool flagCompress = sl_false;
+		if (param.flagCompress) {
+			ListElements<String> headers(getRequestHeaderValues(HttpHeader::SecWebSocketExtensions));
+			for (sl_size i = 0; i < headers.count && !flagCompress; i++) {
+				ListElements<String> offers(headers[i].split(','));
+				for (sl_size k = 0; k < offers.count; k++) {
+					sl_bool flagPeerResetsContext = sl_false;
+					if (ParseDeflateExtension(offers[k], sl_false, flagPeerResetsContext)) {
+						flagCompress = sl_true;
+						break;
+					}
+				}
+			}
+		}
+
+		setResponseCode(HttpStatus::SwitchingProtocols);
+		setResponseHeader(HttpHeader::Upgrade, g_strWebSocket);
+		setResponseHeader(HttpHeader::Connection, g_strUpgrade);
+		setResponseHeader(HttpHeader::SecWebSocketAccept, WebSocket::getAcceptKey(getRequestHeader(HttpHeader::SecWebSocketKey)));
+		if (protocol.isNotEmpty()) {
+			setResponseHeader(HttpHeader::SecWebSocketProtocol, protocol);
+		}
+		if (flagCompress) {
+			// The client is asked to compress without context takeover, so the decompressors are shared too
+			setResponseHeader(HttpHeader::SecWebSocketExtensions, g_strServerDeflate);
+		}
+		Memory response = makeResponsePacket();
+		if (response.isNull()) {
+			return sl_null;
+		}
+
+		Ref<WebSocket> ret = new WebSocket;
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		ret->_init(param, sl_false);
+		WeakRef<HttpServer> weakServer = server;
+		Function<void(WebSocket*, sl_uint16, const String&)> onClose = param.onClose;
+		ret->m_param.onClose = [weakServer, onClose](WebSocket* socket, sl_uint16 code, const String& reason) {
+			Ref<HttpServer> server = weakServer;
+			if (server.isNotNull()) {
+				server->removeWebSocket(socket);
+			}
+			onClose(socket, code, reason);
+		};
+		ret->m_flagCompress = flagCompress;
+		ret->m_flagPeerResetsContext = sl_true;
+		ret->m_poolRead = server->getReadBufferPool();
+		if (ret->m_poolRead.isNull()) {
+			ret->m_bufRead = Memory::create(READ_BUFFER_SIZE);
+			if (ret->m_bufRead.isNull()) {
+				return sl_null;
+			}
+		}
+
+		Memory dataUnprocessed;
+		Ref<AsyncStream> io = connection->detachIO(dataUnprocessed);
+		if (io.isNull()) {
+			return sl_null;
+		}
+		ret->m_io = Move(io);
+		ret->setLocalAddress(connection->getLocalAddress());
+		ret->setRemoteAddress(connection->getRemoteAddress());
+		ret->m_flagOpened = sl_true;
+		setProcessed();
+
+		server->addWebSocket(ret);
+		if (!(ret->_sendFrame(response, sl_true))) {
+			ret->_closeStream();
+			return sl_null;
+		}
+		ret->_start(dataUnprocessed);
+		return ret;
+	}
+
+}